@@ -0,0 +1,191 @@
+#define HERMES_REPORT_ALL
+#include "hermes2d.h"
+#include "weakform_library/h1.h"
+#include "weakform_library/hcurl.h"
+#include "weakform_library/elasticity.h"
+
+//  Micro-benchmark of the volumetric forms generated from compile-time kernels
+//  (weakform/form_kernels.h). For each polynomial degree, the element matrix of a set of
+//  synthetic shape functions on a quadrilateral is evaluated by the forms of the form
+//  libraries through the virtual value() (one call per pair of functions, as in the
+//  assembling without batching) and by the kernel forms through value_batch(). The forms
+//  are the H1 diffusion and mass (planar and axisymmetric), the Hcurl curl-curl and mass,
+//  and the three blocks of linear elasticity. The two matrices have to coincide.
+//
+//  The following parameters can be changed:
+
+const int P_MIN = 1;                              // Range of polynomial degrees.
+const int P_MAX = 8;
+const double MIN_TIME = 0.05;                     // Minimum measured time per form and degree (s).
+const double TOLERANCE = 1e-12;                   // Allowed relative difference of the matrices.
+
+// Problem parameters.
+const double COEFF = 1.3;
+const double LAMBDA = 2.0;
+const double MU = 0.7;
+
+// Synthetic element data: nf functions at np points.
+struct ElementData
+{
+  ElementData(int nf, int np, int nc) : nf(nf), np(np), nc(nc)
+  {
+    for (int k = 0; k < nf; k++) {
+      Func<double>* fn = new Func<double>(np, nc);
+      if (nc == 1) {
+        fn->val = random_array(np);
+        fn->dx = random_array(np);
+        fn->dy = random_array(np);
+      }
+      else {
+        fn->val0 = random_array(np);
+        fn->val1 = random_array(np);
+        fn->curl = random_array(np);
+      }
+      fns.push_back(fn);
+    }
+    batch.resize(nf, np, nc);
+    for (int k = 0; k < nf; k++) batch.set(k, fns[k]);
+
+    // Points of the element (0,1)^2 of the axisymmetric forms.
+    geom.x = random_array(np);
+    geom.y = random_array(np);
+    for (int i = 0; i < np; i++) geom.x[i] += 1.0, geom.y[i] += 1.0;
+  }
+
+  ~ElementData()
+  {
+    for (int k = 0; k < nf; k++) {
+      fns[k]->free_fn();
+      delete fns[k];
+    }
+    delete [] geom.x;
+    delete [] geom.y;
+  }
+
+  static double* random_array(int n)
+  {
+    double* a = new double[n];
+    for (int i = 0; i < n; i++) a[i] = 2.0 * rand() / RAND_MAX - 1.0;
+    return a;
+  }
+
+  int nf, np, nc;
+  std::vector<Func<double>*> fns;
+  FuncBatch batch;
+  Geom<double> geom;
+};
+
+// Evaluates the element matrix by the virtual value() pair by pair.
+void eval_virtual(WeakForm::MatrixFormVol* mfv, ElementData& data, double* wt, scalar** result)
+{
+  for (int i = 0; i < data.nf; i++)
+    for (int j = 0; j < data.nf; j++)
+      result[i][j] = mfv->value(data.np, wt, NULL, data.fns[j], data.fns[i], &data.geom, NULL);
+}
+
+// Evaluates the element matrix by value_batch().
+void eval_batch(WeakForm::MatrixFormVol* mfv, ElementData& data, double* wt, scalar** result)
+{
+  for (int i = 0; i < data.nf; i++)
+    memset(result[i], 0, data.nf * sizeof(scalar));
+  mfv->value_batch(data.np, wt, NULL, &data.batch, &data.batch, &data.geom, NULL, result);
+}
+
+// Calls eval for at least MIN_TIME, returns the time of one call.
+double measure(void (*eval)(WeakForm::MatrixFormVol*, ElementData&, double*, scalar**),
+               WeakForm::MatrixFormVol* mfv, ElementData& data, double* wt, scalar** result)
+{
+  TimePeriod timer;
+  int n = 0;
+  do {
+    eval(mfv, data, wt, result);
+    n++;
+    timer.tick();
+  } while (timer.accumulated() < MIN_TIME);
+  return timer.accumulated() / n;
+}
+
+// Compares the two evaluations of the element matrix, returns false if they differ.
+bool compare(const char* name, WeakForm::MatrixFormVol* lib, WeakForm::MatrixFormVol* kernel,
+             int p, ElementData& data, double* wt)
+{
+  scalar** a = new_matrix<scalar>(data.nf, data.nf);
+  scalar** b = new_matrix<scalar>(data.nf, data.nf);
+  double t_virtual = measure(eval_virtual, lib, data, wt, a);
+  double t_kernel = measure(eval_batch, kernel, data, wt, b);
+
+  double diff = 0, norm = 0;
+  for (int i = 0; i < data.nf; i++)
+    for (int j = 0; j < data.nf; j++) {
+      diff = std::max(diff, std::abs(a[i][j] - b[i][j]));
+      norm = std::max(norm, std::abs(a[i][j]));
+    }
+  delete [] a;
+  delete [] b;
+
+  info("%-22s p: %d, functions: %3d, points: %3d, virtual: %9.3e s, kernel: %9.3e s, speedup: %5.2f, difference: %g.",
+       name, p, data.nf, data.np, t_virtual, t_kernel, t_virtual / t_kernel, diff / norm);
+  return diff <= TOLERANCE * norm;
+}
+
+int main(int argc, char* argv[])
+{
+  using namespace FormKernels;
+  srand(0);
+
+  // Library forms.
+  WeakFormsH1::VolumetricMatrixForms::DefaultLinearDiffusion lib_diffusion(0, 0, HERMES_ANY, COEFF);
+  WeakFormsH1::VolumetricMatrixForms::DefaultLinearMass lib_mass(0, 0, HERMES_ANY, COEFF);
+  WeakFormsH1::VolumetricMatrixForms::DefaultLinearDiffusion lib_diffusion_axisym(0, 0, HERMES_ANY, COEFF,
+                                                                                 HERMES_SYM, HERMES_AXISYM_Y);
+  WeakFormsHcurl::VolumetricMatrixForms::DefaultLinearCurlCurl lib_curlcurl(0, 0, COEFF);
+  WeakFormsHcurl::VolumetricMatrixForms::DefaultLinearMass lib_vector_mass(0, 0, COEFF);
+  WeakFormsElasticity::DefaultVolumetricMatrixFormLinear_x_x lib_elast_xx(0, 0, LAMBDA, MU);
+  WeakFormsElasticity::DefaultVolumetricMatrixFormLinear_x_y lib_elast_xy(0, 1, LAMBDA, MU);
+  WeakFormsElasticity::DefaultVolumetricMatrixFormLinear_y_y lib_elast_yy(1, 1, LAMBDA, MU);
+
+  // Kernel forms.
+  MatrixFormVolKernel<Diffusion<> > diffusion(0, 0, Diffusion<>(COEFF));
+  MatrixFormVolKernel<Mass<> > mass(0, 0, Mass<>(COEFF));
+  MatrixFormVolKernel<Diffusion<RadialCoeff<HERMES_AXISYM_Y> > >
+    diffusion_axisym(0, 0, Diffusion<RadialCoeff<HERMES_AXISYM_Y> >(COEFF));
+  MatrixFormVolKernel<CurlCurl<> > curlcurl(0, 0, CurlCurl<>(COEFF));
+  MatrixFormVolKernel<VectorMass<> > vector_mass(0, 0, VectorMass<>(COEFF));
+  MatrixFormVolKernel<ElasticityDiagonal<false> > elast_xx(0, 0, ElasticityDiagonal<false>(LAMBDA, MU));
+  MatrixFormVolKernel<ElasticityOffDiagonal> elast_xy(0, 1, ElasticityOffDiagonal(LAMBDA, MU));
+  MatrixFormVolKernel<ElasticityDiagonal<true> > elast_yy(1, 1, ElasticityDiagonal<true>(LAMBDA, MU));
+
+  bool success = true;
+  for (int p = P_MIN; p <= P_MAX; p++) {
+    // Quadrature of the product of two functions of degree p on a quadrilateral.
+    int order = 2*p;
+    g_quad_2d_std.set_mode(HERMES_MODE_QUAD);
+    int np = g_quad_2d_std.get_num_points(order);
+    double3* pt = g_quad_2d_std.get_points(order);
+    double* wt = new double[np];
+    for (int i = 0; i < np; i++) wt[i] = pt[i][2];
+
+    ElementData h1(sqr(p + 1), np, 1);
+    success &= compare("diffusion", &lib_diffusion, &diffusion, p, h1, wt);
+    success &= compare("mass", &lib_mass, &mass, p, h1, wt);
+    success &= compare("diffusion (axisym)", &lib_diffusion_axisym, &diffusion_axisym, p, h1, wt);
+    success &= compare("elasticity x-x", &lib_elast_xx, &elast_xx, p, h1, wt);
+    success &= compare("elasticity x-y", &lib_elast_xy, &elast_xy, p, h1, wt);
+    success &= compare("elasticity y-y", &lib_elast_yy, &elast_yy, p, h1, wt);
+
+    ElementData hcurl(2 * p * (p + 1), np, 2);
+    success &= compare("curl-curl", &lib_curlcurl, &curlcurl, p, hcurl, wt);
+    success &= compare("vector mass", &lib_vector_mass, &vector_mass, p, hcurl, wt);
+
+    delete [] wt;
+  }
+
+  if (success) {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
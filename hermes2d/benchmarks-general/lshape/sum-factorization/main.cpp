@@ -0,0 +1,178 @@
+#define HERMES_REPORT_ALL
+#include "hermes2d.h"
+
+using namespace RefinementSelectors;
+
+//  Sum factorization (DiscreteProblem::set_sum_factorization()) in the hp-adaptivity of the
+//  benchmark lshape. In every adaptivity step, the system on the reference mesh is assembled
+//  and solved with the standard quadrature and with sum factorization, and the two solutions have
+//  to coincide. The inner vertices of the initial mesh are shifted, so that the quads are not
+//  parallelograms and their stiffness matrices (which are otherwise taken from the precalculated
+//  reference matrices) are computed by sum factorization, including the Dirichlet lift. The
+//  exact solution is harmonic in any domain, so the benchmark stays the same. After the
+//  adaptivity, the assembly times are compared on a fixed mesh for a range of uniform
+//  polynomial degrees.
+//
+//  The following parameters can be changed:
+
+const int P_INIT = 2;                             // Initial polynomial degree of all mesh elements.
+const int INIT_REF_NUM = 1;                       // Number of initial uniform mesh refinements.
+const double SHIFT = 0.1;                         // Displacement of the inner vertices after the initial refinements.
+const double THRESHOLD = 0.3;                     // Parameter of the adapt(...) function.
+const int STRATEGY = 0;                           // Adaptive strategy.
+const CandList CAND_LIST = H2D_HP_ANISO_H;        // Predefined list of element refinement candidates.
+const int MESH_REGULARITY = -1;                   // Maximum allowed level of hanging nodes.
+const double CONV_EXP = 1.0;                      // Parameter of the hp-adaptivity.
+const double ERR_STOP = 1e-1;                     // Stopping criterion for adaptivity (rel. error tolerance between the
+                                                  // reference mesh and coarse mesh solution in percent).
+const int NDOF_STOP = 20000;                      // Adaptivity process stops when the number of degrees of freedom grows
+                                                  // over this limit.
+const int UNIFORM_REF_NUM = 2;                    // Number of uniform refinements of the mesh with uniform degrees.
+const int P_UNIFORM_MAX = 10;                     // The uniform degrees are 2, 4, ..., P_UNIFORM_MAX.
+const double TOLERANCE = 1e-8;                    // Allowed relative difference of the two solutions.
+MatrixSolverType matrix_solver = SOLVER_UMFPACK;  // Possibilities: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
+                                                  // SOLVER_PETSC, SOLVER_SUPERLU, SOLVER_UMFPACK.
+
+// Boundary markers.
+const std::string BDY_DIRICHLET = "1";
+
+// Exact solution, weak forms.
+#include "../definitions.cpp"
+
+// Assembles and solves the system of dp, returns the vector of all DOFs.
+scalar* solve(DiscreteProblem* dp, double& assembly_time)
+{
+  SparseMatrix* matrix = create_matrix(matrix_solver);
+  Vector* rhs = create_vector(matrix_solver);
+  Solver* solver = create_linear_solver(matrix_solver, matrix, rhs);
+
+  TimePeriod timer;
+  dp->assemble(matrix, rhs);
+  timer.tick();
+  assembly_time = timer.last();
+  if (!solver->solve()) error ("Matrix solver failed.\n");
+
+  scalar* coeff_vec = new scalar[dp->get_num_dofs()];
+  memcpy(coeff_vec, solver->get_solution(), sizeof(scalar) * dp->get_num_dofs());
+
+  delete solver;
+  delete matrix;
+  delete rhs;
+  return coeff_vec;
+}
+
+// Solves the problem on the space without and with sum factorization. Returns the relative
+// difference of the solutions and the assembly times.
+double compare(WeakForm* wf, Space* space, scalar*& sln_vec, double& std_time, double& sum_fact_time)
+{
+  bool is_linear = true;
+  DiscreteProblem dp(wf, space, is_linear);
+  scalar* std_vec = solve(&dp, std_time);
+
+  DiscreteProblem dp_sum_fact(wf, space, is_linear);
+  dp_sum_fact.set_sum_factorization(true);
+  sln_vec = solve(&dp_sum_fact, sum_fact_time);
+
+  double diff = 0, norm = 0;
+  for (int i = 0; i < dp.get_num_dofs(); i++) {
+    diff = std::max(diff, std::abs(sln_vec[i] - std_vec[i]));
+    norm = std::max(norm, std::abs(std_vec[i]));
+  }
+  delete [] std_vec;
+  return (norm > 0) ? diff / norm : diff;
+}
+
+// Loads the L-shaped domain, refines it and shifts the inner vertices.
+void init_mesh(Mesh* mesh, int ref_num)
+{
+  H2DReader mloader;
+  mloader.load("../lshape.mesh", mesh);
+  for (int i = 0; i < ref_num; i++) mesh->refine_all_elements();
+
+  Node* node;
+  for_all_vertex_nodes(node, mesh) {
+    if (!node->bnd) {
+      double x = node->x, y = node->y;
+      node->x += SHIFT * sin(M_PI * (x + 2 * y));
+      node->y += SHIFT * cos(M_PI * (2 * x - y));
+    }
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  Mesh mesh;
+  init_mesh(&mesh, INIT_REF_NUM);
+
+  CustomExactSolution exact_sln(&mesh);
+  DefaultWeakFormLaplace wf;
+  DefaultEssentialBCNonConst bc_essential(BDY_DIRICHLET, &exact_sln);
+  EssentialBCs bcs(&bc_essential);
+  H1Space space(&mesh, &bcs, P_INIT);
+  H1ProjBasedSelector selector(CAND_LIST, CONV_EXP, H2DRS_DEFAULT_ORDER);
+
+  bool success = true;
+  double total_std_time = 0, total_sum_fact_time = 0;
+  int as = 1;
+  bool done = false;
+  do
+  {
+    Space* ref_space = Space::construct_refined_space(&space);
+
+    scalar* ref_vec;
+    double std_time, sum_fact_time;
+    double diff = compare(&wf, ref_space, ref_vec, std_time, sum_fact_time);
+    if (diff > TOLERANCE) success = false;
+    total_std_time += std_time;
+    total_sum_fact_time += sum_fact_time;
+
+    info("step %d, ndof_fine: %d, assembly: %g s (sum factorization: %g s), difference: %g.",
+         as, Space::get_num_dofs(ref_space), std_time, sum_fact_time, diff);
+
+    Solution ref_sln, sln;
+    Solution::vector_to_solution(ref_vec, ref_space, &ref_sln);
+    OGProjection::project_global(&space, &ref_sln, &sln, matrix_solver);
+
+    Adapt adaptivity(&space);
+    double err_est_rel = adaptivity.calc_err_est(&sln, &ref_sln) * 100;
+    if (err_est_rel < ERR_STOP) done = true;
+    else {
+      done = adaptivity.adapt(&selector, THRESHOLD, STRATEGY, MESH_REGULARITY);
+      if (done == false) as++;
+    }
+    if (Space::get_num_dofs(&space) >= NDOF_STOP) done = true;
+
+    delete [] ref_vec;
+    delete ref_space->get_mesh();
+    delete ref_space;
+  }
+  while (done == false);
+
+  info("Total assembly time: %g s (sum factorization: %g s).", total_std_time, total_sum_fact_time);
+
+  // Uniform polynomial degrees.
+  Mesh uniform_mesh;
+  init_mesh(&uniform_mesh, UNIFORM_REF_NUM);
+  for (int p = 2; p <= P_UNIFORM_MAX; p += 2)
+  {
+    H1Space uniform_space(&uniform_mesh, &bcs, p);
+
+    scalar* vec;
+    double std_time, sum_fact_time;
+    double diff = compare(&wf, &uniform_space, vec, std_time, sum_fact_time);
+    if (diff > TOLERANCE) success = false;
+    delete [] vec;
+
+    info("p = %d, ndof: %d, assembly: %g s (sum factorization: %g s), difference: %g.",
+         p, Space::get_num_dofs(&uniform_space), std_time, sum_fact_time, diff);
+  }
+
+  if (success) {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
@@ -0,0 +1,119 @@
+#define HERMES_REPORT_ALL
+#include "hermes2d.h"
+
+//  Location of points in a mesh of about a million elements (two non-affine quads and two
+//  triangles, refined uniformly). The points are located by the spatial index of the mesh
+//  (Mesh::get_element_at()) and, for a few of them, by going through all active elements as
+//  Solution::get_pt_value() did before the index existed. Then the values of a solution are
+//  evaluated by Solution::get_pt_value() in random points and along a line (as in a probe or
+//  a line plot). The elements found by both ways have to coincide.
+//
+//  The following parameters can be changed:
+
+const int INIT_REF_NUM = 9;                       // Number of uniform refinements (4 * 4^9 elements).
+const int NUM_POINTS = 200000;                    // Number of points located by the index.
+const int NUM_SCAN_POINTS = 5;                    // Number of points located by going through the elements.
+const int NUM_LINE_POINTS = 100000;               // Number of points of the line.
+
+// Locates the point by going through all active elements.
+Element* find_by_scan(Mesh* mesh, RefMap* refmap, double x, double y)
+{
+  Element* e;
+  for_all_active_elements(e, mesh)
+  {
+    double xi1, xi2;
+    refmap->set_active_element(e);
+    refmap->untransform(e, x, y, xi1, xi2);
+    if (MeshIndex::is_in_ref_domain(e, xi1, xi2)) return e;
+  }
+  return NULL;
+}
+
+int main(int argc, char* argv[])
+{
+  Mesh mesh;
+  double2 vertices[7] = { {0, 0}, {1, 0}, {2, 0}, {0, 1}, {1.1, 1.2}, {2, 1}, {1, 2} };
+  int4 triangles[2] = { {3, 4, 6, 1}, {4, 5, 6, 1} };
+  int5 quads[2] = { {0, 1, 4, 3, 1}, {1, 2, 5, 4, 1} };
+  int3 boundaries[6] = { {0, 1, 1}, {1, 2, 1}, {2, 5, 1}, {5, 6, 1}, {6, 3, 1}, {3, 0, 1} };
+  mesh.get_element_markers_conversion().insert_marker(1, "0");
+  mesh.get_boundary_markers_conversion().insert_marker(1, "1");
+  mesh.create(7, vertices, 2, triangles, 2, quads, 6, boundaries);
+  for (int i = 0; i < INIT_REF_NUM; i++) mesh.refine_all_elements();
+  info("Active elements: %d.", mesh.get_num_active_elements());
+
+  // Build the index.
+  TimePeriod timer;
+  MeshIndex* index = mesh.get_index();
+  timer.tick();
+  info("Index built in %g s: %d cells, %.2f elements per cell, %lu bytes.", timer.last(),
+       index->get_num_cells(), index->get_avg_cell_size(), (unsigned long) index->get_memory());
+
+  // Random points of the bounding box of the mesh (some of them are outside).
+  srand(1);
+  std::vector<double> x(NUM_POINTS), y(NUM_POINTS);
+  for (int i = 0; i < NUM_POINTS; i++)
+  {
+    x[i] = 2.0 * rand() / RAND_MAX;
+    y[i] = 2.0 * rand() / RAND_MAX;
+  }
+
+  timer.tick(HERMES_SKIP);
+  std::vector<Element*> found(NUM_POINTS);
+  int num_found = 0;
+  for (int i = 0; i < NUM_POINTS; i++)
+  {
+    found[i] = mesh.get_element_at(x[i], y[i]);
+    if (found[i] != NULL) num_found++;
+  }
+  timer.tick();
+  double t_index = timer.last() / NUM_POINTS;
+  info("Index: %d points (%d in the mesh), %g us per point.", NUM_POINTS, num_found, 1e6 * t_index);
+
+  bool success = true;
+  RefMap refmap;
+  timer.tick(HERMES_SKIP);
+  for (int i = 0; i < NUM_SCAN_POINTS; i++)
+    if (find_by_scan(&mesh, &refmap, x[i], y[i]) != found[i])
+    {
+      info("Point (%g, %g) located in different elements.", x[i], y[i]);
+      success = false;
+    }
+  timer.tick();
+  double t_scan = timer.last() / NUM_SCAN_POINTS;
+  info("Scan: %d points, %g us per point, speedup of the index: %g.", NUM_SCAN_POINTS, 1e6 * t_scan,
+       t_scan / t_index);
+
+  // A linear solution, evaluated in the random points and along a line.
+  H1Space space(&mesh, 1);
+  int ndof = space.get_num_dofs();
+  std::vector<scalar> coeffs(ndof);
+  for (int i = 0; i < ndof; i++)
+    coeffs[i] = sin((double) i);
+  Solution sln;
+  Solution::vector_to_solution(&coeffs[0], &space, &sln);
+
+  timer.tick(HERMES_SKIP);
+  for (int i = 0; i < NUM_POINTS; i++)
+    if (found[i] != NULL) sln.get_pt_value(x[i], y[i]);
+  timer.tick();
+  info("Solution::get_pt_value() in random points: %g us per point.", 1e6 * timer.last() / num_found);
+
+  timer.tick(HERMES_SKIP);
+  for (int i = 0; i < NUM_LINE_POINTS; i++)
+  {
+    double t = (i + 0.5) / NUM_LINE_POINTS;
+    sln.get_pt_value(0.1 + 1.8 * t, 0.05 + 0.9 * t);
+  }
+  timer.tick();
+  info("Solution::get_pt_value() along a line: %g us per point.", 1e6 * timer.last() / NUM_LINE_POINTS);
+
+  if (success) {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
@@ -0,0 +1,168 @@
+#define HERMES_REPORT_ALL
+#include "hermes2d.h"
+
+//  Throughput of the evaluation of shape functions. The values and the first derivatives of
+//  all functions of a shapeset are evaluated in the points of the standard quadratures of
+//  several orders, once by the generated shapeset (one call of Shapeset::get_value() per
+//  function, derivative and point, as in PrecalcShapeset) and once by the recurrences of
+//  ShapesetEngine (the whole basis in one pass over the points). The results have to coincide.
+//  Then the tables of all functions are precalculated by a PrecalcShapeset with and without
+//  the engine (PrecalcShapeset::set_shapeset_engine()).
+//
+//  The following parameters can be changed:
+
+const int ORDERS[] = { 2, 6, 10, 14, 19 };        // Orders of the quadratures.
+const double MIN_TIME = 0.05;                     // Minimum measured time per evaluation (s).
+const double TOLERANCE = 1e-10;                   // Allowed relative difference of the values.
+
+// Points of a quadrature.
+struct Points
+{
+  int np;
+  std::vector<double> x, y;
+};
+
+// Evaluates the functions by the generated shapeset: the values, x and y derivatives of the
+// function index in the point i are values[(k * nf + index) * np + i] for k = 0, 1, 2.
+void eval_generated(Shapeset* shapeset, ShapesetEngine* engine, int mode, Points& pts, double* values)
+{
+  int nf = engine->get_max_index(mode) + 1;
+  for (int k = 0; k < 3; k++)
+    for (int index = 0; index < nf; index++)
+    {
+      double* v = values + (k * nf + index) * pts.np;
+      for (int i = 0; i < pts.np; i++)
+        v[i] = shapeset->get_value(k, index, pts.x[i], pts.y[i], 0);
+    }
+}
+
+// Evaluates the functions by the engine.
+void eval_engine(Shapeset* shapeset, ShapesetEngine* engine, int mode, Points& pts, double* values)
+{
+  int nf = engine->get_max_index(mode) + 1;
+  double* result[6] = { values, values + nf * pts.np, values + 2 * nf * pts.np, NULL, NULL, NULL };
+  engine->eval(mode, pts.np, &pts.x[0], &pts.y[0], result);
+}
+
+// Calls eval for at least MIN_TIME, returns the time of one call.
+double measure(void (*eval)(Shapeset*, ShapesetEngine*, int, Points&, double*),
+               Shapeset* shapeset, ShapesetEngine* engine, int mode, Points& pts, double* values)
+{
+  TimePeriod timer;
+  int n = 0;
+  do {
+    eval(shapeset, engine, mode, pts, values);
+    n++;
+    timer.tick();
+  } while (timer.accumulated() < MIN_TIME);
+  return timer.accumulated() / n;
+}
+
+// Compares the two evaluations in the points of the quadrature of the order, returns false if
+// they differ.
+bool compare(const char* name, Shapeset* shapeset, ShapesetEngine* engine, int mode, int order)
+{
+  shapeset->set_mode(mode);
+  g_quad_2d_std.set_mode(mode);
+  Points pts;
+  pts.np = g_quad_2d_std.get_num_points(order);
+  double3* pt = g_quad_2d_std.get_points(order);
+  for (int i = 0; i < pts.np; i++) {
+    pts.x.push_back(pt[i][0]);
+    pts.y.push_back(pt[i][1]);
+  }
+
+  int nf = engine->get_max_index(mode) + 1;
+  std::vector<double> a(3 * nf * pts.np), b(3 * nf * pts.np);
+  double t_generated = measure(eval_generated, shapeset, engine, mode, pts, &a[0]);
+  double t_engine = measure(eval_engine, shapeset, engine, mode, pts, &b[0]);
+
+  // The differences are relative to the maximum of each function.
+  double diff = 0;
+  for (int k = 0; k < 3; k++)
+    for (int index = 0; index < nf; index++) {
+      double d = 0, norm = 0;
+      for (int i = 0; i < pts.np; i++) {
+        int j = (k * nf + index) * pts.np + i;
+        d = std::max(d, std::abs(a[j] - b[j]));
+        norm = std::max(norm, std::abs(a[j]));
+      }
+      diff = std::max(diff, d / std::max(norm, 1.0));
+    }
+
+  info("%-10s %-9s order: %2d, functions: %3d, points: %3d, generated: %7.2f ns, engine: %7.2f ns "
+       "per function and point, speedup: %5.2f, difference: %g.",
+       name, (mode == HERMES_MODE_TRIANGLE) ? "triangle" : "quad", order, nf, pts.np,
+       1e9 * t_generated / (nf * pts.np), 1e9 * t_engine / (nf * pts.np), t_generated / t_engine, diff);
+  return diff <= TOLERANCE;
+}
+
+// Precalculates the tables of the values and the first derivatives of all functions on the
+// element by a new PrecalcShapeset, with the engine if not NULL, returns the time.
+double precalculate(Shapeset* shapeset, ShapesetEngine* engine, Element* e, int order)
+{
+  TimePeriod timer;
+  int n = 0;
+  do {
+    PrecalcShapeset pss(shapeset);
+    pss.set_shapeset_engine(engine);
+    pss.set_active_element(e);
+    for (int index = 0; index <= shapeset->get_max_index(); index++) {
+      pss.set_active_shape(index);
+      pss.set_quad_order(order);
+    }
+    n++;
+    timer.tick();
+  } while (timer.accumulated() < MIN_TIME);
+  return timer.accumulated() / n;
+}
+
+void compare_pss(const char* name, Shapeset* shapeset, ShapesetEngine* engine, Element* e, int order)
+{
+  double t_generated = precalculate(shapeset, NULL, e, order);
+  double t_engine = precalculate(shapeset, engine, e, order);
+  info("%-10s %-9s order: %2d, PrecalcShapeset: %8.2f us, with the engine: %8.2f us, speedup: %5.2f.",
+       name, e->is_triangle() ? "triangle" : "quad", order, 1e6 * t_generated, 1e6 * t_engine,
+       t_generated / t_engine);
+}
+
+int main(int argc, char* argv[])
+{
+  H1ShapesetJacobi h1_shapeset;
+  L2ShapesetLegendre l2_shapeset;
+  ShapesetEngine h1_engine(&h1_shapeset);
+  ShapesetEngine l2_engine(&l2_shapeset);
+
+  bool success = true;
+  for (int mode = 0; mode < 2; mode++) {
+    for (unsigned int i = 0; i < sizeof(ORDERS) / sizeof(int); i++) {
+      success &= compare("H1 Jacobi", &h1_shapeset, &h1_engine, mode, ORDERS[i]);
+      success &= compare("L2", &l2_shapeset, &l2_engine, mode, ORDERS[i]);
+    }
+  }
+
+  // A mesh with one triangle and one quad.
+  Mesh mesh;
+  double2 vertices[5] = { {0, 0}, {1, 0}, {1.3, 1}, {0.3, 1}, {2, 0.2} };
+  int4 triangles[1] = { {1, 4, 2, 1} };
+  int5 quads[1] = { {0, 1, 2, 3, 1} };
+  int3 boundaries[5] = { {0, 1, 1}, {2, 3, 1}, {3, 0, 1}, {1, 4, 1}, {4, 2, 1} };
+  mesh.get_element_markers_conversion().insert_marker(1, "0");
+  mesh.get_boundary_markers_conversion().insert_marker(1, "1");
+  mesh.create(5, vertices, 1, triangles, 1, quads, 5, boundaries);
+  for (int id = 0; id < 2; id++) {
+    for (unsigned int i = 0; i < sizeof(ORDERS) / sizeof(int); i++) {
+      compare_pss("H1 Jacobi", &h1_shapeset, &h1_engine, mesh.get_element(id), ORDERS[i]);
+      compare_pss("L2", &l2_shapeset, &l2_engine, mesh.get_element(id), ORDERS[i]);
+    }
+  }
+
+  if (success) {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
@@ -0,0 +1,121 @@
+#define HERMES_REPORT_ALL
+#include "hermes2d.h"
+
+//  Conjugate gradients with the native smoothed aggregation AMG preconditioner (AMGPrecond)
+//  for the matrices of the benchmark nist-01 on a sequence of uniformly refined meshes.
+//  The numbers of iterations should stay roughly constant as the mesh is refined. On every
+//  mesh, the values of the matrix are then changed (as in a time step or a Newton iteration
+//  with a different coefficient) and the preconditioner is recomputed with setup reuse.
+//
+//  The near null space passed to AMGPrecond is the constant function, i.e. one for the
+//  vertex functions and zero for the higher-order functions of the hierarchic shapeset.
+//
+//  The following parameters can be changed:
+
+const int P_INIT[2] = {1, 3};                     // Polynomial degrees of all mesh elements.
+const int INIT_REF_NUM_MIN = 4;                   // Numbers of initial uniform mesh refinements.
+const int INIT_REF_NUM_MAX = 7;
+const double TOLERANCE = 1e-8;                    // Relative residual of CG.
+const double MAX_ITER_GROWTH = 1.5;               // Allowed growth of the number of iterations from
+                                                  // the coarsest to the finest mesh.
+const double REACTION = 1.0;                      // Added to the diagonal of the matrix for the setup reuse.
+
+// Problem parameters.
+double EXACT_SOL_P = 10;                          // The exact solution is a polynomial of degree 2*EXACT_SOL_P in the x-direction
+                                                  // as well as in the y-direction.
+
+// Boundary markers.
+const std::string BDY_DIRICHLET = "1";
+
+// Weak forms.
+#include "../definitions.cpp"
+
+// Vector of the coefficients of the constant function (without Dirichlet lift).
+void constant_function(Space* space, scalar* nns)
+{
+  memset(nns, 0, sizeof(scalar) * space->get_num_dofs());
+  Shapeset* shapeset = space->get_shapeset();
+  Element* e;
+  AsmList al;
+  for_all_active_elements(e, space->get_mesh()) {
+    space->get_element_assembly_list(e, &al);
+    shapeset->set_mode(e->get_mode());
+    for (unsigned int k = 0; k < al.cnt; k++)
+      for (int i = 0; i < e->get_num_surf(); i++)
+        if (al.dof[k] >= 0 && al.idx[k] == shapeset->get_vertex_index(i))
+          nns[al.dof[k]] = 1.0;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  Mesh basemesh;
+  H2DReader mloader;
+  mloader.load("../square_quad.mesh", &basemesh);
+
+  CustomRightHandSide rhs_fn(EXACT_SOL_P);
+  CustomWeakFormPoisson wf(&rhs_fn);
+
+  bool success = true;
+  for (int p = 0; p < 2; p++) {
+    int first_iters = -1, last_iters = -1;
+    for (int ref_num = INIT_REF_NUM_MIN; ref_num <= INIT_REF_NUM_MAX; ref_num++) {
+      Mesh mesh;
+      mesh.copy(&basemesh);
+      for (int i = 0; i < ref_num; i++) mesh.refine_all_elements();
+
+      CustomExactSolution exact(&mesh, EXACT_SOL_P);
+      DefaultEssentialBCNonConst bc_essential(BDY_DIRICHLET, &exact);
+      EssentialBCs bcs(&bc_essential);
+      H1Space space(&mesh, &bcs, P_INIT[p]);
+      int ndof = space.get_num_dofs();
+
+      bool is_linear = true;
+      DiscreteProblem dp(&wf, &space, is_linear);
+      CSRMatrix matrix;
+      CSRVector rhs;
+      dp.assemble(&matrix, &rhs);
+
+      CGSolver solver(&matrix, &rhs);
+      solver.set_tolerance(TOLERANCE);
+      AMGPrecond amg;
+      solver.set_precond(&amg);
+      amg.create(&matrix);
+      scalar* nns = new scalar[ndof];
+      constant_function(&space, nns);
+      amg.set_near_null_space(nns);
+      delete [] nns;
+
+      TimePeriod timer;
+      if (!solver.solve()) success = false;
+      timer.tick();
+      info("p: %d, ndof: %d, levels: %d, operator complexity: %g, iterations: %d, time: %g s.",
+           P_INIT[p], ndof, amg.get_num_levels(), amg.get_operator_complexity(), solver.get_num_iters(),
+           timer.last());
+      if (amg.get_num_levels() > 1) {
+        if (first_iters < 0) first_iters = solver.get_num_iters();
+        last_iters = solver.get_num_iters();
+      }
+
+      // New values, the same structure.
+      matrix.add_to_diagonal(REACTION);
+      timer.tick();
+      if (!solver.solve()) success = false;
+      timer.tick();
+      info("Setup reused: iterations: %d, time: %g s.", solver.get_num_iters(), timer.last());
+    }
+    if (last_iters > MAX_ITER_GROWTH * first_iters) {
+      info("The number of iterations grows from %d to %d.", first_iters, last_iters);
+      success = false;
+    }
+  }
+
+  if (success) {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
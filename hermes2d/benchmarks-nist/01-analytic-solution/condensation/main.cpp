@@ -0,0 +1,117 @@
+#define HERMES_REPORT_ALL
+#include "hermes2d.h"
+
+//  Static condensation of the bubble DOFs (DiscreteProblem::set_static_condensation())
+//  for the benchmark nist-01 with high polynomial degrees on uniformly refined meshes.
+//  The full system and the condensed system of the vertex and edge DOFs are assembled
+//  and solved, the bubble DOFs are then recovered by back substitution. The sizes of the
+//  systems and the times are compared, and the two solutions have to coincide.
+//
+//  The following parameters can be changed:
+
+const int P_INIT[3] = {4, 6, 8};                  // Polynomial degrees of all mesh elements.
+const int INIT_REF_NUM_MIN = 2;                   // Numbers of initial uniform mesh refinements.
+const int INIT_REF_NUM_MAX = 4;
+const double TOLERANCE = 1e-6;                    // Allowed relative difference of the two solutions.
+MatrixSolverType matrix_solver = SOLVER_UMFPACK;  // Possibilities: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
+                                                  // SOLVER_PETSC, SOLVER_SUPERLU, SOLVER_UMFPACK, SOLVER_KRYLOV.
+
+// Problem parameters.
+double EXACT_SOL_P = 10;                          // The exact solution is a polynomial of degree 2*EXACT_SOL_P in the x-direction
+                                                  // as well as in the y-direction.
+
+// Boundary markers.
+const std::string BDY_DIRICHLET = "1";
+
+// Weak forms.
+#include "../definitions.cpp"
+
+// Assembles and solves the system of dp, returns the vector of all DOFs.
+scalar* solve(DiscreteProblem* dp, double& assembly_time, double& solve_time)
+{
+  SparseMatrix* matrix = create_matrix(matrix_solver);
+  Vector* rhs = create_vector(matrix_solver);
+  Solver* solver = create_linear_solver(matrix_solver, matrix, rhs);
+
+  TimePeriod timer;
+  dp->assemble(matrix, rhs);
+  timer.tick();
+  assembly_time = timer.last();
+  if (!solver->solve()) error ("Matrix solver failed.\n");
+  timer.tick();
+  solve_time = timer.last();
+
+  scalar* coeff_vec = new scalar[dp->get_num_dofs()];
+  if (dp->get_static_condensation())
+    dp->back_substitute_bubbles(solver->get_solution(), coeff_vec);
+  else
+    memcpy(coeff_vec, solver->get_solution(), sizeof(scalar) * dp->get_num_dofs());
+
+  delete solver;
+  delete matrix;
+  delete rhs;
+  return coeff_vec;
+}
+
+int main(int argc, char* argv[])
+{
+  Mesh basemesh;
+  H2DReader mloader;
+  mloader.load("../square_quad.mesh", &basemesh);
+
+  CustomRightHandSide rhs_fn(EXACT_SOL_P);
+  CustomWeakFormPoisson wf(&rhs_fn);
+
+  Hermes2D hermes2d;
+  bool success = true;
+  for (int p = 0; p < 3; p++) {
+    for (int ref_num = INIT_REF_NUM_MIN; ref_num <= INIT_REF_NUM_MAX; ref_num++) {
+      Mesh mesh;
+      mesh.copy(&basemesh);
+      for (int i = 0; i < ref_num; i++) mesh.refine_all_elements();
+
+      CustomExactSolution exact(&mesh, EXACT_SOL_P);
+      DefaultEssentialBCNonConst bc_essential(BDY_DIRICHLET, &exact);
+      EssentialBCs bcs(&bc_essential);
+      H1Space space(&mesh, &bcs, P_INIT[p]);
+      int ndof = space.get_num_dofs();
+
+      bool is_linear = true;
+      double full_assembly_time, full_solve_time;
+      DiscreteProblem dp(&wf, &space, is_linear);
+      scalar* full_vec = solve(&dp, full_assembly_time, full_solve_time);
+
+      double cond_assembly_time, cond_solve_time;
+      DiscreteProblem dp_cond(&wf, &space, is_linear);
+      dp_cond.set_static_condensation(true);
+      scalar* cond_vec = solve(&dp_cond, cond_assembly_time, cond_solve_time);
+
+      double diff = 0, norm = 0;
+      for (int i = 0; i < ndof; i++) {
+        diff = std::max(diff, std::abs(cond_vec[i] - full_vec[i]));
+        norm = std::max(norm, std::abs(full_vec[i]));
+      }
+      if (diff > TOLERANCE * norm) success = false;
+
+      Solution sln;
+      Solution::vector_to_solution(cond_vec, &space, &sln);
+      double err = hermes2d.calc_rel_error(&sln, &exact, HERMES_H1_NORM) * 100;
+
+      info("p: %d, ndof: %d (condensed: %d), assembly: %g s (condensed: %g s), solution: %g s (condensed: %g s), "
+           "difference: %g, error: %g%%.", P_INIT[p], ndof, dp_cond.get_num_condensed_dofs(),
+           full_assembly_time, cond_assembly_time, full_solve_time, cond_solve_time, diff / norm, err);
+
+      delete [] full_vec;
+      delete [] cond_vec;
+    }
+  }
+
+  if (success) {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
@@ -0,0 +1,145 @@
+#define HERMES_REPORT_ALL
+#include "hermes2d.h"
+
+using namespace RefinementSelectors;
+
+//  Incremental assembling (DiscreteProblem::set_element_matrix_cache()) in the hp-adaptivity
+//  of the benchmark nist-01. In every adaptivity step, the system on the reference mesh is
+//  assembled without the cache and with a cache that is kept between the steps, so only the
+//  elements changed by the last adaptation are computed. The assembly times and the numbers
+//  of elements found in the cache are compared, and the two solutions have to coincide.
+//
+//  The following parameters can be changed:
+
+const int P_INIT = 2;                             // Initial polynomial degree of all mesh elements.
+const int INIT_REF_NUM = 1;                       // Number of initial uniform mesh refinements.
+const double THRESHOLD = 0.3;                     // Parameter of the adapt(...) function.
+const int STRATEGY = 0;                           // Adaptive strategy.
+const CandList CAND_LIST = H2D_HP_ANISO_H;        // Predefined list of element refinement candidates.
+const int MESH_REGULARITY = -1;                   // Maximum allowed level of hanging nodes.
+const double CONV_EXP = 0.5;                      // Parameter of the hp-adaptivity.
+const double ERR_STOP = 0.1;                      // Stopping criterion for adaptivity (rel. error tolerance between the
+                                                  // reference mesh and coarse mesh solution in percent).
+const int NDOF_STOP = 20000;                      // Adaptivity process stops when the number of degrees of freedom grows
+                                                  // over this limit.
+const double TOLERANCE = 1e-8;                    // Allowed relative difference of the two solutions.
+MatrixSolverType matrix_solver = SOLVER_UMFPACK;  // Possibilities: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
+                                                  // SOLVER_PETSC, SOLVER_SUPERLU, SOLVER_UMFPACK.
+
+// Problem parameters.
+double EXACT_SOL_P = 10;                          // The exact solution is a polynomial of degree 2*EXACT_SOL_P in the x-direction
+                                                  // as well as in the y-direction.
+
+// Boundary markers.
+const std::string BDY_DIRICHLET = "1";
+
+// Weak forms.
+#include "../definitions.cpp"
+
+// Assembles and solves the system of dp, returns the vector of all DOFs.
+scalar* solve(DiscreteProblem* dp, double& assembly_time)
+{
+  SparseMatrix* matrix = create_matrix(matrix_solver);
+  Vector* rhs = create_vector(matrix_solver);
+  Solver* solver = create_linear_solver(matrix_solver, matrix, rhs);
+
+  TimePeriod timer;
+  dp->assemble(matrix, rhs);
+  timer.tick();
+  assembly_time = timer.last();
+  if (!solver->solve()) error ("Matrix solver failed.\n");
+
+  scalar* coeff_vec = new scalar[dp->get_num_dofs()];
+  memcpy(coeff_vec, solver->get_solution(), sizeof(scalar) * dp->get_num_dofs());
+
+  delete solver;
+  delete matrix;
+  delete rhs;
+  return coeff_vec;
+}
+
+int main(int argc, char* argv[])
+{
+  Mesh mesh;
+  H2DReader mloader;
+  mloader.load("../square_quad.mesh", &mesh);
+  for (int i = 0; i < INIT_REF_NUM; i++) mesh.refine_all_elements();
+
+  CustomExactSolution exact(&mesh, EXACT_SOL_P);
+  CustomRightHandSide rhs_fn(EXACT_SOL_P);
+  CustomWeakFormPoisson wf(&rhs_fn);
+  // The values of the forms depend only on the element, they can be cached.
+  for (unsigned int i = 0; i < wf.get_mfvol().size(); i++) wf.get_mfvol()[i]->cache_values = true;
+  for (unsigned int i = 0; i < wf.get_vfvol().size(); i++) wf.get_vfvol()[i]->cache_values = true;
+  DefaultEssentialBCNonConst bc_essential(BDY_DIRICHLET, &exact);
+  EssentialBCs bcs(&bc_essential);
+  H1Space space(&mesh, &bcs, P_INIT);
+  H1ProjBasedSelector selector(CAND_LIST, CONV_EXP, H2DRS_DEFAULT_ORDER);
+
+  // The cache is kept during the whole adaptivity.
+  ElementMatrixCache cache;
+
+  bool success = true;
+  double total_full_time = 0, total_incr_time = 0;
+  int as = 1;
+  bool done = false;
+  do
+  {
+    Space* ref_space = Space::construct_refined_space(&space);
+    int ndof = Space::get_num_dofs(ref_space);
+
+    bool is_linear = true;
+    double full_time, incr_time;
+    DiscreteProblem dp(&wf, ref_space, is_linear);
+    scalar* full_vec = solve(&dp, full_time);
+
+    unsigned long hits = cache.get_num_hits(), misses = cache.get_num_misses();
+    DiscreteProblem dp_incr(&wf, ref_space, is_linear);
+    dp_incr.set_element_matrix_cache(&cache);
+    scalar* incr_vec = solve(&dp_incr, incr_time);
+    hits = cache.get_num_hits() - hits;
+    misses = cache.get_num_misses() - misses;
+
+    double diff = 0, norm = 0;
+    for (int i = 0; i < ndof; i++) {
+      diff = std::max(diff, std::abs(incr_vec[i] - full_vec[i]));
+      norm = std::max(norm, std::abs(full_vec[i]));
+    }
+    if (diff > TOLERANCE * norm) success = false;
+    total_full_time += full_time;
+    total_incr_time += incr_time;
+
+    info("step %d, ndof_fine: %d, elements reused: %lu of %lu, assembly: %g s (incremental: %g s), "
+         "difference: %g.", as, ndof, hits, hits + misses, full_time, incr_time, diff / norm);
+
+    Solution ref_sln, sln;
+    Solution::vector_to_solution(incr_vec, ref_space, &ref_sln);
+    OGProjection::project_global(&space, &ref_sln, &sln, matrix_solver);
+
+    Adapt adaptivity(&space);
+    double err_est_rel = adaptivity.calc_err_est(&sln, &ref_sln) * 100;
+    if (err_est_rel < ERR_STOP) done = true;
+    else {
+      done = adaptivity.adapt(&selector, THRESHOLD, STRATEGY, MESH_REGULARITY);
+      if (done == false) as++;
+    }
+    if (Space::get_num_dofs(&space) >= NDOF_STOP) done = true;
+
+    delete [] full_vec;
+    delete [] incr_vec;
+    delete ref_space->get_mesh();
+    delete ref_space;
+  }
+  while (done == false);
+
+  info("Total assembly time: %g s (incremental: %g s).", total_full_time, total_incr_time);
+
+  if (success) {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
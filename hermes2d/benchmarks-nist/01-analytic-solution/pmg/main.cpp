@@ -0,0 +1,90 @@
+#define HERMES_REPORT_ALL
+#include "hermes2d.h"
+
+//  Conjugate gradients with the p-multigrid preconditioner (PMultigridPrecond) for the
+//  benchmark nist-01 with high polynomial degrees on uniformly refined meshes. The
+//  lowest-order problem is solved by AMG. The numbers of iterations are compared to CG
+//  with ILU(0), and the error of the solution against the exact one is reported.
+//
+//  The following parameters can be changed:
+
+const int P_INIT[3] = {6, 8, 10};                 // Polynomial degrees of all mesh elements.
+const int INIT_REF_NUM_MIN = 2;                   // Numbers of initial uniform mesh refinements.
+const int INIT_REF_NUM_MAX = 4;
+const double TOLERANCE = 1e-10;                   // Relative residual of CG.
+const int MAX_ITERS = 50;                         // The test fails if p-multigrid needs more iterations.
+
+// Problem parameters.
+double EXACT_SOL_P = 10;                          // The exact solution is a polynomial of degree 2*EXACT_SOL_P in the x-direction
+                                                  // as well as in the y-direction.
+
+// Boundary markers.
+const std::string BDY_DIRICHLET = "1";
+
+// Weak forms.
+#include "../definitions.cpp"
+
+int main(int argc, char* argv[])
+{
+  Mesh basemesh;
+  H2DReader mloader;
+  mloader.load("../square_quad.mesh", &basemesh);
+
+  CustomRightHandSide rhs_fn(EXACT_SOL_P);
+  CustomWeakFormPoisson wf(&rhs_fn);
+
+  Hermes2D hermes2d;
+  bool success = true;
+  for (int p = 0; p < 3; p++) {
+    for (int ref_num = INIT_REF_NUM_MIN; ref_num <= INIT_REF_NUM_MAX; ref_num++) {
+      Mesh mesh;
+      mesh.copy(&basemesh);
+      for (int i = 0; i < ref_num; i++) mesh.refine_all_elements();
+
+      CustomExactSolution exact(&mesh, EXACT_SOL_P);
+      DefaultEssentialBCNonConst bc_essential(BDY_DIRICHLET, &exact);
+      EssentialBCs bcs(&bc_essential);
+      H1Space space(&mesh, &bcs, P_INIT[p]);
+
+      bool is_linear = true;
+      DiscreteProblem dp(&wf, &space, is_linear);
+      CSRMatrix matrix;
+      CSRVector rhs;
+      dp.assemble(&matrix, &rhs);
+
+      CGSolver solver(&matrix, &rhs);
+      solver.set_tolerance(TOLERANCE);
+      PMultigridPrecond pmg(&space);
+      solver.set_precond(&pmg);
+      TimePeriod timer;
+      if (!solver.solve() || solver.get_num_iters() > MAX_ITERS) success = false;
+      timer.tick();
+      int pmg_iters = solver.get_num_iters();
+      double pmg_time = timer.last();
+
+      Solution sln;
+      Solution::vector_to_solution(solver.get_solution(), &space, &sln);
+      double err = hermes2d.calc_rel_error(&sln, &exact, HERMES_H1_NORM) * 100;
+
+      CGSolver ilu_solver(&matrix, &rhs);
+      ilu_solver.set_tolerance(TOLERANCE);
+      ilu_solver.set_precond("ilu0");
+      timer.tick();
+      ilu_solver.solve();
+      timer.tick();
+
+      info("p: %d, ndof: %d, levels: %d, iterations: %d (ILU(0): %d), time: %g s (ILU(0): %g s), error: %g%%.",
+           P_INIT[p], space.get_num_dofs(), pmg.get_num_levels(), pmg_iters, ilu_solver.get_num_iters(),
+           pmg_time, timer.last(), err);
+    }
+  }
+
+  if (success) {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
@@ -0,0 +1,125 @@
+#define HERMES_REPORT_ALL
+#include "hermes2d.h"
+
+//  Scaling of threaded assembling (DiscreteProblem::set_num_threads()) on the problem
+//  of the benchmark nist-01. The matrix and the right-hand side are assembled on a fixed
+//  uniform mesh with 1, 2, 4, ... threads, the wall-clock times are compared to the serial
+//  assembling, and the assembled systems are checked to match the serial ones.
+//
+//  Usage: nist-01-scaling [max_threads]
+//
+//  The following parameters can be changed:
+
+const int P_INIT = 4;                             // Polynomial degree of all mesh elements.
+const int INIT_REF_NUM = 6;                       // Number of initial uniform mesh refinements.
+const int NUM_REPEAT = 3;                         // Number of assemblings measured for each thread count.
+const int DEFAULT_MAX_THREADS = 8;                // Largest thread count tried, unless given on the command line.
+const double TOLERANCE = 1e-12;                   // Allowed relative difference from the serial assembling.
+
+// Problem parameters.
+double EXACT_SOL_P = 10;                          // The exact solution is a polynomial of degree 2*EXACT_SOL_P in the x-direction
+                                                  // as well as in the y-direction. 
+
+// Boundary markers.
+const std::string BDY_DIRICHLET = "1";
+
+// Weak forms.
+#include "../definitions.cpp"
+
+// Assembles the problem using the given number of threads, returns the best wall-clock time.
+double assemble(WeakForm* wf, Space* space, int num_threads, CSCMatrix* matrix, UMFPackVector* rhs)
+{
+  bool is_linear = true;
+  DiscreteProblem dp(wf, space, is_linear);
+  dp.set_num_threads(num_threads);
+
+  double best = -1.0;
+  for (int i = 0; i < NUM_REPEAT; i++) {
+    TimePeriod timer;
+    dp.assemble(matrix, rhs);
+    timer.tick();
+    if (best < 0 || timer.last() < best) best = timer.last();
+  }
+  return best;
+}
+
+// Returns the largest difference between the entries of the arrays relative to the largest entry of 'ref'.
+double rel_difference(scalar* ref, scalar* val, int n)
+{
+  double diff = 0.0, norm = 0.0;
+  for (int i = 0; i < n; i++) {
+    diff = std::max(diff, std::abs(ref[i] - val[i]));
+    norm = std::max(norm, std::abs(ref[i]));
+  }
+  return (norm > 0) ? diff / norm : diff;
+}
+
+int main(int argc, char* argv[])
+{
+  int max_threads = (argc > 1) ? atoi(argv[1]) : DEFAULT_MAX_THREADS;
+  if (max_threads < 1) error("Invalid number of threads.");
+
+  // Load the mesh.
+  Mesh mesh;
+  H2DReader mloader;
+  mloader.load("../square_quad.mesh", &mesh);
+
+  // Perform initial mesh refinements.
+  for (int i = 0; i < INIT_REF_NUM; i++) mesh.refine_all_elements();
+
+  // Set exact solution.
+  CustomExactSolution exact(&mesh, EXACT_SOL_P);
+
+  // Define right-hand side.
+  CustomRightHandSide rhs_fn(EXACT_SOL_P);
+
+  // Initialize the weak formulation.
+  CustomWeakFormPoisson wf(&rhs_fn);
+
+  // Initialize boundary conditions.
+  DefaultEssentialBCNonConst bc_essential(BDY_DIRICHLET, &exact);
+  EssentialBCs bcs(&bc_essential);
+
+  // Create an H1 space with default shapeset.
+  H1Space space(&mesh, &bcs, P_INIT);
+  int ndof = Space::get_num_dofs(&space);
+  info("ndof: %d, elements: %d.", ndof, mesh.get_num_active_elements());
+
+  // Serial assembling is the reference.
+  CSCMatrix serial_matrix;
+  UMFPackVector serial_rhs;
+  double serial_time = assemble(&wf, &space, 1, &serial_matrix, &serial_rhs);
+  scalar* serial_values = new scalar[ndof];
+  serial_rhs.extract(serial_values);
+  info("threads: 1, assembling time: %g s.", serial_time);
+
+  bool success = true;
+  for (int num_threads = 2; num_threads <= max_threads; num_threads *= 2) {
+    CSCMatrix matrix;
+    UMFPackVector rhs;
+    double time = assemble(&wf, &space, num_threads, &matrix, &rhs);
+
+    scalar* values = new scalar[ndof];
+    rhs.extract(values);
+    double matrix_diff = rel_difference(serial_matrix.get_Ax(), matrix.get_Ax(), serial_matrix.get_nnz());
+    double rhs_diff = rel_difference(serial_values, values, ndof);
+    delete [] values;
+
+    info("threads: %d, assembling time: %g s, speedup: %g, parallel efficiency: %g%%, "
+         "difference from serial: %g (matrix), %g (rhs).", num_threads, time, serial_time / time, 
+         100.0 * serial_time / time / num_threads, matrix_diff, rhs_diff);
+
+    if (matrix.get_nnz() != serial_matrix.get_nnz() || matrix_diff > TOLERANCE || rhs_diff > TOLERANCE)
+      success = false;
+  }
+  delete [] serial_values;
+
+  if (success) {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
@@ -0,0 +1,189 @@
+#define HERMES_REPORT_ALL
+#include "hermes2d.h"
+
+//  Matrix-vector products with CSRMatrix (row-parallel, optionally with row blocks)
+//  compared to CSCMatrix. By default the matrices of the benchmark nist-01 are assembled
+//  on a sequence of uniformly refined meshes (the CSR matrix is assembled directly by
+//  the Discrete problem and checked against the CSC one). Alternatively, matrices dumped
+//  by CSCMatrix::dump(file, name, DF_HERMES_BIN) in other runs can be given on the
+//  command line. Every product is checked against y = A x computed from the CSC arrays.
+//
+//  Usage: nist-01-spmv [max_threads] [matrix files]
+//
+//  The following parameters can be changed:
+
+const int P_INIT = 4;                             // Polynomial degree of all mesh elements.
+const int INIT_REF_NUM_MIN = 4;                   // Numbers of initial uniform mesh refinements
+const int INIT_REF_NUM_MAX = 6;                   // of the assembled matrices.
+const int NUM_PRODUCTS = 20;                      // Number of products measured in every configuration.
+const int DEFAULT_MAX_THREADS = 8;                // Largest thread count tried, unless given on the command line.
+const double TOLERANCE = 1e-12;                   // Allowed relative difference from the reference product.
+
+// Problem parameters.
+double EXACT_SOL_P = 10;                          // The exact solution is a polynomial of degree 2*EXACT_SOL_P in the x-direction
+                                                  // as well as in the y-direction.
+
+// Boundary markers.
+const std::string BDY_DIRICHLET = "1";
+
+// Weak forms.
+#include "../definitions.cpp"
+
+// Reads a matrix dumped in the format DF_HERMES_BIN.
+bool read_matrix(const char* filename, CSCMatrix* mat)
+{
+  FILE* file = fopen(filename, "rb");
+  if (file == NULL) return false;
+
+  char header[8];
+  int ssize, size, nnz;
+  bool ok = fread(header, 1, 8, file) == 8 && memcmp(header, "HERMESX\001", 8) == 0
+            && fread(&ssize, sizeof(int), 1, file) == 1 && ssize == sizeof(scalar)
+            && fread(&size, sizeof(int), 1, file) == 1 && fread(&nnz, sizeof(int), 1, file) == 1;
+  if (ok) {
+    int* ap = new int[size + 1];
+    int* ai = new int[nnz];
+    scalar* ax = new scalar[nnz];
+    ok = fread(ap, sizeof(int), size + 1, file) == (size_t) size + 1
+         && fread(ai, sizeof(int), nnz, file) == (size_t) nnz
+         && fread(ax, sizeof(scalar), nnz, file) == (size_t) nnz;
+    if (ok) mat->create(size, nnz, ap, ai, ax);
+    delete [] ap;
+    delete [] ai;
+    delete [] ax;
+  }
+  fclose(file);
+  return ok;
+}
+
+// Returns the largest difference between the entries of the arrays relative to the largest entry of 'ref'.
+double rel_difference(scalar* ref, scalar* val, int n)
+{
+  double diff = 0.0, norm = 0.0;
+  for (int i = 0; i < n; i++) {
+    diff = std::max(diff, std::abs(ref[i] - val[i]));
+    norm = std::max(norm, std::abs(ref[i]));
+  }
+  return (norm > 0) ? diff / norm : diff;
+}
+
+// Returns the average time of one product.
+double time_products(SparseMatrix* mat, scalar* x, scalar* y)
+{
+  TimePeriod timer;
+  for (int i = 0; i < NUM_PRODUCTS; i++)
+    mat->multiply_with_vector(x, y);
+  timer.tick();
+  return timer.last() / NUM_PRODUCTS;
+}
+
+// Compares the products of the CSR matrix to the CSC one, returns false if they differ.
+bool compare_products(CSCMatrix* csc, CSRMatrix* csr, int max_threads)
+{
+  int n = csc->get_size();
+  scalar* x = new scalar[n];
+  scalar* y = new scalar[n];
+  scalar* ref = new scalar[n];
+  for (int i = 0; i < n; i++) x[i] = sin(0.1 * i) + 1.0;
+
+  // Reference product, column by column.
+  memset(ref, 0, sizeof(scalar) * n);
+  for (int j = 0; j < n; j++)
+    for (int k = csc->get_Ap()[j]; k < csc->get_Ap()[j + 1]; k++)
+      ref[csc->get_Ai()[k]] += csc->get_Ax()[k] * x[j];
+
+  double csc_time = time_products(csc, x, y);
+  info("ndof: %d, nnz: %d, CSC: %g ms.", n, csc->get_nnz(), 1000.0 * csc_time);
+
+  bool success = true;
+  for (int blocks = 0; blocks <= 1; blocks++) {
+    csr->set_row_blocks(blocks != 0);
+    for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+      csr->set_num_threads(num_threads);
+      memset(y, 0, sizeof(scalar) * n);
+      double time = time_products(csr, x, y);
+      double diff = rel_difference(ref, y, n);
+      info("CSR, %s, threads: %d: %g ms, speedup against CSC: %g, difference: %g.",
+           blocks ? "row blocks" : "no row blocks", num_threads, 1000.0 * time, csc_time / time, diff);
+      if (diff > TOLERANCE) success = false;
+    }
+    if (blocks) info("Row blocks: %u for %d rows.", csr->get_num_row_blocks(), n);
+  }
+
+  delete [] x;
+  delete [] y;
+  delete [] ref;
+  return success;
+}
+
+int main(int argc, char* argv[])
+{
+  int max_threads = (argc > 1) ? atoi(argv[1]) : DEFAULT_MAX_THREADS;
+  if (max_threads < 1) error("Invalid number of threads.");
+
+  bool success = true;
+
+  // Dumped matrices.
+  if (argc > 2) {
+    for (int i = 2; i < argc; i++) {
+      CSCMatrix csc;
+      if (!read_matrix(argv[i], &csc)) error("Cannot read the matrix from %s.", argv[i]);
+      info("Matrix %s:", argv[i]);
+      CSRMatrix csr;
+      csr.create_from_csc(&csc);
+      if (!compare_products(&csc, &csr, max_threads)) success = false;
+    }
+  }
+
+  // Matrices of nist-01.
+  else {
+    Mesh basemesh;
+    H2DReader mloader;
+    mloader.load("../square_quad.mesh", &basemesh);
+
+    CustomRightHandSide rhs_fn(EXACT_SOL_P);
+    CustomWeakFormPoisson wf(&rhs_fn);
+
+    for (int ref_num = INIT_REF_NUM_MIN; ref_num <= INIT_REF_NUM_MAX; ref_num++) {
+      Mesh mesh;
+      mesh.copy(&basemesh);
+      for (int i = 0; i < ref_num; i++) mesh.refine_all_elements();
+
+      CustomExactSolution exact(&mesh, EXACT_SOL_P);
+      DefaultEssentialBCNonConst bc_essential(BDY_DIRICHLET, &exact);
+      EssentialBCs bcs(&bc_essential);
+      H1Space space(&mesh, &bcs, P_INIT);
+
+      // A discrete problem keeps the structure of one matrix only.
+      bool is_linear = true;
+      DiscreteProblem dp_csc(&wf, &space, is_linear);
+      DiscreteProblem dp_csr(&wf, &space, is_linear);
+      CSCMatrix csc;
+      CSRMatrix csr;
+      dp_csc.assemble(&csc);
+      dp_csr.assemble(&csr);
+
+      // The directly assembled CSR matrix has to match the converted one.
+      CSRMatrix converted;
+      converted.create_from_csc(&csc);
+      if (converted.get_nnz() != csr.get_nnz()
+          || memcmp(converted.get_Ap(), csr.get_Ap(), sizeof(int) * (csr.get_size() + 1)) != 0
+          || memcmp(converted.get_Aj(), csr.get_Aj(), sizeof(int) * csr.get_nnz()) != 0
+          || rel_difference(converted.get_Ax(), csr.get_Ax(), csr.get_nnz()) > TOLERANCE) {
+        info("The assembled CSR matrix differs from the CSC one.");
+        success = false;
+      }
+
+      if (!compare_products(&csc, &csr, max_threads)) success = false;
+    }
+  }
+
+  if (success) {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
@@ -17,18 +17,23 @@
 #include "integrals/h1.h"
 #include "quadrature/limit_order.h"
 #include "discrete_problem.h"
+#include "static_condensation.h"
 #include "mesh/traverse.h"
 #include "space/space.h"
 #include "shapeset/precalc.h"
 #include "../../hermes_common/matrix.h"
 #include "../../hermes_common/solver/umfpack_solver.h"
+#include "../../hermes_common/solver/krylov.h"
 #include "mesh/refmap.h"
 #include "function/solution.h"
+#include "quadrature/quad_all.h"
+#include "shapeset/shapeset_h1_all.h"
 #include "config.h"
 #include "neighbor.h"
 #include "views/scalar_view.h"
 #include "views/base_view.h"
 #include "boundaryconditions/essential_bcs.h"
+#include <deque>
 
 DiscreteProblem::DiscreteProblem(WeakForm* wf, Hermes::vector<Space *> spaces, 
          bool is_linear) : wf(wf), is_linear(is_linear), wf_seq(-1), spaces(spaces)
@@ -45,6 +50,59 @@ DiscreteProblem::DiscreteProblem(WeakForm* wf, Space* space, bool is_linear)
   init();
 }
 
+DiscreteProblem::DiscreteProblem(DiscreteProblem* master)
+   : wf(master->wf), is_linear(master->is_linear), wf_seq(-1), spaces(master->spaces)
+{
+  _F_
+  sp_seq = new int[wf->get_neq()];
+  memset(sp_seq, -1, sizeof(int) * wf->get_neq());
+
+  matrix_buffer = NULL;
+  matrix_buffer_dim = 0;
+  have_spaces = true;
+  have_matrix = false;
+  values_changed = true;
+  struct_changed = true;
+
+  // Every worker evaluates the shape functions on its own copy of the shapesets.
+  pss = new PrecalcShapeset*[wf->get_neq()];
+  num_user_pss = 0;
+  for (unsigned int i = 0; i < wf->get_neq(); i++) {
+    Shapeset* shapeset = spaces[i]->get_shapeset()->clone();
+    if (shapeset == NULL) error("Shapeset can not be cloned in DiscreteProblem::DiscreteProblem().");
+    own_shapesets.push_back(shapeset);
+    pss[i] = new PrecalcShapeset(shapeset);
+    num_user_pss++;
+  }
+
+  ndof = master->ndof;
+  element_markers_conversion = master->element_markers_conversion;
+  boundary_markers_conversion = master->boundary_markers_conversion;
+  is_fvm = master->is_fvm;
+  vector_valued_forms = master->vector_valued_forms;
+  geom_ord = master->geom_ord;
+
+  // Stages with DG forms are never assembled in threads.
+  DG_matrix_forms_present = false;
+  DG_vector_forms_present = false;
+
+  num_threads = 1;
+  space_mutex = master->space_mutex;
+  thread_pool = NULL;
+
+  condensation = master->condensation;
+  element_system = NULL;
+
+  element_cache = master->element_cache;
+  element_cache_entry = NULL;
+
+  assembling_caches.const_cache_fn.set_memory_limit(master->assembling_caches.const_cache_fn.get_memory_limit());
+  assembling_caches.use_geom_cache = master->assembling_caches.use_geom_cache;
+  assembling_caches.geom_cache.set_memory_limit(master->assembling_caches.geom_cache.get_memory_limit());
+  if (master->assembling_caches.use_sum_fact)
+    set_sum_factorization(true);
+}
+
 void DiscreteProblem::init()
 {
   _F_
@@ -96,6 +154,17 @@ void DiscreteProblem::init()
 
   vector_valued_forms = false;
 
+  // Serial assembling by default.
+  num_threads = 1;
+  space_mutex = NULL;
+  thread_pool = NULL;
+
+  condensation = NULL;
+  element_system = NULL;
+
+  element_cache = NULL;
+  element_cache_entry = NULL;
+
   Geom<Ord> *tmp = init_geom_ord();
   geom_ord = *tmp;
   delete tmp;
@@ -105,12 +174,19 @@ DiscreteProblem::~DiscreteProblem()
 {
   _F_
   free();
+  free_thread_contexts();
+  for (unsigned int i = 0; i < u_ext_slns.size(); i++)
+    delete u_ext_slns[i];
+  delete condensation;
+  delete element_system;
   if (sp_seq != NULL) delete [] sp_seq;
   if (pss != NULL) {
     for(int i = 0; i < num_user_pss; i++)
       delete pss[i];
     delete [] pss;
   }
+  for(unsigned int i = 0; i < own_shapesets.size(); i++)
+    delete own_shapesets[i];
 }
 
 void DiscreteProblem::free()
@@ -131,6 +207,46 @@ int DiscreteProblem::get_num_dofs()
   return ndof;
 }
 
+void DiscreteProblem::set_num_threads(int num_threads)
+{
+  _F_
+  if (num_threads < 1) error("Invalid number of threads (%d) in DiscreteProblem::set_num_threads().", num_threads);
+  if (num_threads != this->num_threads) free_thread_contexts();
+  this->num_threads = num_threads;
+}
+
+void DiscreteProblem::set_static_condensation(bool condense)
+{
+  _F_
+  if (condense == (condensation != NULL)) return;
+  // The workers share the condensation of the master.
+  free_thread_contexts();
+  if (condense) condensation = new StaticCondensation;
+  else {
+    delete condensation;
+    condensation = NULL;
+  }
+  // The size and the structure of the matrix change.
+  free();
+}
+
+int DiscreteProblem::get_num_condensed_dofs()
+{
+  _F_
+  if (condensation == NULL) return get_num_dofs();
+  condensation->update(spaces);
+  return condensation->get_num_skeleton_dofs();
+}
+
+void DiscreteProblem::back_substitute_bubbles(scalar* condensed_vec, scalar* coeff_vec)
+{
+  _F_
+  if (condensation == NULL) error("Static condensation is not turned on in DiscreteProblem::back_substitute_bubbles().");
+  if (condensation->get_num_dofs() != get_num_dofs())
+    error("The spaces have changed since the last assembling in DiscreteProblem::back_substitute_bubbles().");
+  condensation->back_substitute(condensed_vec, coeff_vec);
+}
+
 scalar** DiscreteProblem::get_matrix_buffer(int n)
 {
   _F_
@@ -213,12 +329,19 @@ void DiscreteProblem::create_sparse_structure(SparseMatrix* mat, Vector* rhs,
 
   int ndof = get_num_dofs();
 
+  // The bubble DOFs do not appear in the condensed system.
+  if (condensation != NULL) {
+    if (is_DG) error("Static condensation can not be used with DG forms.");
+    ndof = condensation->get_num_skeleton_dofs();
+  }
+
   if (mat != NULL)  
   {
     // Spaces have changed: create the matrix from scratch.
     have_matrix = true;
     mat->free();
     mat->prealloc(ndof);
+    mat->set_num_pattern_threads(num_threads);
 
     AsmList* al = new AsmList[wf->get_neq()];
     Mesh** meshes = new Mesh*[wf->get_neq()];
@@ -237,6 +360,7 @@ void DiscreteProblem::create_sparse_structure(SparseMatrix* mat, Vector* rhs,
       for (unsigned int i = 0; i < wf->get_neq(); i++) {
         // TODO: do not get the assembly list again if the element was not changed.
         if (e[i] != NULL) spaces[i]->get_element_assembly_list(e[i], &(al[i]));
+        if (e[i] != NULL && condensation != NULL) condensation->map_to_skeleton(&(al[i]));
       }
 
       if(is_DG) {
@@ -293,16 +417,8 @@ void DiscreteProblem::create_sparse_structure(SparseMatrix* mat, Vector* rhs,
 
                   // pretend assembling of the element stiffness matrix
                   // register nonzero elements
-                  for (unsigned int i = 0; i < am->cnt; i++) {
-                    if (am->dof[i] >= 0) {
-                      for (unsigned int j = 0; j < an->cnt; j++) {
-                        if (an->dof[j] >= 0) {
-                          if(blocks[m][el]) mat->pre_add_ij(am->dof[i], an->dof[j]);
-                          if(blocks[el][m]) mat->pre_add_ij(an->dof[j], am->dof[i]);
-                        }
-                      }
-                    }
-                  }
+                  if(blocks[m][el]) mat->pre_add_block(am->cnt, am->dof, an->cnt, an->dof);
+                  if(blocks[el][m]) mat->pre_add_block(an->cnt, an->dof, am->cnt, am->dof);
                   delete an;
                 }
               }
@@ -343,15 +459,7 @@ void DiscreteProblem::create_sparse_structure(SparseMatrix* mat, Vector* rhs,
             AsmList *an = &(al[n]);
 
             // Pretend assembling of the element stiffness matrix.
-            for (unsigned int i = 0; i < am->cnt; i++) {
-              if (am->dof[i] >= 0) {
-                for (unsigned int j = 0; j < an->cnt; j++) {
-                  if (an->dof[j] >= 0) {
-                    mat->pre_add_ij(am->dof[i], an->dof[j]);
-                  }
-                }
-              }
-            }
+            mat->pre_add_block(am->cnt, am->dof, an->cnt, an->dof);
           }
         }
       }
@@ -413,15 +521,32 @@ void DiscreteProblem::convert_coeff_vec(scalar* coeff_vec, Hermes::vector<Soluti
 {
   _F_
   if (coeff_vec != NULL) {
+    // The previous iterate is used on every element only once, so it is evaluated from the
+    // shape functions of pss instead of being converted into monomials.
     for (unsigned int i = 0; i < wf->get_neq(); i++) {
-      Solution* external_solution_i = new Solution(spaces[i]->get_mesh());
-      Solution::vector_to_solution(coeff_vec, spaces[i], external_solution_i, add_dir_lift);
-      u_ext.push_back(external_solution_i);
+      if (i >= u_ext_slns.size()) u_ext_slns.push_back(new Solution(spaces[i]->get_mesh()));
+      u_ext_slns[i]->set_coeff_vector_direct(spaces[i], pss[i], coeff_vec, add_dir_lift);
+      u_ext.push_back(u_ext_slns[i]);
     }
   }
   else for (unsigned int i = 0; i < wf->get_neq(); i++) u_ext.push_back(NULL);
 }
 
+void DiscreteProblem::share_coeff_vec(Hermes::vector<Solution *> & master_u_ext,
+                                      Hermes::vector<Solution *> & u_ext)
+{
+  _F_
+  for (unsigned int i = 0; i < wf->get_neq(); i++) {
+    if (master_u_ext[i] == NULL) {
+      u_ext.push_back(NULL);
+      continue;
+    }
+    if (i >= u_ext_slns.size()) u_ext_slns.push_back(new Solution(spaces[i]->get_mesh()));
+    u_ext_slns[i]->share_coeff_vector_direct(master_u_ext[i], pss[i]);
+    u_ext.push_back(u_ext_slns[i]);
+  }
+}
+
 void DiscreteProblem::initialize_psss(Hermes::vector<PrecalcShapeset *>& spss) 
 {
   _F_
@@ -452,8 +577,21 @@ void DiscreteProblem::assemble(scalar* coeff_vec, SparseMatrix* mat,
   // Sanity checks.
   assemble_sanity_checks(block_weights);
 
+  // Numbering of the DOFs of the condensed system.
+  if (condensation != NULL) condensation->update(spaces);
+
+  // The cached shape functions are kept until the spaces change, the orders until the weak form does.
+  assembling_caches.update(spaces, wf);
+
   // Creating matrix sparse structure.
+  bool structure_reused = is_up_to_date();
   create_sparse_structure(mat, rhs, force_diagonal_blocks, block_weights);
+
+  // The assembly is repeated with the same structure, the matrix may record the positions
+  // of the entries (the first time) or reuse them (the next times).
+  if (mat != NULL && structure_reused) mat->begin_assembly_map();
+
+  if (element_cache != NULL) element_cache->begin(wf);
  
   // Convert the coefficient vector 'coeff_vec' into solutions Hermes::vector 'u_ext'.
   Hermes::vector<Solution *> u_ext = Hermes::vector<Solution *>();
@@ -481,6 +619,16 @@ void DiscreteProblem::assemble(scalar* coeff_vec, SparseMatrix* mat,
   bool want_vector = (rhs != NULL);
   wf->get_stages(spaces, u_ext, stages, want_matrix, want_vector);
 
+  // Static condensation needs all contributions of an element in one assembling state.
+  if (condensation != NULL) {
+    if (stages.size() > 1)
+      error("Static condensation needs all forms to be assembled in one stage.");
+    for (unsigned ss = 0; ss < stages.size(); ss++)
+      for (unsigned int i = 1; i < stages[ss].meshes.size(); i++)
+        if (stages[ss].meshes[i]->get_seq() != stages[ss].meshes[0]->get_seq())
+          error("Static condensation can not be used in multi-mesh assembling.");
+  }
+
   // Loop through all assembling stages -- the purpose of this is increased performance
   // in multi-mesh calculations, where, e.g., only the right hand side uses two meshes.
   // In such a case, the matrix forms are assembled over one mesh, and only the rhs
@@ -494,10 +642,19 @@ void DiscreteProblem::assemble(scalar* coeff_vec, SparseMatrix* mat,
     // mesh of the current test function, then the stage would have 
     // three meshes. By stage functions, all functions are meant: shape 
     // functions (their precalculated values), and mesh functions.
-    assemble_one_stage(stages[ss], mat, rhs, force_diagonal_blocks, 
-                       block_weights, spss, refmap, u_ext);
+    // Stages that allow it are assembled in parallel if more threads were requested.
+    if (num_threads > 1 && is_stage_threadable(stages[ss], u_ext))
+      assemble_one_stage_threaded(stages[ss], mat, rhs, force_diagonal_blocks, 
+                                  block_weights, u_ext);
+    else
+      assemble_one_stage(stages[ss], mat, rhs, force_diagonal_blocks, 
+                         block_weights, spss, refmap, u_ext);
   }
 
+  if (mat != NULL && structure_reused) mat->end_assembly_map();
+
+  if (element_cache != NULL) element_cache->end();
+
   // Deinitialize matrix buffer.
   if(matrix_buffer != NULL)
     delete [] matrix_buffer;
@@ -509,10 +666,6 @@ void DiscreteProblem::assemble(scalar* coeff_vec, SparseMatrix* mat,
     delete *it;
   for(std::vector<RefMap *>::iterator it = refmap.begin(); it != refmap.end(); it++)
     delete *it;
-
-  // Delete the vector u_ext.
-  for(std::vector<Solution *>::iterator it = u_ext.begin(); it != u_ext.end(); it++)
-    delete *it;
 }
 
 void DiscreteProblem::assemble_one_stage(WeakForm::Stage& stage, 
@@ -594,6 +747,574 @@ void DiscreteProblem::assemble_one_stage(WeakForm::Stage& stage,
   }
 }
 
+//// threaded assembling ////////////////////////////////////////////////////////////
+
+// Number of traversal states in a chunk, the unit of work of the assembling threads.
+static const int H2D_THREAD_STATES_PER_CHUNK = 256;
+// Number of chunks per thread that may be traversed ahead of the insertion of the recorded
+// contributions into the global matrix and vector (bounds the memory of the records).
+static const int H2D_THREAD_CHUNKS_AHEAD = 4;
+
+// Matrix that only records what is added to it. The assembling threads insert the local
+// contributions of a chunk of states into the chunk's own instance, the contributions are
+// then inserted into the global matrix chunk by chunk, in the order of the serial traversal.
+// Therefore the global matrix does not need any locking and the sums are evaluated in the
+// same order as in serial assembling.
+class AssemblingRecordMatrix : public SparseMatrix
+{
+public:
+  AssemblingRecordMatrix(unsigned int size) : SparseMatrix(size) { }
+
+  virtual void alloc() { }
+  virtual void free() { blocks.clear(); indices.clear(); values.clear(); }
+  virtual scalar get(unsigned int m, unsigned int n) { error("AssemblingRecordMatrix::get() not implemented."); return 0; }
+  virtual void zero() { free(); }
+  virtual void add_to_diagonal(scalar v) { error("AssemblingRecordMatrix::add_to_diagonal() not implemented."); }
+  virtual bool dump(FILE *file, const char *var_name, EMatrixDumpFormat fmt = DF_MATLAB_SPARSE) { return false; }
+  virtual unsigned int get_matrix_size() const { return 0; }
+  virtual double get_fill_in() const { return 0; }
+
+  virtual void add(unsigned int m, unsigned int n, scalar v)
+  {
+    Block b = { 1, 1, true, indices.size(), values.size() };
+    blocks.push_back(b);
+    indices.push_back(m);
+    indices.push_back(n);
+    values.push_back(v);
+  }
+
+  virtual void add(unsigned int m, unsigned int n, scalar **mat, int *rows, int *cols)
+  {
+    if (m == 0 || n == 0) return;
+    Block b = { m, n, false, indices.size(), values.size() };
+    blocks.push_back(b);
+    indices.insert(indices.end(), rows, rows + m);
+    indices.insert(indices.end(), cols, cols + n);
+    for (unsigned int i = 0; i < m; i++)
+      values.insert(values.end(), mat[i], mat[i] + n);
+  }
+
+  /// Adds the recorded contributions to 'mat'.
+  void replay(SparseMatrix* mat)
+  {
+    for (size_t k = 0; k < blocks.size(); k++) {
+      Block& b = blocks[k];
+      int* idx = &indices[b.first_index];
+      scalar* val = &values[b.first_value];
+      if (b.single) {
+        mat->add(idx[0], idx[1], val[0]);
+        continue;
+      }
+      row_ptrs.resize(b.m);
+      for (unsigned int i = 0; i < b.m; i++)
+        row_ptrs[i] = val + i * b.n;
+      mat->add(b.m, b.n, &row_ptrs[0], idx, idx + b.m);
+    }
+  }
+
+protected:
+  struct Block
+  {
+    unsigned int m, n;
+    bool single;
+    size_t first_index, first_value;
+  };
+  std::vector<Block> blocks;
+  std::vector<int> indices;
+  std::vector<scalar> values;
+  std::vector<scalar*> row_ptrs;
+};
+
+// The same as AssemblingRecordMatrix for the right-hand side.
+class AssemblingRecordVector : public Vector
+{
+public:
+  AssemblingRecordVector(unsigned int size) { this->size = size; }
+
+  virtual void alloc(unsigned int ndofs) { free(); size = ndofs; }
+  virtual void free() { blocks.clear(); indices.clear(); values.clear(); }
+  virtual scalar get(unsigned int idx) { error("AssemblingRecordVector::get() not implemented."); return 0; }
+  virtual void extract(scalar *v) const { error("AssemblingRecordVector::extract() not implemented."); }
+  virtual void zero() { free(); }
+  virtual void change_sign() { error("AssemblingRecordVector::change_sign() not implemented."); }
+  virtual void set(unsigned int idx, scalar y) { error("AssemblingRecordVector::set() not implemented."); }
+  virtual void add_vector(Vector* vec) { error("AssemblingRecordVector::add_vector() not implemented."); }
+  virtual void add_vector(scalar* vec) { error("AssemblingRecordVector::add_vector() not implemented."); }
+  virtual bool dump(FILE *file, const char *var_name, EMatrixDumpFormat fmt = DF_MATLAB_SPARSE) { return false; }
+
+  virtual void add(unsigned int idx, scalar y)
+  {
+    Block b = { 1, true, indices.size() };
+    blocks.push_back(b);
+    indices.push_back(idx);
+    values.push_back(y);
+  }
+
+  virtual void add(unsigned int n, unsigned int *idx, scalar *y)
+  {
+    if (n == 0) return;
+    Block b = { n, false, indices.size() };
+    blocks.push_back(b);
+    indices.insert(indices.end(), idx, idx + n);
+    values.insert(values.end(), y, y + n);
+  }
+
+  /// Adds the recorded contributions to 'vec'.
+  void replay(Vector* vec)
+  {
+    for (size_t k = 0; k < blocks.size(); k++) {
+      Block& b = blocks[k];
+      if (b.single)
+        vec->add(indices[b.first], values[b.first]);
+      else
+        vec->add(b.n, &indices[b.first], &values[b.first]);
+    }
+  }
+
+protected:
+  struct Block
+  {
+    unsigned int n;
+    bool single;
+    size_t first;
+  };
+  std::vector<Block> blocks;
+  std::vector<unsigned int> indices;
+  std::vector<scalar> values;
+};
+
+// Consecutive states of the traversal of a stage: the elements and the sub-element
+// transformations of the stage functions and the boundary information of each state
+// (stored by the calling thread), and the contributions recorded by the thread that
+// assembled them.
+struct AssemblingChunk
+{
+  AssemblingChunk(unsigned int mat_size, unsigned int rhs_size)
+    : mat(mat_size), rhs(rhs_size), num_states(0), done(false) { }
+
+  AssemblingRecordMatrix mat;
+  AssemblingRecordVector rhs;
+  int num_states;
+  std::vector<Element *> e;       // num_states x number of stage functions
+  std::vector<uint64_t> sub_idx;  // the same
+  std::vector<Element *> base;
+  std::vector<char> bnd;          // 4 per state
+  std::vector<SurfPos> surf_pos;  // 4 per state
+  bool done;                      // Set by the assembling thread, under the mutex of the pool.
+};
+
+// The assembling threads wait for traversed chunks in the queue, assemble them and mark
+// them done. They are started by the first threaded stage and stopped by
+// free_thread_contexts().
+struct DiscreteProblem::ThreadPool
+{
+  ThreadPool() : shutdown(false)
+  {
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&work_cond, NULL);
+    pthread_cond_init(&done_cond, NULL);
+  }
+
+  ~ThreadPool()
+  {
+    pthread_cond_destroy(&done_cond);
+    pthread_cond_destroy(&work_cond);
+    pthread_mutex_destroy(&mutex);
+  }
+
+  std::vector<pthread_t> threads;
+  pthread_mutex_t mutex;
+  pthread_cond_t work_cond;             // Signalled when a chunk is queued or at the shutdown.
+  pthread_cond_t done_cond;             // Signalled when a chunk is assembled.
+  std::deque<AssemblingChunk *> queue;  // Chunks waiting for a thread.
+  bool shutdown;
+};
+
+// Everything an assembling thread needs for itself. The reference map shapeset, quadrature,
+// master and slave PrecalcShapesets, RefMaps and the worker DiscreteProblem (holding the
+// matrix buffer and the caches) persist between calls to assemble(), the rest is set up
+// for every stage.
+struct DiscreteProblem::ThreadContext
+{
+  ThreadContext(DiscreteProblem* master) : ref_map_pss(&ref_map_shapeset), initialized(false), pool(NULL)
+  {
+    dp = new DiscreteProblem(master);
+    for (unsigned int i = 0; i < dp->wf->get_neq(); i++)
+      dp->pss[i]->set_quad_2d(&quad);
+  }
+
+  ~ThreadContext()
+  {
+    // RefMaps have to be freed while their PrecalcShapeset exists.
+    RefMap::set_thread_ref_map_pss(&ref_map_pss);
+    for (unsigned int i = 0; i < spss.size(); i++)
+      delete spss[i];
+    for (unsigned int i = 0; i < refmap.size(); i++)
+      delete refmap[i];
+    RefMap::set_thread_ref_map_pss(NULL);
+    // The static condensation belongs to the master.
+    dp->condensation = NULL;
+    delete dp;
+  }
+
+  Quad2DStd quad;
+  H1ShapesetJacobi ref_map_shapeset;
+  PrecalcShapeset ref_map_pss;
+  DiscreteProblem* dp;
+  Hermes::vector<PrecalcShapeset *> spss;
+  Hermes::vector<RefMap *> refmap;
+  bool initialized;
+  ThreadPool* pool;
+
+  // The stage with the master's functions replaced by the thread's ones.
+  WeakForm::Stage stage;
+  Hermes::vector<Solution *> u_ext;
+  bool want_matrix, want_vector;
+  bool force_diagonal_blocks;
+  Table* block_weights;
+};
+
+void DiscreteProblem::free_thread_contexts()
+{
+  _F_
+  if (thread_pool != NULL) {
+    pthread_mutex_lock(&thread_pool->mutex);
+    thread_pool->shutdown = true;
+    pthread_cond_broadcast(&thread_pool->work_cond);
+    pthread_mutex_unlock(&thread_pool->mutex);
+    for (unsigned int t = 0; t < thread_pool->threads.size(); t++)
+      pthread_join(thread_pool->threads[t], NULL);
+    delete thread_pool;
+    thread_pool = NULL;
+  }
+  for (unsigned int i = 0; i < thread_contexts.size(); i++)
+    delete thread_contexts[i];
+  thread_contexts.clear();
+}
+
+void DiscreteProblem::set_fn_cache_memory_limit(size_t bytes)
+{
+  _F_
+  assembling_caches.const_cache_fn.set_memory_limit(bytes);
+  for (unsigned int t = 0; t < thread_contexts.size(); t++)
+    thread_contexts[t]->dp->assembling_caches.const_cache_fn.set_memory_limit(bytes);
+}
+
+void DiscreteProblem::set_precalc_arena(PrecalcArena* arena)
+{
+  _F_
+  for (unsigned int i = 0; i < wf->get_neq(); i++)
+    if (arena == NULL || pss[i]->get_shapeset()->get_id() == arena->get_shapeset_id())
+      pss[i]->set_arena(arena);
+}
+
+void DiscreteProblem::get_fn_cache_stats(unsigned long& hits, unsigned long& misses, unsigned long& evictions,
+                                         size_t& memory)
+{
+  _F_
+  hits = misses = evictions = 0;
+  memory = 0;
+  for (unsigned int t = 0; t <= thread_contexts.size(); t++) {
+    AssemblingCaches& caches = (t == 0) ? assembling_caches : thread_contexts[t - 1]->dp->assembling_caches;
+    FnCache* fn_caches[2] = { &caches.const_cache_fn, &caches.cache_fn };
+    for (int i = 0; i < 2; i++) {
+      hits += fn_caches[i]->get_num_hits();
+      misses += fn_caches[i]->get_num_misses();
+      evictions += fn_caches[i]->get_num_evictions();
+      memory += fn_caches[i]->get_memory();
+    }
+  }
+}
+
+void DiscreteProblem::set_geom_cache(bool enable, size_t memory_limit)
+{
+  _F_
+  for (unsigned int t = 0; t <= thread_contexts.size(); t++) {
+    AssemblingCaches& caches = (t == 0) ? assembling_caches : thread_contexts[t - 1]->dp->assembling_caches;
+    caches.use_geom_cache = enable;
+    caches.geom_cache.set_memory_limit(memory_limit);
+    if (!enable) caches.geom_cache.clear();
+  }
+}
+
+void DiscreteProblem::set_sum_factorization(bool enable)
+{
+  _F_
+  for (unsigned int t = 0; t <= thread_contexts.size(); t++) {
+    DiscreteProblem* dp = (t == 0) ? this : thread_contexts[t - 1]->dp;
+    AssemblingCaches& caches = dp->assembling_caches;
+    caches.use_sum_fact = enable;
+    if (!enable) caches.sum_fact.free();
+    for (unsigned int i = 0; i < wf->get_neq(); i++)
+      dp->pss[i]->set_sum_factorization(enable ? &caches.sum_fact : NULL);
+  }
+}
+
+void DiscreteProblem::get_geom_cache_stats(unsigned long& hits, unsigned long& misses, unsigned long& evictions,
+                                           size_t& memory)
+{
+  _F_
+  hits = misses = evictions = 0;
+  memory = 0;
+  for (unsigned int t = 0; t <= thread_contexts.size(); t++) {
+    GeomCache& cache = (t == 0) ? assembling_caches.geom_cache : thread_contexts[t - 1]->dp->assembling_caches.geom_cache;
+    hits += cache.get_num_hits();
+    misses += cache.get_num_misses();
+    evictions += cache.get_num_evictions();
+    memory += cache.get_memory();
+  }
+}
+
+void DiscreteProblem::get_order_cache_stats(unsigned long& hits, unsigned long& misses)
+{
+  _F_
+  hits = misses = 0;
+  for (unsigned int t = 0; t <= thread_contexts.size(); t++) {
+    AssemblingCaches& caches = (t == 0) ? assembling_caches : thread_contexts[t - 1]->dp->assembling_caches;
+    hits += caches.order_hits;
+    misses += caches.order_misses;
+  }
+}
+
+bool DiscreteProblem::is_stage_threadable(WeakForm::Stage& stage, Hermes::vector<Solution *>& u_ext)
+{
+  _F_
+  // DG forms need the neighbors, and they mark visited elements.
+  for (unsigned int i = 0; i < stage.mfsurf.size(); i++)
+    if (stage.mfsurf[i]->areas[0] == H2D_DG_INNER_EDGE) return false;
+  for (unsigned int i = 0; i < stage.vfsurf.size(); i++)
+    if (stage.vfsurf[i]->areas[0] == H2D_DG_INNER_EDGE) return false;
+  for (unsigned int i = 0; i < stage.mfsurf_mc.size(); i++)
+    if (stage.mfsurf_mc[i]->areas[0] == H2D_DG_INNER_EDGE) return false;
+  for (unsigned int i = 0; i < stage.vfsurf_mc.size(); i++)
+    if (stage.vfsurf_mc[i]->areas[0] == H2D_DG_INNER_EDGE) return false;
+
+  // Every thread needs its own instance of each function it evaluates. This is only
+  // available for the previous Newton iterate, which is recreated for each thread.
+  for (unsigned int i = 0; i < stage.ext.size(); i++)
+    if (std::find(u_ext.begin(), u_ext.end(), stage.ext[i]) == u_ext.end()) {
+      verbose("External functions present, assembling stage serially.");
+      return false;
+    }
+
+  // Each thread works with its own copy of the shapesets.
+  if (thread_contexts.empty())
+    for (unsigned int i = 0; i < wf->get_neq(); i++) {
+      Shapeset* shapeset = spaces[i]->get_shapeset()->clone();
+      if (shapeset == NULL) {
+        verbose("Shapeset can not be cloned, assembling stage serially.");
+        return false;
+      }
+      delete shapeset;
+    }
+
+  return true;
+}
+
+void* DiscreteProblem::assembling_thread_run(void* context)
+{
+  ThreadContext* ctx = (ThreadContext*) context;
+  ThreadPool* pool = ctx->pool;
+
+  // The thread does not track its call stack, and it has its own reference map pss.
+  callstack_set_thread_enabled(false);
+  RefMap::set_thread_ref_map_pss(&ctx->ref_map_pss);
+
+  bool bnd[4];
+  SurfPos surf_pos[4];
+  pthread_mutex_lock(&pool->mutex);
+  while (1) {
+    while (pool->queue.empty() && !pool->shutdown)
+      pthread_cond_wait(&pool->work_cond, &pool->mutex);
+    if (pool->queue.empty()) break;
+    AssemblingChunk* chunk = pool->queue.front();
+    pool->queue.pop_front();
+    pthread_mutex_unlock(&pool->mutex);
+
+    // Set the functions of the thread to the elements and transformations of each state
+    // as the traversal would, and assemble the state.
+    unsigned int n = ctx->stage.fns.size();
+    for (int k = 0; k < chunk->num_states; k++) {
+      Element** e = &chunk->e[k * n];
+      for (unsigned int i = 0; i < n; i++)
+        if (e[i] != NULL) {
+          ctx->stage.fns[i]->set_active_element(e[i]);
+          ctx->stage.fns[i]->set_transform(chunk->sub_idx[k * n + i]);
+        }
+      for (int j = 0; j < 4; j++) {
+        bnd[j] = chunk->bnd[4 * k + j];
+        surf_pos[j] = chunk->surf_pos[4 * k + j];
+      }
+      ctx->dp->assemble_one_state(ctx->stage, ctx->want_matrix ? &chunk->mat : NULL,
+                                  ctx->want_vector ? &chunk->rhs : NULL, ctx->force_diagonal_blocks,
+                                  ctx->block_weights, ctx->spss, ctx->refmap,
+                                  ctx->u_ext, e, bnd, surf_pos, chunk->base[k]);
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    chunk->done = true;
+    pthread_cond_signal(&pool->done_cond);
+  }
+  pthread_mutex_unlock(&pool->mutex);
+
+  RefMap::set_thread_ref_map_pss(NULL);
+  return NULL;
+}
+
+void DiscreteProblem::assemble_one_stage_threaded(WeakForm::Stage& stage, 
+                                                  SparseMatrix* matrix, Vector* rhs,
+                                                  bool force_diagonal_blocks, Table* block_weights,
+                                                  Hermes::vector<Solution *>& u_ext)
+{
+  _F_
+  if (thread_contexts.size() != (unsigned) num_threads) {
+    free_thread_contexts();
+    for (int t = 0; t < num_threads; t++)
+      thread_contexts.push_back(new ThreadContext(this));
+  }
+
+  pthread_mutex_t mutex;
+  pthread_mutex_init(&mutex, NULL);
+
+  // Prepare the stage for each thread: own master pss's and own views of the previous Newton iterate.
+  for (int t = 0; t < num_threads; t++) {
+    ThreadContext* ctx = thread_contexts[t];
+    // Created here, so that the objects do not keep pointers to the thread-local default
+    // quadrature of an assembling thread.
+    if (!ctx->initialized) {
+      RefMap::set_thread_ref_map_pss(&ctx->ref_map_pss);
+      ctx->dp->initialize_psss(ctx->spss);
+      ctx->dp->initialize_refmaps(ctx->refmap);
+      for (unsigned int i = 0; i < ctx->spss.size(); i++) {
+        ctx->spss[i]->set_quad_2d(&ctx->quad);
+        ctx->refmap[i]->set_quad_2d(&ctx->quad);
+      }
+      RefMap::set_thread_ref_map_pss(NULL);
+      ctx->initialized = true;
+    }
+    ctx->dp->space_mutex = &mutex;
+    ctx->dp->element_cache = element_cache;
+    for (unsigned int i = 0; i < wf->get_neq(); i++)
+      ctx->dp->pss[i]->set_arena(pss[i]->get_arena());
+    // The tables of the previous iterate are built once by the master and shared.
+    ctx->dp->share_coeff_vec(u_ext, ctx->u_ext);
+    ctx->dp->assembling_caches.update(spaces, wf);
+
+    ctx->stage = stage;
+    for (unsigned int i = 0; i < stage.idx.size(); i++)
+      ctx->stage.fns[i] = ctx->dp->pss[stage.idx[i]];
+    // The quadrature is also set to the reference map pss of the thread.
+    RefMap::set_thread_ref_map_pss(&ctx->ref_map_pss);
+    for (unsigned int i = 0; i < stage.ext.size(); i++) {
+      unsigned int k = std::find(u_ext.begin(), u_ext.end(), stage.ext[i]) - u_ext.begin();
+      ctx->stage.ext[i] = ctx->u_ext[k];
+      ctx->stage.fns[stage.idx.size() + i] = ctx->u_ext[k];
+      ctx->u_ext[k]->set_quad_2d(&ctx->quad);
+    }
+    RefMap::set_thread_ref_map_pss(NULL);
+
+    ctx->want_matrix = (matrix != NULL);
+    ctx->want_vector = (rhs != NULL);
+    ctx->force_diagonal_blocks = force_diagonal_blocks;
+    ctx->block_weights = block_weights;
+  }
+
+  // The threads are started by the first threaded stage and wait for chunks until
+  // free_thread_contexts().
+  if (thread_pool == NULL) {
+    thread_pool = new ThreadPool;
+    for (int t = 0; t < num_threads; t++) {
+      thread_contexts[t]->pool = thread_pool;
+      pthread_t thread;
+      if (pthread_create(&thread, NULL, assembling_thread_run, thread_contexts[t]) != 0)
+        error("Failed to create an assembling thread in DiscreteProblem::assemble_one_stage_threaded().");
+      thread_pool->threads.push_back(thread);
+    }
+  }
+
+  // The stage is traversed once, with placeholders for the functions that only follow
+  // the elements and the sub-element transformations. The states are queued in chunks,
+  // and the contributions of the chunks are inserted in the order of the traversal as
+  // soon as they are assembled, while the threads assemble the next chunks. At most
+  // H2D_THREAD_CHUNKS_AHEAD chunks per thread are traversed ahead.
+  unsigned int n = stage.meshes.size();
+  Transformable* trf = new Transformable[n];
+  MEM_CHECK(trf);
+  std::vector<Transformable *> fns(n);
+  for (unsigned int i = 0; i < n; i++)
+    fns[i] = trf + i;
+  Traverse trav;
+  trav.begin(n, &(stage.meshes.front()), &(fns.front()));
+
+  std::vector<AssemblingChunk *> free_chunks;
+  for (int k = 0; k < H2D_THREAD_CHUNKS_AHEAD * num_threads; k++)
+    free_chunks.push_back(new AssemblingChunk(matrix != NULL ? matrix->get_size() : 0,
+                                              rhs != NULL ? rhs->length() : 0));
+  std::deque<AssemblingChunk *> queued;
+  bool traversed = false;
+  bool bnd[4];
+  SurfPos surf_pos[4];
+  while (1) {
+    while (!traversed && !free_chunks.empty()) {
+      AssemblingChunk* chunk = free_chunks.back();
+      chunk->num_states = 0;
+      chunk->e.clear();
+      chunk->sub_idx.clear();
+      chunk->base.clear();
+      chunk->bnd.clear();
+      chunk->surf_pos.clear();
+      Element** e;
+      while (chunk->num_states < H2D_THREAD_STATES_PER_CHUNK && (e = trav.get_next_state(bnd, surf_pos)) != NULL) {
+        chunk->e.insert(chunk->e.end(), e, e + n);
+        for (unsigned int i = 0; i < n; i++)
+          chunk->sub_idx.push_back(trf[i].get_transform());
+        chunk->base.push_back(trav.get_base());
+        chunk->bnd.insert(chunk->bnd.end(), bnd, bnd + 4);
+        chunk->surf_pos.insert(chunk->surf_pos.end(), surf_pos, surf_pos + 4);
+        chunk->num_states++;
+      }
+      if (chunk->num_states < H2D_THREAD_STATES_PER_CHUNK) traversed = true;
+      if (chunk->num_states == 0) break;
+
+      free_chunks.pop_back();
+      chunk->done = false;
+      pthread_mutex_lock(&thread_pool->mutex);
+      thread_pool->queue.push_back(chunk);
+      pthread_cond_signal(&thread_pool->work_cond);
+      pthread_mutex_unlock(&thread_pool->mutex);
+      queued.push_back(chunk);
+    }
+    if (queued.empty()) break;
+
+    // Insert the contributions of the oldest chunk when it is assembled.
+    AssemblingChunk* chunk = queued.front();
+    queued.pop_front();
+    pthread_mutex_lock(&thread_pool->mutex);
+    while (!chunk->done)
+      pthread_cond_wait(&thread_pool->done_cond, &thread_pool->mutex);
+    pthread_mutex_unlock(&thread_pool->mutex);
+    if (matrix != NULL) chunk->mat.replay(matrix);
+    if (rhs != NULL) chunk->rhs.replay(rhs);
+    chunk->mat.free();
+    chunk->rhs.free();
+    free_chunks.push_back(chunk);
+  }
+  trav.finish();
+  delete [] trf;
+  for (unsigned int k = 0; k < free_chunks.size(); k++)
+    delete free_chunks[k];
+
+  if (matrix != NULL) matrix->finish();
+  if (rhs != NULL) rhs->finish();
+
+  for (int t = 0; t < num_threads; t++) {
+    ThreadContext* ctx = thread_contexts[t];
+    ctx->u_ext.clear();
+    ctx->dp->space_mutex = NULL;
+  }
+  pthread_mutex_destroy(&mutex);
+}
+
 Element* DiscreteProblem::init_state(WeakForm::Stage& stage, Hermes::vector<PrecalcShapeset *>& spss, 
   Hermes::vector<RefMap *>& refmap, Element** e, Hermes::vector<bool>& isempty, Hermes::vector<AsmList *>& al)
 {
@@ -607,7 +1328,7 @@ Element* DiscreteProblem::init_state(WeakForm::Stage& stage, Hermes::vector<Prec
     return NULL;
 
   // Set maximum integration order for use in integrals, see limit_order()
-  update_limit_table(e0->get_mode());
+  update_limit_table(e0->get_mode(), spss[stage.idx[0]]->get_quad_2d());
 
   // Obtain assembly lists for the element at all spaces of the stage, set appropriate mode for each pss.
   // NOTE: Active elements and transformations for external functions (including the solutions from previous
@@ -621,7 +1342,9 @@ Element* DiscreteProblem::init_state(WeakForm::Stage& stage, Hermes::vector<Prec
     }
 
     // TODO: do not obtain again if the element was not changed.
+    if (space_mutex != NULL) pthread_mutex_lock(space_mutex);
     spaces[j]->get_element_assembly_list(e[i], al[j]);
+    if (space_mutex != NULL) pthread_mutex_unlock(space_mutex);
 
     // Set active element to all test functions.
     spss[j]->set_active_element(e[i]);
@@ -666,8 +1389,24 @@ void DiscreteProblem::assemble_one_state(WeakForm::Stage& stage,
   if(rep_element == NULL)
     return;
 
+  // With static condensation, the forms are assembled into the local system of the element
+  // first, its bubble DOFs are eliminated before inserting it into the matrix and the vector.
+  SparseMatrix* global_matrix = matrix;
+  Vector* global_rhs = rhs;
+  if (condensation != NULL) {
+    if (element_system == NULL) element_system = new ElementSystem;
+    element_system->begin(al, condensation->get_num_dofs());
+    if (matrix != NULL) matrix = element_system->get_matrix();
+    if (rhs != NULL) rhs = element_system->get_vector();
+  }
+
   init_cache();
 
+  // Incremental assembling: values of the volumetric forms computed in a previous assembly.
+  element_cache_entry = NULL;
+  if (element_cache != NULL)
+    element_cache_entry = get_element_cache_entry(refmap, u_ext, isempty, al);
+
   /// Assemble volume matrix forms.
    assemble_volume_matrix_forms(stage, matrix, rhs, force_diagonal_blocks,
                                block_weights, spss, refmap, u_ext, isempty,
@@ -697,6 +1436,9 @@ void DiscreteProblem::assemble_one_state(WeakForm::Stage& stage,
                               nat, isurf, e, trav_base, rep_element);
   }
 
+  if (condensation != NULL)
+    condensation->condense(rep_element->id, element_system, global_matrix, global_rhs);
+
   // Delete assembly lists.
   for(unsigned int i = 0; i < wf->get_neq(); i++) 
     delete al[i];
@@ -704,6 +1446,52 @@ void DiscreteProblem::assemble_one_state(WeakForm::Stage& stage,
   delete_cache();
 }
 
+ElementMatrixCache::Entry* DiscreteProblem::get_element_cache_entry(Hermes::vector<RefMap *>& refmap,
+                                                                  Hermes::vector<Solution *>& u_ext,
+                                                                  Hermes::vector<bool>& isempty,
+                                                                  Hermes::vector<AsmList *>& al)
+{
+  // Values depending on the previous iterate can not be reused.
+  if (is_fvm) return NULL;
+  for (unsigned int i = 0; i < u_ext.size(); i++)
+    if (u_ext[i] != NULL) return NULL;
+
+  // The signature of the state: the elements (with their sub-element transformations)
+  // and the shape functions of all equations.
+  std::vector<uint64_t>& signature = assembling_caches.signature;
+  signature.clear();
+  for (unsigned int i = 0; i < wf->get_neq(); i++) {
+    if (isempty[i]) {
+      signature.push_back((uint64_t) -1);
+      continue;
+    }
+    Element* element = refmap[i]->get_active_element();
+    // The geometry of curved elements is not described by the vertices.
+    if (element->cm != NULL) return NULL;
+    signature.push_back(element->get_num_surf());
+    for (int k = 0; k < element->get_num_surf(); k++) {
+      uint64_t xy[2];
+      memcpy(xy, &element->vn[k]->x, sizeof(double));
+      memcpy(xy + 1, &element->vn[k]->y, sizeof(double));
+      signature.push_back(xy[0]);
+      signature.push_back(xy[1]);
+    }
+    signature.push_back(element->marker);
+    signature.push_back(refmap[i]->get_transform());
+    signature.push_back(pss[i]->get_shapeset()->get_id());
+    signature.push_back(al[i]->cnt);
+    for (unsigned int k = 0; k < al[i]->cnt; k++)
+      signature.push_back(al[i]->idx[k]);
+  }
+  return element_cache->get_entry(signature);
+}
+
+// True if the functions of the shapeset can be stored in a FuncBatch.
+static bool is_batch_supported(PrecalcShapeset* pss)
+{
+  return pss->get_num_components() == 1 || pss->get_space_type() == HERMES_HCURL_SPACE;
+}
+
 void DiscreteProblem::assemble_volume_matrix_forms(WeakForm::Stage& stage, 
                       SparseMatrix* mat, Vector* rhs, bool force_diagonal_blocks, 
                       Table* block_weights,
@@ -745,6 +1533,23 @@ void DiscreteProblem::assemble_volume_matrix_forms(WeakForm::Stage& stage,
     scalar **local_stiffness_matrix = NULL;
     local_stiffness_matrix = get_matrix_buffer(std::max(al[m]->cnt, al[n]->cnt));
 
+    // Forms that support it are evaluated for all pairs of functions at once, from the
+    // reference matrices on elements with a constant jacobian. Without the matrix only the
+    // pairs with a Dirichlet function are needed, these are evaluated one by one below.
+    scalar **batch = NULL;
+    if (!is_fvm && mat != NULL && al[m]->cnt > 0 && al[n]->cnt > 0) {
+      batch = eval_form_ref(mfv, pss[n], spss[m], refmap[n], al[n], al[m]);
+      // In incremental assembling, the values of the other forms are computed for all pairs
+      // and stored, unless they are in the cache already.
+      if (batch == NULL && element_cache_entry != NULL && mfv->cache_values && mfv->ext.empty())
+        batch = get_cached_values(mfv, u_ext, pss[n], spss[m], refmap[n], refmap[m], al[n], al[m]);
+      if (batch == NULL)
+        batch = eval_form_sum_fact(mfv, u_ext, pss[n], spss[m], refmap[n], refmap[m], al[n], al[m]);
+      if (batch == NULL && mfv->batch_eval && !mfv->adapt_eval
+          && is_batch_supported(pss[n]) && is_batch_supported(spss[m]))
+        batch = eval_form_batch(mfv, u_ext, pss[n], spss[m], refmap[n], refmap[m], al[n], al[m]);
+    }
+
     for (unsigned int i = 0; i < al[m]->cnt; i++) {
       if (!tra && al[m]->dof[i] < 0) 
         continue;
@@ -763,8 +1568,8 @@ void DiscreteProblem::assemble_volume_matrix_forms(WeakForm::Stage& stage,
               // and if the basis function is active.
               if (std::abs(al[m]->coef[i]) > 1e-12 && std::abs(al[n]->coef[j]) > 1e-12
                   && al[m]->dof[i] >= 0) {
-                scalar val = eval_form(mfv, u_ext, pss[n], spss[m], refmap[n],
-                                       refmap[m]) * al[n]->coef[j] * al[m]->coef[i];
+                scalar val = (batch != NULL ? batch[i][j] : eval_form(mfv, u_ext, pss[n], spss[m], refmap[n],
+                                                                      refmap[m])) * al[n]->coef[j] * al[m]->coef[i];
                 rhs->add(al[m]->dof[i], -val);
               }
             }
@@ -774,8 +1579,9 @@ void DiscreteProblem::assemble_volume_matrix_forms(WeakForm::Stage& stage,
             // Numerical integration performed only if all 
             // coefficients multiplying the form are nonzero.
             if (std::abs(al[m]->coef[i]) > 1e-12 && std::abs(al[n]->coef[j]) > 1e-12) {
-              val = block_scaling_coeff * eval_form(mfv, u_ext, pss[n], spss[m], refmap[n],
-                                                    refmap[m]) * al[n]->coef[j] * al[m]->coef[i];
+              val = block_scaling_coeff * (batch != NULL ? batch[i][j] : eval_form(mfv, u_ext, pss[n], spss[m],
+                                                                                   refmap[n], refmap[m]))
+                    * al[n]->coef[j] * al[m]->coef[i];
             }
             local_stiffness_matrix[i][j] = val;
           }
@@ -798,8 +1604,8 @@ void DiscreteProblem::assemble_volume_matrix_forms(WeakForm::Stage& stage,
               if (std::abs(al[m]->coef[i]) > 1e-12 && std::abs(al[n]->coef[j]) > 1e-12
                   && al[m]->dof[i] >= 0) {
 
-                scalar val = eval_form(mfv, u_ext, pss[n], spss[m], refmap[n], refmap[m]) * 
-                                       al[n]->coef[j] * al[m]->coef[i];
+                scalar val = (batch != NULL ? batch[i][j] : eval_form(mfv, u_ext, pss[n], spss[m], refmap[n],
+                                                                      refmap[m])) * al[n]->coef[j] * al[m]->coef[i];
                 rhs->add(al[m]->dof[i], -val);
 	      }
             }
@@ -809,8 +1615,9 @@ void DiscreteProblem::assemble_volume_matrix_forms(WeakForm::Stage& stage,
             // Numerical integration performed only if all coefficients 
             // multiplying the form are nonzero.
             if (std::abs(al[m]->coef[i]) > 1e-12 && std::abs(al[n]->coef[j]) > 1e-12) {
-              val = block_scaling_coeff * eval_form(mfv, u_ext, pss[n], spss[m], refmap[n],
-                                                    refmap[m]) * al[n]->coef[j] * al[m]->coef[i];
+              val = block_scaling_coeff * (batch != NULL ? batch[i][j] : eval_form(mfv, u_ext, pss[n], spss[m],
+                                                                                   refmap[n], refmap[m]))
+                    * al[n]->coef[j] * al[m]->coef[i];
             }
             local_stiffness_matrix[i][j] = local_stiffness_matrix[j][i] = val;
           }
@@ -1000,6 +1807,19 @@ void DiscreteProblem::assemble_volume_vector_forms(WeakForm::Stage& stage,
     }
     if (assemble_this_form == false) continue; 
 
+    // Forms that support it are evaluated for all test functions at once, from the
+    // reference matrices on elements with a constant jacobian.
+    scalar *batch = NULL;
+    if (!is_fvm && al[m]->cnt > 0) {
+      batch = eval_form_ref(vfv, spss[m], refmap[m], al[m]);
+      if (batch == NULL && element_cache_entry != NULL && vfv->cache_values && vfv->ext.empty())
+        batch = get_cached_values(vfv, u_ext, spss[m], refmap[m], al[m]);
+      if (batch == NULL)
+        batch = eval_form_sum_fact(vfv, u_ext, spss[m], refmap[m], al[m]);
+      if (batch == NULL && vfv->batch_eval && !vfv->adapt_eval && is_batch_supported(spss[m]))
+        batch = eval_form_batch(vfv, u_ext, spss[m], refmap[m], al[m]);
+    }
+
     for (unsigned int i = 0; i < al[m]->cnt; i++) {
       if (al[m]->dof[i] < 0) continue;
       
@@ -1008,7 +1828,8 @@ void DiscreteProblem::assemble_volume_vector_forms(WeakForm::Stage& stage,
       // Numerical integration performed only if the coefficient 
       // multiplying the form is nonzero.
       if (std::abs(al[m]->coef[i]) > 1e-12) {   
-        rhs->add(al[m]->dof[i], eval_form(vfv, u_ext, spss[m], refmap[m]) * al[m]->coef[i]);
+        scalar val = (batch != NULL) ? batch[i] : eval_form(vfv, u_ext, spss[m], refmap[m]);
+        rhs->add(al[m]->dof[i], val * al[m]->coef[i]);
       }
     }
   }
@@ -1079,7 +1900,9 @@ void DiscreteProblem::assemble_surface_integrals(WeakForm::Stage& stage,
         if(spaces[j]->get_essential_bcs()->get_boundary_condition(boundary_markers_conversion->get_user_marker(marker)) != NULL)
           nat[j] = false;
     }
+    if (space_mutex != NULL) pthread_mutex_lock(space_mutex);
     spaces[j]->get_boundary_assembly_list(e[i], isurf, al[j]);
+    if (space_mutex != NULL) pthread_mutex_unlock(space_mutex);
   }
 
   // Assemble boundary edges: 
@@ -1188,12 +2011,7 @@ void DiscreteProblem::assemble_DG_forms(WeakForm::Stage& stage,
 
     // For every neighbor we want to delete the geometry caches and create new ones.
     for (int i = 0; i < g_max_quad + 1 + 4 * g_max_quad + 4; i++)
-      if (cache_e[i] != NULL) {
-        cache_e[i]->free(); 
-        delete cache_e[i];
-        cache_e[i] = NULL;
-        delete [] cache_jwt[i];
-      }
+      delete_single_geom_cache(i);
 
     assemble_DG_one_neighbor(processed, neighbor_i, stage, mat, rhs, 
                              force_diagonal_blocks, block_weights, spss, refmap, 
@@ -2252,32 +3070,16 @@ ExtData<Ord>* DiscreteProblem::init_ext_fns_ord(Hermes::vector<MeshFunction *> &
 Func<double>* DiscreteProblem::get_fn(PrecalcShapeset *fu, RefMap *rm, const int order)
 {
   _F_
+  int mode = rm->get_active_element()->get_mode();
   if(rm->is_jacobian_const()) {
-    AssemblingCaches::KeyConst key(256 - fu->get_active_shape(), order, fu->get_transform(), fu->get_shapeset()->get_id(), rm->get_const_inv_ref_map());
-    if(rm->get_active_element()->get_mode() == HERMES_MODE_TRIANGLE) {
-      if(assembling_caches.const_cache_fn_triangles.find(key) == assembling_caches.const_cache_fn_triangles.end())
-        assembling_caches.const_cache_fn_triangles[key] = init_fn(fu, rm, order);
-      return assembling_caches.const_cache_fn_triangles[key];
-    }
-    else {
-      if(assembling_caches.const_cache_fn_quads.find(key) == assembling_caches.const_cache_fn_quads.end())
-        assembling_caches.const_cache_fn_quads[key] = init_fn(fu, rm, order);
-      return assembling_caches.const_cache_fn_quads[key];
-    }
+    FnCache::Key key(256 - fu->get_active_shape(), order, fu->get_transform(), fu->get_shapeset()->get_id(), 
+                     mode, rm->get_const_inv_ref_map());
+    return assembling_caches.const_cache_fn.get(key, fu, rm, order);
   }
   else {
-    AssemblingCaches::KeyNonConst key(256 - fu->get_active_shape(), order, 
-                                      fu->get_transform(), fu->get_shapeset()->get_id());
-    if(rm->get_active_element()->get_mode() == HERMES_MODE_TRIANGLE) {
-      if(assembling_caches.cache_fn_triangles.find(key) == assembling_caches.cache_fn_triangles.end())
-        assembling_caches.cache_fn_triangles[key] = init_fn(fu, rm, order);
-      return assembling_caches.cache_fn_triangles[key];
-    }
-    else {
-      if(assembling_caches.cache_fn_quads.find(key) == assembling_caches.cache_fn_quads.end())
-        assembling_caches.cache_fn_quads[key] = init_fn(fu, rm, order);
-      return assembling_caches.cache_fn_quads[key];
-    }
+    FnCache::Key key(256 - fu->get_active_shape(), order, fu->get_transform(), fu->get_shapeset()->get_id(), 
+                     mode);
+    return assembling_caches.cache_fn.get(key, fu, rm, order);
   }
 }
 
@@ -2292,52 +3094,134 @@ Func<Ord>* DiscreteProblem::get_fn_ord(const int order)
   return assembling_caches.cache_fn_ord.get(cached_order);
 }
 
-// Caching transformed values
-void DiscreteProblem::init_cache()
+DiscreteProblem::OrderKey::OrderKey(WeakForm::Form* form, int kind)
 {
-  _F_
-  for (int i = 0; i < g_max_quad + 1 + 4 * g_max_quad + 4; i++)
-  {
-    cache_e[i] = NULL;
-    cache_jwt[i] = NULL;
-  }
+  // Keys are compared as raw memory.
+  memset(this, 0, sizeof(OrderKey));
+  this->form = form;
+  this->kind = kind;
 }
 
-void DiscreteProblem::delete_single_geom_cache(int order)
+// Orders of external functions as in init_ext_fns_ord().
+void DiscreteProblem::OrderKey::add_ext_fns(Hermes::vector<MeshFunction *> &ext)
 {
-  if (cache_e[order] != NULL) {
-    cache_e[order]->free();
-    delete cache_e[order];
-    cache_e[order] = NULL;
-    delete [] cache_jwt[order];
-  }
+  add((int) ext.size());
+  for (unsigned int i = 0; i < ext.size(); i++)
+    add(ext[i]->get_fn_order());
 }
 
-void DiscreteProblem::delete_cache()
+void DiscreteProblem::OrderKey::add_ext_fns(Hermes::vector<MeshFunction *> &ext, int edge)
 {
-  _F_
-  for (int i = 0; i < g_max_quad + 1 + 4 * g_max_quad + 4; i++)
-  {
-    if (cache_e[i] != NULL)
-    {
-      cache_e[i]->free(); delete cache_e[i];
-      delete [] cache_jwt[i];
-    }
+  add((int) ext.size());
+  for (unsigned int i = 0; i < ext.size(); i++)
+    add(ext[i]->get_edge_fn_order(edge));
+}
+
+// Orders of a discontinuous external function as in init_ext_fn_ord().
+void DiscreteProblem::OrderKey::add_ext_fn(NeighborSearch* ns, MeshFunction* fu)
+{
+  int inc = (fu->get_num_components() == 2) ? 1 : 0;
+  add(fu->get_edge_fn_order(ns->active_edge) + inc);
+  add(fu->get_edge_fn_order(ns->neighbor_edge.local_num_of_edge) + inc);
+}
+
+bool DiscreteProblem::find_order(const OrderKey& key, int& order)
+{
+  if (!key.form->cache_order || key.n > H2D_ORDER_KEY_SIZE) return false;
+  std::map<OrderKey, int>::iterator it = assembling_caches.cache_order.find(key);
+  if (it == assembling_caches.cache_order.end()) {
+    assembling_caches.order_misses++;
+    return false;
   }
-  
-  for (std::map<AssemblingCaches::KeyNonConst, Func<double>*, AssemblingCaches::CompareNonConst>::const_iterator it = assembling_caches.cache_fn_quads.begin();
-       it != assembling_caches.cache_fn_quads.end(); it++)
+  assembling_caches.order_hits++;
+  order = it->second;
+  return true;
+}
+
+void DiscreteProblem::store_order(const OrderKey& key, int order)
+{
+  if (!key.form->cache_order || key.n > H2D_ORDER_KEY_SIZE) return;
+  assembling_caches.cache_order[key] = order;
+}
+
+// Caching transformed values
+void DiscreteProblem::init_cache()
+{
+  _F_
+  for (int i = 0; i < g_max_quad + 1 + 4 * g_max_quad + 4; i++)
   {
-    (it->second)->free_fn(); delete (it->second);
+    cache_e[i] = NULL;
+    cache_jwt[i] = NULL;
+    cache_e_shared[i] = false;
   }
-  assembling_caches.cache_fn_quads.clear();
+  assembling_caches.const_cache_fn.new_state();
+  assembling_caches.cache_fn.new_state();
+  assembling_caches.geom_cache.new_state();
+}
 
-  for (std::map<AssemblingCaches::KeyNonConst, Func<double>*, AssemblingCaches::CompareNonConst>::const_iterator it = assembling_caches.cache_fn_triangles.begin();
-       it != assembling_caches.cache_fn_triangles.end(); it++)
-  {
-    (it->second)->free_fn(); delete (it->second);
+void DiscreteProblem::delete_single_geom_cache(int order)
+{
+  if (cache_e[order] != NULL) {
+    if (!cache_e_shared[order]) {
+      cache_e[order]->free();
+      delete cache_e[order];
+      delete [] cache_jwt[order];
+    }
+    cache_e[order] = NULL;
+    cache_jwt[order] = NULL;
+    cache_e_shared[order] = false;
   }
-  assembling_caches.cache_fn_triangles.clear();
+}
+
+void DiscreteProblem::init_geom_cache_vol(RefMap* rm, int order)
+{
+  if (cache_e[order] != NULL) return;
+  if (assembling_caches.use_geom_cache) {
+    assembling_caches.geom_cache.get_vol(rm, order, cache_e[order], cache_jwt[order]);
+    cache_e_shared[order] = true;
+    return;
+  }
+
+  int np = rm->get_quad_2d()->get_num_points(order);
+  double3* pt = rm->get_quad_2d()->get_points(order);
+  cache_e[order] = init_geom_vol(rm, order);
+  double* jac = NULL;
+  if(!rm->is_jacobian_const()) 
+    jac = rm->get_jacobian(order);
+  cache_jwt[order] = new double[np];
+  for(int i = 0; i < np; i++) {
+    if(rm->is_jacobian_const())
+      cache_jwt[order][i] = pt[i][2] * rm->get_const_jacobian();
+    else
+      cache_jwt[order][i] = pt[i][2] * jac[i];
+  }
+}
+
+void DiscreteProblem::init_geom_cache_surf(RefMap* rm, SurfPos* surf_pos, int eo)
+{
+  if (cache_e[eo] != NULL) return;
+  if (assembling_caches.use_geom_cache) {
+    assembling_caches.geom_cache.get_surf(rm, surf_pos, eo, cache_e[eo], cache_jwt[eo]);
+    cache_e_shared[eo] = true;
+    return;
+  }
+
+  int np = rm->get_quad_2d()->get_num_points(eo);
+  double3* pt = rm->get_quad_2d()->get_points(eo);
+  cache_e[eo] = init_geom_surf(rm, surf_pos, eo);
+  double3* tan = rm->get_tangent(surf_pos->surf_num, eo);
+  cache_jwt[eo] = new double[np];
+  for(int i = 0; i < np; i++)
+    cache_jwt[eo][i] = pt[i][2] * tan[i][2];
+}
+
+void DiscreteProblem::delete_cache()
+{
+  _F_
+  for (int i = 0; i < g_max_quad + 1 + 4 * g_max_quad + 4; i++)
+    delete_single_geom_cache(i);
+  
+  assembling_caches.cache_fn.clear();
 }
 
 DiscontinuousFunc<Ord>* DiscreteProblem::init_ext_fn_ord(NeighborSearch* ns, MeshFunction* fu)
@@ -2410,20 +3294,7 @@ void DiscreteProblem::eval_form(WeakForm::MultiComponentMatrixFormVol *mfv,
   int np = quad->get_num_points(order);
 
   // Init geometry and jacobian*weights.
-  if (cache_e[order] == NULL)
-  {
-    cache_e[order] = init_geom_vol(ru, order);
-    double* jac = NULL;
-    if(!ru->is_jacobian_const()) 
-      jac = ru->get_jacobian(order);
-    cache_jwt[order] = new double[np];
-    for(int i = 0; i < np; i++) {
-      if(ru->is_jacobian_const())
-        cache_jwt[order][i] = pt[i][2] * ru->get_const_jacobian();
-      else
-        cache_jwt[order][i] = pt[i][2] * jac[i];
-    }
-  }
+  init_geom_cache_vol(ru, order);
   Geom<double>* e = cache_e[order];
   double* jwt = cache_jwt[order];
 
@@ -2483,43 +3354,58 @@ int DiscreteProblem::calc_order_matrix_form_vol(WeakForm::MatrixFormVol *mfv, He
     // Increase for multi-valued shape functions.
     int inc = (fu->get_num_components() == 2) ? 1 : 0;
 
-    // Order of solutions from the previous Newton iteration.
-    Func<Ord>** oi = new Func<Ord>*[u_ext_length - u_ext_offset];
-    if (u_ext != Hermes::vector<Solution *>())
-      for(int i = 0; i < u_ext_length - u_ext_offset; i++)
-        if (u_ext[i + u_ext_offset] != NULL)
-          oi[i] = get_fn_ord(u_ext[i + u_ext_offset]->get_fn_order() + inc);
-        else
+    // The order of the form is cached for the orders of the functions.
+    OrderKey key(mfv, ORDER_VOL);
+    key.add(u_ext_length - u_ext_offset);
+    for(int i = 0; i < u_ext_length - u_ext_offset; i++)
+      key.add(u_ext[i + u_ext_offset] != NULL ? u_ext[i + u_ext_offset]->get_fn_order() + inc : 0);
+    key.add(fu->get_fn_order() + inc);
+    key.add(fv->get_fn_order() + inc);
+    key.add_ext_fns(mfv->ext);
+
+    int form_order;
+    if (!find_order(key, form_order)) {
+      // Order of solutions from the previous Newton iteration.
+      Func<Ord>** oi = new Func<Ord>*[u_ext_length - u_ext_offset];
+      if (u_ext != Hermes::vector<Solution *>())
+        for(int i = 0; i < u_ext_length - u_ext_offset; i++)
+          if (u_ext[i + u_ext_offset] != NULL)
+            oi[i] = get_fn_ord(u_ext[i + u_ext_offset]->get_fn_order() + inc);
+          else
+            oi[i] = get_fn_ord(0);
+      else
+        for(int i = 0; i < u_ext_length - u_ext_offset; i++)
           oi[i] = get_fn_ord(0);
-    else
-      for(int i = 0; i < u_ext_length - u_ext_offset; i++)
-        oi[i] = get_fn_ord(0);
 
-    // Order of shape functions.
-    Func<Ord>* ou = get_fn_ord(fu->get_fn_order() + inc);
-    Func<Ord>* ov = get_fn_ord(fv->get_fn_order() + inc);
+      // Order of shape functions.
+      Func<Ord>* ou = get_fn_ord(fu->get_fn_order() + inc);
+      Func<Ord>* ov = get_fn_ord(fv->get_fn_order() + inc);
 
-    // Order of additional external functions.
-    ExtData<Ord>* fake_ext = init_ext_fns_ord(mfv->ext);
+      // Order of additional external functions.
+      ExtData<Ord>* fake_ext = init_ext_fns_ord(mfv->ext);
 
-    // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
-    double fake_wt = 1.0;
+      // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
+      double fake_wt = 1.0;
 
-    // Total order of the matrix form.
-    Ord o = mfv->ord(1, &fake_wt, oi, ou, ov, &geom_ord, fake_ext);
+      // Total order of the matrix form.
+      Ord o = mfv->ord(1, &fake_wt, oi, ou, ov, &geom_ord, fake_ext);
+
+      // Cleanup.
+      delete [] oi;
+
+      if (fake_ext != NULL) {
+        fake_ext->free_ord(); 
+        delete fake_ext;
+      }
+
+      form_order = o.get_order();
+      store_order(key, form_order);
+    }
 
     // Increase due to reference map.
     order = ru->get_inv_ref_order();
-    order += o.get_order();
+    order += form_order;
     limit_order(order);
-    
-    // Cleanup.
-    delete [] oi;
-
-    if (fake_ext != NULL) {
-      fake_ext->free_ord(); 
-      delete fake_ext;
-    }
   }
   return order;
 }
@@ -2540,43 +3426,58 @@ int DiscreteProblem::calc_order_matrix_form_vol(WeakForm::MultiComponentMatrixFo
     // Increase for multi-valued shape functions.
     int inc = (fu->get_num_components() == 2) ? 1 : 0;
 
-    // Order of solutions from the previous Newton iteration.
-    Func<Ord>** oi = new Func<Ord>*[u_ext_length - u_ext_offset];
-    if (u_ext != Hermes::vector<Solution *>())
-      for(int i = 0; i < u_ext_length - u_ext_offset; i++)
-        if (u_ext[i + u_ext_offset] != NULL)
-          oi[i] = get_fn_ord(u_ext[i + u_ext_offset]->get_fn_order() + inc);
-        else
+    // The order of the form is cached for the orders of the functions.
+    OrderKey key(mfv, ORDER_VOL);
+    key.add(u_ext_length - u_ext_offset);
+    for(int i = 0; i < u_ext_length - u_ext_offset; i++)
+      key.add(u_ext[i + u_ext_offset] != NULL ? u_ext[i + u_ext_offset]->get_fn_order() + inc : 0);
+    key.add(fu->get_fn_order() + inc);
+    key.add(fv->get_fn_order() + inc);
+    key.add_ext_fns(mfv->ext);
+
+    int form_order;
+    if (!find_order(key, form_order)) {
+      // Order of solutions from the previous Newton iteration.
+      Func<Ord>** oi = new Func<Ord>*[u_ext_length - u_ext_offset];
+      if (u_ext != Hermes::vector<Solution *>())
+        for(int i = 0; i < u_ext_length - u_ext_offset; i++)
+          if (u_ext[i + u_ext_offset] != NULL)
+            oi[i] = get_fn_ord(u_ext[i + u_ext_offset]->get_fn_order() + inc);
+          else
+            oi[i] = get_fn_ord(0);
+      else
+        for(int i = 0; i < u_ext_length - u_ext_offset; i++)
           oi[i] = get_fn_ord(0);
-    else
-      for(int i = 0; i < u_ext_length - u_ext_offset; i++)
-        oi[i] = get_fn_ord(0);
 
-    // Order of shape functions.
-    Func<Ord>* ou = get_fn_ord(fu->get_fn_order() + inc);
-    Func<Ord>* ov = get_fn_ord(fv->get_fn_order() + inc);
+      // Order of shape functions.
+      Func<Ord>* ou = get_fn_ord(fu->get_fn_order() + inc);
+      Func<Ord>* ov = get_fn_ord(fv->get_fn_order() + inc);
+
+      // Order of additional external functions.
+      ExtData<Ord>* fake_ext = init_ext_fns_ord(mfv->ext);
 
-    // Order of additional external functions.
-    ExtData<Ord>* fake_ext = init_ext_fns_ord(mfv->ext);
+      // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
+      double fake_wt = 1.0;
 
-    // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
-    double fake_wt = 1.0;
+      // Total order of the matrix form.
+      Ord o = mfv->ord(1, &fake_wt, oi, ou, ov, &geom_ord, fake_ext);
 
-    // Total order of the matrix form.
-    Ord o = mfv->ord(1, &fake_wt, oi, ou, ov, &geom_ord, fake_ext);
+      // Cleanup.
+      delete [] oi;
+
+      if (fake_ext != NULL) {
+        fake_ext->free_ord(); 
+        delete fake_ext;
+      }
+
+      form_order = o.get_order();
+      store_order(key, form_order);
+    }
 
     // Increase due to reference map.
     order = ru->get_inv_ref_order();
-    order += o.get_order();
+    order += form_order;
     limit_order(order);
-    
-    // Cleanup.
-    delete [] oi;
-
-    if (fake_ext != NULL) {
-      fake_ext->free_ord(); 
-      delete fake_ext;
-    }
   }
   return order;
 }
@@ -2592,20 +3493,7 @@ scalar DiscreteProblem::eval_form_subelement(int order, WeakForm::MatrixFormVol
   int np = quad->get_num_points(order);
 
   // Init geometry and jacobian*weights.
-  if (cache_e[order] == NULL)
-  {
-    cache_e[order] = init_geom_vol(ru, order);
-    double* jac = NULL;
-    if(!ru->is_jacobian_const()) 
-      jac = ru->get_jacobian(order);
-    cache_jwt[order] = new double[np];
-    for(int i = 0; i < np; i++) {
-      if(ru->is_jacobian_const())
-        cache_jwt[order][i] = pt[i][2] * ru->get_const_jacobian();
-      else
-        cache_jwt[order][i] = pt[i][2] * jac[i];
-    }
-  }
+  init_geom_cache_vol(ru, order);
   Geom<double>* e = cache_e[order];
   double* jwt = cache_jwt[order];
 
@@ -2735,6 +3623,243 @@ scalar DiscreteProblem::eval_form_adaptive(int order_init, scalar result_init,
 }
 
 
+// Index of the shape function of the highest order in the assembly list.
+static int highest_order_shape(Shapeset* shapeset, AsmList* al)
+{
+  int index = al->idx[0], max_order = -1;
+  for (unsigned int i = 0; i < al->cnt; i++) {
+    int o = shapeset->get_order(al->idx[i]);
+    o = std::max(H2D_GET_H_ORDER(o), H2D_GET_V_ORDER(o));
+    if (o > max_order) {
+      max_order = o;
+      index = al->idx[i];
+    }
+  }
+  return index;
+}
+
+scalar** DiscreteProblem::eval_form_batch(WeakForm::MatrixFormVol *mfv, 
+                                          Hermes::vector<Solution *> u_ext,
+                                          PrecalcShapeset *fu, PrecalcShapeset *fv, 
+                                          RefMap *ru, RefMap *rv, AsmList *alu, AsmList *alv)
+{
+  _F_
+  AssemblingCaches& ac = assembling_caches;
+
+  // All pairs are integrated with the order of the pair of the highest orders.
+  fu->set_active_shape(highest_order_shape(fu->get_shapeset(), alu));
+  fv->set_active_shape(highest_order_shape(fv->get_shapeset(), alv));
+  int order = calc_order_matrix_form_vol(mfv, u_ext, fu, fv, ru, rv);
+
+  Quad2D* quad = fu->get_quad_2d();
+  double3* pt = quad->get_points(order);
+  int np = quad->get_num_points(order);
+
+  // Init geometry and jacobian*weights.
+  init_geom_cache_vol(ru, order);
+  Geom<double>* e = cache_e[order];
+  double* jwt = cache_jwt[order];
+
+  // Values of the previous Newton iteration and external functions in quadrature points.
+  int prev_size = u_ext.size() - mfv->u_ext_offset;
+  Func<scalar>** prev = new Func<scalar>*[prev_size];
+  if (u_ext != Hermes::vector<Solution *>())
+    for (int i = 0; i < prev_size; i++)
+      if (u_ext[i + mfv->u_ext_offset] != NULL) 
+        prev[i] = init_fn(u_ext[i + mfv->u_ext_offset], order);
+      else 
+        prev[i] = NULL;
+  else
+    for (int i = 0; i < prev_size; i++) 
+      prev[i] = NULL;
+
+  ExtData<scalar>* ext = init_ext_fns(mfv->ext, rv, order);
+
+  // All shape functions in quadrature points.
+  ac.batch_u.resize(alu->cnt, np, fu->get_num_components());
+  for (unsigned int j = 0; j < alu->cnt; j++) {
+    fu->set_active_shape(alu->idx[j]);
+    ac.batch_u.set(j, get_fn(fu, ru, order));
+  }
+  ac.batch_v.resize(alv->cnt, np, fv->get_num_components());
+  for (unsigned int i = 0; i < alv->cnt; i++) {
+    fv->set_active_shape(alv->idx[i]);
+    ac.batch_v.set(i, get_fn(fv, rv, order));
+  }
+
+  int dim = std::max(alu->cnt, alv->cnt);
+  if (dim > ac.batch_matrix_dim) {
+    delete [] ac.batch_matrix;
+    ac.batch_matrix = new_matrix<scalar>(dim, dim);
+    ac.batch_matrix_dim = dim;
+  }
+  scalar** result = ac.batch_matrix;
+  for (unsigned int i = 0; i < alv->cnt; i++)
+    memset(result[i], 0, alu->cnt * sizeof(scalar));
+
+  // The actual calculation takes place here.
+  mfv->value_batch(np, jwt, prev, &ac.batch_u, &ac.batch_v, e, ext, result);
+
+  for (unsigned int i = 0; i < alv->cnt; i++)
+    for (unsigned int j = 0; j < alu->cnt; j++)
+      result[i][j] *= mfv->scaling_factor;
+
+  // Clean up.
+  for(int i = 0; i < prev_size; i++)
+    if (prev[i] != NULL) { 
+      prev[i]->free_fn(); 
+      delete prev[i]; 
+    }
+  delete [] prev;
+
+  if (ext != NULL) {
+    ext->free(); 
+    delete ext;
+  }
+
+  return result;
+}
+
+
+scalar** DiscreteProblem::eval_form_ref(WeakForm::MatrixFormVol *mfv, PrecalcShapeset *fu,
+                                        PrecalcShapeset *fv, RefMap *ru, AsmList *alu, AsmList *alv)
+{
+  _F_
+  if (!ru->is_jacobian_const() || fu->get_transform() != 0 || fv->get_transform() != 0)
+    return NULL;
+  if (!RefMatrixCache::is_supported(fu->get_shapeset()) || !RefMatrixCache::is_supported(fv->get_shapeset()))
+    return NULL;
+
+  scalar coeffs[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES];
+  for (int p = 0; p < H2D_NUM_REF_QUANTITIES; p++)
+    for (int q = 0; q < H2D_NUM_REF_QUANTITIES; q++)
+      coeffs[p][q] = 0.0;
+  if (!mfv->ref_coeffs(*ru->get_const_inv_ref_map(), ru->get_const_jacobian(), coeffs))
+    return NULL;
+  for (int p = 0; p < H2D_NUM_REF_QUANTITIES; p++)
+    for (int q = 0; q < H2D_NUM_REF_QUANTITIES; q++)
+      coeffs[p][q] *= mfv->scaling_factor;
+
+  AssemblingCaches& ac = assembling_caches;
+  int dim = std::max(alu->cnt, alv->cnt);
+  if (dim > ac.batch_matrix_dim) {
+    delete [] ac.batch_matrix;
+    ac.batch_matrix = new_matrix<scalar>(dim, dim);
+    ac.batch_matrix_dim = dim;
+  }
+  ac.ref_matrices.combine(fu->get_shapeset(), alu, fv->get_shapeset(), alv, fu->get_quad_2d(),
+                          coeffs, ac.batch_matrix);
+  return ac.batch_matrix;
+}
+
+// Inverse reference maps of the active element of rm in the points of the volumetric
+// quadrature of the order.
+static double2x2* get_inv_ref_maps(RefMap* rm, int order, int np, SumFactorization& sum_fact)
+{
+  if (!rm->is_jacobian_const())
+    return rm->get_inv_ref_map(order);
+  double2x2* m = sum_fact.get_inv_ref_map_buffer(np);
+  for (int k = 0; k < np; k++)
+    memcpy(m[k], *rm->get_const_inv_ref_map(), sizeof(double2x2));
+  return m;
+}
+
+// The 1D rule of the volumetric quadrature of fn if sum factorization can be used, else NULL.
+static Quad1D* get_sum_fact_quad(PrecalcShapeset* fn)
+{
+  Quad2D* quad = fn->get_quad_2d();
+  if (quad->get_mode() != HERMES_MODE_QUAD || fn->get_transform() != 0)
+    return NULL;
+  return quad->get_tensor_quad_1d();
+}
+
+scalar** DiscreteProblem::eval_form_sum_fact(WeakForm::MatrixFormVol *mfv, Hermes::vector<Solution *> u_ext,
+                                             PrecalcShapeset *fu, PrecalcShapeset *fv, RefMap *ru, RefMap *rv,
+                                             AsmList *alu, AsmList *alv)
+{
+  _F_
+  AssemblingCaches& ac = assembling_caches;
+  if (!ac.use_sum_fact || mfv->adapt_eval || fv->get_transform() != 0)
+    return NULL;
+  Quad1D* quad_1d = get_sum_fact_quad(fu);
+  if (quad_1d == NULL || !ac.sum_fact.is_supported(fu->get_shapeset(), alu)
+      || !ac.sum_fact.is_supported(fv->get_shapeset(), alv))
+    return NULL;
+
+  // All pairs are integrated with the order of the pair of the highest orders.
+  fu->set_active_shape(highest_order_shape(fu->get_shapeset(), alu));
+  fv->set_active_shape(highest_order_shape(fv->get_shapeset(), alv));
+  int order = calc_order_matrix_form_vol(mfv, u_ext, fu, fv, ru, rv);
+  int np = fu->get_quad_2d()->get_num_points(order);
+  if (order > quad_1d->get_max_order() || np != sqr(quad_1d->get_num_points(order)))
+    return NULL;
+
+  init_geom_cache_vol(ru, order);
+  SumFactorization::MatrixCoeffs* coeffs = ac.sum_fact.get_matrix_coeffs(np);
+  if (!mfv->ref_point_coeffs(np, cache_jwt[order], get_inv_ref_maps(ru, order, np, ac.sum_fact),
+                             cache_e[order], coeffs))
+    return NULL;
+  for (int k = 0; k < np; k++)
+    for (int p = 0; p < H2D_NUM_REF_QUANTITIES; p++)
+      for (int q = 0; q < H2D_NUM_REF_QUANTITIES; q++)
+        coeffs[k][p][q] *= mfv->scaling_factor;
+
+  int dim = std::max(alu->cnt, alv->cnt);
+  if (dim > ac.batch_matrix_dim) {
+    delete [] ac.batch_matrix;
+    ac.batch_matrix = new_matrix<scalar>(dim, dim);
+    ac.batch_matrix_dim = dim;
+  }
+  ac.sum_fact.assemble_matrix(fu->get_shapeset(), alu, fv->get_shapeset(), alv, quad_1d, order,
+                              coeffs, ac.batch_matrix);
+  return ac.batch_matrix;
+}
+
+scalar** DiscreteProblem::get_cached_values(WeakForm::MatrixFormVol *mfv, Hermes::vector<Solution *> u_ext,
+                                            PrecalcShapeset *fu, PrecalcShapeset *fv, RefMap *ru, RefMap *rv,
+                                            AsmList *alu, AsmList *alv)
+{
+  _F_
+  AssemblingCaches& ac = assembling_caches;
+  int n = alu->cnt * alv->cnt;
+  scalar* values = element_cache->get_values(element_cache_entry, mfv, mfv->scaling_factor, n);
+  if (values == NULL) {
+    scalar** batch = eval_form_sum_fact(mfv, u_ext, fu, fv, ru, rv, alu, alv);
+    if (batch == NULL && mfv->batch_eval && !mfv->adapt_eval && is_batch_supported(fu) && is_batch_supported(fv))
+      batch = eval_form_batch(mfv, u_ext, fu, fv, ru, rv, alu, alv);
+    if (batch == NULL) {
+      int dim = std::max(alu->cnt, alv->cnt);
+      if (dim > ac.batch_matrix_dim) {
+        delete [] ac.batch_matrix;
+        ac.batch_matrix = new_matrix<scalar>(dim, dim);
+        ac.batch_matrix_dim = dim;
+      }
+      batch = ac.batch_matrix;
+      // The values of a symmetric form on a diagonal block are computed only once.
+      bool sym = (mfv->sym == 1) && (alu == alv);
+      for (unsigned int i = 0; i < alv->cnt; i++) {
+        fv->set_active_shape(alv->idx[i]);
+        for (unsigned int j = sym ? i : 0; j < alu->cnt; j++) {
+          fu->set_active_shape(alu->idx[j]);
+          batch[i][j] = eval_form(mfv, u_ext, fu, fv, ru, rv);
+          if (sym) batch[j][i] = batch[i][j];
+        }
+      }
+    }
+
+    values = element_cache->add_values(element_cache_entry, mfv, mfv->scaling_factor, n);
+    if (values == NULL) return batch;
+    for (unsigned int i = 0; i < alv->cnt; i++)
+      memcpy(values + i * alu->cnt, batch[i], alu->cnt * sizeof(scalar));
+  }
+
+  ac.cached_rows.resize(alv->cnt);
+  for (unsigned int i = 0; i < alv->cnt; i++)
+    ac.cached_rows[i] = values + i * alu->cnt;
+  return &ac.cached_rows[0];
+}
+
+
 // Volume vector forms.
 
 scalar DiscreteProblem::eval_form(WeakForm::VectorFormVol *vfv, 
@@ -2786,20 +3911,7 @@ void DiscreteProblem::eval_form(WeakForm::MultiComponentVectorFormVol *vfv,
   int np = quad->get_num_points(order);
 
   // Init geometry and jacobian*weights.
-  if (cache_e[order] == NULL)
-  {
-    cache_e[order] = init_geom_vol(rv, order);
-    double* jac = NULL;
-    if(!rv->is_jacobian_const()) 
-      jac = rv->get_jacobian(order);
-    cache_jwt[order] = new double[np];
-    for(int i = 0; i < np; i++) {
-      if(rv->is_jacobian_const())
-        cache_jwt[order][i] = pt[i][2] * rv->get_const_jacobian();
-      else
-        cache_jwt[order][i] = pt[i][2] * jac[i];
-    }
-  }
+  init_geom_cache_vol(rv, order);
   Geom<double>* e = cache_e[order];
   double* jwt = cache_jwt[order];
 
@@ -2857,43 +3969,57 @@ int DiscreteProblem::calc_order_vector_form_vol(WeakForm::VectorFormVol *vfv,
     // Increase for multi-valued shape functions.
     int inc = (fv->get_num_components() == 2) ? 1 : 0;
 
-    // Order of solutions from the previous Newton iteration.
-    Func<Ord>** oi = new Func<Ord>*[u_ext_length - u_ext_offset];
-    if (u_ext != Hermes::vector<Solution *>())
-      for(int i = 0; i < u_ext_length - u_ext_offset; i++)
-        if (u_ext[i + u_ext_offset] != NULL)
-          oi[i] = get_fn_ord(u_ext[i + u_ext_offset]->get_fn_order() + inc);
-        else
+    // The order of the form is cached for the orders of the functions.
+    OrderKey key(vfv, ORDER_VOL);
+    key.add(u_ext_length - u_ext_offset);
+    for(int i = 0; i < u_ext_length - u_ext_offset; i++)
+      key.add(u_ext[i + u_ext_offset] != NULL ? u_ext[i + u_ext_offset]->get_fn_order() + inc : 0);
+    key.add(fv->get_fn_order() + inc);
+    key.add_ext_fns(vfv->ext);
+
+    int form_order;
+    if (!find_order(key, form_order)) {
+      // Order of solutions from the previous Newton iteration.
+      Func<Ord>** oi = new Func<Ord>*[u_ext_length - u_ext_offset];
+      if (u_ext != Hermes::vector<Solution *>())
+        for(int i = 0; i < u_ext_length - u_ext_offset; i++)
+          if (u_ext[i + u_ext_offset] != NULL)
+            oi[i] = get_fn_ord(u_ext[i + u_ext_offset]->get_fn_order() + inc);
+          else
+            oi[i] = get_fn_ord(0);
+      else
+        for(int i = 0; i < u_ext_length - u_ext_offset; i++)
           oi[i] = get_fn_ord(0);
-    else
-      for(int i = 0; i < u_ext_length - u_ext_offset; i++)
-        oi[i] = get_fn_ord(0);
 
-    // Order of the shape function.
-    Func<Ord>* ov = get_fn_ord(fv->get_fn_order() + inc);
+      // Order of the shape function.
+      Func<Ord>* ov = get_fn_ord(fv->get_fn_order() + inc);
 
-    // Order of additional external functions.
-    ExtData<Ord>* fake_ext = init_ext_fns_ord(vfv->ext);
+      // Order of additional external functions.
+      ExtData<Ord>* fake_ext = init_ext_fns_ord(vfv->ext);
 
-    // Order of geometric attributes (eg. for multiplication of 
-    // a solution with coordinates, normals, etc.).
-    double fake_wt = 1.0;
+      // Order of geometric attributes (eg. for multiplication of 
+      // a solution with coordinates, normals, etc.).
+      double fake_wt = 1.0;
 
-    // Total order of the vector form.
-    Ord o = vfv->ord(1, &fake_wt, oi, ov, &geom_ord, fake_ext);
+      // Total order of the vector form.
+      Ord o = vfv->ord(1, &fake_wt, oi, ov, &geom_ord, fake_ext);
+
+      // Cleanup.
+      delete [] oi;
+
+      if (fake_ext != NULL) {
+        fake_ext->free_ord(); 
+        delete fake_ext;
+      }
+
+      form_order = o.get_order();
+      store_order(key, form_order);
+    }
 
     // Increase due to reference map.
     order = rv->get_inv_ref_order();
-    order += o.get_order();
+    order += form_order;
     limit_order(order);
-    
-    // Cleanup.
-    delete [] oi;
-
-    if (fake_ext != NULL) {
-      fake_ext->free_ord(); 
-      delete fake_ext;
-    }
   }
   return order;
 }
@@ -2915,43 +4041,57 @@ int DiscreteProblem::calc_order_vector_form_vol(WeakForm::MultiComponentVectorFo
     // Increase for multi-valued shape functions.
     int inc = (fv->get_num_components() == 2) ? 1 : 0;
 
-    // Order of solutions from the previous Newton iteration.
-    Func<Ord>** oi = new Func<Ord>*[u_ext_length - u_ext_offset];
-    if (u_ext != Hermes::vector<Solution *>())
-      for(int i = 0; i < u_ext_length - u_ext_offset; i++)
-        if (u_ext[i + u_ext_offset] != NULL)
-          oi[i] = get_fn_ord(u_ext[i + u_ext_offset]->get_fn_order() + inc);
-        else
+    // The order of the form is cached for the orders of the functions.
+    OrderKey key(vfv, ORDER_VOL);
+    key.add(u_ext_length - u_ext_offset);
+    for(int i = 0; i < u_ext_length - u_ext_offset; i++)
+      key.add(u_ext[i + u_ext_offset] != NULL ? u_ext[i + u_ext_offset]->get_fn_order() + inc : 0);
+    key.add(fv->get_fn_order() + inc);
+    key.add_ext_fns(vfv->ext);
+
+    int form_order;
+    if (!find_order(key, form_order)) {
+      // Order of solutions from the previous Newton iteration.
+      Func<Ord>** oi = new Func<Ord>*[u_ext_length - u_ext_offset];
+      if (u_ext != Hermes::vector<Solution *>())
+        for(int i = 0; i < u_ext_length - u_ext_offset; i++)
+          if (u_ext[i + u_ext_offset] != NULL)
+            oi[i] = get_fn_ord(u_ext[i + u_ext_offset]->get_fn_order() + inc);
+          else
+            oi[i] = get_fn_ord(0);
+      else
+        for(int i = 0; i < u_ext_length - u_ext_offset; i++)
           oi[i] = get_fn_ord(0);
-    else
-      for(int i = 0; i < u_ext_length - u_ext_offset; i++)
-        oi[i] = get_fn_ord(0);
 
-    // Order of the shape function.
-    Func<Ord>* ov = get_fn_ord(fv->get_fn_order() + inc);
+      // Order of the shape function.
+      Func<Ord>* ov = get_fn_ord(fv->get_fn_order() + inc);
+
+      // Order of additional external functions.
+      ExtData<Ord>* fake_ext = init_ext_fns_ord(vfv->ext);
+
+      // Order of geometric attributes (eg. for multiplication of 
+      // a solution with coordinates, normals, etc.).
+      double fake_wt = 1.0;
+
+      // Total order of the vector form.
+      Ord o = vfv->ord(1, &fake_wt, oi, ov, &geom_ord, fake_ext);
 
-    // Order of additional external functions.
-    ExtData<Ord>* fake_ext = init_ext_fns_ord(vfv->ext);
+      // Cleanup.
+      delete [] oi;
 
-    // Order of geometric attributes (eg. for multiplication of 
-    // a solution with coordinates, normals, etc.).
-    double fake_wt = 1.0;
+      if (fake_ext != NULL) {
+        fake_ext->free_ord(); 
+        delete fake_ext;
+      }
 
-    // Total order of the vector form.
-    Ord o = vfv->ord(1, &fake_wt, oi, ov, &geom_ord, fake_ext);
+      form_order = o.get_order();
+      store_order(key, form_order);
+    }
 
     // Increase due to reference map.
     order = rv->get_inv_ref_order();
-    order += o.get_order();
+    order += form_order;
     limit_order(order);
-    
-    // Cleanup.
-    delete [] oi;
-
-    if (fake_ext != NULL) {
-      fake_ext->free_ord(); 
-      delete fake_ext;
-    }
   }
   return order;
 }
@@ -2967,20 +4107,7 @@ scalar DiscreteProblem::eval_form_subelement(int order, WeakForm::VectorFormVol
   int np = quad->get_num_points(order);
 
   // Init geometry and jacobian*weights.
-  if (cache_e[order] == NULL)
-  {
-    cache_e[order] = init_geom_vol(rv, order);
-    double* jac = NULL;
-    if(!rv->is_jacobian_const()) 
-      jac = rv->get_jacobian(order);
-    cache_jwt[order] = new double[np];
-    for(int i = 0; i < np; i++) {
-      if(rv->is_jacobian_const())
-        cache_jwt[order][i] = pt[i][2] * rv->get_const_jacobian();
-      else
-        cache_jwt[order][i] = pt[i][2] * jac[i];
-    }
-  }
+  init_geom_cache_vol(rv, order);
   Geom<double>* e = cache_e[order];
   double* jwt = cache_jwt[order];
 
@@ -3103,6 +4230,154 @@ scalar DiscreteProblem::eval_form_adaptive(int order_init, scalar result_init,
 }
 
 
+scalar* DiscreteProblem::eval_form_batch(WeakForm::VectorFormVol *vfv, 
+                                         Hermes::vector<Solution *> u_ext, 
+                                         PrecalcShapeset *fv, RefMap *rv, AsmList *alv)
+{
+  _F_
+  AssemblingCaches& ac = assembling_caches;
+
+  // All test functions are integrated with the order of the highest one.
+  fv->set_active_shape(highest_order_shape(fv->get_shapeset(), alv));
+  int order = calc_order_vector_form_vol(vfv, u_ext, fv, rv);
+
+  Quad2D* quad = fv->get_quad_2d();
+  double3* pt = quad->get_points(order);
+  int np = quad->get_num_points(order);
+
+  // Init geometry and jacobian*weights.
+  init_geom_cache_vol(rv, order);
+  Geom<double>* e = cache_e[order];
+  double* jwt = cache_jwt[order];
+
+  // Values of the previous Newton iteration and external functions in quadrature points.
+  int prev_size = u_ext.size() - vfv->u_ext_offset;
+  Func<scalar>** prev = new Func<scalar>*[prev_size];
+  if (u_ext != Hermes::vector<Solution *>())
+    for (int i = 0; i < prev_size; i++)
+      if (u_ext[i + vfv->u_ext_offset] != NULL) 
+        prev[i] = init_fn(u_ext[i + vfv->u_ext_offset], order);
+      else 
+        prev[i] = NULL;
+  else
+    for (int i = 0; i < prev_size; i++) 
+      prev[i] = NULL;
+
+  ExtData<scalar>* ext = init_ext_fns(vfv->ext, rv, order);
+
+  // All test functions in quadrature points.
+  ac.batch_v.resize(alv->cnt, np, fv->get_num_components());
+  for (unsigned int i = 0; i < alv->cnt; i++) {
+    fv->set_active_shape(alv->idx[i]);
+    ac.batch_v.set(i, get_fn(fv, rv, order));
+  }
+
+  ac.batch_vector.assign(alv->cnt, 0.0);
+  scalar* result = &ac.batch_vector[0];
+
+  // The actual calculation takes place here.
+  vfv->value_batch(np, jwt, prev, &ac.batch_v, e, ext, result);
+
+  for (unsigned int i = 0; i < alv->cnt; i++)
+    result[i] *= vfv->scaling_factor;
+
+  // Clean up.
+  for(int i = 0; i < prev_size; i++)
+    if (prev[i] != NULL) { 
+      prev[i]->free_fn(); 
+      delete prev[i]; 
+    }
+  delete [] prev;
+
+  if (ext != NULL) {
+    ext->free(); 
+    delete ext;
+  }
+
+  return result;
+}
+
+
+scalar* DiscreteProblem::eval_form_ref(WeakForm::VectorFormVol *vfv, PrecalcShapeset *fv,
+                                       RefMap *rv, AsmList *alv)
+{
+  _F_
+  if (!rv->is_jacobian_const() || fv->get_transform() != 0 || !RefMatrixCache::is_supported(fv->get_shapeset()))
+    return NULL;
+
+  scalar coeffs[H2D_NUM_REF_QUANTITIES];
+  for (int q = 0; q < H2D_NUM_REF_QUANTITIES; q++)
+    coeffs[q] = 0.0;
+  if (!vfv->ref_coeffs(*rv->get_const_inv_ref_map(), rv->get_const_jacobian(), coeffs))
+    return NULL;
+  for (int q = 0; q < H2D_NUM_REF_QUANTITIES; q++)
+    coeffs[q] *= vfv->scaling_factor;
+
+  AssemblingCaches& ac = assembling_caches;
+  ac.batch_vector.resize(alv->cnt);
+  ac.ref_matrices.combine(fv->get_shapeset(), alv, fv->get_quad_2d(), coeffs, &ac.batch_vector[0]);
+  return &ac.batch_vector[0];
+}
+
+scalar* DiscreteProblem::eval_form_sum_fact(WeakForm::VectorFormVol *vfv, Hermes::vector<Solution *> u_ext,
+                                            PrecalcShapeset *fv, RefMap *rv, AsmList *alv)
+{
+  _F_
+  AssemblingCaches& ac = assembling_caches;
+  if (!ac.use_sum_fact || vfv->adapt_eval)
+    return NULL;
+  Quad1D* quad_1d = get_sum_fact_quad(fv);
+  if (quad_1d == NULL || !ac.sum_fact.is_supported(fv->get_shapeset(), alv))
+    return NULL;
+
+  // All test functions are integrated with the order of the highest one.
+  fv->set_active_shape(highest_order_shape(fv->get_shapeset(), alv));
+  int order = calc_order_vector_form_vol(vfv, u_ext, fv, rv);
+  int np = fv->get_quad_2d()->get_num_points(order);
+  if (order > quad_1d->get_max_order() || np != sqr(quad_1d->get_num_points(order)))
+    return NULL;
+
+  init_geom_cache_vol(rv, order);
+  SumFactorization::VectorCoeffs* coeffs = ac.sum_fact.get_vector_coeffs(np);
+  if (!vfv->ref_point_coeffs(np, cache_jwt[order], get_inv_ref_maps(rv, order, np, ac.sum_fact),
+                             cache_e[order], coeffs))
+    return NULL;
+  for (int k = 0; k < np; k++)
+    for (int q = 0; q < H2D_NUM_REF_QUANTITIES; q++)
+      coeffs[k][q] *= vfv->scaling_factor;
+
+  ac.batch_vector.resize(alv->cnt);
+  ac.sum_fact.assemble_vector(fv->get_shapeset(), alv, quad_1d, order, coeffs, &ac.batch_vector[0]);
+  return &ac.batch_vector[0];
+}
+
+scalar* DiscreteProblem::get_cached_values(WeakForm::VectorFormVol *vfv, Hermes::vector<Solution *> u_ext,
+                                           PrecalcShapeset *fv, RefMap *rv, AsmList *alv)
+{
+  _F_
+  scalar* values = element_cache->get_values(element_cache_entry, vfv, vfv->scaling_factor, alv->cnt);
+  if (values != NULL) return values;
+
+  scalar* batch = eval_form_sum_fact(vfv, u_ext, fv, rv, alv);
+  if (batch == NULL && vfv->batch_eval && !vfv->adapt_eval && is_batch_supported(fv))
+    batch = eval_form_batch(vfv, u_ext, fv, rv, alv);
+  if (batch == NULL) {
+    AssemblingCaches& ac = assembling_caches;
+    ac.batch_vector.resize(alv->cnt);
+    batch = &ac.batch_vector[0];
+    for (unsigned int i = 0; i < alv->cnt; i++) {
+      fv->set_active_shape(alv->idx[i]);
+      batch[i] = eval_form(vfv, u_ext, fv, rv);
+    }
+  }
+
+  values = element_cache->add_values(element_cache_entry, vfv, vfv->scaling_factor, alv->cnt);
+  if (values == NULL) return batch;
+  memcpy(values, batch, alv->cnt * sizeof(scalar));
+  return values;
+}
+
+
 // Surface matrix forms.
 
 scalar DiscreteProblem::eval_form(WeakForm::MatrixFormSurf *mfs, 
@@ -3153,14 +4428,7 @@ void DiscreteProblem::eval_form(WeakForm::MultiComponentMatrixFormSurf *mfs,
   int np = quad->get_num_points(eo);
 
   // Init geometry and jacobian*weights.
-  if (cache_e[eo] == NULL)
-  {
-    cache_e[eo] = init_geom_surf(ru, surf_pos, eo);
-    double3* tan = ru->get_tangent(surf_pos->surf_num, eo);
-    cache_jwt[eo] = new double[np];
-    for(int i = 0; i < np; i++)
-      cache_jwt[eo][i] = pt[i][2] * tan[i][2];
-  }
+  init_geom_cache_surf(ru, surf_pos, eo);
   Geom<double>* e = cache_e[eo];
   double* jwt = cache_jwt[eo];
 
@@ -3218,43 +4486,58 @@ int DiscreteProblem::calc_order_matrix_form_surf(WeakForm::MatrixFormSurf *mfs,
     // Increase for multi-valued shape functions.
     int inc = (fu->get_num_components() == 2) ? 1 : 0;
 
-    // Order of solutions from the previous Newton iteration.
-    Func<Ord>** oi = new Func<Ord>*[u_ext_length - u_ext_offset];
-    if (u_ext != Hermes::vector<Solution *>())
-      for(int i = 0; i < u_ext_length - u_ext_offset; i++)
-        if (u_ext[i + u_ext_offset] != NULL)
-          oi[i] = get_fn_ord(u_ext[i + u_ext_offset]->get_edge_fn_order(surf_pos->surf_num) + inc);
-        else
+    // The order of the form is cached for the orders of the functions.
+    OrderKey key(mfs, ORDER_SURF);
+    key.add(u_ext_length - u_ext_offset);
+    for(int i = 0; i < u_ext_length - u_ext_offset; i++)
+      key.add(u_ext[i + u_ext_offset] != NULL ? u_ext[i + u_ext_offset]->get_edge_fn_order(surf_pos->surf_num) + inc : 0);
+    key.add(fu->get_edge_fn_order(surf_pos->surf_num) + inc);
+    key.add(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
+    key.add_ext_fns(mfs->ext, surf_pos->surf_num);
+
+    int form_order;
+    if (!find_order(key, form_order)) {
+      // Order of solutions from the previous Newton iteration.
+      Func<Ord>** oi = new Func<Ord>*[u_ext_length - u_ext_offset];
+      if (u_ext != Hermes::vector<Solution *>())
+        for(int i = 0; i < u_ext_length - u_ext_offset; i++)
+          if (u_ext[i + u_ext_offset] != NULL)
+            oi[i] = get_fn_ord(u_ext[i + u_ext_offset]->get_edge_fn_order(surf_pos->surf_num) + inc);
+          else
+            oi[i] = get_fn_ord(0);
+      else
+        for(int i = 0; i < u_ext_length - u_ext_offset; i++)
           oi[i] = get_fn_ord(0);
-    else
-      for(int i = 0; i < u_ext_length - u_ext_offset; i++)
-        oi[i] = get_fn_ord(0);
 
-    // Order of shape functions.
-    Func<Ord>* ou = get_fn_ord(fu->get_edge_fn_order(surf_pos->surf_num) + inc);
-    Func<Ord>* ov = get_fn_ord(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
+      // Order of shape functions.
+      Func<Ord>* ou = get_fn_ord(fu->get_edge_fn_order(surf_pos->surf_num) + inc);
+      Func<Ord>* ov = get_fn_ord(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
 
-    // Order of additional external functions.
-    ExtData<Ord>* fake_ext = init_ext_fns_ord(mfs->ext, surf_pos->surf_num);
+      // Order of additional external functions.
+      ExtData<Ord>* fake_ext = init_ext_fns_ord(mfs->ext, surf_pos->surf_num);
 
-    // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
-    double fake_wt = 1.0;
+      // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
+      double fake_wt = 1.0;
 
-    // Total order of the matrix form.
-    Ord o = mfs->ord(1, &fake_wt, oi, ou, ov, &geom_ord, fake_ext);
+      // Total order of the matrix form.
+      Ord o = mfs->ord(1, &fake_wt, oi, ou, ov, &geom_ord, fake_ext);
 
-    // Increase due to reference map.
-    order = ru->get_inv_ref_order();
-    order += o.get_order();
-    limit_order(order);
+      // Cleanup.
+      delete [] oi;
 
-    // Cleanup.
-    delete [] oi;
+      if (fake_ext != NULL) {
+        fake_ext->free_ord(); 
+        delete fake_ext;
+      }
 
-    if (fake_ext != NULL) {
-      fake_ext->free_ord(); 
-      delete fake_ext;
+      form_order = o.get_order();
+      store_order(key, form_order);
     }
+
+    // Increase due to reference map.
+    order = ru->get_inv_ref_order();
+    order += form_order;
+    limit_order(order);
   }
   return order;
 }
@@ -3275,43 +4558,58 @@ int DiscreteProblem::calc_order_matrix_form_surf(WeakForm::MultiComponentMatrixF
     // Increase for multi-valued shape functions.
     int inc = (fu->get_num_components() == 2) ? 1 : 0;
 
-    // Order of solutions from the previous Newton iteration.
-    Func<Ord>** oi = new Func<Ord>*[u_ext_length - u_ext_offset];
-    if (u_ext != Hermes::vector<Solution *>())
-      for(int i = 0; i < u_ext_length - u_ext_offset; i++)
-        if (u_ext[i + u_ext_offset] != NULL)
-          oi[i] = get_fn_ord(u_ext[i + u_ext_offset]->get_edge_fn_order(surf_pos->surf_num) + inc);
-        else
+    // The order of the form is cached for the orders of the functions.
+    OrderKey key(mfs, ORDER_SURF);
+    key.add(u_ext_length - u_ext_offset);
+    for(int i = 0; i < u_ext_length - u_ext_offset; i++)
+      key.add(u_ext[i + u_ext_offset] != NULL ? u_ext[i + u_ext_offset]->get_edge_fn_order(surf_pos->surf_num) + inc : 0);
+    key.add(fu->get_edge_fn_order(surf_pos->surf_num) + inc);
+    key.add(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
+    key.add_ext_fns(mfs->ext, surf_pos->surf_num);
+
+    int form_order;
+    if (!find_order(key, form_order)) {
+      // Order of solutions from the previous Newton iteration.
+      Func<Ord>** oi = new Func<Ord>*[u_ext_length - u_ext_offset];
+      if (u_ext != Hermes::vector<Solution *>())
+        for(int i = 0; i < u_ext_length - u_ext_offset; i++)
+          if (u_ext[i + u_ext_offset] != NULL)
+            oi[i] = get_fn_ord(u_ext[i + u_ext_offset]->get_edge_fn_order(surf_pos->surf_num) + inc);
+          else
+            oi[i] = get_fn_ord(0);
+      else
+        for(int i = 0; i < u_ext_length - u_ext_offset; i++)
           oi[i] = get_fn_ord(0);
-    else
-      for(int i = 0; i < u_ext_length - u_ext_offset; i++)
-        oi[i] = get_fn_ord(0);
 
-    // Order of shape functions.
-    Func<Ord>* ou = get_fn_ord(fu->get_edge_fn_order(surf_pos->surf_num) + inc);
-    Func<Ord>* ov = get_fn_ord(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
+      // Order of shape functions.
+      Func<Ord>* ou = get_fn_ord(fu->get_edge_fn_order(surf_pos->surf_num) + inc);
+      Func<Ord>* ov = get_fn_ord(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
 
-    // Order of additional external functions.
-    ExtData<Ord>* fake_ext = init_ext_fns_ord(mfs->ext, surf_pos->surf_num);
+      // Order of additional external functions.
+      ExtData<Ord>* fake_ext = init_ext_fns_ord(mfs->ext, surf_pos->surf_num);
 
-    // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
-    double fake_wt = 1.0;
+      // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
+      double fake_wt = 1.0;
 
-    // Total order of the matrix form.
-    Ord o = mfs->ord(1, &fake_wt, oi, ou, ov, &geom_ord, fake_ext);
+      // Total order of the matrix form.
+      Ord o = mfs->ord(1, &fake_wt, oi, ou, ov, &geom_ord, fake_ext);
 
-    // Increase due to reference map.
-    order = ru->get_inv_ref_order();
-    order += o.get_order();
-    limit_order(order);
+      // Cleanup.
+      delete [] oi;
 
-    // Cleanup.
-    delete [] oi;
+      if (fake_ext != NULL) {
+        fake_ext->free_ord(); 
+        delete fake_ext;
+      }
 
-    if (fake_ext != NULL) {
-      fake_ext->free_ord(); 
-      delete fake_ext;
+      form_order = o.get_order();
+      store_order(key, form_order);
     }
+
+    // Increase due to reference map.
+    order = ru->get_inv_ref_order();
+    order += form_order;
+    limit_order(order);
   }
   return order;
 }
@@ -3328,14 +4626,7 @@ scalar DiscreteProblem::eval_form_subelement(int order, WeakForm::MatrixFormSurf
   int np = quad->get_num_points(eo);
 
   // Init geometry and jacobian*weights.
-  if (cache_e[eo] == NULL)
-  {
-    cache_e[eo] = init_geom_surf(ru, surf_pos, eo);
-    double3* tan = ru->get_tangent(surf_pos->surf_num, eo);
-    cache_jwt[eo] = new double[np];
-    for(int i = 0; i < np; i++)
-      cache_jwt[eo][i] = pt[i][2] * tan[i][2];
-  }
+  init_geom_cache_surf(ru, surf_pos, eo);
   Geom<double>* e = cache_e[eo];
   double* jwt = cache_jwt[eo];
 
@@ -3512,13 +4803,7 @@ void DiscreteProblem::eval_form(WeakForm::MultiComponentVectorFormSurf *vfs,
   int np = quad->get_num_points(eo);
 
   // Init geometry and jacobian*weights.
-  if (cache_e[eo] == NULL) {
-    cache_e[eo] = init_geom_surf(rv, surf_pos, eo);
-    double3* tan = rv->get_tangent(surf_pos->surf_num, eo);
-    cache_jwt[eo] = new double[np];
-    for(int i = 0; i < np; i++)
-      cache_jwt[eo][i] = pt[i][2] * tan[i][2];
-  }
+  init_geom_cache_surf(rv, surf_pos, eo);
   Geom<double>* e = cache_e[eo];
   double* jwt = cache_jwt[eo];
 
@@ -3575,42 +4860,56 @@ int DiscreteProblem::calc_order_vector_form_surf(WeakForm::VectorFormSurf *vfs,
     // Increase for multi-valued shape functions.
     int inc = (fv->get_num_components() == 2) ? 1 : 0;
 
-    // Order of solutions from the previous Newton iteration.
-    Func<Ord>** oi = new Func<Ord>*[u_ext_length - u_ext_offset];
-    if (u_ext != Hermes::vector<Solution *>())
-      for(int i = 0; i < u_ext_length - u_ext_offset; i++)
-        if (u_ext[i + u_ext_offset] != NULL)
-          oi[i] = get_fn_ord(u_ext[i]->get_edge_fn_order(surf_pos->surf_num) + inc);
-        else
+    // The order of the form is cached for the orders of the functions.
+    OrderKey key(vfs, ORDER_SURF);
+    key.add(u_ext_length - u_ext_offset);
+    for(int i = 0; i < u_ext_length - u_ext_offset; i++)
+      key.add(u_ext[i + u_ext_offset] != NULL ? u_ext[i]->get_edge_fn_order(surf_pos->surf_num) + inc : 0);
+    key.add(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
+    key.add_ext_fns(vfs->ext);
+
+    int form_order;
+    if (!find_order(key, form_order)) {
+      // Order of solutions from the previous Newton iteration.
+      Func<Ord>** oi = new Func<Ord>*[u_ext_length - u_ext_offset];
+      if (u_ext != Hermes::vector<Solution *>())
+        for(int i = 0; i < u_ext_length - u_ext_offset; i++)
+          if (u_ext[i + u_ext_offset] != NULL)
+            oi[i] = get_fn_ord(u_ext[i]->get_edge_fn_order(surf_pos->surf_num) + inc);
+          else
+            oi[i] = get_fn_ord(0);
+      else
+        for(int i = 0; i < u_ext_length - u_ext_offset; i++)
           oi[i] = get_fn_ord(0);
-    else
-      for(int i = 0; i < u_ext_length - u_ext_offset; i++)
-        oi[i] = get_fn_ord(0);
 
-    // Order of the shape function.
-    Func<Ord>* ov = get_fn_ord(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
+      // Order of the shape function.
+      Func<Ord>* ov = get_fn_ord(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
 
-    // Order of additional external functions.
-    ExtData<Ord>* fake_ext = init_ext_fns_ord(vfs->ext);
+      // Order of additional external functions.
+      ExtData<Ord>* fake_ext = init_ext_fns_ord(vfs->ext);
 
-    // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
-    double fake_wt = 1.0;
+      // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
+      double fake_wt = 1.0;
+
+      // Total order of the vector form.
+      Ord o = vfs->ord(1, &fake_wt, oi, ov, &geom_ord, fake_ext);
+
+      // Cleanup.
+      delete [] oi;
+
+      if (fake_ext != NULL) {
+        fake_ext->free_ord(); 
+        delete fake_ext;
+      }
 
-    // Total order of the vector form.
-    Ord o = vfs->ord(1, &fake_wt, oi, ov, &geom_ord, fake_ext);
+      form_order = o.get_order();
+      store_order(key, form_order);
+    }
 
     // Increase due to reference map.
     order = rv->get_inv_ref_order();
-    order += o.get_order();
+    order += form_order;
     limit_order(order);
-    
-    // Cleanup.
-    delete [] oi;
-
-    if (fake_ext != NULL) {
-      fake_ext->free_ord(); 
-      delete fake_ext;
-    }
   }
   return order;
 }
@@ -3631,42 +4930,56 @@ int DiscreteProblem::calc_order_vector_form_surf(WeakForm::MultiComponentVectorF
     // Increase for multi-valued shape functions.
     int inc = (fv->get_num_components() == 2) ? 1 : 0;
 
-    // Order of solutions from the previous Newton iteration.
-    Func<Ord>** oi = new Func<Ord>*[u_ext_length - u_ext_offset];
-    if (u_ext != Hermes::vector<Solution *>())
-      for(int i = 0; i < u_ext_length - u_ext_offset; i++)
-        if (u_ext[i + u_ext_offset] != NULL)
-          oi[i] = get_fn_ord(u_ext[i]->get_edge_fn_order(surf_pos->surf_num) + inc);
-        else
+    // The order of the form is cached for the orders of the functions.
+    OrderKey key(vfs, ORDER_SURF);
+    key.add(u_ext_length - u_ext_offset);
+    for(int i = 0; i < u_ext_length - u_ext_offset; i++)
+      key.add(u_ext[i + u_ext_offset] != NULL ? u_ext[i]->get_edge_fn_order(surf_pos->surf_num) + inc : 0);
+    key.add(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
+    key.add_ext_fns(vfs->ext);
+
+    int form_order;
+    if (!find_order(key, form_order)) {
+      // Order of solutions from the previous Newton iteration.
+      Func<Ord>** oi = new Func<Ord>*[u_ext_length - u_ext_offset];
+      if (u_ext != Hermes::vector<Solution *>())
+        for(int i = 0; i < u_ext_length - u_ext_offset; i++)
+          if (u_ext[i + u_ext_offset] != NULL)
+            oi[i] = get_fn_ord(u_ext[i]->get_edge_fn_order(surf_pos->surf_num) + inc);
+          else
+            oi[i] = get_fn_ord(0);
+      else
+        for(int i = 0; i < u_ext_length - u_ext_offset; i++)
           oi[i] = get_fn_ord(0);
-    else
-      for(int i = 0; i < u_ext_length - u_ext_offset; i++)
-        oi[i] = get_fn_ord(0);
 
-    // Order of the shape function.
-    Func<Ord>* ov = get_fn_ord(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
+      // Order of the shape function.
+      Func<Ord>* ov = get_fn_ord(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
 
-    // Order of additional external functions.
-    ExtData<Ord>* fake_ext = init_ext_fns_ord(vfs->ext);
+      // Order of additional external functions.
+      ExtData<Ord>* fake_ext = init_ext_fns_ord(vfs->ext);
 
-    // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
-    double fake_wt = 1.0;
+      // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
+      double fake_wt = 1.0;
 
-    // Total order of the vector form.
-    Ord o = vfs->ord(1, &fake_wt, oi, ov, &geom_ord, fake_ext);
+      // Total order of the vector form.
+      Ord o = vfs->ord(1, &fake_wt, oi, ov, &geom_ord, fake_ext);
+
+      // Cleanup.
+      delete [] oi;
+
+      if (fake_ext != NULL) {
+        fake_ext->free_ord(); 
+        delete fake_ext;
+      }
+
+      form_order = o.get_order();
+      store_order(key, form_order);
+    }
 
     // Increase due to reference map.
     order = rv->get_inv_ref_order();
-    order += o.get_order();
+    order += form_order;
     limit_order(order);
-    
-    // Cleanup.
-    delete [] oi;
-
-    if (fake_ext != NULL) {
-      fake_ext->free_ord(); 
-      delete fake_ext;
-    }
   }
   return order;
 }
@@ -3683,13 +4996,7 @@ scalar DiscreteProblem::eval_form_subelement(int order, WeakForm::VectorFormSurf
   int np = quad->get_num_points(eo);
 
   // Init geometry and jacobian*weights.
-  if (cache_e[eo] == NULL) {
-    cache_e[eo] = init_geom_surf(rv, surf_pos, eo);
-    double3* tan = rv->get_tangent(surf_pos->surf_num, eo);
-    cache_jwt[eo] = new double[np];
-    for(int i = 0; i < np; i++)
-      cache_jwt[eo][i] = pt[i][2] * tan[i][2];
-  }
+  init_geom_cache_surf(rv, surf_pos, eo);
   Geom<double>* e = cache_e[eo];
   double* jwt = cache_jwt[eo];
 
@@ -3827,57 +5134,81 @@ int DiscreteProblem::calc_order_dg_matrix_form(WeakForm::MatrixFormSurf *mfs, He
   if(this->is_fvm)
     order = ru->get_inv_ref_order();
   else {
-    // Order of solutions from the previous Newton iteration.
+    // Increase for multi-valued shape functions.
+    int inc = (fv->get_num_components() == 2) ? 1 : 0;
+
+    // The order of the form is cached for the orders of the functions.
+    OrderKey key(mfs, ORDER_DG);
     int prev_size = u_ext.size() - mfs->u_ext_offset;
-    Func<Ord>** oi = new Func<Ord>*[prev_size];
-    if (u_ext != Hermes::vector<Solution *>())
-      for (int i = 0; i < prev_size; i++)
-        if (u_ext[i + mfs->u_ext_offset] != NULL) 
-          oi[i] = init_ext_fn_ord(neighbor_searches.get(u_ext[i]->get_mesh()->get_seq() - min_dg_mesh_seq), u_ext[i]);
-        else 
+    key.add(prev_size);
+    for (int i = 0; i < prev_size; i++)
+      if (u_ext[i + mfs->u_ext_offset] != NULL)
+        key.add_ext_fn(neighbor_searches.get(u_ext[i]->get_mesh()->get_seq() - min_dg_mesh_seq), u_ext[i]);
+      else
+        key.add(-1);
+    key.add(fu->get_edge_fn_order(surf_pos->surf_num) + inc);
+    key.add(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
+    key.add(neighbor_supp_u);
+    key.add(neighbor_supp_v);
+    key.add(mfs->ext.size());
+    for (unsigned int j = 0; j < mfs->ext.size(); j++)
+      key.add_ext_fn(neighbor_searches.get(mfs->ext[j]->get_mesh()->get_seq() - min_dg_mesh_seq), mfs->ext[j]);
+    key.add(nbs_u->neighb_el->marker);
+
+    int form_order;
+    if (!find_order(key, form_order)) {
+      // Order of solutions from the previous Newton iteration.
+      Func<Ord>** oi = new Func<Ord>*[prev_size];
+      if (u_ext != Hermes::vector<Solution *>())
+        for (int i = 0; i < prev_size; i++)
+          if (u_ext[i + mfs->u_ext_offset] != NULL) 
+            oi[i] = init_ext_fn_ord(neighbor_searches.get(u_ext[i]->get_mesh()->get_seq() - min_dg_mesh_seq), u_ext[i]);
+          else 
+            oi[i] = get_fn_ord(0);
+      else
+        for (int i = 0; i < prev_size; i++) 
           oi[i] = get_fn_ord(0);
-    else
-      for (int i = 0; i < prev_size; i++) 
-        oi[i] = get_fn_ord(0);
-    
-    // Order of shape functions.
-    int inc = (fv->get_num_components() == 2) ? 1 : 0;
-    DiscontinuousFunc<Ord>* ou = new DiscontinuousFunc<Ord>(get_fn_ord(fu->get_edge_fn_order(surf_pos->surf_num) + inc), neighbor_supp_u);
-    DiscontinuousFunc<Ord>* ov = new DiscontinuousFunc<Ord>(get_fn_ord(fv->get_edge_fn_order(surf_pos->surf_num) + inc), neighbor_supp_v);
+      
+      // Order of shape functions.
+      DiscontinuousFunc<Ord>* ou = new DiscontinuousFunc<Ord>(get_fn_ord(fu->get_edge_fn_order(surf_pos->surf_num) + inc), neighbor_supp_u);
+      DiscontinuousFunc<Ord>* ov = new DiscontinuousFunc<Ord>(get_fn_ord(fv->get_edge_fn_order(surf_pos->surf_num) + inc), neighbor_supp_v);
 
-    // Order of additional external functions.
-    ExtData<Ord>* fake_ext = init_ext_fns_ord(mfs->ext, neighbor_searches);
+      // Order of additional external functions.
+      ExtData<Ord>* fake_ext = init_ext_fns_ord(mfs->ext, neighbor_searches);
 
-    // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
-    Geom<Ord>* fake_e = new InterfaceGeom<Ord>(&geom_ord, nbs_u->neighb_el->marker, 
-      nbs_u->neighb_el->id, nbs_u->neighb_el->get_diameter());
-    double fake_wt = 1.0;
-    
-    // Total order of the matrix form.
-    Ord o = mfs->ord(1, &fake_wt, oi, ou, ov, fake_e, fake_ext);
+      // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
+      Geom<Ord>* fake_e = new InterfaceGeom<Ord>(&geom_ord, nbs_u->neighb_el->marker, 
+        nbs_u->neighb_el->id, nbs_u->neighb_el->get_diameter());
+      double fake_wt = 1.0;
+      
+      // Total order of the matrix form.
+      Ord o = mfs->ord(1, &fake_wt, oi, ou, ov, fake_e, fake_ext);
+
+      // Clean up.
+      if (u_ext != Hermes::vector<Solution *>())
+        for (int i = 0; i < prev_size; i++)
+          if (u_ext[i + mfs->u_ext_offset] != NULL) 
+            delete oi[i];
+      delete [] oi;
+      delete fake_e;
+      delete ou;
+      delete ov;
+      if (fake_ext != NULL) {
+        for (int i = 0; i < fake_ext->nf; i++) {
+          delete fake_ext->fn[i];
+        }
+        fake_ext->free_ord(); 
+        delete fake_ext;
+      }
+
+      form_order = o.get_order();
+      store_order(key, form_order);
+    }
 
     // Increase due to reference maps.
     order = ru->get_inv_ref_order();
-
-    order += o.get_order();
+    order += form_order;
     limit_order(order);
-
-    // Clean up.
-    if (u_ext != Hermes::vector<Solution *>())
-      for (int i = 0; i < prev_size; i++)
-        if (u_ext[i + mfs->u_ext_offset] != NULL) 
-          delete oi[i];
-    delete [] oi;
-    delete fake_e;
-    delete ou;
-    delete ov;
-    if (fake_ext != NULL) {
-      for (int i = 0; i < fake_ext->nf; i++) {
-        delete fake_ext->fn[i];
-      }
-      fake_ext->free_ord(); 
-      delete fake_ext;
-    }
   }
   return order;
 }
@@ -3892,57 +5223,81 @@ int DiscreteProblem::calc_order_dg_matrix_form(WeakForm::MultiComponentMatrixFor
   if(this->is_fvm)
     order = ru->get_inv_ref_order();
   else {
-    // Order of solutions from the previous Newton iteration.
+    // Increase for multi-valued shape functions.
+    int inc = (fv->get_num_components() == 2) ? 1 : 0;
+
+    // The order of the form is cached for the orders of the functions.
+    OrderKey key(mfs, ORDER_DG);
     int prev_size = u_ext.size() - mfs->u_ext_offset;
-    Func<Ord>** oi = new Func<Ord>*[prev_size];
-    if (u_ext != Hermes::vector<Solution *>())
-      for (int i = 0; i < prev_size; i++)
-        if (u_ext[i + mfs->u_ext_offset] != NULL) 
-          oi[i] = init_ext_fn_ord(neighbor_searches.get(u_ext[i]->get_mesh()->get_seq() - min_dg_mesh_seq), u_ext[i]);
-        else 
+    key.add(prev_size);
+    for (int i = 0; i < prev_size; i++)
+      if (u_ext[i + mfs->u_ext_offset] != NULL)
+        key.add_ext_fn(neighbor_searches.get(u_ext[i]->get_mesh()->get_seq() - min_dg_mesh_seq), u_ext[i]);
+      else
+        key.add(-1);
+    key.add(fu->get_edge_fn_order(surf_pos->surf_num) + inc);
+    key.add(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
+    key.add(neighbor_supp_u);
+    key.add(neighbor_supp_v);
+    key.add(mfs->ext.size());
+    for (unsigned int j = 0; j < mfs->ext.size(); j++)
+      key.add_ext_fn(neighbor_searches.get(mfs->ext[j]->get_mesh()->get_seq() - min_dg_mesh_seq), mfs->ext[j]);
+    key.add(nbs_u->neighb_el->marker);
+
+    int form_order;
+    if (!find_order(key, form_order)) {
+      // Order of solutions from the previous Newton iteration.
+      Func<Ord>** oi = new Func<Ord>*[prev_size];
+      if (u_ext != Hermes::vector<Solution *>())
+        for (int i = 0; i < prev_size; i++)
+          if (u_ext[i + mfs->u_ext_offset] != NULL) 
+            oi[i] = init_ext_fn_ord(neighbor_searches.get(u_ext[i]->get_mesh()->get_seq() - min_dg_mesh_seq), u_ext[i]);
+          else 
+            oi[i] = get_fn_ord(0);
+      else
+        for (int i = 0; i < prev_size; i++) 
           oi[i] = get_fn_ord(0);
-    else
-      for (int i = 0; i < prev_size; i++) 
-        oi[i] = get_fn_ord(0);
-    
-    // Order of shape functions.
-    int inc = (fv->get_num_components() == 2) ? 1 : 0;
-    DiscontinuousFunc<Ord>* ou = new DiscontinuousFunc<Ord>(get_fn_ord(fu->get_edge_fn_order(surf_pos->surf_num) + inc), neighbor_supp_u);
-    DiscontinuousFunc<Ord>* ov = new DiscontinuousFunc<Ord>(get_fn_ord(fv->get_edge_fn_order(surf_pos->surf_num) + inc), neighbor_supp_v);
+      
+      // Order of shape functions.
+      DiscontinuousFunc<Ord>* ou = new DiscontinuousFunc<Ord>(get_fn_ord(fu->get_edge_fn_order(surf_pos->surf_num) + inc), neighbor_supp_u);
+      DiscontinuousFunc<Ord>* ov = new DiscontinuousFunc<Ord>(get_fn_ord(fv->get_edge_fn_order(surf_pos->surf_num) + inc), neighbor_supp_v);
 
-    // Order of additional external functions.
-    ExtData<Ord>* fake_ext = init_ext_fns_ord(mfs->ext, neighbor_searches);
+      // Order of additional external functions.
+      ExtData<Ord>* fake_ext = init_ext_fns_ord(mfs->ext, neighbor_searches);
 
-    // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
-    Geom<Ord>* fake_e = new InterfaceGeom<Ord>(&geom_ord, nbs_u->neighb_el->marker, 
-      nbs_u->neighb_el->id, nbs_u->neighb_el->get_diameter());
-    double fake_wt = 1.0;
-    
-    // Total order of the matrix form.
-    Ord o = mfs->ord(1, &fake_wt, oi, ou, ov, fake_e, fake_ext);
+      // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
+      Geom<Ord>* fake_e = new InterfaceGeom<Ord>(&geom_ord, nbs_u->neighb_el->marker, 
+        nbs_u->neighb_el->id, nbs_u->neighb_el->get_diameter());
+      double fake_wt = 1.0;
+      
+      // Total order of the matrix form.
+      Ord o = mfs->ord(1, &fake_wt, oi, ou, ov, fake_e, fake_ext);
+
+      // Clean up.
+      if (u_ext != Hermes::vector<Solution *>())
+        for (int i = 0; i < prev_size; i++)
+          if (u_ext[i + mfs->u_ext_offset] != NULL) 
+            delete oi[i];
+      delete [] oi;
+      delete fake_e;
+      delete ou;
+      delete ov;
+      if (fake_ext != NULL) {
+        for (int i = 0; i < fake_ext->nf; i++) {
+          delete fake_ext->fn[i];
+        }
+        fake_ext->free_ord(); 
+        delete fake_ext;
+      }
+
+      form_order = o.get_order();
+      store_order(key, form_order);
+    }
 
     // Increase due to reference maps.
     order = ru->get_inv_ref_order();
-
-    order += o.get_order();
+    order += form_order;
     limit_order(order);
-
-    // Clean up.
-    if (u_ext != Hermes::vector<Solution *>())
-      for (int i = 0; i < prev_size; i++)
-        if (u_ext[i + mfs->u_ext_offset] != NULL) 
-          delete oi[i];
-    delete [] oi;
-    delete fake_e;
-    delete ou;
-    delete ov;
-    if (fake_ext != NULL) {
-      for (int i = 0; i < fake_ext->nf; i++) {
-        delete fake_ext->fn[i];
-      }
-      fake_ext->free_ord(); 
-      delete fake_ext;
-    }
   }
   return order;
 }
@@ -4133,55 +5488,77 @@ int DiscreteProblem::calc_order_dg_vector_form(WeakForm::VectorFormSurf *vfs, He
   if(this->is_fvm)
     order = rv->get_inv_ref_order();
   else {
-    // Order of solutions from the previous Newton iteration.
+    // Increase for multi-valued shape functions.
+    int inc = (fv->get_num_components() == 2) ? 1 : 0;
+
+    // The order of the form is cached for the orders of the functions.
+    OrderKey key(vfs, ORDER_DG);
     int prev_size = u_ext.size() - vfs->u_ext_offset;
-    Func<Ord>** oi = new Func<Ord>*[prev_size];
-    if (u_ext != Hermes::vector<Solution *>())
-      for (int i = 0; i < prev_size; i++)
-        if (u_ext[i + vfs->u_ext_offset] != NULL) 
-          oi[i] = init_ext_fn_ord(neighbor_searches.get(u_ext[i]->get_mesh()->get_seq() - min_dg_mesh_seq), u_ext[i]);
-        else 
+    key.add(prev_size);
+    for (int i = 0; i < prev_size; i++)
+      if (u_ext[i + vfs->u_ext_offset] != NULL)
+        key.add_ext_fn(neighbor_searches.get(u_ext[i]->get_mesh()->get_seq() - min_dg_mesh_seq), u_ext[i]);
+      else
+        key.add(-1);
+    key.add(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
+    key.add(vfs->ext.size());
+    for (unsigned int j = 0; j < vfs->ext.size(); j++)
+      key.add_ext_fn(neighbor_searches.get(vfs->ext[j]->get_mesh()->get_seq() - min_dg_mesh_seq), vfs->ext[j]);
+    key.add(nbs_v->neighb_el->marker);
+
+    int form_order;
+    if (!find_order(key, form_order)) {
+      // Order of solutions from the previous Newton iteration.
+      Func<Ord>** oi = new Func<Ord>*[prev_size];
+      if (u_ext != Hermes::vector<Solution *>())
+        for (int i = 0; i < prev_size; i++)
+          if (u_ext[i + vfs->u_ext_offset] != NULL) 
+            oi[i] = init_ext_fn_ord(neighbor_searches.get(u_ext[i]->get_mesh()->get_seq() - min_dg_mesh_seq), u_ext[i]);
+          else 
+            oi[i] = get_fn_ord(0);
+      else
+        for (int i = 0; i < prev_size; i++) 
           oi[i] = get_fn_ord(0);
-    else
-      for (int i = 0; i < prev_size; i++) 
-        oi[i] = get_fn_ord(0);
 
-    // Order of the shape function.
-    // Determine the integration order.
-    int inc = (fv->get_num_components() == 2) ? 1 : 0;
-    Func<Ord>* ov = get_fn_ord(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
-
-    // Order of additional external functions.
-    ExtData<Ord>* fake_ext = init_ext_fns_ord(vfs->ext, neighbor_searches);
+      // Order of the shape function.
+      // Determine the integration order.
+      Func<Ord>* ov = get_fn_ord(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
+
+      // Order of additional external functions.
+      ExtData<Ord>* fake_ext = init_ext_fns_ord(vfs->ext, neighbor_searches);
+
+      // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
+      Geom<Ord>* fake_e = new InterfaceGeom<Ord>(&geom_ord,
+                          nbs_v->neighb_el->marker, nbs_v->neighb_el->id, nbs_v->neighb_el->get_diameter());
+      double fake_wt = 1.0;
+
+      // Total order of the vector form.
+      Ord o = vfs->ord(1, &fake_wt, oi, ov, fake_e, fake_ext);
+
+      // Clean up.
+      if (u_ext != Hermes::vector<Solution *>())
+        for (int i = 0; i < prev_size; i++)
+          if (u_ext[i + vfs->u_ext_offset] != NULL) 
+            delete oi[i];
+      delete [] oi;
+      if (fake_ext != NULL) {
+        for (int i = 0; i < fake_ext->nf; i++) {
+          delete fake_ext->fn[i];
+        }
+        fake_ext->free_ord(); 
+        delete fake_ext;
+      }
 
-    // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
-    Geom<Ord>* fake_e = new InterfaceGeom<Ord>(&geom_ord,
-                        nbs_v->neighb_el->marker, nbs_v->neighb_el->id, nbs_v->neighb_el->get_diameter());
-    double fake_wt = 1.0;
+      delete fake_e;
 
-    // Total order of the vector form.
-    Ord o = vfs->ord(1, &fake_wt, oi, ov, fake_e, fake_ext);
+      form_order = o.get_order();
+      store_order(key, form_order);
+    }
 
     // Increase due to reference map.
     order = rv->get_inv_ref_order();
-    order += o.get_order();
+    order += form_order;
     limit_order(order);
-
-    // Clean up.
-    if (u_ext != Hermes::vector<Solution *>())
-      for (int i = 0; i < prev_size; i++)
-        if (u_ext[i + vfs->u_ext_offset] != NULL) 
-          delete oi[i];
-    delete [] oi;
-    if (fake_ext != NULL) {
-      for (int i = 0; i < fake_ext->nf; i++) {
-        delete fake_ext->fn[i];
-      }
-      fake_ext->free_ord(); 
-      delete fake_ext;
-    }
-
-    delete fake_e;
   }
   return order;
 }
@@ -4198,55 +5575,77 @@ int DiscreteProblem::calc_order_dg_vector_form(WeakForm::MultiComponentVectorFor
   if(this->is_fvm)
     order = rv->get_inv_ref_order();
   else {
-    // Order of solutions from the previous Newton iteration.
+    // Increase for multi-valued shape functions.
+    int inc = (fv->get_num_components() == 2) ? 1 : 0;
+
+    // The order of the form is cached for the orders of the functions.
+    OrderKey key(vfs, ORDER_DG);
     int prev_size = u_ext.size() - vfs->u_ext_offset;
-    Func<Ord>** oi = new Func<Ord>*[prev_size];
-    if (u_ext != Hermes::vector<Solution *>())
-      for (int i = 0; i < prev_size; i++)
-        if (u_ext[i + vfs->u_ext_offset] != NULL) 
-          oi[i] = init_ext_fn_ord(neighbor_searches.get(u_ext[i]->get_mesh()->get_seq() - min_dg_mesh_seq), u_ext[i]);
-        else 
+    key.add(prev_size);
+    for (int i = 0; i < prev_size; i++)
+      if (u_ext[i + vfs->u_ext_offset] != NULL)
+        key.add_ext_fn(neighbor_searches.get(u_ext[i]->get_mesh()->get_seq() - min_dg_mesh_seq), u_ext[i]);
+      else
+        key.add(-1);
+    key.add(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
+    key.add(vfs->ext.size());
+    for (unsigned int j = 0; j < vfs->ext.size(); j++)
+      key.add_ext_fn(neighbor_searches.get(vfs->ext[j]->get_mesh()->get_seq() - min_dg_mesh_seq), vfs->ext[j]);
+    key.add(nbs_v->neighb_el->marker);
+
+    int form_order;
+    if (!find_order(key, form_order)) {
+      // Order of solutions from the previous Newton iteration.
+      Func<Ord>** oi = new Func<Ord>*[prev_size];
+      if (u_ext != Hermes::vector<Solution *>())
+        for (int i = 0; i < prev_size; i++)
+          if (u_ext[i + vfs->u_ext_offset] != NULL) 
+            oi[i] = init_ext_fn_ord(neighbor_searches.get(u_ext[i]->get_mesh()->get_seq() - min_dg_mesh_seq), u_ext[i]);
+          else 
+            oi[i] = get_fn_ord(0);
+      else
+        for (int i = 0; i < prev_size; i++) 
           oi[i] = get_fn_ord(0);
-    else
-      for (int i = 0; i < prev_size; i++) 
-        oi[i] = get_fn_ord(0);
-
-    // Order of the shape function.
-    // Determine the integration order.
-    int inc = (fv->get_num_components() == 2) ? 1 : 0;
-    Func<Ord>* ov = get_fn_ord(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
 
-    // Order of additional external functions.
-    ExtData<Ord>* fake_ext = init_ext_fns_ord(vfs->ext, neighbor_searches);
+      // Order of the shape function.
+      // Determine the integration order.
+      Func<Ord>* ov = get_fn_ord(fv->get_edge_fn_order(surf_pos->surf_num) + inc);
+
+      // Order of additional external functions.
+      ExtData<Ord>* fake_ext = init_ext_fns_ord(vfs->ext, neighbor_searches);
+
+      // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
+      Geom<Ord>* fake_e = new InterfaceGeom<Ord>(&geom_ord,
+                          nbs_v->neighb_el->marker, nbs_v->neighb_el->id, nbs_v->neighb_el->get_diameter());
+      double fake_wt = 1.0;
+
+      // Total order of the vector form.
+      Ord o = vfs->ord(1, &fake_wt, oi, ov, fake_e, fake_ext);
+
+      // Clean up.
+      if (u_ext != Hermes::vector<Solution *>())
+        for (int i = 0; i < prev_size; i++)
+          if (u_ext[i + vfs->u_ext_offset] != NULL) 
+            delete oi[i];
+      delete [] oi;
+      if (fake_ext != NULL) {
+        for (int i = 0; i < fake_ext->nf; i++) {
+          delete fake_ext->fn[i];
+        }
+        fake_ext->free_ord(); 
+        delete fake_ext;
+      }
 
-    // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
-    Geom<Ord>* fake_e = new InterfaceGeom<Ord>(&geom_ord,
-                        nbs_v->neighb_el->marker, nbs_v->neighb_el->id, nbs_v->neighb_el->get_diameter());
-    double fake_wt = 1.0;
+      delete fake_e;
 
-    // Total order of the vector form.
-    Ord o = vfs->ord(1, &fake_wt, oi, ov, fake_e, fake_ext);
+      form_order = o.get_order();
+      store_order(key, form_order);
+    }
 
     // Increase due to reference map.
     order = rv->get_inv_ref_order();
-    order += o.get_order();
+    order += form_order;
     limit_order(order);
-
-    // Clean up.
-    if (u_ext != Hermes::vector<Solution *>())
-      for (int i = 0; i < prev_size; i++)
-        if (u_ext[i + vfs->u_ext_offset] != NULL) 
-          delete oi[i];
-    delete [] oi;
-    if (fake_ext != NULL) {
-      for (int i = 0; i < fake_ext->nf; i++) {
-        delete fake_ext->fn[i];
-      }
-      fake_ext->free_ord(); 
-      delete fake_ext;
-    }
-
-    delete fake_e;
   }
   return order;
 }
@@ -4269,13 +5668,7 @@ scalar DiscreteProblem::eval_dg_form(WeakForm::VectorFormSurf* vfs, Hermes::vect
   assert(surf_pos->surf_num == nbs_v->active_edge);
 
   // Init geometry and jacobian*weights.
-  if (cache_e[eo] == NULL) {
-    cache_e[eo] = init_geom_surf(rv, surf_pos, eo);
-    double3* tan = rv->get_tangent(surf_pos->surf_num, eo);
-    cache_jwt[eo] = new double[np];
-    for(int i = 0; i < np; i++)
-      cache_jwt[eo][i] = pt[i][2] * tan[i][2];
-  }
+  init_geom_cache_surf(rv, surf_pos, eo);
 
   Geom<double>* e = new InterfaceGeom<double>(cache_e[eo], nbs_v->neighb_el->marker, 
     nbs_v->neighb_el->id, nbs_v->neighb_el->get_diameter());
@@ -4342,13 +5735,7 @@ void DiscreteProblem::eval_dg_form(WeakForm::MultiComponentVectorFormSurf* vfs,
   assert(surf_pos->surf_num == nbs_v->active_edge);
 
   // Init geometry and jacobian*weights.
-  if (cache_e[eo] == NULL) {
-    cache_e[eo] = init_geom_surf(rv, surf_pos, eo);
-    double3* tan = rv->get_tangent(surf_pos->surf_num, eo);
-    cache_jwt[eo] = new double[np];
-    for(int i = 0; i < np; i++)
-      cache_jwt[eo][i] = pt[i][2] * tan[i][2];
-  }
+  init_geom_cache_surf(rv, surf_pos, eo);
 
   Geom<double>* e = new InterfaceGeom<double>(cache_e[eo], nbs_v->neighb_el->marker, 
     nbs_v->neighb_el->id, nbs_v->neighb_el->get_diameter());
@@ -4437,33 +5824,52 @@ unsigned int DiscreteProblem::NeighborNode::get_transformation()
 
 DiscreteProblem::AssemblingCaches::AssemblingCaches()
 {
-
+  const_cache_fn.set_memory_limit(256 << 20);
+  use_geom_cache = false;
+  geom_cache.set_memory_limit(64 << 20);
+  use_sum_fact = false;
+  order_hits = order_misses = 0;
+  wf_seq = -1;
+  batch_matrix = NULL;
+  batch_matrix_dim = 0;
 };
 
 DiscreteProblem::AssemblingCaches::~AssemblingCaches()
 {
   _F_
-  for (std::map<KeyConst, Func<double>*, CompareConst>::const_iterator it = const_cache_fn_triangles.begin();
-       it != const_cache_fn_triangles.end(); it++)
-  {
-    (it->second)->free_fn(); delete (it->second);
-  }
-  const_cache_fn_triangles.clear();
-
-  for (std::map<KeyConst, Func<double>*, CompareConst>::const_iterator it = const_cache_fn_quads.begin();
-       it != const_cache_fn_quads.end(); it++)
-  {
-    (it->second)->free_fn(); delete (it->second);
-  }
-  const_cache_fn_quads.clear();
-
   for(unsigned int i = 0; i < cache_fn_ord.get_size(); i++)
     if(cache_fn_ord.present(i)) {
       cache_fn_ord.get(i)->free_ord(); 
       delete cache_fn_ord.get(i);
     }
+  delete [] batch_matrix;
 };
 
+void DiscreteProblem::AssemblingCaches::update(Hermes::vector<Space *>& spaces, WeakForm* wf)
+{
+  _F_
+  if (wf->get_seq() != wf_seq) {
+    cache_order.clear();
+    wf_seq = wf->get_seq();
+  }
+
+  bool changed = (sp_seq.size() != spaces.size()), mesh_changed = changed;
+  for (unsigned int i = 0; i < spaces.size() && !mesh_changed; i++) {
+    if (spaces[i]->get_seq() != sp_seq[i]) changed = true;
+    if (spaces[i]->get_mesh()->get_seq() != mesh_seq[i]) changed = mesh_changed = true;
+  }
+  if (!changed) return;
+
+  const_cache_fn.clear();
+  if (mesh_changed) geom_cache.clear();
+  sp_seq.resize(spaces.size());
+  mesh_seq.resize(spaces.size());
+  for (unsigned int i = 0; i < spaces.size(); i++) {
+    sp_seq[i] = spaces[i]->get_seq();
+    mesh_seq[i] = spaces[i]->get_mesh()->get_seq();
+  }
+}
+
 double Hermes2D::get_l2_norm(Vector* vec) const 
 {
   _F_
@@ -4475,11 +5881,41 @@ double Hermes2D::get_l2_norm(Vector* vec) const
   return sqrt(std::abs(val));
 }
 
+NewtonSettings::NewtonSettings()
+  : jacobian_refresh(1), max_residual_ratio(0.5), inexact(false),
+    eta_initial(0.5), eta_max(0.9), ew_gamma(0.9), ew_alpha(0.5 * (1 + sqrt(5.0)))
+{
+}
+
+void NewtonStatistics::clear()
+{
+  residual_norms.clear();
+  residual_times.clear();
+  jacobian_times.clear();
+  solve_times.clear();
+  forcing_terms.clear();
+  linear_iters.clear();
+  num_jacobians = 0;
+}
+
 bool Hermes2D::solve_newton(scalar* coeff_vec, DiscreteProblem* dp, Solver* solver, SparseMatrix* matrix,
                             Vector* rhs, double newton_tol, int newton_max_iter, bool verbose,
                             bool residual_as_function,
-                            double damping_coeff, double max_allowed_residual_norm) const
+                            double damping_coeff, double max_allowed_residual_norm,
+                            const NewtonSettings* settings, NewtonStatistics* stats) const
 {
+  NewtonSettings default_settings;
+  if (settings == NULL) settings = &default_settings;
+  if (stats != NULL) stats->clear();
+
+  // The tolerance of an iterative solver is adapted in the inexact Newton's method, the
+  // tolerance of the caller is restored on return.
+  IterSolver* iter_solver = settings->inexact ? dynamic_cast<IterSolver*>(solver) : NULL;
+  double iter_tolerance = (iter_solver != NULL) ? iter_solver->get_tolerance() : 0.0;
+  if (settings->inexact && iter_solver == NULL && verbose)
+    info("The matrix solver is not iterative, the linear systems will be solved exactly.");
+  bool reuse_jacobian = (settings->jacobian_refresh != 1);
+
   // Prepare solutions for measuring residual norm.
   int num_spaces = dp->get_spaces().size();
   Hermes::vector<Solution*> solutions;
@@ -4490,7 +5926,11 @@ bool Hermes2D::solve_newton(scalar* coeff_vec, DiscreteProblem* dp, Solver* solv
   }
 
   // The Newton's loop.
-  double residual_norm;
+  double residual_norm, last_residual_norm = 0;
+  double eta = settings->eta_initial;
+  bool have_jacobian = false;
+  int jacobian_age = 0;                   // Number of iterations that reused the last assembled Jacobian.
+  TimePeriod timer;
   int it = 1;
   while (1)
   {
@@ -4498,7 +5938,16 @@ bool Hermes2D::solve_newton(scalar* coeff_vec, DiscreteProblem* dp, Solver* solv
     int ndof = dp->get_num_dofs();
 
     // Assemble the residual vector.
+    timer.tick(HERMES_SKIP);
     dp->assemble(coeff_vec, NULL, rhs); // NULL = we do not want the Jacobian.
+    timer.tick();
+    if (stats != NULL) {
+      stats->residual_times.push_back(timer.last());
+      stats->jacobian_times.push_back(0.0);
+      stats->solve_times.push_back(0.0);
+      stats->forcing_terms.push_back(0.0);
+      stats->linear_iters.push_back(0);
+    }
 
     // Measure the residual norm.
     if (residual_as_function) {
@@ -4515,6 +5964,7 @@ bool Hermes2D::solve_newton(scalar* coeff_vec, DiscreteProblem* dp, Solver* solv
       // Calculate the l2-norm of residual vector, this is the traditional way.
       residual_norm = get_l2_norm(rhs);
     }
+    if (stats != NULL) stats->residual_norms.push_back(residual_norm);
 
     // Info for the user.
     if (it == 1) {
@@ -4531,6 +5981,8 @@ bool Hermes2D::solve_newton(scalar* coeff_vec, DiscreteProblem* dp, Solver* solv
       }
       for (unsigned int i = 0; i < solutions.size(); i++)
         delete solutions[i];
+      if (reuse_jacobian) solver->set_factorization_scheme(HERMES_FACTORIZE_FROM_SCRATCH);
+      if (iter_solver != NULL) iter_solver->set_tolerance(iter_tolerance);
       return false;
     }
 
@@ -4538,15 +5990,61 @@ bool Hermes2D::solve_newton(scalar* coeff_vec, DiscreteProblem* dp, Solver* solv
     // of iteration has been reached, then quit.
     if ((residual_norm < newton_tol || it > newton_max_iter) && it > 1) break;
 
+    // Decide whether the Jacobian is assembled in this iteration: always in the Newton's
+    // method, periodically in the Shamanskii method, and whenever the convergence of
+    // the last iteration with the reused Jacobian is too slow.
+    bool assemble_jacobian = !have_jacobian || settings->jacobian_refresh == 1
+                             || (settings->jacobian_refresh > 1 && jacobian_age >= settings->jacobian_refresh - 1)
+                             || (jacobian_age > 0 && residual_norm > settings->max_residual_ratio * last_residual_norm);
+
+    // The forcing term of the inexact Newton's method (Eisenstat-Walker, choice 2).
+    if (iter_solver != NULL) {
+      if (it > 1) {
+        double eta_new = settings->ew_gamma * pow(residual_norm / last_residual_norm, settings->ew_alpha);
+        double eta_safe = settings->ew_gamma * pow(eta, settings->ew_alpha);
+        if (eta_safe > 0.1) eta_new = std::max(eta_new, eta_safe);
+        eta = std::min(eta_new, settings->eta_max);
+      }
+      iter_solver->set_tolerance(eta);
+    }
+    last_residual_norm = residual_norm;
+
     // Assemble the Jacobian matrix.
-    dp->assemble(coeff_vec, matrix, NULL); // NULL = we do not want the rhs.
+    if (assemble_jacobian) {
+      timer.tick(HERMES_SKIP);
+      dp->assemble(coeff_vec, matrix, NULL); // NULL = we do not want the rhs.
+      timer.tick();
+      have_jacobian = true;
+      jacobian_age = 0;
+      if (stats != NULL) {
+        stats->jacobian_times.back() = timer.last();
+        stats->num_jacobians++;
+      }
+      // A new matrix has to be factorized.
+      if (reuse_jacobian) solver->set_factorization_scheme(HERMES_FACTORIZE_FROM_SCRATCH);
+    }
+    else {
+      // The matrix has not changed, its factorization (or preconditioner) is kept.
+      solver->set_factorization_scheme(HERMES_REUSE_FACTORIZATION_COMPLETELY);
+      jacobian_age++;
+      if (verbose) info("---- Newton iter %d reuses the Jacobian.", it);
+    }
 
     // Multiply the residual vector with -1 since the matrix
     // equation reads J(Y^n) \deltaY^{n+1} = -F(Y^n).
     rhs->change_sign();
 
     // Solve the linear system.
+    timer.tick(HERMES_SKIP);
     if(!solver->solve()) error ("Matrix solver failed.\n");
+    timer.tick();
+    if (stats != NULL) {
+      stats->solve_times.back() = timer.last();
+      if (iter_solver != NULL) {
+        stats->forcing_terms.back() = eta;
+        stats->linear_iters.back() = iter_solver->get_num_iters();
+      }
+    }
 
     // Add \deltaY^{n+1} to Y^n.
     for (int i = 0; i < ndof; i++) coeff_vec[i] += damping_coeff * solver->get_solution()[i];
@@ -4571,6 +6069,8 @@ bool Hermes2D::solve_newton(scalar* coeff_vec, DiscreteProblem* dp, Solver* solv
 
   for (unsigned int i = 0; i < solutions.size(); i++)
     delete solutions[i];
+  if (reuse_jacobian) solver->set_factorization_scheme(HERMES_FACTORIZE_FROM_SCRATCH);
+  if (iter_solver != NULL) iter_solver->set_tolerance(iter_tolerance);
 
   if (it >= newton_max_iter) {
     if (verbose) info("Maximum allowed number of Newton iterations exceeded, returning false.");
@@ -4580,6 +6080,177 @@ bool Hermes2D::solve_newton(scalar* coeff_vec, DiscreteProblem* dp, Solver* solv
   return true;
 }
 
+// The Jacobian of the residual of dp at the iterate u as a LinearOperator: J v is approximated
+// by the difference of residuals (F(u + eps v) - F(u)) / eps.
+class JacobianFreeOperator : public LinearOperator
+{
+public:
+  JacobianFreeOperator(DiscreteProblem* dp, scalar* u, scalar* f, double fd_epsilon)
+    : dp(dp), u(u), f(f), fd_epsilon(fd_epsilon), num_residuals(0)
+  {
+    ndof = dp->get_num_dofs();
+    u_pert = new scalar[ndof];
+    MEM_CHECK(u_pert);
+    f_pert.alloc(ndof);
+    u_norm = 0;
+    for (int i = 0; i < ndof; i++) u_norm += std::abs(u[i]) * std::abs(u[i]);
+    u_norm = sqrt(u_norm);
+  }
+  virtual ~JacobianFreeOperator() { delete [] u_pert; }
+
+  virtual int get_size() { return ndof; }
+
+  virtual void multiply_with_vector(scalar* v, scalar* y)
+  {
+    double v_norm = 0;
+    for (int i = 0; i < ndof; i++) v_norm += std::abs(v[i]) * std::abs(v[i]);
+    v_norm = sqrt(v_norm);
+    if (v_norm == 0) { memset(y, 0, ndof * sizeof(scalar)); return; }
+
+    double eps = (fd_epsilon > 0 ? fd_epsilon : sqrt((1 + u_norm) * DBL_EPSILON)) / v_norm;
+    for (int i = 0; i < ndof; i++) u_pert[i] = u[i] + eps * v[i];
+    dp->assemble(u_pert, NULL, &f_pert);
+    num_residuals++;
+    for (int i = 0; i < ndof; i++) y[i] = (f_pert.get(i) - f[i]) / eps;
+  }
+
+  int get_num_residuals() const { return num_residuals; }
+
+protected:
+  DiscreteProblem* dp;
+  int ndof;
+  scalar* u;
+  scalar* f;
+  scalar* u_pert;
+  CSRVector f_pert;
+  double u_norm, fd_epsilon;
+  int num_residuals;
+};
+
+bool Hermes2D::solve_jfnk(scalar* coeff_vec, DiscreteProblem* dp, double newton_tol,
+                          int newton_max_iter, bool verbose,
+                          NativePrecond* precond, DiscreteProblem* dp_precond,
+                          const NewtonSettings* settings, NewtonStatistics* stats,
+                          int gmres_restart, int gmres_max_iters, double fd_epsilon) const
+{
+  NewtonSettings default_settings;
+  if (settings == NULL) settings = &default_settings;
+  if (stats != NULL) stats->clear();
+  if (dp_precond == NULL) dp_precond = dp;
+
+  int ndof = dp->get_num_dofs();
+  if (dp_precond->get_num_dofs() != ndof)
+    error("The preconditioner problem has %d DOFs instead of %d in solve_jfnk().",
+          dp_precond->get_num_dofs(), ndof);
+  CSRVector rhs;
+  rhs.alloc(ndof);
+  CSRMatrix* jacobian = NULL;
+  if (precond != NULL) {
+    jacobian = new CSRMatrix;
+    MEM_CHECK(jacobian);
+  }
+  scalar* f = new scalar[ndof];
+  scalar* b = new scalar[ndof];
+  scalar* step = new scalar[ndof];
+  MEM_CHECK(f);
+  MEM_CHECK(b);
+  MEM_CHECK(step);
+
+  // The Newton's loop.
+  double residual_norm, last_residual_norm = 0;
+  double eta = settings->eta_initial;
+  bool have_precond = false;
+  int precond_age = 0;
+  TimePeriod timer;
+  int it = 1;
+  while (1)
+  {
+    // Assemble the residual vector.
+    timer.tick(HERMES_SKIP);
+    dp->assemble(coeff_vec, NULL, &rhs);
+    timer.tick();
+    rhs.extract(f);
+    residual_norm = get_l2_norm(&rhs);
+    if (stats != NULL) {
+      stats->residual_norms.push_back(residual_norm);
+      stats->residual_times.push_back(timer.last());
+      stats->jacobian_times.push_back(0.0);
+      stats->solve_times.push_back(0.0);
+      stats->forcing_terms.push_back(0.0);
+      stats->linear_iters.push_back(0);
+    }
+
+    if (it == 1) {
+      if (verbose) info("---- JFNK initial residual norm: %g", residual_norm);
+    }
+    else if (verbose) info("---- JFNK iter %d, residual norm: %g", it-1, residual_norm);
+
+    if ((residual_norm < newton_tol || it > newton_max_iter) && it > 1) break;
+
+    // The forcing term (Eisenstat-Walker, choice 2).
+    if (it > 1) {
+      double eta_new = settings->ew_gamma * pow(residual_norm / last_residual_norm, settings->ew_alpha);
+      double eta_safe = settings->ew_gamma * pow(eta, settings->ew_alpha);
+      if (eta_safe > 0.1) eta_new = std::max(eta_new, eta_safe);
+      eta = std::min(eta_new, settings->eta_max);
+    }
+    last_residual_norm = residual_norm;
+
+    // Assemble the Jacobian for the preconditioner.
+    if (precond != NULL && (!have_precond || settings->jacobian_refresh == 1
+                            || (settings->jacobian_refresh > 1 && precond_age >= settings->jacobian_refresh))) {
+      timer.tick(HERMES_SKIP);
+      dp_precond->assemble(coeff_vec, jacobian, NULL);
+      precond->create(jacobian);
+      precond->compute();
+      timer.tick();
+      have_precond = true;
+      precond_age = 0;
+      if (stats != NULL) {
+        stats->jacobian_times.back() = timer.last();
+        stats->num_jacobians++;
+      }
+    }
+    precond_age++;
+
+    // Solve J(Y^n) \deltaY^{n+1} = -F(Y^n) by GMRES.
+    for (int i = 0; i < ndof; i++) b[i] = -f[i];
+    memset(step, 0, ndof * sizeof(scalar));
+    JacobianFreeOperator op(dp, coeff_vec, f, fd_epsilon);
+    int num_iters;
+    double linear_residual;
+    timer.tick(HERMES_SKIP);
+    bool converged = gmres(&op, precond, b, step, gmres_restart, eta, gmres_max_iters, num_iters, linear_residual);
+    timer.tick();
+    if (!converged)
+      warn("JFNK: GMRES not converged in %d iterations, relative residual %g.", num_iters, linear_residual);
+    if (verbose) info("---- GMRES: %d iterations (%d residuals), relative residual %g, tolerance %g.",
+                      num_iters, op.get_num_residuals(), linear_residual, eta);
+    if (stats != NULL) {
+      stats->solve_times.back() = timer.last();
+      stats->forcing_terms.back() = eta;
+      stats->linear_iters.back() = num_iters;
+    }
+
+    // Add \deltaY^{n+1} to Y^n.
+    for (int i = 0; i < ndof; i++) coeff_vec[i] += step[i];
+
+    it++;
+  }
+
+  delete [] f;
+  delete [] b;
+  delete [] step;
+  delete jacobian;
+
+  if (residual_norm >= newton_tol) {
+    if (verbose) info("Maximum allowed number of JFNK iterations exceeded, returning false.");
+    return false;
+  }
+
+  return true;
+}
+
 // Perform Picard's iteration.
 bool Hermes2D::solve_picard(WeakForm* wf, Space* space, Solution* sln_prev_iter,
                   MatrixSolverType matrix_solver, double picard_tol,
@@ -23,6 +23,10 @@
 #include "adapt/adapt.h"
 #include "graph.h"
 #include "function/forms.h"
+#include "function/fn_cache.h"
+#include "function/geom_cache.h"
+#include "function/sum_factorization.h"
+#include "element_matrix_cache.h"
 #include "weakform/weakform.h"
 #include "views/view.h"
 #include "views/scalar_view.h"
@@ -33,6 +37,9 @@
 #include "ref_selectors/selector.h"
 #include <map>
 
+/// Maximum number of function orders in the key of a cached integration order of a form.
+const int H2D_ORDER_KEY_SIZE = 24;
+
 class Space;
 class PrecalcShapeset;
 class WeakForm;
@@ -40,6 +47,8 @@ class Matrix;
 class SparseMatrix;
 class Vector;
 class Solver;
+class StaticCondensation;
+class ElementSystem;
 
 
 /// Discrete problem class.
@@ -57,7 +66,9 @@ public:
   DiscreteProblem(WeakForm* wf, Space* space, bool is_linear = false);
 
   /// Non-parameterized constructor (currently used only in KellyTypeAdapt to gain access to NeighborSearch methods).
-  DiscreteProblem() : wf(NULL), pss(NULL) {num_user_pss = 0; sp_seq = NULL;}
+  DiscreteProblem() : wf(NULL), pss(NULL), num_threads(1), space_mutex(NULL), thread_pool(NULL), condensation(NULL), element_system(NULL),
+                      element_cache(NULL), element_cache_entry(NULL)
+    {num_user_pss = 0; sp_seq = NULL;}
 
   /// Init function. Common code for the constructors.
   void init();
@@ -88,6 +99,78 @@ public:
   /// Get info about presence of a matrix.
   bool is_matrix_free() { return wf->is_matrix_free(); }
 
+  /// Get the number of threads used in assembling.
+  int get_num_threads() const { return num_threads; }
+
+  /// Set the number of threads used in assembling (1 = serial assembling, the default).
+  /// Each stage is traversed once by the calling thread and split into chunks of states,
+  /// which are assembled by a pool of num_threads threads (kept until the number of threads
+  /// changes). Meanwhile the calling thread inserts the contributions of the assembled
+  /// chunks into the global matrix and vector in the serial order, so the result is
+  /// identical to serial assembling. Stages with DG forms, external
+  /// functions other than the previous Newton iterate, or spaces with shapesets that can
+  /// not be cloned are always assembled serially. User forms must not modify shared data.
+  void set_num_threads(int num_threads);
+
+  /// Turns on (off) static condensation of the bubble DOFs (see StaticCondensation). The
+  /// matrix and the right-hand side are then assembled for the vertex and edge DOFs only
+  /// (get_num_condensed_dofs() unknowns in the order of the global DOFs), the bubble DOFs
+  /// are eliminated element by element. The vector of all DOFs is obtained from the solution
+  /// of the condensed system by back_substitute_bubbles(). Not available with DG forms and
+  /// in multi-mesh assembling.
+  void set_static_condensation(bool condense);
+  bool get_static_condensation() const { return condensation != NULL; }
+
+  /// Get the number of unknowns of the condensed system.
+  int get_num_condensed_dofs();
+
+  /// Computes all DOFs from the solution of the condensed system (of the last assembling)
+  /// into coeff_vec, which has get_num_dofs() entries.
+  void back_substitute_bubbles(scalar* condensed_vec, scalar* coeff_vec);
+
+  /// Incremental assembling: the values of the volumetric forms with cache_values set (see
+  /// WeakForm::Form) are taken from the cache for the elements that did not change since the
+  /// last assembly with the cache (see ElementMatrixCache), and stored there for the others.
+  /// The cache belongs to the caller
+  /// and is typically shared by the discrete problems of the reference spaces of all
+  /// adaptivity steps. NULL turns incremental assembling off.
+  void set_element_matrix_cache(ElementMatrixCache* cache) { element_cache = cache; }
+  ElementMatrixCache* get_element_matrix_cache() const { return element_cache; }
+
+  /// The shape functions of the spaces with the shapeset of the arena are evaluated on
+  /// the whole elements from the arena (see PrecalcArena), also in the assembling threads.
+  /// The arena belongs to the caller and can be shared by several discrete problems.
+  /// NULL turns it off.
+  void set_precalc_arena(PrecalcArena* arena);
+
+  /// Limits the memory of the cached shape functions of the elements with constant jacobians
+  /// in bytes (0 = no limit, 256 MB by default), per assembling thread.
+  void set_fn_cache_memory_limit(size_t bytes);
+
+  /// Statistics of the cached shape functions, summed over the assembling threads.
+  void get_fn_cache_stats(unsigned long& hits, unsigned long& misses, unsigned long& evictions, 
+                          size_t& memory);
+
+  /// Keeps the geometry and the jacobian*weights of the elements (see GeomCache) between
+  /// assemblies while the meshes do not change, instead of computing them for every element
+  /// in every assembly. The memory is limited in bytes (0 = no limit) per assembling thread.
+  void set_geom_cache(bool enable, size_t memory_limit = 64 << 20);
+
+  /// Statistics of the cached geometry, summed over the assembling threads.
+  void get_geom_cache_stats(unsigned long& hits, unsigned long& misses, unsigned long& evictions,
+                            size_t& memory);
+
+  /// Evaluates the volumetric forms that provide their coefficients in the quadrature points
+  /// (see WeakForm::MatrixFormVol::ref_point_coeffs()) on quads by sum factorization (see
+  /// SumFactorization), and precalculates the shape functions on quads from their 1D factors.
+  /// Used on the elements where the reference matrices can not be, i.e. with non-constant
+  /// jacobians. Off by default.
+  void set_sum_factorization(bool enable);
+  bool get_sum_factorization() const { return assembling_caches.use_sum_fact; }
+
+  /// Statistics of the cached integration orders of forms (see WeakForm::Form::cache_order),
+  /// summed over the assembling threads.
+  void get_order_cache_stats(unsigned long& hits, unsigned long& misses);
 
   /// Preassembling.
   /// Precalculate matrix sparse structure.
@@ -107,8 +190,13 @@ public:
 
   /// Converts coeff_vec to u_ext.
   /// If the supplied coeff_vec is NULL, it supplies the appropriate number of NULL pointers.
+  /// The solutions belong to the DiscreteProblem and are reused by the next call.
   void convert_coeff_vec(scalar* coeff_vec, Hermes::vector<Solution *> & u_ext, bool add_dir_lift);
 
+  /// Sets u_ext to views of the solutions master_u_ext of convert_coeff_vec() of the master,
+  /// evaluated from the own pss (see Solution::share_coeff_vector_direct()).
+  void share_coeff_vec(Hermes::vector<Solution *> & master_u_ext, Hermes::vector<Solution *> & u_ext);
+
   /// Initializes psss.
   void initialize_psss(Hermes::vector<PrecalcShapeset *>& spss);
 
@@ -144,6 +232,14 @@ public:
                           Hermes::vector<PrecalcShapeset *>& spss, Hermes::vector<RefMap *>& refmap, 
                           Hermes::vector<Solution *>& u_ext);
 
+  /// Assemble one stage using set_num_threads() threads.
+  void assemble_one_stage_threaded(WeakForm::Stage& stage, 
+                          SparseMatrix* mat, Vector* rhs, bool force_diagonal_blocks, Table* block_weights,
+                          Hermes::vector<Solution *>& u_ext);
+
+  /// Returns true if the stage can be assembled by assemble_one_stage_threaded().
+  bool is_stage_threadable(WeakForm::Stage& stage, Hermes::vector<Solution *>& u_ext);
+
   /// Assemble one state.
   void assemble_one_state(WeakForm::Stage& stage, 
                           SparseMatrix* mat, Vector* rhs, bool force_diagonal_blocks, Table* block_weights,
@@ -250,6 +346,10 @@ public:
   void set_fvm() {this->is_fvm = true;}
 
 protected:
+  /// Constructor of a worker used in threaded assembling. Shares the weak form and the spaces
+  /// with the master, but has its own master PrecalcShapesets (on cloned shapesets) and caches.
+  DiscreteProblem(DiscreteProblem* master);
+
   /// Assembling.
   /// Experimental caching of vector valued (vector) forms.
   struct SurfVectorFormsKey
@@ -298,6 +398,31 @@ protected:
                             PrecalcShapeset *fu, PrecalcShapeset *fv, 
                             RefMap *ru, RefMap *rv);
 
+  // Evaluates a form with batch_eval set (see WeakForm::MatrixFormVol::value_batch())
+  // for all pairs of the basis functions of alu and the test functions of alv at once.
+  // Returns the values multiplied by the scaling factor, indexed by [test][basis].
+  scalar** eval_form_batch(WeakForm::MatrixFormVol *mfv, Hermes::vector<Solution *> u_ext,
+                           PrecalcShapeset *fu, PrecalcShapeset *fv, RefMap *ru, RefMap *rv,
+                           AsmList *alu, AsmList *alv);
+
+  // Evaluates a form for all pairs of functions from the reference matrices (see
+  // WeakForm::MatrixFormVol::ref_coeffs()), in the same way as eval_form_batch().
+  // Returns NULL if the form or the element does not allow it.
+  scalar** eval_form_ref(WeakForm::MatrixFormVol *mfv, PrecalcShapeset *fu, PrecalcShapeset *fv,
+                         RefMap *ru, AsmList *alu, AsmList *alv);
+
+  // Evaluates a form for all pairs of functions by sum factorization (see set_sum_factorization()),
+  // in the same way as eval_form_batch(). Returns NULL if the form or the element does not allow it.
+  scalar** eval_form_sum_fact(WeakForm::MatrixFormVol *mfv, Hermes::vector<Solution *> u_ext,
+                              PrecalcShapeset *fu, PrecalcShapeset *fv, RefMap *ru, RefMap *rv,
+                              AsmList *alu, AsmList *alv);
+
+  // Returns the values of a form for all pairs of functions, in the same way as eval_form_batch(),
+  // from element_cache_entry. If they are not there, they are computed and stored.
+  scalar** get_cached_values(WeakForm::MatrixFormVol *mfv, Hermes::vector<Solution *> u_ext,
+                             PrecalcShapeset *fu, PrecalcShapeset *fv, RefMap *ru, RefMap *rv,
+                             AsmList *alu, AsmList *alv);
+
   // Vector volume forms. The functions provide the same functionality as the
   // parallel ones for matrix volume forms.
 
@@ -319,6 +444,14 @@ protected:
                             WeakForm::VectorFormVol *vfv, 
                             Hermes::vector<Solution *> u_ext,
                             PrecalcShapeset *fv, RefMap *rv);
+
+  scalar* eval_form_batch(WeakForm::VectorFormVol *vfv, Hermes::vector<Solution *> u_ext,
+                          PrecalcShapeset *fv, RefMap *rv, AsmList *alv);
+  scalar* eval_form_ref(WeakForm::VectorFormVol *vfv, PrecalcShapeset *fv, RefMap *rv, AsmList *alv);
+  scalar* eval_form_sum_fact(WeakForm::VectorFormVol *vfv, Hermes::vector<Solution *> u_ext,
+                             PrecalcShapeset *fv, RefMap *rv, AsmList *alv);
+  scalar* get_cached_values(WeakForm::VectorFormVol *vfv, Hermes::vector<Solution *> u_ext,
+                            PrecalcShapeset *fv, RefMap *rv, AsmList *alv);
  
   // Matrix surface forms. The functions provide the same functionality as the
   // parallel ones for matrix volume forms.
@@ -415,6 +548,32 @@ protected:
   Func<double>* get_fn(PrecalcShapeset *fu, RefMap *rm, const int order);
   Func<Ord>* get_fn_ord(const int order);
 
+  /// Key of the integration order of a form: the form, the kind of the integral and the orders
+  /// of all functions the form is evaluated with (their count goes first). Keys with more than
+  /// H2D_ORDER_KEY_SIZE orders are not cached.
+  struct OrderKey
+  {
+    OrderKey(WeakForm::Form* form, int kind);
+
+    inline void add(int order) { if (n < H2D_ORDER_KEY_SIZE) orders[n] = order; n++; }
+    void add_ext_fns(Hermes::vector<MeshFunction *> &ext);
+    void add_ext_fns(Hermes::vector<MeshFunction *> &ext, int edge);
+    void add_ext_fn(NeighborSearch* ns, MeshFunction* fu);
+
+    bool operator<(const OrderKey& other) const { return memcmp(this, &other, sizeof(OrderKey)) < 0; }
+
+    WeakForm::Form* form;
+    int kind;
+    int n;
+    int orders[H2D_ORDER_KEY_SIZE];
+  };
+  enum OrderKind { ORDER_VOL, ORDER_SURF, ORDER_DG };
+
+  /// Finds the order of the form (without the increase due to the reference map) in the cache.
+  bool find_order(const OrderKey& key, int& order);
+  /// Stores the order of the form in the cache.
+  void store_order(const OrderKey& key, int order);
+
   struct VolVectorFormsKey
   {
     WeakForm::VectorFormVol* vfv;
@@ -520,15 +679,59 @@ protected:
   PrecalcShapeset** pss;    // This is different from H3D.
   int num_user_pss;         // This is different from H3D.
 
+  /// Threaded assembling.
+  int num_threads;
+  /// Serializes calls to Space (assembly lists change the mode of the space's shapeset).
+  /// NULL unless in threaded assembling.
+  pthread_mutex_t* space_mutex;
+  /// Shapesets cloned for the pss of a worker, owned by the worker.
+  Hermes::vector<Shapeset *> own_shapesets;
+  /// Per-thread data, see discrete_problem.cpp. Kept between calls of assemble().
+  struct ThreadContext;
+  std::vector<ThreadContext *> thread_contexts;
+  /// The assembling threads and the queue of their work, NULL if not started.
+  struct ThreadPool;
+  ThreadPool* thread_pool;
+  /// Stops the assembling threads and frees their data.
+  void free_thread_contexts();
+  /// Body of an assembling thread (pthread start routine), the argument is a ThreadContext.
+  static void* assembling_thread_run(void* context);
+
+  /// Solutions of convert_coeff_vec(), evaluated directly from the coefficient vector
+  /// (see Solution::set_coeff_vector_direct()) and kept between the calls of assemble().
+  Hermes::vector<Solution *> u_ext_slns;
+
+  /// Static condensation, NULL if not used. Shared by the master and its workers.
+  StaticCondensation* condensation;
+  /// Collects the local system of the current state for static condensation.
+  ElementSystem* element_system;
+
+  /// Incremental assembling, NULL if not used. Shared by the master and its workers.
+  ElementMatrixCache* element_cache;
+  /// The entry of the current state, NULL if its values can not be cached.
+  ElementMatrixCache::Entry* element_cache_entry;
+  /// Finds the entry of the current state in element_cache.
+  ElementMatrixCache::Entry* get_element_cache_entry(Hermes::vector<RefMap *>& refmap,
+                                                     Hermes::vector<Solution *>& u_ext,
+                                                     Hermes::vector<bool>& isempty,
+                                                     Hermes::vector<AsmList *>& al);
+
 
   /// Geometry and jacobian*weights caches.
   Geom<double>* cache_e[g_max_quad + 1 + 4 * g_max_quad + 4];
   double* cache_jwt[g_max_quad + 1 + 4 * g_max_quad + 4];
+  /// True if the entry belongs to AssemblingCaches::geom_cache and must not be freed.
+  bool cache_e_shared[g_max_quad + 1 + 4 * g_max_quad + 4];
 
   /// Functions handling the above caches, and also other caches.
   void init_cache();
   void delete_cache();
   void delete_single_geom_cache(int order);
+  /// Sets cache_e[order] and cache_jwt[order] for the volumetric quadrature of the order on
+  /// the active element of rm, if they are not set yet.
+  void init_geom_cache_vol(RefMap* rm, int order);
+  /// The same for the edge quadrature eo of surf_pos.
+  void init_geom_cache_surf(RefMap* rm, SurfPos* surf_pos, int eo);
 
   /// Class handling various caches used in assembling.
   class AssemblingCaches {
@@ -537,134 +740,54 @@ protected:
     AssemblingCaches();
     ~AssemblingCaches();
 
-    /// Key for caching precalculated shapeset values on transformed elements with constant
-    /// jacobians.
-    struct KeyConst
-    {
-      int index;
-      int order;
-#ifdef _MSC_VER
-      UINT64 sub_idx;
-#else
-      unsigned int sub_idx;
-#endif
-      int shapeset_type;
-      double inv_ref_map[2][2];
-#ifdef _MSC_VER
-      KeyConst(int index, int order, UINT64 sub_idx, int shapeset_type, double2x2* inv_ref_map) {
-        this->index = index;
-        this->order = order;
-        this->sub_idx = sub_idx;
-        this->shapeset_type = shapeset_type;
-        this->inv_ref_map[0][0] = (*inv_ref_map)[0][0];
-        this->inv_ref_map[0][1] = (*inv_ref_map)[0][1];
-        this->inv_ref_map[1][0] = (*inv_ref_map)[1][0];
-        this->inv_ref_map[1][1] = (*inv_ref_map)[1][1];
-      }
-#else
-      KeyConst(int index, int order, unsigned int sub_idx, int shapeset_type, double2x2* inv_ref_map) {
-        this->index = index;
-        this->order = order;
-        this->sub_idx = sub_idx;
-        this->shapeset_type = shapeset_type;
-        this->inv_ref_map[0][0] = (*inv_ref_map)[0][0];
-        this->inv_ref_map[0][1] = (*inv_ref_map)[0][1];
-        this->inv_ref_map[1][0] = (*inv_ref_map)[1][0];
-        this->inv_ref_map[1][1] = (*inv_ref_map)[1][1];
-      }
-#endif
-    };
-
-    /// Functor that compares two above keys (needed e.g. to create a std::map indexed by these keys);
-    struct CompareConst {
-      bool operator()(KeyConst a, KeyConst b) const {
-        if(a.inv_ref_map[0][0] < b.inv_ref_map[0][0]) return true;
-        else if(a.inv_ref_map[0][0] > b.inv_ref_map[0][0]) return false;
-        else
-          if(a.inv_ref_map[0][1] < b.inv_ref_map[0][1]) return true;
-          else if(a.inv_ref_map[0][1] > b.inv_ref_map[0][1]) return false;
-          else
-            if(a.inv_ref_map[1][0] < b.inv_ref_map[1][0]) return true;
-            else if(a.inv_ref_map[1][0] > b.inv_ref_map[1][0]) return false;
-            else
-              if(a.inv_ref_map[1][1] < b.inv_ref_map[1][1]) return true;
-              else if(a.inv_ref_map[1][1] > b.inv_ref_map[1][1]) return false;
-              else
-                if (a.index < b.index) return true;
-                else if (a.index > b.index) return false;
-                else
-                  if (a.order < b.order) return true;
-                  else if (a.order > b.order) return false;
-                  else
-                    if (a.sub_idx < b.sub_idx) return true;
-                    else if (a.sub_idx > b.sub_idx) return false;
-                    else
-                      if (a.shapeset_type < b.shapeset_type) return true;
-                      else return false;
-      };
-    };
-
-    /// PrecalcShapeset stored values for Elements with constant jacobian of the reference mapping.
-    /// For triangles.
-    std::map<KeyConst, Func<double>*, CompareConst> const_cache_fn_triangles;
-    /// For quads
-    std::map<KeyConst, Func<double>*, CompareConst> const_cache_fn_quads;
-    
-    /// The same setup for elements with non-constant jacobians.
-    /// This cache is deleted with every change of the state in assembling.
-    struct KeyNonConst {
-      int index;
-      int order;
-#ifdef _MSC_VER
-      UINT64 sub_idx;
-#else
-      unsigned int sub_idx;
-#endif
-      int shapeset_type;
-#ifdef _MSC_VER
-      KeyNonConst(int index, int order, UINT64 sub_idx, int shapeset_type) {
-        this->index = index;
-        this->order = order;
-        this->sub_idx = sub_idx;
-        this->shapeset_type = shapeset_type;
-      }
-#else
-      KeyNonConst(int index, int order, unsigned int sub_idx, int shapeset_type) {
-        this->index = index;
-        this->order = order;
-        this->sub_idx = sub_idx;
-        this->shapeset_type = shapeset_type;
-      }
-#endif
-    };
-
-    /// Functor that compares two above keys (needed e.g. to create a std::map indexed by these keys);
-    struct CompareNonConst {
-      bool operator()(KeyNonConst a, KeyNonConst b) const {
-        if (a.index < b.index) return true;
-        else if (a.index > b.index) return false;
-        else {
-          if (a.order < b.order) return true;
-          else if (a.order > b.order) return false;
-          else {
-            if (a.sub_idx < b.sub_idx) return true;
-            else if (a.sub_idx > b.sub_idx) return false;
-            else {
-              if (a.shapeset_type < b.shapeset_type) return true;
-              else return false;
-            }
-          }
-        }
-      }
-    };
-    
-    /// PrecalcShapeset stored values for Elements with constant jacobian of the reference mapping.
-    /// For triangles.
-    std::map<KeyNonConst, Func<double>*, CompareNonConst> cache_fn_triangles;
-    /// For quads
-    std::map<KeyNonConst, Func<double>*, CompareNonConst> cache_fn_quads;
+    /// Clears the cache of the elements with constant jacobians if the spaces or their meshes
+    /// have changed since the last call, the cache of the geometry if the meshes have, and the
+    /// cache of the orders if the weak form has.
+    void update(Hermes::vector<Space *>& spaces, WeakForm* wf);
+
+    /// PrecalcShapeset values transformed to elements with constant jacobian of the reference mapping.
+    /// They do not depend on the element and are kept between assemblies until the spaces change.
+    FnCache const_cache_fn;
+    /// The same for elements with non-constant jacobians.
+    /// This cache is cleared with every change of the state in assembling.
+    FnCache cache_fn;
 
     LightArray<Func<Ord>*> cache_fn_ord;
+
+    /// Geometry of the elements, used if use_geom_cache is set (see set_geom_cache()).
+    /// Cleared when the meshes change.
+    GeomCache geom_cache;
+    bool use_geom_cache;
+
+    /// Shape functions and results of the batched evaluation of forms.
+    FuncBatch batch_u, batch_v;
+    scalar** batch_matrix;
+    int batch_matrix_dim;
+    std::vector<scalar> batch_vector;
+
+    /// Signature of the current state and the rows of the values taken from the
+    /// ElementMatrixCache.
+    std::vector<uint64_t> signature;
+    std::vector<scalar*> cached_rows;
+
+    /// Integrals of the shape functions over the reference elements, they depend only
+    /// on the shapesets.
+    RefMatrixCache ref_matrices;
+
+    /// Factors of the shape functions on quads, used if use_sum_fact is set (see
+    /// set_sum_factorization()).
+    SumFactorization sum_fact;
+    bool use_sum_fact;
+
+    /// Integration orders of the forms. They do not depend on the spaces and are kept until
+    /// the weak form changes.
+    std::map<OrderKey, int> cache_order;
+    unsigned long order_hits, order_misses;
+
+  protected:
+    std::vector<int> sp_seq;
+    std::vector<unsigned int> mesh_seq;
+    int wf_seq;
   };
   AssemblingCaches assembling_caches;
 };
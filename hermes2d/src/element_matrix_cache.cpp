@@ -0,0 +1,131 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "element_matrix_cache.h"
+#include "weakform/weakform.h"
+
+ElementMatrixCache::ElementMatrixCache(size_t memory_limit) : memory_limit(memory_limit)
+{
+  _F_
+  generation = 0;
+  wf = NULL;
+  wf_seq = -1;
+  memory = 0;
+  hits = misses = 0;
+  pthread_mutex_init(&mutex, NULL);
+}
+
+ElementMatrixCache::~ElementMatrixCache()
+{
+  _F_
+  clear();
+  pthread_mutex_destroy(&mutex);
+}
+
+size_t ElementMatrixCache::entry_memory(const std::vector<uint64_t>& signature, Entry* entry)
+{
+  size_t size = sizeof(Entry) + signature.size() * sizeof(uint64_t);
+  for (std::map<const void*, std::pair<scalar, std::vector<scalar> > >::iterator it = entry->values.begin();
+       it != entry->values.end(); it++)
+    size += it->second.second.size() * sizeof(scalar);
+  return size;
+}
+
+void ElementMatrixCache::begin(WeakForm* wf)
+{
+  _F_
+  if (wf != this->wf || wf->get_seq() != wf_seq) {
+    clear();
+    this->wf = wf;
+    wf_seq = wf->get_seq();
+  }
+  generation++;
+}
+
+void ElementMatrixCache::end()
+{
+  _F_
+  std::map<std::vector<uint64_t>, Entry*>::iterator it = entries.begin();
+  while (it != entries.end()) {
+    if (it->second->generation != generation) {
+      memory -= entry_memory(it->first, it->second);
+      delete it->second;
+      entries.erase(it++);
+    }
+    else it++;
+  }
+}
+
+ElementMatrixCache::Entry* ElementMatrixCache::get_entry(const std::vector<uint64_t>& signature)
+{
+  pthread_mutex_lock(&mutex);
+  Entry* entry = NULL;
+  std::map<std::vector<uint64_t>, Entry*>::iterator it = entries.find(signature);
+  if (it != entries.end()) {
+    entry = it->second;
+    hits++;
+  }
+  else {
+    misses++;
+    size_t size = sizeof(Entry) + signature.size() * sizeof(uint64_t);
+    if (memory_limit == 0 || memory + size <= memory_limit) {
+      entry = new Entry;
+      MEM_CHECK(entry);
+      entries[signature] = entry;
+      memory += size;
+    }
+  }
+  if (entry != NULL) entry->generation = generation;
+  pthread_mutex_unlock(&mutex);
+  return entry;
+}
+
+scalar* ElementMatrixCache::get_values(Entry* entry, const void* form, scalar scaling_factor, int n)
+{
+  std::map<const void*, std::pair<scalar, std::vector<scalar> > >::iterator it = entry->values.find(form);
+  if (it == entry->values.end() || it->second.first != scaling_factor || (int) it->second.second.size() != n)
+    return NULL;
+  return &it->second.second[0];
+}
+
+scalar* ElementMatrixCache::add_values(Entry* entry, const void* form, scalar scaling_factor, int n)
+{
+  if (n == 0) return NULL;
+  // Only one thread assembles a state, so only the memory counter is shared.
+  std::pair<scalar, std::vector<scalar> >& values = entry->values[form];
+  size_t old_size = values.second.size() * sizeof(scalar), new_size = n * sizeof(scalar);
+  pthread_mutex_lock(&mutex);
+  bool fits = (memory_limit == 0 || memory - old_size + new_size <= memory_limit);
+  memory -= old_size;
+  if (fits) memory += new_size;
+  pthread_mutex_unlock(&mutex);
+  if (!fits) {
+    entry->values.erase(form);
+    return NULL;
+  }
+
+  values.first = scaling_factor;
+  values.second.resize(n);
+  return &values.second[0];
+}
+
+void ElementMatrixCache::clear()
+{
+  _F_
+  for (std::map<std::vector<uint64_t>, Entry*>::iterator it = entries.begin(); it != entries.end(); it++)
+    delete it->second;
+  entries.clear();
+  memory = 0;
+}
@@ -0,0 +1,98 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __H2D_ELEMENT_MATRIX_CACHE_H
+#define __H2D_ELEMENT_MATRIX_CACHE_H
+
+#include "h2d_common.h"
+
+class WeakForm;
+
+/// Values of the volumetric forms on the elements of the last assembly, used for incremental
+/// assembling (see DiscreteProblem::set_element_matrix_cache()).
+///
+/// An assembling state is identified by the vertices, markers and sub-element transformations
+/// of its elements and by the indices of the shape functions of its assembly lists (the
+/// signature). If a state with the same signature was assembled before, the values of the
+/// forms do not have to be computed again: they are only multiplied by the current
+/// coefficients of the assembly lists (which change with the constraints of the neighbors)
+/// and inserted at the current DOFs. After the reference space of an adaptivity step is
+/// refined, only the elements that were refined or whose shape functions have changed
+/// (including the edge functions shared with a refined neighbor) are computed.
+///
+/// The cache lives outside of the DiscreteProblem, so it can be used by the discrete problems
+/// of the subsequent adaptivity steps. Only the values of the linear forms (assembled without
+/// a previous iterate) that do not use external functions and have cache_values set are
+/// stored. The states that were not assembled in the last assembly are removed.
+class HERMES_API ElementMatrixCache
+{
+public:
+  /// The memory of the values is limited in bytes (0 = no limit), the states above the
+  /// limit are not stored.
+  ElementMatrixCache(size_t memory_limit = 256 << 20);
+  ~ElementMatrixCache();
+
+  /// Values of the forms in one state.
+  struct Entry
+  {
+    unsigned int generation;  ///< The last assembly that used the entry.
+    /// Values of the forms: the scaling factor of the form and the values.
+    std::map<const void*, std::pair<scalar, std::vector<scalar> > > values;
+  };
+
+  /// Starts an assembly with the weak form wf. All entries are removed if the weak form
+  /// is not the one of the last assembly or has changed.
+  void begin(WeakForm* wf);
+  /// Ends the assembly, removes the entries that were not used.
+  void end();
+
+  /// Returns the entry of the state with the signature, a new one if it is not in the cache.
+  /// Returns NULL if the memory limit is reached. Can be called from the assembling threads.
+  Entry* get_entry(const std::vector<uint64_t>& signature);
+
+  /// Returns the values of size n of the form with the scaling factor in the entry, NULL if
+  /// they are not stored.
+  scalar* get_values(Entry* entry, const void* form, scalar scaling_factor, int n);
+  /// Allocates n values of the form in the entry and returns them (to be filled in by the
+  /// caller), NULL if the memory limit is reached.
+  scalar* add_values(Entry* entry, const void* form, scalar scaling_factor, int n);
+
+  /// Removes all entries.
+  void clear();
+
+  void set_memory_limit(size_t bytes) { memory_limit = bytes; }
+  size_t get_memory_limit() const { return memory_limit; }
+
+  /// Statistics: states found and not found in the cache (in all assemblies).
+  unsigned long get_num_hits() const { return hits; }
+  unsigned long get_num_misses() const { return misses; }
+  size_t get_memory() const { return memory; }
+  int get_num_entries() const { return (int) entries.size(); }
+
+protected:
+  std::map<std::vector<uint64_t>, Entry*> entries;
+  unsigned int generation;
+  WeakForm* wf;
+  int wf_seq;
+
+  size_t memory, memory_limit;
+  unsigned long hits, misses;
+
+  pthread_mutex_t mutex;
+
+  static size_t entry_memory(const std::vector<uint64_t>& signature, Entry* entry);
+};
+
+#endif
@@ -0,0 +1,215 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "fn_cache.h"
+
+static const unsigned int FN_CACHE_MIN_CAPACITY = 64;
+
+FnCache::Key::Key(int index, int order, uint64_t sub_idx, int shapeset_type, int mode, double2x2* inv_ref_map)
+{
+  // Keys are hashed and compared as raw memory.
+  memset(this, 0, sizeof(Key));
+  this->sub_idx = sub_idx;
+  this->index = index;
+  this->order = order;
+  this->shapeset_type = shapeset_type;
+  this->mode = mode;
+  if (inv_ref_map != NULL) {
+    this->inv_ref_map[0][0] = (*inv_ref_map)[0][0];
+    this->inv_ref_map[0][1] = (*inv_ref_map)[0][1];
+    this->inv_ref_map[1][0] = (*inv_ref_map)[1][0];
+    this->inv_ref_map[1][1] = (*inv_ref_map)[1][1];
+  }
+}
+
+FnCache::FnCache()
+{
+  _F_
+  capacity = FN_CACHE_MIN_CAPACITY;
+  table = new Entry[capacity];
+  MEM_CHECK(table);
+  for (unsigned int i = 0; i < capacity; i++) table[i].fn = NULL;
+
+  state = 0;
+  memory = 0;
+  memory_limit = 0;
+  hits = misses = evictions = 0;
+}
+
+FnCache::~FnCache()
+{
+  _F_
+  free();
+  delete [] table;
+}
+
+unsigned int FnCache::hash_key(const Key& key)
+{
+  // FNV-1a over the 32-bit words of the key.
+  const unsigned int* w = (const unsigned int*) &key;
+  unsigned int h = 2166136261u;
+  for (unsigned int i = 0; i < sizeof(Key) / sizeof(unsigned int); i++) {
+    h ^= w[i];
+    h *= 16777619u;
+  }
+  return h ^ (h >> 15);
+}
+
+size_t FnCache::fn_memory(Func<double>* fn)
+{
+  int n = 0;
+  if (fn->val != NULL) n++;
+  if (fn->dx != NULL) n++;
+  if (fn->dy != NULL) n++;
+#ifdef H2D_SECOND_DERIVATIVES_ENABLED
+  if (fn->laplace != NULL) n++;
+#endif
+  if (fn->val0 != NULL) n++;
+  if (fn->val1 != NULL) n++;
+  if (fn->curl != NULL) n++;
+  if (fn->div != NULL) n++;
+  return sizeof(Func<double>) + n * fn->num_gip * sizeof(double);
+}
+
+void FnCache::delete_fn(Func<double>* fn)
+{
+  fn->free_fn();
+  delete fn;
+}
+
+Func<double>* FnCache::get(const Key& key, PrecalcShapeset* fu, RefMap* rm, int order)
+{
+  unsigned int hash = hash_key(key);
+  unsigned int mask = capacity - 1;
+  for (unsigned int i = hash & mask; table[i].fn != NULL; i = (i + 1) & mask) {
+    if (table[i].hash == hash && !memcmp(&table[i].key, &key, sizeof(Key))) {
+      hits++;
+      table[i].state = state;
+      return table[i].fn;
+    }
+  }
+  misses++;
+
+  // Take the arrays of a function with the same number of points and space type from the pool.
+  Quad2D* quad = fu->get_quad_2d();
+  int pool_key = quad->get_num_points(order) * (HERMES_L2_SPACE + 1) + fu->get_space_type();
+  Func<double>* fn = NULL;
+  std::map<int, std::vector<Func<double>*> >::iterator it = pool.find(pool_key);
+  if (it != pool.end() && !it->second.empty()) {
+    fn = it->second.back();
+    it->second.pop_back();
+    fn = init_fn(fu, rm, order, fn);
+  }
+  else {
+    fn = init_fn(fu, rm, order);
+    memory += fn_memory(fn);
+  }
+
+  if (2 * (live.size() + 1) > capacity) rehash(2 * capacity);
+
+  Entry entry;
+  entry.key = key;
+  entry.hash = hash;
+  entry.state = state;
+  entry.pool_key = pool_key;
+  entry.fn = fn;
+  insert(entry);
+
+  if (memory_limit > 0 && memory > memory_limit) evict();
+  return fn;
+}
+
+void FnCache::insert(const Entry& entry)
+{
+  unsigned int mask = capacity - 1;
+  unsigned int i = entry.hash & mask;
+  while (table[i].fn != NULL) i = (i + 1) & mask;
+  table[i] = entry;
+  live.push_back(i);
+}
+
+void FnCache::rehash(unsigned int new_capacity)
+{
+  _F_
+  std::vector<Entry> entries;
+  entries.reserve(live.size());
+  for (unsigned int i = 0; i < live.size(); i++)
+    entries.push_back(table[live[i]]);
+
+  if (new_capacity != capacity) {
+    delete [] table;
+    capacity = new_capacity;
+    table = new Entry[capacity];
+    MEM_CHECK(table);
+    for (unsigned int i = 0; i < capacity; i++) table[i].fn = NULL;
+  }
+  else
+    for (unsigned int i = 0; i < live.size(); i++) table[live[i]].fn = NULL;
+
+  live.clear();
+  for (unsigned int i = 0; i < entries.size(); i++)
+    insert(entries[i]);
+}
+
+void FnCache::evict()
+{
+  _F_
+  // Free the pool first.
+  for (std::map<int, std::vector<Func<double>*> >::iterator it = pool.begin(); it != pool.end(); it++)
+    for (unsigned int i = 0; i < it->second.size(); i++) {
+      memory -= fn_memory(it->second[i]);
+      delete_fn(it->second[i]);
+    }
+  pool.clear();
+  if (memory <= memory_limit) return;
+
+  // Then the functions that are not used in the current state.
+  unsigned int n = 0;
+  for (unsigned int i = 0; i < live.size(); i++) {
+    Entry& entry = table[live[i]];
+    if (entry.state == state)
+      live[n++] = live[i];
+    else {
+      memory -= fn_memory(entry.fn);
+      delete_fn(entry.fn);
+      entry.fn = NULL;
+      evictions++;
+    }
+  }
+  live.resize(n);
+  rehash(capacity);
+}
+
+void FnCache::clear()
+{
+  _F_
+  for (unsigned int i = 0; i < live.size(); i++) {
+    Entry& entry = table[live[i]];
+    pool[entry.pool_key].push_back(entry.fn);
+    entry.fn = NULL;
+  }
+  live.clear();
+}
+
+void FnCache::free()
+{
+  _F_
+  clear();
+  for (std::map<int, std::vector<Func<double>*> >::iterator it = pool.begin(); it != pool.end(); it++)
+    for (unsigned int i = 0; i < it->second.size(); i++)
+      delete_fn(it->second[i]);
+  pool.clear();
+  memory = 0;
+}
@@ -0,0 +1,100 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __H2D_FN_CACHE_H
+#define __H2D_FN_CACHE_H
+
+#include "forms.h"
+
+/// Cache of shape functions transformed to physical elements (see init_fn()), used in assembling.
+///
+/// It is an open-addressing hash table with linear probing. The functions removed from the
+/// table by clear() are kept in a pool and their arrays are reused by later misses. If the
+/// memory of the functions exceeds the limit, the pool is freed and then the functions not
+/// used since the last call to new_state() are evicted, so a function returned by get() stays
+/// valid at least until the next new_state() or clear().
+class HERMES_API FnCache
+{
+public:
+  FnCache();
+  ~FnCache();
+
+  /// Key of a transformed shape function. For elements with a constant jacobian of the
+  /// reference mapping, the inverse reference map is a part of the key and the function
+  /// does not depend on the element; otherwise it is zero and the cache has to be cleared
+  /// for every element.
+  struct Key
+  {
+    Key() { }
+    Key(int index, int order, uint64_t sub_idx, int shapeset_type, int mode, double2x2* inv_ref_map = NULL);
+
+    uint64_t sub_idx;
+    int index;
+    int order;
+    int shapeset_type;
+    int mode;
+    double inv_ref_map[2][2];
+  };
+
+  /// Returns the function of the key, calls init_fn(fu, rm, order) if it is not cached.
+  Func<double>* get(const Key& key, PrecalcShapeset* fu, RefMap* rm, int order);
+
+  /// Marks the beginning of a new assembling state (element).
+  void new_state() { state++; }
+
+  /// Removes all functions, their memory goes to the pool.
+  void clear();
+  /// Frees all functions including the pool.
+  void free();
+
+  /// Memory limit of the cached functions in bytes (0 = no limit).
+  void set_memory_limit(size_t bytes) { memory_limit = bytes; }
+  size_t get_memory_limit() const { return memory_limit; }
+
+  /// Statistics.
+  unsigned long get_num_hits() const { return hits; }
+  unsigned long get_num_misses() const { return misses; }
+  unsigned long get_num_evictions() const { return evictions; }
+  size_t get_memory() const { return memory; }
+  int get_num_entries() const { return (int) live.size(); }
+
+protected:
+  struct Entry
+  {
+    Key key;
+    unsigned int hash;
+    unsigned int state;     ///< The last state in which the function was used.
+    int pool_key;           ///< Number of points and space type of the function.
+    Func<double>* fn;       ///< NULL for an empty slot.
+  };
+
+  Entry* table;
+  unsigned int capacity;    ///< Size of the table, a power of two.
+  std::vector<unsigned int> live;   ///< Occupied slots.
+  std::map<int, std::vector<Func<double>*> > pool;
+
+  unsigned int state;
+  size_t memory, memory_limit;
+  unsigned long hits, misses, evictions;
+
+  static unsigned int hash_key(const Key& key);
+  void insert(const Entry& entry);
+  void rehash(unsigned int new_capacity);
+  void evict();
+  static size_t fn_memory(Func<double>* fn);
+  static void delete_fn(Func<double>* fn);
+};
+
+#endif
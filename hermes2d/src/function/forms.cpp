@@ -106,7 +106,7 @@ Func<Ord>* init_fn_ord(const int order)
 }
 
 /// Transformation of shape functions using reference mapping.
-Func<double>* init_fn(PrecalcShapeset *fu, RefMap *rm, const int order)
+Func<double>* init_fn(PrecalcShapeset *fu, RefMap *rm, const int order, Func<double>* u)
 {
   int nc = fu->get_num_components();
   ESpaceType space_type = fu->get_space_type();
@@ -119,15 +119,18 @@ Func<double>* init_fn(PrecalcShapeset *fu, RefMap *rm, const int order)
   fu->set_quad_order(order);
   double3* pt = quad->get_points(order);
   int np = quad->get_num_points(order);
-  Func<double>* u = new Func<double>(np, nc);
+  if (u == NULL)
+    u = new Func<double>(np, nc);
+  else if (u->num_gip != np || u->nc != nc)
+    error("Func<double> of a wrong size reused in init_fn().");
 
   // H1 space.
   if (space_type == HERMES_H1_SPACE) {
-    u->val = new double [np];
-    u->dx  = new double [np];
-    u->dy  = new double [np];
+    if (u->val == NULL) u->val = new double [np];
+    if (u->dx == NULL) u->dx = new double [np];
+    if (u->dy == NULL) u->dy = new double [np];
 #ifdef H2D_SECOND_DERIVATIVES_ENABLED
-    u->laplace = new double [np];
+    if (u->laplace == NULL) u->laplace = new double [np];
 #endif
     double *fn = fu->get_fn_values();
     double *dx = fu->get_dx_values();
@@ -189,9 +192,9 @@ Func<double>* init_fn(PrecalcShapeset *fu, RefMap *rm, const int order)
   }
   // Hcurl space.
   else if (space_type == HERMES_HCURL_SPACE) {
-    u->val0 = new double [np];
-    u->val1 = new double [np];
-    u->curl = new double [np];
+    if (u->val0 == NULL) u->val0 = new double [np];
+    if (u->val1 == NULL) u->val1 = new double [np];
+    if (u->curl == NULL) u->curl = new double [np];
 
     double *fn0 = fu->get_fn_values(0);
     double *fn1 = fu->get_fn_values(1);
@@ -228,8 +231,9 @@ Func<double>* init_fn(PrecalcShapeset *fu, RefMap *rm, const int order)
   }
   // Hdiv space.
   else if (space_type == HERMES_HDIV_SPACE) {
-    u->val0 = new double [np];
-    u->val1 = new double [np];
+    if (u->val0 == NULL) u->val0 = new double [np];
+    if (u->val1 == NULL) u->val1 = new double [np];
+    if (u->div == NULL) u->div = new double [np];
 
     double *fn0 = fu->get_fn_values(0);
     double *fn1 = fu->get_fn_values(1);
@@ -267,9 +271,9 @@ Func<double>* init_fn(PrecalcShapeset *fu, RefMap *rm, const int order)
   else if (space_type == HERMES_L2_SPACE) {
     // Same as for H1, except that we currently do not have
     // second derivatives of L2 shape functions for triangles.
-    u->val = new double [np];
-    u->dx  = new double [np];
-    u->dy  = new double [np];
+    if (u->val == NULL) u->val = new double [np];
+    if (u->dx == NULL) u->dx = new double [np];
+    if (u->dy == NULL) u->dy = new double [np];
 
     double *fn = fu->get_fn_values();
     double *dx = fu->get_dx_values();
@@ -389,7 +393,7 @@ Func<scalar>* init_fn(Solution *fu, const int order)
     memcpy(u->dy, fu->get_dy_values(), np * sizeof(scalar));
 #ifdef H2D_SECOND_DERIVATIVES_ENABLED
     if (space_type == HERMES_H1_SPACE) {
-      if(sln_type == HERMES_SLN) {
+      if(sln_type == HERMES_SLN || sln_type == HERMES_SLN_DIRECT) {
         scalar *dxx = fu->get_dxx_values();
         scalar *dyy = fu->get_dyy_values();
         for (int i = 0; i < np; i++)
@@ -420,3 +424,93 @@ Func<scalar>* init_fn(Solution *fu, const int order)
   return u;
 }
 
+FuncBatch::FuncBatch()
+{
+  nf = np = size = work_np = 0;
+  nc = 1;
+  val = dx = dy = NULL;
+  val0 = val1 = curl = NULL;
+  wbuf = work = NULL;
+  swork = NULL;
+}
+
+FuncBatch::~FuncBatch()
+{
+  free();
+}
+
+void FuncBatch::resize(int nf, int np, int nc)
+{
+  _F_
+  this->nf = nf;
+  this->np = np;
+  if (nf * np <= size && np <= work_np && nc == this->nc) return;
+  free();
+  this->nc = nc;
+  size = nf * np;
+  work_np = np;
+  wbuf = new double[np];
+  work = new double[2 * size];
+  swork = new scalar[2 * np];
+  MEM_CHECK(swork);
+  if (nc == 1) {
+    val = new double[size];
+    dx = new double[size];
+    dy = new double[size];
+    MEM_CHECK(dy);
+  }
+  else {
+    val0 = new double[size];
+    val1 = new double[size];
+    curl = new double[size];
+    MEM_CHECK(curl);
+  }
+}
+
+void FuncBatch::set(int k, Func<double>* u)
+{
+  assert(k < nf && u->num_gip == np && u->nc == nc);
+  if (nc == 1) {
+    memcpy(val + k * np, u->val, np * sizeof(double));
+    memcpy(dx + k * np, u->dx, np * sizeof(double));
+    memcpy(dy + k * np, u->dy, np * sizeof(double));
+  }
+  else {
+    memcpy(val0 + k * np, u->val0, np * sizeof(double));
+    memcpy(val1 + k * np, u->val1, np * sizeof(double));
+    memcpy(curl + k * np, u->curl, np * sizeof(double));
+  }
+}
+
+void FuncBatch::view(int k, Func<double>* f) const
+{
+  assert(k < nf && f->num_gip == np && f->nc == nc);
+  if (nc == 1) {
+    f->val = val + k * np;
+    f->dx = dx + k * np;
+    f->dy = dy + k * np;
+  }
+  else {
+    f->val0 = val0 + k * np;
+    f->val1 = val1 + k * np;
+    f->curl = curl + k * np;
+  }
+}
+
+void FuncBatch::free()
+{
+  delete [] val;
+  delete [] dx;
+  delete [] dy;
+  delete [] val0;
+  delete [] val1;
+  delete [] curl;
+  delete [] wbuf;
+  delete [] work;
+  delete [] swork;
+  val = dx = dy = NULL;
+  val0 = val1 = curl = NULL;
+  wbuf = work = NULL;
+  swork = NULL;
+  size = work_np = 0;
+}
@@ -406,7 +406,8 @@ HERMES_API Geom<double>* init_geom_surf(RefMap *rm, SurfPos* surf_pos, const int
 /// Init the function for calculation the integration order.
 HERMES_API Func<Ord>* init_fn_ord(const int order);
 /// Init the shape function for the evaluation of the volumetric/surface integral (transformation of values).
-HERMES_API Func<double>* init_fn(PrecalcShapeset *fu, RefMap *rm, const int order);
+/// If u is given, its arrays are reused (it has to come from init_fn() with the same number of points and space type).
+HERMES_API Func<double>* init_fn(PrecalcShapeset *fu, RefMap *rm, const int order, Func<double>* u = NULL);
 /// Init the mesh-function for the evaluation of the volumetric/surface integral.
 HERMES_API Func<scalar>* init_fn(MeshFunction *fu, const int order);
 /// Init the solution for the evaluation of the volumetric/surface integral.
@@ -444,4 +445,40 @@ public:
   }
 };
 
+/// Values of several shape functions at the integration points of an element, used in the
+/// batched evaluation of forms. The arrays are contiguous: val[k * np + i] is the value of
+/// the k-th function at the i-th integration point, and similarly the other arrays. Scalar
+/// functions (nc == 1) have val, dx and dy, vector-valued (Hcurl) functions val0, val1 and
+/// curl, the other arrays are NULL.
+class HERMES_API FuncBatch
+{
+public:
+  int nf;           ///< Number of functions.
+  int np;           ///< Number of integration points.
+  int nc;           ///< Number of components.
+  double *val, *dx, *dy;
+  double *val0, *val1, *curl;
+
+  /// Scratch space of the batched integrals (see integrals/h1.h), so that they do not
+  /// allocate memory for every element: wbuf has np values, work 2 * nf * np values and
+  /// swork 2 * np values. The contents are undefined between the calls.
+  double *wbuf, *work;
+  scalar *swork;
+
+  FuncBatch();
+  ~FuncBatch();
+
+  /// Makes room for nf functions at np points, the arrays are reused if they are large enough.
+  void resize(int nf, int np, int nc = 1);
+  /// Copies the values of the function u (with np points) to the k-th position.
+  void set(int k, Func<double>* u);
+  /// Points the arrays of f (with np points and nc components) to the k-th function.
+  void view(int k, Func<double>* f) const;
+  void free();
+
+protected:
+  int size;         ///< Allocated length of the arrays.
+  int work_np;      ///< Allocated length of wbuf (and half of the length of swork).
+};
+
 #endif
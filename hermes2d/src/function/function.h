@@ -61,6 +61,8 @@ const int H2D_FN_COMPONENT_1 = H2D_FN_VAL_1 | H2D_FN_DX_1 | H2D_FN_DY_1 | H2D_FN
   #define check_table(n, msg)
 #endif
 
+class PrecalcArena;
+
 
 /// \brief Represents an arbitrary function defined on an element.
 ///
@@ -115,6 +117,13 @@ public:
   ///   H2D_FN_VAL | H2D_FN_DX | H2D_FN_DY. You can also use H2D_FN_ALL to precalculate everything.
   void set_quad_order(unsigned int order, int mask = H2D_FN_DEFAULT)
   {
+    if (fixed_nodes != NULL && order < num_fixed_nodes && fixed_nodes[order] != NULL
+        && (fixed_nodes[order]->mask & mask) == mask) {
+      cur_node = fixed_nodes[order];
+      return;
+    }
+    if (nodes == NULL)
+      update_nodes_ptr();
     if(nodes->present(order)) {
       cur_node = nodes->get(order);
       // If the mask has changed.
@@ -250,6 +259,12 @@ protected:
   // Nodes for the overflow sub-element transformation.
   LightArray<Node*>* overflow_nodes;
 
+  /// Nodes precalculated in advance (see PrecalcArena), indexed by the order; used instead of
+  /// 'nodes' if not NULL and the node of the order is present with all requested tables.
+  /// 'nodes' can then be NULL, it is looked up only when needed.
+  Node** fixed_nodes;
+  unsigned int num_fixed_nodes;
+
   /// With changed sub-element mapping, there comes the need for a change of the current
   /// Node table nodes.
   void update_nodes_ptr()
@@ -296,6 +311,7 @@ protected:
 
   static int idx2mask[6][2];  ///< index to mask table
 
+  friend class PrecalcArena;
 };
 
 
@@ -324,6 +340,8 @@ Function<TYPE>::Function()
   sub_tables = NULL;
   nodes = NULL;
   overflow_nodes = NULL;
+  fixed_nodes = NULL;
+  num_fixed_nodes = 0;
   memset(quads, 0, sizeof(quads));
 }
 
@@ -0,0 +1,162 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "geom_cache.h"
+
+GeomCache::GeomCache()
+{
+  state = 0;
+  memory = 0;
+  memory_limit = 0;
+  hits = misses = evictions = 0;
+}
+
+GeomCache::~GeomCache()
+{
+  _F_
+  clear();
+}
+
+GeomCache::Entry* GeomCache::find(RefMap* rm, int order, int np, int num_arrays, bool& computed)
+{
+  Key key;
+  key.element = rm->get_active_element();
+  key.sub_idx = rm->get_transform();
+  key.order = order;
+
+  std::map<Key, Entry*>::iterator it = entries.find(key);
+  if (it != entries.end()) {
+    hits++;
+    Entry* entry = it->second;
+    entry->state = state;
+    lru.splice(lru.begin(), lru, entry->lru);
+    computed = true;
+    return entry;
+  }
+  misses++;
+
+  Entry* entry = new Entry;
+  MEM_CHECK(entry);
+  entry->key = key;
+  entry->data = new double[num_arrays * np];
+  MEM_CHECK(entry->data);
+  entry->size = sizeof(Entry) + num_arrays * np * sizeof(double);
+  entry->state = state;
+  lru.push_front(entry);
+  entry->lru = lru.begin();
+  entries[key] = entry;
+  memory += entry->size;
+
+  if (memory_limit > 0 && memory > memory_limit) evict();
+  computed = false;
+  return entry;
+}
+
+void GeomCache::get_vol(RefMap* rm, int order, Geom<double>*& e, double*& jwt)
+{
+  Quad2D* quad = rm->get_quad_2d();
+  int np = quad->get_num_points(order);
+  bool computed;
+  Entry* entry = find(rm, order, np, 3, computed);
+  e = &entry->e;
+  jwt = entry->jwt;
+  if (computed) return;
+
+  Element* element = rm->get_active_element();
+  e->diam = element->get_diameter();
+  e->id = element->id;
+  e->elem_marker = element->marker;
+  e->x = entry->data;
+  e->y = entry->data + np;
+  jwt = entry->jwt = entry->data + 2*np;
+  memcpy(e->x, rm->get_phys_x(order), np * sizeof(double));
+  memcpy(e->y, rm->get_phys_y(order), np * sizeof(double));
+
+  double3* pt = quad->get_points(order);
+  if (rm->is_jacobian_const()) {
+    double jac = rm->get_const_jacobian();
+    for (int i = 0; i < np; i++)
+      jwt[i] = pt[i][2] * jac;
+  }
+  else {
+    double* jac = rm->get_jacobian(order);
+    for (int i = 0; i < np; i++)
+      jwt[i] = pt[i][2] * jac[i];
+  }
+}
+
+void GeomCache::get_surf(RefMap* rm, SurfPos* surf_pos, int eo, Geom<double>*& e, double*& jwt)
+{
+  Quad2D* quad = rm->get_quad_2d();
+  int np = quad->get_num_points(eo);
+  bool computed;
+  Entry* entry = find(rm, eo, np, 7, computed);
+  e = &entry->e;
+  jwt = entry->jwt;
+  if (computed) return;
+
+  Element* element = rm->get_active_element();
+  e->edge_marker = surf_pos->marker;
+  e->elem_marker = element->marker;
+  e->diam = element->get_diameter();
+  e->id = element->en[surf_pos->surf_num]->id;
+  e->orientation = element->get_edge_orientation(surf_pos->surf_num);
+  e->x = entry->data;
+  e->y = entry->data + np;
+  jwt = entry->jwt = entry->data + 2*np;
+  e->tx = entry->data + 3*np;
+  e->ty = entry->data + 4*np;
+  e->nx = entry->data + 5*np;
+  e->ny = entry->data + 6*np;
+  memcpy(e->x, rm->get_phys_x(eo), np * sizeof(double));
+  memcpy(e->y, rm->get_phys_y(eo), np * sizeof(double));
+
+  double3* pt = quad->get_points(eo);
+  double3* tan = rm->get_tangent(surf_pos->surf_num, eo);
+  for (int i = 0; i < np; i++) {
+    jwt[i] = pt[i][2] * tan[i][2];
+    e->tx[i] = tan[i][0];  e->ty[i] =   tan[i][1];
+    e->nx[i] = tan[i][1];  e->ny[i] = - tan[i][0];
+  }
+}
+
+void GeomCache::evict()
+{
+  _F_
+  // The entries of the current state are at the beginning of the list.
+  while (memory > memory_limit && !lru.empty() && lru.back()->state != state) {
+    Entry* entry = lru.back();
+    lru.pop_back();
+    entries.erase(entry->key);
+    delete_entry(entry);
+    evictions++;
+  }
+}
+
+void GeomCache::delete_entry(Entry* entry)
+{
+  memory -= entry->size;
+  delete [] entry->data;
+  delete entry;
+}
+
+void GeomCache::clear()
+{
+  _F_
+  for (std::list<Entry*>::iterator it = lru.begin(); it != lru.end(); it++)
+    delete_entry(*it);
+  lru.clear();
+  entries.clear();
+}
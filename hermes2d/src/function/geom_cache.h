@@ -0,0 +1,100 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __H2D_GEOM_CACHE_H
+#define __H2D_GEOM_CACHE_H
+
+#include "forms.h"
+#include <list>
+
+/// Cache of the geometry of elements (see init_geom_vol() and init_geom_surf()) together with
+/// the jacobian*weights of the quadrature, used in assembling.
+///
+/// The entries are indexed by the element, the sub-element transformation and the order of
+/// the quadrature (the volumetric orders and the edge orders of Quad2D::get_edge_points() do
+/// not overlap). The arrays of an entry are stored in one block: x, y, jwt and for edges also
+/// tx, ty, nx, ny. The entries stay valid as long as the mesh of the elements does not change,
+/// the owner has to call clear() then. If the memory of the entries exceeds the limit, the
+/// least recently used ones are evicted, except for the ones used since the last call to
+/// new_state().
+class HERMES_API GeomCache
+{
+public:
+  GeomCache();
+  ~GeomCache();
+
+  /// Returns the geometry and the jacobian*weights of the volumetric quadrature of the order on
+  /// the active element of rm, they are computed if they are not cached.
+  void get_vol(RefMap* rm, int order, Geom<double>*& e, double*& jwt);
+  /// The same for the edge quadrature eo (see Quad2D::get_edge_points()) of surf_pos.
+  void get_surf(RefMap* rm, SurfPos* surf_pos, int eo, Geom<double>*& e, double*& jwt);
+
+  /// Marks the beginning of a new assembling state (element).
+  void new_state() { state++; }
+
+  /// Frees all entries.
+  void clear();
+
+  /// Memory limit of the entries in bytes (0 = no limit).
+  void set_memory_limit(size_t bytes) { memory_limit = bytes; }
+  size_t get_memory_limit() const { return memory_limit; }
+
+  /// Statistics.
+  unsigned long get_num_hits() const { return hits; }
+  unsigned long get_num_misses() const { return misses; }
+  unsigned long get_num_evictions() const { return evictions; }
+  size_t get_memory() const { return memory; }
+  int get_num_entries() const { return (int) entries.size(); }
+
+protected:
+  struct Key
+  {
+    Element* element;
+    uint64_t sub_idx;
+    int order;
+
+    bool operator<(const Key& other) const {
+      if (element != other.element) return element < other.element;
+      if (sub_idx != other.sub_idx) return sub_idx < other.sub_idx;
+      return order < other.order;
+    }
+  };
+
+  struct Entry
+  {
+    Key key;
+    Geom<double> e;
+    double* data;         ///< The arrays of e and jwt.
+    double* jwt;
+    size_t size;          ///< Memory of the entry in bytes.
+    unsigned int state;   ///< The last state in which the entry was used.
+    std::list<Entry*>::iterator lru;
+  };
+
+  std::map<Key, Entry*> entries;
+  std::list<Entry*> lru;  ///< The most recently used entries first.
+
+  unsigned int state;
+  size_t memory, memory_limit;
+  unsigned long hits, misses, evictions;
+
+  /// Returns the entry of the key, or a new entry with num_arrays arrays of np points if
+  /// it is not cached (in which case the entry is not filled in and computed is false).
+  Entry* find(RefMap* rm, int order, int np, int num_arrays, bool& computed);
+  void evict();
+  void delete_entry(Entry* entry);
+};
+
+#endif
@@ -0,0 +1,187 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "ref_matrices.h"
+#include "../shapeset/shapeset.h"
+#include "../quadrature/quad.h"
+#include "../quadrature/limit_order.h"
+
+RefMatrixCache::RefMatrixCache()
+{
+  hits = misses = 0;
+}
+
+RefMatrixCache::~RefMatrixCache()
+{
+  _F_
+  free();
+}
+
+void RefMatrixCache::free()
+{
+  _F_
+  for (std::map<std::pair<std::pair<int, int>, int>, Table*>::iterator it = tables.begin(); it != tables.end(); it++)
+    delete it->second;
+  tables.clear();
+}
+
+bool RefMatrixCache::is_supported(Shapeset* shapeset)
+{
+  ESpaceType type = shapeset->get_space_type();
+  return type == HERMES_H1_SPACE || type == HERMES_L2_SPACE || type == HERMES_HCURL_SPACE;
+}
+
+RefMatrixCache::Table* RefMatrixCache::get_table(int id_u, int id_v, int mode)
+{
+  std::pair<std::pair<int, int>, int> key(std::pair<int, int>(id_u, id_v), mode);
+  std::map<std::pair<std::pair<int, int>, int>, Table*>::iterator it = tables.find(key);
+  if (it != tables.end()) return it->second;
+  Table* table = new Table;
+  MEM_CHECK(table);
+  tables[key] = table;
+  return table;
+}
+
+int RefMatrixCache::get_slot(std::map<int, int>& slots, std::vector<int>& indices, int index)
+{
+  std::map<int, int>::iterator it = slots.find(index);
+  if (it != slots.end()) return it->second;
+  int slot = indices.size();
+  slots[index] = slot;
+  indices.push_back(index);
+  return slot;
+}
+
+void RefMatrixCache::get_quantities(Shapeset* shapeset, int index, double x, double y,
+                                    double q[H2D_NUM_REF_QUANTITIES])
+{
+  if (shapeset->get_num_components() == 1) {
+    q[0] = shapeset->get_fn_value(index, x, y, 0);
+    q[1] = shapeset->get_dx_value(index, x, y, 0);
+    q[2] = shapeset->get_dy_value(index, x, y, 0);
+  }
+  else {
+    q[0] = shapeset->get_dx_value(index, x, y, 1) - shapeset->get_dy_value(index, x, y, 0);
+    q[1] = shapeset->get_fn_value(index, x, y, 0);
+    q[2] = shapeset->get_fn_value(index, x, y, 1);
+  }
+}
+
+int RefMatrixCache::get_order(Shapeset* shapeset, int index)
+{
+  int o = shapeset->get_order(index);
+  o = std::max(H2D_GET_H_ORDER(o), H2D_GET_V_ORDER(o));
+  // Increase for vector-valued shape functions, as in DiscreteProblem.
+  if (shapeset->get_num_components() == 2) o++;
+  return o;
+}
+
+void RefMatrixCache::compute(Shapeset* shapeset_u, int iu, Shapeset* shapeset_v, int iv,
+                             Quad2D* quad, Entry& entry)
+{
+  misses++;
+  int order = (shapeset_u != NULL) ? get_order(shapeset_u, iu) : 0;
+  order += get_order(shapeset_v, iv);
+  limit_order_nowarn(order);
+
+  double3* pt = quad->get_points(order);
+  int np = quad->get_num_points(order);
+
+  memset(entry.r, 0, sizeof(entry.r));
+  for (int k = 0; k < np; k++) {
+    double qu[H2D_NUM_REF_QUANTITIES], qv[H2D_NUM_REF_QUANTITIES];
+    if (shapeset_u != NULL)
+      get_quantities(shapeset_u, iu, pt[k][0], pt[k][1], qu);
+    else
+      qu[0] = 1.0, qu[1] = qu[2] = 0.0;
+    get_quantities(shapeset_v, iv, pt[k][0], pt[k][1], qv);
+    for (int p = 0; p < H2D_NUM_REF_QUANTITIES; p++)
+      for (int q = 0; q < H2D_NUM_REF_QUANTITIES; q++)
+        entry.r[p][q] += pt[k][2] * qu[p] * qv[q];
+  }
+  entry.done = true;
+}
+
+void RefMatrixCache::combine(Shapeset* shapeset_u, AsmList* alu, Shapeset* shapeset_v, AsmList* alv,
+                             Quad2D* quad, scalar coeffs[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES],
+                             scalar** result)
+{
+  Table* table = get_table(shapeset_u->get_id(), shapeset_v->get_id(), shapeset_v->get_mode());
+
+  su.resize(alu->cnt);
+  for (unsigned int j = 0; j < alu->cnt; j++)
+    su[j] = get_slot(table->slot_u, table->index_u, alu->idx[j]);
+  sv.resize(alv->cnt);
+  for (unsigned int i = 0; i < alv->cnt; i++)
+    sv[i] = get_slot(table->slot_v, table->index_v, alv->idx[i]);
+
+  // Only the nonzero coefficients are combined.
+  int np = 0, pp[H2D_NUM_REF_QUANTITIES * H2D_NUM_REF_QUANTITIES], qq[H2D_NUM_REF_QUANTITIES * H2D_NUM_REF_QUANTITIES];
+  for (int p = 0; p < H2D_NUM_REF_QUANTITIES; p++)
+    for (int q = 0; q < H2D_NUM_REF_QUANTITIES; q++)
+      if (coeffs[p][q] != 0.0) {
+        pp[np] = p;
+        qq[np++] = q;
+      }
+
+  if (table->rows.size() < table->index_v.size())
+    table->rows.resize(table->index_v.size());
+  for (unsigned int i = 0; i < alv->cnt; i++) {
+    std::vector<Entry>& row = table->rows[sv[i]];
+    if (row.size() < table->index_u.size()) {
+      Entry empty;
+      empty.done = false;
+      row.resize(table->index_u.size(), empty);
+    }
+    for (unsigned int j = 0; j < alu->cnt; j++) {
+      Entry& entry = row[su[j]];
+      if (!entry.done)
+        compute(shapeset_u, alu->idx[j], shapeset_v, alv->idx[i], quad, entry);
+      else
+        hits++;
+      scalar value = 0.0;
+      for (int k = 0; k < np; k++)
+        value += coeffs[pp[k]][qq[k]] * entry.r[pp[k]][qq[k]];
+      result[i][j] = value;
+    }
+  }
+}
+
+void RefMatrixCache::combine(Shapeset* shapeset_v, AsmList* alv, Quad2D* quad,
+                             scalar coeffs[H2D_NUM_REF_QUANTITIES], scalar* result)
+{
+  // The vectors are stored as the first row of the matrices R_pq with u = 1.
+  Table* table = get_table(-1, shapeset_v->get_id(), shapeset_v->get_mode());
+
+  if (table->rows.empty()) table->rows.resize(1);
+  std::vector<Entry>& row = table->rows[0];
+  for (unsigned int i = 0; i < alv->cnt; i++) {
+    int slot = get_slot(table->slot_v, table->index_v, alv->idx[i]);
+    if (row.size() < table->index_v.size()) {
+      Entry empty;
+      empty.done = false;
+      row.resize(table->index_v.size(), empty);
+    }
+    Entry& entry = row[slot];
+    if (!entry.done)
+      compute(NULL, 0, shapeset_v, alv->idx[i], quad, entry);
+    else
+      hits++;
+    scalar value = 0.0;
+    for (int q = 0; q < H2D_NUM_REF_QUANTITIES; q++)
+      value += coeffs[q] * entry.r[0][q];
+    result[i] = value;
+  }
+}
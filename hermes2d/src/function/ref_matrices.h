@@ -0,0 +1,95 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __H2D_REF_MATRICES_H
+#define __H2D_REF_MATRICES_H
+
+#include "../h2d_common.h"
+#include "../asmlist.h"
+
+class Shapeset;
+class Quad2D;
+
+/// Number of the reference quantities Q_0, Q_1, Q_2 of a shape function: the value and the
+/// derivatives with respect to the two reference coordinates for scalar (H1, L2) shapesets,
+/// the curl and the two components for Hcurl shapesets.
+const int H2D_NUM_REF_QUANTITIES = 3;
+
+/// Reference matrices of shape functions, used to evaluate forms on elements with a constant
+/// jacobian without numerical quadrature (see WeakForm::MatrixFormVol::ref_coeffs()).
+///
+/// For a basis function u and a test function v, R_pq(u, v) is the integral of Q_p(u) Q_q(v)
+/// over the reference element, and for a test function v, r_q(v) is the integral of Q_q(v).
+/// The integrals depend only on the shape functions and the mode of the element, so they
+/// are computed by exact quadrature the first time a pair of functions is encountered and
+/// kept until free() is called.
+class HERMES_API RefMatrixCache
+{
+public:
+  RefMatrixCache();
+  ~RefMatrixCache();
+
+  /// Returns true if the reference quantities of the shapeset are defined.
+  static bool is_supported(Shapeset* shapeset);
+
+  /// Sets result[i][j] = sum_{p,q} coeffs[p][q] R_pq(u_j, v_i) for the basis functions u of
+  /// the assembly list alu and the test functions v of alv. The shapesets have to be in the
+  /// mode of the element and quad is the quadrature of the element (with the limit table of
+  /// limit_order() set for its mode).
+  void combine(Shapeset* shapeset_u, AsmList* alu, Shapeset* shapeset_v, AsmList* alv, Quad2D* quad,
+               scalar coeffs[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES], scalar** result);
+  /// Sets result[i] = sum_q coeffs[q] r_q(v_i) for the test functions v of alv.
+  void combine(Shapeset* shapeset_v, AsmList* alv, Quad2D* quad,
+               scalar coeffs[H2D_NUM_REF_QUANTITIES], scalar* result);
+
+  void free();
+
+  /// Statistics: number of pairs (or functions) found and computed.
+  unsigned long get_num_hits() const { return hits; }
+  unsigned long get_num_misses() const { return misses; }
+
+protected:
+  struct Entry
+  {
+    bool done;
+    double r[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES];
+  };
+
+  /// Integrals of the pairs of functions of two shapesets in one mode. The functions are
+  /// numbered in the order of their appearance (slots).
+  struct Table
+  {
+    std::map<int, int> slot_u, slot_v;    ///< Slot of a shape function index.
+    std::vector<int> index_u, index_v;    ///< Shape function index of a slot.
+    std::vector<std::vector<Entry> > rows;  ///< rows[slot_v][slot_u].
+  };
+  /// Tables indexed by the ids of the shapesets and the mode (the vectors r_q use
+  /// the id -1 for u).
+  std::map<std::pair<std::pair<int, int>, int>, Table*> tables;
+
+  unsigned long hits, misses;
+
+  /// Scratch space for the slots of the functions of an element.
+  std::vector<int> su, sv;
+
+  Table* get_table(int id_u, int id_v, int mode);
+  static int get_slot(std::map<int, int>& slots, std::vector<int>& indices, int index);
+  static void get_quantities(Shapeset* shapeset, int index, double x, double y,
+                             double q[H2D_NUM_REF_QUANTITIES]);
+  static int get_order(Shapeset* shapeset, int index);
+  void compute(Shapeset* shapeset_u, int iu, Shapeset* shapeset_v, int iv, Quad2D* quad, Entry& entry);
+};
+
+#endif
@@ -0,0 +1,122 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "refmap_cache.h"
+#include "../mesh/mesh.h"
+
+RefMapCache::RefMapCache(size_t memory_limit)
+{
+  mesh = NULL;
+  mesh_seq = 0;
+  memory = 0;
+  this->memory_limit = memory_limit;
+  hits = misses = evictions = 0;
+}
+
+RefMapCache::~RefMapCache()
+{
+  _F_
+  clear();
+}
+
+bool RefMapCache::same_element(Entry* entry, Element* e)
+{
+  for (unsigned int i = 0; i < e->nvert; i++)
+    if (entry->verts[i][0] != e->vn[i]->x || entry->verts[i][1] != e->vn[i]->y)
+      return false;
+  return true;
+}
+
+double2x2* RefMapCache::get(Mesh* mesh, Element* e, Quad2D* quad, uint64_t sub_idx, int order,
+                            int np, bool& computed)
+{
+  // the entries of another mesh or of a changed one are not valid
+  if (mesh != this->mesh || mesh->get_seq() != mesh_seq) {
+    clear();
+    this->mesh = mesh;
+    mesh_seq = mesh->get_seq();
+  }
+
+  Key key;
+  key.elem_id = e->id;
+  key.quad = quad;
+  key.sub_idx = sub_idx;
+  key.order = order;
+
+  std::map<Key, Entry*>::iterator it = entries.find(key);
+  if (it != entries.end()) {
+    Entry* entry = it->second;
+    if (same_element(entry, e)) {
+      hits++;
+      lru.splice(lru.begin(), lru, entry->lru);
+      computed = true;
+      return entry->data;
+    }
+    // the id belongs to another element now
+    lru.erase(entry->lru);
+    entries.erase(it);
+    delete_entry(entry);
+  }
+  misses++;
+
+  Entry* entry = new Entry;
+  MEM_CHECK(entry);
+  entry->key = key;
+  for (unsigned int i = 0; i < e->nvert; i++) {
+    entry->verts[i][0] = e->vn[i]->x;
+    entry->verts[i][1] = e->vn[i]->y;
+  }
+  entry->data = new double2x2[np];
+  MEM_CHECK(entry->data);
+  entry->size = sizeof(Entry) + np * sizeof(double2x2);
+  lru.push_front(entry);
+  entry->lru = lru.begin();
+  entries[key] = entry;
+  memory += entry->size;
+
+  if (memory_limit > 0 && memory > memory_limit) evict();
+  computed = false;
+  return entry->data;
+}
+
+void RefMapCache::evict()
+{
+  _F_
+  // the entry just added is at the beginning of the list and is kept
+  while (memory > memory_limit && lru.size() > 1) {
+    Entry* entry = lru.back();
+    lru.pop_back();
+    entries.erase(entry->key);
+    delete_entry(entry);
+    evictions++;
+  }
+}
+
+void RefMapCache::delete_entry(Entry* entry)
+{
+  memory -= entry->size;
+  delete [] entry->data;
+  delete entry;
+}
+
+void RefMapCache::clear()
+{
+  _F_
+  for (std::list<Entry*>::iterator it = lru.begin(); it != lru.end(); it++)
+    delete_entry(*it);
+  lru.clear();
+  entries.clear();
+  mesh = NULL;
+}
@@ -0,0 +1,101 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __H2D_REFMAP_CACHE_H
+#define __H2D_REFMAP_CACHE_H
+
+#include "../h2d_common.h"
+#include <list>
+
+class Mesh;
+class Element;
+class Quad2D;
+
+/// Cache of the inverse reference mappings of the elements with non-constant jacobians in the
+/// points of the quadratures, used by a Solution to transform its derivatives or values (see
+/// Solution::set_refmap_cache()).
+///
+/// The mappings do not depend on the coefficients of the solution, so they stay valid when the
+/// solution is set again on the same mesh (the previous time level, the iterates of the
+/// Newton's method), while the RefMap calculates them again for every element it is set to.
+/// The entries are indexed by the element, the quadrature, the sub-element transformation and
+/// the order of the quadrature. They are dropped when the mesh changes and recalculated when
+/// the vertices of the element differ (the ids of the elements are reused). If the memory of
+/// the entries exceeds the limit, the least recently used ones are evicted.
+class HERMES_API RefMapCache
+{
+public:
+  RefMapCache(size_t memory_limit = 0);
+  ~RefMapCache();
+
+  /// Returns the inverse reference mappings of the element e of the mesh in the np points of
+  /// the quadrature of the order. Sets computed = false if they have to be filled by the caller.
+  double2x2* get(Mesh* mesh, Element* e, Quad2D* quad, uint64_t sub_idx, int order, int np,
+                 bool& computed);
+
+  /// Frees all entries.
+  void clear();
+
+  /// Memory limit of the entries in bytes (0 = no limit).
+  void set_memory_limit(size_t bytes) { memory_limit = bytes; }
+  size_t get_memory_limit() const { return memory_limit; }
+
+  /// Statistics.
+  unsigned long get_num_hits() const { return hits; }
+  unsigned long get_num_misses() const { return misses; }
+  unsigned long get_num_evictions() const { return evictions; }
+  size_t get_memory() const { return memory; }
+  int get_num_entries() const { return (int) entries.size(); }
+
+protected:
+  struct Key
+  {
+    int elem_id;
+    Quad2D* quad;
+    uint64_t sub_idx;
+    int order;
+
+    bool operator<(const Key& other) const {
+      if (elem_id != other.elem_id) return elem_id < other.elem_id;
+      if (sub_idx != other.sub_idx) return sub_idx < other.sub_idx;
+      if (quad != other.quad) return quad < other.quad;
+      return order < other.order;
+    }
+  };
+
+  struct Entry
+  {
+    Key key;
+    double2 verts[4];     ///< Vertices of the element.
+    double2x2* data;
+    size_t size;          ///< Memory of the entry in bytes.
+    std::list<Entry*>::iterator lru;
+  };
+
+  std::map<Key, Entry*> entries;
+  std::list<Entry*> lru;  ///< The most recently used entries first.
+
+  Mesh* mesh;             ///< The mesh and its sequence number of the entries.
+  unsigned mesh_seq;
+
+  size_t memory, memory_limit;
+  unsigned long hits, misses, evictions;
+
+  static bool same_element(Entry* entry, Element* e);
+  void evict();
+  void delete_entry(Entry* entry);
+};
+
+#endif
@@ -18,6 +18,7 @@
 #include "../../../hermes_common/matrix.h"
 #include "../shapeset/precalc.h"
 #include "../mesh/refmap.h"
+#include "../mesh/mesh_index.h"
 
 //// MeshFunction //////////////////////////////////////////////////////////////////////////////////
 
@@ -91,19 +92,11 @@ void MeshFunction::pop_transform()
 
 //// Quad2DCheb ////////////////////////////////////////////////////////////////////////////////////
 
-static double3* cheb_tab_tri[11];
-static double3* cheb_tab_quad[11];
-static int      cheb_np_tri[11];
-static int      cheb_np_quad[11];
-
-static double3** cheb_tab[2] = { cheb_tab_tri, cheb_tab_quad };
-static int*      cheb_np[2]  = { cheb_np_tri,  cheb_np_quad  };
-
 /// Quad2DCheb is a special "quadrature" consisting of product Chebyshev
 /// points on the reference triangle and quad. It is used for expressing
 /// the solution on an element as a linear combination of monomials.
 ///
-static class Quad2DCheb : public Quad2D
+class Quad2DCheb : public Quad2D
 {
 public:
 
@@ -112,6 +105,8 @@ public:
     mode = HERMES_MODE_TRIANGLE;
     max_order[0]  = max_order[1]  = 10;
     num_tables[0] = num_tables[1] = 11;
+    cheb_tab[0] = cheb_tab_tri;  cheb_tab[1] = cheb_tab_quad;
+    cheb_np[0]  = cheb_np_tri;   cheb_np[1]  = cheb_np_quad;
     tables = cheb_tab;
     np = cheb_np;
 
@@ -140,13 +135,25 @@ public:
   ~Quad2DCheb()
   {
     for (int mode = 0; mode <= 1; mode++)
-      for (int k = 1; k <= 10; k++)
+      for (int k = 0; k <= 10; k++)
         delete[] tables[mode][k];
   }
 
   virtual void dummy_fn() {}
 
-} g_quad_2d_cheb;
+protected:
+
+  double3* cheb_tab_tri[11];
+  double3* cheb_tab_quad[11];
+  int      cheb_np_tri[11];
+  int      cheb_np_quad[11];
+
+  double3** cheb_tab[2];
+  int*      cheb_np[2];
+};
+
+// Quad2D keeps the current element mode, every thread needs its own instance.
+static ThreadLocalInstance<Quad2DCheb> quad_2d_cheb_instances = H2D_THREAD_LOCAL_INSTANCE_INIT;
 
 
 //// Solution //////////////////////////////////////////////////////////////////////////////////////
@@ -191,6 +198,7 @@ void Solution::init()
   num_components = 0;
   e_last = NULL;
   exact_mult = 1.0;
+  refmap_cache = NULL;
 
   for(int i = 0; i < 4; i++)
     for(int j = 0; j < 4; j++)
@@ -201,6 +209,12 @@ void Solution::init()
   elem_orders = NULL;
   dxdy_buffer = NULL;
   num_coefs = num_elems = 0;
+
+  sln_pss = NULL;
+  elem_fns = fn_idx = NULL;
+  fn_coefs = NULL;
+  fn_capacity = 0;
+  own_fn_tables = true;
   num_dofs = -1;
 
   set_quad_2d(&g_quad_2d_std);
@@ -288,6 +302,8 @@ void Solution::assign(Solution* sln)
 void Solution::copy(const Solution* sln)
 {
   if (sln->sln_type == HERMES_UNDEF) error("Solution being copied is uninitialized.");
+  if (sln->sln_type == HERMES_SLN_DIRECT)
+    error("A solution set by set_coeff_vector_direct() can not be copied, use vector_to_solution().");
 
   free();
 
@@ -350,6 +366,12 @@ void Solution::free_tables()
 
 void Solution::free()
 {
+  // Tables shared by share_coeff_vector_direct() are freed by their owner.
+  if (!own_fn_tables) {
+    elem_orders = elem_fns = fn_idx = NULL;
+    fn_coefs = NULL;
+    own_fn_tables = true;
+  }
   if (mono_coefs  != NULL) { delete [] mono_coefs;   mono_coefs = NULL;  }
   if (elem_orders != NULL) { delete [] elem_orders;  elem_orders = NULL; }
   if (dxdy_buffer != NULL) { delete [] dxdy_buffer;  dxdy_buffer = NULL; }
@@ -358,9 +380,16 @@ void Solution::free()
     if (elem_coefs[i] != NULL)
       { delete [] elem_coefs[i];  elem_coefs[i] = NULL; }
 
+  if (sln_pss  != NULL) { delete sln_pss;       sln_pss = NULL;  }
+  if (elem_fns != NULL) { delete [] elem_fns;   elem_fns = NULL; }
+  if (fn_idx   != NULL) { delete [] fn_idx;     fn_idx = NULL;   }
+  if (fn_coefs != NULL) { delete [] fn_coefs;   fn_coefs = NULL; }
+  fn_capacity = 0;
+
   if (own_mesh == true && mesh != NULL)
   {
     //printf("Deleting mesh in Solution (own_mesh == true).\n");
+    if (refmap_cache != NULL) refmap_cache->clear();
     delete mesh;
     own_mesh = false;
   }
@@ -374,6 +403,7 @@ void Solution::free()
 Solution::~Solution()
 {
   free();
+  if (refmap_cache != NULL) delete refmap_cache;
   space_type = HERMES_INVALID_SPACE;
 }
 
@@ -387,10 +417,13 @@ public:
   // this is a set of LU-decomposed matrices shared by all Solutions
   double** mat[2][11];
   int* perm[2][11];
+  // protects the lazy calculation of the matrices
+  pthread_mutex_t mutex;
 
   mono_lu_init()
   {
     memset(mat, 0, sizeof(mat));
+    pthread_mutex_init(&mutex, NULL);
   }
 
   ~mono_lu_init()
@@ -401,6 +434,7 @@ public:
           delete [] mat[m][i];
           delete [] perm[m][i];
         }
+    pthread_mutex_destroy(&mutex);
   }
 }
 mono_lu;
@@ -530,7 +564,7 @@ void Solution::set_coeff_vector(Space* space, PrecalcShapeset* pss, scalar* coef
   mono_coefs = new scalar[num_coefs];
 
   // express the solution on elements as a linear combination of monomials
-  Quad2D* quad = &g_quad_2d_cheb;
+  Quad2D* quad = quad_2d_cheb_instances.get();
   pss->set_quad_2d(quad);
   scalar* mono = mono_coefs;
   for_all_active_elements(e, mesh)
@@ -564,8 +598,10 @@ void Solution::set_coeff_vector(Space* space, PrecalcShapeset* pss, scalar* coef
       mono += np;
 
       // solve for the monomial coefficients
+      pthread_mutex_lock(&mono_lu.mutex);
       if (mono_lu.mat[mode][o] == NULL)
         mono_lu.mat[mode][o] = calc_mono_matrix(o, mono_lu.perm[mode][o]);
+      pthread_mutex_unlock(&mono_lu.mutex);
       lubksb(mono_lu.mat[mode][o], np, mono_lu.perm[mode][o], val);
     }
   }
@@ -575,6 +611,150 @@ void Solution::set_coeff_vector(Space* space, PrecalcShapeset* pss, scalar* coef
   element = NULL;
 }
 
+// using the shape functions directly
+void Solution::set_coeff_vector_direct(Space* space, PrecalcShapeset* pss, scalar* coeffs, bool add_dir_lift)
+{
+  // some sanity checks
+  if (space == NULL) error("Space == NULL in Solution::set_coeff_vector_direct().");
+  if (space->get_mesh() == NULL) error("Mesh == NULL in Solution::set_coeff_vector_direct().");
+  if (pss == NULL) error("PrecalcShapeset == NULL in Solution::set_coeff_vector_direct().");
+  if (coeffs == NULL) error("Coefficient vector == NULL in Solution::set_coeff_vector_direct().");
+  if (!space->is_up_to_date())
+    error("Provided 'space' is not up to date.");
+  // The pss may use a copy of the shapeset of the space (as in threaded assembling).
+  if (space->get_shapeset()->get_id() != pss->get_shapeset()->get_id())
+    error("Provided 'space' and 'pss' must have the same shapesets.");
+
+  // Keep the arrays of the previous call (unless they were shared), free the rest.
+  if (!own_fn_tables) {
+    elem_orders = elem_fns = fn_idx = NULL;
+    fn_coefs = NULL;
+    fn_capacity = 0;
+    own_fn_tables = true;
+  }
+  bool reuse = (sln_type == HERMES_SLN_DIRECT && elem_orders != NULL
+                && num_elems == space->get_mesh()->get_max_element_id());
+  int* orders = elem_orders;   elem_orders = NULL;
+  int* fns = elem_fns;         elem_fns = NULL;
+  int* idx = fn_idx;           fn_idx = NULL;
+  scalar* coefs = fn_coefs;    fn_coefs = NULL;
+  int capacity = fn_capacity;
+  PrecalcShapeset* old_pss = sln_pss;  sln_pss = NULL;
+  free();
+
+  space_type = space->get_type();
+  num_components = pss->get_num_components();
+  sln_type = HERMES_SLN_DIRECT;
+  num_dofs = space->get_num_dofs();
+  mesh = space->get_mesh();
+
+  PrecalcShapeset* master = pss->is_slave() ? pss->master_pss : pss;
+  if (old_pss != NULL && old_pss->master_pss == master)
+    sln_pss = old_pss;
+  else {
+    delete old_pss;
+    sln_pss = new PrecalcShapeset(master);
+    MEM_CHECK(sln_pss);
+  }
+
+  if (!reuse) {
+    delete [] orders;
+    delete [] fns;
+    num_elems = mesh->get_max_element_id();
+    orders = new int[num_elems];
+    fns = new int[num_elems + 1];
+  }
+  elem_orders = orders;
+  elem_fns = fns;
+  fn_idx = idx;
+  fn_coefs = coefs;
+  fn_capacity = capacity;
+
+  // Store the shape functions of the elements with the coefficients from the vector.
+  AsmList al;
+  int n = 0;
+  double dir_lift_coeff = add_dir_lift ? 1.0 : 0.0;
+  for (int id = 0; id < num_elems; id++)
+  {
+    elem_fns[id] = n;
+    elem_orders[id] = 0;
+    Element* e = mesh->get_element_fast(id);
+    if (!e->used || !e->active) continue;
+
+    int o = space->get_element_order(e->id);
+    o = std::max(H2D_GET_H_ORDER(o), H2D_GET_V_ORDER(o));
+    for (unsigned int k = 0; k < e->nvert; k++) {
+      int eo = space->get_edge_order(e, k);
+      if (eo > o) o = eo;
+    }
+    // Hcurl: actual order of functions is one higher than element order
+    if ((space->get_shapeset())->get_num_components() == 2) o++;
+    elem_orders[id] = o;
+
+    space->get_element_assembly_list(e, &al);
+    if (n + (int) al.cnt > fn_capacity) {
+      fn_capacity = std::max(2 * fn_capacity, n + (int) al.cnt);
+      int* new_idx = new int[fn_capacity];
+      scalar* new_coefs = new scalar[fn_capacity];
+      if (n > 0) {
+        memcpy(new_idx, fn_idx, n * sizeof(int));
+        memcpy(new_coefs, fn_coefs, n * sizeof(scalar));
+      }
+      delete [] fn_idx;
+      delete [] fn_coefs;
+      fn_idx = new_idx;
+      fn_coefs = new_coefs;
+    }
+    for (unsigned int k = 0; k < al.cnt; k++) {
+      int dof = al.dof[k];
+      fn_idx[n] = al.idx[k];
+      fn_coefs[n++] = al.coef[k] * (dof >= 0 ? coeffs[dof] : dir_lift_coeff);
+    }
+  }
+  elem_fns[num_elems] = n;
+  num_coefs = n;
+
+  element = NULL;
+}
+
+void Solution::share_coeff_vector_direct(Solution* sln, PrecalcShapeset* pss)
+{
+  if (sln == NULL || sln->sln_type != HERMES_SLN_DIRECT)
+    error("Solution::share_coeff_vector_direct() needs a solution set by set_coeff_vector_direct().");
+  if (pss == NULL) error("PrecalcShapeset == NULL in Solution::share_coeff_vector_direct().");
+  if (sln->sln_pss->get_shapeset()->get_id() != pss->get_shapeset()->get_id())
+    error("The solution and 'pss' must have the same shapesets.");
+
+  PrecalcShapeset* old_pss = sln_pss;  sln_pss = NULL;
+  free();
+
+  space_type = sln->space_type;
+  num_components = sln->num_components;
+  sln_type = HERMES_SLN_DIRECT;
+  num_dofs = sln->num_dofs;
+  mesh = sln->mesh;
+
+  PrecalcShapeset* master = pss->is_slave() ? pss->master_pss : pss;
+  if (old_pss != NULL && old_pss->master_pss == master)
+    sln_pss = old_pss;
+  else {
+    delete old_pss;
+    sln_pss = new PrecalcShapeset(master);
+    MEM_CHECK(sln_pss);
+  }
+
+  num_elems = sln->num_elems;
+  num_coefs = sln->num_coefs;
+  elem_orders = sln->elem_orders;
+  elem_fns = sln->elem_fns;
+  fn_idx = sln->fn_idx;
+  fn_coefs = sln->fn_coefs;
+  fn_capacity = 0;
+  own_fn_tables = false;
+
+  element = NULL;
+}
+
 void Solution::set_const(Mesh* mesh, scalar c)
 {
   free();
@@ -722,6 +902,34 @@ void Solution::enable_transform(bool enable)
 }
 
 
+void Solution::set_refmap_cache(bool enable, size_t memory_limit)
+{
+  if (!enable) {
+    if (refmap_cache != NULL) { delete refmap_cache;  refmap_cache = NULL; }
+    return;
+  }
+  if (refmap_cache == NULL) {
+    refmap_cache = new RefMapCache(memory_limit);
+    MEM_CHECK(refmap_cache);
+  }
+  else
+    refmap_cache->set_memory_limit(memory_limit);
+}
+
+
+void Solution::get_refmap_cache_stats(unsigned long& hits, unsigned long& misses, unsigned long& evictions,
+                                      size_t& memory)
+{
+  hits = misses = evictions = 0;
+  memory = 0;
+  if (refmap_cache == NULL) return;
+  hits = refmap_cache->get_num_hits();
+  misses = refmap_cache->get_num_misses();
+  evictions = refmap_cache->get_num_evictions();
+  memory = refmap_cache->get_memory();
+}
+
+
 void Solution::multiply(scalar coef)
 {
   if (sln_type == HERMES_SLN)
@@ -729,6 +937,11 @@ void Solution::multiply(scalar coef)
     for (int i = 0; i < num_coefs; i++)
       mono_coefs[i] *= coef;
   }
+  else if (sln_type == HERMES_SLN_DIRECT)
+  {
+    for (int i = 0; i < num_coefs; i++)
+      fn_coefs[i] *= coef;
+  }
   else if (sln_type == HERMES_CONST)
   {
     cnst[0] *= coef;
@@ -840,6 +1053,10 @@ void Solution::set_active_element(Element* e)
       make_dx_coefs(mode, o, dxdy_coefs[i][2], dxdy_coefs[i][5] = dxdy_buffer+m);  m += n;
     }
   }
+  else if (sln_type == HERMES_SLN_DIRECT)
+  {
+    order = elem_orders[element->id];
+  }
   else if (sln_type == HERMES_EXACT)
   {
     order = 20; // fixme
@@ -859,25 +1076,51 @@ void Solution::set_active_element(Element* e)
 
 //// precalculate //////////////////////////////////////////////////////////////////////////////////
 
-// sets all elements of y[] to num
-static inline void set_vec_num(int n, scalar* y, scalar num)
+// Evaluates the polynomials of the order o with the monomial coefficients mono[s] (see the
+// top of the file) by Horner's scheme in the points pt transformed by ctm, result[s][i] for
+// s = 0, ..., ns-1. The points are processed in blocks for all the polynomials at once, so
+// that the block stays in the cache and the loops over it are vectorized.
+static void eval_horner(int mode, int o, int ns, scalar** mono, int np, double3* pt, Trf* ctm,
+                        scalar** result)
 {
-  for (int i = 0; i < n; i++)
-    y[i] = num;
-}
+  const int BLOCK = 64;
+  double x[BLOCK], y[BLOCK];
+  scalar tx[BLOCK];
 
-// y = y .* x + num
-static inline void vec_x_vec_p_num(int n, scalar* y, scalar* x, scalar num)
-{
-  for (int i = 0; i < n; i++)
-    y[i] = y[i]*x[i] + num;
-}
+  for (int p0 = 0; p0 < np; p0 += BLOCK)
+  {
+    int nb = std::min(BLOCK, np - p0);
+    for (int p = 0; p < nb; p++)
+    {
+      x[p] = pt[p0 + p][0] * ctm->m[0] + ctm->t[0];
+      y[p] = pt[p0 + p][1] * ctm->m[1] + ctm->t[1];
+    }
 
-// y = y .* x + z
-static inline void vec_x_vec_p_vec(int n, scalar* y, scalar* x, scalar* z)
-{
-  for (int i = 0; i < n; i++)
-    y[i] = y[i]*x[i] + z[i];
+    for (int s = 0; s < ns; s++)
+    {
+      scalar* c = mono[s];
+      scalar* r = result[s] + p0;
+      for (int i = 0; i <= o; i++)
+      {
+        scalar c0 = *c++;
+        for (int p = 0; p < nb; p++)
+          tx[p] = c0;
+        for (int j = 1; j <= (mode ? o : i); j++)
+        {
+          scalar cj = *c++;
+          for (int p = 0; p < nb; p++)
+            tx[p] = tx[p] * x[p] + cj;
+        }
+
+        if (!i)
+          for (int p = 0; p < nb; p++)
+            r[p] = tx[p];
+        else
+          for (int p = 0; p < nb; p++)
+            r[p] = r[p] * y[p] + tx[p];
+      }
+    }
+  }
 }
 
 
@@ -886,6 +1129,23 @@ static const int H2D_SECOND = H2D_FN_DXX_0 | H2D_FN_DXY_0 | H2D_FN_DYY_0;
 static const int H2D_CURL = H2D_FN_DX | H2D_FN_DY;
 
 
+double2x2* Solution::get_inv_ref_map(int order, int np, int& mstep)
+{
+  update_refmap();
+  if (refmap->is_jacobian_const()) {
+    mstep = 0;
+    return refmap->get_const_inv_ref_map();
+  }
+  mstep = 1;
+  if (refmap_cache == NULL) return refmap->get_inv_ref_map(order);
+
+  bool computed;
+  double2x2* mat = refmap_cache->get(mesh, element, quads[cur_quad], sub_idx, order, np, computed);
+  if (!computed) memcpy(mat, refmap->get_inv_ref_map(order), np * sizeof(double2x2));
+  return mat;
+}
+
+
 void Solution::transform_values(int order, Node* node, int newmask, int oldmask, int np)
 {
   double2x2 *mat, *m;
@@ -917,9 +1177,7 @@ void Solution::transform_values(int order, Node* node, int newmask, int oldmask,
 #endif
     if ((newmask & H2D_GRAD) == H2D_GRAD && (oldmask & H2D_GRAD) != H2D_GRAD)
     {
-      update_refmap();
-      mat = refmap->get_const_inv_ref_map();
-      if (!refmap->is_jacobian_const()) { mat = refmap->get_inv_ref_map(order); mstep = 1; }
+      mat = get_inv_ref_map(order, np, mstep);
 
       for (i = 0, m = mat; i < np; i++, m += mstep)
       {
@@ -940,9 +1198,7 @@ void Solution::transform_values(int order, Node* node, int newmask, int oldmask,
 
     if (trans_val || trans_curl)
     {
-      update_refmap();
-      mat = refmap->get_const_inv_ref_map();
-      if (!refmap->is_jacobian_const()) { mat = refmap->get_inv_ref_map(order); mstep = 1; }
+      mat = get_inv_ref_map(order, np, mstep);
 
       for (i = 0, m = mat; i < np; i++, m += mstep)
       {
@@ -969,9 +1225,7 @@ void Solution::transform_values(int order, Node* node, int newmask, int oldmask,
   {
     if ((newmask & H2D_FN_VAL) == H2D_FN_VAL && (oldmask & H2D_FN_VAL) != H2D_FN_VAL)
     {
-      update_refmap();
-      mat = refmap->get_const_inv_ref_map();
-      if (!refmap->is_jacobian_const()) { mat = refmap->get_inv_ref_map(order); mstep = 1; }
+      mat = get_inv_ref_map(order, np, mstep);
 
       for (i = 0, m = mat; i < np; i++, m += mstep)
       {
@@ -988,7 +1242,7 @@ int Solution::get_edge_fn_order(int edge, Space* space, Element* e)
 {
   if (e == NULL) e = element;
 
-  if (sln_type == HERMES_SLN && space != NULL) {
+  if ((sln_type == HERMES_SLN || sln_type == HERMES_SLN_DIRECT) && space != NULL) {
     return space->get_edge_order(e, edge);
   } else {
     return ScalarFunction::get_edge_fn_order(edge);
@@ -1005,7 +1259,7 @@ void Solution::precalculate(int order, int mask)
   H2D_CHECK_ORDER(quad, order);
   int np = quad->get_num_points(order);
 
-  if (sln_type == HERMES_SLN)
+  if (sln_type == HERMES_SLN || sln_type == HERMES_SLN_DIRECT)
   {
     // if we are required to transform vectors, we must precalculate both their components
     const int H2D_GRAD = H2D_FN_DX_0 | H2D_FN_DY_0;
@@ -1029,53 +1283,76 @@ void Solution::precalculate(int order, int mask)
     int newmask = mask | oldmask;
     node = new_node(newmask, np);
 
-    // transform integration points by the current matrix
-    scalar* x = new scalar[np];
-    scalar* y = new scalar[np];
-    scalar* tx = new scalar[np];
-    double3* pt = quad->get_points(order);
-    for (i = 0; i < np; i++)
+    if (sln_type == HERMES_SLN_DIRECT)
     {
-      x[i] = pt[i][0] * ctm->m[0] + ctm->t[0];
-      y[i] = pt[i][1] * ctm->m[1] + ctm->t[1];
-    }
+      // sum the values of the shape functions of the element
+      int sum_mask = 0;
+      for (l = 0; l < num_components; l++)
+        for (k = 0; k < 6; k++)
+          if (newmask & idx2mask[k][l])
+          {
+            if (oldmask & idx2mask[k][l])
+              memcpy(node->values[l][k], cur_node->values[l][k], np * sizeof(scalar));
+            else
+            {
+              memset(node->values[l][k], 0, np * sizeof(scalar));
+              sum_mask |= idx2mask[k][l];
+            }
+          }
 
-    // obtain the solution values, this is the core of the whole module
-    int o = elem_orders[element->id];
-    for (l = 0; l < num_components; l++)
+      if (sum_mask != 0)
+      {
+        if (sln_pss->get_quad_2d() != quad) sln_pss->set_quad_2d(quad);
+        sln_pss->set_active_element(element);
+        sln_pss->force_transform(sub_idx, ctm);
+        for (j = elem_fns[element->id]; j < elem_fns[element->id + 1]; j++)
+        {
+          scalar coef = fn_coefs[j];
+          if (coef == 0.0) continue;
+          sln_pss->set_active_shape(fn_idx[j]);
+          sln_pss->set_quad_order(order, sum_mask);
+          for (l = 0; l < num_components; l++)
+            for (k = 0; k < 6; k++)
+              if (sum_mask & idx2mask[k][l])
+              {
+                scalar* result = node->values[l][k];
+                double* shape = sln_pss->get_values(l, k);
+                for (i = 0; i < np; i++)
+                  result[i] += coef * shape[i];
+              }
+        }
+      }
+    }
+    else
     {
-      for (k = 0; k < 6; k++)
+      // obtain the solution values, this is the core of the whole module
+      int o = elem_orders[element->id];
+      scalar* mono[2*6];
+      scalar* result[2*6];
+      int ns = 0;
+      for (l = 0; l < num_components; l++)
       {
-        if (newmask & idx2mask[k][l])
+        for (k = 0; k < 6; k++)
         {
-          scalar* result = node->values[l][k];
-          if (oldmask & idx2mask[k][l])
-          {
-            // copy the old table if we have it already
-            memcpy(result, cur_node->values[l][k], np * sizeof(scalar));
-          }
-          else
+          if (newmask & idx2mask[k][l])
           {
-            // calculate the solution values using Horner's scheme
-            scalar* mono = dxdy_coefs[l][k];
-            for (i = 0; i <= o; i++)
+            if (oldmask & idx2mask[k][l])
             {
-              set_vec_num(np, tx, *mono++);
-              for (j = 1; j <= (mode ? o : i); j++)
-                vec_x_vec_p_num(np, tx, x, *mono++);
-
-              if (!i) memcpy(result, tx, sizeof(scalar)*np);
-                 else vec_x_vec_p_vec(np, result, y, tx);
+              // copy the old table if we have it already
+              memcpy(node->values[l][k], cur_node->values[l][k], np * sizeof(scalar));
+            }
+            else
+            {
+              mono[ns] = dxdy_coefs[l][k];
+              result[ns++] = node->values[l][k];
             }
           }
         }
       }
+      if (ns > 0)
+        eval_horner(mode, o, ns, mono, np, quad->get_points(order), ctm, result);
     }
 
-    delete [] x;
-    delete [] y;
-    delete [] tx;
-
     // transform gradient or vector solution, if required
     if (transform)
       transform_values(order, node, newmask, oldmask, np);
@@ -1175,6 +1452,7 @@ void Solution::save(const char* filename, bool compress)
 
   if (sln_type == HERMES_EXACT) error("Exact solution cannot be saved to a file.");
   if (sln_type == HERMES_CONST)  error("Constant solution cannot be saved to a file.");
+  if (sln_type == HERMES_SLN_DIRECT) error("Solution set by set_coeff_vector_direct() cannot be saved to a file.");
   if (sln_type == HERMES_UNDEF) error("Cannot save -- uninitialized solution.");
 
   // open the stream
@@ -1328,6 +1606,16 @@ scalar Solution::get_ref_value(Element* e, double xi1, double xi2, int component
 {
   set_active_element(e);
 
+  if (sln_type == HERMES_SLN_DIRECT)
+  {
+    Shapeset* shapeset = sln_pss->get_shapeset();
+    shapeset->set_mode(e->get_mode());
+    scalar result = 0.0;
+    for (int i = elem_fns[e->id]; i < elem_fns[e->id + 1]; i++)
+      result += fn_coefs[i] * shapeset->get_value(item, fn_idx[i], xi1, xi2, component);
+    return result;
+  }
+
   int o = elem_orders[e->id];
   scalar* mono = dxdy_coefs[component][item];
   scalar result = 0.0;
@@ -1343,16 +1631,6 @@ scalar Solution::get_ref_value(Element* e, double xi1, double xi2, int component
 }
 
 
-static inline bool is_in_ref_domain(Element* e, double xi1, double xi2)
-{
-  const double TOL = 1e-11;
-  if (e->is_triangle())
-    return (xi1 + xi2 <= TOL) && (xi1 + 1.0 >= -TOL) && (xi2 + 1.0 >= -TOL);
-  else
-    return (xi1 - 1.0 <= TOL) && (xi1 + 1.0 >= -TOL) && (xi2 - 1.0 <= TOL) && (xi2 + 1.0 >= -TOL);
-}
-
-
 scalar Solution::get_ref_value_transformed(Element* e, double xi1, double xi2, int a, int b)
 {
 
@@ -1447,7 +1725,7 @@ scalar Solution::get_pt_value(double x, double y, int item)
       {
         refmap->set_active_element(elem[i]);
         refmap->untransform(elem[i], x, y, xi1, xi2);
-        if (is_in_ref_domain(elem[i], xi1, xi2))
+        if (MeshIndex::is_in_ref_domain(elem[i], xi1, xi2))
         {
           e_last = elem[i];
           return get_ref_value_transformed(elem[i], xi1, xi2, a, b);
@@ -1455,17 +1733,12 @@ scalar Solution::get_pt_value(double x, double y, int item)
       }
   }
 
-  // go through all elements
-  Element *e;
-  for_all_active_elements(e, mesh)
+  // locate the point by the spatial index of the mesh
+  Element* e = mesh->get_element_at(x, y, xi1, xi2, refmap);
+  if (e != NULL)
   {
-    refmap->set_active_element(e);
-    refmap->untransform(e, x, y, xi1, xi2);
-    if (is_in_ref_domain(e, xi1, xi2))
-    {
-      e_last = e;
-      return get_ref_value_transformed(e, xi1, xi2, a, b);
-    }
+    e_last = e;
+    return get_ref_value_transformed(e, xi1, xi2, a, b);
   }
 
   warn("Point (%g, %g) does not lie in any element.", x, y);
@@ -19,6 +19,7 @@
 #include "../function/function.h"
 #include "../space/space.h"
 #include "../mesh/refmap.h"
+#include "../function/refmap_cache.h"
 #include "../../../hermes_common/matrix.h"
 
 class PrecalcShapeset;
@@ -130,6 +131,17 @@ public:
   /// mapping matrix. The default is enabled (true).
   void enable_transform(bool enable = true);
 
+  /// Keeps the inverse reference mappings of the elements with non-constant jacobians in the
+  /// points of the quadratures (see RefMapCache), used to transform the derivatives or the
+  /// values of the solution. The cache is kept when the solution is set again on the same
+  /// mesh, e.g. to the next iterate of the Newton's method or to the next time level. The
+  /// memory is limited in bytes (0 = no limit). Off by default.
+  void set_refmap_cache(bool enable, size_t memory_limit = 64 << 20);
+
+  /// Statistics of the cached mappings (zeros if the cache is off).
+  void get_refmap_cache_stats(unsigned long& hits, unsigned long& misses, unsigned long& evictions,
+                              size_t& memory);
+
   /// Saves the complete solution (i.e., including the internal copy of the mesh and
   /// element orders) to a binary file. On Linux, if `compress` is true, the file is
   /// compressed with gzip and a ".gz" suffix added to the file name.
@@ -155,9 +167,10 @@ public:
 
   /// Returns solution value or derivatives at the physical domain point (x, y).
   /// 'item' controls the returned value: H2D_FN_VAL_0, H2D_FN_VAL_1, H2D_FN_DX_0, H2D_FN_DX_1, H2D_FN_DY_0,....
+  /// The element is searched among the neighbours of the last one found and then by the
+  /// spatial index of the mesh (see Mesh::get_element_at()).
   /// NOTE: This function should be used for postprocessing only, it is not effective
-  /// enough for calculations. Since it searches for an element sequentinally, it is extremelly
-  /// slow. Prefer Solution::get_ref_value if possible.
+  /// enough for calculations. Prefer Solution::get_ref_value if possible.
   virtual scalar get_pt_value(double x, double y, int item = H2D_FN_VAL_0);
 
   /// Returns the number of degrees of freedom of the solution.
@@ -177,6 +190,22 @@ public:
   /// Internal.
   virtual void set_active_element(Element* e);
 
+  /// Sets the solution to the coefficient vector of the space without converting it into
+  /// monomials (the type HERMES_SLN_DIRECT). Only the shape functions and their coefficients
+  /// are stored for every element and the values are calculated from the shape functions of
+  /// pss (through a slave, so its precalculated tables are shared). This is cheaper than
+  /// vector_to_solution() if the solution is used only once on every element, as the previous
+  /// iterate in assembling. The pss has to exist as long as the solution is used. The arrays
+  /// are reused if the solution is set again.
+  void set_coeff_vector_direct(Space* space, PrecalcShapeset* pss, scalar* coeffs, bool add_dir_lift = true);
+
+  /// Makes the solution a read-only view of the HERMES_SLN_DIRECT solution sln: the tables of
+  /// the shape functions and their coefficients are shared, the values are calculated from the
+  /// shape functions of pss (which must have the same shapeset). Used by the assembling threads,
+  /// so that the tables are built once. The solution sln must not change or be freed while the
+  /// view is used.
+  void share_coeff_vector_direct(Solution* sln, PrecalcShapeset* pss);
+
   /// Passes solution components calculated from solution vector as Solutions.
   static void vector_to_solutions(scalar* solution_vector, Hermes::vector<Space *> spaces,
                                   Hermes::vector<Solution *> solutions,
@@ -236,12 +265,27 @@ protected:
   scalar* dxdy_coefs[2][6];
   scalar* dxdy_buffer;
 
+  /// Shape functions of the elements of a HERMES_SLN_DIRECT solution: the functions of the
+  /// element with the id i are fn_idx[k], fn_coefs[k] for elem_fns[i] <= k < elem_fns[i+1].
+  PrecalcShapeset* sln_pss;
+  int* elem_fns;
+  int* fn_idx;
+  scalar* fn_coefs;
+  int fn_capacity;
+  bool own_fn_tables; ///< False if the tables above belong to another solution (see share_coeff_vector_direct()).
+
   double** calc_mono_matrix(int o, int*& perm);
   void init_dxdy_buffer();
   void free_tables();
 
   Element* e_last; ///< last visited element when getting solution values at specific points
 
+  RefMapCache* refmap_cache; ///< cached inverse reference mappings, NULL if off (see set_refmap_cache())
+
+  /// Returns the inverse reference mapping of the active element in the points of the order
+  /// (mstep = 1), or its constant one (mstep = 0), from the cache if it is on.
+  double2x2* get_inv_ref_map(int order, int np, int& mstep);
+
 };
 
 
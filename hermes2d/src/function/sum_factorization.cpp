@@ -0,0 +1,420 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "sum_factorization.h"
+#include "../shapeset/shapeset.h"
+#include "../quadrature/quad.h"
+
+// Probe points of the factorization. Polynomials of degree up to H2D_NUM_PROBES - 1 in each
+// variable are determined by their values on the grid, so a function of rank one on the grid
+// is a product of 1D functions. The points are irregular to avoid ties in the maxima.
+static const int H2D_NUM_PROBES = 12;
+static const double probes[H2D_NUM_PROBES] =
+  { -0.97, -0.83, -0.66, -0.49, -0.28, -0.11, 0.07, 0.24, 0.43, 0.61, 0.79, 0.94 };
+
+// Derivatives of the shape functions (see Shapeset::get_value()) corresponding to the
+// derivatives of the 1D functions in the directions, and the derivatives of the 1D functions
+// in the value k of a shape function.
+static const int fn_value[2][3] = { { 0, 1, 3 }, { 0, 2, 4 } };
+static const int value_fn[6][2] = { { 0, 0 }, { 1, 0 }, { 0, 1 }, { 2, 0 }, { 0, 2 }, { 1, 1 } };
+
+// Derivatives of the 1D functions in the reference quantities Q_p (value, d/dxi, d/deta).
+static const int quantity_fn[H2D_NUM_REF_QUANTITIES][2] = { { 0, 0 }, { 1, 0 }, { 0, 1 } };
+
+SumFactorization::SumFactorization()
+{
+}
+
+SumFactorization::~SumFactorization()
+{
+  _F_
+  free();
+}
+
+void SumFactorization::free()
+{
+  _F_
+  fns.clear();
+  factors.clear();
+  tables.clear();
+}
+
+double SumFactorization::eval_function(Shapeset* shapeset, const Function1D& fn, int d, double t)
+{
+  double x = (fn.dir == 0) ? t : fn.pos;
+  double y = (fn.dir == 0) ? fn.pos : t;
+  return shapeset->get_value(fn_value[fn.dir][d], fn.index, x, y, 0) / fn.norm;
+}
+
+int SumFactorization::find_function(Shapeset* shapeset, int index, int dir, double pos, double norm,
+                                    std::vector<double>& probe)
+{
+  // The functions are normalized to the maximum 1 in the probe points, so equal functions
+  // have equal probe values.
+  int id = shapeset->get_id();
+  for (unsigned int f = 0; f < fns.size(); f++) {
+    if (fns[f].id != id || fns[f].dir != dir) continue;
+    int a = 0;
+    while (a < H2D_NUM_PROBES && fabs(fns[f].probe[a] - probe[a]) < 1e-12) a++;
+    if (a == H2D_NUM_PROBES) return f;
+  }
+
+  Function1D fn;
+  fn.id = id;
+  fn.index = index;
+  fn.dir = dir;
+  fn.pos = pos;
+  fn.norm = norm;
+  fn.probe = probe;
+  fns.push_back(fn);
+  return fns.size() - 1;
+}
+
+SumFactorization::Factors& SumFactorization::get_factors(Shapeset* shapeset, int index)
+{
+  std::pair<int, int> key(shapeset->get_id(), index);
+  std::map<std::pair<int, int>, Factors>::iterator it = factors.find(key);
+  if (it != factors.end()) return it->second;
+
+  Factors& result = factors[key];
+  result.fn[0] = result.fn[1] = -1;
+  result.scale = 0.0;
+  if (shapeset->get_num_components() != 1) return result;
+
+  int mode = shapeset->get_mode();
+  shapeset->set_mode(HERMES_MODE_QUAD);
+
+  // Values on the probe grid and their maximum f(t_am, t_bm).
+  double f[H2D_NUM_PROBES][H2D_NUM_PROBES];
+  int am = 0, bm = 0;
+  for (int a = 0; a < H2D_NUM_PROBES; a++)
+    for (int b = 0; b < H2D_NUM_PROBES; b++) {
+      f[a][b] = shapeset->get_fn_value(index, probes[a], probes[b], 0);
+      if (fabs(f[a][b]) > fabs(f[am][bm])) am = a, bm = b;
+    }
+
+  // If f = s X(x) Y(y), then f(x, y) = f(x, t_bm) f(t_am, y) / f(t_am, t_bm).
+  double fm = f[am][bm];
+  bool rank_one = (fm != 0.0);
+  for (int a = 0; a < H2D_NUM_PROBES && rank_one; a++)
+    for (int b = 0; b < H2D_NUM_PROBES && rank_one; b++)
+      if (fabs(f[a][b] - f[a][bm] * f[am][b] / fm) > 1e-10 * fabs(fm))
+        rank_one = false;
+
+  if (rank_one) {
+    std::vector<double> probe(H2D_NUM_PROBES);
+    for (int a = 0; a < H2D_NUM_PROBES; a++)
+      probe[a] = f[a][bm] / fm;
+    result.fn[0] = find_function(shapeset, index, 0, probes[bm], fm, probe);
+    for (int b = 0; b < H2D_NUM_PROBES; b++)
+      probe[b] = f[am][b] / fm;
+    result.fn[1] = find_function(shapeset, index, 1, probes[am], fm, probe);
+    result.scale = fm;
+  }
+
+  shapeset->set_mode(mode);
+  return result;
+}
+
+bool SumFactorization::is_supported(Shapeset* shapeset, AsmList* al)
+{
+  _F_
+  if (shapeset->get_num_components() != 1) return false;
+  for (unsigned int i = 0; i < al->cnt; i++)
+    if (get_factors(shapeset, al->idx[i]).fn[0] < 0)
+      return false;
+  return true;
+}
+
+void SumFactorization::init_basis(Shapeset* shapeset, AsmList* al, Quad1D* quad, int order, Basis& basis)
+{
+  int np = quad->get_num_points(order);
+  double2* pt = quad->get_points(order);
+
+  basis.scale.resize(al->cnt);
+  for (int dir = 0; dir < 2; dir++) {
+    basis.slot[dir].resize(al->cnt);
+    basis.fn[dir].clear();
+  }
+
+  for (unsigned int i = 0; i < al->cnt; i++) {
+    Factors& f = get_factors(shapeset, al->idx[i]);
+    if (f.fn[0] < 0) error("Shape function %d is not a product of 1D functions.", al->idx[i]);
+    basis.scale[i] = f.scale;
+    for (int dir = 0; dir < 2; dir++) {
+      std::vector<int>& fn = basis.fn[dir];
+      unsigned int s = std::find(fn.begin(), fn.end(), f.fn[dir]) - fn.begin();
+      if (s == fn.size()) fn.push_back(f.fn[dir]);
+      basis.slot[dir][i] = s;
+    }
+  }
+
+  // Values of the 1D functions in the points, computed the first time a function is used
+  // with the rule.
+  int mode = shapeset->get_mode();
+  shapeset->set_mode(HERMES_MODE_QUAD);
+  for (int dir = 0; dir < 2; dir++) {
+    for (int d = 0; d < 2; d++)
+      basis.values[dir][d].resize(basis.fn[dir].size());
+    for (unsigned int s = 0; s < basis.fn[dir].size(); s++) {
+      Table& table = tables[std::pair<int, double2*>(basis.fn[dir][s], pt)];
+      if (table.d[0].empty()) {
+        const Function1D& fn = fns[basis.fn[dir][s]];
+        for (int d = 0; d < 2; d++) {
+          table.d[d].resize(np);
+          for (int a = 0; a < np; a++)
+            table.d[d][a] = eval_function(shapeset, fn, d, pt[a][0]);
+        }
+      }
+      for (int d = 0; d < 2; d++)
+        basis.values[dir][d][s] = &table.d[d][0];
+    }
+  }
+  shapeset->set_mode(mode);
+}
+
+void SumFactorization::find_active(MatrixCoeffs* coeffs, int np,
+                                   bool active[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES])
+{
+  for (int p = 0; p < H2D_NUM_REF_QUANTITIES; p++)
+    for (int q = 0; q < H2D_NUM_REF_QUANTITIES; q++) {
+      active[p][q] = false;
+      for (int k = 0; k < np && !active[p][q]; k++)
+        if (coeffs[k][p][q] != 0.0) active[p][q] = true;
+    }
+}
+
+void SumFactorization::assemble_matrix(Shapeset* shapeset_u, AsmList* alu, Shapeset* shapeset_v, AsmList* alv,
+                                       Quad1D* quad, int order, MatrixCoeffs* coeffs, scalar** result)
+{
+  _F_
+  int n = quad->get_num_points(order);
+  init_basis(shapeset_u, alu, quad, order, basis_u);
+  init_basis(shapeset_v, alv, quad, order, basis_v);
+
+  for (unsigned int i = 0; i < alv->cnt; i++)
+    for (unsigned int j = 0; j < alu->cnt; j++)
+      result[i][j] = 0.0;
+
+  bool active[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES];
+  find_active(coeffs, n * n, active);
+
+  int nxu = basis_u.fn[0].size(), nxv = basis_v.fn[0].size();
+  work.resize(n * n);
+  work2.resize(nxu * nxv * n);
+  for (int p = 0; p < H2D_NUM_REF_QUANTITIES; p++)
+    for (int q = 0; q < H2D_NUM_REF_QUANTITIES; q++) {
+      if (!active[p][q]) continue;
+      const int *du = quantity_fn[p], *dv = quantity_fn[q];
+
+      // T[xu][xv][b] = sum_a C_pq(t_a, t_b) Xu(t_a) Xv(t_a) for all pairs of x-functions.
+      scalar* c = &work[0];
+      for (int k = 0; k < n * n; k++)
+        c[k] = coeffs[k][p][q];
+      for (int xu = 0; xu < nxu; xu++)
+        for (int xv = 0; xv < nxv; xv++) {
+          const double* fu = basis_u.values[0][du[0]][xu];
+          const double* fv = basis_v.values[0][dv[0]][xv];
+          scalar* t = &work2[(xu * nxv + xv) * n];
+          for (int b = 0; b < n; b++)
+            t[b] = 0.0;
+          for (int a = 0; a < n; a++) {
+            double w = fu[a] * fv[a];
+            if (w == 0.0) continue;
+            const scalar* ca = c + a * n;
+            for (int b = 0; b < n; b++)
+              t[b] += w * ca[b];
+          }
+        }
+
+      // result[i][j] += sum_b T[xu_j][xv_i][b] Yu_j(t_b) Yv_i(t_b).
+      for (unsigned int i = 0; i < alv->cnt; i++) {
+        const double* gv = basis_v.values[1][dv[1]][basis_v.slot[1][i]];
+        int xv = basis_v.slot[0][i];
+        for (unsigned int j = 0; j < alu->cnt; j++) {
+          const double* gu = basis_u.values[1][du[1]][basis_u.slot[1][j]];
+          const scalar* t = &work2[(basis_u.slot[0][j] * nxv + xv) * n];
+          scalar value = 0.0;
+          for (int b = 0; b < n; b++)
+            value += t[b] * (gu[b] * gv[b]);
+          result[i][j] += value;
+        }
+      }
+    }
+
+  for (unsigned int i = 0; i < alv->cnt; i++)
+    for (unsigned int j = 0; j < alu->cnt; j++)
+      result[i][j] *= basis_u.scale[j] * basis_v.scale[i];
+}
+
+void SumFactorization::assemble_vector(Shapeset* shapeset_v, AsmList* alv, Quad1D* quad, int order,
+                                       VectorCoeffs* coeffs, scalar* result)
+{
+  _F_
+  int n = quad->get_num_points(order);
+  init_basis(shapeset_v, alv, quad, order, basis_v);
+
+  for (unsigned int i = 0; i < alv->cnt; i++)
+    result[i] = 0.0;
+
+  int nxv = basis_v.fn[0].size();
+  work.resize(n * n);
+  work2.resize(nxv * n);
+  for (int q = 0; q < H2D_NUM_REF_QUANTITIES; q++) {
+    scalar* c = &work[0];
+    bool active = false;
+    for (int k = 0; k < n * n; k++) {
+      c[k] = coeffs[k][q];
+      if (c[k] != 0.0) active = true;
+    }
+    if (!active) continue;
+    const int* dv = quantity_fn[q];
+
+    // W[xv][b] = sum_a C_q(t_a, t_b) Xv(t_a).
+    for (int xv = 0; xv < nxv; xv++) {
+      const double* fv = basis_v.values[0][dv[0]][xv];
+      scalar* w = &work2[xv * n];
+      for (int b = 0; b < n; b++)
+        w[b] = 0.0;
+      for (int a = 0; a < n; a++) {
+        if (fv[a] == 0.0) continue;
+        const scalar* ca = c + a * n;
+        for (int b = 0; b < n; b++)
+          w[b] += fv[a] * ca[b];
+      }
+    }
+
+    // result[i] += sum_b W[xv_i][b] Yv_i(t_b).
+    for (unsigned int i = 0; i < alv->cnt; i++) {
+      const double* gv = basis_v.values[1][dv[1]][basis_v.slot[1][i]];
+      const scalar* w = &work2[basis_v.slot[0][i] * n];
+      scalar value = 0.0;
+      for (int b = 0; b < n; b++)
+        value += w[b] * gv[b];
+      result[i] += value;
+    }
+  }
+
+  for (unsigned int i = 0; i < alv->cnt; i++)
+    result[i] *= basis_v.scale[i];
+}
+
+void SumFactorization::apply_matrix(Shapeset* shapeset_u, AsmList* alu, Shapeset* shapeset_v, AsmList* alv,
+                                    Quad1D* quad, int order, MatrixCoeffs* coeffs, scalar* x, scalar* y)
+{
+  _F_
+  int n = quad->get_num_points(order);
+  init_basis(shapeset_u, alu, quad, order, basis_u);
+
+  bool active[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES];
+  find_active(coeffs, n * n, active);
+
+  // The coefficients of x in the products of the 1D functions: Z[xu][yu].
+  int nxu = basis_u.fn[0].size(), nyu = basis_u.fn[1].size();
+  work.assign(nxu * nyu, 0.0);
+  for (unsigned int j = 0; j < alu->cnt; j++)
+    work[basis_u.slot[0][j] * nyu + basis_u.slot[1][j]] += basis_u.scale[j] * x[j];
+
+  // The quantities U_p of the function u = sum_j x_j u_j in the points, and the coefficients
+  // sum_p C_pq U_p of the vector of the test functions.
+  apply_buffer.assign(n * n * H2D_NUM_REF_QUANTITIES, 0.0);
+  VectorCoeffs* vc = (VectorCoeffs*) &apply_buffer[0];
+  work2.resize(nxu * n + n * n);
+  for (int p = 0; p < H2D_NUM_REF_QUANTITIES; p++) {
+    bool needed = false;
+    for (int q = 0; q < H2D_NUM_REF_QUANTITIES; q++)
+      if (active[p][q]) needed = true;
+    if (!needed) continue;
+    const int* du = quantity_fn[p];
+
+    // V[xu][b] = sum_yu Z[xu][yu] Yu(t_b).
+    scalar* v = &work2[0];
+    for (int xu = 0; xu < nxu; xu++) {
+      scalar* vx = v + xu * n;
+      for (int b = 0; b < n; b++)
+        vx[b] = 0.0;
+      for (int yu = 0; yu < nyu; yu++) {
+        scalar z = work[xu * nyu + yu];
+        if (z == 0.0) continue;
+        const double* gu = basis_u.values[1][du[1]][yu];
+        for (int b = 0; b < n; b++)
+          vx[b] += z * gu[b];
+      }
+    }
+
+    // U_p(t_a, t_b) = sum_xu Xu(t_a) V[xu][b].
+    scalar* u = &work2[nxu * n];
+    for (int k = 0; k < n * n; k++)
+      u[k] = 0.0;
+    for (int xu = 0; xu < nxu; xu++) {
+      const double* fu = basis_u.values[0][du[0]][xu];
+      const scalar* vx = v + xu * n;
+      for (int a = 0; a < n; a++) {
+        if (fu[a] == 0.0) continue;
+        scalar* ua = u + a * n;
+        for (int b = 0; b < n; b++)
+          ua[b] += fu[a] * vx[b];
+      }
+    }
+
+    for (int q = 0; q < H2D_NUM_REF_QUANTITIES; q++)
+      if (active[p][q])
+        for (int k = 0; k < n * n; k++)
+          vc[k][q] += coeffs[k][p][q] * u[k];
+  }
+
+  assemble_vector(shapeset_v, alv, quad, order, vc, y);
+}
+
+bool SumFactorization::eval(Shapeset* shapeset, int index, int k, double* x, int nx, double* y, int ny,
+                            double* result)
+{
+  Factors& f = get_factors(shapeset, index);
+  if (f.fn[0] < 0) return false;
+
+  eval_buffer.resize(nx + ny);
+  double* fx = &eval_buffer[0];
+  double* fy = fx + nx;
+  int mode = shapeset->get_mode();
+  shapeset->set_mode(HERMES_MODE_QUAD);
+  for (int i = 0; i < nx; i++)
+    fx[i] = f.scale * eval_function(shapeset, fns[f.fn[0]], value_fn[k][0], x[i]);
+  for (int j = 0; j < ny; j++)
+    fy[j] = eval_function(shapeset, fns[f.fn[1]], value_fn[k][1], y[j]);
+  shapeset->set_mode(mode);
+
+  for (int i = 0; i < nx; i++)
+    for (int j = 0; j < ny; j++)
+      result[i * ny + j] = fx[i] * fy[j];
+  return true;
+}
+
+SumFactorization::MatrixCoeffs* SumFactorization::get_matrix_coeffs(int n)
+{
+  coeffs_buffer.assign(n * H2D_NUM_REF_QUANTITIES * H2D_NUM_REF_QUANTITIES, 0.0);
+  return (MatrixCoeffs*) &coeffs_buffer[0];
+}
+
+SumFactorization::VectorCoeffs* SumFactorization::get_vector_coeffs(int n)
+{
+  coeffs_buffer.assign(n * H2D_NUM_REF_QUANTITIES, 0.0);
+  return (VectorCoeffs*) &coeffs_buffer[0];
+}
+
+double2x2* SumFactorization::get_inv_ref_map_buffer(int n)
+{
+  m_buffer.resize(4 * n);
+  return (double2x2*) &m_buffer[0];
+}
@@ -0,0 +1,134 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __H2D_SUM_FACTORIZATION_H
+#define __H2D_SUM_FACTORIZATION_H
+
+#include "../h2d_common.h"
+#include "../asmlist.h"
+#include "ref_matrices.h"
+
+class Shapeset;
+class Quad1D;
+
+/// Sum factorization on quadrilaterals. The shape functions of the scalar shapesets on quads
+/// are products f(x, y) = s X(x) Y(y) of 1D functions, and the volumetric quadrature is the
+/// tensor product of a 1D rule with n points (see Quad2D::get_tensor_quad_1d()). The sums over
+/// the n^2 points then factorize into sums over one coordinate at a time:
+///  - the values of a shape function in the n^2 points from 2n evaluations (eval()),
+///  - the vector of a form (assemble_vector()) and the product of the matrix of a form with
+///    a vector (apply_matrix()) in O(p^3) operations instead of O(p^4),
+///  - the matrix of a form (assemble_matrix()) in O(p^5) operations instead of O(p^6),
+/// for the degree p of the element. The forms are given by their coefficients of the reference
+/// quantities (see RefMatrixCache) in the quadrature points, so that elements with a
+/// non-constant jacobian are covered as well (see WeakForm::MatrixFormVol::ref_point_coeffs()).
+///
+/// The factors of the shape functions are found numerically the first time a function is
+/// encountered (the rank of its values on a grid of probe points has to be one) and kept with
+/// their values in the points of the 1D rules until free() is called. Not thread-safe: every
+/// assembling thread has its own instance.
+class HERMES_API SumFactorization
+{
+public:
+  SumFactorization();
+  ~SumFactorization();
+
+  /// Coefficients of the reference quantities of a form in a point.
+  typedef scalar MatrixCoeffs[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES];
+  typedef scalar VectorCoeffs[H2D_NUM_REF_QUANTITIES];
+
+  /// Returns true if all shape functions of the assembly list (in the mode of quads) are
+  /// products of 1D functions.
+  bool is_supported(Shapeset* shapeset, AsmList* al);
+
+  /// Sets result[i][j] = sum_k sum_{p,q} coeffs[k][p][q] Q_p(u_j)(x_k) Q_q(v_i)(x_k) for the
+  /// basis functions u of alu and the test functions v of alv, where x_k are the points of the
+  /// tensor product of the 1D rule quad of the order (x_k = (t_a, t_b) for k = a * n + b).
+  void assemble_matrix(Shapeset* shapeset_u, AsmList* alu, Shapeset* shapeset_v, AsmList* alv,
+                       Quad1D* quad, int order, MatrixCoeffs* coeffs, scalar** result);
+  /// Sets result[i] = sum_k sum_q coeffs[k][q] Q_q(v_i)(x_k).
+  void assemble_vector(Shapeset* shapeset_v, AsmList* alv, Quad1D* quad, int order,
+                       VectorCoeffs* coeffs, scalar* result);
+  /// Sets y = A x for the matrix A given by assemble_matrix(), without assembling it.
+  void apply_matrix(Shapeset* shapeset_u, AsmList* alu, Shapeset* shapeset_v, AsmList* alv,
+                    Quad1D* quad, int order, MatrixCoeffs* coeffs, scalar* x, scalar* y);
+
+  /// Sets result[i * ny + j] to the value k (see Shapeset::get_value()) of the shape function
+  /// at (x[i], y[j]). Returns false if the function is not a product of 1D functions.
+  bool eval(Shapeset* shapeset, int index, int k, double* x, int nx, double* y, int ny, double* result);
+
+  /// Buffers for the coefficients of n points (set to zero) and for n inverse reference maps.
+  MatrixCoeffs* get_matrix_coeffs(int n);
+  VectorCoeffs* get_vector_coeffs(int n);
+  double2x2* get_inv_ref_map_buffer(int n);
+
+  void free();
+
+  /// Number of the distinct 1D functions found.
+  int get_num_functions() const { return fns.size(); }
+
+protected:
+  /// A 1D function: the shape function index of the shapeset id along the direction dir
+  /// (0 = x, 1 = y) with the other coordinate equal to pos, divided by norm.
+  struct Function1D
+  {
+    int id, index, dir;
+    double pos, norm;
+    std::vector<double> probe;      ///< Values in the probe points.
+  };
+  std::vector<Function1D> fns;
+
+  /// Factors of a shape function: scale * fns[fn[0]](x) * fns[fn[1]](y), fn[0] = -1 if the
+  /// function does not factorize.
+  struct Factors
+  {
+    int fn[2];
+    double scale;
+  };
+  std::map<std::pair<int, int>, Factors> factors;   ///< By the shapeset id and the index.
+
+  /// Values and first derivatives of the 1D functions in the points of the 1D rules, by the
+  /// function and the points of the rule.
+  struct Table
+  {
+    std::vector<double> d[2];
+  };
+  std::map<std::pair<int, double2*>, Table> tables;
+
+  /// The distinct 1D functions of an assembly list in both directions: the i-th function is
+  /// scale[i] * X_{slot[0][i]}(x) * Y_{slot[1][i]}(y), values[dir][d][slot] are the derivatives
+  /// d of the 1D functions in the points.
+  struct Basis
+  {
+    std::vector<int> slot[2];
+    std::vector<double> scale;
+    std::vector<int> fn[2];
+    std::vector<const double*> values[2][2];
+  };
+  Basis basis_u, basis_v;
+
+  /// Scratch space.
+  std::vector<scalar> coeffs_buffer, apply_buffer, work, work2;
+  std::vector<double> m_buffer, eval_buffer;
+
+  Factors& get_factors(Shapeset* shapeset, int index);
+  int find_function(Shapeset* shapeset, int index, int dir, double pos, double norm,
+                    std::vector<double>& probe);
+  static double eval_function(Shapeset* shapeset, const Function1D& fn, int d, double t);
+  void init_basis(Shapeset* shapeset, AsmList* al, Quad1D* quad, int order, Basis& basis);
+  static void find_active(MatrixCoeffs* coeffs, int np, bool active[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES]);
+};
+
+#endif
@@ -45,6 +45,45 @@ const int H2D_ORDER_MASK = (1 << H2D_ORDER_BITS) - 1;
    tests in Traverse:begin(). */
 //#define H2D_DISABLE_MULTIMESH_TESTS
 
+/// An object of type T with a separate instance in every thread. The instance is created
+/// on the first call to get() in the thread and deleted when the thread exits (the instance
+/// of the main thread lives until the end of the program). Objects which keep a pointer to
+/// the instance must not outlive the thread.
+/// Meant for variables with static storage only: initialize them with
+/// H2D_THREAD_LOCAL_INSTANCE_INIT, so that they can be used during the static initialization
+/// of other global objects. get() locks a mutex, callers on hot paths should cache
+/// the returned pointer in a HERMES_THREAD_LOCAL variable.
+template<typename T>
+struct ThreadLocalInstance
+{
+  pthread_mutex_t key_mutex;
+  bool key_created;
+  pthread_key_t key;
+
+  T* get()
+  {
+    pthread_mutex_lock(&key_mutex);
+    if (!key_created)
+    {
+      pthread_key_create(&key, destroy);
+      key_created = true;
+    }
+    pthread_mutex_unlock(&key_mutex);
+
+    T* instance = (T*) pthread_getspecific(key);
+    if (instance == NULL)
+    {
+      instance = new T;
+      pthread_setspecific(key, instance);
+    }
+    return instance;
+  }
+
+  static void destroy(void* instance) { delete (T*) instance; }
+};
+
+#define H2D_THREAD_LOCAL_INSTANCE_INIT { PTHREAD_MUTEX_INITIALIZER, false, pthread_key_t() }
+
 class MeshFunction;
 class Solution;
 enum ProjNormType;
@@ -52,6 +91,47 @@ class RefMap;
 class DiscreteProblem;
 class Space;
 class WeakForm;
+class NativePrecond;
+
+/// Parameters of the variants of the Newton's method in Hermes2D::solve_newton().
+/// The default values give the plain Newton's method.
+struct HERMES_API NewtonSettings
+{
+  NewtonSettings();
+
+  /// The Jacobian is assembled in every jacobian_refresh-th iteration only and reused
+  /// (together with its factorization) in the other ones: 1 = the Newton's method,
+  /// n > 1 = the Shamanskii method, 0 = the chord method (the Jacobian is never refreshed
+  /// periodically).
+  int jacobian_refresh;
+  /// If the residual norm does not drop at least by this factor in an iteration with a reused
+  /// Jacobian, the Jacobian is refreshed at the current iterate before the period ends.
+  double max_residual_ratio;
+
+  /// Inexact Newton's method: if the solver is an IterSolver, its tolerance is set to
+  /// the Eisenstat-Walker forcing term eta_k = ew_gamma * (||F_k|| / ||F_{k-1}||)^ew_alpha
+  /// (safeguarded by ew_gamma * eta_{k-1}^ew_alpha and bounded by eta_max), eta_0 = eta_initial.
+  /// The original tolerance of the solver is restored when solve_newton() returns.
+  bool inexact;
+  double eta_initial, eta_max, ew_gamma, ew_alpha;
+};
+
+/// Statistics of the iterations of Hermes2D::solve_newton() and solve_jfnk(). The index i
+/// corresponds to the i-th iterate (0 = the initial guess): its residual norm and the times of
+/// assembling the residual and the Jacobian (for solve_jfnk() the Jacobian of the preconditioner)
+/// and of the solution of the linear system (0 if not done), the tolerance given to the iterative
+/// solver (0 for other solvers) and the number of its iterations.
+struct HERMES_API NewtonStatistics
+{
+  std::vector<double> residual_norms;
+  std::vector<double> residual_times, jacobian_times, solve_times;
+  std::vector<double> forcing_terms;
+  std::vector<int> linear_iters;
+  int num_jacobians;        ///< Number of Jacobian assemblies.
+
+  NewtonStatistics() : num_jacobians(0) { }
+  void clear();
+};
 
 // Class for all global functions.
 class HERMES_API Hermes2D {
@@ -104,10 +184,29 @@ public:
 
   double get_l2_norm(Vector* vec) const;
 
+  /// Newton's method. With settings, the Jacobian can be reused in several iterations
+  /// (chord / Shamanskii method) and the tolerance of an iterative solver can be adapted
+  /// (inexact Newton's method), see NewtonSettings. If stats is not NULL, it is filled with
+  /// the statistics of the iterations.
   bool solve_newton(scalar* coeff_vec, DiscreteProblem* dp, Solver* solver, SparseMatrix* matrix,
 		    Vector* rhs, double NEWTON_TOL = 1e-8, int NEWTON_MAX_ITER = 100, bool verbose = false,
                     bool residual_as_function = false,
-                    double damping_coeff = 1.0, double max_allowed_residual_norm = 1e6) const;
+                    double damping_coeff = 1.0, double max_allowed_residual_norm = 1e6,
+                    const NewtonSettings* settings = NULL, NewtonStatistics* stats = NULL) const;
+
+  /// Jacobian-free Newton-Krylov method: the Newton's systems are solved by GMRES(gmres_restart)
+  /// with the products of the Jacobian and a vector v approximated by differences of residuals
+  /// (F(Y + eps v) - F(Y)) / eps, so that only residuals are assembled. eps = fd_epsilon / ||v||,
+  /// or sqrt((1 + ||Y||) * machine eps) / ||v|| if fd_epsilon is 0. The tolerances of GMRES are
+  /// the Eisenstat-Walker forcing terms given by settings.
+  /// If precond is not NULL, it is computed from the Jacobian assembled by dp_precond (dp if NULL,
+  /// else e.g. a DiscreteProblem with a simplified weak form on the same spaces, it must have the
+  /// same number of DOFs as dp) in every settings->jacobian_refresh-th iteration (only once if 0).
+  bool solve_jfnk(scalar* coeff_vec, DiscreteProblem* dp, double newton_tol = 1e-8,
+                  int newton_max_iter = 100, bool verbose = false,
+                  NativePrecond* precond = NULL, DiscreteProblem* dp_precond = NULL,
+                  const NewtonSettings* settings = NULL, NewtonStatistics* stats = NULL,
+                  int gmres_restart = 30, int gmres_max_iters = 1000, double fd_epsilon = 0.0) const;
 
   bool solve_picard(WeakForm* wf, Space* space, Solution* sln_prev_iter, 
                     MatrixSolverType matrix_solver, double picard_tol = 1e-8, 
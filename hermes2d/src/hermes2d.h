@@ -38,11 +38,15 @@
 #include "../hermes_common/solver/petsc.h"
 #include "../hermes_common/solver/umfpack_solver.h"
 #include "../hermes_common/solver/superlu.h"
+#include "../hermes_common/solver/csr.h"
+#include "../hermes_common/solver/krylov.h"
 
 // preconditioners
 #include "../hermes_common/solver/precond.h"
 #include "../hermes_common/solver/precond_ifpack.h"
 #include "../hermes_common/solver/precond_ml.h"
+#include "../hermes_common/solver/precond_native.h"
+#include "../hermes_common/solver/precond_amg.h"
 
 // boundary conditions
 #include "boundaryconditions/essential_bcs.h"
@@ -70,14 +74,22 @@
 #include "shapeset/shapeset_hc_all.h"
 #include "shapeset/shapeset_hd_all.h"
 #include "shapeset/shapeset_l2_all.h"
+#include "shapeset/shapeset_engine.h"
 
 #include "mesh/refmap.h"
+#include "mesh/mesh_index.h"
 #include "mesh/traverse.h"
 #include "mesh/trans.h"
 
 #include "weakform/weakform.h"
+#include "weakform/form_kernels.h"
 #include "discrete_problem.h"
 #include "function/forms.h"
+#include "function/fn_cache.h"
+#include "function/geom_cache.h"
+#include "function/refmap_cache.h"
+#include "function/ref_matrices.h"
+#include "function/sum_factorization.h"
 
 #include "integrals/h1.h"
 #include "integrals/hcurl.h"
@@ -112,6 +124,9 @@
 #include "adapt/kelly_type_adapt.h"
 #include "neighbor.h"
 #include "ogprojection.h"
+#include "precond_pmg.h"
+#include "static_condensation.h"
+#include "element_matrix_cache.h"
 
 #include "runge_kutta.h"
 #include "spline.h"
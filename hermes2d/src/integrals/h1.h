@@ -470,4 +470,179 @@ inline double int_l2_norm(Function<T>* fu, RefMap* ru)
   return result;
 }
 
+//// batched integrals (see WeakForm::MatrixFormVol::value_batch()) ////
+
+// The kernels below keep their intermediate values in the scratch arrays of the test
+// functions v (FuncBatch::work and swork), which belong to the caller and are reused for
+// all elements. The weights w may be stored in v->wbuf (see geom_weights()).
+
+// Integration weights multiplied by the radial coordinate of axisymmetric forms: e->y for
+// HERMES_AXISYM_X and e->x for HERMES_AXISYM_Y. For planar forms wt is returned, otherwise
+// the weights are stored to buffer, which has to hold n values.
+inline double* geom_weights(int n, double *wt, Geom<double> *e, GeomType gt, double *buffer)
+{
+  if (gt == HERMES_PLANAR) return wt;
+  double* r = (gt == HERMES_AXISYM_X) ? e->y : e->x;
+  for (int i = 0; i < n; i++)
+    buffer[i] = wt[i] * r[i];
+  return buffer;
+}
+
+// The k-th weight of geom_weights(), for loops that need one point at a time.
+inline double geom_weight(int k, double *wt, Geom<double> *e, GeomType gt)
+{
+  if (gt == HERMES_PLANAR) return wt[k];
+  return wt[k] * ((gt == HERMES_AXISYM_X) ? e->y[k] : e->x[k]);
+}
+
+// Dense product of two sets of functions at n points: result[i][j] += coeff * sum_t sum_k
+// a[t][i * n + k] * b[t][j * n + k] for i < na, j < nb, t < nt. Two rows and two columns are
+// processed at once, so that every loaded value is used twice.
+inline void batch_product(int n, int na, double **a, int nb, double **b, int nt, scalar coeff, scalar **result)
+{
+  int i, j;
+  for (i = 0; i + 1 < na; i += 2) {
+    for (j = 0; j + 1 < nb; j += 2) {
+      double s00 = 0, s01 = 0, s10 = 0, s11 = 0;
+      for (int t = 0; t < nt; t++) {
+        double *a0 = a[t] + i * n, *a1 = a0 + n;
+        double *b0 = b[t] + j * n, *b1 = b0 + n;
+        for (int k = 0; k < n; k++) {
+          s00 += a0[k] * b0[k];
+          s01 += a0[k] * b1[k];
+          s10 += a1[k] * b0[k];
+          s11 += a1[k] * b1[k];
+        }
+      }
+      result[i][j] += coeff * s00;
+      result[i][j + 1] += coeff * s01;
+      result[i + 1][j] += coeff * s10;
+      result[i + 1][j + 1] += coeff * s11;
+    }
+    for (; j < nb; j++) {
+      double s0 = 0, s1 = 0;
+      for (int t = 0; t < nt; t++) {
+        double *a0 = a[t] + i * n, *a1 = a0 + n, *b0 = b[t] + j * n;
+        for (int k = 0; k < n; k++) {
+          s0 += a0[k] * b0[k];
+          s1 += a1[k] * b0[k];
+        }
+      }
+      result[i][j] += coeff * s0;
+      result[i + 1][j] += coeff * s1;
+    }
+  }
+  for (; i < na; i++)
+    for (j = 0; j < nb; j++) {
+      double s = 0;
+      for (int t = 0; t < nt; t++) {
+        double *a0 = a[t] + i * n, *b0 = b[t] + j * n;
+        for (int k = 0; k < n; k++)
+          s += a0[k] * b0[k];
+      }
+      result[i][j] += coeff * s;
+    }
+}
+
+// Values of the functions multiplied by the weights, stored to buffer (nf * n values).
+inline double* batch_weighted(int n, double *w, int nf, double *values, double *buffer)
+{
+  for (int i = 0; i < nf; i++)
+    for (int k = 0; k < n; k++)
+      buffer[i * n + k] = w[k] * values[i * n + k];
+  return buffer;
+}
+
+// \int w u_j v_i for all pairs.
+inline void int_u_v_batch(int n, double *w, FuncBatch *u, FuncBatch *v, scalar coeff, scalar **result)
+{
+  double* a[1] = { batch_weighted(n, w, v->nf, v->val, v->work) };
+  double* b[1] = { u->val };
+  batch_product(n, v->nf, a, u->nf, b, 1, coeff, result);
+}
+
+// \int w \nabla u_j \cdot \nabla v_i for all pairs.
+inline void int_grad_u_grad_v_batch(int n, double *w, FuncBatch *u, FuncBatch *v, scalar coeff, scalar **result)
+{
+  double* a[2] = { batch_weighted(n, w, v->nf, v->dx, v->work),
+                   batch_weighted(n, w, v->nf, v->dy, v->work + v->nf * n) };
+  double* b[2] = { u->dx, u->dy };
+  batch_product(n, v->nf, a, u->nf, b, 2, coeff, result);
+}
+
+// \int w (coeff1 du_j/dx + coeff2 du_j/dy) v_i for all pairs.
+inline void int_dudx_dudy_v_batch(int n, double *w, FuncBatch *u, FuncBatch *v, scalar coeff1, scalar coeff2,
+                                  scalar **result)
+{
+  double* a[1] = { batch_weighted(n, w, v->nf, v->val, v->work) };
+  double* bx[1] = { u->dx };
+  double* by[1] = { u->dy };
+  batch_product(n, v->nf, a, u->nf, bx, 1, coeff1, result);
+  batch_product(n, v->nf, a, u->nf, by, 1, coeff2, result);
+}
+
+// \int w f v_i for all test functions, where f are values at the integration points.
+inline void int_f_v_batch(int n, double *w, scalar *f, FuncBatch *v, scalar coeff, scalar *result)
+{
+  scalar* wf = v->swork;
+  for (int k = 0; k < n; k++)
+    wf[k] = w[k] * f[k];
+  for (int i = 0; i < v->nf; i++) {
+    double *vi = v->val + i * n;
+    scalar s = 0;
+    for (int k = 0; k < n; k++)
+      s += wf[k] * vi[k];
+    result[i] += coeff * s;
+  }
+}
+
+// \int w v_i for all test functions.
+inline void int_v_batch(int n, double *w, FuncBatch *v, scalar coeff, scalar *result)
+{
+  for (int i = 0; i < v->nf; i++) {
+    double *vi = v->val + i * n;
+    double s = 0;
+    for (int k = 0; k < n; k++)
+      s += w[k] * vi[k];
+    result[i] += coeff * s;
+  }
+}
+
+// \int w \nabla u_ext \cdot \nabla v_i for all test functions.
+inline void int_grad_u_ext_grad_v_batch(int n, double *w, Func<scalar> *u_ext, FuncBatch *v, scalar coeff,
+                                        scalar *result)
+{
+  scalar *wdx = v->swork, *wdy = v->swork + n;
+  for (int k = 0; k < n; k++) {
+    wdx[k] = w[k] * u_ext->dx[k];
+    wdy[k] = w[k] * u_ext->dy[k];
+  }
+  for (int i = 0; i < v->nf; i++) {
+    double *vdx = v->dx + i * n, *vdy = v->dy + i * n;
+    scalar s = 0;
+    for (int k = 0; k < n; k++)
+      s += wdx[k] * vdx[k] + wdy[k] * vdy[k];
+    result[i] += coeff * s;
+  }
+}
+
+//// reference-element coefficients (see WeakForm::MatrixFormVol::ref_coeffs()) ////
+
+// \int coeff grad u . grad v, the reference derivatives are transformed by m.
+inline void ref_coeffs_grad_u_grad_v(double2x2& m, double jac, scalar coeff,
+                                     scalar coeffs[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES])
+{
+  for (int a = 0; a < 2; a++)
+    for (int b = 0; b < 2; b++)
+      coeffs[1 + a][1 + b] += coeff * jac * (m[0][a] * m[0][b] + m[1][a] * m[1][b]);
+}
+
+// \int (coeff1 du/dx + coeff2 du/dy) v.
+inline void ref_coeffs_dudx_dudy_v(double2x2& m, double jac, scalar coeff1, scalar coeff2,
+                                   scalar coeffs[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES])
+{
+  for (int a = 0; a < 2; a++)
+    coeffs[1 + a][0] += jac * (coeff1 * m[0][a] + coeff2 * m[1][a]);
+}
+
 #endif
@@ -104,5 +104,24 @@ Scalar int_e_tau_f_tau(int n, double *wt, Func<Real> *u, Func<Real> *v, Geom<Rea
   return result;
 }
 
+//// reference-element coefficients (see WeakForm::MatrixFormVol::ref_coeffs()) ////
+
+// \int coeff E . F, the reference components are transformed by m.
+inline void ref_coeffs_e_f(double2x2& m, double jac, scalar coeff,
+                           scalar coeffs[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES])
+{
+  for (int a = 0; a < 2; a++)
+    for (int b = 0; b < 2; b++)
+      coeffs[1 + a][1 + b] += coeff * jac * (m[0][a] * m[0][b] + m[1][a] * m[1][b]);
+}
+
+// \int coeff curl E curl F, the reference curl is multiplied by det(m) = 1 / jac.
+inline void ref_coeffs_curl_e_curl_f(double2x2& m, double jac, scalar coeff,
+                                     scalar coeffs[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES])
+{
+  double det = m[0][0] * m[1][1] - m[1][0] * m[0][1];
+  coeffs[0][0] += coeff * jac * det * det;
+}
+
 #endif
 
@@ -155,6 +155,8 @@ protected:
 
   mutable pthread_mutex_t data_mutex;
 
+  Quad2D* quad_lin; ///< Linearization points of the thread calling process_solution().
+
   static void calc_aabb(double* x, double* y, int stride, int num, double* min_x, double* max_x, double* min_y, double* max_y); ///< Calculates AABB from an array of X-axis and Y-axis coordinates. The distance between values in the array is stride bytes.
 };
 
@@ -191,6 +193,8 @@ protected:
   char** ltext;
   double2* lbox;
 
+  Quad2D* quad_ord; ///< Points of the order labels of the thread calling process_space().
+
 };
 
 
@@ -120,7 +120,16 @@ public:
 
   virtual void dummy_fn() {}
 
-} quad_lin;
+};
+
+// The quadrature keeps the current mode and functions keep pointers to it, so every thread
+// has its own instance shared by all its linearizers.
+static ThreadLocalInstance<Quad2DLin> quad_lin_instances = H2D_THREAD_LOCAL_INSTANCE_INIT;
+
+Quad2D* get_quad_lin()
+{
+  return quad_lin_instances.get();
+}
 
 
 
@@ -132,6 +141,7 @@ Linearizer::Linearizer()
   verts = NULL;
   tris = NULL;
   edges = NULL;
+  quad_lin = NULL;
 
   pthread_mutexattr_t attr;
   pthread_mutexattr_init(&attr);
@@ -725,12 +735,13 @@ void Linearizer::process_solution(MeshFunction* sln, int item, double eps, doubl
 
   // select the linearization quadrature
   Quad2D *old_quad, *old_quad_x = NULL, *old_quad_y = NULL;
+  quad_lin = get_quad_lin();
   old_quad = sln->get_quad_2d();
-  sln->set_quad_2d(&quad_lin);
+  sln->set_quad_2d(quad_lin);
   if (disp) { old_quad_x = xdisp->get_quad_2d();
               old_quad_y = ydisp->get_quad_2d();
-              xdisp->set_quad_2d(&quad_lin);
-              ydisp->set_quad_2d(&quad_lin); }
+              xdisp->set_quad_2d(quad_lin);
+              ydisp->set_quad_2d(quad_lin); }
 
   // create all top-level vertices (corresponding to vertex nodes), with
   // all parent-son relations preserved; this is necessary for regularization to
@@ -39,7 +39,7 @@ static int3*     ord_edge_quad[2]   = { edge_quad0,  edge_quad1 };
 static int3**    ord_edge[2]        = { ord_edge_tri, ord_edge_quad };
 
 
-static class Quad2DOrd : public Quad2D
+class Quad2DOrd : public Quad2D
 {
 public:
 
@@ -54,7 +54,9 @@ public:
 
   virtual void dummy_fn() {}
 
-} quad_ord;
+};
+
+static ThreadLocalInstance<Quad2DOrd> quad_ord_instances = H2D_THREAD_LOCAL_INSTANCE_INIT;
 
 
 //// Orderizer /////////////////////////////////////////////////////////////////////////////////////
@@ -67,6 +69,7 @@ Orderizer::Orderizer()
   lbox = NULL;
 
   nl = cl1 = cl2 = cl3 = 0;
+  quad_ord = NULL;
 
   for (int i = 0, p = 0; i <= 10; i++)
   {
@@ -116,8 +119,9 @@ void Orderizer::process_space(Space* space)
 
   int oo, o[6];
 
+  quad_ord = quad_ord_instances.get();
   RefMap refmap;
-  refmap.set_quad_2d(&quad_ord);
+  refmap.set_quad_2d(quad_ord);
 
   // make a mesh illustrating the distribution of polynomial orders over the space
   Element* e;
@@ -131,8 +135,8 @@ void Orderizer::process_space(Space* space)
     double* x = refmap.get_phys_x(type);
     double* y = refmap.get_phys_y(type);
 
-    double3* pt = quad_ord.get_points(type);
-    int np = quad_ord.get_num_points(type);
+    double3* pt = quad_ord->get_points(type);
+    int np = quad_ord->get_num_points(type);
     int id[80];
     assert(np <= 80);
 
@@ -25,8 +25,7 @@ extern int quad_indices[9][5];
 extern int lin_np_tri[2];
 extern int lin_np_quad[2];
 
-class Quad2DLin;
-extern Quad2DLin quad_lin;
+extern Quad2D* get_quad_lin();
 
 
 //// vertices and triangles ////////////////////////////////////////////////////////////////////////
@@ -409,11 +408,12 @@ void Vectorizer::process_solution(MeshFunction* xsln, int xitem, MeshFunction* y
 
   // select the linearization quadrature
   Quad2D *old_quad_x, *old_quad_y;
+  quad_lin = get_quad_lin();
   old_quad_x = xsln->get_quad_2d();
   old_quad_y = ysln->get_quad_2d();
 
-  xsln->set_quad_2d((Quad2D*) &quad_lin);
-  ysln->set_quad_2d((Quad2D*) &quad_lin);
+  xsln->set_quad_2d(quad_lin);
+  ysln->set_quad_2d(quad_lin);
 
   if (!xitem) error("Parameter 'xitem' cannot be zero.");
   if (!yitem) error("Parameter 'yitem' cannot be zero.");
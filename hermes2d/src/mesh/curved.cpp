@@ -22,9 +22,6 @@
 #include "../quadrature/quad_all.h"
 #include "../../../hermes_common/matrix.h"
   
-H1ShapesetJacobi CurvMap::ref_map_shapeset;
-PrecalcShapeset CurvMap::ref_map_pss(&ref_map_shapeset);
-
 double** CurvMap::edge_proj_matrix;
 double** CurvMap::bubble_proj_matrix_tri;
 double** CurvMap::bubble_proj_matrix_quad;
@@ -34,9 +31,34 @@ double* CurvMap::bubble_tri_p;
 double* CurvMap::bubble_quad_p;
 
 Quad1DStd CurvMap::quad1d;
-Quad2DStd CurvMap::quad2d;
 
-Trf CurvMap::ctm;
+// Protects the lazy calculation of the projection matrices.
+static pthread_mutex_t proj_matrix_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// The reference mapping shapeset, quadrature and the current transformation used while
+// projecting, one instance per thread.
+struct CurvMapContext
+{
+  CurvMapContext() : ref_map_pss(&ref_map_shapeset)
+  {
+    ref_map_pss.set_quad_2d(&quad2d);
+  }
+
+  H1ShapesetJacobi ref_map_shapeset;
+  PrecalcShapeset ref_map_pss;
+  Quad2DStd quad2d;
+  Trf ctm;
+};
+
+static ThreadLocalInstance<CurvMapContext> curv_map_contexts = H2D_THREAD_LOCAL_INSTANCE_INIT;
+
+static CurvMapContext* get_curv_map_context()
+{
+  static HERMES_THREAD_LOCAL CurvMapContext* ctx = NULL;
+  if (ctx == NULL)
+    ctx = curv_map_contexts.get();
+  return ctx;
+}
 
 //// NURBS //////////////////////////////////////////////////////////////////////////////////////////
 // recursive calculation of the basis function N_i,k
@@ -379,7 +401,8 @@ void CurvMap::calc_ref_map(Element* e, Nurbs** nurbs, double xi_1, double xi_2,
 void CurvMap::precalculate_cholesky_projection_matrix_edge()
 {
   _F_
-  int order = ref_map_shapeset.get_max_order();
+  CurvMapContext* ctx = get_curv_map_context();
+  int order = ctx->ref_map_shapeset.get_max_order();
   int n = order - 1; // number of edge basis functions
   edge_proj_matrix = new_matrix<double>(n, n);
 
@@ -487,6 +510,7 @@ void CurvMap::precalculate_cholesky_projection_matrix_edge()
 double** CurvMap::calculate_bubble_projection_matrix(int nb, int* indices)
 {
   _F_
+  CurvMapContext* ctx = get_curv_map_context();
   double** mat = new_matrix<double>(nb, nb);
 
   for (int i = 0; i < nb; i++)
@@ -494,20 +518,20 @@ double** CurvMap::calculate_bubble_projection_matrix(int nb, int* indices)
     for (int j = i; j < nb; j++)
     {
       int ii = indices[i], ij = indices[j];
-      int o = ref_map_shapeset.get_order(ii) + ref_map_shapeset.get_order(ij);
+      int o = ctx->ref_map_shapeset.get_order(ii) + ctx->ref_map_shapeset.get_order(ij);
       o = std::max(H2D_GET_V_ORDER(o), H2D_GET_H_ORDER(o));
 
-      ref_map_pss.set_active_shape(ii);
-      ref_map_pss.set_quad_order(o);
-      double* fni = ref_map_pss.get_fn_values();
+      ctx->ref_map_pss.set_active_shape(ii);
+      ctx->ref_map_pss.set_quad_order(o);
+      double* fni = ctx->ref_map_pss.get_fn_values();
 
-      ref_map_pss.set_active_shape(ij);
-      ref_map_pss.set_quad_order(o);
-      double* fnj = ref_map_pss.get_fn_values();
+      ctx->ref_map_pss.set_active_shape(ij);
+      ctx->ref_map_pss.set_quad_order(o);
+      double* fnj = ctx->ref_map_pss.get_fn_values();
 
-      double3* pt = quad2d.get_points(o);
+      double3* pt = ctx->quad2d.get_points(o);
       double val = 0.0;
-      for (int k = 0; k < quad2d.get_num_points(o); k++)
+      for (int k = 0; k < ctx->quad2d.get_num_points(o); k++)
         val += pt[k][2] * (fni[k] * fnj[k]);
 
       mat[i][j] = mat[j][i] = val;
@@ -521,13 +545,14 @@ double** CurvMap::calculate_bubble_projection_matrix(int nb, int* indices)
 void CurvMap::precalculate_cholesky_projection_matrices_bubble()
 {
   _F_
+  CurvMapContext* ctx = get_curv_map_context();
   // *** triangles ***
-  ref_map_pss.set_mode(HERMES_MODE_TRIANGLE);
-  int order = ref_map_shapeset.get_max_order();
+  ctx->ref_map_pss.set_mode(HERMES_MODE_TRIANGLE);
+  int order = ctx->ref_map_shapeset.get_max_order();
 
   // calculate projection matrix of maximum order
-  int nb = ref_map_shapeset.get_num_bubbles(order);
-  int* indices = ref_map_shapeset.get_bubble_indices(order);
+  int nb = ctx->ref_map_shapeset.get_num_bubbles(order);
+  int* indices = ctx->ref_map_shapeset.get_bubble_indices(order);
   bubble_proj_matrix_tri = calculate_bubble_projection_matrix(nb, indices);
 
   // cholesky factorization of the matrix
@@ -535,13 +560,13 @@ void CurvMap::precalculate_cholesky_projection_matrices_bubble()
   choldc(bubble_proj_matrix_tri, nb, bubble_tri_p);
 
   // *** quads ***
-  ref_map_pss.set_mode(HERMES_MODE_QUAD);
-  order = ref_map_shapeset.get_max_order();
+  ctx->ref_map_pss.set_mode(HERMES_MODE_QUAD);
+  order = ctx->ref_map_shapeset.get_max_order();
   order = H2D_MAKE_QUAD_ORDER(order, order);
 
   // calculate projection matrix of maximum order
-  nb = ref_map_shapeset.get_num_bubbles(order);
-  indices = ref_map_shapeset.get_bubble_indices(order);
+  nb = ctx->ref_map_shapeset.get_num_bubbles(order);
+  indices = ctx->ref_map_shapeset.get_bubble_indices(order);
   bubble_proj_matrix_quad = calculate_bubble_projection_matrix(nb, indices);
 
   // cholesky factorization of the matrix
@@ -556,12 +581,13 @@ void CurvMap::precalculate_cholesky_projection_matrices_bubble()
 void CurvMap::edge_coord(Element* e, int edge, double t, double2& x, double2& v)
 {
   _F_
+  CurvMapContext* ctx = get_curv_map_context();
   int mode = e->get_mode();
   double2 a, b;
-  a[0] = ctm.m[0] * ref_vert[mode][edge][0] + ctm.t[0];
-  a[1] = ctm.m[1] * ref_vert[mode][edge][1] + ctm.t[1];
-  b[0] = ctm.m[0] * ref_vert[mode][e->next_vert(edge)][0] + ctm.t[0];
-  b[1] = ctm.m[1] * ref_vert[mode][e->next_vert(edge)][1] + ctm.t[1];
+  a[0] = ctx->ctm.m[0] * ref_vert[mode][edge][0] + ctx->ctm.t[0];
+  a[1] = ctx->ctm.m[1] * ref_vert[mode][edge][1] + ctx->ctm.t[1];
+  b[0] = ctx->ctm.m[0] * ref_vert[mode][e->next_vert(edge)][0] + ctx->ctm.t[0];
+  b[1] = ctx->ctm.m[1] * ref_vert[mode][e->next_vert(edge)][1] + ctx->ctm.t[1];
 
   for (int i = 0; i < 2; i++)
   {
@@ -575,7 +601,8 @@ void CurvMap::edge_coord(Element* e, int edge, double t, double2& x, double2& v)
 void CurvMap::calc_edge_projection(Element* e, int edge, Nurbs** nurbs, int order, double2* proj)
 {
   _F_
-  ref_map_pss.set_active_element(e);
+  CurvMapContext* ctx = get_curv_map_context();
+  ctx->ref_map_pss.set_active_element(e);
 
   int i, j, k;
   int mo1 = quad1d.get_max_order();
@@ -591,10 +618,10 @@ void CurvMap::calc_edge_projection(Element* e, int edge, Nurbs** nurbs, int orde
   memset(rhside[1], 0, sizeof(double) * ne);
 
   double a_1, a_2, b_1, b_2;
-  a_1 = ctm.m[0] * ref_vert[mode][edge][0] + ctm.t[0];
-  a_2 = ctm.m[1] * ref_vert[mode][edge][1] + ctm.t[1];
-  b_1 = ctm.m[0] * ref_vert[mode][e->next_vert(edge)][0] + ctm.t[0];
-  b_2 = ctm.m[1] * ref_vert[mode][e->next_vert(edge)][1] + ctm.t[1];
+  a_1 = ctx->ctm.m[0] * ref_vert[mode][edge][0] + ctx->ctm.t[0];
+  a_2 = ctx->ctm.m[1] * ref_vert[mode][edge][1] + ctx->ctm.t[1];
+  b_1 = ctx->ctm.m[0] * ref_vert[mode][e->next_vert(edge)][0] + ctx->ctm.t[0];
+  b_2 = ctx->ctm.m[1] * ref_vert[mode][e->next_vert(edge)][1] + ctx->ctm.t[1];
 
   // values of nonpolynomial function in two vertices
   double2 fa, fb;
@@ -675,17 +702,18 @@ void CurvMap::calc_edge_projection(Element* e, int edge, Nurbs** nurbs, int orde
 void CurvMap::old_projection(Element* e, int order, double2* proj, double* old[2])
 {
   _F_
-  int mo2 = quad2d.get_max_order();
-  int np = quad2d.get_num_points(mo2);
+  CurvMapContext* ctx = get_curv_map_context();
+  int mo2 = ctx->quad2d.get_max_order();
+  int np = ctx->quad2d.get_num_points(mo2);
 
   for (unsigned int k = 0; k < e->nvert; k++) // loop over vertices
   {
     // vertex basis functions in all integration points
     double* vd;
-    int index_v = ref_map_shapeset.get_vertex_index(k);
-    ref_map_pss.set_active_shape(index_v);
-    ref_map_pss.set_quad_order(mo2);
-    vd = ref_map_pss.get_fn_values();
+    int index_v = ctx->ref_map_shapeset.get_vertex_index(k);
+    ctx->ref_map_pss.set_active_shape(index_v);
+    ctx->ref_map_pss.set_quad_order(mo2);
+    vd = ctx->ref_map_pss.get_fn_values();
 
     for (int m = 0; m < 2; m++)   // part 0 or 1
       for (int j = 0; j < np; j++)
@@ -695,10 +723,10 @@ void CurvMap::old_projection(Element* e, int order, double2* proj, double* old[2
     {
       // edge basis functions in all integration points
       double* ed;
-      int index_e = ref_map_shapeset.get_edge_index(k,0,ii+2);
-      ref_map_pss.set_active_shape(index_e);
-      ref_map_pss.set_quad_order(mo2);
-      ed = ref_map_pss.get_fn_values();
+      int index_e = ctx->ref_map_shapeset.get_edge_index(k,0,ii+2);
+      ctx->ref_map_pss.set_active_shape(index_e);
+      ctx->ref_map_pss.set_quad_order(mo2);
+      ed = ctx->ref_map_pss.get_fn_values();
 
       for (int m = 0; m < 2; m++)  //part 0 or 1
         for (int j = 0; j < np; j++)
@@ -710,13 +738,14 @@ void CurvMap::old_projection(Element* e, int order, double2* proj, double* old[2
 void CurvMap::calc_bubble_projection(Element* e, Nurbs** nurbs, int order, double2* proj)
 {
   _F_
-  ref_map_pss.set_active_element(e);
+  CurvMapContext* ctx = get_curv_map_context();
+  ctx->ref_map_pss.set_active_element(e);
 
   int i, j, k;
-  int mo2 = quad2d.get_max_order();
-  int np = quad2d.get_num_points(mo2);
+  int mo2 = ctx->quad2d.get_max_order();
+  int np = ctx->quad2d.get_num_points(mo2);
   int qo = e->is_quad() ? H2D_MAKE_QUAD_ORDER(order, order) : order;
-  int nb = ref_map_shapeset.get_num_bubbles(qo);
+  int nb = ctx->ref_map_shapeset.get_num_bubbles(qo);
 
   double2* fn = new double2[np];
   memset(fn, 0, np * sizeof(double2));
@@ -734,12 +763,12 @@ void CurvMap::calc_bubble_projection(Element* e, Nurbs** nurbs, int order, doubl
   old_projection(e, order, proj, old);
 
   // fn values of both components of nonpolynomial function
-  double3* pt = quad2d.get_points(mo2);
+  double3* pt = ctx->quad2d.get_points(mo2);
   for (j = 0; j < np; j++)  // over all integration points
   {
     double2 a;
-    a[0] = ctm.m[0] * pt[j][0] + ctm.t[0];
-    a[1] = ctm.m[1] * pt[j][1] + ctm.t[1];
+    a[0] = ctx->ctm.m[0] * pt[j][0] + ctx->ctm.t[0];
+    a[1] = ctx->ctm.m[1] * pt[j][1] + ctx->ctm.t[1];
     calc_ref_map(e, nurbs, a[0], a[1], fn[j]);
   }
 
@@ -750,10 +779,10 @@ void CurvMap::calc_bubble_projection(Element* e, Nurbs** nurbs, int order, doubl
     {
       // bubble basis functions in all integration points
       double *bfn;
-      int index_i = ref_map_shapeset.get_bubble_indices(qo)[i];
-      ref_map_pss.set_active_shape(index_i);
-      ref_map_pss.set_quad_order(mo2);
-      bfn = ref_map_pss.get_fn_values();
+      int index_i = ctx->ref_map_shapeset.get_bubble_indices(qo)[i];
+      ctx->ref_map_pss.set_active_shape(index_i);
+      ctx->ref_map_pss.set_quad_order(mo2);
+      bfn = ctx->ref_map_pss.get_fn_values();
 
       for (j = 0; j < np; j++) // over all integration points
         rhside[k][i] += pt[j][2] * (bfn[j] * (fn[j][k] - old[k][j]));
@@ -804,21 +833,24 @@ void CurvMap::ref_map_projection(Element* e, Nurbs** nurbs, int order, double2*
 void CurvMap::update_refmap_coeffs(Element* e)
 {
   _F_
-  ref_map_pss.set_quad_2d(&quad2d);
+  CurvMapContext* ctx = get_curv_map_context();
+  ctx->ref_map_pss.set_quad_2d(&ctx->quad2d);
   //ref_map_pss.set_active_element(e);
 
   // calculation of projection matrices
+  pthread_mutex_lock(&proj_matrix_mutex);
   if (edge_proj_matrix == NULL) precalculate_cholesky_projection_matrix_edge();
   if (bubble_proj_matrix_tri == NULL) precalculate_cholesky_projection_matrices_bubble();
+  pthread_mutex_unlock(&proj_matrix_mutex);
 
-  ref_map_pss.set_mode(e->get_mode());
-  ref_map_shapeset.set_mode(e->get_mode());
+  ctx->ref_map_pss.set_mode(e->get_mode());
+  ctx->ref_map_shapeset.set_mode(e->get_mode());
 
   // allocate projection coefficients
   int nv = e->nvert;
   int ne = order - 1;
   int qo = e->is_quad() ? H2D_MAKE_QUAD_ORDER(order, order) : order;
-  int nb = ref_map_shapeset.get_num_bubbles(qo);
+  int nb = ctx->ref_map_shapeset.get_num_bubbles(qo);
   nc = nv + nv*ne + nb;
   if (coeffs != NULL) {
     delete [] coeffs;
@@ -832,17 +864,17 @@ void CurvMap::update_refmap_coeffs(Element* e)
   Nurbs** nurbs;
   if (toplevel == false)
   {
-    ref_map_pss.set_active_element(e);
-    ref_map_pss.set_transform(part);
+    ctx->ref_map_pss.set_active_element(e);
+    ctx->ref_map_pss.set_transform(part);
     nurbs = parent->cm->nurbs;
   }
   else
   {
-    ref_map_pss.reset_transform();
+    ctx->ref_map_pss.reset_transform();
     nurbs = e->cm->nurbs;
   }
-  ctm = *(ref_map_pss.get_ctm());
-  ref_map_pss.reset_transform(); // fixme - do we need this?
+  ctx->ctm = *(ctx->ref_map_pss.get_ctm());
+  ctx->ref_map_pss.reset_transform(); // fixme - do we need this?
 
   // calculation of new projection coefficients
   ref_map_projection(e, nurbs, order, coeffs);
@@ -851,6 +883,7 @@ void CurvMap::update_refmap_coeffs(Element* e)
 void CurvMap::get_mid_edge_points(Element* e, double2* pt, int n)
 {
   _F_
+  CurvMapContext* ctx = get_curv_map_context();
   Nurbs** nurbs = this->nurbs;
   Transformable tran;
   tran.set_active_element(e);
@@ -862,12 +895,12 @@ void CurvMap::get_mid_edge_points(Element* e, double2* pt, int n)
     nurbs = e->cm->nurbs;
   }
 
-  ctm = *(tran.get_ctm());
+  ctx->ctm = *(tran.get_ctm());
   double xi_1, xi_2;
   for (int i = 0; i < n; i++)
   {
-    xi_1 = ctm.m[0] * pt[i][0] + ctm.t[0];
-    xi_2 = ctm.m[1] * pt[i][1] + ctm.t[1];
+    xi_1 = ctx->ctm.m[0] * pt[i][0] + ctx->ctm.t[0];
+    xi_2 = ctx->ctm.m[1] * pt[i][1] + ctx->ctm.t[1];
     calc_ref_map(e, nurbs, xi_1, xi_2, pt[i]);
   }
 }
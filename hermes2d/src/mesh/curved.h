@@ -100,9 +100,6 @@ public:
 
   void get_mid_edge_points(Element* e, double2* pt, int n);
 
-  static H1ShapesetJacobi ref_map_shapeset;
-  static PrecalcShapeset ref_map_pss;
-
   static double** edge_proj_matrix;  //projection matrix for each edge is the same
   static double** bubble_proj_matrix_tri; //projection matrix for triangle bubbles
   static double** bubble_proj_matrix_quad; //projection matrix for quad bubbles
@@ -112,9 +109,6 @@ public:
   static double* bubble_quad_p; // diagonal vector in cholesky factorization
 
   static Quad1DStd quad1d;
-  static Quad2DStd quad2d; // fixme: g_quad_2d_std
-
-  static Trf ctm;
 
   static double nurbs_basis_fn(int i, int k, double t, double* knot);
   static void nurbs_edge(Element* e, Nurbs* nurbs, int edge, double t, double& x, 
@@ -20,7 +20,7 @@
 #include <iostream>
 #include "h2d_reader.h"
 
-extern unsigned g_mesh_seq;
+extern unsigned next_mesh_seq();
 
 H2DReader::H2DReader()
 {
@@ -425,7 +425,7 @@ bool H2DReader::load_stream(std::istream &is, Mesh *mesh,
   }
   mesh->ninitial = mesh->elements.get_num_items();
 
-  mesh->seq = g_mesh_seq++;
+  mesh->seq = next_mesh_seq();
 
 
   return true;
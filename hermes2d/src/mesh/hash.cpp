@@ -98,6 +98,39 @@ void HashTable::rebuild()
 }
 
 
+void HashTable::grow()
+{
+  if (nodes.get_num_items() <= 2 * (mask+1)) return;
+
+  // move the lists of synonyms to the larger tables
+  int old_size = mask+1;
+  Node** old_tables[2] = { v_table, e_table };
+  mask = 4*old_size - 1;
+  v_table = new Node*[mask+1];
+  e_table = new Node*[mask+1];
+  memset(v_table, 0, (mask+1) * sizeof(Node*));
+  memset(e_table, 0, (mask+1) * sizeof(Node*));
+  Node** new_tables[2] = { v_table, e_table };
+
+  for (int t = 0; t < 2; t++)
+  {
+    for (int i = 0; i < old_size; i++)
+    {
+      Node* node = old_tables[t][i];
+      while (node != NULL)
+      {
+        Node* next = node->next_hash;
+        int idx = hash(node->p1, node->p2);
+        node->next_hash = new_tables[t][idx];
+        new_tables[t][idx] = node;
+        node = next;
+      }
+    }
+    delete [] old_tables[t];
+  }
+}
+
+
 void HashTable::free()
 {
   nodes.free();
@@ -160,6 +193,7 @@ Node* HashTable::get_vertex_node(int p1, int p2)
   // insert into hashtable
   newnode->next_hash = v_table[i];
   v_table[i] = newnode;
+  grow();
 
   return newnode;
 }
@@ -187,6 +221,7 @@ Node* HashTable::get_edge_node(int p1, int p2)
   // insert into hashtable
   newnode->next_hash = e_table[i];
   e_table[i] = newnode;
+  grow();
 
   return newnode;
 }
@@ -75,6 +75,10 @@ protected:
   /// Reconstructs the hashtable, after, e.g., the nodes have been loaded from a file.
   void rebuild();
 
+  /// Enlarges the hash table four times when it holds twice as many nodes as its size,
+  /// so that the lists of synonyms stay short as the mesh is refined.
+  void grow();
+
   /// Frees all memory used by the instance.
   void free();
 
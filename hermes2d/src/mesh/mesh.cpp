@@ -16,6 +16,7 @@
 #include "../h2d_common.h"
 #include "mesh.h"
 #include "h2d_reader.h"
+#include "mesh_index.h"
 
 
 //// nodes, element ////////////////////////////////////////////////////////////////////////////////
@@ -124,12 +125,22 @@ double Element::get_diameter() const
 
 //// mesh //////////////////////////////////////////////////////////////////////////////////////////
 
-unsigned g_mesh_seq = 0;
+static unsigned g_mesh_seq = 0;
+static pthread_mutex_t mesh_seq_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+unsigned next_mesh_seq()
+{
+  pthread_mutex_lock(&mesh_seq_mutex);
+  unsigned seq = g_mesh_seq++;
+  pthread_mutex_unlock(&mesh_seq_mutex);
+  return seq;
+}
 
 Mesh::Mesh() : HashTable()
 {
   nbase = nactive = ntopvert = ninitial = 0;
-  seq = g_mesh_seq++;
+  seq = next_mesh_seq();
+  index = NULL;
 }
 
 
@@ -141,6 +152,36 @@ Element* Mesh::get_element(int id) const
 }
 
 
+MeshIndex* Mesh::get_index()
+{
+  if (index == NULL) {
+    index = new MeshIndex(this);
+    MEM_CHECK(index);
+  }
+  if (!index->is_up_to_date()) index->build();
+  return index;
+}
+
+
+void Mesh::free_index()
+{
+  if (index != NULL) { delete index;  index = NULL; }
+}
+
+
+Element* Mesh::get_element_at(double x, double y, double& xi1, double& xi2, RefMap* refmap)
+{
+  return get_index()->find(x, y, xi1, xi2, refmap);
+}
+
+
+Element* Mesh::get_element_at(double x, double y)
+{
+  double xi1, xi2;
+  return get_index()->find(x, y, xi1, xi2);
+}
+
+
 int Mesh::get_edge_sons(Element* e, int edge, int& son1, int& son2)
 {
   assert(!e->active);
@@ -730,7 +771,7 @@ void refine_element(Mesh* mesh, Element* e, int refinement)
   }
   else refine_quad(mesh, e, refinement);
 
-  if (mesh != NULL) mesh->seq = g_mesh_seq++;
+  if (mesh != NULL) mesh->seq = next_mesh_seq();
 }
 
 void Mesh::refine_element_id(int id, int refinement)
@@ -752,10 +793,11 @@ void Mesh::refine_all_elements(int refinement, bool mark_as_initial)
     ninitial = this->get_max_element_id();
 }
 
-static int rtb_marker;
-static bool rtb_aniso;
-static bool rtb_tria_to_quad;
-static char* rtb_vert;
+// parameters of the refinement criteria below, set by the calling thread
+static HERMES_THREAD_LOCAL int rtb_marker;
+static HERMES_THREAD_LOCAL bool rtb_aniso;
+static HERMES_THREAD_LOCAL bool rtb_tria_to_quad;
+static HERMES_THREAD_LOCAL char* rtb_vert;
 
 void Mesh::refine_by_criterion(int (*criterion)(Element*), int depth)
 {
@@ -769,7 +811,7 @@ void Mesh::refine_by_criterion(int (*criterion)(Element*), int depth)
   elements.set_append_only(false);
 }
 
-static int rtv_id;
+static HERMES_THREAD_LOCAL int rtv_id;
 
 static int rtv_criterion(Element* e)
 {
@@ -865,7 +907,7 @@ void Mesh::unrefine_element_id(int id)
       unrefine_element_id(e->sons[i]->id);
 
   unrefine_element_internal(e);
-  seq = g_mesh_seq++;
+  seq = next_mesh_seq();
 }
 
 
@@ -1066,7 +1108,7 @@ void Mesh::create(int nv, double2* verts, int nt, int4* tris,
   }
 
   nbase = nactive = ninitial = nt + nq;
-  seq = g_mesh_seq++;
+  seq = next_mesh_seq();
 }
 
 bool Mesh::rescale(double x_ref, double y_ref) 
@@ -1092,6 +1134,7 @@ bool Mesh::rescale(double x_ref, double y_ref)
     n->x /= x_ref;
     n->y /= y_ref;
   }
+  free_index();
 
   return true;
 }
@@ -1215,7 +1258,7 @@ void Mesh::copy_base(Mesh* mesh)
 
   nbase = nactive = ninitial = mesh->nbase;
   ntopvert = mesh->ntopvert;
-  seq = g_mesh_seq++;
+  seq = next_mesh_seq();
 }
 
 
@@ -1233,6 +1276,7 @@ void Mesh::free()
 
   elements.free();
   HashTable::free();
+  free_index();
 }
 
 void Mesh::copy_converted(Mesh* mesh)
@@ -1317,7 +1361,7 @@ void Mesh::copy_converted(Mesh* mesh)
 
   nbase = nactive = ninitial = mesh->nactive;
   ntopvert = mesh->ntopvert = get_num_nodes();
-  seq = g_mesh_seq++;
+  seq = next_mesh_seq();
 }
 
 ////convert a triangle element into three quadrilateral elements///////
@@ -1744,7 +1788,7 @@ void Mesh::refine_element_to_quads_id(int id)
   else
     refine_quad_to_quads(e);
 
-  seq = g_mesh_seq++;
+  seq = next_mesh_seq();
 }
 
 
@@ -1944,7 +1988,7 @@ void Mesh::refine_element_to_triangles_id(int id)
   else
     refine_quad_to_triangles(e);
 
-  seq = g_mesh_seq++;
+  seq = next_mesh_seq();
 }
 
 void Mesh::convert_element_to_base_id(int id)
@@ -1958,7 +2002,7 @@ void Mesh::convert_element_to_base_id(int id)
   else
     convert_quads_to_base(e);// FIXME:
 
-  seq = g_mesh_seq++;
+  seq = next_mesh_seq();
 }
 
 void Mesh::load(const char* filename, bool debug)
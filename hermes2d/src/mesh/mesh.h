@@ -22,6 +22,8 @@
 class Element;
 class HashTable;
 class Space;
+class MeshIndex;
+class RefMap;
 struct MItem;
 
 /// \brief Stores one node of a mesh.
@@ -198,6 +200,18 @@ public:
   /// Retrieves an element by its id number.
   Element* get_element(int id) const;
 
+  /// Returns the active element containing the point (x, y) and the reference coordinates of
+  /// the point in it, NULL if the point is not in the mesh. The element is found by the spatial
+  /// index of the mesh (see get_index()). The reference mappings are inverted by the refmap,
+  /// which is left set to the element, or by the one of the index if NULL (not thread-safe).
+  Element* get_element_at(double x, double y, double& xi1, double& xi2, RefMap* refmap = NULL);
+  Element* get_element_at(double x, double y);
+
+  /// Returns the spatial index of the active elements (see MeshIndex). It is built on the first
+  /// call and rebuilt when the mesh has changed since, so the first call after a change should
+  /// not be made by several threads at once.
+  MeshIndex* get_index();
+
   /// Returns the total number of elements stored.
   int get_num_elements() const {
     if (this == NULL) error("this == NULL in Mesh::get_num_elements().");
@@ -323,6 +337,9 @@ protected:
   int nbase, ntopvert;
   int ninitial;
 
+  MeshIndex* index; ///< spatial index of the active elements, NULL if not built
+  void free_index();
+
   void unrefine_element_internal(Element* e);
 
   Nurbs* reverse_nurbs(Nurbs* nurbs);
@@ -0,0 +1,194 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "mesh_index.h"
+#include "mesh.h"
+
+// number of points sampled on every edge of a curved element
+static const int H2D_BBOX_SAMPLES = 8;
+// enlargement of the bounding box of a curved element relative to its diameter
+static const double H2D_BBOX_CURVED = 0.05;
+// enlargement of all bounding boxes relative to the size of the mesh
+static const double H2D_BBOX_TOL = 1e-10;
+
+MeshIndex::MeshIndex(Mesh* mesh)
+{
+  this->mesh = mesh;
+  seq = 0;
+  nactive = max_id = -1;
+  x0 = y0 = 0.0;
+  inv_hx = inv_hy = 0.0;
+  nx = ny = 0;
+}
+
+bool MeshIndex::is_up_to_date() const
+{
+  return nx > 0 && mesh->get_seq() == seq && mesh->get_num_active_elements() == nactive
+         && mesh->get_max_element_id() == max_id;
+}
+
+void MeshIndex::get_bbox(Element* e, double* box)
+{
+  box[0] = box[2] = e->vn[0]->x;
+  box[1] = box[3] = e->vn[0]->y;
+  for (unsigned int i = 1; i < e->nvert; i++) {
+    box[0] = std::min(box[0], e->vn[i]->x);  box[2] = std::max(box[2], e->vn[i]->x);
+    box[1] = std::min(box[1], e->vn[i]->y);  box[3] = std::max(box[3], e->vn[i]->y);
+  }
+  if (!e->is_curved()) return;
+
+  // sample the edges by the reference mapping
+  static const double ref_vert[2][4][2] = {
+    { { -1, -1 }, { 1, -1 }, { -1, 1 }, { 0, 0 } },
+    { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } }
+  };
+  const double (*rv)[2] = ref_vert[e->get_mode()];
+  refmap.set_active_element(e);
+  for (unsigned int i = 0; i < e->nvert; i++) {
+    const double* a = rv[i];
+    const double* b = rv[e->next_vert(i)];
+    for (int k = 1; k < H2D_BBOX_SAMPLES; k++) {
+      double t = (double) k / H2D_BBOX_SAMPLES, x, y;
+      double2x2 m;
+      refmap.inv_ref_map_at_point(a[0] + t * (b[0] - a[0]), a[1] + t * (b[1] - a[1]), x, y, m);
+      box[0] = std::min(box[0], x);  box[2] = std::max(box[2], x);
+      box[1] = std::min(box[1], y);  box[3] = std::max(box[3], y);
+    }
+  }
+  double d = H2D_BBOX_CURVED * e->get_diameter();
+  box[0] -= d;  box[1] -= d;  box[2] += d;  box[3] += d;
+}
+
+void MeshIndex::get_cells(const double* box, int& i0, int& j0, int& i1, int& j1) const
+{
+  i0 = std::max(0, std::min(nx - 1, (int) floor((box[0] - x0) * inv_hx)));
+  j0 = std::max(0, std::min(ny - 1, (int) floor((box[1] - y0) * inv_hy)));
+  i1 = std::max(0, std::min(nx - 1, (int) floor((box[2] - x0) * inv_hx)));
+  j1 = std::max(0, std::min(ny - 1, (int) floor((box[3] - y0) * inv_hy)));
+}
+
+void MeshIndex::build()
+{
+  _F_
+  seq = mesh->get_seq();
+  nactive = mesh->get_num_active_elements();
+  max_id = mesh->get_max_element_id();
+
+  // bounding boxes of the elements and of the mesh
+  elems.clear();
+  boxes.clear();
+  elems.reserve(nactive);
+  boxes.reserve(4 * nactive);
+  double mbox[4] = { 0, 0, 0, 0 };
+  Element* e;
+  for_all_active_elements(e, mesh) {
+    double box[4];
+    get_bbox(e, box);
+    if (elems.empty())
+      memcpy(mbox, box, sizeof(mbox));
+    else {
+      mbox[0] = std::min(mbox[0], box[0]);  mbox[1] = std::min(mbox[1], box[1]);
+      mbox[2] = std::max(mbox[2], box[2]);  mbox[3] = std::max(mbox[3], box[3]);
+    }
+    elems.push_back(e);
+    boxes.insert(boxes.end(), box, box + 4);
+  }
+  int n = (int) elems.size();
+
+  double w = mbox[2] - mbox[0], h = mbox[3] - mbox[1];
+  double tol = H2D_BBOX_TOL * std::max(w, h);
+  for (int k = 0; k < n; k++) {
+    boxes[4*k] -= tol;  boxes[4*k+1] -= tol;
+    boxes[4*k+2] += tol;  boxes[4*k+3] += tol;
+  }
+
+  // about one cell per element, of the aspect ratio of the mesh
+  w = std::max(w, tol);
+  h = std::max(h, tol);
+  nx = std::max(1, std::min(1 << 15, (int) ceil(sqrt(n * w / h))));
+  ny = std::max(1, std::min(1 << 15, (int) ceil(sqrt(n * h / w))));
+  x0 = mbox[0] - tol;
+  y0 = mbox[1] - tol;
+  inv_hx = nx / (w + 2 * tol);
+  inv_hy = ny / (h + 2 * tol);
+
+  // count the elements of the cells, then fill them
+  start.assign(nx * ny + 1, 0);
+  for (int k = 0; k < n; k++) {
+    int i0, j0, i1, j1;
+    get_cells(&boxes[4*k], i0, j0, i1, j1);
+    for (int j = j0; j <= j1; j++)
+      for (int i = i0; i <= i1; i++)
+        start[j * nx + i + 1]++;
+  }
+  for (int c = 0; c < nx * ny; c++)
+    start[c + 1] += start[c];
+
+  items.resize(start[nx * ny]);
+  std::vector<int> pos(start.begin(), start.end() - 1);
+  for (int k = 0; k < n; k++) {
+    int i0, j0, i1, j1;
+    get_cells(&boxes[4*k], i0, j0, i1, j1);
+    for (int j = j0; j <= j1; j++)
+      for (int i = i0; i <= i1; i++)
+        items[pos[j * nx + i]++] = k;
+  }
+}
+
+Element** MeshIndex::get_candidates(double x, double y, int& n)
+{
+  result.clear();
+  n = 0;
+  if (x < x0 || y < y0) return NULL;
+  int i = (int) ((x - x0) * inv_hx), j = (int) ((y - y0) * inv_hy);
+  if (i >= nx || j >= ny) return NULL;
+
+  int c = j * nx + i;
+  for (int k = start[c]; k < start[c + 1]; k++) {
+    const double* box = &boxes[4 * items[k]];
+    if (x >= box[0] && x <= box[2] && y >= box[1] && y <= box[3])
+      result.push_back(elems[items[k]]);
+  }
+  n = (int) result.size();
+  return n ? &result[0] : NULL;
+}
+
+Element* MeshIndex::find(double x, double y, double& xi1, double& xi2, RefMap* refmap)
+{
+  if (refmap == NULL) refmap = &this->refmap;
+  int n;
+  Element** cand = get_candidates(x, y, n);
+  for (int k = 0; k < n; k++) {
+    refmap->set_active_element(cand[k]);
+    refmap->untransform(cand[k], x, y, xi1, xi2);
+    if (is_in_ref_domain(cand[k], xi1, xi2)) return cand[k];
+  }
+  return NULL;
+}
+
+bool MeshIndex::is_in_ref_domain(Element* e, double xi1, double xi2)
+{
+  const double TOL = 1e-11;
+  if (e->is_triangle())
+    return (xi1 + xi2 <= TOL) && (xi1 + 1.0 >= -TOL) && (xi2 + 1.0 >= -TOL);
+  else
+    return (xi1 - 1.0 <= TOL) && (xi1 + 1.0 >= -TOL) && (xi2 - 1.0 <= TOL) && (xi2 + 1.0 >= -TOL);
+}
+
+size_t MeshIndex::get_memory() const
+{
+  return start.capacity() * sizeof(int) + items.capacity() * sizeof(int)
+         + elems.capacity() * sizeof(Element*) + boxes.capacity() * sizeof(double);
+}
@@ -0,0 +1,87 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __H2D_MESH_INDEX_H
+#define __H2D_MESH_INDEX_H
+
+#include "refmap.h"
+
+class Mesh;
+
+/// \brief Spatial index of the active elements of a mesh for locating points.
+///
+/// The bounding boxes of the active elements are sorted into a uniform grid of about as many
+/// cells as there are elements, covering the bounding box of the mesh. A point is located by
+/// inverting the reference mappings of the few elements registered in its cell, instead of all
+/// elements of the mesh. The bounding boxes of curved elements are taken from their edges
+/// sampled by the reference mapping, enlarged by a part of the diameter.
+///
+/// The index is built for the state of the mesh at the time of build() and is up to date as
+/// long as the mesh does not change (see is_up_to_date()). Usually it is obtained by
+/// Mesh::get_index(), which rebuilds it when needed. Not thread-safe when the refmap of the
+/// index is used (see find()).
+class HERMES_API MeshIndex
+{
+public:
+  MeshIndex(Mesh* mesh);
+
+  /// Builds the index of the current active elements of the mesh.
+  void build();
+
+  /// Returns true if the mesh has not been changed since build().
+  bool is_up_to_date() const;
+
+  /// Returns the active elements whose bounding boxes may contain the point (x, y), n of them.
+  Element** get_candidates(double x, double y, int& n);
+
+  /// Returns the active element containing the point (x, y) and the reference coordinates of
+  /// the point in it, NULL if the point is not in the mesh. The reference mappings are inverted
+  /// by the refmap (by the own one of the index if NULL), which is left set to the element.
+  Element* find(double x, double y, double& xi1, double& xi2, RefMap* refmap = NULL);
+
+  /// Returns true if the reference coordinates lie in the reference domain of the element.
+  static bool is_in_ref_domain(Element* e, double xi1, double xi2);
+
+  /// Statistics.
+  int get_num_cells() const { return nx * ny; }
+  /// Average number of elements registered in a cell.
+  double get_avg_cell_size() const { return (double) items.size() / (nx * ny); }
+  size_t get_memory() const;
+
+protected:
+  Mesh* mesh;
+  unsigned seq;                     ///< State of the mesh at build().
+  int nactive, max_id;
+
+  double x0, y0;                    ///< Lower left corner of the grid.
+  double inv_hx, inv_hy;            ///< Inverse sizes of the cells.
+  int nx, ny;
+
+  /// The elements of the cell i are elems[items[k]] for start[i] <= k < start[i+1], with
+  /// the bounding boxes boxes[items[k]] (xmin, ymin, xmax, ymax).
+  std::vector<int> start, items;
+  std::vector<Element*> elems;
+  std::vector<double> boxes;
+  std::vector<Element*> result;     ///< Scratch space of get_candidates().
+
+  RefMap refmap;
+
+  /// Calculates the bounding box of the element.
+  void get_bbox(Element* e, double* box);
+  /// Returns the range of the cells overlapped by the box.
+  void get_cells(const double* box, int& i0, int& j0, int& i1, int& j1) const;
+};
+
+#endif
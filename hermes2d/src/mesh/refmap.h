@@ -45,6 +45,11 @@ public:
   /// Returns the current quadrature points.
   Quad2D* get_quad_2d() const { return quad_2d; }
 
+  /// Sets the (master) PrecalcShapeset used for evaluating reference maps in the calling
+  /// thread, NULL restores the default one. Every thread has its own default instance,
+  /// this is meant for threads which keep their own pss with their other data.
+  static void set_thread_ref_map_pss(PrecalcShapeset* pss);
+
   /// Returns the 1D quadrature for use in surface integrals.
   const Quad1D* get_quad_1d() const { return &quad_1d; }
 
@@ -1,9 +1,6 @@
 #include "trans.h"
 #define countof(a) (sizeof(a)/sizeof(a[0]))
 
-// taken form RefMap.cpp
-extern H1ShapesetJacobi ref_map_shapeset;
-
 // vertical edge
 double2 e0_pt[] = {
 	{ -1,  1 },
@@ -32,6 +29,8 @@ double2 *transform_element(Element *e, int np, double2 *pt)
 {
 	Quad2D *quad_2d = &g_quad_2d_std;
 
+	// the shapeset of the reference mapping, as in RefMap
+	H1ShapesetJacobi ref_map_shapeset;
 	ref_map_shapeset.set_mode(e->get_mode());
 
 	// transform all x coordinates of the integration points
@@ -0,0 +1,384 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "h2d_common.h"
+#include "precond_pmg.h"
+#include "asmlist.h"
+
+PMultigridPrecond::PMultigridPrecond(Hermes::vector<Space *> spaces) : NativePrecond()
+{
+  _F_
+  this->spaces = spaces;
+  pre_sweeps = post_sweeps = 2;
+  order_halving = true;
+  coarse_solver = PMG_COARSE_AMG;
+  umf_matrix = NULL;
+  umf_rhs = NULL;
+  umf_solver = NULL;
+  umf_src = NULL;
+  umf_new_values = false;
+  fine_Ap = fine_Aj = NULL;
+  fine_size = fine_nnz = 0;
+}
+
+PMultigridPrecond::PMultigridPrecond(Space *space) : NativePrecond()
+{
+  _F_
+  this->spaces = Hermes::vector<Space *>(space);
+  pre_sweeps = post_sweeps = 2;
+  order_halving = true;
+  coarse_solver = PMG_COARSE_AMG;
+  umf_matrix = NULL;
+  umf_rhs = NULL;
+  umf_solver = NULL;
+  umf_src = NULL;
+  umf_new_values = false;
+  fine_Ap = fine_Aj = NULL;
+  fine_size = fine_nnz = 0;
+}
+
+PMultigridPrecond::~PMultigridPrecond()
+{
+  _F_
+  destroy();
+}
+
+void PMultigridPrecond::set_smoothing_steps(int pre_sweeps, int post_sweeps)
+{
+  _F_
+  if (pre_sweeps < 0 || post_sweeps < 0) error("PMultigridPrecond: invalid number of smoothing steps.");
+  this->pre_sweeps = pre_sweeps;
+  this->post_sweeps = post_sweeps;
+}
+
+void PMultigridPrecond::set_coarse_solver(PMultigridCoarseSolver coarse_solver)
+{
+  _F_
+  this->coarse_solver = coarse_solver;
+  // The coarsest level is set up again in the next compute().
+  free_levels();
+}
+
+void PMultigridPrecond::destroy()
+{
+  _F_
+  free_levels();
+  coarse_amg.destroy();
+  NativePrecond::destroy();
+}
+
+void PMultigridPrecond::free_levels()
+{
+  for (unsigned int l = 0; l < levels.size(); l++) {
+    Level &L = levels[l];
+    if (l > 0) {
+      delete L.A;
+      delete [] L.x;
+      delete [] L.b;
+    }
+    delete [] L.src;
+    delete [] L.to_coarse;
+    delete [] L.inv_diag;
+    delete [] L.r;
+  }
+  levels.clear();
+  delete umf_solver; umf_solver = NULL;
+  delete umf_matrix; umf_matrix = NULL;
+  delete umf_rhs; umf_rhs = NULL;
+  delete [] umf_src; umf_src = NULL;
+  delete [] fine_Ap; fine_Ap = NULL;
+  delete [] fine_Aj; fine_Aj = NULL;
+  fine_size = fine_nnz = 0;
+}
+
+bool PMultigridPrecond::same_structure(CSRMatrix *a)
+{
+  return fine_Ap != NULL && fine_size == a->get_size() && fine_nnz == a->get_nnz()
+         && memcmp(fine_Ap, a->get_Ap(), sizeof(int) * (fine_size + 1)) == 0
+         && memcmp(fine_Aj, a->get_Aj(), sizeof(int) * fine_nnz) == 0;
+}
+
+void PMultigridPrecond::get_dof_orders(int *orders, int ndof)
+{
+  _F_
+  // A DOF can appear with a lower degree in the assembly lists of constrained elements,
+  // so the largest degree is taken.
+  for (int i = 0; i < ndof; i++) orders[i] = 0;
+  AsmList al;
+  for (unsigned int s = 0; s < spaces.size(); s++) {
+    Shapeset *shapeset = spaces[s]->get_shapeset();
+    Element *e;
+    for_all_active_elements(e, spaces[s]->get_mesh()) {
+      spaces[s]->get_element_assembly_list(e, &al);
+      shapeset->set_mode(e->get_mode());
+      for (unsigned int k = 0; k < al.cnt; k++) {
+        if (al.dof[k] < 0) continue;
+        int order = shapeset->get_order(al.idx[k]);
+        if (e->is_quad()) order = std::max(H2D_GET_H_ORDER(order), H2D_GET_V_ORDER(order));
+        orders[al.dof[k]] = std::max(orders[al.dof[k]], order);
+      }
+    }
+  }
+}
+
+void PMultigridPrecond::setup_levels(CSRMatrix *a)
+{
+  _F_
+  int n = a->get_size();
+  if (Space::get_num_dofs(spaces) != n) error("PMultigridPrecond: the matrix does not match the spaces.");
+
+  int *orders = new int[n];
+  MEM_CHECK(orders);
+  get_dof_orders(orders, n);
+  int max_order = 1;
+  for (int i = 0; i < n; i++) max_order = std::max(max_order, orders[i]);
+
+  Level fine;
+  memset(&fine, 0, sizeof(Level));
+  fine.order = max_order;
+  fine.A = a;
+  fine.r = new scalar[n];
+  MEM_CHECK(fine.r);
+  levels.push_back(fine);
+
+  // Fine indices of the DOFs of the current level.
+  std::vector<int> fine_dofs(n);
+  for (int i = 0; i < n; i++) fine_dofs[i] = i;
+
+  int order = max_order;
+  while (order > 1) {
+    order = order_halving ? std::max(order / 2, 1) : order - 1;
+    Level &L = levels.back();
+    int size = L.A->get_size();
+
+    int *to_coarse = new int[size];
+    MEM_CHECK(to_coarse);
+    int nc = 0;
+    for (int i = 0; i < size; i++)
+      to_coarse[i] = (orders[fine_dofs[i]] <= order) ? nc++ : -1;
+    if (nc == size) {
+      // No DOFs of the degrees between order and L.order.
+      delete [] to_coarse;
+      continue;
+    }
+    L.to_coarse = to_coarse;
+
+    // The principal submatrix.
+    int *Ap = L.A->get_Ap(), *Aj = L.A->get_Aj();
+    int *Cp = new int[nc + 1];
+    MEM_CHECK(Cp);
+    Cp[0] = 0;
+    for (int i = 0; i < size; i++) {
+      if (to_coarse[i] < 0) continue;
+      int count = 0;
+      for (int k = Ap[i]; k < Ap[i + 1]; k++)
+        if (to_coarse[Aj[k]] >= 0) count++;
+      Cp[to_coarse[i] + 1] = Cp[to_coarse[i]] + count;
+    }
+    int *Cj = new int[Cp[nc]];
+    int *src = new int[Cp[nc]];
+    scalar *Cx = new scalar[Cp[nc]];
+    MEM_CHECK(Cj);
+    MEM_CHECK(src);
+    MEM_CHECK(Cx);
+    memset(Cx, 0, sizeof(scalar) * Cp[nc]);
+    std::vector<int> coarse_fine_dofs(nc);
+    for (int i = 0; i < size; i++) {
+      if (to_coarse[i] < 0) continue;
+      int c = Cp[to_coarse[i]];
+      for (int k = Ap[i]; k < Ap[i + 1]; k++)
+        if (to_coarse[Aj[k]] >= 0) {
+          Cj[c] = to_coarse[Aj[k]];
+          src[c++] = (L.src != NULL) ? L.src[k] : k;
+        }
+      coarse_fine_dofs[to_coarse[i]] = fine_dofs[i];
+    }
+
+    Level coarse;
+    memset(&coarse, 0, sizeof(Level));
+    coarse.order = order;
+    coarse.A = new CSRMatrix;
+    coarse.A->set_num_threads(a->get_num_threads());
+    coarse.A->create(nc, Cp[nc], Cp, Cj, Cx);
+    coarse.src = src;
+    coarse.x = new scalar[nc];
+    coarse.b = new scalar[nc];
+    coarse.r = new scalar[nc];
+    MEM_CHECK(coarse.x);
+    MEM_CHECK(coarse.b);
+    MEM_CHECK(coarse.r);
+    delete [] Cp;
+    delete [] Cj;
+    delete [] Cx;
+    levels.push_back(coarse);
+    fine_dofs.swap(coarse_fine_dofs);
+  }
+  delete [] orders;
+}
+
+void PMultigridPrecond::setup_umfpack()
+{
+  _F_
+  // Columns of the coarsest matrix.
+  CSRMatrix *a = levels.back().A;
+  int n = a->get_size(), nnz = a->get_nnz();
+  int *Ap = a->get_Ap(), *Aj = a->get_Aj();
+  int *cp = new int[n + 1];
+  int *ci = new int[nnz];
+  scalar *cx = new scalar[nnz];
+  umf_src = new int[nnz];
+  MEM_CHECK(cp);
+  MEM_CHECK(ci);
+  MEM_CHECK(cx);
+  MEM_CHECK(umf_src);
+  memset(cp, 0, sizeof(int) * (n + 1));
+  memset(cx, 0, sizeof(scalar) * nnz);
+  for (int k = 0; k < nnz; k++) cp[Aj[k] + 1]++;
+  for (int j = 0; j < n; j++) cp[j + 1] += cp[j];
+  std::vector<int> next(cp, cp + n);
+  for (int i = 0; i < n; i++)
+    for (int k = Ap[i]; k < Ap[i + 1]; k++) {
+      int t = next[Aj[k]]++;
+      ci[t] = i;
+      umf_src[t] = k;
+    }
+
+  umf_matrix = new UMFPackMatrix;
+  umf_matrix->create(n, nnz, cp, ci, cx);
+  umf_rhs = new UMFPackVector(n);
+  umf_solver = new UMFPackLinearSolver(umf_matrix, umf_rhs);
+  delete [] cp;
+  delete [] ci;
+  delete [] cx;
+}
+
+void PMultigridPrecond::compute()
+{
+  _F_
+  CSRMatrix *a = get_rows();
+  if (!same_structure(a)) {
+    free_levels();
+    fine_size = a->get_size();
+    fine_nnz = a->get_nnz();
+    fine_Ap = new int[fine_size + 1];
+    fine_Aj = new int[fine_nnz];
+    MEM_CHECK(fine_Ap);
+    MEM_CHECK(fine_Aj);
+    memcpy(fine_Ap, a->get_Ap(), sizeof(int) * (fine_size + 1));
+    memcpy(fine_Aj, a->get_Aj(), sizeof(int) * fine_nnz);
+    setup_levels(a);
+    if (coarse_solver == PMG_COARSE_UMFPACK) setup_umfpack();
+  }
+  else
+    levels[0].A = a;
+
+  // Values of the levels.
+  scalar *fine_Ax = a->get_Ax();
+  for (unsigned int l = 0; l < levels.size(); l++) {
+    Level &L = levels[l];
+    int n = L.A->get_size();
+    int *Ap = L.A->get_Ap(), *Aj = L.A->get_Aj();
+    scalar *Ax = L.A->get_Ax();
+    if (l > 0)
+      for (int k = 0; k < Ap[n]; k++) Ax[k] = fine_Ax[L.src[k]];
+    if (L.inv_diag == NULL) {
+      L.inv_diag = new scalar[n];
+      MEM_CHECK(L.inv_diag);
+    }
+    for (int i = 0; i < n; i++) {
+      scalar d = 0.0;
+      for (int k = Ap[i]; k < Ap[i + 1]; k++)
+        if (Aj[k] == i) d = Ax[k];
+      if (d == 0.0) error("PMultigridPrecond: zero diagonal entry in row %d of level %d.", i, l);
+      L.inv_diag[i] = 1.0 / d;
+    }
+  }
+
+  // The lowest-order problem.
+  CSRMatrix *coarsest = levels.back().A;
+  if (coarse_solver == PMG_COARSE_AMG) {
+    coarse_amg.create(coarsest);
+    coarse_amg.compute();
+  }
+  else {
+    scalar *Ax = coarsest->get_Ax(), *umf_Ax = umf_matrix->get_Ax();
+    for (unsigned int t = 0; t < coarsest->get_nnz(); t++) umf_Ax[t] = Ax[umf_src[t]];
+    umf_new_values = true;
+  }
+
+  computed = true;
+  verbose("PMultigridPrecond: %d levels, degree %d (%u DOFs) to %d (%u DOFs).", (int) levels.size(),
+          levels[0].order, levels[0].A->get_size(), levels.back().order, coarsest->get_size());
+}
+
+void PMultigridPrecond::smooth(int l, scalar *b, scalar *x, int sweeps, bool forward)
+{
+  Level &L = levels[l];
+  int n = L.A->get_size();
+  int *Ap = L.A->get_Ap(), *Aj = L.A->get_Aj();
+  scalar *Ax = L.A->get_Ax();
+
+  for (int s = 0; s < sweeps; s++)
+    for (int m = 0; m < n; m++) {
+      int i = forward ? m : n - 1 - m;
+      scalar res = b[i];
+      for (int k = Ap[i]; k < Ap[i + 1]; k++) res -= Ax[k] * x[Aj[k]];
+      x[i] += L.inv_diag[i] * res;
+    }
+}
+
+void PMultigridPrecond::cycle(int l, scalar *b, scalar *x)
+{
+  Level &L = levels[l];
+  int n = L.A->get_size();
+
+  if (l + 1 == (int) levels.size()) {
+    if (coarse_solver == PMG_COARSE_AMG)
+      coarse_amg.apply(b, x);
+    else {
+      for (int i = 0; i < n; i++) umf_rhs->set(i, b[i]);
+      Solver *solver = umf_solver;
+      solver->set_factorization_scheme(umf_new_values ? HERMES_REUSE_MATRIX_REORDERING
+                                                      : HERMES_REUSE_FACTORIZATION_COMPLETELY);
+      if (!solver->solve()) error("PMultigridPrecond: UMFPACK failed on the lowest-order problem.");
+      umf_new_values = false;
+      memcpy(x, solver->get_solution(), sizeof(scalar) * n);
+    }
+    return;
+  }
+
+  Level &C = levels[l + 1];
+  int nc = C.A->get_size();
+  smooth(l, b, x, pre_sweeps, true);
+
+  // Restriction of the residual (the injection).
+  L.A->multiply_with_vector(x, L.r);
+  for (int i = 0; i < n; i++)
+    if (L.to_coarse[i] >= 0) C.b[L.to_coarse[i]] = b[i] - L.r[i];
+
+  memset(C.x, 0, sizeof(scalar) * nc);
+  cycle(l + 1, C.b, C.x);
+  for (int i = 0; i < n; i++)
+    if (L.to_coarse[i] >= 0) x[i] += C.x[L.to_coarse[i]];
+
+  smooth(l, b, x, post_sweeps, false);
+}
+
+void PMultigridPrecond::apply(scalar *r, scalar *z)
+{
+  if (levels.empty()) error("PMultigridPrecond: compute() has to be called before apply().");
+  memset(z, 0, sizeof(scalar) * levels[0].A->get_size());
+  cycle(0, r, z);
+}
@@ -0,0 +1,111 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __H2D_PRECOND_PMG_H
+#define __H2D_PRECOND_PMG_H
+
+#include "../../hermes_common/solver/precond_amg.h"
+#include "../../hermes_common/solver/umfpack_solver.h"
+#include "space/space.h"
+
+/// Solvers of the lowest-order problem in PMultigridPrecond.
+enum PMultigridCoarseSolver
+{
+  PMG_COARSE_AMG,       ///< One cycle of AMGPrecond.
+  PMG_COARSE_UMFPACK    ///< Direct solution by UMFPACK.
+};
+
+/// Polynomial multigrid preconditioner for spaces with hierarchic shapesets.
+///
+/// Every DOF is assigned the polynomial degree of its basis function (taken from the
+/// assembly lists of the elements, the degree of a quad function is the larger one of its
+/// two directional degrees). The level of degree q consists of the DOFs of degree at most q,
+/// so the prolongation to the next finer level is the injection and the matrix of the level
+/// is the corresponding principal submatrix of the fine matrix (the Galerkin product). The
+/// degrees of the levels are p, p/2, p/4, ..., 1 where p is the largest degree (or p, p - 1,
+/// ..., 1, see set_order_halving()).
+///
+/// The levels are smoothed by symmetric Gauss-Seidel, the lowest-order problem is solved
+/// by AMGPrecond (default) or UMFPACK. apply() performs one V-cycle, which is symmetric, so
+/// the preconditioner can be used with CG.
+///
+/// The levels are set up in compute() for the spaces given in the constructor, they are kept
+/// as long as the structure of the matrix does not change (then only the values of the level
+/// matrices are copied from the fine matrix).
+///
+/// @ingroup preconds
+class HERMES_API PMultigridPrecond : public NativePrecond {
+public:
+  PMultigridPrecond(Hermes::vector<Space *> spaces);
+  PMultigridPrecond(Space *space);
+  virtual ~PMultigridPrecond();
+
+  virtual void destroy();
+  virtual void compute();
+  virtual void apply(scalar *r, scalar *z);
+
+  /// Numbers of Gauss-Seidel sweeps before and after the coarse grid correction (default 2, 2).
+  void set_smoothing_steps(int pre_sweeps, int post_sweeps);
+  /// Halve the degree between the levels (default) or decrease it by one.
+  void set_order_halving(bool halve) { this->order_halving = halve; }
+  void set_coarse_solver(PMultigridCoarseSolver coarse_solver);
+
+  int get_num_levels() const { return levels.size(); }
+  /// Polynomial degree of the level (0 = finest).
+  int get_level_order(int l) const { return levels[l].order; }
+  /// The AMG preconditioner of the lowest-order problem (e.g. to change its parameters).
+  AMGPrecond *get_coarse_amg() { return &coarse_amg; }
+
+protected:
+  /// One level. The DOFs of the level are numbered in the order of the fine DOFs.
+  struct Level
+  {
+    int order;
+    CSRMatrix *A;       ///< Matrix of the level (of the finest level not owned).
+    int *src;           ///< Positions of the entries of A in the fine matrix.
+    int *to_coarse;     ///< Index of every DOF in the next coarser level, -1 if not there.
+    scalar *inv_diag;
+    scalar *x, *b, *r;  ///< Work vectors (x, b of the coarser levels only).
+  };
+  std::vector<Level> levels;
+
+  Hermes::vector<Space *> spaces;
+  int pre_sweeps, post_sweeps;
+  bool order_halving;
+  PMultigridCoarseSolver coarse_solver;
+
+  AMGPrecond coarse_amg;
+  UMFPackMatrix *umf_matrix;
+  UMFPackVector *umf_rhs;
+  UMFPackLinearSolver *umf_solver;
+  int *umf_src;         ///< Positions of the entries of umf_matrix in the coarsest level matrix.
+  bool umf_new_values;
+
+  int *fine_Ap, *fine_Aj;   ///< Structure of the fine matrix at the last compute().
+  unsigned int fine_size, fine_nnz;
+
+  void free_levels();
+  bool same_structure(CSRMatrix *a);
+
+  /// Polynomial degrees of all DOFs of the spaces.
+  void get_dof_orders(int *orders, int ndof);
+  void setup_levels(CSRMatrix *a);
+  void setup_umfpack();
+
+  void smooth(int l, scalar *b, scalar *x, int sweeps, bool forward);
+  void cycle(int l, scalar *b, scalar *x);
+};
+
+#endif
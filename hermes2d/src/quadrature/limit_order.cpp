@@ -35,11 +35,14 @@ static int default_order_table_quad[] =
 
 static int* g_order_table_quad = default_order_table_quad;
 static int* g_order_table_tri  = default_order_table_tri;
-static bool warned_order = false;
+// The limits depend on the element being processed, so every thread keeps its own copy.
+static HERMES_THREAD_LOCAL bool warned_order = false;
+static HERMES_THREAD_LOCAL LimitOrderState limit_order_state = { 0, 0, NULL };
 
-HERMES_API int  g_max_order;
-HERMES_API int  g_safe_max_order;
-HERMES_API int* g_order_table = NULL;
+HERMES_API LimitOrderState* get_limit_order_state()
+{
+  return &limit_order_state;
+}
 
 HERMES_API void set_order_limit_table(int* tri_table, int* quad_table, int n)
 {
@@ -51,10 +54,15 @@ HERMES_API void set_order_limit_table(int* tri_table, int* quad_table, int n)
 
 HERMES_API void update_limit_table(int mode)
 {
-  g_quad_2d_std.set_mode(mode);
-  g_max_order = g_quad_2d_std.get_max_order();
-  g_safe_max_order = g_quad_2d_std.get_safe_max_order();
-  g_order_table = (mode == HERMES_MODE_TRIANGLE) ? g_order_table_tri : g_order_table_quad;
+  update_limit_table(mode, &g_quad_2d_std);
+}
+
+HERMES_API void update_limit_table(int mode, Quad2D* quad)
+{
+  quad->set_mode(mode);
+  limit_order_state.max_order = quad->get_max_order();
+  limit_order_state.safe_max_order = quad->get_safe_max_order();
+  limit_order_state.order_table = (mode == HERMES_MODE_TRIANGLE) ? g_order_table_tri : g_order_table_quad;
 }
 
 HERMES_API void reset_warn_order() {
@@ -19,10 +19,21 @@
 // can be called to set a custom order limiting table
 extern HERMES_API void set_order_limit_table(int* tri_table, int* quad_table, int n);
 
-// limit_order is used in integrals
-extern HERMES_API int  g_safe_max_order;
-extern HERMES_API int  g_max_order;
-extern HERMES_API int* g_order_table;
+class Quad2D;
+
+// limit_order is used in integrals; the limits are kept separately for every thread
+struct LimitOrderState
+{
+  int  safe_max_order;
+  int  max_order;
+  int* order_table;
+};
+
+extern HERMES_API LimitOrderState* get_limit_order_state();
+
+#define g_safe_max_order (get_limit_order_state()->safe_max_order)
+#define g_max_order      (get_limit_order_state()->max_order)
+#define g_order_table    (get_limit_order_state()->order_table)
 
 #ifndef DEBUG_ORDER
   #define limit_order(o) \
@@ -41,7 +52,8 @@ extern HERMES_API int* g_order_table;
 
 extern HERMES_API void reset_warn_order(); ///< Resets warn order flag.
 extern HERMES_API void warn_order(); ///< Warns about integration order iff ward order flags it not set. Sets warn order flag.
-extern HERMES_API void update_limit_table(int mode);
+extern HERMES_API void update_limit_table(int mode); ///< Sets the limits for the given mode, uses and switches g_quad_2d_std.
+extern HERMES_API void update_limit_table(int mode, Quad2D* quad); ///< The same, using and switching the given quadrature.
 
 #endif
 
@@ -69,6 +69,8 @@ class HERMES_API Quad2D
 {
 public:
 
+  virtual ~Quad2D() {}
+
   void set_mode(int mode) { this->mode = mode; }
   int  get_mode() const { return mode; }
 
@@ -83,6 +85,16 @@ public:
 
   double2* get_ref_vertex(int n) { return &ref_vert[mode][n]; }
 
+  /// Identifies the point tables: the same for all quadratures sharing them (e.g. the instances
+  /// of Quad2DStd in different threads).
+  const void* get_tables_id() const { return tables; }
+
+  /// The 1D quadrature whose tensor product gives the volumetric tables of quads: the point
+  /// i * n + j of the table of an order is (x_i, x_j) with the weight w_i w_j, where x and w
+  /// are the n points and weights of the 1D table of the same order. NULL if the tables are
+  /// not tensor products.
+  virtual Quad1D* get_tensor_quad_1d() const { return NULL; }
+
 protected:
 
   int mode;
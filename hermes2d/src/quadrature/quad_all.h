@@ -36,12 +36,18 @@ class HERMES_API Quad2DStd : public Quad2D
   public:  Quad2DStd();
           ~Quad2DStd();
 
+  /// Returns g_quad_1d_std.
+  virtual Quad1D* get_tensor_quad_1d() const;
+
   virtual void dummy_fn() {}
 };
 
 
 extern HERMES_API Quad1DStd g_quad_1d_std;
-extern HERMES_API Quad2DStd g_quad_2d_std;
+
+/// Returns the standard 2D quadrature of the calling thread.
+extern HERMES_API Quad2DStd* get_quad_2d_std();
+#define g_quad_2d_std (*get_quad_2d_std())
 
 
 #endif
@@ -2483,6 +2483,7 @@ static int* std_np_2d[2] =
 
 
 static int quad_pt_ref = 0;
+static pthread_mutex_t quad_pt_mutex = PTHREAD_MUTEX_INITIALIZER; // protects quad_pt_ref and the tables
 
 
 Quad2DStd::Quad2DStd()
@@ -2513,6 +2514,7 @@ Quad2DStd::Quad2DStd()
 
   // create quad tables and edge tables
   int i, j, k, l;
+  pthread_mutex_lock(&quad_pt_mutex);
   if (!quad_pt_ref++)
   {
     for (i = 0; i <= max_order[0]; i++)
@@ -2537,6 +2539,8 @@ Quad2DStd::Quad2DStd()
     }
   }
 
+  pthread_mutex_unlock(&quad_pt_mutex);
+
   tables = std_tables_2d;
   np = std_np_2d;
 }
@@ -2545,6 +2549,7 @@ Quad2DStd::Quad2DStd()
 Quad2DStd::~Quad2DStd()
 {
   int i;
+  pthread_mutex_lock(&quad_pt_mutex);
   if (!--quad_pt_ref)
   {
     for (i = 0; i <= 3 * max_order[0] + 2; i++)
@@ -2553,6 +2558,13 @@ Quad2DStd::~Quad2DStd()
     for (i = 0; i <= 5 * max_order[1] + 4; i++)
       delete [] std_tables_2d_quad[i];
   }
+  pthread_mutex_unlock(&quad_pt_mutex);
+}
+
+
+Quad1D* Quad2DStd::get_tensor_quad_1d() const
+{
+  return &g_quad_1d_std;
 }
 
 
@@ -2561,4 +2573,14 @@ Quad2DStd::~Quad2DStd()
 // ... for use in any module
 
 HERMES_API Quad1DStd g_quad_1d_std;
-HERMES_API Quad2DStd g_quad_2d_std;
+
+// Quad2D keeps the current element mode, every thread needs its own instance.
+static ThreadLocalInstance<Quad2DStd> quad_2d_std_instances = H2D_THREAD_LOCAL_INSTANCE_INIT;
+
+HERMES_API Quad2DStd* get_quad_2d_std()
+{
+  static HERMES_THREAD_LOCAL Quad2DStd* quad = NULL;
+  if (quad == NULL)
+    quad = quad_2d_std_instances.get();
+  return quad;
+}
@@ -6,12 +6,15 @@
 #include "h1_proj_based_selector.h"
 
 namespace RefinementSelectors {
-  H1Shapeset H1ProjBasedSelector::default_shapeset;
-
   const int H1ProjBasedSelector::H2DRS_MAX_H1_ORDER = H2DRS_MAX_ORDER;
 
   H1ProjBasedSelector::H1ProjBasedSelector(CandList cand_list, double conv_exp, int max_order, H1Shapeset* user_shapeset)
-    : ProjBasedSelector(cand_list, conv_exp, max_order, user_shapeset == NULL ? &default_shapeset : user_shapeset, Range<int>(1,1), Range<int>(2, H2DRS_MAX_H1_ORDER)) {}
+    : ProjBasedSelector(cand_list, conv_exp, max_order, user_shapeset == NULL ? new H1Shapeset() : user_shapeset, Range<int>(1,1), Range<int>(2, H2DRS_MAX_H1_ORDER))
+    , default_shapeset(user_shapeset == NULL ? static_cast<H1Shapeset*>(shapeset) : NULL) {}
+
+  H1ProjBasedSelector::~H1ProjBasedSelector() {
+    delete default_shapeset;
+  }
 
   void H1ProjBasedSelector::set_current_order_range(Element* element) {
     current_max_order = this->max_order;
@@ -8,16 +8,16 @@
 #ifdef H2D_COMPLEX
 
 namespace RefinementSelectors {
-  HcurlShapeset HcurlProjBasedSelector::default_shapeset;
-
   const int HcurlProjBasedSelector::H2DRS_MAX_HCURL_ORDER = 6;
 
   HcurlProjBasedSelector::HcurlProjBasedSelector(CandList cand_list, double conv_exp, int max_order, HcurlShapeset* user_shapeset)
-    : ProjBasedSelector(cand_list, conv_exp, max_order, user_shapeset == NULL ? &default_shapeset : user_shapeset, Range<int>(), Range<int>(0, H2DRS_MAX_HCURL_ORDER))
-    , precalc_rvals_curl(NULL) {}
+    : ProjBasedSelector(cand_list, conv_exp, max_order, user_shapeset == NULL ? new HcurlShapeset() : user_shapeset, Range<int>(), Range<int>(0, H2DRS_MAX_HCURL_ORDER))
+    , precalc_rvals_curl(NULL)
+    , default_shapeset(user_shapeset == NULL ? static_cast<HcurlShapeset*>(shapeset) : NULL) {}
 
   HcurlProjBasedSelector::~HcurlProjBasedSelector() {
     delete[] precalc_rvals_curl;
+    delete default_shapeset;
   }
 
   void HcurlProjBasedSelector::set_current_order_range(Element* element) {
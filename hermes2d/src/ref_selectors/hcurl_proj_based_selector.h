@@ -83,7 +83,7 @@ namespace RefinementSelectors {
     virtual double evaluate_error_squared_subdomain(Element* sub_elem, const ElemGIP& sub_gip, const ElemSubTrf& sub_trf, const ElemProj& elem_proj);
 
   protected: //defaults
-    static HcurlShapeset default_shapeset; ///< A default shapeset.
+    HcurlShapeset* default_shapeset; ///< A default shapeset owned by the selector, NULL if the user supplied one.
   };
 }
 
@@ -6,12 +6,15 @@
 #include "l2_proj_based_selector.h"
 
 namespace RefinementSelectors {
-  L2Shapeset L2ProjBasedSelector::default_shapeset;
-
   const int L2ProjBasedSelector::H2DRS_MAX_L2_ORDER = H2DRS_MAX_ORDER;
 
   L2ProjBasedSelector::L2ProjBasedSelector(CandList cand_list, double conv_exp, int max_order, L2Shapeset* user_shapeset)
-    : ProjBasedSelector(cand_list, conv_exp, max_order, user_shapeset == NULL ? &default_shapeset : user_shapeset, Range<int>(1,1), Range<int>(0, H2DRS_MAX_L2_ORDER)) {}
+    : ProjBasedSelector(cand_list, conv_exp, max_order, user_shapeset == NULL ? new L2Shapeset() : user_shapeset, Range<int>(1,1), Range<int>(0, H2DRS_MAX_L2_ORDER))
+    , default_shapeset(user_shapeset == NULL ? static_cast<L2Shapeset*>(shapeset) : NULL) {}
+
+  L2ProjBasedSelector::~L2ProjBasedSelector() {
+    delete default_shapeset;
+  }
 
   void L2ProjBasedSelector::set_current_order_range(Element* element) {
     current_max_order = this->max_order;
@@ -33,6 +33,10 @@ namespace RefinementSelectors {
      *  \param[in] max_order A maximum order which considered. If ::H2DRS_DEFAULT_ORDER, a maximum order supported by the selector is used, see HcurlProjBasedSelector::H2DRS_MAX_L2_ORDER.
      *  \param[in] user_shapeset A shapeset. If NULL, it will use internal instance of the class L2Shapeset. */
     L2ProjBasedSelector(CandList cand_list = H2D_HP_ANISO, double conv_exp = 1.0, int max_order = H2DRS_DEFAULT_ORDER, L2Shapeset* user_shapeset = NULL);
+
+    /// Destructor.
+    virtual ~L2ProjBasedSelector();
+
   protected: //overloads
     /// A function expansion of a function f used by this selector.
     enum LocalFuncExpansion {
@@ -76,7 +80,7 @@ namespace RefinementSelectors {
     virtual double evaluate_error_squared_subdomain(Element* sub_elem, const ElemGIP& sub_gip, const ElemSubTrf& sub_trf, const ElemProj& elem_proj);
 
   protected: //defaults
-    static L2Shapeset default_shapeset; ///< A default shapeset.
+    L2Shapeset* default_shapeset; ///< A default shapeset owned by the selector, NULL if the user supplied one.
   };
 }
 
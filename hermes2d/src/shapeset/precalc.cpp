@@ -16,6 +16,8 @@
 #include "../h2d_common.h"
 #include "../quadrature/quad.h"
 #include "precalc.h"
+#include "../function/sum_factorization.h"
+#include "shapeset_engine.h"
 
 
 
@@ -25,6 +27,9 @@ PrecalcShapeset::PrecalcShapeset(Shapeset* shapeset)
   assert_msg(shapeset != NULL, "Shapeset cannot be NULL.");
   this->shapeset = shapeset;
   master_pss = NULL;
+  arena = NULL;
+  sum_fact = NULL;
+  engine = NULL;
   num_components = shapeset->get_num_components();
   assert(num_components == 1 || num_components == 2);
   update_max_index();
@@ -38,6 +43,9 @@ PrecalcShapeset::PrecalcShapeset(PrecalcShapeset* pss)
   while (pss->is_slave())
     pss = pss->master_pss;
   master_pss = pss;
+  arena = NULL;
+  sum_fact = NULL;
+  engine = NULL;
   shapeset = pss->shapeset;
   num_components = pss->num_components;
   update_max_index();
@@ -86,14 +94,56 @@ void PrecalcShapeset::set_active_shape(int index)
     sub_tables = master_pss->tables.get(key);
   }
 
+  this->index = index;
+
   // Update the Node table.
-  update_nodes_ptr();
+  update_nodes();
 
-  this->index = index;
   order = std::max(H2D_GET_H_ORDER(shapeset->get_order(index)), H2D_GET_V_ORDER(shapeset->get_order(index)));
 }
 
 
+void PrecalcShapeset::update_nodes()
+{
+  PrecalcArena* a = get_arena();
+  fixed_nodes = (a != NULL && sub_idx == 0) ? a->get_nodes(get_quad_2d(), mode, index) : NULL;
+  if (fixed_nodes != NULL) {
+    num_fixed_nodes = a->num_tables[mode];
+    nodes = NULL;
+  }
+  else
+    update_nodes_ptr();
+}
+
+
+void PrecalcShapeset::set_arena(PrecalcArena* arena)
+{
+  if (is_slave())
+    error("The arena can be set only for a master PrecalcShapeset.");
+  if (arena != NULL && arena->get_shapeset_id() != shapeset->get_id())
+    error("The arena was created for another shapeset.");
+  this->arena = arena;
+}
+
+
+void PrecalcShapeset::set_sum_factorization(SumFactorization* sum_fact)
+{
+  if (is_slave())
+    error("Sum factorization can be set only for a master PrecalcShapeset.");
+  this->sum_fact = sum_fact;
+}
+
+
+void PrecalcShapeset::set_shapeset_engine(ShapesetEngine* engine)
+{
+  if (is_slave())
+    error("The shapeset engine can be set only for a master PrecalcShapeset.");
+  if (engine != NULL && engine->get_shapeset_id() != shapeset->get_id())
+    error("The shapeset engine was created for another shapeset.");
+  this->engine = engine;
+}
+
+
 void PrecalcShapeset::set_active_element(Element* e)
 {
   mode = e->get_mode();
@@ -116,9 +166,10 @@ void PrecalcShapeset::precalculate(int order, int mask)
 {
   int i, j, k;
 
-  // initialization
+  // initialization (the shapeset may be shared with a pss on an element of another mode)
   Quad2D* quad = get_quad_2d();
   quad->set_mode(mode);
+  shapeset->set_mode(mode);
   H2D_CHECK_ORDER(quad, order);
   int np = quad->get_num_points(order);
   double3* pt = quad->get_points(order);
@@ -127,6 +178,27 @@ void PrecalcShapeset::precalculate(int order, int mask)
   int newmask = mask | oldmask;
   Node* node = new_node(newmask, np);
 
+  // On quads, the tables of a tensor-product quadrature are evaluated from the 1D factors
+  // of the shape functions in the n points (transformed to the sub-element) of the 1D rule.
+  SumFactorization* sf = get_sum_factorization();
+  Quad1D* quad_1d = (sf != NULL && mode == HERMES_MODE_QUAD) ? quad->get_tensor_quad_1d() : NULL;
+  std::vector<double> x, y;
+  if (quad_1d != NULL && order <= quad->get_max_order() && order <= quad_1d->get_max_order()
+      && np == sqr(quad_1d->get_num_points(order))) {
+    double2* pt_1d = quad_1d->get_points(order);
+    for (i = 0; i < quad_1d->get_num_points(order); i++) {
+      x.push_back(ctm->m[0] * pt_1d[i][0] + ctm->t[0]);
+      y.push_back(ctm->m[1] * pt_1d[i][0] + ctm->t[1]);
+    }
+  }
+
+  // Otherwise the engine (of a scalar shapeset) evaluates all functions in the points at once.
+  ShapesetEngine* engine = get_shapeset_engine();
+  if (engine != NULL && (index < 0 || index > engine->get_max_index(mode)))
+    engine = NULL;
+  double* engine_values[6] = { NULL, NULL, NULL, NULL, NULL, NULL };
+  bool use_engine = false;
+
   // precalculate all required tables
   for (j = 0; j < num_components; j++)
   {
@@ -135,6 +207,12 @@ void PrecalcShapeset::precalculate(int order, int mask)
       if (newmask & idx2mask[k][j]) {
         if (oldmask & idx2mask[k][j])
           memcpy(node->values[j][k], cur_node->values[j][k], np * sizeof(double));
+        else if (!x.empty() && sf->eval(shapeset, index, k, &x[0], x.size(), &y[0], y.size(), node->values[j][k]))
+          continue;
+        else if (engine != NULL) {
+          engine_values[k] = node->values[j][k];
+          use_engine = true;
+        }
         else
           for (i = 0; i < np; i++)
             node->values[j][k][i] = shapeset->get_value(k, index, ctm->m[0] * pt[i][0] + ctm->t[0],
@@ -142,6 +220,14 @@ void PrecalcShapeset::precalculate(int order, int mask)
       }
     }
   }
+  if (use_engine) {
+    std::vector<double> ex(np), ey(np);
+    for (i = 0; i < np; i++) {
+      ex[i] = ctm->m[0] * pt[i][0] + ctm->t[0];
+      ey[i] = ctm->m[1] * pt[i][1] + ctm->t[1];
+    }
+    engine->eval_index(mode, index, np, &ex[0], &ey[0], engine_values);
+  }
   if(nodes->present(order)) {
     assert(nodes->get(order) == cur_node);
     ::free(nodes->get(order));
@@ -174,8 +260,6 @@ void PrecalcShapeset::free()
   }
 }
 
-extern PrecalcShapeset ref_map_pss;
-
 PrecalcShapeset::~PrecalcShapeset()
 {
   free();
@@ -185,12 +269,101 @@ void PrecalcShapeset::push_transform(int son)
 {
   Transformable::push_transform(son);
   if(sub_tables != NULL)
-    update_nodes_ptr();
+    update_nodes();
 }
 
 void PrecalcShapeset::pop_transform()
 {
   Transformable::pop_transform();
   if(sub_tables != NULL)
-    update_nodes_ptr();
-}
\ No newline at end of file
+    update_nodes();
+}
+
+PrecalcArena::PrecalcArena(Shapeset* shapeset, int max_order, int mask, Quad2D* quad)
+{
+  _F_
+  int nc = shapeset->get_num_components();
+  if (nc < 2) mask = (mask & H2D_FN_COMPONENT_0) | ((mask & H2D_FN_COMPONENT_0) << 6);
+  shapeset_id = shapeset->get_id();
+  this->max_order = max_order;
+  quad_tables = quad->get_tables_id();
+  int shapeset_mode = shapeset->get_mode(), quad_mode = quad->get_mode();
+
+  // Count the nodes and the values, the tables of a node are padded to 8 doubles (64 bytes).
+  int num_nodes = 0;
+  size = 0;
+  for (int mode = 0; mode < H2D_NUM_MODES; mode++) {
+    shapeset->set_mode(mode);
+    quad->set_mode(mode);
+    max_index[mode] = shapeset->get_max_index();
+    num_tables[mode] = quad->get_num_tables();
+    for (int index = 0; index <= max_index[mode]; index++) {
+      int o = shapeset->get_order(index);
+      if (std::max(H2D_GET_H_ORDER(o), H2D_GET_V_ORDER(o)) > max_order) continue;
+      num_nodes += num_tables[mode];
+      for (int t = 0; t < num_tables[mode]; t++)
+        for (int j = 0; j < nc; j++)
+          for (int k = 0; k < 6; k++)
+            if (mask & RealFunction::idx2mask[k][j])
+              size += (quad->get_num_points(t) + 7) & ~7;
+    }
+  }
+
+  block = malloc(size * sizeof(double) + 64);
+  MEM_CHECK(block);
+  values = (double*) (((size_t) block + 63) & ~(size_t) 63);
+  headers = (Node*) malloc(std::max(num_nodes, 1) * sizeof(Node));
+  MEM_CHECK(headers);
+
+  int num_shapes = max_index[0] + max_index[1] + 2;
+  node_ptrs = new Node*[std::max(num_nodes, 1)];
+  MEM_CHECK(node_ptrs);
+  shape_nodes[0] = new Node**[num_shapes];
+  MEM_CHECK(shape_nodes[0]);
+  shape_nodes[1] = shape_nodes[0] + max_index[0] + 1;
+
+  // Precalculate the values.
+  Node* node = headers;
+  Node** ptr = node_ptrs;
+  double* data = values;
+  for (int mode = 0; mode < H2D_NUM_MODES; mode++) {
+    shapeset->set_mode(mode);
+    quad->set_mode(mode);
+    for (int index = 0; index <= max_index[mode]; index++) {
+      int o = shapeset->get_order(index);
+      if (std::max(H2D_GET_H_ORDER(o), H2D_GET_V_ORDER(o)) > max_order) {
+        shape_nodes[mode][index] = NULL;
+        continue;
+      }
+      shape_nodes[mode][index] = ptr;
+      for (int t = 0; t < num_tables[mode]; t++, node++) {
+        int np = quad->get_num_points(t);
+        double3* pt = quad->get_points(t);
+        node->mask = mask;
+        node->size = 0;
+        memset(node->values, 0, sizeof(node->values));
+        for (int j = 0; j < nc; j++)
+          for (int k = 0; k < 6; k++)
+            if (mask & RealFunction::idx2mask[k][j]) {
+              node->values[j][k] = data;
+              for (int i = 0; i < np; i++)
+                data[i] = shapeset->get_value(k, index, pt[i][0], pt[i][1], j);
+              memset(data + np, 0, (((np + 7) & ~7) - np) * sizeof(double));
+              data += (np + 7) & ~7;
+            }
+        *ptr++ = node;
+      }
+    }
+  }
+  shapeset->set_mode(shapeset_mode);
+  quad->set_mode(quad_mode);
+}
+
+
+PrecalcArena::~PrecalcArena()
+{
+  delete [] shape_nodes[0];
+  delete [] node_ptrs;
+  ::free(headers);
+  ::free(block);
+}
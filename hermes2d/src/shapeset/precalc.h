@@ -19,6 +19,70 @@
 #include "../function/function.h"
 #include "../shapeset/shapeset.h"
 
+class SumFactorization;
+class ShapesetEngine;
+
+
+/// \brief Shape function values precalculated in advance.
+///
+/// PrecalcArena evaluates all shape functions of a shapeset up to the given polynomial order
+/// in the points of all tables of a quadrature (volume and edge) on the reference element,
+/// in both modes. The values are stored in one contiguous 64-byte aligned block, one table per
+/// value type and component with the points innermost, each table padded to a multiple of
+/// 64 bytes. The nodes are found by index arithmetic from the mode, the shape index and
+/// the order.
+///
+/// A PrecalcShapeset with an arena (see PrecalcShapeset::set_arena()) takes the values on
+/// the whole element from it and precalculates only the values on sub-elements (and the
+/// value types or shape functions not in the arena) as usual. The arena is not modified after
+/// the construction, so it can be shared by any number of PrecalcShapesets in any threads,
+/// including those with a clone of the shapeset or with another instance of the quadrature
+/// having the same point tables.
+///
+class HERMES_API PrecalcArena
+{
+public:
+  /// \param shapeset [in] The shapeset, used during the construction only.
+  /// \param max_order [in] Maximum polynomial order of the shape functions.
+  /// \param mask [in] The value types (see Function::set_quad_order()).
+  /// \param quad [in] The quadrature.
+  PrecalcArena(Shapeset* shapeset, int max_order, int mask = H2D_FN_DEFAULT, Quad2D* quad = &g_quad_2d_std);
+  ~PrecalcArena();
+
+  int get_shapeset_id() const { return shapeset_id; }
+  int get_max_order() const { return max_order; }
+
+  /// Returns the size of the values in bytes.
+  size_t get_memory() const { return size * sizeof(double); }
+
+protected:
+  typedef RealFunction::Node Node;
+
+  int shapeset_id;
+  int max_order;
+  const void* quad_tables;  ///< see Quad2D::get_tables_id()
+
+  int num_tables[2];        ///< number of tables of the quadrature
+  int max_index[2];
+  Node*** shape_nodes[2];   ///< shape_nodes[mode][index]: num_tables[mode] nodes, NULL if not included
+  Node* headers;
+  Node** node_ptrs;
+
+  double* values;           ///< aligned values
+  void* block;              ///< allocated block
+  size_t size;              ///< number of values including padding
+
+  /// Returns the nodes of the shape function indexed by the order, or NULL if it is not
+  /// in the arena or the quadrature is different.
+  Node** get_nodes(Quad2D* quad, int mode, int index) const
+  {
+    if (quad->get_tables_id() != quad_tables || index < 0 || index > max_index[mode]) return NULL;
+    return shape_nodes[mode][index];
+  }
+
+  friend class PrecalcShapeset;
+};
+
 
 /// \brief Caches precalculated shape function values.
 ///
@@ -94,6 +158,28 @@ public:
 
   virtual void pop_transform();
 
+  /// Takes the values on the whole element from the arena (NULL = none), see PrecalcArena.
+  /// Only for a master pss, its slaves use the arena of the master. The arena must be created
+  /// for the same shapeset and it must not be deleted before the pss.
+  void set_arena(PrecalcArena* arena);
+
+  PrecalcArena* get_arena() const { return master_pss != NULL ? master_pss->arena : arena; }
+
+  /// Precalculates the shape functions on quads from their 1D factors in the points of the 1D
+  /// rule (see SumFactorization::eval()), if the volumetric quadrature is a tensor product.
+  /// Only for a master pss, its slaves use the one of the master. NULL = off.
+  void set_sum_factorization(SumFactorization* sum_fact);
+
+  SumFactorization* get_sum_factorization() const { return master_pss != NULL ? master_pss->sum_fact : sum_fact; }
+
+  /// Precalculates the shape functions by the engine (see ShapesetEngine::eval_index()), which
+  /// evaluates all functions of the shapeset in the points at once and keeps them for the other
+  /// functions. Only for a master pss, its slaves use the engine of the master. The engine must
+  /// be created for the same shapeset and not be used by other threads. NULL = off (default).
+  void set_shapeset_engine(ShapesetEngine* engine);
+
+  ShapesetEngine* get_shapeset_engine() const { return master_pss != NULL ? master_pss->engine : engine; }
+
 protected:
 
   Shapeset* shapeset;
@@ -115,12 +201,20 @@ protected:
 
   PrecalcShapeset* master_pss;
 
+  PrecalcArena* arena;
+  SumFactorization* sum_fact;
+  ShapesetEngine* engine;
+
   bool is_slave() const { return master_pss != NULL; }
 
   virtual void precalculate(int order, int mask);
 
   void update_max_index();
 
+  /// Sets the nodes of the active shape function for the current transform: the nodes
+  /// of the arena on the whole element, otherwise the node table of the sub-element.
+  void update_nodes();
+
   /// Forces a transform without using push_transform() etc.
   /// Used by the Solution class. <b>For internal use only</b>.
   void force_transform(uint64_t sub_idx, Trf* ctm)
@@ -73,7 +73,7 @@ class HERMES_API Shapeset
 {
 public:
 
-  ~Shapeset() { free_constrained_edge_combinations(); }
+  virtual ~Shapeset() { free_constrained_edge_combinations(); }
 
   /// Selects HERMES_MODE_TRIANGLE or HERMES_MODE_QUAD.
   void set_mode(int mode)
@@ -197,6 +197,11 @@ public:
   /// Returns space type.
   virtual ESpaceType get_space_type() const = 0;
 
+  /// Returns a new instance of the same shapeset. The shapeset keeps mutable state (mode,
+  /// constrained edge combinations), so every assembling thread needs its own instance.
+  /// Returns NULL if the shapeset can not be cloned, which disables threaded assembling.
+  virtual Shapeset* clone() { return NULL; }
+
 protected:
 
   int mode;
@@ -0,0 +1,640 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "../h2d_common.h"
+#include "shapeset_engine.h"
+
+// Ids of the supported shapesets (see Shapeset::get_id()).
+static const int H2D_SE_H1_JACOBI = 1;
+static const int H2D_SE_L2_LEGENDRE = 30;
+
+const int ShapesetEngine::BLOCK;
+
+
+ShapesetEngine::ShapesetEngine(Shapeset* shapeset)
+{
+  _F_
+  if (!is_supported(shapeset))
+    error("ShapesetEngine: the shapeset %d is not supported.", shapeset->get_id());
+
+  shapeset_id = shapeset->get_id();
+  num_factors[0] = num_factors[1] = 0;
+  cached_mode = -1;
+  for (int k = 0; k < 6; k++)
+    cached_valid[k] = false;
+  if (shapeset_id == H2D_SE_H1_JACOBI)
+    init_h1_jacobi(shapeset->get_max_order());
+  else
+    init_l2_legendre(shapeset->get_max_order());
+}
+
+
+bool ShapesetEngine::is_supported(Shapeset* shapeset)
+{
+  int id = shapeset->get_id();
+  return id == H2D_SE_H1_JACOBI || id == H2D_SE_L2_LEGENDRE;
+}
+
+
+ShapesetEngine::Affine ShapesetEngine::affine(double a, double b, double c)
+{
+  Affine f = { a, b, c };
+  return f;
+}
+
+
+int ShapesetEngine::add_family(int mode, int type, int max_n, Affine a0, Affine a1, Affine a2, double alpha)
+{
+  Family fam;
+  fam.type = type;
+  fam.arg[0] = a0;
+  fam.arg[1] = a1;
+  fam.arg[2] = a2;
+  fam.alpha = alpha;
+  fam.max_n = (type == H2D_SE_LINEAR) ? 0 : max_n;
+  fam.first = num_factors[mode];
+  num_factors[mode] += fam.max_n + 1;
+  families[mode].push_back(fam);
+  return fam.first;
+}
+
+
+void ShapesetEngine::add_product(int mode, int f0, int f1, double coef)
+{
+  Product p;
+  p.f[0] = f0;
+  p.f[1] = f1;
+  p.coef = coef;
+  products[mode].push_back(p);
+}
+
+
+//// shapesets /////////////////////////////////////////////////////////////////////////////////
+
+// H1ShapesetJacobi. On triangles, the vertex functions are the barycentric coordinates
+// lambda_0, lambda_1, lambda_2 of the vertices (-1,-1), (1,-1), (-1,1), the functions of the
+// edge 0 are the scaled Lobatto polynomials s^k l_k(t / s) with t = lambda_1 - lambda_0 and
+// s = lambda_0 + lambda_1, the functions of the edges 1 and 2 are the products of the
+// barycentric coordinates of the edge with the kernel functions phi_{k-2}(y), phi_{k-2}(-y).
+// The bubbles of the order n1 + n2 are the products of the scaled Lobatto polynomials of the
+// order n1 with the integrated Jacobi polynomials of the order n2 and alpha = 2 * n1 - 1 in y,
+// normalized in the H1 seminorm. The functions of odd orders on edges have two indices, the
+// second one for the opposite orientation of the edge (with the opposite sign). The quads are
+// the products of Lobatto polynomials l_i(x) l_j(y), ordered by i and j.
+void ShapesetEngine::init_h1_jacobi(int max_order)
+{
+  Affine zero = affine(0, 0, 0);
+  Affine lambda[3] = { affine(-0.5, -0.5, 0), affine(0.5, 0, 0.5), affine(0, 0.5, 0.5) };
+
+  int mode = HERMES_MODE_TRIANGLE;
+  int one = add_family(mode, H2D_SE_LINEAR, 0, affine(0, 0, 1), zero, zero);
+  int vert[3];
+  for (int i = 0; i < 3; i++)
+    vert[i] = add_family(mode, H2D_SE_LINEAR, 0, lambda[i], zero, zero);
+  int lob = add_family(mode, H2D_SE_SCALED_LOBATTO, max_order, affine(1, 0.5, 0.5), affine(0, -0.5, 0.5), zero);
+  int edge[3];
+  edge[0] = lob;
+  edge[1] = add_family(mode, H2D_SE_EDGE_KERNEL, max_order, affine(0, 1, 0), lambda[1], lambda[2]);
+  edge[2] = add_family(mode, H2D_SE_EDGE_KERNEL, max_order, affine(0, -1, 0), lambda[2], lambda[0]);
+  std::vector<int> jac(max_order, -1);
+  for (int n1 = 2; n1 < max_order; n1++)
+    jac[n1] = add_family(mode, H2D_SE_INT_JACOBI, max_order - n1, affine(0, 1, 0), zero, zero, 2 * n1 - 1);
+
+  for (int i = 0; i < 3; i++)
+    add_product(mode, vert[i], one, 1.0);
+  std::vector<int> bubbles;
+  for (int k = 2; k <= max_order; k++)
+  {
+    for (int e = 0; e < 3; e++)
+    {
+      add_product(mode, edge[e] + k, one, 1.0);
+      if (k % 2) add_product(mode, edge[e] + k, one, -1.0);
+    }
+    for (int n1 = 2; n1 < k; n1++)
+    {
+      bubbles.push_back(products[mode].size());
+      add_product(mode, lob + n1, jac[n1] + k - n1, 1.0);
+    }
+  }
+  normalize(mode, bubbles);
+
+  // Quads. The signs of the edge functions of odd orders and the orientation 0 are positive on
+  // the edges 0 (y = -1) and 1 (x = 1), negative on the edges 2 and 3.
+  mode = HERMES_MODE_QUAD;
+  int lx = add_family(mode, H2D_SE_LOBATTO, max_order, affine(1, 0, 0), zero, zero);
+  int ly = add_family(mode, H2D_SE_LOBATTO, max_order, affine(0, 1, 0), zero, zero);
+  for (int i = 0; i <= max_order; i++)
+  {
+    for (int j = 0; j <= max_order; j++)
+    {
+      if ((i <= 1 && j >= 2 && j % 2) || (j <= 1 && i >= 2 && i % 2))
+      {
+        double sign = (i == 0 || j == 1) ? -1.0 : 1.0;
+        add_product(mode, lx + i, ly + j, sign);
+        add_product(mode, lx + i, ly + j, -sign);
+      }
+      else
+        add_product(mode, lx + i, ly + j, 1.0);
+    }
+  }
+}
+
+
+// L2ShapesetLegendre. The quads are the products P_i(x) P_j(y) with the index i * (n + 1) + j,
+// the triangles the products P_i(u) P_j(v) of u = lambda_1 - lambda_0, v = lambda_0 - lambda_2,
+// ordered by d = min(i, j) and then by the order, (d, k) before (k, d).
+void ShapesetEngine::init_l2_legendre(int max_order)
+{
+  Affine zero = affine(0, 0, 0);
+
+  int mode = HERMES_MODE_TRIANGLE;
+  int pu = add_family(mode, H2D_SE_LEGENDRE, max_order, affine(1, 0.5, 0.5), zero, zero);
+  int pv = add_family(mode, H2D_SE_LEGENDRE, max_order, affine(-0.5, -1, -0.5), zero, zero);
+  for (int d = 0; 2 * d <= max_order; d++)
+  {
+    add_product(mode, pu + d, pv + d, 1.0);
+    for (int k = d + 1; d + k <= max_order; k++)
+    {
+      add_product(mode, pu + d, pv + k, 1.0);
+      add_product(mode, pu + k, pv + d, 1.0);
+    }
+  }
+
+  mode = HERMES_MODE_QUAD;
+  int px = add_family(mode, H2D_SE_LEGENDRE, max_order, affine(1, 0, 0), zero, zero);
+  int py = add_family(mode, H2D_SE_LEGENDRE, max_order, affine(0, 1, 0), zero, zero);
+  for (int i = 0; i <= max_order; i++)
+    for (int j = 0; j <= max_order; j++)
+      add_product(mode, px + i, py + j, 1.0);
+}
+
+
+// Gauss-Legendre rule with n points on (-1, 1).
+static void gauss_legendre(int n, double* pt, double* wt)
+{
+  for (int i = 0; i < n; i++)
+  {
+    double x = cos(M_PI * (i + 0.75) / (n + 0.5)), dp = 0;
+    for (int it = 0; it < 100; it++)
+    {
+      double p0 = 1, p1 = x;
+      for (int k = 1; k < n; k++)
+      {
+        double p2 = ((2 * k + 1) * x * p1 - k * p0) / (k + 1);
+        p0 = p1; p1 = p2;
+      }
+      dp = n * (x * p1 - p0) / (x * x - 1);
+      double dx = p1 / dp;
+      x -= dx;
+      if (fabs(dx) < 1e-16) break;
+    }
+    pt[i] = x;
+    wt[i] = 2.0 / ((1 - x * x) * dp * dp);
+  }
+}
+
+
+void ShapesetEngine::normalize(int mode, const std::vector<int>& indices)
+{
+  if (indices.empty()) return;
+
+  // Tensor product rule on the square, collapsed to the triangle for its mode, exact for the
+  // squares of the derivatives.
+  int n1 = 0;
+  for (unsigned int i = 0; i < families[mode].size(); i++)
+    n1 = std::max(n1, families[mode][i].max_n);
+  n1 += 2;
+  std::vector<double> pt(n1), wt(n1);
+  gauss_legendre(n1, &pt[0], &wt[0]);
+
+  int np = n1 * n1;
+  std::vector<double> x(np), y(np), w(np);
+  for (int i = 0; i < n1; i++)
+    for (int j = 0; j < n1; j++)
+    {
+      int k = i * n1 + j;
+      y[k] = pt[i];
+      x[k] = pt[j];
+      w[k] = wt[i] * wt[j];
+      if (mode == HERMES_MODE_TRIANGLE)
+      {
+        x[k] = (1 + pt[j]) * (1 - pt[i]) / 2 - 1;
+        w[k] *= (1 - pt[i]) / 2;
+      }
+    }
+
+  int nf = products[mode].size();
+  std::vector<double> dx(nf * np), dy(nf * np);
+  double* result[6] = { NULL, &dx[0], &dy[0], NULL, NULL, NULL };
+  eval(mode, np, &x[0], &y[0], result);
+
+  for (unsigned int i = 0; i < indices.size(); i++)
+  {
+    int index = indices[i];
+    double sum = 0;
+    for (int k = 0; k < np; k++)
+      sum += w[k] * (sqr(dx[index * np + k]) + sqr(dy[index * np + k]));
+    products[mode][index].coef /= sqrt(sum);
+  }
+}
+
+
+//// evaluation ////////////////////////////////////////////////////////////////////////////////
+
+void ShapesetEngine::jacobi(double alpha, double beta, int max_n, int nb, const double* t, int nd, double* out)
+{
+  double* p0[3];
+  for (int d = 0; d < 3; d++) p0[d] = out + d * BLOCK;
+  for (int i = 0; i < nb; i++) p0[0][i] = 1.0;
+  if (nd >= 1) for (int i = 0; i < nb; i++) p0[1][i] = 0.0;
+  if (nd >= 2) for (int i = 0; i < nb; i++) p0[2][i] = 0.0;
+  if (max_n < 1) return;
+
+  double* p1[3];
+  for (int d = 0; d < 3; d++) p1[d] = out + (3 + d) * BLOCK;
+  double a = (alpha + beta + 2) / 2, b = (alpha - beta) / 2;
+  for (int i = 0; i < nb; i++) p1[0][i] = a * t[i] + b;
+  if (nd >= 1) for (int i = 0; i < nb; i++) p1[1][i] = a;
+  if (nd >= 2) for (int i = 0; i < nb; i++) p1[2][i] = 0.0;
+
+  // P_{n+1} = (A t + B) P_n - C P_{n-1}.
+  for (int n = 1; n < max_n; n++)
+  {
+    double ab = 2 * n + alpha + beta;
+    double a1 = 2 * (n + 1) * (n + alpha + beta + 1) * ab;
+    double A = ab * (ab + 1) * (ab + 2) / a1;
+    double B = (ab + 1) * (alpha * alpha - beta * beta) / a1;
+    double C = 2 * (n + alpha) * (n + beta) * (ab + 2) / a1;
+
+    const double* pm = out + (n - 1) * 3 * BLOCK;
+    const double* pn = out + n * 3 * BLOCK;
+    double* pp = out + (n + 1) * 3 * BLOCK;
+    if (nd >= 2)
+      for (int i = 0; i < nb; i++)
+        pp[2 * BLOCK + i] = 2 * A * pn[BLOCK + i] + (A * t[i] + B) * pn[2 * BLOCK + i] - C * pm[2 * BLOCK + i];
+    if (nd >= 1)
+      for (int i = 0; i < nb; i++)
+        pp[BLOCK + i] = A * pn[i] + (A * t[i] + B) * pn[BLOCK + i] - C * pm[BLOCK + i];
+    for (int i = 0; i < nb; i++)
+      pp[i] = (A * t[i] + B) * pn[i] - C * pm[i];
+  }
+}
+
+
+void ShapesetEngine::scaled_legendre(int max_n, int nb, const double* t, const double* s, int nd, double* out)
+{
+  int nv = (nd == 0) ? 1 : (nd == 1) ? 3 : 6;
+  for (int d = 0; d < nv; d++)
+    for (int i = 0; i < nb; i++)
+    {
+      out[d * BLOCK + i] = (d == 0) ? 1.0 : 0.0;
+      out[(6 + d) * BLOCK + i] = (d == 0) ? t[i] : (d == 1) ? 1.0 : 0.0;
+    }
+
+  // (n + 1) P_{n+1} = (2n + 1) t P_n - n s^2 P_{n-1}.
+  for (int n = 1; n < max_n; n++)
+  {
+    double A = (2.0 * n + 1) / (n + 1), C = (double) n / (n + 1);
+    const double* pm = out + (n - 1) * 6 * BLOCK;
+    const double* pn = out + n * 6 * BLOCK;
+    double* pp = out + (n + 1) * 6 * BLOCK;
+    for (int i = 0; i < nb; i++)
+      pp[i] = A * t[i] * pn[i] - C * s[i] * s[i] * pm[i];
+    if (nd == 0) continue;
+
+    const double *pn_t = pn + BLOCK, *pn_s = pn + 2 * BLOCK, *pn_tt = pn + 3 * BLOCK,
+                 *pn_ts = pn + 4 * BLOCK, *pn_ss = pn + 5 * BLOCK;
+    const double *pm_t = pm + BLOCK, *pm_s = pm + 2 * BLOCK, *pm_tt = pm + 3 * BLOCK,
+                 *pm_ts = pm + 4 * BLOCK, *pm_ss = pm + 5 * BLOCK;
+    for (int i = 0; i < nb; i++)
+    {
+      double s2 = s[i] * s[i];
+      pp[BLOCK + i] = A * (pn[i] + t[i] * pn_t[i]) - C * s2 * pm_t[i];
+      pp[2 * BLOCK + i] = A * t[i] * pn_s[i] - C * (2 * s[i] * pm[i] + s2 * pm_s[i]);
+    }
+    if (nd == 1) continue;
+
+    for (int i = 0; i < nb; i++)
+    {
+      double s2 = s[i] * s[i];
+      pp[3 * BLOCK + i] = A * (2 * pn_t[i] + t[i] * pn_tt[i]) - C * s2 * pm_tt[i];
+      pp[4 * BLOCK + i] = A * (pn_s[i] + t[i] * pn_ts[i]) - C * (2 * s[i] * pm_t[i] + s2 * pm_ts[i]);
+      pp[5 * BLOCK + i] = A * t[i] * pn_ss[i] - C * (2 * pm[i] + 4 * s[i] * pm_s[i] + s2 * pm_ss[i]);
+    }
+  }
+}
+
+
+// Stores c * f(g) with the derivatives of f by its argument w[d * BLOCK + i] as the values and
+// derivatives by x and y of the factor out, for the argument g = ga * x + gb * y + gc.
+static inline void chain_1d(int nb, const double* w, double c, double ga, double gb, int nd, int block, double* out)
+{
+  for (int i = 0; i < nb; i++) out[i] = c * w[i];
+  if (nd >= 1)
+  {
+    double ca = c * ga, cb = c * gb;
+    for (int i = 0; i < nb; i++) out[block + i] = ca * w[block + i];
+    for (int i = 0; i < nb; i++) out[2 * block + i] = cb * w[block + i];
+  }
+  if (nd >= 2)
+  {
+    double caa = c * ga * ga, cbb = c * gb * gb, cab = c * ga * gb;
+    for (int i = 0; i < nb; i++) out[3 * block + i] = caa * w[2 * block + i];
+    for (int i = 0; i < nb; i++) out[4 * block + i] = cbb * w[2 * block + i];
+    for (int i = 0; i < nb; i++) out[5 * block + i] = cab * w[2 * block + i];
+  }
+}
+
+
+void ShapesetEngine::eval_family(const Family& fam, int nb, const double* x, const double* y, int nd)
+{
+  const Affine& g = fam.arg[0];
+  double t[BLOCK], s[BLOCK];
+  for (int i = 0; i < nb; i++) t[i] = g.a * x[i] + g.b * y[i] + g.c;
+  double* out = &factors[fam.first * 6 * BLOCK];
+  int n = fam.max_n;
+
+  switch (fam.type)
+  {
+    case H2D_SE_LINEAR:
+    {
+      double w[3 * BLOCK];
+      for (int i = 0; i < nb; i++) { w[i] = t[i]; w[BLOCK + i] = 1.0; w[2 * BLOCK + i] = 0.0; }
+      chain_1d(nb, w, 1.0, g.a, g.b, nd, BLOCK, out);
+      break;
+    }
+
+    case H2D_SE_LEGENDRE:
+      jacobi(0, 0, n, nb, t, nd, &work[0]);
+      for (int k = 0; k <= n; k++)
+        chain_1d(nb, &work[k * 3 * BLOCK], 1.0, g.a, g.b, nd, BLOCK, out + k * 6 * BLOCK);
+      break;
+
+    case H2D_SE_LOBATTO:
+    {
+      // l_0 = (1 - t) / 2, l_1 = (1 + t) / 2, l_k = (P_k - P_{k-2}) / sqrt(2 (2k - 1)).
+      jacobi(0, 0, n, nb, t, nd, &work[0]);
+      double* w = &work2[0];
+      for (int k = 0; k <= n; k++)
+      {
+        const double* pk = &work[k * 3 * BLOCK];
+        if (k < 2)
+        {
+          double sg = k ? 1.0 : -1.0;
+          for (int i = 0; i < nb; i++)
+          {
+            w[i] = (1 + sg * t[i]) / 2;
+            w[BLOCK + i] = sg / 2;
+            w[2 * BLOCK + i] = 0.0;
+          }
+          chain_1d(nb, w, 1.0, g.a, g.b, nd, BLOCK, out + k * 6 * BLOCK);
+          continue;
+        }
+        const double* pm = &work[(k - 2) * 3 * BLOCK];
+        for (int d = 0; d <= nd; d++)
+          for (int i = 0; i < nb; i++)
+            w[d * BLOCK + i] = pk[d * BLOCK + i] - pm[d * BLOCK + i];
+        chain_1d(nb, w, 1.0 / sqrt(2.0 * (2 * k - 1)), g.a, g.b, nd, BLOCK, out + k * 6 * BLOCK);
+      }
+      break;
+    }
+
+    case H2D_SE_SCALED_LOBATTO:
+    {
+      const Affine& h = fam.arg[1];
+      for (int i = 0; i < nb; i++) s[i] = h.a * x[i] + h.b * y[i] + h.c;
+      scaled_legendre(n, nb, t, s, nd, &work[0]);
+
+      for (int k = 0; k <= n; k++)
+      {
+        // Partial derivatives by t, s, tt, ts, ss of s^k l_k(t / s): (s - t) / 2, (s + t) / 2,
+        // and (P_k - s^2 P_{k-2}) / sqrt(2 (2k - 1)) for the scaled Legendre polynomials P.
+        double* w = &work2[0];
+        if (k < 2)
+        {
+          double sg = k ? 1.0 : -1.0;
+          for (int i = 0; i < nb; i++)
+          {
+            w[i] = (s[i] + sg * t[i]) / 2;
+            w[BLOCK + i] = sg / 2;
+            w[2 * BLOCK + i] = 0.5;
+            w[3 * BLOCK + i] = w[4 * BLOCK + i] = w[5 * BLOCK + i] = 0.0;
+          }
+        }
+        else
+        {
+          double c = 1.0 / sqrt(2.0 * (2 * k - 1));
+          const double* pk = &work[k * 6 * BLOCK];
+          const double* pm = &work[(k - 2) * 6 * BLOCK];
+          for (int i = 0; i < nb; i++)
+            w[i] = c * (pk[i] - s[i] * s[i] * pm[i]);
+          if (nd >= 1)
+          {
+            for (int i = 0; i < nb; i++)
+            {
+              double s2 = s[i] * s[i];
+              w[BLOCK + i] = c * (pk[BLOCK + i] - s2 * pm[BLOCK + i]);
+              w[2 * BLOCK + i] = c * (pk[2 * BLOCK + i] - 2 * s[i] * pm[i] - s2 * pm[2 * BLOCK + i]);
+            }
+          }
+          if (nd >= 2)
+          {
+            for (int i = 0; i < nb; i++)
+            {
+              double s2 = s[i] * s[i];
+              w[3 * BLOCK + i] = c * (pk[3 * BLOCK + i] - s2 * pm[3 * BLOCK + i]);
+              w[4 * BLOCK + i] = c * (pk[4 * BLOCK + i] - 2 * s[i] * pm[BLOCK + i] - s2 * pm[4 * BLOCK + i]);
+              w[5 * BLOCK + i] = c * (pk[5 * BLOCK + i] - 2 * pm[i] - 4 * s[i] * pm[2 * BLOCK + i]
+                                      - s2 * pm[5 * BLOCK + i]);
+            }
+          }
+        }
+
+        double* o = out + k * 6 * BLOCK;
+        for (int i = 0; i < nb; i++) o[i] = w[i];
+        if (nd >= 1)
+          for (int i = 0; i < nb; i++)
+          {
+            o[BLOCK + i] = w[BLOCK + i] * g.a + w[2 * BLOCK + i] * h.a;
+            o[2 * BLOCK + i] = w[BLOCK + i] * g.b + w[2 * BLOCK + i] * h.b;
+          }
+        if (nd >= 2)
+          for (int i = 0; i < nb; i++)
+          {
+            double wtt = w[3 * BLOCK + i], wts = w[4 * BLOCK + i], wss = w[5 * BLOCK + i];
+            o[3 * BLOCK + i] = wtt * g.a * g.a + 2 * wts * g.a * h.a + wss * h.a * h.a;
+            o[4 * BLOCK + i] = wtt * g.b * g.b + 2 * wts * g.b * h.b + wss * h.b * h.b;
+            o[5 * BLOCK + i] = wtt * g.a * g.b + wts * (g.a * h.b + g.b * h.a) + wss * h.a * h.b;
+          }
+      }
+      break;
+    }
+
+    case H2D_SE_EDGE_KERNEL:
+    {
+      // phi_{k-2} = -2 sqrt((2k - 1) / 2) / (k - 1) P_{k-2}^{(1,1)}, times the product q of the
+      // two barycentric coordinates.
+      const Affine& l1 = fam.arg[1];
+      const Affine& l2 = fam.arg[2];
+      jacobi(1, 1, std::max(n - 2, 0), nb, t, nd, &work[0]);
+      double qxx = 2 * l1.a * l2.a, qyy = 2 * l1.b * l2.b, qxy = l1.a * l2.b + l1.b * l2.a;
+      for (int k = 2; k <= n; k++)
+      {
+        double* o = out + k * 6 * BLOCK;
+        chain_1d(nb, &work[(k - 2) * 3 * BLOCK], -2 * sqrt((2 * k - 1) / 2.0) / (k - 1), g.a, g.b, nd, BLOCK, o);
+        for (int i = 0; i < nb; i++)
+        {
+          double u = l1.a * x[i] + l1.b * y[i] + l1.c, v = l2.a * x[i] + l2.b * y[i] + l2.c;
+          double q = u * v, qx = l1.a * v + u * l2.a, qy = l1.b * v + u * l2.b;
+          if (nd >= 2)
+          {
+            o[3 * BLOCK + i] = qxx * o[i] + 2 * qx * o[BLOCK + i] + q * o[3 * BLOCK + i];
+            o[4 * BLOCK + i] = qyy * o[i] + 2 * qy * o[2 * BLOCK + i] + q * o[4 * BLOCK + i];
+            o[5 * BLOCK + i] = qxy * o[i] + qx * o[2 * BLOCK + i] + qy * o[BLOCK + i] + q * o[5 * BLOCK + i];
+          }
+          if (nd >= 1)
+          {
+            o[BLOCK + i] = qx * o[i] + q * o[BLOCK + i];
+            o[2 * BLOCK + i] = qy * o[i] + q * o[2 * BLOCK + i];
+          }
+          o[i] *= q;
+        }
+      }
+      break;
+    }
+
+    case H2D_SE_INT_JACOBI:
+    {
+      // The integral of P_{k-1}^{(alpha,0)} is 2 / (k + alpha - 1) P_k^{(alpha-1,-1)}.
+      jacobi(fam.alpha - 1, -1, n, nb, t, nd, &work[0]);
+      for (int k = 1; k <= n; k++)
+        chain_1d(nb, &work[k * 3 * BLOCK], 2.0 / (k + fam.alpha - 1), g.a, g.b, nd, BLOCK, out + k * 6 * BLOCK);
+      break;
+    }
+  }
+}
+
+
+void ShapesetEngine::eval_factors(int mode, int nb, const double* x, const double* y, int nd)
+{
+  int max_n = 0;
+  for (unsigned int i = 0; i < families[mode].size(); i++)
+    max_n = std::max(max_n, families[mode][i].max_n);
+  factors.resize(num_factors[mode] * 6 * BLOCK);
+  work.resize((max_n + 1) * 6 * BLOCK);
+  work2.resize(6 * BLOCK);
+
+  for (unsigned int i = 0; i < families[mode].size(); i++)
+    eval_family(families[mode][i], nb, x, y, nd);
+}
+
+
+void ShapesetEngine::eval(int mode, int np, const double* x, const double* y, double* result[6])
+{
+  _F_
+  int nd = 0;
+  for (int k = 1; k < 6; k++)
+    if (result[k] != NULL) nd = (k < 3) ? std::max(nd, 1) : 2;
+
+  int nf = products[mode].size();
+  for (int off = 0; off < np; off += BLOCK)
+  {
+    int nb = std::min(BLOCK, np - off);
+    eval_factors(mode, nb, x + off, y + off, nd);
+
+    for (int index = 0; index < nf; index++)
+    {
+      const Product& p = products[mode][index];
+      const double* a = &factors[p.f[0] * 6 * BLOCK];
+      const double* b = &factors[p.f[1] * 6 * BLOCK];
+      double c = p.coef;
+      const double *a0 = a, *a1 = a + BLOCK, *a2 = a + 2 * BLOCK;
+      const double *b0 = b, *b1 = b + BLOCK, *b2 = b + 2 * BLOCK;
+
+      double* r;
+      if ((r = result[H2D_FEI_VALUE]) != NULL)
+      {
+        r += index * np + off;
+        for (int i = 0; i < nb; i++) r[i] = c * a0[i] * b0[i];
+      }
+      if ((r = result[H2D_FEI_DX]) != NULL)
+      {
+        r += index * np + off;
+        for (int i = 0; i < nb; i++) r[i] = c * (a1[i] * b0[i] + a0[i] * b1[i]);
+      }
+      if ((r = result[H2D_FEI_DY]) != NULL)
+      {
+        r += index * np + off;
+        for (int i = 0; i < nb; i++) r[i] = c * (a2[i] * b0[i] + a0[i] * b2[i]);
+      }
+      if ((r = result[H2D_FEI_DXX]) != NULL)
+      {
+        r += index * np + off;
+        const double *a3 = a + 3 * BLOCK, *b3 = b + 3 * BLOCK;
+        for (int i = 0; i < nb; i++) r[i] = c * (a3[i] * b0[i] + 2 * a1[i] * b1[i] + a0[i] * b3[i]);
+      }
+      if ((r = result[H2D_FEI_DYY]) != NULL)
+      {
+        r += index * np + off;
+        const double *a4 = a + 4 * BLOCK, *b4 = b + 4 * BLOCK;
+        for (int i = 0; i < nb; i++) r[i] = c * (a4[i] * b0[i] + 2 * a2[i] * b2[i] + a0[i] * b4[i]);
+      }
+      if ((r = result[H2D_FEI_DXY]) != NULL)
+      {
+        r += index * np + off;
+        const double *a5 = a + 5 * BLOCK, *b5 = b + 5 * BLOCK;
+        for (int i = 0; i < nb; i++) r[i] = c * (a5[i] * b0[i] + a1[i] * b2[i] + a2[i] * b1[i] + a0[i] * b5[i]);
+      }
+    }
+  }
+}
+
+
+void ShapesetEngine::eval(int mode, int k, int np, const double* x, const double* y, double* result)
+{
+  double* res[6] = { NULL, NULL, NULL, NULL, NULL, NULL };
+  res[k] = result;
+  eval(mode, np, x, y, res);
+}
+
+
+void ShapesetEngine::eval_index(int mode, int index, int np, const double* x, const double* y,
+                                double* result[6])
+{
+  if (mode != cached_mode || (int) cached_x.size() != np || !std::equal(x, x + np, cached_x.begin())
+      || !std::equal(y, y + np, cached_y.begin())) {
+    cached_mode = mode;
+    cached_x.assign(x, x + np);
+    cached_y.assign(y, y + np);
+    for (int k = 0; k < 6; k++)
+      cached_valid[k] = false;
+  }
+
+  // The missing values are evaluated together.
+  double* missing[6] = { NULL, NULL, NULL, NULL, NULL, NULL };
+  bool any = false;
+  for (int k = 0; k < 6; k++)
+    if (result[k] != NULL && !cached_valid[k]) {
+      cached_values[k].resize((get_max_index(mode) + 1) * np);
+      missing[k] = &cached_values[k][0];
+      cached_valid[k] = any = true;
+    }
+  if (any)
+    eval(mode, np, x, y, missing);
+
+  for (int k = 0; k < 6; k++)
+    if (result[k] != NULL)
+      memcpy(result[k], &cached_values[k][index * np], np * sizeof(double));
+}
@@ -0,0 +1,133 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __H2D_SHAPESET_ENGINE_H
+#define __H2D_SHAPESET_ENGINE_H
+
+#include "shapeset.h"
+
+/// \brief Evaluates a whole shapeset at a batch of points by recurrences.
+///
+/// The generated shapesets define every shape function and each of its derivatives by a
+/// separate C function. ShapesetEngine instead builds the shape functions of a shapeset at
+/// runtime as products c * A(x, y) * B(x, y) of factors taken from a few families of
+/// polynomials of an affine function of the reference coordinates (Legendre and Lobatto
+/// polynomials, scaled Lobatto polynomials, Jacobi polynomials), and evaluates all
+/// polynomials of a family at once by their three-term recurrence. All loops run over the
+/// points, so that they can be vectorized by the compiler. The basis (indices, orientations,
+/// signs, normalization) is the same as the one of the shapeset up to the round-off.
+///
+/// Supported are the scalar shapesets H1ShapesetJacobi and L2ShapesetLegendre, in both modes.
+/// Not thread-safe: the engine keeps its scratch space.
+class HERMES_API ShapesetEngine
+{
+public:
+  ShapesetEngine(Shapeset* shapeset);
+
+  /// Returns true if the engine can evaluate the shapeset.
+  static bool is_supported(Shapeset* shapeset);
+
+  /// Returns the maximum index of a shape function in the mode.
+  int get_max_index(int mode) const { return (int) products[mode].size() - 1; }
+
+  /// Returns the id of the shapeset of the engine.
+  int get_shapeset_id() const { return shapeset_id; }
+
+  /// Sets result[k][index * np + i] to the value k (see Shapeset::get_value()) of the shape
+  /// function index at the point (x[i], y[i]) for all indices, for the values k with
+  /// result[k] != NULL.
+  void eval(int mode, int np, const double* x, const double* y, double* result[6]);
+  /// Sets result[index * np + i] to the value k of all shape functions.
+  void eval(int mode, int k, int np, const double* x, const double* y, double* result);
+  /// Sets result[k][i] to the value k of the shape function index at the point (x[i], y[i]),
+  /// for the values k with result[k] != NULL. The values of all shape functions are evaluated
+  /// at once and kept until the points change, so the calls for the other functions at the
+  /// same points only copy them (see PrecalcShapeset::set_shapeset_engine()).
+  void eval_index(int mode, int index, int np, const double* x, const double* y, double* result[6]);
+
+protected:
+  /// Number of points evaluated at once.
+  static const int BLOCK = 64;
+
+  /// An affine function a*x + b*y + c of the reference coordinates.
+  struct Affine
+  {
+    double a, b, c;
+  };
+
+  /// Family of factors: the polynomials 0, ..., max_n of the type in the arguments arg.
+  enum FamilyType
+  {
+    H2D_SE_LINEAR,          ///< arg[0] (a single factor).
+    H2D_SE_LEGENDRE,        ///< P_n(arg[0]).
+    H2D_SE_LOBATTO,         ///< l_n(arg[0]).
+    H2D_SE_SCALED_LOBATTO,  ///< arg[1]^n l_n(arg[0] / arg[1]) for n >= 2.
+    H2D_SE_EDGE_KERNEL,     ///< arg[1] arg[2] phi_{n-2}(arg[0]) for n >= 2 (Lobatto kernel functions).
+    H2D_SE_INT_JACOBI       ///< Integral of P_{n-1}^{(alpha,0)} from -1 to arg[0] for n >= 1.
+  };
+  struct Family
+  {
+    int type;
+    Affine arg[3];
+    double alpha;
+    int max_n;
+    int first;              ///< Index of the factor of the polynomial 0.
+  };
+  std::vector<Family> families[2];
+  int num_factors[2];
+
+  /// A shape function coef * factor[f[0]] * factor[f[1]].
+  struct Product
+  {
+    int f[2];
+    double coef;
+  };
+  std::vector<Product> products[2];
+
+  int shapeset_id;
+
+  /// Values of the factors in a block of points: factors[(f * 6 + k) * BLOCK + i].
+  std::vector<double> factors;
+  std::vector<double> work, work2;
+
+  /// The values of all shape functions at the points of the last eval_index(), for the values
+  /// k with cached_valid[k].
+  int cached_mode;
+  std::vector<double> cached_x, cached_y;
+  std::vector<double> cached_values[6];
+  bool cached_valid[6];
+
+  static Affine affine(double a, double b, double c);
+
+  int add_family(int mode, int type, int max_n, Affine a0, Affine a1, Affine a2, double alpha = 0.0);
+  void add_product(int mode, int f0, int f1, double coef);
+
+  void init_h1_jacobi(int max_order);
+  void init_l2_legendre(int max_order);
+  /// Scales the shape functions to a unit H1 seminorm on the reference domain.
+  void normalize(int mode, const std::vector<int>& indices);
+
+  /// Evaluates the factors in nb <= BLOCK points, with derivatives up to the order nd.
+  void eval_factors(int mode, int nb, const double* x, const double* y, int nd);
+  void eval_family(const Family& fam, int nb, const double* x, const double* y, int nd);
+  /// Jacobi polynomials P_n^{(alpha,beta)}(t[i]) and their derivatives up to the order nd,
+  /// out[(n * 3 + d) * BLOCK + i] for n = 0, ..., max_n.
+  static void jacobi(double alpha, double beta, int max_n, int nb, const double* t, int nd, double* out);
+  /// Scaled Legendre polynomials s^n P_n(t / s) and their partial derivatives (by t, s, tt,
+  /// ts, ss), out[(n * 6 + d) * BLOCK + i].
+  static void scaled_legendre(int max_n, int nb, const double* t, const double* s, int nd, double* out);
+};
+
+#endif
@@ -27,6 +27,7 @@ class HERMES_API H1ShapesetOrtho : public Shapeset
   public: H1ShapesetOrtho();
   virtual int get_id() const { return 0; }
   virtual ESpaceType get_space_type() const { return HERMES_H1_SPACE; }
+  virtual Shapeset* clone() { return new H1ShapesetOrtho(); }
 };
 
 
@@ -36,6 +37,7 @@ class HERMES_API H1ShapesetJacobi : public Shapeset
   public: H1ShapesetJacobi();
   virtual int get_id() const { return 1; }
   virtual ESpaceType get_space_type() const { return HERMES_H1_SPACE; }
+  virtual Shapeset* clone() { return new H1ShapesetJacobi(); }
 };
 
 
@@ -45,6 +47,7 @@ class HERMES_API H1ShapesetEigen : public Shapeset
   public: H1ShapesetEigen();
   virtual int get_id() const { return 2; }
   virtual ESpaceType get_space_type() const { return HERMES_H1_SPACE; }
+  virtual Shapeset* clone() { return new H1ShapesetEigen(); }
 };
 
 
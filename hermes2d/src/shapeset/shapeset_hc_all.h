@@ -27,6 +27,7 @@ class HERMES_API HcurlShapesetLegendre : public Shapeset
   public: HcurlShapesetLegendre();
   virtual int get_id() const { return 10; }
   virtual ESpaceType get_space_type() const { return HERMES_HCURL_SPACE; }
+  virtual Shapeset* clone() { return new HcurlShapesetLegendre(); }
 };
 
 
@@ -36,6 +37,7 @@ class HERMES_API HcurlShapesetEigen2 : public Shapeset
   public: HcurlShapesetEigen2();
   virtual int get_id() const { return 11; }
   virtual ESpaceType get_space_type() const { return HERMES_HCURL_SPACE; }
+  virtual Shapeset* clone() { return new HcurlShapesetEigen2(); }
 };
 
 
@@ -45,6 +47,7 @@ class HERMES_API HcurlShapesetGradEigen : public Shapeset
   public: HcurlShapesetGradEigen();
   virtual int get_id() const { return 12; }
   virtual ESpaceType get_space_type() const { return HERMES_HCURL_SPACE; }
+  virtual Shapeset* clone() { return new HcurlShapesetGradEigen(); }
 };
 
 
@@ -54,6 +57,7 @@ class HERMES_API HcurlShapesetGradLeg : public Shapeset
   public: HcurlShapesetGradLeg();
   virtual int get_id() const { return 13; }
   virtual ESpaceType get_space_type() const { return HERMES_HCURL_SPACE; }
+  virtual Shapeset* clone() { return new HcurlShapesetGradLeg(); }
 };
 
 
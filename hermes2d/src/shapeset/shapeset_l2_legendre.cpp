@@ -4029,17 +4029,15 @@ static double leg_tri_l0_l0(double x, double y)
 
 static double leg_tri_l0_l0x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1x = Legendre0x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2x = Legendre0x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l0_l0y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1y = Legendre0x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2y = Legendre0x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1y = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2y = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4050,17 +4048,15 @@ static double leg_tri_l0_l1(double x, double y)
 
 static double leg_tri_l0_l1x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1x = Legendre1x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2x = Legendre1x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l0_l1y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1y = Legendre1x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2y = Legendre1x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1y = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2y = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4071,17 +4067,15 @@ static double leg_tri_l1_l0(double x, double y)
 
 static double leg_tri_l1_l0x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1x = Legendre0x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2x = Legendre0x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l1_l0y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1y = Legendre0x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2y = Legendre0x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1y = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2y = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4092,17 +4086,15 @@ static double leg_tri_l0_l2(double x, double y)
 
 static double leg_tri_l0_l2x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1x = Legendre2x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2x = Legendre2x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l0_l2y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1y = Legendre2x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2y = Legendre2x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1y = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2y = Legendre2x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4113,17 +4105,15 @@ static double leg_tri_l2_l0(double x, double y)
 
 static double leg_tri_l2_l0x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre2(l3 - l2), L1x = Legendre0x(l3 - l2);
-  double L2 = Legendre2(l2 - l1), L2x = Legendre0x(l2 - l1);
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l2_l0y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre2(l3 - l2), L1y = Legendre0x(l3 - l2);
-  double L2 = Legendre2(l2 - l1), L2y = Legendre0x(l2 - l1);
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1y = Legendre2x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2y = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4134,17 +4124,15 @@ static double leg_tri_l0_l3(double x, double y)
 
 static double leg_tri_l0_l3x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1x = Legendre3x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2x = Legendre3x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l0_l3y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1y = Legendre3x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2y = Legendre3x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1y = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2y = Legendre3x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4155,17 +4143,15 @@ static double leg_tri_l3_l0(double x, double y)
 
 static double leg_tri_l3_l0x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre3(l3 - l2), L1x = Legendre0x(l3 - l2);
-  double L2 = Legendre3(l2 - l1), L2x = Legendre0x(l2 - l1);
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l3_l0y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre3(l3 - l2), L1y = Legendre0x(l3 - l2);
-  double L2 = Legendre3(l2 - l1), L2y = Legendre0x(l2 - l1);
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1y = Legendre3x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2y = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4176,17 +4162,15 @@ static double leg_tri_l0_l4(double x, double y)
 
 static double leg_tri_l0_l4x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1x = Legendre4x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2x = Legendre4x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l0_l4y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1y = Legendre4x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2y = Legendre4x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1y = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2y = Legendre4x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4197,17 +4181,15 @@ static double leg_tri_l4_l0(double x, double y)
 
 static double leg_tri_l4_l0x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre4(l3 - l2), L1x = Legendre0x(l3 - l2);
-  double L2 = Legendre4(l2 - l1), L2x = Legendre0x(l2 - l1);
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l4_l0y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre4(l3 - l2), L1y = Legendre0x(l3 - l2);
-  double L2 = Legendre4(l2 - l1), L2y = Legendre0x(l2 - l1);
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1y = Legendre4x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2y = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4218,17 +4200,15 @@ static double leg_tri_l0_l5(double x, double y)
 
 static double leg_tri_l0_l5x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1x = Legendre5x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2x = Legendre5x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l0_l5y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1y = Legendre5x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2y = Legendre5x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1y = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2y = Legendre5x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4239,17 +4219,15 @@ static double leg_tri_l5_l0(double x, double y)
 
 static double leg_tri_l5_l0x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre5(l3 - l2), L1x = Legendre0x(l3 - l2);
-  double L2 = Legendre5(l2 - l1), L2x = Legendre0x(l2 - l1);
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l5_l0y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre5(l3 - l2), L1y = Legendre0x(l3 - l2);
-  double L2 = Legendre5(l2 - l1), L2y = Legendre0x(l2 - l1);
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1y = Legendre5x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2y = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4260,17 +4238,15 @@ static double leg_tri_l0_l6(double x, double y)
 
 static double leg_tri_l0_l6x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1x = Legendre6x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2x = Legendre6x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l0_l6y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1y = Legendre6x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2y = Legendre6x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1y = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2y = Legendre6x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4281,17 +4257,15 @@ static double leg_tri_l6_l0(double x, double y)
 
 static double leg_tri_l6_l0x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre6(l3 - l2), L1x = Legendre0x(l3 - l2);
-  double L2 = Legendre6(l2 - l1), L2x = Legendre0x(l2 - l1);
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l6_l0y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre6(l3 - l2), L1y = Legendre0x(l3 - l2);
-  double L2 = Legendre6(l2 - l1), L2y = Legendre0x(l2 - l1);
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1y = Legendre6x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2y = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4302,17 +4276,15 @@ static double leg_tri_l0_l7(double x, double y)
 
 static double leg_tri_l0_l7x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1x = Legendre7x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2x = Legendre7x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2x = Legendre7x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l0_l7y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1y = Legendre7x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2y = Legendre7x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1y = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2y = Legendre7x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4323,17 +4295,15 @@ static double leg_tri_l7_l0(double x, double y)
 
 static double leg_tri_l7_l0x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre7(l3 - l2), L1x = Legendre0x(l3 - l2);
-  double L2 = Legendre7(l2 - l1), L2x = Legendre0x(l2 - l1);
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1x = Legendre7x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l7_l0y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre7(l3 - l2), L1y = Legendre0x(l3 - l2);
-  double L2 = Legendre7(l2 - l1), L2y = Legendre0x(l2 - l1);
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1y = Legendre7x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2y = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4344,17 +4314,15 @@ static double leg_tri_l0_l8(double x, double y)
 
 static double leg_tri_l0_l8x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1x = Legendre8x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2x = Legendre8x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre8(lambda2(x,y) - lambda1(x,y)), L2x = Legendre8x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l0_l8y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1y = Legendre8x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2y = Legendre8x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1y = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre8(lambda2(x,y) - lambda1(x,y)), L2y = Legendre8x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4365,17 +4333,15 @@ static double leg_tri_l8_l0(double x, double y)
 
 static double leg_tri_l8_l0x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre8(l3 - l2), L1x = Legendre0x(l3 - l2);
-  double L2 = Legendre8(l2 - l1), L2x = Legendre0x(l2 - l1);
+  double L1 = Legendre8(lambda3(x,y) - lambda2(x,y)), L1x = Legendre8x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l8_l0y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre8(l3 - l2), L1y = Legendre0x(l3 - l2);
-  double L2 = Legendre8(l2 - l1), L2y = Legendre0x(l2 - l1);
+  double L1 = Legendre8(lambda3(x,y) - lambda2(x,y)), L1y = Legendre8x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2y = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4386,17 +4352,15 @@ static double leg_tri_l0_l9(double x, double y)
 
 static double leg_tri_l0_l9x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1x = Legendre9x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2x = Legendre9x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre9(lambda2(x,y) - lambda1(x,y)), L2x = Legendre9x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l0_l9y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1y = Legendre9x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2y = Legendre9x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1y = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre9(lambda2(x,y) - lambda1(x,y)), L2y = Legendre9x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4407,17 +4371,15 @@ static double leg_tri_l9_l0(double x, double y)
 
 static double leg_tri_l9_l0x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre9(l3 - l2), L1x = Legendre0x(l3 - l2);
-  double L2 = Legendre9(l2 - l1), L2x = Legendre0x(l2 - l1);
+  double L1 = Legendre9(lambda3(x,y) - lambda2(x,y)), L1x = Legendre9x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l9_l0y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre9(l3 - l2), L1y = Legendre0x(l3 - l2);
-  double L2 = Legendre9(l2 - l1), L2y = Legendre0x(l2 - l1);
+  double L1 = Legendre9(lambda3(x,y) - lambda2(x,y)), L1y = Legendre9x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2y = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4428,17 +4390,15 @@ static double leg_tri_l0_l10(double x, double y)
 
 static double leg_tri_l0_l10x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1x = Legendre10x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2x = Legendre10x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre10(lambda2(x,y) - lambda1(x,y)), L2x = Legendre10x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l0_l10y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre0(l3 - l2), L1y = Legendre10x(l3 - l2);
-  double L2 = Legendre0(l2 - l1), L2y = Legendre10x(l2 - l1);
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1y = Legendre0x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre10(lambda2(x,y) - lambda1(x,y)), L2y = Legendre10x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4449,17 +4409,15 @@ static double leg_tri_l10_l0(double x, double y)
 
 static double leg_tri_l10_l0x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre10(l3 - l2), L1x = Legendre0x(l3 - l2);
-  double L2 = Legendre10(l2 - l1), L2x = Legendre0x(l2 - l1);
+  double L1 = Legendre10(lambda3(x,y) - lambda2(x,y)), L1x = Legendre10x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l10_l0y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre10(l3 - l2), L1y = Legendre0x(l3 - l2);
-  double L2 = Legendre10(l2 - l1), L2y = Legendre0x(l2 - l1);
+  double L1 = Legendre10(lambda3(x,y) - lambda2(x,y)), L1y = Legendre10x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2y = Legendre0x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4470,17 +4428,15 @@ static double leg_tri_l1_l1(double x, double y)
 
 static double leg_tri_l1_l1x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1x = Legendre1x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2x = Legendre1x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l1_l1y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1y = Legendre1x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2y = Legendre1x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1y = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2y = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4491,17 +4447,15 @@ static double leg_tri_l1_l2(double x, double y)
 
 static double leg_tri_l1_l2x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1x = Legendre2x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2x = Legendre2x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l1_l2y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1y = Legendre2x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2y = Legendre2x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1y = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2y = Legendre2x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4512,17 +4466,15 @@ static double leg_tri_l2_l1(double x, double y)
 
 static double leg_tri_l2_l1x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre2(l3 - l2), L1x = Legendre1x(l3 - l2);
-  double L2 = Legendre2(l2 - l1), L2x = Legendre1x(l2 - l1);
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l2_l1y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre2(l3 - l2), L1y = Legendre1x(l3 - l2);
-  double L2 = Legendre2(l2 - l1), L2y = Legendre1x(l2 - l1);
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1y = Legendre2x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2y = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4533,17 +4485,15 @@ static double leg_tri_l1_l3(double x, double y)
 
 static double leg_tri_l1_l3x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1x = Legendre3x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2x = Legendre3x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l1_l3y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1y = Legendre3x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2y = Legendre3x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1y = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2y = Legendre3x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4554,17 +4504,15 @@ static double leg_tri_l3_l1(double x, double y)
 
 static double leg_tri_l3_l1x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre3(l3 - l2), L1x = Legendre1x(l3 - l2);
-  double L2 = Legendre3(l2 - l1), L2x = Legendre1x(l2 - l1);
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l3_l1y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre3(l3 - l2), L1y = Legendre1x(l3 - l2);
-  double L2 = Legendre3(l2 - l1), L2y = Legendre1x(l2 - l1);
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1y = Legendre3x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2y = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4575,17 +4523,15 @@ static double leg_tri_l1_l4(double x, double y)
 
 static double leg_tri_l1_l4x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1x = Legendre4x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2x = Legendre4x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l1_l4y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1y = Legendre4x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2y = Legendre4x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1y = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2y = Legendre4x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4596,17 +4542,15 @@ static double leg_tri_l4_l1(double x, double y)
 
 static double leg_tri_l4_l1x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre4(l3 - l2), L1x = Legendre1x(l3 - l2);
-  double L2 = Legendre4(l2 - l1), L2x = Legendre1x(l2 - l1);
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l4_l1y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre4(l3 - l2), L1y = Legendre1x(l3 - l2);
-  double L2 = Legendre4(l2 - l1), L2y = Legendre1x(l2 - l1);
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1y = Legendre4x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2y = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4617,17 +4561,15 @@ static double leg_tri_l1_l5(double x, double y)
 
 static double leg_tri_l1_l5x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1x = Legendre5x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2x = Legendre5x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l1_l5y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1y = Legendre5x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2y = Legendre5x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1y = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2y = Legendre5x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4638,17 +4580,15 @@ static double leg_tri_l5_l1(double x, double y)
 
 static double leg_tri_l5_l1x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre5(l3 - l2), L1x = Legendre1x(l3 - l2);
-  double L2 = Legendre5(l2 - l1), L2x = Legendre1x(l2 - l1);
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l5_l1y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre5(l3 - l2), L1y = Legendre1x(l3 - l2);
-  double L2 = Legendre5(l2 - l1), L2y = Legendre1x(l2 - l1);
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1y = Legendre5x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2y = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4659,17 +4599,15 @@ static double leg_tri_l1_l6(double x, double y)
 
 static double leg_tri_l1_l6x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1x = Legendre6x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2x = Legendre6x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l1_l6y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1y = Legendre6x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2y = Legendre6x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1y = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2y = Legendre6x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4680,17 +4618,15 @@ static double leg_tri_l6_l1(double x, double y)
 
 static double leg_tri_l6_l1x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre6(l3 - l2), L1x = Legendre1x(l3 - l2);
-  double L2 = Legendre6(l2 - l1), L2x = Legendre1x(l2 - l1);
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l6_l1y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre6(l3 - l2), L1y = Legendre1x(l3 - l2);
-  double L2 = Legendre6(l2 - l1), L2y = Legendre1x(l2 - l1);
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1y = Legendre6x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2y = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4701,17 +4637,15 @@ static double leg_tri_l1_l7(double x, double y)
 
 static double leg_tri_l1_l7x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1x = Legendre7x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2x = Legendre7x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2x = Legendre7x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l1_l7y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1y = Legendre7x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2y = Legendre7x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1y = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2y = Legendre7x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4722,17 +4656,15 @@ static double leg_tri_l7_l1(double x, double y)
 
 static double leg_tri_l7_l1x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre7(l3 - l2), L1x = Legendre1x(l3 - l2);
-  double L2 = Legendre7(l2 - l1), L2x = Legendre1x(l2 - l1);
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1x = Legendre7x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l7_l1y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre7(l3 - l2), L1y = Legendre1x(l3 - l2);
-  double L2 = Legendre7(l2 - l1), L2y = Legendre1x(l2 - l1);
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1y = Legendre7x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2y = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4743,17 +4675,15 @@ static double leg_tri_l1_l8(double x, double y)
 
 static double leg_tri_l1_l8x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1x = Legendre8x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2x = Legendre8x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre8(lambda2(x,y) - lambda1(x,y)), L2x = Legendre8x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l1_l8y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1y = Legendre8x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2y = Legendre8x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1y = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre8(lambda2(x,y) - lambda1(x,y)), L2y = Legendre8x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4764,17 +4694,15 @@ static double leg_tri_l8_l1(double x, double y)
 
 static double leg_tri_l8_l1x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre8(l3 - l2), L1x = Legendre1x(l3 - l2);
-  double L2 = Legendre8(l2 - l1), L2x = Legendre1x(l2 - l1);
+  double L1 = Legendre8(lambda3(x,y) - lambda2(x,y)), L1x = Legendre8x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l8_l1y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre8(l3 - l2), L1y = Legendre1x(l3 - l2);
-  double L2 = Legendre8(l2 - l1), L2y = Legendre1x(l2 - l1);
+  double L1 = Legendre8(lambda3(x,y) - lambda2(x,y)), L1y = Legendre8x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2y = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4785,17 +4713,15 @@ static double leg_tri_l1_l9(double x, double y)
 
 static double leg_tri_l1_l9x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1x = Legendre9x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2x = Legendre9x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre9(lambda2(x,y) - lambda1(x,y)), L2x = Legendre9x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l1_l9y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre1(l3 - l2), L1y = Legendre9x(l3 - l2);
-  double L2 = Legendre1(l2 - l1), L2y = Legendre9x(l2 - l1);
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1y = Legendre1x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre9(lambda2(x,y) - lambda1(x,y)), L2y = Legendre9x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4806,17 +4732,15 @@ static double leg_tri_l9_l1(double x, double y)
 
 static double leg_tri_l9_l1x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre9(l3 - l2), L1x = Legendre1x(l3 - l2);
-  double L2 = Legendre9(l2 - l1), L2x = Legendre1x(l2 - l1);
+  double L1 = Legendre9(lambda3(x,y) - lambda2(x,y)), L1x = Legendre9x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l9_l1y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre9(l3 - l2), L1y = Legendre1x(l3 - l2);
-  double L2 = Legendre9(l2 - l1), L2y = Legendre1x(l2 - l1);
+  double L1 = Legendre9(lambda3(x,y) - lambda2(x,y)), L1y = Legendre9x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2y = Legendre1x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4827,17 +4751,15 @@ static double leg_tri_l2_l2(double x, double y)
 
 static double leg_tri_l2_l2x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre2(l3 - l2), L1x = Legendre2x(l3 - l2);
-  double L2 = Legendre2(l2 - l1), L2x = Legendre2x(l2 - l1);
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l2_l2y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre2(l3 - l2), L1y = Legendre2x(l3 - l2);
-  double L2 = Legendre2(l2 - l1), L2y = Legendre2x(l2 - l1);
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1y = Legendre2x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2y = Legendre2x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4848,17 +4770,15 @@ static double leg_tri_l2_l3(double x, double y)
 
 static double leg_tri_l2_l3x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre2(l3 - l2), L1x = Legendre3x(l3 - l2);
-  double L2 = Legendre2(l2 - l1), L2x = Legendre3x(l2 - l1);
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l2_l3y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre2(l3 - l2), L1y = Legendre3x(l3 - l2);
-  double L2 = Legendre2(l2 - l1), L2y = Legendre3x(l2 - l1);
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1y = Legendre2x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2y = Legendre3x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4869,17 +4789,15 @@ static double leg_tri_l3_l2(double x, double y)
 
 static double leg_tri_l3_l2x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre3(l3 - l2), L1x = Legendre2x(l3 - l2);
-  double L2 = Legendre3(l2 - l1), L2x = Legendre2x(l2 - l1);
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l3_l2y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre3(l3 - l2), L1y = Legendre2x(l3 - l2);
-  double L2 = Legendre3(l2 - l1), L2y = Legendre2x(l2 - l1);
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1y = Legendre3x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2y = Legendre2x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4890,17 +4808,15 @@ static double leg_tri_l2_l4(double x, double y)
 
 static double leg_tri_l2_l4x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre2(l3 - l2), L1x = Legendre4x(l3 - l2);
-  double L2 = Legendre2(l2 - l1), L2x = Legendre4x(l2 - l1);
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l2_l4y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre2(l3 - l2), L1y = Legendre4x(l3 - l2);
-  double L2 = Legendre2(l2 - l1), L2y = Legendre4x(l2 - l1);
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1y = Legendre2x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2y = Legendre4x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4911,17 +4827,15 @@ static double leg_tri_l4_l2(double x, double y)
 
 static double leg_tri_l4_l2x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre4(l3 - l2), L1x = Legendre2x(l3 - l2);
-  double L2 = Legendre4(l2 - l1), L2x = Legendre2x(l2 - l1);
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l4_l2y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre4(l3 - l2), L1y = Legendre2x(l3 - l2);
-  double L2 = Legendre4(l2 - l1), L2y = Legendre2x(l2 - l1);
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1y = Legendre4x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2y = Legendre2x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4932,17 +4846,15 @@ static double leg_tri_l2_l5(double x, double y)
 
 static double leg_tri_l2_l5x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre2(l3 - l2), L1x = Legendre5x(l3 - l2);
-  double L2 = Legendre2(l2 - l1), L2x = Legendre5x(l2 - l1);
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l2_l5y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre2(l3 - l2), L1y = Legendre5x(l3 - l2);
-  double L2 = Legendre2(l2 - l1), L2y = Legendre5x(l2 - l1);
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1y = Legendre2x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2y = Legendre5x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4953,17 +4865,15 @@ static double leg_tri_l5_l2(double x, double y)
 
 static double leg_tri_l5_l2x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre5(l3 - l2), L1x = Legendre2x(l3 - l2);
-  double L2 = Legendre5(l2 - l1), L2x = Legendre2x(l2 - l1);
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l5_l2y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre5(l3 - l2), L1y = Legendre2x(l3 - l2);
-  double L2 = Legendre5(l2 - l1), L2y = Legendre2x(l2 - l1);
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1y = Legendre5x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2y = Legendre2x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4974,17 +4884,15 @@ static double leg_tri_l2_l6(double x, double y)
 
 static double leg_tri_l2_l6x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre2(l3 - l2), L1x = Legendre6x(l3 - l2);
-  double L2 = Legendre2(l2 - l1), L2x = Legendre6x(l2 - l1);
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l2_l6y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre2(l3 - l2), L1y = Legendre6x(l3 - l2);
-  double L2 = Legendre2(l2 - l1), L2y = Legendre6x(l2 - l1);
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1y = Legendre2x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2y = Legendre6x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -4995,17 +4903,15 @@ static double leg_tri_l6_l2(double x, double y)
 
 static double leg_tri_l6_l2x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre6(l3 - l2), L1x = Legendre2x(l3 - l2);
-  double L2 = Legendre6(l2 - l1), L2x = Legendre2x(l2 - l1);
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l6_l2y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre6(l3 - l2), L1y = Legendre2x(l3 - l2);
-  double L2 = Legendre6(l2 - l1), L2y = Legendre2x(l2 - l1);
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1y = Legendre6x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2y = Legendre2x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -5016,17 +4922,15 @@ static double leg_tri_l2_l7(double x, double y)
 
 static double leg_tri_l2_l7x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre2(l3 - l2), L1x = Legendre7x(l3 - l2);
-  double L2 = Legendre2(l2 - l1), L2x = Legendre7x(l2 - l1);
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2x = Legendre7x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l2_l7y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre2(l3 - l2), L1y = Legendre7x(l3 - l2);
-  double L2 = Legendre2(l2 - l1), L2y = Legendre7x(l2 - l1);
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1y = Legendre2x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2y = Legendre7x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -5037,17 +4941,15 @@ static double leg_tri_l7_l2(double x, double y)
 
 static double leg_tri_l7_l2x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre7(l3 - l2), L1x = Legendre2x(l3 - l2);
-  double L2 = Legendre7(l2 - l1), L2x = Legendre2x(l2 - l1);
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1x = Legendre7x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l7_l2y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre7(l3 - l2), L1y = Legendre2x(l3 - l2);
-  double L2 = Legendre7(l2 - l1), L2y = Legendre2x(l2 - l1);
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1y = Legendre7x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2y = Legendre2x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -5058,17 +4960,15 @@ static double leg_tri_l2_l8(double x, double y)
 
 static double leg_tri_l2_l8x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre2(l3 - l2), L1x = Legendre8x(l3 - l2);
-  double L2 = Legendre2(l2 - l1), L2x = Legendre8x(l2 - l1);
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre8(lambda2(x,y) - lambda1(x,y)), L2x = Legendre8x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l2_l8y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre2(l3 - l2), L1y = Legendre8x(l3 - l2);
-  double L2 = Legendre2(l2 - l1), L2y = Legendre8x(l2 - l1);
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1y = Legendre2x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre8(lambda2(x,y) - lambda1(x,y)), L2y = Legendre8x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -5079,17 +4979,15 @@ static double leg_tri_l8_l2(double x, double y)
 
 static double leg_tri_l8_l2x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre8(l3 - l2), L1x = Legendre2x(l3 - l2);
-  double L2 = Legendre8(l2 - l1), L2x = Legendre2x(l2 - l1);
+  double L1 = Legendre8(lambda3(x,y) - lambda2(x,y)), L1x = Legendre8x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l8_l2y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre8(l3 - l2), L1y = Legendre2x(l3 - l2);
-  double L2 = Legendre8(l2 - l1), L2y = Legendre2x(l2 - l1);
+  double L1 = Legendre8(lambda3(x,y) - lambda2(x,y)), L1y = Legendre8x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2y = Legendre2x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -5100,17 +4998,15 @@ static double leg_tri_l3_l3(double x, double y)
 
 static double leg_tri_l3_l3x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre3(l3 - l2), L1x = Legendre3x(l3 - l2);
-  double L2 = Legendre3(l2 - l1), L2x = Legendre3x(l2 - l1);
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l3_l3y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre3(l3 - l2), L1y = Legendre3x(l3 - l2);
-  double L2 = Legendre3(l2 - l1), L2y = Legendre3x(l2 - l1);
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1y = Legendre3x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2y = Legendre3x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -5121,17 +5017,15 @@ static double leg_tri_l3_l4(double x, double y)
 
 static double leg_tri_l3_l4x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre3(l3 - l2), L1x = Legendre4x(l3 - l2);
-  double L2 = Legendre3(l2 - l1), L2x = Legendre4x(l2 - l1);
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l3_l4y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre3(l3 - l2), L1y = Legendre4x(l3 - l2);
-  double L2 = Legendre3(l2 - l1), L2y = Legendre4x(l2 - l1);
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1y = Legendre3x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2y = Legendre4x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -5142,17 +5036,15 @@ static double leg_tri_l4_l3(double x, double y)
 
 static double leg_tri_l4_l3x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre4(l3 - l2), L1x = Legendre3x(l3 - l2);
-  double L2 = Legendre4(l2 - l1), L2x = Legendre3x(l2 - l1);
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l4_l3y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre4(l3 - l2), L1y = Legendre3x(l3 - l2);
-  double L2 = Legendre4(l2 - l1), L2y = Legendre3x(l2 - l1);
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1y = Legendre4x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2y = Legendre3x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -5163,17 +5055,15 @@ static double leg_tri_l3_l5(double x, double y)
 
 static double leg_tri_l3_l5x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre3(l3 - l2), L1x = Legendre5x(l3 - l2);
-  double L2 = Legendre3(l2 - l1), L2x = Legendre5x(l2 - l1);
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l3_l5y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre3(l3 - l2), L1y = Legendre5x(l3 - l2);
-  double L2 = Legendre3(l2 - l1), L2y = Legendre5x(l2 - l1);
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1y = Legendre3x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2y = Legendre5x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -5184,17 +5074,15 @@ static double leg_tri_l5_l3(double x, double y)
 
 static double leg_tri_l5_l3x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre5(l3 - l2), L1x = Legendre3x(l3 - l2);
-  double L2 = Legendre5(l2 - l1), L2x = Legendre3x(l2 - l1);
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l5_l3y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre5(l3 - l2), L1y = Legendre3x(l3 - l2);
-  double L2 = Legendre5(l2 - l1), L2y = Legendre3x(l2 - l1);
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1y = Legendre5x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2y = Legendre3x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -5205,17 +5093,15 @@ static double leg_tri_l3_l6(double x, double y)
 
 static double leg_tri_l3_l6x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre3(l3 - l2), L1x = Legendre6x(l3 - l2);
-  double L2 = Legendre3(l2 - l1), L2x = Legendre6x(l2 - l1);
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l3_l6y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre3(l3 - l2), L1y = Legendre6x(l3 - l2);
-  double L2 = Legendre3(l2 - l1), L2y = Legendre6x(l2 - l1);
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1y = Legendre3x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2y = Legendre6x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -5226,17 +5112,15 @@ static double leg_tri_l6_l3(double x, double y)
 
 static double leg_tri_l6_l3x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre6(l3 - l2), L1x = Legendre3x(l3 - l2);
-  double L2 = Legendre6(l2 - l1), L2x = Legendre3x(l2 - l1);
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l6_l3y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre6(l3 - l2), L1y = Legendre3x(l3 - l2);
-  double L2 = Legendre6(l2 - l1), L2y = Legendre3x(l2 - l1);
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1y = Legendre6x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2y = Legendre3x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -5247,17 +5131,15 @@ static double leg_tri_l3_l7(double x, double y)
 
 static double leg_tri_l3_l7x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre3(l3 - l2), L1x = Legendre7x(l3 - l2);
-  double L2 = Legendre3(l2 - l1), L2x = Legendre7x(l2 - l1);
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2x = Legendre7x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l3_l7y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre3(l3 - l2), L1y = Legendre7x(l3 - l2);
-  double L2 = Legendre3(l2 - l1), L2y = Legendre7x(l2 - l1);
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1y = Legendre3x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2y = Legendre7x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -5268,17 +5150,15 @@ static double leg_tri_l7_l3(double x, double y)
 
 static double leg_tri_l7_l3x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre7(l3 - l2), L1x = Legendre3x(l3 - l2);
-  double L2 = Legendre7(l2 - l1), L2x = Legendre3x(l2 - l1);
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1x = Legendre7x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l7_l3y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre7(l3 - l2), L1y = Legendre3x(l3 - l2);
-  double L2 = Legendre7(l2 - l1), L2y = Legendre3x(l2 - l1);
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1y = Legendre7x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2y = Legendre3x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -5289,17 +5169,15 @@ static double leg_tri_l4_l4(double x, double y)
 
 static double leg_tri_l4_l4x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre4(l3 - l2), L1x = Legendre4x(l3 - l2);
-  double L2 = Legendre4(l2 - l1), L2x = Legendre4x(l2 - l1);
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l4_l4y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre4(l3 - l2), L1y = Legendre4x(l3 - l2);
-  double L2 = Legendre4(l2 - l1), L2y = Legendre4x(l2 - l1);
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1y = Legendre4x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2y = Legendre4x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -5310,17 +5188,15 @@ static double leg_tri_l4_l5(double x, double y)
 
 static double leg_tri_l4_l5x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre4(l3 - l2), L1x = Legendre5x(l3 - l2);
-  double L2 = Legendre4(l2 - l1), L2x = Legendre5x(l2 - l1);
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l4_l5y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre4(l3 - l2), L1y = Legendre5x(l3 - l2);
-  double L2 = Legendre4(l2 - l1), L2y = Legendre5x(l2 - l1);
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1y = Legendre4x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2y = Legendre5x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -5331,17 +5207,15 @@ static double leg_tri_l5_l4(double x, double y)
 
 static double leg_tri_l5_l4x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre5(l3 - l2), L1x = Legendre4x(l3 - l2);
-  double L2 = Legendre5(l2 - l1), L2x = Legendre4x(l2 - l1);
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l5_l4y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre5(l3 - l2), L1y = Legendre4x(l3 - l2);
-  double L2 = Legendre5(l2 - l1), L2y = Legendre4x(l2 - l1);
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1y = Legendre5x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2y = Legendre4x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -5352,17 +5226,15 @@ static double leg_tri_l4_l6(double x, double y)
 
 static double leg_tri_l4_l6x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre4(l3 - l2), L1x = Legendre6x(l3 - l2);
-  double L2 = Legendre4(l2 - l1), L2x = Legendre6x(l2 - l1);
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l4_l6y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre4(l3 - l2), L1y = Legendre6x(l3 - l2);
-  double L2 = Legendre4(l2 - l1), L2y = Legendre6x(l2 - l1);
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1y = Legendre4x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2y = Legendre6x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -5373,17 +5245,15 @@ static double leg_tri_l6_l4(double x, double y)
 
 static double leg_tri_l6_l4x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre6(l3 - l2), L1x = Legendre4x(l3 - l2);
-  double L2 = Legendre6(l2 - l1), L2x = Legendre4x(l2 - l1);
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l6_l4y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre6(l3 - l2), L1y = Legendre4x(l3 - l2);
-  double L2 = Legendre6(l2 - l1), L2y = Legendre4x(l2 - l1);
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1y = Legendre6x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2y = Legendre4x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
@@ -5394,20 +5264,1800 @@ static double leg_tri_l5_l5(double x, double y)
 
 static double leg_tri_l5_l5x(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre5(l3 - l2), L1x = Legendre5x(l3 - l2);
-  double L2 = Legendre5(l2 - l1), L2x = Legendre5x(l2 - l1);
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y));
   return L1x * (lambda3x(x,y) - lambda2x(x,y)) * L2 + L1 * L2x * (lambda2x(x,y) - lambda1x(x,y));
 }
 
 static double leg_tri_l5_l5y(double x, double y)
 {
-  double l1 = lambda1(x,y), l2 = lambda2(x,y), l3 = lambda3(x,y);
-  double L1 = Legendre5(l3 - l2), L1y = Legendre5x(l3 - l2);
-  double L2 = Legendre5(l2 - l1), L2y = Legendre5x(l2 - l1);
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1y = Legendre5x(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2y = Legendre5x(lambda2(x,y) - lambda1(x,y));
   return L1y * (lambda3y(x,y) - lambda2y(x,y)) * L2 + L1 * L2y * (lambda2y(x,y) - lambda1y(x,y));
 }
 
+static double leg_tri_l0_l0xx(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l0yy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l0xy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l1xx(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l1yy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l1xy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l0xx(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l0yy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l0xy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l2xx(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l2yy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l2xy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l0xx(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l0yy(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l0xy(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l3xx(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l3yy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l3xy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l0xx(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l0yy(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l0xy(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l4xx(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l4yy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l4xy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l0xx(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l0yy(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l0xy(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l5xx(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre5xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l5yy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre5xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l5xy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre5xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l5_l0xx(double x, double y)
+{
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre5xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l5_l0yy(double x, double y)
+{
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre5xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l5_l0xy(double x, double y)
+{
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre5xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l6xx(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre6xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l6yy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre6xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l6xy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre6xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l6_l0xx(double x, double y)
+{
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre6xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l6_l0yy(double x, double y)
+{
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre6xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l6_l0xy(double x, double y)
+{
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre6xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l7xx(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2x = Legendre7x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre7xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l7yy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2x = Legendre7x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre7xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l7xy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2x = Legendre7x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre7xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l7_l0xx(double x, double y)
+{
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1x = Legendre7x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre7xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l7_l0yy(double x, double y)
+{
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1x = Legendre7x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre7xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l7_l0xy(double x, double y)
+{
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1x = Legendre7x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre7xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l8xx(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre8(lambda2(x,y) - lambda1(x,y)), L2x = Legendre8x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre8xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l8yy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre8(lambda2(x,y) - lambda1(x,y)), L2x = Legendre8x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre8xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l8xy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre8(lambda2(x,y) - lambda1(x,y)), L2x = Legendre8x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre8xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l8_l0xx(double x, double y)
+{
+  double L1 = Legendre8(lambda3(x,y) - lambda2(x,y)), L1x = Legendre8x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre8xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l8_l0yy(double x, double y)
+{
+  double L1 = Legendre8(lambda3(x,y) - lambda2(x,y)), L1x = Legendre8x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre8xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l8_l0xy(double x, double y)
+{
+  double L1 = Legendre8(lambda3(x,y) - lambda2(x,y)), L1x = Legendre8x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre8xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l9xx(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre9(lambda2(x,y) - lambda1(x,y)), L2x = Legendre9x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre9xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l9yy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre9(lambda2(x,y) - lambda1(x,y)), L2x = Legendre9x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre9xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l9xy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre9(lambda2(x,y) - lambda1(x,y)), L2x = Legendre9x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre9xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l9_l0xx(double x, double y)
+{
+  double L1 = Legendre9(lambda3(x,y) - lambda2(x,y)), L1x = Legendre9x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre9xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l9_l0yy(double x, double y)
+{
+  double L1 = Legendre9(lambda3(x,y) - lambda2(x,y)), L1x = Legendre9x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre9xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l9_l0xy(double x, double y)
+{
+  double L1 = Legendre9(lambda3(x,y) - lambda2(x,y)), L1x = Legendre9x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre9xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l10xx(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre10(lambda2(x,y) - lambda1(x,y)), L2x = Legendre10x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre10xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l10yy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre10(lambda2(x,y) - lambda1(x,y)), L2x = Legendre10x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre10xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l0_l10xy(double x, double y)
+{
+  double L1 = Legendre0(lambda3(x,y) - lambda2(x,y)), L1x = Legendre0x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre0xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre10(lambda2(x,y) - lambda1(x,y)), L2x = Legendre10x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre10xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l10_l0xx(double x, double y)
+{
+  double L1 = Legendre10(lambda3(x,y) - lambda2(x,y)), L1x = Legendre10x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre10xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l10_l0yy(double x, double y)
+{
+  double L1 = Legendre10(lambda3(x,y) - lambda2(x,y)), L1x = Legendre10x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre10xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l10_l0xy(double x, double y)
+{
+  double L1 = Legendre10(lambda3(x,y) - lambda2(x,y)), L1x = Legendre10x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre10xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre0(lambda2(x,y) - lambda1(x,y)), L2x = Legendre0x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre0xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l1xx(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l1yy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l1xy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l2xx(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l2yy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l2xy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l1xx(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l1yy(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l1xy(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l3xx(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l3yy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l3xy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l1xx(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l1yy(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l1xy(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l4xx(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l4yy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l4xy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l1xx(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l1yy(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l1xy(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l5xx(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre5xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l5yy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre5xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l5xy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre5xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l5_l1xx(double x, double y)
+{
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre5xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l5_l1yy(double x, double y)
+{
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre5xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l5_l1xy(double x, double y)
+{
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre5xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l6xx(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre6xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l6yy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre6xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l6xy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre6xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l6_l1xx(double x, double y)
+{
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre6xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l6_l1yy(double x, double y)
+{
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre6xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l6_l1xy(double x, double y)
+{
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre6xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l7xx(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2x = Legendre7x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre7xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l7yy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2x = Legendre7x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre7xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l7xy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2x = Legendre7x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre7xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l7_l1xx(double x, double y)
+{
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1x = Legendre7x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre7xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l7_l1yy(double x, double y)
+{
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1x = Legendre7x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre7xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l7_l1xy(double x, double y)
+{
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1x = Legendre7x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre7xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l8xx(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre8(lambda2(x,y) - lambda1(x,y)), L2x = Legendre8x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre8xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l8yy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre8(lambda2(x,y) - lambda1(x,y)), L2x = Legendre8x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre8xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l8xy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre8(lambda2(x,y) - lambda1(x,y)), L2x = Legendre8x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre8xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l8_l1xx(double x, double y)
+{
+  double L1 = Legendre8(lambda3(x,y) - lambda2(x,y)), L1x = Legendre8x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre8xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l8_l1yy(double x, double y)
+{
+  double L1 = Legendre8(lambda3(x,y) - lambda2(x,y)), L1x = Legendre8x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre8xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l8_l1xy(double x, double y)
+{
+  double L1 = Legendre8(lambda3(x,y) - lambda2(x,y)), L1x = Legendre8x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre8xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l9xx(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre9(lambda2(x,y) - lambda1(x,y)), L2x = Legendre9x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre9xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l9yy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre9(lambda2(x,y) - lambda1(x,y)), L2x = Legendre9x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre9xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l1_l9xy(double x, double y)
+{
+  double L1 = Legendre1(lambda3(x,y) - lambda2(x,y)), L1x = Legendre1x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre1xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre9(lambda2(x,y) - lambda1(x,y)), L2x = Legendre9x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre9xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l9_l1xx(double x, double y)
+{
+  double L1 = Legendre9(lambda3(x,y) - lambda2(x,y)), L1x = Legendre9x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre9xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l9_l1yy(double x, double y)
+{
+  double L1 = Legendre9(lambda3(x,y) - lambda2(x,y)), L1x = Legendre9x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre9xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l9_l1xy(double x, double y)
+{
+  double L1 = Legendre9(lambda3(x,y) - lambda2(x,y)), L1x = Legendre9x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre9xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre1(lambda2(x,y) - lambda1(x,y)), L2x = Legendre1x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre1xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l2xx(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l2yy(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l2xy(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l3xx(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l3yy(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l3xy(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l2xx(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l2yy(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l2xy(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l4xx(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l4yy(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l4xy(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l2xx(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l2yy(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l2xy(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l5xx(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre5xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l5yy(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre5xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l5xy(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre5xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l5_l2xx(double x, double y)
+{
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre5xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l5_l2yy(double x, double y)
+{
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre5xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l5_l2xy(double x, double y)
+{
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre5xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l6xx(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre6xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l6yy(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre6xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l6xy(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre6xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l6_l2xx(double x, double y)
+{
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre6xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l6_l2yy(double x, double y)
+{
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre6xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l6_l2xy(double x, double y)
+{
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre6xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l7xx(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2x = Legendre7x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre7xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l7yy(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2x = Legendre7x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre7xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l7xy(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2x = Legendre7x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre7xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l7_l2xx(double x, double y)
+{
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1x = Legendre7x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre7xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l7_l2yy(double x, double y)
+{
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1x = Legendre7x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre7xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l7_l2xy(double x, double y)
+{
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1x = Legendre7x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre7xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l8xx(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre8(lambda2(x,y) - lambda1(x,y)), L2x = Legendre8x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre8xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l8yy(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre8(lambda2(x,y) - lambda1(x,y)), L2x = Legendre8x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre8xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l2_l8xy(double x, double y)
+{
+  double L1 = Legendre2(lambda3(x,y) - lambda2(x,y)), L1x = Legendre2x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre2xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre8(lambda2(x,y) - lambda1(x,y)), L2x = Legendre8x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre8xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l8_l2xx(double x, double y)
+{
+  double L1 = Legendre8(lambda3(x,y) - lambda2(x,y)), L1x = Legendre8x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre8xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l8_l2yy(double x, double y)
+{
+  double L1 = Legendre8(lambda3(x,y) - lambda2(x,y)), L1x = Legendre8x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre8xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l8_l2xy(double x, double y)
+{
+  double L1 = Legendre8(lambda3(x,y) - lambda2(x,y)), L1x = Legendre8x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre8xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre2(lambda2(x,y) - lambda1(x,y)), L2x = Legendre2x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre2xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l3xx(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l3yy(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l3xy(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l4xx(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l4yy(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l4xy(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l3xx(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l3yy(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l3xy(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l5xx(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre5xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l5yy(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre5xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l5xy(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre5xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l5_l3xx(double x, double y)
+{
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre5xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l5_l3yy(double x, double y)
+{
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre5xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l5_l3xy(double x, double y)
+{
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre5xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l6xx(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre6xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l6yy(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre6xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l6xy(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre6xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l6_l3xx(double x, double y)
+{
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre6xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l6_l3yy(double x, double y)
+{
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre6xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l6_l3xy(double x, double y)
+{
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre6xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l7xx(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2x = Legendre7x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre7xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l7yy(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2x = Legendre7x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre7xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l3_l7xy(double x, double y)
+{
+  double L1 = Legendre3(lambda3(x,y) - lambda2(x,y)), L1x = Legendre3x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre3xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre7(lambda2(x,y) - lambda1(x,y)), L2x = Legendre7x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre7xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l7_l3xx(double x, double y)
+{
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1x = Legendre7x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre7xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l7_l3yy(double x, double y)
+{
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1x = Legendre7x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre7xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l7_l3xy(double x, double y)
+{
+  double L1 = Legendre7(lambda3(x,y) - lambda2(x,y)), L1x = Legendre7x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre7xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre3(lambda2(x,y) - lambda1(x,y)), L2x = Legendre3x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre3xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l4xx(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l4yy(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l4xy(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l5xx(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre5xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l5yy(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre5xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l5xy(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre5xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l5_l4xx(double x, double y)
+{
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre5xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l5_l4yy(double x, double y)
+{
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre5xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l5_l4xy(double x, double y)
+{
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre5xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l6xx(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre6xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l6yy(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre6xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l4_l6xy(double x, double y)
+{
+  double L1 = Legendre4(lambda3(x,y) - lambda2(x,y)), L1x = Legendre4x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre4xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre6(lambda2(x,y) - lambda1(x,y)), L2x = Legendre6x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre6xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l6_l4xx(double x, double y)
+{
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre6xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l6_l4yy(double x, double y)
+{
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre6xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l6_l4xy(double x, double y)
+{
+  double L1 = Legendre6(lambda3(x,y) - lambda2(x,y)), L1x = Legendre6x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre6xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre4(lambda2(x,y) - lambda1(x,y)), L2x = Legendre4x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre4xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l5_l5xx(double x, double y)
+{
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre5xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre5xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3x(x,y) - lambda2x(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2x(x,y) - lambda1x(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l5_l5yy(double x, double y)
+{
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre5xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre5xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3y(x,y) - lambda2y(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2y(x,y) - lambda1y(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
+static double leg_tri_l5_l5xy(double x, double y)
+{
+  double L1 = Legendre5(lambda3(x,y) - lambda2(x,y)), L1x = Legendre5x(lambda3(x,y) - lambda2(x,y)), L1xx = Legendre5xx(lambda3(x,y) - lambda2(x,y));
+  double L2 = Legendre5(lambda2(x,y) - lambda1(x,y)), L2x = Legendre5x(lambda2(x,y) - lambda1(x,y)), L2xx = Legendre5xx(lambda2(x,y) - lambda1(x,y));
+  double s1 = lambda3x(x,y) - lambda2x(x,y), s2 = lambda3y(x,y) - lambda2y(x,y);
+  double t1 = lambda2x(x,y) - lambda1x(x,y), t2 = lambda2y(x,y) - lambda1y(x,y);
+  return L1xx * s1 * s2 * L2 + L1x * L2x * (s1 * t2 + s2 * t1) + L1 * L2xx * t1 * t2;
+}
+
 static Shapeset::shape_fn_t leg_tri_fn[] =
 {
   leg_tri_l0_l0,   leg_tri_l0_l1,   leg_tri_l1_l0,   leg_tri_l0_l2,   leg_tri_l2_l0,
@@ -5459,9 +7109,63 @@ static Shapeset::shape_fn_t leg_tri_fn_dy[] =
   leg_tri_l4_l4y,   leg_tri_l4_l5y,   leg_tri_l5_l4y,   leg_tri_l4_l6y,   leg_tri_l6_l4y,
   leg_tri_l5_l5y,
 };
+static Shapeset::shape_fn_t leg_tri_fn_dxx[] =
+{
+  leg_tri_l0_l0xx,   leg_tri_l0_l1xx,   leg_tri_l1_l0xx,   leg_tri_l0_l2xx,   leg_tri_l2_l0xx,
+  leg_tri_l0_l3xx,   leg_tri_l3_l0xx,   leg_tri_l0_l4xx,   leg_tri_l4_l0xx,   leg_tri_l0_l5xx,
+  leg_tri_l5_l0xx,   leg_tri_l0_l6xx,   leg_tri_l6_l0xx,   leg_tri_l0_l7xx,   leg_tri_l7_l0xx,
+  leg_tri_l0_l8xx,   leg_tri_l8_l0xx,   leg_tri_l0_l9xx,   leg_tri_l9_l0xx,   leg_tri_l0_l10xx,
+  leg_tri_l10_l0xx,   leg_tri_l1_l1xx,   leg_tri_l1_l2xx,   leg_tri_l2_l1xx,   leg_tri_l1_l3xx,
+  leg_tri_l3_l1xx,   leg_tri_l1_l4xx,   leg_tri_l4_l1xx,   leg_tri_l1_l5xx,   leg_tri_l5_l1xx,
+  leg_tri_l1_l6xx,   leg_tri_l6_l1xx,   leg_tri_l1_l7xx,   leg_tri_l7_l1xx,   leg_tri_l1_l8xx,
+  leg_tri_l8_l1xx,   leg_tri_l1_l9xx,   leg_tri_l9_l1xx,   leg_tri_l2_l2xx,   leg_tri_l2_l3xx,
+  leg_tri_l3_l2xx,   leg_tri_l2_l4xx,   leg_tri_l4_l2xx,   leg_tri_l2_l5xx,   leg_tri_l5_l2xx,
+  leg_tri_l2_l6xx,   leg_tri_l6_l2xx,   leg_tri_l2_l7xx,   leg_tri_l7_l2xx,   leg_tri_l2_l8xx,
+  leg_tri_l8_l2xx,   leg_tri_l3_l3xx,   leg_tri_l3_l4xx,   leg_tri_l4_l3xx,   leg_tri_l3_l5xx,
+  leg_tri_l5_l3xx,   leg_tri_l3_l6xx,   leg_tri_l6_l3xx,   leg_tri_l3_l7xx,   leg_tri_l7_l3xx,
+  leg_tri_l4_l4xx,   leg_tri_l4_l5xx,   leg_tri_l5_l4xx,   leg_tri_l4_l6xx,   leg_tri_l6_l4xx,
+  leg_tri_l5_l5xx,
+};
+static Shapeset::shape_fn_t leg_tri_fn_dyy[] =
+{
+  leg_tri_l0_l0yy,   leg_tri_l0_l1yy,   leg_tri_l1_l0yy,   leg_tri_l0_l2yy,   leg_tri_l2_l0yy,
+  leg_tri_l0_l3yy,   leg_tri_l3_l0yy,   leg_tri_l0_l4yy,   leg_tri_l4_l0yy,   leg_tri_l0_l5yy,
+  leg_tri_l5_l0yy,   leg_tri_l0_l6yy,   leg_tri_l6_l0yy,   leg_tri_l0_l7yy,   leg_tri_l7_l0yy,
+  leg_tri_l0_l8yy,   leg_tri_l8_l0yy,   leg_tri_l0_l9yy,   leg_tri_l9_l0yy,   leg_tri_l0_l10yy,
+  leg_tri_l10_l0yy,   leg_tri_l1_l1yy,   leg_tri_l1_l2yy,   leg_tri_l2_l1yy,   leg_tri_l1_l3yy,
+  leg_tri_l3_l1yy,   leg_tri_l1_l4yy,   leg_tri_l4_l1yy,   leg_tri_l1_l5yy,   leg_tri_l5_l1yy,
+  leg_tri_l1_l6yy,   leg_tri_l6_l1yy,   leg_tri_l1_l7yy,   leg_tri_l7_l1yy,   leg_tri_l1_l8yy,
+  leg_tri_l8_l1yy,   leg_tri_l1_l9yy,   leg_tri_l9_l1yy,   leg_tri_l2_l2yy,   leg_tri_l2_l3yy,
+  leg_tri_l3_l2yy,   leg_tri_l2_l4yy,   leg_tri_l4_l2yy,   leg_tri_l2_l5yy,   leg_tri_l5_l2yy,
+  leg_tri_l2_l6yy,   leg_tri_l6_l2yy,   leg_tri_l2_l7yy,   leg_tri_l7_l2yy,   leg_tri_l2_l8yy,
+  leg_tri_l8_l2yy,   leg_tri_l3_l3yy,   leg_tri_l3_l4yy,   leg_tri_l4_l3yy,   leg_tri_l3_l5yy,
+  leg_tri_l5_l3yy,   leg_tri_l3_l6yy,   leg_tri_l6_l3yy,   leg_tri_l3_l7yy,   leg_tri_l7_l3yy,
+  leg_tri_l4_l4yy,   leg_tri_l4_l5yy,   leg_tri_l5_l4yy,   leg_tri_l4_l6yy,   leg_tri_l6_l4yy,
+  leg_tri_l5_l5yy,
+};
+static Shapeset::shape_fn_t leg_tri_fn_dxy[] =
+{
+  leg_tri_l0_l0xy,   leg_tri_l0_l1xy,   leg_tri_l1_l0xy,   leg_tri_l0_l2xy,   leg_tri_l2_l0xy,
+  leg_tri_l0_l3xy,   leg_tri_l3_l0xy,   leg_tri_l0_l4xy,   leg_tri_l4_l0xy,   leg_tri_l0_l5xy,
+  leg_tri_l5_l0xy,   leg_tri_l0_l6xy,   leg_tri_l6_l0xy,   leg_tri_l0_l7xy,   leg_tri_l7_l0xy,
+  leg_tri_l0_l8xy,   leg_tri_l8_l0xy,   leg_tri_l0_l9xy,   leg_tri_l9_l0xy,   leg_tri_l0_l10xy,
+  leg_tri_l10_l0xy,   leg_tri_l1_l1xy,   leg_tri_l1_l2xy,   leg_tri_l2_l1xy,   leg_tri_l1_l3xy,
+  leg_tri_l3_l1xy,   leg_tri_l1_l4xy,   leg_tri_l4_l1xy,   leg_tri_l1_l5xy,   leg_tri_l5_l1xy,
+  leg_tri_l1_l6xy,   leg_tri_l6_l1xy,   leg_tri_l1_l7xy,   leg_tri_l7_l1xy,   leg_tri_l1_l8xy,
+  leg_tri_l8_l1xy,   leg_tri_l1_l9xy,   leg_tri_l9_l1xy,   leg_tri_l2_l2xy,   leg_tri_l2_l3xy,
+  leg_tri_l3_l2xy,   leg_tri_l2_l4xy,   leg_tri_l4_l2xy,   leg_tri_l2_l5xy,   leg_tri_l5_l2xy,
+  leg_tri_l2_l6xy,   leg_tri_l6_l2xy,   leg_tri_l2_l7xy,   leg_tri_l7_l2xy,   leg_tri_l2_l8xy,
+  leg_tri_l8_l2xy,   leg_tri_l3_l3xy,   leg_tri_l3_l4xy,   leg_tri_l4_l3xy,   leg_tri_l3_l5xy,
+  leg_tri_l5_l3xy,   leg_tri_l3_l6xy,   leg_tri_l6_l3xy,   leg_tri_l3_l7xy,   leg_tri_l7_l3xy,
+  leg_tri_l4_l4xy,   leg_tri_l4_l5xy,   leg_tri_l5_l4xy,   leg_tri_l4_l6xy,   leg_tri_l6_l4xy,
+  leg_tri_l5_l5xy,
+};
 Shapeset::shape_fn_t* leg_tri_shape_fn_table[1]     = { leg_tri_fn };
 Shapeset::shape_fn_t* leg_tri_shape_fn_table_dx[1]  = { leg_tri_fn_dx };
 Shapeset::shape_fn_t* leg_tri_shape_fn_table_dy[1]  = { leg_tri_fn_dy };
+Shapeset::shape_fn_t* leg_tri_shape_fn_table_dxx[1] = { leg_tri_fn_dxx };
+Shapeset::shape_fn_t* leg_tri_shape_fn_table_dyy[1] = { leg_tri_fn_dyy };
+Shapeset::shape_fn_t* leg_tri_shape_fn_table_dxy[1] = { leg_tri_fn_dxy };
 
 static int qb_0[] = { 0, };
 static int qb_1[] = { 0, 1, 2, };
@@ -5528,19 +7232,19 @@ static Shapeset::shape_fn_t** leg_shape_fn_table_dy[2] =
 
 static Shapeset::shape_fn_t** leg_shape_fn_table_dxx[2] =
 {
-  NULL,
+  leg_tri_shape_fn_table_dxx,
   leg_quad_shape_fn_table_dxx
 };
 
 static Shapeset::shape_fn_t** leg_shape_fn_table_dyy[2] =
 {
-  NULL,
+  leg_tri_shape_fn_table_dyy,
   leg_quad_shape_fn_table_dyy
 };
 
 static Shapeset::shape_fn_t** leg_shape_fn_table_dxy[2] =
 {
-  NULL,
+  leg_tri_shape_fn_table_dxy,
   leg_quad_shape_fn_table_dxy
 };
 
@@ -5613,8 +7317,8 @@ L2ShapesetLegendre::L2ShapesetLegendre()
   max_order = 10;
   num_components = 1;
 
-  max_index[0] = 66;
-  max_index[1] = 121;
+  max_index[0] = 65;
+  max_index[1] = 120;
 
   ebias = 2;
 
@@ -32,6 +32,8 @@ Space::Space(Mesh* mesh, Shapeset* shapeset, EssentialBCs* essential_bcs, Ord2 p
   this->seq = 0;
   this->was_assigned = false;
   this->ndof = 0;
+  this->proj_mat = NULL;
+  this->chol_p = NULL;
 
   if(essential_bcs != NULL)
     for(std::vector<EssentialBoundaryCondition*>::const_iterator it = essential_bcs->begin(); it != essential_bcs->end(); it++)
@@ -589,6 +591,15 @@ void Space::get_boundary_assembly_list(Element* e, int surf_num, AsmList* al)
 }
 
 
+void Space::get_element_bubble_list(Element* e, AsmList* al)
+{
+  _F_
+  al->clear();
+  shapeset->set_mode(e->get_mode());
+  get_bubble_assembly_list(e, al);
+}
+
+
 void Space::get_bubble_assembly_list(Element* e, AsmList* al)
 {
   _F_
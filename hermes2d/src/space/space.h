@@ -171,6 +171,9 @@ public:
   /// Obtains an edge assembly list (contains shape functions that are nonzero on the specified edge).
   void get_boundary_assembly_list(Element* e, int surf_num, AsmList* al);
 
+  /// Obtains an assembly list of the bubble functions of the element only (used by static condensation).
+  void get_element_bubble_list(Element* e, AsmList* al);
+
   /// Updates essential BC values. Typically used for time-dependent
   /// essnetial boundary conditions.
   void update_essential_bc_values();
@@ -268,8 +271,8 @@ protected: //debugging support
   virtual void get_boundary_assembly_list_internal(Element* e, int surf_num, AsmList* al) = 0;
   virtual void get_bubble_assembly_list(Element* e, AsmList* al);
 
-  double** proj_mat;
-  double*  chol_p;
+  double** proj_mat; ///< Cholesky factor of the edge projection matrix of this space's shapeset.
+  double*  chol_p;   ///< Diagonal of the Cholesky factor.
 
   void copy_callbacks(const Space* space);
   void precalculate_projection_matrix(int nv, double**& mat, double*& p);
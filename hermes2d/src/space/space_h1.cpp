@@ -20,10 +20,6 @@
 #include "../../../hermes_common/matrix.h"
 #include "../boundaryconditions/essential_bcs.h"
 
-double** H1Space::h1_proj_mat = NULL;
-double*  H1Space::h1_chol_p   = NULL;
-int      H1Space::h1_proj_ref = 0;
-
 void H1Space::init(Shapeset* shapeset, Ord2 p_init)
 {
   if (shapeset == NULL)
@@ -32,11 +28,7 @@ void H1Space::init(Shapeset* shapeset, Ord2 p_init)
     own_shapeset = true;
   }
 
-  if (!h1_proj_ref++)
-    // FIXME: separate projection matrices for different shapesets
-    precalculate_projection_matrix(2, h1_proj_mat, h1_chol_p);
-  proj_mat = h1_proj_mat;
-  chol_p   = h1_chol_p;
+  precalculate_projection_matrix(2, proj_mat, chol_p);
 
   // set uniform poly order in elements
   if (p_init.order_h < 1 || p_init.order_v < 1) error("P_INIT must be >=  1 in an H1 space.");
@@ -63,11 +55,8 @@ H1Space::H1Space(Mesh* mesh, int p_init, Shapeset* shapeset)
 H1Space::~H1Space()
 {
   _F_
-  if (!--h1_proj_ref)
-  {
-    delete [] h1_proj_mat;
-    delete [] h1_chol_p;
-  }
+  delete [] proj_mat;
+  delete [] chol_p;
   if (own_shapeset)
     delete this->shapeset;
 }
@@ -20,10 +20,6 @@
 #include "../shapeset/shapeset_hc_all.h"
 #include "../boundaryconditions/essential_bcs.h"
 
-double** HcurlSpace::hcurl_proj_mat = NULL;
-double*  HcurlSpace::hcurl_chol_p   = NULL;
-int      HcurlSpace::hcurl_proj_ref = 0;
-
 void HcurlSpace::init(Shapeset* shapeset, Ord2 p_init)
 {
   if (shapeset == NULL)
@@ -33,13 +29,7 @@ void HcurlSpace::init(Shapeset* shapeset, Ord2 p_init)
   }
   if (this->shapeset->get_num_components() < 2) error("HcurlSpace requires a vector shapeset.");
 
-  if (!hcurl_proj_ref++)
-  {
-    precalculate_projection_matrix(0, hcurl_proj_mat, hcurl_chol_p);
-  }
-
-  proj_mat = hcurl_proj_mat;
-  chol_p   = hcurl_chol_p;
+  precalculate_projection_matrix(0, proj_mat, chol_p);
 
   // set uniform poly order in elements
   if (p_init.order_h < 0 || p_init.order_v < 0) error("P_INIT must be >= 0 in an Hcurl space.");
@@ -65,11 +55,8 @@ HcurlSpace::HcurlSpace(Mesh* mesh, int p_init, Shapeset* shapeset)
 
 HcurlSpace::~HcurlSpace()
 {
-  if (!--hcurl_proj_ref)
-  {
-    delete [] hcurl_proj_mat;
-    delete [] hcurl_chol_p;
-  }
+  delete [] proj_mat;
+  delete [] chol_p;
   if (own_shapeset)
     delete this->shapeset;
 }
@@ -20,10 +20,6 @@
 #include "../shapeset/shapeset_hd_all.h"
 #include "../boundaryconditions/essential_bcs.h"
 
-double** HdivSpace::hdiv_proj_mat = NULL;
-double*  HdivSpace::hdiv_chol_p   = NULL;
-int      HdivSpace::hdiv_proj_ref = 0;
-
 void HdivSpace::init(Shapeset* shapeset, Ord2 p_init)
 {
   if (shapeset == NULL)
@@ -33,13 +29,7 @@ void HdivSpace::init(Shapeset* shapeset, Ord2 p_init)
   }
   if (this->shapeset->get_num_components() < 2) error("HdivSpace requires a vector shapeset.");
 
-  if (!hdiv_proj_ref++)
-  {
-    precalculate_projection_matrix(0, hdiv_proj_mat, hdiv_chol_p);
-  }
-
-  proj_mat = hdiv_proj_mat;
-  chol_p   = hdiv_chol_p;
+  precalculate_projection_matrix(0, proj_mat, chol_p);
 
   // set uniform poly order in elements
   if (p_init.order_h < 0 || p_init.order_v < 0) error("P_INIT must be >= 0 in an Hdiv space.");
@@ -65,11 +55,8 @@ HdivSpace::HdivSpace(Mesh* mesh, int p_init, Shapeset* shapeset)
 
 HdivSpace::~HdivSpace()
 {
-  if (!--hdiv_proj_ref)
-  {
-    delete [] hdiv_proj_mat;
-    delete [] hdiv_chol_p;
-  }
+  delete [] proj_mat;
+  delete [] chol_p;
   if (own_shapeset)
     delete this->shapeset;
 }
@@ -53,10 +53,6 @@ protected:
   virtual void get_boundary_assembly_list_internal(Element* e, int surf_num, AsmList* al);
   virtual void get_bubble_assembly_list(Element* e, AsmList* al);
 
-  static double** hdiv_proj_mat;
-  static double*  hdiv_chol_p;
-  static int      hdiv_proj_ref;
-
   virtual scalar* get_bc_projection(SurfPos* surf_pos, int order);
 
   struct EdgeInfo
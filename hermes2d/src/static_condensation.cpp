@@ -0,0 +1,400 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "h2d_common.h"
+#include "static_condensation.h"
+#include "mesh/mesh.h"
+
+// ElementSystem ///////
+
+class ElementSystem::CollectingMatrix : public SparseMatrix
+{
+public:
+  CollectingMatrix(ElementSystem* sys) : SparseMatrix(0), sys(sys) { }
+
+  virtual void alloc() { }
+  virtual void free() { }
+  virtual scalar get(unsigned int m, unsigned int n) { error("ElementSystem::CollectingMatrix::get() not implemented."); return 0; }
+  virtual void zero() { }
+  virtual void add_to_diagonal(scalar v) { error("ElementSystem::CollectingMatrix::add_to_diagonal() not implemented."); }
+  virtual bool dump(FILE *file, const char *var_name, EMatrixDumpFormat fmt = DF_MATLAB_SPARSE) { return false; }
+  virtual unsigned int get_matrix_size() const { return 0; }
+  virtual double get_fill_in() const { return 0; }
+
+  virtual void add(unsigned int m, unsigned int n, scalar v) { sys->add((int) m, (int) n, v); }
+
+  virtual void add(unsigned int m, unsigned int n, scalar **mat, int *rows, int *cols)
+  {
+    for (unsigned int i = 0; i < m; i++)
+      for (unsigned int j = 0; j < n; j++)
+        sys->add(rows[i], cols[j], mat[i][j]);
+  }
+
+protected:
+  ElementSystem* sys;
+};
+
+class ElementSystem::CollectingVector : public Vector
+{
+public:
+  CollectingVector(ElementSystem* sys) : sys(sys) { }
+
+  virtual void alloc(unsigned int ndofs) { }
+  virtual void free() { }
+  virtual scalar get(unsigned int idx) { error("ElementSystem::CollectingVector::get() not implemented."); return 0; }
+  virtual void extract(scalar *v) const { error("ElementSystem::CollectingVector::extract() not implemented."); }
+  virtual void zero() { }
+  virtual void change_sign() { error("ElementSystem::CollectingVector::change_sign() not implemented."); }
+  virtual void set(unsigned int idx, scalar y) { error("ElementSystem::CollectingVector::set() not implemented."); }
+  virtual void add_vector(Vector* vec) { error("ElementSystem::CollectingVector::add_vector() not implemented."); }
+  virtual void add_vector(scalar* vec) { error("ElementSystem::CollectingVector::add_vector() not implemented."); }
+  virtual bool dump(FILE *file, const char *var_name, EMatrixDumpFormat fmt = DF_MATLAB_SPARSE) { return false; }
+
+  virtual void add(unsigned int idx, scalar y) { sys->add((int) idx, y); }
+
+  virtual void add(unsigned int n, unsigned int *idx, scalar *y)
+  {
+    for (unsigned int i = 0; i < n; i++)
+      sys->add((int) idx[i], y[i]);
+  }
+
+protected:
+  ElementSystem* sys;
+};
+
+ElementSystem::ElementSystem()
+{
+  _F_
+  n = 0;
+  A = f = NULL;
+  local = NULL;
+  local_size = allocated = 0;
+  matrix = new CollectingMatrix(this);
+  vector = new CollectingVector(this);
+}
+
+ElementSystem::~ElementSystem()
+{
+  _F_
+  delete matrix;
+  delete vector;
+  delete [] local;
+  delete [] A;
+  delete [] f;
+}
+
+void ElementSystem::begin(Hermes::vector<AsmList *>& al, int ndof)
+{
+  _F_
+  if (ndof > local_size) {
+    delete [] local;
+    local = new int[ndof];
+    MEM_CHECK(local);
+    for (int i = 0; i < ndof; i++) local[i] = -1;
+    local_size = ndof;
+    dofs.clear();
+  }
+  for (unsigned int k = 0; k < dofs.size(); k++)
+    local[dofs[k]] = -1;
+  dofs.clear();
+
+  // Constrained functions at hanging nodes contribute to several DOFs, and one DOF
+  // can appear several times in the assembly lists.
+  for (unsigned int i = 0; i < al.size(); i++)
+    for (unsigned int k = 0; k < al[i]->cnt; k++) {
+      int dof = al[i]->dof[k];
+      if (dof >= 0 && local[dof] < 0) {
+        local[dof] = dofs.size();
+        dofs.push_back(dof);
+      }
+    }
+  n = dofs.size();
+
+  if (n > allocated) {
+    delete [] A;
+    delete [] f;
+    A = new scalar[n * n];
+    MEM_CHECK(A);
+    f = new scalar[n];
+    MEM_CHECK(f);
+    allocated = n;
+  }
+  memset(A, 0, sizeof(scalar) * n * n);
+  memset(f, 0, sizeof(scalar) * n);
+}
+
+// StaticCondensation ///////
+
+// LU factorization with partial pivoting of the dense n x n matrix a (row-major),
+// returns false for a singular matrix.
+static bool dense_lu(scalar *a, int n, int *piv)
+{
+  for (int k = 0; k < n; k++) {
+    int p = k;
+    for (int i = k + 1; i < n; i++)
+      if (std::abs(a[i * n + k]) > std::abs(a[p * n + k])) p = i;
+    piv[k] = p;
+    if (a[p * n + k] == 0.0) return false;
+    if (p != k)
+      for (int j = 0; j < n; j++) std::swap(a[k * n + j], a[p * n + j]);
+    for (int i = k + 1; i < n; i++) {
+      a[i * n + k] /= a[k * n + k];
+      for (int j = k + 1; j < n; j++)
+        a[i * n + j] -= a[i * n + k] * a[k * n + j];
+    }
+  }
+  return true;
+}
+
+// Solves LU x = P b in place.
+static void dense_lu_solve(scalar *lu, int n, int *piv, scalar *x)
+{
+  for (int k = 0; k < n; k++)
+    if (piv[k] != k) std::swap(x[k], x[piv[k]]);
+  for (int i = 1; i < n; i++)
+    for (int j = 0; j < i; j++)
+      x[i] -= lu[i * n + j] * x[j];
+  for (int i = n - 1; i >= 0; i--) {
+    for (int j = i + 1; j < n; j++)
+      x[i] -= lu[i * n + j] * x[j];
+    x[i] /= lu[i * n + i];
+  }
+}
+
+StaticCondensation::StaticCondensation()
+{
+  _F_
+  ndof = num_skeleton_dofs = 0;
+  skeleton_index = NULL;
+}
+
+StaticCondensation::~StaticCondensation()
+{
+  _F_
+  free_factors();
+  delete [] skeleton_index;
+}
+
+void StaticCondensation::free_factors()
+{
+  _F_
+  for (unsigned int i = 0; i < factors.size(); i++) {
+    Factors* fac = factors[i];
+    if (fac == NULL) continue;
+    delete [] fac->dofs;
+    delete [] fac->piv;
+    delete [] fac->lu;
+    delete [] fac->x;
+    delete [] fac->a_sb;
+    delete [] fac->y;
+    delete fac;
+  }
+  factors.clear();
+}
+
+void StaticCondensation::update(Hermes::vector<Space *> spaces)
+{
+  _F_
+  bool changed = (sp_seq.size() != spaces.size());
+  for (unsigned int i = 0; i < spaces.size() && !changed; i++)
+    if (spaces[i]->get_seq() != sp_seq[i]) changed = true;
+  if (!changed) return;
+
+  free_factors();
+  delete [] skeleton_index;
+  ndof = Space::get_num_dofs(spaces);
+  skeleton_index = new int[ndof];
+  MEM_CHECK(skeleton_index);
+  memset(skeleton_index, 0, sizeof(int) * ndof);
+
+  // Mark the bubble DOFs.
+  int max_element_id = 0;
+  AsmList al;
+  for (unsigned int i = 0; i < spaces.size(); i++) {
+    Mesh* mesh = spaces[i]->get_mesh();
+    max_element_id = std::max(max_element_id, mesh->get_max_element_id());
+    Element* e;
+    for_all_active_elements(e, mesh) {
+      spaces[i]->get_element_bubble_list(e, &al);
+      for (unsigned int k = 0; k < al.cnt; k++)
+        if (al.dof[k] >= 0) skeleton_index[al.dof[k]] = -1;
+    }
+  }
+
+  num_skeleton_dofs = 0;
+  for (int i = 0; i < ndof; i++)
+    if (skeleton_index[i] == 0) skeleton_index[i] = num_skeleton_dofs++;
+  factors.resize(max_element_id, NULL);
+
+  sp_seq.resize(spaces.size());
+  for (unsigned int i = 0; i < spaces.size(); i++)
+    sp_seq[i] = spaces[i]->get_seq();
+
+  verbose("Static condensation: %d skeleton DOFs, %d bubble DOFs.", num_skeleton_dofs, ndof - num_skeleton_dofs);
+}
+
+void StaticCondensation::map_to_skeleton(AsmList* al)
+{
+  for (unsigned int k = 0; k < al->cnt; k++)
+    if (al->dof[k] >= 0) al->dof[k] = skeleton_index[al->dof[k]];
+}
+
+StaticCondensation::Factors* StaticCondensation::get_factors(int element_id, int nb, int ns)
+{
+  Factors* fac = factors[element_id];
+  if (fac != NULL && fac->nb == nb && fac->ns == ns) return fac;
+  if (fac != NULL) {
+    delete [] fac->dofs;
+    delete [] fac->piv;
+    delete [] fac->lu;
+    delete [] fac->x;
+    delete [] fac->a_sb;
+    delete [] fac->y;
+  }
+  else {
+    fac = new Factors;
+    MEM_CHECK(fac);
+  }
+  fac->nb = nb;
+  fac->ns = ns;
+  fac->dofs = new int[nb + ns];
+  fac->piv = new int[nb];
+  fac->lu = new scalar[nb * nb];
+  fac->x = new scalar[ns * nb];
+  fac->a_sb = new scalar[ns * nb];
+  fac->y = new scalar[nb];
+  MEM_CHECK(fac->y);
+  memset(fac->y, 0, sizeof(scalar) * nb);
+  factors[element_id] = fac;
+  return fac;
+}
+
+void StaticCondensation::condense(int element_id, ElementSystem* sys, SparseMatrix* mat, Vector* rhs)
+{
+  _F_
+  if (element_id >= (int) factors.size())
+    error("Element #%d is not in the spaces of StaticCondensation.", element_id);
+
+  // Positions of the bubble DOFs in the element system, followed by the skeleton ones.
+  int n = sys->n;
+  std::vector<int> order(n);
+  int nb = 0;
+  for (int k = 0; k < n; k++)
+    if (skeleton_index[sys->dofs[k]] < 0) order[nb++] = k;
+  int ns = 0;
+  std::vector<int> sidx(n);
+  for (int k = 0; k < n; k++)
+    if (skeleton_index[sys->dofs[k]] >= 0) {
+      order[nb + ns] = k;
+      sidx[ns++] = skeleton_index[sys->dofs[k]];
+    }
+  scalar* A = sys->A;
+  scalar* f = sys->f;
+  std::vector<scalar> g(ns);
+
+  if (nb == 0) {
+    if (mat != NULL) {
+      std::vector<scalar*> rows(ns);
+      for (int i = 0; i < ns; i++) rows[i] = A + order[i] * n;
+      // The skeleton DOFs are in the order of the element system.
+      if (ns > 0) mat->add(ns, ns, &rows[0], &sidx[0], &sidx[0]);
+    }
+    if (rhs != NULL && ns > 0)
+      rhs->add(ns, (unsigned int *) &sidx[0], f);
+    return;
+  }
+
+  Factors* fac;
+  if (mat != NULL) {
+    fac = get_factors(element_id, nb, ns);
+    for (int k = 0; k < n; k++)
+      fac->dofs[k] = sys->dofs[order[k]];
+
+    for (int i = 0; i < nb; i++)
+      for (int j = 0; j < nb; j++)
+        fac->lu[i * nb + j] = A[order[i] * n + order[j]];
+    if (!dense_lu(fac->lu, nb, fac->piv))
+      error("Singular matrix of the bubble functions of element #%d in static condensation.", element_id);
+
+    for (int j = 0; j < ns; j++) {
+      scalar* xj = fac->x + j * nb;
+      for (int k = 0; k < nb; k++)
+        xj[k] = A[order[k] * n + order[nb + j]];
+      dense_lu_solve(fac->lu, nb, fac->piv, xj);
+    }
+    for (int i = 0; i < ns; i++)
+      for (int k = 0; k < nb; k++)
+        fac->a_sb[i * nb + k] = A[order[nb + i] * n + order[k]];
+
+    // Schur complement.
+    scalar* s = new scalar[ns * ns];
+    MEM_CHECK(s);
+    std::vector<scalar*> rows(ns);
+    for (int i = 0; i < ns; i++) {
+      rows[i] = s + i * ns;
+      scalar* a_sb = fac->a_sb + i * nb;
+      for (int j = 0; j < ns; j++) {
+        scalar* xj = fac->x + j * nb;
+        scalar sum = A[order[nb + i] * n + order[nb + j]];
+        for (int k = 0; k < nb; k++)
+          sum -= a_sb[k] * xj[k];
+        rows[i][j] = sum;
+      }
+    }
+    if (ns > 0) mat->add(ns, ns, &rows[0], &sidx[0], &sidx[0]);
+    delete [] s;
+  }
+  else {
+    fac = factors[element_id];
+    if (fac == NULL || fac->nb != nb || fac->ns != ns)
+      error("The right-hand side can be assembled alone with static condensation only after the matrix.");
+  }
+
+  if (rhs != NULL) {
+    for (int k = 0; k < nb; k++)
+      fac->y[k] = f[order[k]];
+    dense_lu_solve(fac->lu, nb, fac->piv, fac->y);
+    for (int i = 0; i < ns; i++) {
+      scalar* a_sb = fac->a_sb + i * nb;
+      scalar sum = f[order[nb + i]];
+      for (int k = 0; k < nb; k++)
+        sum -= a_sb[k] * fac->y[k];
+      g[i] = sum;
+    }
+    if (ns > 0) rhs->add(ns, (unsigned int *) &sidx[0], &g[0]);
+  }
+}
+
+void StaticCondensation::back_substitute(scalar* skeleton_vec, scalar* coeff_vec)
+{
+  _F_
+  for (int i = 0; i < ndof; i++)
+    if (skeleton_index[i] >= 0) coeff_vec[i] = skeleton_vec[skeleton_index[i]];
+
+  std::vector<scalar> xs;
+  for (unsigned int e = 0; e < factors.size(); e++) {
+    Factors* fac = factors[e];
+    if (fac == NULL) continue;
+    xs.resize(fac->ns);
+    for (int j = 0; j < fac->ns; j++)
+      xs[j] = skeleton_vec[skeleton_index[fac->dofs[fac->nb + j]]];
+    for (int k = 0; k < fac->nb; k++) {
+      scalar sum = fac->y[k];
+      for (int j = 0; j < fac->ns; j++)
+        sum -= fac->x[j * fac->nb + k] * xs[j];
+      coeff_vec[fac->dofs[k]] = sum;
+    }
+  }
+}
@@ -0,0 +1,130 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __H2D_STATIC_CONDENSATION_H
+#define __H2D_STATIC_CONDENSATION_H
+
+#include "../../hermes_common/matrix.h"
+#include "space/space.h"
+
+/// Dense system of one element. During assembling of one state, it collects everything
+/// that the forms add to the global matrix and vector (indexed by the global DOFs) through
+/// the matrix and the vector returned by get_matrix() and get_vector().
+class HERMES_API ElementSystem
+{
+public:
+  ElementSystem();
+  ~ElementSystem();
+
+  /// Starts a new element with the (nonnegative) DOFs of the assembly lists.
+  void begin(Hermes::vector<AsmList *>& al, int ndof);
+
+  SparseMatrix* get_matrix() { return matrix; }
+  Vector* get_vector() { return vector; }
+
+  /// Number of DOFs of the element, the DOFs, the matrix (row-major) and the vector.
+  int n;
+  std::vector<int> dofs;
+  scalar* A;
+  scalar* f;
+
+protected:
+  class CollectingMatrix;
+  class CollectingVector;
+  SparseMatrix* matrix;   ///< A CollectingMatrix.
+  Vector* vector;         ///< A CollectingVector.
+
+  int* local;             ///< Position of every global DOF in dofs, -1 if not there.
+  int local_size;
+  int allocated;          ///< Allocated size of A is allocated * allocated.
+
+  inline void add(int row, int col, scalar v)
+  {
+    if (row >= 0 && col >= 0 && local[row] >= 0 && local[col] >= 0)
+      A[local[row] * n + local[col]] += v;
+  }
+  inline void add(int row, scalar v)
+  {
+    if (row >= 0 && local[row] >= 0) f[local[row]] += v;
+  }
+};
+
+/// Static condensation of the bubble DOFs (see DiscreteProblem::set_static_condensation()).
+///
+/// The bubble functions of an element vanish outside of it, so unless there are DG forms,
+/// the bubble DOFs b of an element are coupled only with the DOFs of the same element. The
+/// other DOFs are called skeleton DOFs s. Writing the system of the element as
+///
+///   [ A_ss A_sb ] [ x_s ]   [ f_s ]
+///   [ A_bs A_bb ] [ x_b ] = [ f_b ],
+///
+/// the element contributes the Schur complement A_ss - A_sb A_bb^-1 A_bs to the matrix and
+/// f_s - A_sb A_bb^-1 f_b to the right-hand side of the global system of the skeleton DOFs.
+/// After this system is solved, the bubble DOFs are obtained element by element as
+/// x_b = A_bb^-1 (f_b - A_bs x_s).
+///
+/// The skeleton DOFs are numbered in the order of the global DOFs. The LU factors of A_bb,
+/// A_bb^-1 A_bs, A_sb and A_bb^-1 f_b of every element are kept, so the right-hand side can
+/// be assembled alone as long as the matrix does not change.
+class HERMES_API StaticCondensation
+{
+public:
+  StaticCondensation();
+  ~StaticCondensation();
+
+  /// Numbers the skeleton DOFs if the spaces have changed since the last call.
+  void update(Hermes::vector<Space *> spaces);
+
+  /// Size of the condensed system.
+  int get_num_skeleton_dofs() const { return num_skeleton_dofs; }
+  /// Number of all DOFs of the spaces.
+  int get_num_dofs() const { return ndof; }
+
+  /// Replaces the DOFs of the assembly list by their index in the condensed system
+  /// (-1 for bubble and Dirichlet DOFs).
+  void map_to_skeleton(AsmList* al);
+
+  /// Eliminates the bubble DOFs from the system of the element and adds the result to
+  /// the condensed matrix and vector (any of them can be NULL). The element system has
+  /// to contain the matrix unless the matrix has been condensed on this element before.
+  /// Different elements can be condensed in parallel.
+  void condense(int element_id, ElementSystem* sys, SparseMatrix* mat, Vector* rhs);
+
+  /// Computes the vector of all DOFs from the solution of the condensed system.
+  void back_substitute(scalar* skeleton_vec, scalar* coeff_vec);
+
+protected:
+  /// Factors of one element, the first nb DOFs are the bubble ones.
+  struct Factors
+  {
+    int nb, ns;
+    int* dofs;
+    int* piv;
+    scalar* lu;           ///< LU factorization of A_bb, nb x nb.
+    scalar* x;            ///< (A_bb^-1 A_bs)^T, ns x nb.
+    scalar* a_sb;         ///< A_sb, ns x nb.
+    scalar* y;            ///< A_bb^-1 f_b.
+  };
+  std::vector<Factors *> factors;   ///< Indexed by element id.
+
+  int ndof, num_skeleton_dofs;
+  int* skeleton_index;
+  std::vector<int> sp_seq;
+
+  void free_factors();
+  Factors* get_factors(int element_id, int nb, int ns);
+};
+
+#endif
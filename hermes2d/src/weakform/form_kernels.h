@@ -0,0 +1,350 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __H2D_FORM_KERNELS_H
+#define __H2D_FORM_KERNELS_H
+
+#include "weakform.h"
+#include "../function/forms.h"
+
+/// Volumetric forms generated from compile-time kernels.
+///
+/// A kernel describes the integrand of a form at one integration point. It is a class with
+///
+///   static const int num_components;          // 1 (H1, L2) or 2 (Hcurl)
+///   static const bool second_derivatives;     // true if the integrand uses laplace
+///   template<typename Real, typename Scalar>
+///   Scalar operator()(int i, Func<Scalar> *u_ext[], Func<Real> *u, Func<Real> *v,
+///                     Geom<Real> *e, ExtData<Scalar> *ext) const;
+///
+/// (without u for vector forms). MatrixFormVolKernel<Kernel> and VectorFormVolKernel<Kernel>
+/// then provide value(), ord() and value_batch() with the integration loop instantiated
+/// for the kernel, so the integrand is inlined and no virtual call is made per pair of
+/// functions in the batched evaluation. The coefficients of the kernels below are template
+/// parameters as well, see ConstCoeff and RadialCoeff.
+namespace FormKernels {
+
+  /// Constant coefficient.
+  struct ConstCoeff
+  {
+    ConstCoeff(scalar c = 1.0) : c(c) { }
+#ifdef H2D_COMPLEX
+    ConstCoeff(double c) : c(c) { }
+#endif
+    scalar operator()(int i, Geom<double> *e) const { return c; }
+    Ord operator()(int i, Geom<Ord> *e) const { return Ord(0); }
+    scalar c;
+  };
+
+  /// Constant coefficient multiplied by the radial coordinate of axisymmetric problems,
+  /// e->y for HERMES_AXISYM_X and e->x for HERMES_AXISYM_Y.
+  template<int gt>
+  struct RadialCoeff
+  {
+    RadialCoeff(scalar c = 1.0) : c(c) { }
+#ifdef H2D_COMPLEX
+    RadialCoeff(double c) : c(c) { }
+#endif
+    scalar operator()(int i, Geom<double> *e) const { return c * (gt == HERMES_AXISYM_X ? e->y[i] : e->x[i]); }
+    Ord operator()(int i, Geom<Ord> *e) const { return (gt == HERMES_AXISYM_X) ? e->y[i] : e->x[i]; }
+    scalar c;
+  };
+
+  //// H1 ////
+
+  /// coeff grad u . grad v
+  template<typename Coeff = ConstCoeff>
+  struct Diffusion
+  {
+    static const int num_components = 1;
+    static const bool second_derivatives = false;
+    Diffusion(Coeff coeff = Coeff()) : coeff(coeff) { }
+
+    template<typename Real, typename Scalar>
+    Scalar operator()(int i, Func<Scalar> *u_ext[], Func<Real> *u, Func<Real> *v,
+                      Geom<Real> *e, ExtData<Scalar> *ext) const {
+      return coeff(i, e) * (u->dx[i] * v->dx[i] + u->dy[i] * v->dy[i]);
+    }
+    Coeff coeff;
+  };
+
+  /// coeff u v
+  template<typename Coeff = ConstCoeff>
+  struct Mass
+  {
+    static const int num_components = 1;
+    static const bool second_derivatives = false;
+    Mass(Coeff coeff = Coeff()) : coeff(coeff) { }
+
+    template<typename Real, typename Scalar>
+    Scalar operator()(int i, Func<Scalar> *u_ext[], Func<Real> *u, Func<Real> *v,
+                      Geom<Real> *e, ExtData<Scalar> *ext) const {
+      return coeff(i, e) * (u->val[i] * v->val[i]);
+    }
+    Coeff coeff;
+  };
+
+  /// (coeff1 du/dx + coeff2 du/dy) v
+  template<typename Coeff = ConstCoeff>
+  struct Advection
+  {
+    static const int num_components = 1;
+    static const bool second_derivatives = false;
+    Advection(Coeff coeff1 = Coeff(), Coeff coeff2 = Coeff()) : coeff1(coeff1), coeff2(coeff2) { }
+
+    template<typename Real, typename Scalar>
+    Scalar operator()(int i, Func<Scalar> *u_ext[], Func<Real> *u, Func<Real> *v,
+                      Geom<Real> *e, ExtData<Scalar> *ext) const {
+      return (coeff1(i, e) * u->dx[i] + coeff2(i, e) * u->dy[i]) * v->val[i];
+    }
+    Coeff coeff1, coeff2;
+  };
+
+  /// coeff v (vector form)
+  template<typename Coeff = ConstCoeff>
+  struct Source
+  {
+    static const int num_components = 1;
+    static const bool second_derivatives = false;
+    Source(Coeff coeff = Coeff()) : coeff(coeff) { }
+
+    template<typename Real, typename Scalar>
+    Scalar operator()(int i, Func<Scalar> *u_ext[], Func<Real> *v, Geom<Real> *e,
+                      ExtData<Scalar> *ext) const {
+      return coeff(i, e) * v->val[i];
+    }
+    Coeff coeff;
+  };
+
+  //// Hcurl ////
+
+  /// coeff curl E curl F
+  template<typename Coeff = ConstCoeff>
+  struct CurlCurl
+  {
+    static const int num_components = 2;
+    static const bool second_derivatives = false;
+    CurlCurl(Coeff coeff = Coeff()) : coeff(coeff) { }
+
+    template<typename Real, typename Scalar>
+    Scalar operator()(int i, Func<Scalar> *u_ext[], Func<Real> *u, Func<Real> *v,
+                      Geom<Real> *e, ExtData<Scalar> *ext) const {
+      return coeff(i, e) * (u->curl[i] * v->curl[i]);
+    }
+    Coeff coeff;
+  };
+
+  /// coeff E . F
+  template<typename Coeff = ConstCoeff>
+  struct VectorMass
+  {
+    static const int num_components = 2;
+    static const bool second_derivatives = false;
+    VectorMass(Coeff coeff = Coeff()) : coeff(coeff) { }
+
+    template<typename Real, typename Scalar>
+    Scalar operator()(int i, Func<Scalar> *u_ext[], Func<Real> *u, Func<Real> *v,
+                      Geom<Real> *e, ExtData<Scalar> *ext) const {
+      return coeff(i, e) * (u->val0[i] * v->val0[i] + u->val1[i] * v->val1[i]);
+    }
+    Coeff coeff;
+  };
+
+  //// linear elasticity (see weakform_library/elasticity.h) ////
+
+  /// (lambda + 2 mu) du/dx dv/dx + mu du/dy dv/dy, or the same with x and y swapped if yy.
+  template<bool yy>
+  struct ElasticityDiagonal
+  {
+    static const int num_components = 1;
+    static const bool second_derivatives = false;
+    ElasticityDiagonal(double lambda, double mu) : lambda(lambda), mu(mu) { }
+
+    template<typename Real, typename Scalar>
+    Scalar operator()(int i, Func<Scalar> *u_ext[], Func<Real> *u, Func<Real> *v,
+                      Geom<Real> *e, ExtData<Scalar> *ext) const {
+      if (yy)
+        return mu * (u->dx[i] * v->dx[i]) + (lambda + 2*mu) * (u->dy[i] * v->dy[i]);
+      return (lambda + 2*mu) * (u->dx[i] * v->dx[i]) + mu * (u->dy[i] * v->dy[i]);
+    }
+    double lambda, mu;
+  };
+
+  /// lambda du/dy dv/dx + mu du/dx dv/dy
+  struct ElasticityOffDiagonal
+  {
+    static const int num_components = 1;
+    static const bool second_derivatives = false;
+    ElasticityOffDiagonal(double lambda, double mu) : lambda(lambda), mu(mu) { }
+
+    template<typename Real, typename Scalar>
+    Scalar operator()(int i, Func<Scalar> *u_ext[], Func<Real> *u, Func<Real> *v,
+                      Geom<Real> *e, ExtData<Scalar> *ext) const {
+      return lambda * (u->dy[i] * v->dx[i]) + mu * (u->dx[i] * v->dy[i]);
+    }
+    double lambda, mu;
+  };
+}
+
+/// Matrix volume form evaluated by a kernel (see FormKernels).
+template<class Kernel>
+class MatrixFormVolKernel : public WeakForm::MatrixFormVol
+{
+public:
+  MatrixFormVolKernel(unsigned int i, unsigned int j, const Kernel& kernel,
+                      std::string area = HERMES_ANY, SymFlag sym = HERMES_NONSYM)
+    : WeakForm::MatrixFormVol(i, j, area, sym), kernel(kernel) { init(); }
+  MatrixFormVolKernel(unsigned int i, unsigned int j, const Kernel& kernel,
+                      Hermes::vector<std::string> areas, SymFlag sym = HERMES_NONSYM)
+    : WeakForm::MatrixFormVol(i, j, areas, sym), kernel(kernel) { init(); }
+
+  virtual scalar value(int n, double *wt, Func<scalar> *u_ext[], Func<double> *u, Func<double> *v,
+                       Geom<double> *e, ExtData<scalar> *ext) const {
+    return integrate<double, scalar>(n, wt, u_ext, u, v, e, ext);
+  }
+
+  virtual Ord ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *u, Func<Ord> *v,
+                  Geom<Ord> *e, ExtData<Ord> *ext) const {
+    return integrate<Ord, Ord>(n, wt, u_ext, u, v, e, ext);
+  }
+
+  virtual void value_batch(int n, double *wt, Func<scalar> *u_ext[], FuncBatch *u, FuncBatch *v,
+                           Geom<double> *e, ExtData<scalar> *ext, scalar **result) const {
+    Func<double> fu(n, Kernel::num_components), fv(n, Kernel::num_components);
+    for (int i = 0; i < v->nf; i++) {
+      v->view(i, &fv);
+      for (int j = 0; j < u->nf; j++) {
+        u->view(j, &fu);
+        result[i][j] += integrate_batch(n, wt, u_ext, &fu, &fv, e, ext);
+      }
+    }
+  }
+
+  virtual WeakForm::MatrixFormVol* clone() {
+    return new MatrixFormVolKernel(*this);
+  }
+
+  Kernel kernel;
+
+protected:
+  void init()
+  {
+#ifndef H2D_SECOND_DERIVATIVES_ENABLED
+    if (Kernel::second_derivatives)
+      error("The kernel of the form needs second derivatives, define H2D_SECOND_DERIVATIVES_ENABLED.");
+#endif
+    // FuncBatch holds only first derivatives.
+    batch_eval = !Kernel::second_derivatives;
+  }
+
+  template<typename Real, typename Scalar>
+  Scalar integrate(int n, double *wt, Func<Scalar> *u_ext[], Func<Real> *u, Func<Real> *v,
+                   Geom<Real> *e, ExtData<Scalar> *ext) const {
+    Scalar result = 0;
+    for (int i = 0; i < n; i++)
+      result += wt[i] * kernel(i, u_ext, u, v, e, ext);
+    return result;
+  }
+
+  /// The loop of value_batch(), with four partial sums to break the dependency chain
+  /// of the additions.
+  scalar integrate_batch(int n, double *wt, Func<scalar> *u_ext[], Func<double> *u, Func<double> *v,
+                         Geom<double> *e, ExtData<scalar> *ext) const {
+    scalar r0 = 0, r1 = 0, r2 = 0, r3 = 0;
+    int i = 0;
+    for (; i + 3 < n; i += 4) {
+      r0 += wt[i] * kernel(i, u_ext, u, v, e, ext);
+      r1 += wt[i+1] * kernel(i+1, u_ext, u, v, e, ext);
+      r2 += wt[i+2] * kernel(i+2, u_ext, u, v, e, ext);
+      r3 += wt[i+3] * kernel(i+3, u_ext, u, v, e, ext);
+    }
+    for (; i < n; i++)
+      r0 += wt[i] * kernel(i, u_ext, u, v, e, ext);
+    return (r0 + r1) + (r2 + r3);
+  }
+};
+
+/// Vector volume form evaluated by a kernel (see FormKernels).
+template<class Kernel>
+class VectorFormVolKernel : public WeakForm::VectorFormVol
+{
+public:
+  VectorFormVolKernel(unsigned int i, const Kernel& kernel, std::string area = HERMES_ANY)
+    : WeakForm::VectorFormVol(i, area), kernel(kernel) { init(); }
+  VectorFormVolKernel(unsigned int i, const Kernel& kernel, Hermes::vector<std::string> areas)
+    : WeakForm::VectorFormVol(i, areas), kernel(kernel) { init(); }
+
+  virtual scalar value(int n, double *wt, Func<scalar> *u_ext[], Func<double> *v,
+                       Geom<double> *e, ExtData<scalar> *ext) const {
+    return integrate<double, scalar>(n, wt, u_ext, v, e, ext);
+  }
+
+  virtual Ord ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *v, Geom<Ord> *e,
+                  ExtData<Ord> *ext) const {
+    return integrate<Ord, Ord>(n, wt, u_ext, v, e, ext);
+  }
+
+  virtual void value_batch(int n, double *wt, Func<scalar> *u_ext[], FuncBatch *v,
+                           Geom<double> *e, ExtData<scalar> *ext, scalar *result) const {
+    Func<double> fv(n, Kernel::num_components);
+    for (int i = 0; i < v->nf; i++) {
+      v->view(i, &fv);
+      result[i] += integrate_batch(n, wt, u_ext, &fv, e, ext);
+    }
+  }
+
+  virtual WeakForm::VectorFormVol* clone() {
+    return new VectorFormVolKernel(*this);
+  }
+
+  Kernel kernel;
+
+protected:
+  void init()
+  {
+#ifndef H2D_SECOND_DERIVATIVES_ENABLED
+    if (Kernel::second_derivatives)
+      error("The kernel of the form needs second derivatives, define H2D_SECOND_DERIVATIVES_ENABLED.");
+#endif
+    batch_eval = !Kernel::second_derivatives;
+  }
+
+  template<typename Real, typename Scalar>
+  Scalar integrate(int n, double *wt, Func<Scalar> *u_ext[], Func<Real> *v,
+                   Geom<Real> *e, ExtData<Scalar> *ext) const {
+    Scalar result = 0;
+    for (int i = 0; i < n; i++)
+      result += wt[i] * kernel(i, u_ext, v, e, ext);
+    return result;
+  }
+
+  /// The loop of value_batch(), see MatrixFormVolKernel::integrate_batch().
+  scalar integrate_batch(int n, double *wt, Func<scalar> *u_ext[], Func<double> *v,
+                         Geom<double> *e, ExtData<scalar> *ext) const {
+    scalar r0 = 0, r1 = 0, r2 = 0, r3 = 0;
+    int i = 0;
+    for (; i + 3 < n; i += 4) {
+      r0 += wt[i] * kernel(i, u_ext, v, e, ext);
+      r1 += wt[i+1] * kernel(i+1, u_ext, v, e, ext);
+      r2 += wt[i+2] * kernel(i+2, u_ext, v, e, ext);
+      r3 += wt[i+3] * kernel(i+3, u_ext, v, e, ext);
+    }
+    for (; i < n; i++)
+      r0 += wt[i] * kernel(i, u_ext, v, e, ext);
+    return (r0 + r1) + (r2 + r3);
+  }
+};
+
+#endif
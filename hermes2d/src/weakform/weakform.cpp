@@ -26,6 +26,9 @@ WeakForm::Form::Form(std::string area, Hermes::vector<MeshFunction *> ext, Herme
   ext(ext), param(param), scaling_factor(scaling_factor), u_ext_offset(u_ext_offset)
 {
   adapt_eval = false;
+  cache_order = true;
+  batch_eval = false;
+  cache_values = false;
   areas.push_back(area);
   stage_time = 0.0;
 }
@@ -36,6 +39,9 @@ WeakForm::Form::Form(Hermes::vector<std::string> areas, Hermes::vector<MeshFunct
   ext(ext), param(param), scaling_factor(scaling_factor), u_ext_offset(u_ext_offset)
 {
   adapt_eval = false;
+  cache_order = true;
+  batch_eval = false;
+  cache_values = false;
   this->areas = areas;
   stage_time = 0.0;
 }
@@ -64,6 +70,27 @@ Ord WeakForm::MatrixFormVol::ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord
   return Ord();
 }
 
+void WeakForm::MatrixFormVol::value_batch(int n, double *wt, Func<scalar> *u_ext[], FuncBatch *u, FuncBatch *v,
+                                          Geom<double> *e, ExtData<scalar> *ext, scalar **result) const
+{
+  error("WeakForm::MatrixFormVol::value_batch must be overridden if batch_eval is set.");
+}
+
+bool WeakForm::MatrixFormVol::ref_coeffs(double2x2& m, double jac,
+                                         scalar coeffs[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES]) const
+{
+  return false;
+}
+
+bool WeakForm::MatrixFormVol::ref_point_coeffs(int n, double *jwt, double2x2 *m, Geom<double> *e,
+                                               scalar (*coeffs)[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES]) const
+{
+  for (int k = 0; k < n; k++)
+    if (!ref_coeffs(m[k], jwt[k], coeffs[k]))
+      return false;
+  return true;
+}
+
 WeakForm::MatrixFormVol* WeakForm::MatrixFormVol::clone()
 {
   error("WeakForm::MatrixFormVol::clone() must be overridden.");
@@ -128,6 +155,26 @@ Ord WeakForm::VectorFormVol::ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord
   return Ord();
 }
 
+void WeakForm::VectorFormVol::value_batch(int n, double *wt, Func<scalar> *u_ext[], FuncBatch *v,
+                                          Geom<double> *e, ExtData<scalar> *ext, scalar *result) const
+{
+  error("WeakForm::VectorFormVol::value_batch must be overridden if batch_eval is set.");
+}
+
+bool WeakForm::VectorFormVol::ref_coeffs(double2x2& m, double jac, scalar coeffs[H2D_NUM_REF_QUANTITIES]) const
+{
+  return false;
+}
+
+bool WeakForm::VectorFormVol::ref_point_coeffs(int n, double *jwt, double2x2 *m, Geom<double> *e,
+                                               scalar (*coeffs)[H2D_NUM_REF_QUANTITIES]) const
+{
+  for (int k = 0; k < n; k++)
+    if (!ref_coeffs(m[k], jwt[k], coeffs[k]))
+      return false;
+  return true;
+}
+
 WeakForm::VectorFormVol* WeakForm::VectorFormVol::clone()
 {
   error("WeakForm::VectorFormVol::clone() must be overridden.");
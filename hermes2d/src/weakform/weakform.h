@@ -19,6 +19,7 @@
 
 #include "../function/function.h"
 #include "../function/solution.h"
+#include "../function/ref_matrices.h"
 #include "../definitions.h"
 #include <string>
 
@@ -34,6 +35,7 @@ class Shapeset;
 template<typename T> class Func;
 template<typename T> class Geom;
 template<typename T> class ExtData;
+class FuncBatch;
 
 /// \brief Represents the weak formulation of a PDE problem.
 ///
@@ -94,6 +96,18 @@ public:
     // Max. allowed relative error (stopping criterion for adaptive
     // numerical quadrature.
     double adapt_rel_error_tol;
+    // If true (default), the integration order given by ord() is cached
+    // for the orders of the functions it is evaluated with. Set it to false
+    // if ord() depends on anything else (time, parameters, the element, ...).
+    bool cache_order;
+    // If true, the (volumetric) form is evaluated for all pairs of shape
+    // functions of an element at once by value_batch(), see MatrixFormVol.
+    bool batch_eval;
+    // If true, the values of the (volumetric) form on an element may be reused in
+    // incremental assembling (see ElementMatrixCache). False by default, set it to
+    // true only if value() depends on nothing else than the element and the shape
+    // functions (not on time, parameters changed between assemblies, ...).
+    bool cache_values;
 
     /// For time-dependent right-hand side functions.
     /// E.g. for Runge-Kutta methods. Otherwise the one time for the whole WeakForm can be used.
@@ -130,6 +144,35 @@ public:
                          Geom<double> *e, ExtData<scalar> *ext) const;
     virtual Ord ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *u, Func<Ord> *v,
                     Geom<Ord> *e, ExtData<Ord> *ext) const;
+
+    /// Batched evaluation (optional, used if batch_eval is true): adds the value of the form
+    /// for the basis function u_j and the test function v_i to result[i][j], for all basis
+    /// functions u and test functions v of the element. All pairs are integrated with the
+    /// highest of their orders. The form is evaluated by value() for vector-valued shape
+    /// functions and with adaptive integration, so value() has to be provided as well.
+    virtual void value_batch(int n, double *wt, Func<scalar> *u_ext[], FuncBatch *u, FuncBatch *v,
+                             Geom<double> *e, ExtData<scalar> *ext, scalar **result) const;
+
+    /// Reference-element evaluation (optional). On elements with a constant jacobian, a form
+    /// with constant coefficients that does not depend on u_ext and ext can be written as
+    /// sum_{p,q} coeffs[p][q] R_pq, where R_pq are the reference matrices of the shape
+    /// functions (see RefMatrixCache), and is then evaluated without numerical quadrature.
+    /// Such forms add the coefficients for the inverse reference map m and the jacobian jac
+    /// of the element to coeffs (zero on entry) and return true. The default implementation
+    /// returns false.
+    virtual bool ref_coeffs(double2x2& m, double jac,
+                            scalar coeffs[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES]) const;
+
+    /// Reference-element evaluation in the quadrature points (optional), used by the sum
+    /// factorization on quads (see SumFactorization and DiscreteProblem::set_sum_factorization()):
+    /// a form that does not depend on u_ext and ext is written as the sum over the n quadrature
+    /// points x_k of sum_{p,q} coeffs[k][p][q] Q_p(u)(x_k) Q_q(v)(x_k). Such forms add the
+    /// coefficients for the jacobians times the weights jwt, the inverse reference maps m and
+    /// the geometry e in the points to coeffs (zero on entry) and return true. The default
+    /// implementation calls ref_coeffs() in every point with the jacobian jwt[k], which
+    /// requires its coefficients to be proportional to the jacobian.
+    virtual bool ref_point_coeffs(int n, double *jwt, double2x2 *m, Geom<double> *e,
+                                  scalar (*coeffs)[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES]) const;
   };
 
   class HERMES_API MatrixFormSurf : public Form
@@ -178,6 +221,21 @@ public:
                          Geom<double> *e, ExtData<scalar> *ext) const;
     virtual Ord ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *v, Geom<Ord> *e, 
                     ExtData<Ord> *ext) const;
+
+    /// Batched evaluation (optional, used if batch_eval is true): adds the value of the form
+    /// for the test function v_i to result[i], for all test functions v of the element.
+    /// See MatrixFormVol::value_batch().
+    virtual void value_batch(int n, double *wt, Func<scalar> *u_ext[], FuncBatch *v,
+                             Geom<double> *e, ExtData<scalar> *ext, scalar *result) const;
+
+    /// Reference-element evaluation (optional): the form is sum_q coeffs[q] r_q.
+    /// See MatrixFormVol::ref_coeffs().
+    virtual bool ref_coeffs(double2x2& m, double jac, scalar coeffs[H2D_NUM_REF_QUANTITIES]) const;
+
+    /// Reference-element evaluation in the quadrature points (optional): the form is the sum
+    /// over the points of sum_q coeffs[k][q] Q_q(v)(x_k). See MatrixFormVol::ref_point_coeffs().
+    virtual bool ref_point_coeffs(int n, double *jwt, double2x2 *m, Geom<double> *e,
+                                  scalar (*coeffs)[H2D_NUM_REF_QUANTITIES]) const;
   };
 
   class HERMES_API VectorFormSurf : public Form
@@ -339,10 +397,10 @@ public:
   Hermes::vector<VectorFormSurf *> get_vfsurf() { return vfsurf; }
 
   /// Sets volumetric and surface weak forms.
-  void set_mfvol(Hermes::vector<MatrixFormVol *> mfvol) { this->mfvol = mfvol; }
-  void set_mfsurf(Hermes::vector<MatrixFormSurf *> mfvol) { this->mfsurf = mfsurf; }
-  void set_vfvol(Hermes::vector<VectorFormVol *> vfvol) { this->vfvol = vfvol; }
-  void set_vfsurf(Hermes::vector<VectorFormSurf *> vfvol) { this->vfsurf = vfsurf; }
+  void set_mfvol(Hermes::vector<MatrixFormVol *> mfvol) { this->mfvol = mfvol; seq++; }
+  void set_mfsurf(Hermes::vector<MatrixFormSurf *> mfvol) { this->mfsurf = mfsurf; seq++; }
+  void set_vfvol(Hermes::vector<VectorFormVol *> vfvol) { this->vfvol = vfvol; seq++; }
+  void set_vfsurf(Hermes::vector<VectorFormSurf *> vfvol) { this->vfsurf = vfsurf; seq++; }
 
   /// Deletes all volumetric and surface forms.
   void delete_all()
@@ -351,6 +409,7 @@ public:
     mfsurf.clear();
     vfvol.clear();
     vfsurf.clear();
+    seq++;
   };
 
   /// Internal. Used by DiscreteProblem to detect changes in the weakform.
@@ -31,10 +31,10 @@ namespace WeakFormsH1 {
     public:
       DefaultLinearDiffusion(int i, int j, std::string area = HERMES_ANY, scalar coeff = 1.0,
                              SymFlag sym = HERMES_SYM, GeomType gt = HERMES_PLANAR)
-        : WeakForm::MatrixFormVol(i, j, area, sym), coeff(coeff), gt(gt) { }
+        : WeakForm::MatrixFormVol(i, j, area, sym), coeff(coeff), gt(gt) { batch_eval = true; }
       DefaultLinearDiffusion(int i, int j, Hermes::vector<std::string> areas, scalar coeff = 1.0,
                              SymFlag sym = HERMES_SYM, GeomType gt = HERMES_PLANAR)
-        : WeakForm::MatrixFormVol(i, j, areas, sym), coeff(coeff), gt(gt) { }
+        : WeakForm::MatrixFormVol(i, j, areas, sym), coeff(coeff), gt(gt) { batch_eval = true; }
 
       virtual scalar value(int n, double *wt, Func<scalar> *u_ext[], Func<double> *u,
                            Func<double> *v, Geom<double> *e, ExtData<scalar> *ext) const {
@@ -58,6 +58,25 @@ namespace WeakFormsH1 {
         return result;
       }
 
+      virtual void value_batch(int n, double *wt, Func<scalar> *u_ext[], FuncBatch *u, FuncBatch *v,
+                               Geom<double> *e, ExtData<scalar> *ext, scalar **result) const {
+        int_grad_u_grad_v_batch(n, geom_weights(n, wt, e, gt, v->wbuf), u, v, coeff, result);
+      }
+
+      virtual bool ref_coeffs(double2x2& m, double jac,
+                              scalar coeffs[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES]) const {
+        if (gt != HERMES_PLANAR) return false;
+        ref_coeffs_grad_u_grad_v(m, jac, coeff, coeffs);
+        return true;
+      }
+
+      virtual bool ref_point_coeffs(int n, double *jwt, double2x2 *m, Geom<double> *e,
+                                    scalar (*coeffs)[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES]) const {
+        for (int k = 0; k < n; k++)
+          ref_coeffs_grad_u_grad_v(m[k], geom_weight(k, jwt, e, gt), coeff, coeffs[k]);
+        return true;
+      }
+
       // This is to make the form usable in rk_time_step().
       virtual WeakForm::MatrixFormVol* clone() {
         return new DefaultLinearDiffusion(*this);
@@ -141,10 +160,10 @@ namespace WeakFormsH1 {
     public:
       DefaultLinearMass(int i, int j, std::string area = HERMES_ANY, scalar coeff = 1.0,
                         SymFlag sym = HERMES_SYM, GeomType gt = HERMES_PLANAR)
-        : WeakForm::MatrixFormVol(i, j, area, sym), coeff(coeff), gt(gt) { }
+        : WeakForm::MatrixFormVol(i, j, area, sym), coeff(coeff), gt(gt) { batch_eval = true; }
       DefaultLinearMass(int i, int j, Hermes::vector<std::string> areas, scalar coeff = 1.0,
                         SymFlag sym = HERMES_SYM, GeomType gt = HERMES_PLANAR)
-        : WeakForm::MatrixFormVol(i, j, areas, sym), coeff(coeff), gt(gt) { }
+        : WeakForm::MatrixFormVol(i, j, areas, sym), coeff(coeff), gt(gt) { batch_eval = true; }
 
       virtual scalar value(int n, double *wt, Func<scalar> *u_ext[], Func<double> *u,
                    Func<double> *v, Geom<double> *e, ExtData<scalar> *ext) const {
@@ -166,6 +185,25 @@ namespace WeakFormsH1 {
         return result;
       }
 
+      virtual void value_batch(int n, double *wt, Func<scalar> *u_ext[], FuncBatch *u, FuncBatch *v,
+                               Geom<double> *e, ExtData<scalar> *ext, scalar **result) const {
+        int_u_v_batch(n, geom_weights(n, wt, e, gt, v->wbuf), u, v, coeff, result);
+      }
+
+      virtual bool ref_coeffs(double2x2& m, double jac,
+                              scalar coeffs[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES]) const {
+        if (gt != HERMES_PLANAR) return false;
+        coeffs[0][0] += coeff * jac;
+        return true;
+      }
+
+      virtual bool ref_point_coeffs(int n, double *jwt, double2x2 *m, Geom<double> *e,
+                                    scalar (*coeffs)[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES]) const {
+        for (int k = 0; k < n; k++)
+          coeffs[k][0][0] += coeff * geom_weight(k, jwt, e, gt);
+        return true;
+      }
+
       // This is to make the form usable in rk_time_step().
       virtual WeakForm::MatrixFormVol* clone() {
         return new DefaultLinearMass(*this);
@@ -244,9 +282,9 @@ namespace WeakFormsH1 {
     {
     public:
       DefaultLinearAdvection(int i, int j, std::string area = HERMES_ANY, scalar coeff1 = 1.0, scalar coeff2 = 1.0, GeomType gt = HERMES_PLANAR)
-        : WeakForm::MatrixFormVol(i, j, area, HERMES_NONSYM), coeff1(coeff1), coeff2(coeff2), gt(gt) { }
+        : WeakForm::MatrixFormVol(i, j, area, HERMES_NONSYM), coeff1(coeff1), coeff2(coeff2), gt(gt) { batch_eval = true; }
       DefaultLinearAdvection(int i, int j, Hermes::vector<std::string> areas, scalar coeff1 = 1.0, scalar coeff2 = 1.0, GeomType gt = HERMES_PLANAR)
-        : WeakForm::MatrixFormVol(i, j, areas, HERMES_NONSYM), coeff1(coeff1), coeff2(coeff2), gt(gt) { }
+        : WeakForm::MatrixFormVol(i, j, areas, HERMES_NONSYM), coeff1(coeff1), coeff2(coeff2), gt(gt) { batch_eval = true; }
 
       template<typename Real, typename Scalar>
       Scalar matrix_form(int n, double *wt, Func<Scalar> *u_ext[], Func<Real> *u,
@@ -265,6 +303,17 @@ namespace WeakFormsH1 {
         return matrix_form<Ord, Ord>(n, wt, u_ext, u, v, e, ext);
       }
 
+      virtual void value_batch(int n, double *wt, Func<scalar> *u_ext[], FuncBatch *u, FuncBatch *v,
+                               Geom<double> *e, ExtData<scalar> *ext, scalar **result) const {
+        int_dudx_dudy_v_batch(n, wt, u, v, coeff1, coeff2, result);
+      }
+
+      virtual bool ref_coeffs(double2x2& m, double jac,
+                              scalar coeffs[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES]) const {
+        ref_coeffs_dudx_dudy_v(m, jac, coeff1, coeff2, coeffs);
+        return true;
+      }
+
       // This is to make the form usable in rk_time_step().
       virtual WeakForm::MatrixFormVol* clone() {
         return new DefaultLinearAdvection(*this);
@@ -370,10 +419,10 @@ namespace WeakFormsH1 {
     public:
       DefaultVectorFormConst(int i, std::string area = HERMES_ANY, scalar coeff = 1.0,
                              GeomType gt = HERMES_PLANAR)
-             : WeakForm::VectorFormVol(i, area), coeff(coeff), gt(gt) { }
+             : WeakForm::VectorFormVol(i, area), coeff(coeff), gt(gt) { batch_eval = true; }
       DefaultVectorFormConst(int i, Hermes::vector<std::string> areas, scalar coeff = 1.0,
                              GeomType gt = HERMES_PLANAR)
-             : WeakForm::VectorFormVol(i, areas), coeff(coeff), gt(gt) { }
+             : WeakForm::VectorFormVol(i, areas), coeff(coeff), gt(gt) { batch_eval = true; }
 
       virtual scalar value(int n, double *wt, Func<scalar> *u_ext[], Func<double> *v,
                            Geom<double> *e, ExtData<scalar> *ext) const {
@@ -393,6 +442,24 @@ namespace WeakFormsH1 {
         }
       }
 
+      virtual void value_batch(int n, double *wt, Func<scalar> *u_ext[], FuncBatch *v,
+                               Geom<double> *e, ExtData<scalar> *ext, scalar *result) const {
+        int_v_batch(n, geom_weights(n, wt, e, gt, v->wbuf), v, coeff, result);
+      }
+
+      virtual bool ref_coeffs(double2x2& m, double jac, scalar coeffs[H2D_NUM_REF_QUANTITIES]) const {
+        if (gt != HERMES_PLANAR) return false;
+        coeffs[0] += coeff * jac;
+        return true;
+      }
+
+      virtual bool ref_point_coeffs(int n, double *jwt, double2x2 *m, Geom<double> *e,
+                                    scalar (*coeffs)[H2D_NUM_REF_QUANTITIES]) const {
+        for (int k = 0; k < n; k++)
+          coeffs[k][0] += coeff * geom_weight(k, jwt, e, gt);
+        return true;
+      }
+
       // This is to make the form usable in rk_time_step().
       virtual WeakForm::VectorFormVol* clone() {
         return new DefaultVectorFormConst(*this);
@@ -412,9 +479,9 @@ namespace WeakFormsH1 {
     {
     public:
       DefaultResidualLinearMass(int i, std::string area = HERMES_ANY, scalar coeff = 1.0, GeomType gt = HERMES_PLANAR)
-        : WeakForm::VectorFormVol(i, area), coeff(coeff), gt(gt) { }
+        : WeakForm::VectorFormVol(i, area), coeff(coeff), gt(gt) { batch_eval = true; }
       DefaultResidualLinearMass(int i, Hermes::vector<std::string> areas, scalar coeff = 1.0, GeomType gt = HERMES_PLANAR)
-        : WeakForm::VectorFormVol(i, areas), coeff(coeff), gt(gt) { }
+        : WeakForm::VectorFormVol(i, areas), coeff(coeff), gt(gt) { batch_eval = true; }
 
       template<typename Real, typename Scalar>
       Scalar vector_form(int n, double *wt, Func<Scalar> *u_ext[],
@@ -437,6 +504,11 @@ namespace WeakFormsH1 {
         return vector_form<Ord, Ord>(n, wt, u_ext, v, e, ext);
       }
 
+      virtual void value_batch(int n, double *wt, Func<scalar> *u_ext[], FuncBatch *v,
+                               Geom<double> *e, ExtData<scalar> *ext, scalar *result) const {
+        int_f_v_batch(n, wt, u_ext[0]->val, v, coeff, result);
+      }
+
       // This is to make the form usable in rk_time_step().
       virtual WeakForm::VectorFormVol* clone() {
         return new DefaultResidualLinearMass(*this);
@@ -456,9 +528,9 @@ namespace WeakFormsH1 {
     {
     public:
       DefaultResidualLinearDiffusion(int i, std::string area = HERMES_ANY, scalar coeff = 1.0, GeomType gt = HERMES_PLANAR)
-             : WeakForm::VectorFormVol(i, area), coeff(coeff), gt(gt) { }
+             : WeakForm::VectorFormVol(i, area), coeff(coeff), gt(gt) { batch_eval = true; }
       DefaultResidualLinearDiffusion(int i, Hermes::vector<std::string> areas, scalar coeff = 1.0, GeomType gt = HERMES_PLANAR)
-             : WeakForm::VectorFormVol(i, areas), coeff(coeff), gt(gt) { }
+             : WeakForm::VectorFormVol(i, areas), coeff(coeff), gt(gt) { batch_eval = true; }
 
       virtual scalar value(int n, double *wt, Func<scalar> *u_ext[], Func<double> *v,
                            Geom<double> *e, ExtData<scalar> *ext) const {
@@ -483,6 +555,11 @@ namespace WeakFormsH1 {
         return result;
       }
 
+      virtual void value_batch(int n, double *wt, Func<scalar> *u_ext[], FuncBatch *v,
+                               Geom<double> *e, ExtData<scalar> *ext, scalar *result) const {
+        int_grad_u_ext_grad_v_batch(n, geom_weights(n, wt, e, gt, v->wbuf), u_ext[0], v, coeff, result);
+      }
+
       // This is to make the form usable in rk_time_step().
       virtual WeakForm::VectorFormVol* clone() {
         return new DefaultResidualLinearDiffusion(*this);
@@ -704,6 +781,13 @@ namespace WeakFormsH1 {
         return result;
       }
 
+      virtual bool ref_point_coeffs(int n, double *jwt, double2x2 *m, Geom<double> *e,
+                                    scalar (*coeffs)[H2D_NUM_REF_QUANTITIES]) const {
+        for (int k = 0; k < n; k++)
+          coeffs[k][0] += jwt[k] * rhs->value(e->x[k], e->y[k]);
+        return true;
+      }
+
       // This is to make the form usable in rk_time_step().
       virtual WeakForm::VectorFormVol* clone() {
         return new DefaultVectorFormNonConst(*this);
@@ -50,6 +50,12 @@ namespace WeakFormsHcurl {
         return matrix_form<Ord, Ord>(n, wt, u_ext, u, v, e, ext);
       }
 
+      virtual bool ref_coeffs(double2x2& m, double jac,
+                              scalar coeffs[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES]) const {
+        ref_coeffs_curl_e_curl_f(m, jac, coeff, coeffs);
+        return true;
+      }
+
       virtual WeakForm::MatrixFormVol* clone() {
         return new DefaultLinearCurlCurl(*this);
       }
@@ -86,6 +92,12 @@ namespace WeakFormsHcurl {
         return matrix_form<Ord, Ord>(n, wt, u_ext, u, v, e, ext);
       }
 
+      virtual bool ref_coeffs(double2x2& m, double jac,
+                              scalar coeffs[H2D_NUM_REF_QUANTITIES][H2D_NUM_REF_QUANTITIES]) const {
+        ref_coeffs_e_f(m, jac, coeff, coeffs);
+        return true;
+      }
+
       virtual WeakForm::MatrixFormVol* clone() {
         return new DefaultLinearMass(*this);
       }
@@ -164,6 +176,12 @@ namespace WeakFormsHcurl {
           return coeff0 * int_v0 + coeff1 * int_v1;
         }
 
+        virtual bool ref_coeffs(double2x2& m, double jac, scalar coeffs[H2D_NUM_REF_QUANTITIES]) const {
+          for (int a = 0; a < 2; a++)
+            coeffs[1 + a] += jac * (coeff0 * m[0][a] + coeff1 * m[1][a]);
+          return true;
+        }
+
       virtual WeakForm::VectorFormVol* clone() {
         return new DefaultVectorFormConst(*this);
       }
@@ -0,0 +1,123 @@
+#include "hermes2d.h"
+
+// This test makes sure that the matrices assembled by replaying the assembly
+// map of CSCMatrix (the positions of the entries recorded in the first
+// assembly that reuses the sparse structure) are the same as the ones
+// assembled by CSCMatrix::add() without the map, for a nonlinear form
+// evaluated at different iterates and with Dirichlet DOFs, and that the map
+// is dropped if it grows over the limit.
+
+int P_INIT = 3;
+int INIT_REF_NUM = 2;
+int NUM_ASSEMBLIES = 4;
+
+// The Jacobian of -div((1 + u^2) grad u) + u = f.
+class CustomJacobian : public WeakForm::MatrixFormVol
+{
+public:
+  CustomJacobian() : WeakForm::MatrixFormVol(0, 0, HERMES_ANY, HERMES_NONSYM) { }
+
+  template<typename Real, typename Scalar>
+  Scalar matrix_form(int n, double *wt, Func<Scalar> *u_ext[], Func<Real> *u,
+                     Func<Real> *v, Geom<Real> *e, ExtData<Scalar> *ext) const {
+    Scalar result = 0;
+    Func<Scalar>* u_prev = u_ext[0];
+    for (int i = 0; i < n; i++)
+      result += wt[i] * ((1.0 + u_prev->val[i] * u_prev->val[i]) * (u->dx[i] * v->dx[i] + u->dy[i] * v->dy[i])
+                         + 2.0 * u_prev->val[i] * u->val[i] * (u_prev->dx[i] * v->dx[i] + u_prev->dy[i] * v->dy[i])
+                         + u->val[i] * v->val[i]);
+    return result;
+  }
+
+  virtual scalar value(int n, double *wt, Func<scalar> *u_ext[], Func<double> *u,
+                       Func<double> *v, Geom<double> *e, ExtData<scalar> *ext) const {
+    return matrix_form<double, scalar>(n, wt, u_ext, u, v, e, ext);
+  }
+
+  virtual Ord ord(int n, double *wt, Func<Ord> *u_ext[], Func<Ord> *u, Func<Ord> *v,
+                  Geom<Ord> *e, ExtData<Ord> *ext) const {
+    return matrix_form<Ord, Ord>(n, wt, u_ext, u, v, e, ext);
+  }
+};
+
+class CustomWeakForm : public WeakForm
+{
+public:
+  CustomWeakForm() : WeakForm(1) { add_matrix_form(new CustomJacobian()); }
+};
+
+// Compares the nonzero entries of the matrices.
+bool compare(UMFPackMatrix* mat, UMFPackMatrix* mat_ref)
+{
+  if (mat->get_nnz() != mat_ref->get_nnz())
+  {
+    printf("%u != %u nonzero entries\n", mat->get_nnz(), mat_ref->get_nnz());
+    return false;
+  }
+  for (unsigned int k = 0; k < mat->get_nnz(); k++)
+    if (mat->get_Ax()[k] != mat_ref->get_Ax()[k])
+    {
+      printf("entry %u: %g != %g\n", k, mat->get_Ax()[k], mat_ref->get_Ax()[k]);
+      return false;
+    }
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  // Two quads that are not parallelograms and two triangles.
+  Mesh mesh;
+  double2 vertices[7] = { {0, 0}, {1, 0}, {2, 0}, {0, 1}, {1.1, 1.2}, {2, 1}, {1, 2} };
+  int4 triangles[2] = { {3, 4, 6, 1}, {4, 5, 6, 1} };
+  int5 quads[2] = { {0, 1, 4, 3, 1}, {1, 2, 5, 4, 1} };
+  int3 boundaries[6] = { {0, 1, 1}, {1, 2, 1}, {2, 5, 1}, {5, 6, 1}, {6, 3, 1}, {3, 0, 1} };
+  mesh.get_element_markers_conversion().insert_marker(1, "0");
+  mesh.get_boundary_markers_conversion().insert_marker(1, "1");
+  mesh.create(7, vertices, 2, triangles, 2, quads, 6, boundaries);
+  for (int i = 0; i < INIT_REF_NUM; i++) mesh.refine_all_elements();
+
+  DefaultEssentialBCConst bc_essential("1", 1.0);
+  EssentialBCs bcs(&bc_essential);
+  H1Space space(&mesh, &bcs, P_INIT);
+  int ndof = space.get_num_dofs();
+  CustomWeakForm wf;
+
+  // The same problem assembled with the map, with a map over the limit, and without the map.
+  DiscreteProblem dp(&wf, &space, false);
+  DiscreteProblem dp_small(&wf, &space, false);
+  DiscreteProblem dp_ref(&wf, &space, false);
+  UMFPackMatrix mat, mat_small, mat_ref;
+  mat_small.set_use_assembly_map(true, 0.5);
+  mat_ref.set_use_assembly_map(false);
+
+  bool success = true;
+  std::vector<scalar> coeff_vec(ndof);
+  for (int it = 0; it < NUM_ASSEMBLIES && success; it++)
+  {
+    for (int i = 0; i < ndof; i++)
+      coeff_vec[i] = sin(1.0 + it + 0.1 * i);
+    dp.assemble(&coeff_vec[0], &mat, NULL);
+    dp_small.assemble(&coeff_vec[0], &mat_small, NULL);
+    dp_ref.assemble(&coeff_vec[0], &mat_ref, NULL);
+
+    // The map is recorded by the second assembly and replayed by the next ones.
+    if (mat.has_assembly_map() != (it > 0) || mat_small.has_assembly_map())
+    {
+      printf("assembly %d: unexpected state of the assembly maps\n", it);
+      success = false;
+    }
+    success = success && compare(&mat, &mat_ref) && compare(&mat_small, &mat_ref);
+  }
+  printf("%d DOFs, %u nonzero entries\n", ndof, mat.get_nnz());
+
+  if (success)
+  {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else
+  {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
@@ -0,0 +1,105 @@
+#include "hermes2d.h"
+
+// This test makes sure that the elements containing points found by
+// the spatial index of a mesh (Mesh::get_element_at()) are the same
+// as the ones found by going through all active elements, with the
+// correct reference coordinates, also after the mesh is refined and
+// unrefined (the index has to be rebuilt, the ids are reused).
+
+int NUM_POINTS = 2000;
+double EPS = 1e-10;
+
+// Locates the point by going through all active elements.
+Element* find_by_scan(Mesh* mesh, RefMap* refmap, double x, double y)
+{
+  Element* e;
+  for_all_active_elements(e, mesh)
+  {
+    double xi1, xi2;
+    refmap->set_active_element(e);
+    refmap->untransform(e, x, y, xi1, xi2);
+    if (MeshIndex::is_in_ref_domain(e, xi1, xi2)) return e;
+  }
+  return NULL;
+}
+
+bool check(Mesh* mesh)
+{
+  RefMap refmap;
+  srand(1);
+  for (int i = 0; i < NUM_POINTS; i++)
+  {
+    // Points of the bounding box of the mesh and around it.
+    double x = 2.2 * rand() / RAND_MAX - 0.1;
+    double y = 2.2 * rand() / RAND_MAX - 0.1;
+    double xi1, xi2;
+    Element* e = mesh->get_element_at(x, y, xi1, xi2, &refmap);
+    Element* e_scan = find_by_scan(mesh, &refmap, x, y);
+    if (e != e_scan)
+    {
+      printf("point (%g, %g): element %d != %d\n", x, y, e ? e->id : -1, e_scan ? e_scan->id : -1);
+      return false;
+    }
+    if (e == NULL) continue;
+
+    // The reference coordinates are mapped back to the point.
+    double px, py;
+    double2x2 m;
+    refmap.set_active_element(e);
+    refmap.inv_ref_map_at_point(xi1, xi2, px, py, m);
+    if (fabs(px - x) > EPS || fabs(py - y) > EPS)
+    {
+      printf("point (%g, %g): reference coordinates (%g, %g) map to (%g, %g)\n", x, y, xi1, xi2,
+             px, py);
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  // Two quads that are not parallelograms and two triangles.
+  Mesh mesh;
+  double2 vertices[7] = { {0, 0}, {1, 0}, {2, 0}, {0, 1}, {1.1, 1.2}, {2, 1}, {1, 2} };
+  int4 triangles[2] = { {3, 4, 6, 1}, {4, 5, 6, 1} };
+  int5 quads[2] = { {0, 1, 4, 3, 1}, {1, 2, 5, 4, 1} };
+  int3 boundaries[6] = { {0, 1, 1}, {1, 2, 1}, {2, 5, 1}, {5, 6, 1}, {6, 3, 1}, {3, 0, 1} };
+  mesh.get_element_markers_conversion().insert_marker(1, "0");
+  mesh.get_boundary_markers_conversion().insert_marker(1, "1");
+  mesh.create(7, vertices, 2, triangles, 2, quads, 6, boundaries);
+
+  bool success = true;
+  mesh.refine_all_elements();
+  mesh.refine_all_elements();
+  success = success && check(&mesh);
+
+  // Refine a part of the elements, anisotropically for some quads.
+  Element* e;
+  std::vector<int> ids;
+  for_all_active_elements(e, &mesh)
+    if (e->id % 3 == 0) ids.push_back(e->id);
+  for (unsigned int i = 0; i < ids.size(); i++)
+    mesh.refine_element_id(ids[i], mesh.get_element(ids[i])->is_quad() ? i % 3 : 0);
+  success = success && check(&mesh);
+
+  // Unrefine and refine other elements, which reuses the ids.
+  mesh.unrefine_all_elements();
+  ids.clear();
+  for_all_active_elements(e, &mesh)
+    if (e->id % 2 == 0) ids.push_back(e->id);
+  for (unsigned int i = 0; i < ids.size(); i++)
+    mesh.refine_element_id(ids[i]);
+  success = success && check(&mesh);
+
+  if (success)
+  {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else
+  {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
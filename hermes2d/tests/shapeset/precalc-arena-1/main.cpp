@@ -0,0 +1,106 @@
+#include "hermes2d.h"
+
+// This test makes sure that the shape function values taken from
+// a PrecalcArena are the same as the values precalculated by
+// PrecalcShapeset, on whole elements as well as on sub-elements
+// (which are not in the arena), for master and slave shapesets.
+
+int MAX_ORDER = 6;
+double EPS = 1e-14;
+
+// Compares the values of all shape functions in all quadrature tables.
+bool compare(Shapeset* shapeset, Element** elements)
+{
+  PrecalcArena arena(shapeset, MAX_ORDER);
+  info("Arena of shapeset %d: %lu bytes.", shapeset->get_id(), (unsigned long) arena.get_memory());
+
+  PrecalcShapeset pss(shapeset), pss_arena(shapeset);
+  pss_arena.set_arena(&arena);
+  PrecalcShapeset slave(&pss), slave_arena(&pss_arena);
+
+  int nc = shapeset->get_num_components();
+  for (int m = 0; m < 2; m++)
+  {
+    for (int use_slave = 0; use_slave < 2; use_slave++)
+    {
+      PrecalcShapeset* p[2] = { &pss, &pss_arena };
+      if (use_slave) { p[0] = &slave; p[1] = &slave_arena; }
+      for (int k = 0; k < 2; k++)
+        p[k]->set_active_element(elements[m]);
+
+      Quad2D* quad = p[0]->get_quad_2d();
+      for (int index = 0; index <= shapeset->get_max_index(); index++)
+      {
+        // Whole element, a son, and the whole element again.
+        for (int son = -1; son < 2; son++)
+        {
+          for (int order = 0; order < quad->get_num_tables(); order++)
+          {
+            for (int k = 0; k < 2; k++)
+            {
+              if (use_slave) {
+                pss.reset_transform(); pss_arena.reset_transform();
+                if (son == 0) { pss.push_transform(son); pss_arena.push_transform(son); }
+                p[k]->set_master_transform();
+              }
+              else {
+                p[k]->reset_transform();
+                if (son == 0) p[k]->push_transform(son);
+              }
+              p[k]->set_active_shape(index);
+              p[k]->set_quad_order(order);
+            }
+            int np = quad->get_num_points(order);
+            for (int c = 0; c < nc; c++)
+            {
+              double* v[2][3];
+              for (int k = 0; k < 2; k++)
+              {
+                v[k][0] = p[k]->get_fn_values(c);
+                v[k][1] = p[k]->get_dx_values(c);
+                v[k][2] = p[k]->get_dy_values(c);
+              }
+              for (int t = 0; t < 3; t++)
+                for (int i = 0; i < np; i++)
+                  if (fabs(v[0][t][i] - v[1][t][i]) > EPS)
+                  {
+                    printf("mode %d, index %d, order %d, son %d: %g != %g\n", m, index, order, son,
+                           v[0][t][i], v[1][t][i]);
+                    return false;
+                  }
+            }
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  // A mesh with one triangle and one quad.
+  Mesh mesh;
+  double2 vertices[5] = { {0, 0}, {1, 0}, {1.3, 1}, {0.3, 1}, {2, 0.2} };
+  int4 triangles[1] = { {1, 4, 2, 1} };
+  int5 quads[1] = { {0, 1, 2, 3, 1} };
+  int3 boundaries[5] = { {0, 1, 1}, {2, 3, 1}, {3, 0, 1}, {1, 4, 1}, {4, 2, 1} };
+  mesh.get_element_markers_conversion().insert_marker(1, "0");
+  mesh.get_boundary_markers_conversion().insert_marker(1, "1");
+  mesh.create(5, vertices, 1, triangles, 1, quads, 5, boundaries);
+
+  Element* elements[2] = { mesh.get_element(1), mesh.get_element(0) };
+  if (elements[0]->get_mode() != HERMES_MODE_TRIANGLE)
+    std::swap(elements[0], elements[1]);
+
+  H1Shapeset h1_shapeset;
+  HcurlShapeset hcurl_shapeset;
+  if (!compare(&h1_shapeset, elements) || !compare(&hcurl_shapeset, elements))
+  {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+
+  printf("Success!\n");
+  return ERR_SUCCESS;
+}
@@ -0,0 +1,197 @@
+#include "hermes2d.h"
+
+// This test makes sure that the shape functions evaluated by
+// ShapesetEngine are the same as the functions of the generated
+// shapesets H1ShapesetJacobi and L2ShapesetLegendre, with all
+// derivatives, in a set of points on both element types, and
+// that the derivatives of the L2 shapeset are the ones of the
+// finite differences of the values. It also checks the tables
+// precalculated by a PrecalcShapeset with the engine against the
+// ones without it, on whole elements and on sub-elements.
+
+int NUM_POINTS = 200;
+double EPS = 1e-12;
+double FD_STEP = 1e-5;
+double FD_EPS = 1e-5;
+double PSS_EPS = 1e-10;
+
+// Compares the values k of the engine with the shapeset.
+bool compare(Shapeset* shapeset, ShapesetEngine* engine, int mode, int k, int np, double* x, double* y)
+{
+  shapeset->set_mode(mode);
+  int nf = engine->get_max_index(mode) + 1;
+  std::vector<double> result(nf * np);
+  engine->eval(mode, k, np, x, y, &result[0]);
+
+  // The differences are relative to the maximum of the function.
+  for (int index = 0; index < nf; index++)
+  {
+    double diff = 0, norm = 0;
+    for (int i = 0; i < np; i++)
+    {
+      double value = shapeset->get_value(k, index, x[i], y[i], 0);
+      diff = std::max(diff, fabs(value - result[index * np + i]));
+      norm = std::max(norm, fabs(value));
+    }
+    if (diff > EPS * std::max(1.0, norm))
+    {
+      printf("shapeset %d, mode %d, k %d, index %d: difference %g\n", shapeset->get_id(), mode, k,
+             index, diff);
+      return false;
+    }
+  }
+  return true;
+}
+
+// Compares the derivatives of the engine with the central differences of its values (k = 1, 2)
+// and of its first derivatives (k = 3, 4, 5).
+bool compare_fd(ShapesetEngine* engine, int mode, int np, double* x, double* y)
+{
+  int nf = engine->get_max_index(mode) + 1;
+  std::vector<double> xs(5 * np), ys(5 * np);
+  for (int i = 0; i < np; i++)
+  {
+    double dx[5] = { 0, FD_STEP, -FD_STEP, 0, 0 }, dy[5] = { 0, 0, 0, FD_STEP, -FD_STEP };
+    for (int j = 0; j < 5; j++)
+    {
+      xs[j * np + i] = x[i] + dx[j];
+      ys[j * np + i] = y[i] + dy[j];
+    }
+  }
+  std::vector<double> r[3];
+  for (int k = 0; k < 3; k++)
+  {
+    r[k].resize(nf * 5 * np);
+    engine->eval(mode, k, 5 * np, &xs[0], &ys[0], &r[k][0]);
+  }
+  std::vector<double> deriv(nf * np);
+
+  for (int k = 1; k < 6; k++)
+  {
+    engine->eval(mode, k, np, x, y, &deriv[0]);
+    // The function differentiated and the direction of the difference.
+    int fn[6] = { 0, 0, 0, 1, 2, 1 }, dir[6] = { 0, 0, 1, 0, 1, 1 };
+    for (int index = 0; index < nf; index++)
+      for (int i = 0; i < np; i++)
+      {
+        const double* f = &r[fn[k]][index * 5 * np];
+        int p = (dir[k] == 0) ? 1 : 3;
+        double fd = (f[p * np + i] - f[(p + 1) * np + i]) / (2 * FD_STEP);
+        double value = deriv[index * np + i];
+        if (fabs(value - fd) > FD_EPS * std::max(1.0, fabs(fd)))
+        {
+          printf("mode %d, k %d, index %d: %g != %g (finite difference)\n", mode, k, index, value, fd);
+          return false;
+        }
+      }
+  }
+  return true;
+}
+
+// Compares the tables of all shape functions precalculated with and without the engine.
+bool compare_pss(Shapeset* shapeset, ShapesetEngine* engine, Element** elements)
+{
+  PrecalcShapeset pss(shapeset), pss_engine(shapeset);
+  pss_engine.set_shapeset_engine(engine);
+  PrecalcShapeset* p[2] = { &pss, &pss_engine };
+  for (int m = 0; m < 2; m++)
+  {
+    for (int k = 0; k < 2; k++)
+      p[k]->set_active_element(elements[m]);
+    Quad2D* quad = pss.get_quad_2d();
+    for (int son = -1; son < 2; son++)
+      for (int order = 0; order < quad->get_num_tables(); order++)
+        for (int index = 0; index <= shapeset->get_max_index(); index++)
+        {
+          for (int k = 0; k < 2; k++)
+          {
+            p[k]->reset_transform();
+            if (son == 1) p[k]->push_transform(son);
+            p[k]->set_active_shape(index);
+            p[k]->set_quad_order(order, H2D_FN_ALL);
+          }
+          int np = quad->get_num_points(order);
+          for (int t = 0; t < 6; t++)
+          {
+            double* v[2];
+            for (int k = 0; k < 2; k++)
+              v[k] = p[k]->get_values(0, t);
+            double diff = 0, norm = 0;
+            for (int i = 0; i < np; i++)
+            {
+              diff = std::max(diff, fabs(v[0][i] - v[1][i]));
+              norm = std::max(norm, fabs(v[0][i]));
+            }
+            if (diff > PSS_EPS * std::max(1.0, norm))
+            {
+              printf("shapeset %d, mode %d, index %d, order %d, son %d, value %d: difference %g\n",
+                     shapeset->get_id(), m, index, order, son, t, diff);
+              return false;
+            }
+          }
+        }
+  }
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  H1ShapesetJacobi h1_shapeset;
+  L2ShapesetLegendre l2_shapeset;
+  ShapesetEngine h1_engine(&h1_shapeset);
+  ShapesetEngine l2_engine(&l2_shapeset);
+
+  bool success = true;
+  for (int mode = 0; mode < 2; mode++)
+  {
+    // Irregular points of the reference domain (the points of a quadrature can be roots of the
+    // Legendre polynomials, where the relative differences are meaningless).
+    int np = NUM_POINTS;
+    std::vector<double> x(np), y(np);
+    for (int i = 0; i < np; i++)
+    {
+      x[i] = 2 * fmod(0.5 + i * 0.6180339887, 1.0) - 1;
+      y[i] = 2 * fmod(0.2 + i * 0.4142135624, 1.0) - 1;
+      if (mode == HERMES_MODE_TRIANGLE && x[i] + y[i] > 0)
+      {
+        double t = x[i];
+        x[i] = -y[i];
+        y[i] = -t;
+      }
+    }
+
+    for (int k = 0; k < 6; k++)
+    {
+      success = success && compare(&h1_shapeset, &h1_engine, mode, k, np, &x[0], &y[0]);
+      success = success && compare(&l2_shapeset, &l2_engine, mode, k, np, &x[0], &y[0]);
+    }
+    success = success && compare_fd(&l2_engine, mode, np, &x[0], &y[0]);
+  }
+
+  // A mesh with one triangle and one quad.
+  Mesh mesh;
+  double2 vertices[5] = { {0, 0}, {1, 0}, {1.3, 1}, {0.3, 1}, {2, 0.2} };
+  int4 triangles[1] = { {1, 4, 2, 1} };
+  int5 quads[1] = { {0, 1, 2, 3, 1} };
+  int3 boundaries[5] = { {0, 1, 1}, {2, 3, 1}, {3, 0, 1}, {1, 4, 1}, {4, 2, 1} };
+  mesh.get_element_markers_conversion().insert_marker(1, "0");
+  mesh.get_boundary_markers_conversion().insert_marker(1, "1");
+  mesh.create(5, vertices, 1, triangles, 1, quads, 5, boundaries);
+  Element* elements[2] = { mesh.get_element(1), mesh.get_element(0) };
+  if (elements[0]->get_mode() != HERMES_MODE_TRIANGLE)
+    std::swap(elements[0], elements[1]);
+
+  success = success && compare_pss(&h1_shapeset, &h1_engine, elements);
+  success = success && compare_pss(&l2_shapeset, &l2_engine, elements);
+
+  if (success)
+  {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else
+  {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
@@ -0,0 +1,90 @@
+#include "hermes2d.h"
+
+// This test makes sure that the product of the matrix of a form with
+// a vector computed by SumFactorization::apply_matrix() is the same
+// as the product with the matrix assembled by assemble_matrix(), for
+// the assembly lists of two spaces of different degrees on a quad
+// and coefficients of all reference quantities in all points.
+
+int P_U = 6;
+int P_V = 4;
+double EPS = 1e-12;
+
+// Pseudo-random coefficients of the reference quantities.
+void set_coeffs(SumFactorization::MatrixCoeffs* coeffs, int np)
+{
+  for (int k = 0; k < np; k++)
+    for (int p = 0; p < H2D_NUM_REF_QUANTITIES; p++)
+      for (int q = 0; q < H2D_NUM_REF_QUANTITIES; q++)
+        coeffs[k][p][q] = sin(1.0 + k + 7.0 * p + 13.0 * q);
+}
+
+int main(int argc, char* argv[])
+{
+  // A quad that is not a parallelogram.
+  Mesh mesh;
+  double2 vertices[4] = { {0, 0}, {1, 0}, {1.2, 1.1}, {0, 1} };
+  int5 quads[1] = { {0, 1, 2, 3, 1} };
+  int3 boundaries[4] = { {0, 1, 1}, {1, 2, 1}, {2, 3, 1}, {3, 0, 1} };
+  mesh.get_element_markers_conversion().insert_marker(1, "0");
+  mesh.get_boundary_markers_conversion().insert_marker(1, "1");
+  mesh.create(4, vertices, 0, NULL, 1, quads, 4, boundaries);
+
+  H1Space space_u(&mesh, P_U);
+  H1Space space_v(&mesh, P_V);
+  Element* e = mesh.get_element(0);
+  AsmList alu, alv;
+  space_u.get_element_assembly_list(e, &alu);
+  space_v.get_element_assembly_list(e, &alv);
+  Shapeset* shapeset_u = space_u.get_shapeset();
+  Shapeset* shapeset_v = space_v.get_shapeset();
+
+  SumFactorization sum_fact;
+  bool success = sum_fact.is_supported(shapeset_u, &alu) && sum_fact.is_supported(shapeset_v, &alv);
+  if (!success)
+    printf("The shape functions are not supported.\n");
+
+  g_quad_2d_std.set_mode(HERMES_MODE_QUAD);
+  Quad1D* quad = g_quad_2d_std.get_tensor_quad_1d();
+  int order = P_U + P_V;
+  int n = quad->get_num_points(order);
+  SumFactorization::MatrixCoeffs* coeffs = sum_fact.get_matrix_coeffs(n * n);
+  set_coeffs(coeffs, n * n);
+
+  if (success)
+  {
+    scalar** mat = new_matrix<scalar>(alv.cnt, alu.cnt);
+    sum_fact.assemble_matrix(shapeset_u, &alu, shapeset_v, &alv, quad, order, coeffs, mat);
+
+    std::vector<scalar> x(alu.cnt), y(alv.cnt);
+    for (unsigned int j = 0; j < alu.cnt; j++)
+      x[j] = cos(0.5 + j);
+    sum_fact.apply_matrix(shapeset_u, &alu, shapeset_v, &alv, quad, order, coeffs, &x[0], &y[0]);
+
+    // The differences are relative to the maximum of the product.
+    double diff = 0, norm = 0;
+    for (unsigned int i = 0; i < alv.cnt; i++)
+    {
+      scalar value = 0;
+      for (unsigned int j = 0; j < alu.cnt; j++)
+        value += mat[i][j] * x[j];
+      diff = std::max(diff, std::abs(value - y[i]));
+      norm = std::max(norm, std::abs(value));
+    }
+    printf("%d x %d matrix, %d points: difference %g, norm %g\n", alv.cnt, alu.cnt, n * n, diff, norm);
+    if (norm == 0 || diff > EPS * norm)
+      success = false;
+    delete [] mat;
+  }
+
+  if (success)
+  {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else
+  {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
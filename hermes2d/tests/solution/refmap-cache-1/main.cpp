@@ -0,0 +1,109 @@
+#include "hermes2d.h"
+
+// This test makes sure that the values and derivatives of Solutions
+// transformed by the cached inverse reference mappings (see
+// Solution::set_refmap_cache()) are the same as the ones transformed
+// by the mappings of the RefMap, for H1 and Hcurl solutions on whole
+// elements and on sub-elements, and that the cache is reused when
+// the solution is set to another coefficient vector.
+
+int P_INIT = 4;
+int NUM_ITER = 3;
+
+// Compares the values of the two solutions in all quadrature tables of all elements.
+bool compare(Solution* sln, Solution* sln_cached, Mesh* mesh)
+{
+  Quad2D* quad = sln->get_quad_2d();
+  int nc = sln->get_num_components();
+  Element* e;
+  for_all_active_elements(e, mesh)
+  {
+    quad->set_mode(e->get_mode());
+    // Whole element, a son, and the whole element again.
+    for (int son = -1; son < 2; son++)
+    {
+      for (int order = 0; order < quad->get_num_tables(); order++)
+      {
+        Solution* s[2] = { sln, sln_cached };
+        for (int k = 0; k < 2; k++)
+        {
+          s[k]->set_active_element(e);
+          s[k]->reset_transform();
+          if (son == 0) s[k]->push_transform(son);
+          s[k]->set_quad_order(order);
+        }
+        int np = quad->get_num_points(order);
+
+        for (int c = 0; c < nc; c++)
+        {
+          scalar* v[2][3];
+          for (int k = 0; k < 2; k++)
+          {
+            v[k][0] = s[k]->get_fn_values(c);
+            v[k][1] = s[k]->get_dx_values(c);
+            v[k][2] = s[k]->get_dy_values(c);
+          }
+          for (int t = 0; t < 3; t++)
+            for (int i = 0; i < np; i++)
+              if (v[0][t][i] != v[1][t][i])
+              {
+                printf("element %d, son %d, order %d, component %d, value %d: %g != %g\n", e->id,
+                       son, order, c, t, std::abs(v[0][t][i]), std::abs(v[1][t][i]));
+                return false;
+              }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Sets both solutions to several coefficient vectors of the space and compares them.
+bool test_space(Space* space, Mesh* mesh)
+{
+  int ndof = space->get_num_dofs();
+  Solution sln, sln_cached;
+  sln_cached.set_refmap_cache(true);
+  std::vector<scalar> coeffs(ndof);
+  for (int iter = 0; iter < NUM_ITER; iter++)
+  {
+    for (int i = 0; i < ndof; i++)
+      coeffs[i] = sin(1.0 + i * (iter + 1.7));
+    Solution::vector_to_solution(&coeffs[0], space, &sln);
+    Solution::vector_to_solution(&coeffs[0], space, &sln_cached);
+    if (!compare(&sln, &sln_cached, mesh)) return false;
+  }
+
+  // The mappings of the first iteration are reused in the others.
+  unsigned long hits, misses, evictions;
+  size_t memory;
+  sln_cached.get_refmap_cache_stats(hits, misses, evictions, memory);
+  info("Cache: %lu hits, %lu misses, %lu evictions, %lu bytes.", hits, misses, evictions,
+       (unsigned long) memory);
+  return misses > 0 && hits == (NUM_ITER - 1) * misses;
+}
+
+int main(int argc, char* argv[])
+{
+  // A mesh with one triangle and one quad that is not a parallelogram, refined once.
+  Mesh mesh;
+  double2 vertices[5] = { {0, 0}, {1, 0}, {1.6, 1.3}, {0.3, 1}, {2, 0.2} };
+  int4 triangles[1] = { {1, 4, 2, 1} };
+  int5 quads[1] = { {0, 1, 2, 3, 1} };
+  int3 boundaries[5] = { {0, 1, 1}, {2, 3, 1}, {3, 0, 1}, {1, 4, 1}, {4, 2, 1} };
+  mesh.get_element_markers_conversion().insert_marker(1, "0");
+  mesh.get_boundary_markers_conversion().insert_marker(1, "1");
+  mesh.create(5, vertices, 1, triangles, 1, quads, 5, boundaries);
+  mesh.refine_all_elements();
+
+  H1Space h1_space(&mesh, P_INIT);
+  HcurlSpace hcurl_space(&mesh, P_INIT);
+  if (!test_space(&h1_space, &mesh) || !test_space(&hcurl_space, &mesh))
+  {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+
+  printf("Success!\n");
+  return ERR_SUCCESS;
+}
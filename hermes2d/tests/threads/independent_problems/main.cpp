@@ -0,0 +1,178 @@
+#define HERMES_REPORT_ALL
+#include "hermes2d.h"
+#include "weakform_library/h1.h"
+
+using namespace RefinementSelectors;
+using namespace WeakFormsH1::VolumetricMatrixForms;
+using namespace WeakFormsH1::VolumetricVectorForms;
+
+// This test solves several independent problems (a small parameter sweep)
+// concurrently in threads of one process and makes sure that the results
+// are identical to the ones obtained when the problems are solved one
+// after another. Every problem assembles its discrete problem, builds a
+// solution, linearizes it and performs one adaptivity step, on a mesh
+// with curved elements.
+//
+// Usage: test-independent-problems [domain.mesh] [number of threads]
+
+const int NUM_PROBLEMS = 8;                       // Number of independent problems.
+const int INIT_REF_NUM = 1;                       // Number of initial uniform mesh refinements.
+const double THRESHOLD = 0.3;                     // Adaptivity threshold.
+const int STRATEGY = 0;                           // Adaptive strategy.
+const CandList CAND_LIST = H2D_HP_ANISO;          // Predefined list of element refinement candidates.
+
+// Weak form of -div(lambda grad u) + u = f.
+class SweepWeakForm : public WeakForm
+{
+public:
+  SweepWeakForm(double lambda, double f) : WeakForm(1)
+  {
+    add_matrix_form(new DefaultLinearDiffusion(0, 0, HERMES_ANY, lambda));
+    add_matrix_form(new DefaultLinearMass(0, 0));
+    add_vector_form(new DefaultVectorFormConst(0, HERMES_ANY, f));
+  }
+};
+
+// Everything one problem produces.
+struct ProblemResult
+{
+  int ndof;
+  std::vector<scalar> matrix;
+  std::vector<scalar> rhs;
+  double norm;
+  int lin_vertices;
+  double lin_sum;
+  double err_est;
+  int ndof_adapted;
+};
+
+Mesh* base_mesh;
+ProblemResult serial_results[NUM_PROBLEMS];
+ProblemResult threaded_results[NUM_PROBLEMS];
+
+void solve_problem(int k, ProblemResult* result)
+{
+  Mesh mesh;
+  mesh.copy(base_mesh);
+  for (int i = 0; i < INIT_REF_NUM; i++) mesh.refine_all_elements();
+
+  DefaultEssentialBCConst bc(Hermes::vector<std::string>("1", "3"), 0.1 * k);
+  EssentialBCs bcs(&bc);
+  H1Space space(&mesh, &bcs, 2 + k % 3);
+  SweepWeakForm wf(1.0 + k, 10.0 - k);
+
+  // Assemble the stiffness matrix and the right-hand side.
+  result->ndof = Space::get_num_dofs(&space);
+  CSCMatrix matrix;
+  UMFPackVector rhs;
+  DiscreteProblem dp(&wf, &space);
+  dp.assemble(&matrix, &rhs);
+  result->matrix.assign(matrix.get_Ax(), matrix.get_Ax() + matrix.get_nnz());
+  result->rhs.resize(result->ndof);
+  for (int i = 0; i < result->ndof; i++)
+    result->rhs[i] = rhs.get(i);
+
+  // A solution with the right-hand side as coefficients.
+  Solution sln;
+  Solution::vector_to_solution(&result->rhs[0], &space, &sln);
+  Hermes2D hermes2d;
+  result->norm = hermes2d.calc_norm(&sln, HERMES_H1_NORM);
+
+  Linearizer lin;
+  lin.process_solution(&sln, H2D_FN_VAL_0, HERMES_EPS_LOW);
+  result->lin_vertices = lin.get_num_vertices();
+  result->lin_sum = 0.0;
+  for (int i = 0; i < lin.get_num_vertices(); i++)
+    result->lin_sum += lin.get_vertices()[i][2];
+
+  // One adaptivity step, with a reference solution built the same way.
+  Space* ref_space = Space::construct_refined_space(&space);
+  int ndof_ref = Space::get_num_dofs(ref_space);
+  scalar* ref_coeffs = new scalar[ndof_ref];
+  for (int i = 0; i < ndof_ref; i++)
+    ref_coeffs[i] = sin(0.1 * i * (k + 1));
+  Solution ref_sln;
+  Solution::vector_to_solution(ref_coeffs, ref_space, &ref_sln);
+  delete [] ref_coeffs;
+
+  H1ProjBasedSelector selector(CAND_LIST);
+  Adapt adaptivity(&space);
+  result->err_est = adaptivity.calc_err_est(&sln, &ref_sln);
+  adaptivity.adapt(&selector, THRESHOLD, STRATEGY);
+  result->ndof_adapted = Space::get_num_dofs(&space);
+
+  delete ref_space->get_mesh();
+  delete ref_space;
+}
+
+struct ThreadData
+{
+  int first;
+  int step;
+};
+
+void* solve_problems(void* arg)
+{
+  ThreadData* data = (ThreadData*) arg;
+  for (int k = data->first; k < NUM_PROBLEMS; k += data->step)
+    solve_problem(k, &threaded_results[k]);
+  return NULL;
+}
+
+bool compare(int k, const ProblemResult& a, const ProblemResult& b)
+{
+  bool ok = a.ndof == b.ndof && a.matrix == b.matrix && a.rhs == b.rhs && a.norm == b.norm
+            && a.lin_vertices == b.lin_vertices && a.lin_sum == b.lin_sum
+            && a.err_est == b.err_est && a.ndof_adapted == b.ndof_adapted;
+  info("Problem %d: ndof = %d, norm = %g, err_est = %g%%, ndof after adaptation = %d%s.",
+       k, a.ndof, a.norm, a.err_est, a.ndof_adapted, ok ? "" : " (threaded result differs)");
+  return ok;
+}
+
+int main(int argc, char* argv[])
+{
+  const char* mesh_file = (argc > 1) ? argv[1] : "domain.mesh";
+  int num_threads = (argc > 2) ? atoi(argv[2]) : 4;
+  if (num_threads < 1) num_threads = 1;
+
+  // Load the mesh.
+  Mesh mesh;
+  H2DReader mloader;
+  mloader.load(mesh_file, &mesh);
+  base_mesh = &mesh;
+
+  // Solve the problems one after another.
+  for (int k = 0; k < NUM_PROBLEMS; k++)
+    solve_problem(k, &serial_results[k]);
+
+  // Solve them again, concurrently.
+  pthread_t* threads = new pthread_t[num_threads];
+  ThreadData* data = new ThreadData[num_threads];
+  for (int t = 0; t < num_threads; t++)
+  {
+    data[t].first = t;
+    data[t].step = num_threads;
+    if (pthread_create(&threads[t], NULL, solve_problems, &data[t]))
+      error("Failed to create a thread.");
+  }
+  for (int t = 0; t < num_threads; t++)
+    pthread_join(threads[t], NULL);
+  delete [] threads;
+  delete [] data;
+
+  bool success = true;
+  for (int k = 0; k < NUM_PROBLEMS; k++)
+    if (!compare(k, serial_results[k], threaded_results[k]))
+      success = false;
+
+  if (success)
+  {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else
+  {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
@@ -0,0 +1,147 @@
+#define HERMES_REPORT_ALL
+#define HERMES_REPORT_FILE "application.log"
+#include "hermes2d.h"
+#include "function/function.h"
+
+//  Jacobian-free Newton-Krylov method (Hermes2D::solve_jfnk()) for the problem of the example
+//  P02-nonlinear/02-newton-1. The problem is solved by the Newton's method with the assembled
+//  Jacobian, by JFNK without a preconditioner and by JFNK with an ILU(0) preconditioner computed
+//  from the Jacobian of every third iteration. The numbers of iterations, residual assemblies
+//  and the times are compared, and the three solutions have to coincide.
+//
+//  The following parameters can be changed:
+
+const int P_INIT = 2;                             // Initial polynomial degree.
+const int INIT_GLOB_REF_NUM = 4;                  // Number of initial uniform mesh refinements.
+const int INIT_BDY_REF_NUM = 5;                   // Number of initial refinements towards boundary.
+const double NEWTON_TOL = 1e-6;                   // Stopping criterion for the Newton's method.
+const int NEWTON_MAX_ITER = 100;                  // Maximum allowed number of Newton iterations.
+const int PRECOND_REFRESH = 3;                    // The preconditioner is computed in every PRECOND_REFRESH-th
+                                                  // iteration.
+const double INIT_COND_CONST = 3.0;               // Constant initial condition.
+const double TOLERANCE = 1e-5;                    // Allowed relative difference of the solutions.
+MatrixSolverType matrix_solver = SOLVER_UMFPACK;  // Possibilities: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
+                                                  // SOLVER_PETSC, SOLVER_SUPERLU, SOLVER_UMFPACK.
+
+// Problem parameters.
+double HEAT_SRC = 1.0;
+
+// Boundary markers.
+const std::string BDY_DIRICHLET = "1";
+
+// Weak forms.
+#include "../definitions.cpp"
+
+// Prints the statistics of the iterations, returns the number of linear iterations.
+int report(const char* name, NewtonStatistics& stats, double time)
+{
+  int num_iters = stats.residual_norms.size() - 1, linear_iters = 0;
+  double residual_time = 0, jacobian_time = 0, solve_time = 0;
+  for (unsigned int i = 0; i < stats.residual_norms.size(); i++) {
+    linear_iters += stats.linear_iters[i];
+    residual_time += stats.residual_times[i];
+    jacobian_time += stats.jacobian_times[i];
+    solve_time += stats.solve_times[i];
+  }
+  info("%s: %d iterations, %d Jacobians, %d linear iterations, time %g s (residuals %g s, "
+       "Jacobians %g s, linear solves %g s).", name, num_iters, stats.num_jacobians, linear_iters,
+       time, residual_time, jacobian_time, solve_time);
+  return linear_iters;
+}
+
+int main(int argc, char* argv[])
+{
+  // Instantiate a class with global functions.
+  Hermes2D hermes2d;
+
+  // Load the mesh.
+  Mesh mesh;
+  H2DReader mloader;
+  mloader.load("../square.mesh", &mesh);
+
+  // Perform initial mesh refinements.
+  for(int i = 0; i < INIT_GLOB_REF_NUM; i++) mesh.refine_all_elements();
+  mesh.refine_towards_boundary(BDY_DIRICHLET, INIT_BDY_REF_NUM);
+
+  // Initialize the weak formulation.
+  CustomWeakFormHeatTransferNewton wf(HEAT_SRC);
+
+  // Initialize boundary conditions.
+  DefaultEssentialBCConst bc_essential(BDY_DIRICHLET, 0.0);
+  EssentialBCs bcs(&bc_essential);
+
+  // Create an H1 space with default shapeset.
+  H1Space space(&mesh, &bcs, P_INIT);
+  int ndof = Space::get_num_dofs(&space);
+  info("ndof = %d", ndof);
+
+  // Project the initial condition on the FE space.
+  scalar* init_vec = new scalar[ndof];
+  Solution init_sln;
+  init_sln.set_const(&mesh, INIT_COND_CONST);
+  OGProjection::project_global(&space, &init_sln, init_vec, matrix_solver);
+
+  // The Newton's method with the assembled Jacobian.
+  bool is_linear = false;
+  DiscreteProblem dp(&wf, &space, is_linear);
+  SparseMatrix* matrix = create_matrix(matrix_solver);
+  Vector* rhs = create_vector(matrix_solver);
+  Solver* solver = create_linear_solver(matrix_solver, matrix, rhs);
+  scalar* newton_vec = new scalar[ndof];
+  memcpy(newton_vec, init_vec, ndof * sizeof(scalar));
+  NewtonStatistics stats;
+  TimePeriod timer;
+  if (!hermes2d.solve_newton(newton_vec, &dp, solver, matrix, rhs, NEWTON_TOL, NEWTON_MAX_ITER,
+      false, false, 1.0, 1e6, NULL, &stats)) error("Newton's iteration failed.");
+  timer.tick();
+  report("Newton", stats, timer.last());
+  delete solver;
+  delete matrix;
+  delete rhs;
+
+  // JFNK without a preconditioner.
+  DiscreteProblem dp_jfnk(&wf, &space, is_linear);
+  scalar* jfnk_vec = new scalar[ndof];
+  memcpy(jfnk_vec, init_vec, ndof * sizeof(scalar));
+  timer.tick(HERMES_SKIP);
+  if (!hermes2d.solve_jfnk(jfnk_vec, &dp_jfnk, NEWTON_TOL, NEWTON_MAX_ITER, false,
+      NULL, NULL, NULL, &stats)) error("JFNK iteration failed.");
+  timer.tick();
+  report("JFNK", stats, timer.last());
+
+  // JFNK with an ILU(0) preconditioner computed from the Jacobian of every third iteration.
+  NewtonSettings settings;
+  settings.jacobian_refresh = PRECOND_REFRESH;
+  NativePrecond* precond = create_native_precond("ilu0");
+  scalar* pjfnk_vec = new scalar[ndof];
+  memcpy(pjfnk_vec, init_vec, ndof * sizeof(scalar));
+  timer.tick(HERMES_SKIP);
+  if (!hermes2d.solve_jfnk(pjfnk_vec, &dp_jfnk, NEWTON_TOL, NEWTON_MAX_ITER, false,
+      precond, NULL, &settings, &stats)) error("Preconditioned JFNK iteration failed.");
+  timer.tick();
+  report("JFNK with ILU(0)", stats, timer.last());
+  delete precond;
+
+  // Compare the solutions.
+  double diff = 0, norm = 0;
+  for (int i = 0; i < ndof; i++) {
+    diff = std::max(diff, std::abs(jfnk_vec[i] - newton_vec[i]));
+    diff = std::max(diff, std::abs(pjfnk_vec[i] - newton_vec[i]));
+    norm = std::max(norm, std::abs(newton_vec[i]));
+  }
+  info("Relative difference of the solutions: %g.", diff / norm);
+
+  delete [] init_vec;
+  delete [] newton_vec;
+  delete [] jfnk_vec;
+  delete [] pjfnk_vec;
+
+  if (diff <= TOLERANCE * norm) {
+    printf("Success!\n");
+    return ERR_SUCCESS;
+  }
+  else {
+    printf("Failure!\n");
+    return ERR_FAILURE;
+  }
+}
@@ -14,6 +14,8 @@ const int INIT_GLOB_REF_NUM = 3;                  // Number of initial uniform m
 const int INIT_BDY_REF_NUM = 5;                   // Number of initial refinements towards boundary.
 const double NEWTON_TOL = 1e-6;                   // Stopping criterion for the Newton's method.
 const int NEWTON_MAX_ITER = 8;                    // Maximum allowed number of Newton iterations.
+const int NEWTON_MAX_ITER_REUSE = 30;             // Maximum allowed number of iterations of the Shamanskii
+                                                  // and inexact Newton's methods.
 const double INIT_COND_CONST = 3.0;               // Constant initial condition.
 MatrixSolverType matrix_solver = SOLVER_UMFPACK;  // Possibilities: SOLVER_AMESOS, SOLVER_AZTECOO, SOLVER_MUMPS,
                                                   // SOLVER_PETSC, SOLVER_SUPERLU, SOLVER_UMFPACK.
@@ -71,6 +73,8 @@ int main(int argc, char* argv[])
   Solution* init_sln = new Solution();
   init_sln->set_const(&mesh, INIT_COND_CONST);
   OGProjection::project_global(&space, init_sln, coeff_vec, matrix_solver);
+  scalar* init_vec = new scalar[ndof];
+  memcpy(init_vec, coeff_vec, ndof * sizeof(scalar));
   delete init_sln;
 
   // Perform Newton's iteration.
@@ -81,11 +85,45 @@ int main(int argc, char* argv[])
   // Translate the resulting coefficient vector into the Solution sln.
   Solution::vector_to_solution(coeff_vec, &space, &sln);
 
+  // The Shamanskii method (the Jacobian is assembled in every third iteration) and
+  // the inexact Newton's method with GMRES have to converge to the same solution.
+  NewtonSettings shamanskii;
+  shamanskii.jacobian_refresh = 3;
+  NewtonStatistics stats;
+  memcpy(coeff_vec, init_vec, ndof * sizeof(scalar));
+  if (!hermes2d.solve_newton(coeff_vec, &dp, solver, matrix, rhs,
+      NEWTON_TOL, NEWTON_MAX_ITER_REUSE, verbose, false, 1.0, 1e6, &shamanskii, &stats))
+    error("Newton's iteration with the Jacobian reuse failed.");
+  info("Jacobian reuse: %d iterations, %d Jacobians.", (int) stats.residual_norms.size() - 1, stats.num_jacobians);
+  bool success = (stats.num_jacobians < (int) stats.residual_norms.size() - 1);
+  Solution sln_shamanskii;
+  Solution::vector_to_solution(coeff_vec, &space, &sln_shamanskii);
+
+  DiscreteProblem dp_gmres(&wf, &space, is_linear);
+  SparseMatrix* gmres_matrix = create_matrix(SOLVER_KRYLOV);
+  Vector* gmres_rhs = create_vector(SOLVER_KRYLOV);
+  IterSolver* gmres = static_cast<IterSolver*>(create_linear_solver(SOLVER_KRYLOV, gmres_matrix, gmres_rhs));
+  gmres->set_precond("ilu0");
+  NewtonSettings inexact;
+  inexact.inexact = true;
+  memcpy(coeff_vec, init_vec, ndof * sizeof(scalar));
+  if (!hermes2d.solve_newton(coeff_vec, &dp_gmres, gmres, gmres_matrix, gmres_rhs,
+      NEWTON_TOL, NEWTON_MAX_ITER_REUSE, verbose, false, 1.0, 1e6, &inexact, &stats))
+    error("Inexact Newton's iteration failed.");
+  info("Inexact Newton: %d iterations, forcing terms %g, %g.", (int) stats.residual_norms.size() - 1,
+       stats.forcing_terms[0], stats.forcing_terms[1]);
+  Solution sln_inexact;
+  Solution::vector_to_solution(coeff_vec, &space, &sln_inexact);
+
   // Cleanup.
   delete [] coeff_vec;
+  delete [] init_vec;
   delete matrix;
   delete rhs;
   delete solver;
+  delete gmres;
+  delete gmres_matrix;
+  delete gmres_rhs;
   
   info("ndof = %d", ndof);
   info("Coordinate (1, 0) value = %lf", sln.get_pt_value(1.0, 0.0));
@@ -96,11 +134,12 @@ int main(int argc, char* argv[])
   double coor_x[4] = {1.0, 3.0, 5.0, 7.0};
   double coor_y = 0.0;
   double t_value[4] = {2.658510, 2.617692, 2.522083, 2.329342};
-  bool success = true;
 
   for (int i = 0; i < 4; i++)
   {
     if (abs(t_value[i] - sln.get_pt_value(coor_x[i], coor_y)) > 1E-6) success = false;
+    if (abs(t_value[i] - sln_shamanskii.get_pt_value(coor_x[i], coor_y)) > 1E-5) success = false;
+    if (abs(t_value[i] - sln_inexact.get_pt_value(coor_x[i], coor_y)) > 1E-5) success = false;
   }
 
   if (success) {
@@ -241,11 +241,7 @@ void DiscreteProblem::create_sparse_structure(SparseMatrix *mat, Vector* rhs,
 
             // pretend assembling of the element stiffness matrix
             // register nonzero elements
-            for (int i = 0; i < am->cnt; i++)
-              if (am->dof[i] >= 0)
-                for (int j = 0; j < an->cnt; j++)
-                  if (an->dof[j] >= 0)
-                    mat->pre_add_ij(am->dof[i], an->dof[j]);
+            mat->pre_add_block(am->cnt, am->dof, an->cnt, an->dof);
           }
         }
       }
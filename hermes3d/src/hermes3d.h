@@ -45,11 +45,15 @@
 #include "../../hermes_common/solver/aztecoo.h"
 #include "../../hermes_common/solver/nox.h"
 #include "../../hermes_common/solver/mumps.h"
+#include "../../hermes_common/solver/csr.h"
+#include "../../hermes_common/solver/krylov.h"
 
 // preconditioners
 #include "../../hermes_common/solver/precond.h"
 #include "../../hermes_common/solver/precond_ifpack.h"
 #include "../../hermes_common/solver/precond_ml.h"
+#include "../../hermes_common/solver/precond_native.h"
+#include "../../hermes_common/solver/precond_amg.h"
 
 // Eigensolver
 #include "../../hermes_common/solver/eigensolver.h"
@@ -25,6 +25,17 @@
 // global instance of the call stack object
 static CallStack callstack;
 
+// the call stack objects of the calling thread
+static HERMES_THREAD_LOCAL CallStackObj *callstack_objs[HERMES_CALLSTACK_MAX_SIZE];
+static HERMES_THREAD_LOCAL int callstack_size = 0;
+
+// call stack objects created in threads with this flag set are not recorded
+static HERMES_THREAD_LOCAL bool callstack_thread_disabled = false;
+
+void callstack_set_thread_enabled(bool enabled) {
+	callstack_thread_disabled = !enabled;
+}
+
 // Call Stack Object ////
 
 CallStackObj::CallStackObj(int ln, const char *func, const char *file) {
@@ -32,18 +43,24 @@ CallStackObj::CallStackObj(int ln, const char *func, const char *file) {
 	this->func = func;
 	this->file = file;
 
+	if (callstack_thread_disabled)
+		return;
+
 	// add this object to the call stack
-	if (callstack.size < callstack.max_size) {
-		callstack.stack[callstack.size] = this;
-		callstack.size++;
+	if (callstack_size < HERMES_CALLSTACK_MAX_SIZE) {
+		callstack_objs[callstack_size] = this;
+		callstack_size++;
 	}
 }
 
 CallStackObj::~CallStackObj() {
+	if (callstack_thread_disabled)
+		return;
+
 	// remove the object only if it is on the top of the call stack
-	if (callstack.size > 0 && callstack.stack[callstack.size - 1] == this) {
-		callstack.size--;
-		callstack.stack[callstack.size] = NULL;
+	if (callstack_size > 0 && callstack_objs[callstack_size - 1] == this) {
+		callstack_size--;
+		callstack_objs[callstack_size] = NULL;
 	}
 }
 
@@ -85,24 +102,19 @@ void callstack_finalize() {
 
 CallStack &get_callstack() { return callstack; }
 
-CallStack::CallStack(int max_size) {
-	this->max_size = max_size;
-	this->size = 0;
-	this->stack = new CallStackObj *[max_size];
-
+CallStack::CallStack() {
 	// initialize signals
 	callstack_initialize();
 }
 
 CallStack::~CallStack() {
-	delete [] stack;
 }
 
 void CallStack::dump() {
-	if (size > 0) {
+	if (callstack_size > 0) {
 		fprintf(stderr, "Call stack:\n");
-		for (int i = size - 1; i >= 0; i--)
-			fprintf(stderr, "  %s:%d: %s\n", stack[i]->file, stack[i]->line, stack[i]->func);
+		for (int i = callstack_size - 1; i >= 0; i--)
+			fprintf(stderr, "  %s:%d: %s\n", callstack_objs[i]->file, callstack_objs[i]->line, callstack_objs[i]->func);
 	}
 	else {
 		fprintf(stderr, "No call stack available.\n");
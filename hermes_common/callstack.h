@@ -43,26 +43,27 @@ public:
 	const char *func;			// function name
 };
 
+/// Maximal depth of the recorded call stack
+#define HERMES_CALLSTACK_MAX_SIZE 32
+
 /// Call stack object
 ///
+/// Every thread records its own stack of calls, dump() prints the one of the calling thread.
 class HERMES_API CallStack 
 {
 public:
-	CallStack(int max_size = 32);
+	CallStack();
 	~CallStack();
 
 	// dump the call stack objects to standard error
 	void dump();
-
-protected:
-	CallStackObj **stack;
-	int size;
-	int max_size;
-
-	friend class CallStackObj;
 };
 
 CallStack &get_callstack();
 
+/// Enables / disables tracking of the call stack in the calling thread. Worker threads
+/// (e.g. in threaded assembling) may switch the tracking off to save its overhead.
+HERMES_API void callstack_set_thread_enabled(bool enabled);
+
 
 #endif
@@ -83,7 +83,8 @@ enum MatrixSolverType
    SOLVER_MUMPS,
    SOLVER_SUPERLU,
    SOLVER_AMESOS,
-   SOLVER_AZTECOO
+   SOLVER_AZTECOO,
+   SOLVER_KRYLOV
 };
 
 // Should be in the same order as MatrixSolverTypes above, so that the
@@ -94,7 +95,8 @@ const std::string MatrixSolverNames[7] = {
   "MUMPS",
   "SuperLU",
   "Trilinos/Amesos",
-  "Trilinos/AztecOO"
+  "Trilinos/AztecOO",
+  "Native Krylov"
 };
 
 #define UMFPACK_NOT_COMPILED  HERMES " was not built with UMFPACK support."
@@ -123,7 +125,8 @@ enum ESolutionType {
   HERMES_UNDEF = -1,
   HERMES_SLN = 0,
   HERMES_EXACT = 1,
-  HERMES_CONST = 2
+  HERMES_CONST = 2,
+  HERMES_SLN_DIRECT = 3  // Evaluated directly from the coefficient vector and the shape functions.
 };
 
 
@@ -58,6 +58,15 @@ FILE *fmemopen (void *buf, size_t size, const char *opentype);
 #define strtold strtod
 #endif
 
+// Storage class for variables that have a separate instance in every thread.
+// Such variables can not carry HERMES_API (MSVC refuses dllimport of thread data),
+// export an accessor function instead.
+#ifdef _MSC_VER
+#define HERMES_THREAD_LOCAL __declspec(thread)
+#else
+#define HERMES_THREAD_LOCAL __thread
+#endif
+
 #ifdef __GNUC__
 #define NORETURN __attribute__((noreturn))
 #else
@@ -31,6 +31,7 @@
 #include "solver/mumps.h"
 #include "solver/nox.h"
 #include "solver/aztecoo.h"
+#include "solver/krylov.h"
 
 #define HERMES_TINY 1.0e-20
 
@@ -128,13 +129,13 @@ double vec_dot(Vector *r, Vector *s, int n_dof)
 
 // SparseMatrix ////////////////////////////////////////////////////////////////////////////////////
 
-void qsort_int(int* pbase, size_t total_elems); // defined in qsort.cpp
-
 SparseMatrix::SparseMatrix()
 {
   _F_
   size = 0;
-  pages = NULL;
+  pattern = NULL;
+  pattern_threads = 1;
+  pattern_seq = 0;
 
   row_storage = false;
   col_storage = false;
@@ -144,7 +145,9 @@ SparseMatrix::SparseMatrix(unsigned int size)
 {
   _F_
   this->size = size;
-  pages = NULL;
+  pattern = NULL;
+  pattern_threads = 1;
+  pattern_seq = 0;
 
   row_storage = false;
   col_storage = false;
@@ -153,7 +156,7 @@ SparseMatrix::SparseMatrix(unsigned int size)
 SparseMatrix::~SparseMatrix()
 {
   _F_
-  delete [] pages;
+  delete pattern;
 }
 
 void SparseMatrix::prealloc(unsigned int n)
@@ -161,54 +164,35 @@ void SparseMatrix::prealloc(unsigned int n)
   _F_
   this->size = n;
 
-  pages = new Page *[n];
-  MEM_CHECK(pages);
-  memset(pages, 0, n * sizeof(Page *));
+  delete pattern;
+  pattern = new SparsityPattern;
+  MEM_CHECK(pattern);
+  pattern->init(n);
 }
 
 void SparseMatrix::pre_add_ij(unsigned int row, unsigned int col)
 {
-  _F_
-  if (pages[col] == NULL || pages[col]->count >= PAGE_SIZE) {
-    Page *new_page = new Page;
-    MEM_CHECK(new_page);
-    new_page->count = 0;
-    new_page->next = pages[col];
-    pages[col] = new_page;
-  }
-  pages[col]->idx[pages[col]->count++] = row;
+  pattern->add_entry(row, col);
 }
 
-int SparseMatrix::sort_and_store_indices(Page *page, int *buffer, int *max)
+void SparseMatrix::pre_add_block(unsigned int n_rows, int* rows, unsigned int n_cols, int* cols)
 {
-  _F_
-  // gather all pages in the buffer, deleting them along the way
-  int *end = buffer;
-  while (page != NULL) {
-    memcpy(end, page->idx, sizeof(int) * page->count);
-    end += page->count;
-    Page *tmp = page;
-    page = page->next;
-    delete tmp;
-  }
-
-  // sort the indices and remove duplicities
-  qsort_int(buffer, end - buffer);
-  int *q = buffer;
-  for (int *p = buffer, last = -1; p < end; p++) if (*p != last) *q++ = last = *p;
-
-  return q - buffer;
+  pattern->add_block(n_rows, rows, n_cols, cols);
 }
 
-int SparseMatrix::get_num_indices()
+void SparseMatrix::build_pattern(int*& col_ptr, int*& row_idx)
 {
   _F_
-  int total = 0;
-  for (unsigned int i = 0; i < size; i++)
-    for (Page *page = pages[i]; page != NULL; page = page->next)
-      total += page->count;
-
-  return total;
+  assert(pattern != NULL);
+  pattern->build(pattern_threads);
+  verbose("Sparse structure: %u nonzeros from %g element entries, built in %g s, peak memory %g MB.",
+          pattern->get_nnz(), pattern->get_num_pairs(), pattern->get_build_time(),
+          pattern->get_peak_memory() / 1048576.0);
+  col_ptr = pattern->take_col_ptr();
+  row_idx = pattern->take_row_idx();
+  delete pattern;
+  pattern = NULL;
+  pattern_seq++;
 }
 
 SparseMatrix* create_matrix(MatrixSolverType matrix_solver)
@@ -242,6 +226,11 @@ SparseMatrix* create_matrix(MatrixSolverType matrix_solver)
       return new SuperLUMatrix;
       break;
     }
+    case SOLVER_KRYLOV: 
+    {
+      return new CSRMatrix;
+      break;
+    }
     default: 
       error("Unknown matrix solver requested.");
   }
@@ -296,6 +285,12 @@ Solver* create_linear_solver(MatrixSolverType matrix_solver, Matrix* matrix, Vec
       else return new SuperLUSolver(static_cast<SuperLUMatrix*>(matrix), static_cast<SuperLUVector*>(rhs_dummy)); 
       break;
     }
+    case SOLVER_KRYLOV: 
+    {
+      info("Using native GMRES.");
+      return new GMRESSolver(static_cast<SparseMatrix*>(matrix), rhs);
+      break;
+    }
     default: 
       error("Unknown matrix solver requested.");
   }
@@ -333,6 +328,11 @@ Vector* create_vector(MatrixSolverType matrix_solver)
       return new SuperLUVector;
       break;
     }
+    case SOLVER_KRYLOV: 
+    {
+      return new CSRVector;
+      break;
+    }
     default: 
       error("Unknown matrix solver requested.");
   }
@@ -22,6 +22,7 @@
 
 #include "common.h"
 #include "error.h"
+#include "sparsity.h"
 
 /// Creates a new (full) matrix with m rows and n columns with entries of the type T.
 /// The entries can be accessed by matrix[i][j]. To delete the matrix, just
@@ -310,6 +311,29 @@ public:
   /// @param[in] col  - column index
   virtual void pre_add_ij(unsigned int row, unsigned int col);
 
+  /// add indices of all nonzero entries of an element matrix, negative indices are skipped
+  ///
+  /// @param[in] n_rows - number of rows
+  /// @param[in] rows   - row indices
+  /// @param[in] n_cols - number of columns
+  /// @param[in] cols   - column indices
+  virtual void pre_add_block(unsigned int n_rows, int* rows, unsigned int n_cols, int* cols);
+
+  /// set the number of threads building the sparse structure in alloc()
+  void set_num_pattern_threads(int num_threads) { pattern_threads = num_threads; }
+
+  /// the structure registered by the last prealloc(), valid until alloc()
+  SparsityPattern* get_pattern() const { return pattern; }
+
+  /// sequence number of the sparse structure, changes whenever the structure is rebuilt
+  /// (used by the solvers to reuse the symbolic factorization)
+  unsigned int get_pattern_seq() const { return pattern_seq; }
+
+  /// mark the beginning and the end of an assembly (a sequence of add() calls repeated
+  /// with the same structure), matrices can use them to speed up the repeated assemblies
+  virtual void begin_assembly_map() { }
+  virtual void end_assembly_map() { }
+
   virtual void finish() { }
 
   virtual unsigned int get_size() { return size; }
@@ -369,18 +393,13 @@ public:
   unsigned col_storage:1;
 
 protected:
-  static const int PAGE_SIZE = 62;
-
-  struct Page {
-    int count;
-    int idx[PAGE_SIZE];
-    Page *next;
-  };
-
-  Page **pages;
+  SparsityPattern* pattern;
+  int pattern_threads;
+  unsigned int pattern_seq;
 
-  int sort_and_store_indices(Page *page, int *buffer, int *max);
-  int get_num_indices();
+  /// Builds the structure registered since prealloc() and releases it. Returns the column
+  /// pointers (size + 1 entries) and the sorted row indices in arrays allocated by new [].
+  void build_pattern(int*& col_ptr, int*& row_idx);
 
   // mem stat
   int mem_size;
@@ -0,0 +1,686 @@
+// This file is part of Hermes
+//
+// Hermes is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "csr.h"
+#include "umfpack_solver.h"
+
+#include "../trace.h"
+#include "../error.h"
+#include "../utils.h"
+#include "../callstack.h"
+
+static int find_position(int *Aj, int Alen, int idx)
+{
+  int lo = 0, hi = Alen - 1;
+  while (lo <= hi) {
+    int mid = (lo + hi) >> 1;
+    if (idx < Aj[mid]) hi = mid - 1;
+    else if (idx > Aj[mid]) lo = mid + 1;
+    else return mid;
+  }
+  return -1;
+}
+
+// Dot product of a sparse row with a vector. Four independent partial sums keep
+// the floating point pipelines busy, the summation order does not depend on the
+// number of threads.
+static inline scalar sparse_dot(const scalar* a, const int* idx, int n, const scalar* x)
+{
+  scalar s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+  int k = 0;
+  for (; k + 4 <= n; k += 4) {
+    s0 += a[k] * x[idx[k]];
+    s1 += a[k + 1] * x[idx[k + 1]];
+    s2 += a[k + 2] * x[idx[k + 2]];
+    s3 += a[k + 3] * x[idx[k + 3]];
+  }
+  for (; k < n; k++) s0 += a[k] * x[idx[k]];
+  return (s0 + s1) + (s2 + s3);
+}
+
+// Dot product of two contiguous arrays (rows of a row block with the gathered vector).
+static inline scalar dense_dot(const scalar* a, const scalar* x, int n)
+{
+  scalar s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+  int k = 0;
+  for (; k + 4 <= n; k += 4) {
+    s0 += a[k] * x[k];
+    s1 += a[k + 1] * x[k + 1];
+    s2 += a[k + 2] * x[k + 2];
+    s3 += a[k + 3] * x[k + 3];
+  }
+  for (; k < n; k++) s0 += a[k] * x[k];
+  return (s0 + s1) + (s2 + s3);
+}
+
+// The threads of multiply_with_vector(). The calling thread computes the first range of
+// blocks, the threads of the pool the other ones.
+struct CSRMatrix::MultiplyPool
+{
+  struct Range
+  {
+    MultiplyPool* pool;
+    CSRMatrix* mat;
+    unsigned int first_block, last_block;
+    scalar* gathered;
+  };
+
+  MultiplyPool(int num_ranges) : ranges(num_ranges), split_valid(false), vector_in(NULL), vector_out(NULL),
+                                 generation(0), num_running(0), shutdown(false)
+  {
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&start_cond, NULL);
+    pthread_cond_init(&done_cond, NULL);
+    for (unsigned int t = 0; t < ranges.size(); t++)
+      ranges[t].gathered = NULL;
+  }
+
+  ~MultiplyPool()
+  {
+    for (unsigned int t = 0; t < ranges.size(); t++)
+      delete [] ranges[t].gathered;
+    pthread_cond_destroy(&done_cond);
+    pthread_cond_destroy(&start_cond);
+    pthread_mutex_destroy(&mutex);
+  }
+
+  std::vector<pthread_t> threads;
+  std::vector<Range> ranges;
+  bool split_valid;           // The ranges correspond to the current structure.
+
+  pthread_mutex_t mutex;
+  pthread_cond_t start_cond;  // Signalled when a product starts or at the shutdown.
+  pthread_cond_t done_cond;   // Signalled when the threads finished the product.
+  scalar* vector_in;
+  scalar* vector_out;
+  unsigned long generation;   // Number of started products.
+  int num_running;            // Number of threads still working on the current product.
+  bool shutdown;
+};
+
+CSRMatrix::CSRMatrix()
+{
+  _F_
+  size = 0; nnz = 0;
+  Ap = NULL;
+  Aj = NULL;
+  Ax = NULL;
+  num_threads = 1;
+  use_row_blocks = false;
+  block_ptr = NULL;
+  num_blocks = 0;
+  max_row_length = 0;
+  gathered = NULL;
+  pool = NULL;
+  row_storage = true;
+}
+
+CSRMatrix::CSRMatrix(unsigned int size)
+{
+  _F_
+  this->size = size;
+  nnz = 0;
+  Ap = NULL;
+  Aj = NULL;
+  Ax = NULL;
+  num_threads = 1;
+  use_row_blocks = false;
+  block_ptr = NULL;
+  num_blocks = 0;
+  max_row_length = 0;
+  gathered = NULL;
+  pool = NULL;
+  row_storage = true;
+  this->alloc();
+}
+
+CSRMatrix::~CSRMatrix()
+{
+  _F_
+  free();
+  free_pool();
+}
+
+void CSRMatrix::pre_add_ij(unsigned int row, unsigned int col)
+{
+  pattern->add_entry(col, row);
+}
+
+void CSRMatrix::pre_add_block(unsigned int n_rows, int* rows, unsigned int n_cols, int* cols)
+{
+  pattern->add_block(n_cols, cols, n_rows, rows);
+}
+
+void CSRMatrix::alloc()
+{
+  _F_
+  free();
+
+  // The pattern has been registered transposed, its columns are the rows of the matrix.
+  build_pattern(Ap, Aj);
+  nnz = Ap[size];
+
+  Ax = new scalar[nnz];
+  MEM_CHECK(Ax);
+  memset(Ax, 0, sizeof(scalar) * nnz);
+  update_row_blocks();
+}
+
+void CSRMatrix::free()
+{
+  _F_
+  nnz = 0;
+  if (Ap != NULL) { delete [] Ap; Ap = NULL; }
+  if (Aj != NULL) { delete [] Aj; Aj = NULL; }
+  if (Ax != NULL) { delete [] Ax; Ax = NULL; }
+  if (block_ptr != NULL) { delete [] block_ptr; block_ptr = NULL; }
+  if (gathered != NULL) { delete [] gathered; gathered = NULL; }
+  num_blocks = 0;
+  max_row_length = 0;
+  if (pool != NULL) pool->split_valid = false;
+}
+
+void CSRMatrix::find_row_blocks(std::vector<int>& first_rows) const
+{
+  _F_
+  first_rows.clear();
+  for (unsigned int i = 0; i < size; i++) {
+    if (i > 0) {
+      int len = Ap[i + 1] - Ap[i];
+      int first = first_rows.back();
+      if (len > 0 && len == Ap[first + 1] - Ap[first]
+          && memcmp(Aj + Ap[i], Aj + Ap[first], sizeof(int) * len) == 0)
+        continue;
+    }
+    first_rows.push_back(i);
+  }
+}
+
+void CSRMatrix::update_row_blocks()
+{
+  _F_
+  if (block_ptr != NULL) { delete [] block_ptr; block_ptr = NULL; }
+  if (gathered != NULL) { delete [] gathered; gathered = NULL; }
+  num_blocks = size;
+  max_row_length = 0;
+  if (pool != NULL) pool->split_valid = false;
+  if (Ap == NULL) return;
+
+  for (unsigned int i = 0; i < size; i++)
+    max_row_length = std::max(max_row_length, Ap[i + 1] - Ap[i]);
+  if (!use_row_blocks) return;
+
+  std::vector<int> starts;
+  find_row_blocks(starts);
+
+  num_blocks = starts.size();
+  block_ptr = new int[num_blocks + 1];
+  MEM_CHECK(block_ptr);
+  if (num_blocks > 0) memcpy(block_ptr, &starts[0], sizeof(int) * num_blocks);
+  block_ptr[num_blocks] = size;
+  gathered = new scalar[std::max(max_row_length, 1)];
+  MEM_CHECK(gathered);
+  verbose("CSRMatrix: %u rows in %u row blocks.", size, num_blocks);
+}
+
+void CSRMatrix::set_row_blocks(bool use)
+{
+  _F_
+  use_row_blocks = use;
+  update_row_blocks();
+}
+
+void CSRMatrix::set_num_threads(int num_threads)
+{
+  _F_
+  if (num_threads < 1) error("Invalid number of threads in CSRMatrix::set_num_threads().");
+  if (num_threads != this->num_threads) free_pool();
+  this->num_threads = num_threads;
+}
+
+scalar CSRMatrix::get(unsigned int m, unsigned int n)
+{
+  _F_
+  // Find n-th column in the m-th row.
+  int pos = find_position(Aj + Ap[m], Ap[m + 1] - Ap[m], n);
+  if (pos < 0)
+    return 0.0;
+  else
+    return Ax[Ap[m] + pos];
+}
+
+void CSRMatrix::zero()
+{
+  _F_
+  memset(Ax, 0, sizeof(scalar) * nnz);
+}
+
+void CSRMatrix::add(unsigned int m, unsigned int n, scalar v)
+{
+  _F_
+  if (v != 0.0)   // ignore zero values.
+  {
+    // Find n-th column in the m-th row.
+    int pos = find_position(Aj + Ap[m], Ap[m + 1] - Ap[m], n);
+    // Make sure we are adding to an existing non-zero entry.
+    if (pos < 0) {
+      info("CSRMatrix::add(): i = %d, j = %d.", m, n);
+      error("Sparse matrix entry not found");
+    }
+
+    Ax[Ap[m] + pos] += v;
+  }
+}
+
+void CSRMatrix::add_to_diagonal(scalar v)
+{
+  _F_
+  for (unsigned int i = 0; i < size; i++)
+    add(i, i, v);
+}
+
+void CSRMatrix::add(unsigned int m, unsigned int n, scalar **mat, int *rows, int *cols)
+{
+  _F_
+  for (unsigned int i = 0; i < m; i++) {     // rows
+    if (rows[i] < 0) continue;               // Dir. dof
+    int* row_cols = Aj + Ap[rows[i]];
+    scalar* row_vals = Ax + Ap[rows[i]];
+    int len = Ap[rows[i] + 1] - Ap[rows[i]];
+    for (unsigned int j = 0; j < n; j++) {   // cols
+      if (cols[j] < 0 || mat[i][j] == 0.0) continue;
+      int pos = find_position(row_cols, len, cols[j]);
+      if (pos < 0) {
+        info("CSRMatrix::add(): i = %d, j = %d.", rows[i], cols[j]);
+        error("Sparse matrix entry not found");
+      }
+      row_vals[pos] += mat[i][j];
+    }
+  }
+}
+
+void CSRMatrix::multiply_blocks(scalar* vector_in, scalar* vector_out, unsigned int first_block, unsigned int last_block,
+                                scalar* scratch)
+{
+  if (block_ptr == NULL) {
+    for (unsigned int i = first_block; i < last_block; i++)
+      vector_out[i] = sparse_dot(Ax + Ap[i], Aj + Ap[i], Ap[i + 1] - Ap[i], vector_in);
+    return;
+  }
+
+  for (unsigned int b = first_block; b < last_block; b++) {
+    int first = block_ptr[b], last = block_ptr[b + 1];
+    int len = Ap[first + 1] - Ap[first];
+    if (last - first == 1) {
+      vector_out[first] = sparse_dot(Ax + Ap[first], Aj + Ap[first], len, vector_in);
+      continue;
+    }
+    const int* idx = Aj + Ap[first];
+    for (int k = 0; k < len; k++)
+      scratch[k] = vector_in[idx[k]];
+    for (int i = first; i < last; i++)
+      vector_out[i] = dense_dot(Ax + Ap[i], scratch, len);
+  }
+}
+
+void* CSRMatrix::multiply_thread_run(void* data)
+{
+  MultiplyPool::Range* range = (MultiplyPool::Range*) data;
+  MultiplyPool* pool = range->pool;
+  unsigned long generation = 0;
+
+  pthread_mutex_lock(&pool->mutex);
+  while (1) {
+    while (pool->generation == generation && !pool->shutdown)
+      pthread_cond_wait(&pool->start_cond, &pool->mutex);
+    if (pool->shutdown) break;
+    generation = pool->generation;
+    pthread_mutex_unlock(&pool->mutex);
+
+    range->mat->multiply_blocks(pool->vector_in, pool->vector_out, range->first_block, range->last_block,
+                                range->gathered);
+
+    pthread_mutex_lock(&pool->mutex);
+    if (--pool->num_running == 0) pthread_cond_signal(&pool->done_cond);
+  }
+  pthread_mutex_unlock(&pool->mutex);
+  return NULL;
+}
+
+void CSRMatrix::split_blocks()
+{
+  _F_
+  // Split the blocks into ranges with about the same number of nonzeros.
+  int nt = pool->ranges.size();
+  unsigned int first = 0;
+  for (int t = 0; t < nt; t++) {
+    unsigned int last = num_blocks;
+    if (t < nt - 1) {
+      double target = (double) nnz * (t + 1) / nt;
+      unsigned int hi = num_blocks;
+      last = first;
+      while (last < hi) {
+        unsigned int mid = (last + hi) / 2;
+        int row = (block_ptr != NULL) ? block_ptr[mid] : mid;
+        if (Ap[row] < target) last = mid + 1;
+        else hi = mid;
+      }
+    }
+    MultiplyPool::Range& range = pool->ranges[t];
+    range.first_block = first;
+    range.last_block = last;
+    delete [] range.gathered;
+    range.gathered = NULL;
+    if (block_ptr != NULL) {
+      range.gathered = new scalar[std::max(max_row_length, 1)];
+      MEM_CHECK(range.gathered);
+    }
+    first = last;
+  }
+  pool->split_valid = true;
+}
+
+void CSRMatrix::free_pool()
+{
+  _F_
+  if (pool == NULL) return;
+  pthread_mutex_lock(&pool->mutex);
+  pool->shutdown = true;
+  pthread_cond_broadcast(&pool->start_cond);
+  pthread_mutex_unlock(&pool->mutex);
+  for (unsigned int t = 0; t < pool->threads.size(); t++)
+    pthread_join(pool->threads[t], NULL);
+  delete pool;
+  pool = NULL;
+}
+
+void CSRMatrix::multiply_with_vector(scalar* vector_in, scalar* vector_out)
+{
+  _F_
+  int nt = std::min(num_threads, (int) (nnz / HERMES_CSR_MIN_NNZ_PER_THREAD));
+  if (nt <= 1) {
+    multiply_blocks(vector_in, vector_out, 0, num_blocks, gathered);
+    return;
+  }
+
+  // The threads are started by the first product, and again if their number changes
+  // with the number of nonzeros.
+  if (pool != NULL && (int) pool->ranges.size() != nt) free_pool();
+  if (pool == NULL) {
+    pool = new MultiplyPool(nt);
+    for (int t = 0; t < nt; t++) {
+      pool->ranges[t].pool = pool;
+      pool->ranges[t].mat = this;
+    }
+    split_blocks();
+    for (int t = 1; t < nt; t++) {
+      pthread_t thread;
+      if (pthread_create(&thread, NULL, multiply_thread_run, &pool->ranges[t]) != 0)
+        error("Failed to create a thread in CSRMatrix::multiply_with_vector().");
+      pool->threads.push_back(thread);
+    }
+  }
+  if (!pool->split_valid) split_blocks();
+
+  pthread_mutex_lock(&pool->mutex);
+  pool->vector_in = vector_in;
+  pool->vector_out = vector_out;
+  pool->num_running = nt - 1;
+  pool->generation++;
+  pthread_cond_broadcast(&pool->start_cond);
+  pthread_mutex_unlock(&pool->mutex);
+
+  MultiplyPool::Range& range = pool->ranges[0];
+  multiply_blocks(vector_in, vector_out, range.first_block, range.last_block, range.gathered);
+
+  pthread_mutex_lock(&pool->mutex);
+  while (pool->num_running > 0)
+    pthread_cond_wait(&pool->done_cond, &pool->mutex);
+  pthread_mutex_unlock(&pool->mutex);
+}
+
+void CSRMatrix::multiply_with_scalar(scalar value)
+{
+  _F_
+  for (unsigned int i = 0; i < nnz; i++) Ax[i] *= value;
+}
+
+bool CSRMatrix::dump(FILE *file, const char *var_name, EMatrixDumpFormat fmt)
+{
+  _F_
+  switch (fmt)
+  {
+    case DF_MATLAB_SPARSE:
+      fprintf(file, "%% Size: %dx%d\n%% Nonzeros: %d\ntemp = zeros(%d, 3);\ntemp = [\n",
+              size, size, nnz, nnz);
+      for (unsigned int i = 0; i < size; i++)
+        for (int k = Ap[i]; k < Ap[i + 1]; k++)
+          fprintf(file, "%d %d " SCALAR_FMT "\n", i + 1, Aj[k] + 1, SCALAR(Ax[k]));
+      fprintf(file, "];\n%s = spconvert(temp);\n", var_name);
+      return true;
+
+    case DF_MATRIX_MARKET:
+    {
+      fprintf(file, "%%%%MatrixMarket matrix coordinate real symmetric\n");
+      int nnz_sym = 0;
+      for (int i = 0; i < (int) size; i++)
+        for (int k = Ap[i]; k < Ap[i + 1]; k++)
+          if (Aj[k] <= i) nnz_sym++;
+      fprintf(file, "%d %d %d\n", size, size, nnz_sym);
+      for (int i = 0; i < (int) size; i++)
+        for (int k = Ap[i]; k < Ap[i + 1]; k++)
+          if (Aj[k] <= i) fprintf(file, "%d %d " SCALAR_FMT "\n", i + 1, Aj[k] + 1, SCALAR(Ax[k]));
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+
+unsigned int CSRMatrix::get_matrix_size() const
+{
+  return size;
+}
+
+double CSRMatrix::get_fill_in() const
+{
+  _F_
+  return nnz / (double) (size * size);
+}
+
+int CSRMatrix::get_num_row_entries(unsigned int row)
+{
+  return Ap[row + 1] - Ap[row];
+}
+
+void CSRMatrix::create(unsigned int size, unsigned int nnz, int* ap, int* aj, scalar* ax)
+{
+  _F_
+  free();
+  this->size = size;
+  pattern_seq++;
+  this->nnz = nnz;
+  Ap = new int[size + 1];
+  Aj = new int[nnz];
+  Ax = new scalar[nnz];
+  MEM_CHECK(Ap);
+  MEM_CHECK(Aj);
+  MEM_CHECK(Ax);
+  memcpy(Ap, ap, sizeof(int) * (size + 1));
+  memcpy(Aj, aj, sizeof(int) * nnz);
+  memcpy(Ax, ax, sizeof(scalar) * nnz);
+  update_row_blocks();
+}
+
+void CSRMatrix::create_from_csc(CSCMatrix* mat)
+{
+  _F_
+  free();
+  size = mat->get_size();
+  pattern_seq++;
+  nnz = mat->get_nnz();
+  int* cp = mat->get_Ap();
+  int* ci = mat->get_Ai();
+  scalar* cx = mat->get_Ax();
+
+  // Count the entries of the rows, then distribute the columns in increasing order,
+  // which keeps the column indices of every row sorted.
+  Ap = new int[size + 1];
+  Aj = new int[nnz];
+  Ax = new scalar[nnz];
+  MEM_CHECK(Ap);
+  MEM_CHECK(Aj);
+  MEM_CHECK(Ax);
+  memset(Ap, 0, sizeof(int) * (size + 1));
+  for (unsigned int k = 0; k < nnz; k++) Ap[ci[k] + 1]++;
+  for (unsigned int i = 0; i < size; i++) Ap[i + 1] += Ap[i];
+
+  int* pos = new int[size];
+  MEM_CHECK(pos);
+  memcpy(pos, Ap, sizeof(int) * size);
+  for (unsigned int j = 0; j < size; j++)
+    for (int k = cp[j]; k < cp[j + 1]; k++) {
+      int p = pos[ci[k]]++;
+      Aj[p] = j;
+      Ax[p] = cx[k];
+    }
+  delete [] pos;
+  update_row_blocks();
+}
+
+CSRMatrix* CSRMatrix::duplicate()
+{
+  _F_
+  CSRMatrix* new_matrix = new CSRMatrix();
+  new_matrix->num_threads = num_threads;
+  new_matrix->use_row_blocks = use_row_blocks;
+  new_matrix->create(size, nnz, Ap, Aj, Ax);
+  return new_matrix;
+}
+
+
+// CSRVector ///////
+
+CSRVector::CSRVector()
+{
+  _F_
+  v = NULL;
+  size = 0;
+}
+
+CSRVector::CSRVector(unsigned int size)
+{
+  _F_
+  v = NULL;
+  this->size = size;
+  this->alloc(size);
+}
+
+CSRVector::~CSRVector()
+{
+  _F_
+  free();
+}
+
+void CSRVector::alloc(unsigned int n)
+{
+  _F_
+  free();
+  this->size = n;
+  v = new scalar[n];
+  MEM_CHECK(v);
+  this->zero();
+}
+
+void CSRVector::free()
+{
+  _F_
+  delete [] v;
+  v = NULL;
+  size = 0;
+}
+
+void CSRVector::zero()
+{
+  _F_
+  memset(v, 0, size * sizeof(scalar));
+}
+
+void CSRVector::change_sign()
+{
+  _F_
+  for (unsigned int i = 0; i < size; i++) v[i] = -v[i];
+}
+
+void CSRVector::set(unsigned int idx, scalar y)
+{
+  _F_
+  v[idx] = y;
+}
+
+void CSRVector::add(unsigned int idx, scalar y)
+{
+  _F_
+  v[idx] += y;
+}
+
+void CSRVector::add(unsigned int n, unsigned int *idx, scalar *y)
+{
+  _F_
+  for (unsigned int i = 0; i < n; i++)
+    v[idx[i]] += y[i];
+}
+
+void CSRVector::add_vector(Vector* vec)
+{
+  _F_
+  assert(this->length() == vec->length());
+  for (unsigned int i = 0; i < size; i++) v[i] += vec->get(i);
+}
+
+void CSRVector::add_vector(scalar* vec)
+{
+  _F_
+  for (unsigned int i = 0; i < size; i++) v[i] += vec[i];
+}
+
+bool CSRVector::dump(FILE *file, const char *var_name, EMatrixDumpFormat fmt)
+{
+  _F_
+  switch (fmt)
+  {
+    case DF_MATLAB_SPARSE:
+      fprintf(file, "%% Size: %dx1\n%s = [\n", size, var_name);
+      for (unsigned int i = 0; i < size; i++)
+        fprintf(file, SCALAR_FMT "\n", SCALAR(v[i]));
+      fprintf(file, " ];\n");
+      return true;
+
+    case DF_HERMES_BIN:
+    {
+      hermes_fwrite("HERMESR\001", 1, 8, file);
+      int ssize = sizeof(scalar);
+      hermes_fwrite(&ssize, sizeof(int), 1, file);
+      hermes_fwrite(&size, sizeof(int), 1, file);
+      hermes_fwrite(v, sizeof(scalar), size, file);
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
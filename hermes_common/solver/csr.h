@@ -0,0 +1,162 @@
+// This file is part of Hermes
+//
+// Hermes is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef __HERMES_COMMON_CSR_H_
+#define __HERMES_COMMON_CSR_H_
+
+#include "../matrix.h"
+
+class CSCMatrix;
+
+// Below this number of nonzeros per thread the product is computed by fewer threads.
+#define HERMES_CSR_MIN_NNZ_PER_THREAD 50000
+
+/// General CSR matrix (row-wise storage), meant for matrix-vector products, i.e. for
+/// iterative methods and residual evaluations.
+///
+/// multiply_with_vector() processes the rows independently, so it can be split between
+/// several threads (set_num_threads()). The threads are started by the first product and
+/// kept by the matrix, together with the split of the rows and the scratch buffers, until
+/// the number of threads changes. The inner loops are written so that the compiler can
+/// vectorize them.
+///
+/// Row blocks (set_row_blocks()): consecutive rows with identical column indices (the DOFs
+/// of one element interacting with the same neighbors, or the components of a system
+/// numbered node by node) are grouped. The product then gathers the entries of the input
+/// vector once per block and computes the rows of the block as dense dot products with
+/// unit stride. The values stay in the usual CSR order, so nothing is copied.
+class HERMES_API CSRMatrix : public SparseMatrix {
+public:
+  CSRMatrix();
+  CSRMatrix(unsigned int size);
+  virtual ~CSRMatrix();
+
+  /// The structure is registered transposed, so that the column-oriented SparsityPattern
+  /// produces the rows.
+  virtual void pre_add_ij(unsigned int row, unsigned int col);
+  virtual void pre_add_block(unsigned int n_rows, int* rows, unsigned int n_cols, int* cols);
+
+  virtual void alloc();
+  virtual void free();
+  virtual scalar get(unsigned int m, unsigned int n);
+  virtual void zero();
+  virtual void add(unsigned int m, unsigned int n, scalar v);
+  virtual void add_to_diagonal(scalar v);
+  virtual void add(unsigned int m, unsigned int n, scalar **mat, int *rows, int *cols);
+  virtual bool dump(FILE *file, const char *var_name, EMatrixDumpFormat fmt = DF_MATLAB_SPARSE);
+  virtual unsigned int get_matrix_size() const;
+  unsigned int get_nnz() { return this->nnz; }
+  virtual double get_fill_in() const;
+  virtual int get_num_row_entries(unsigned int row);
+
+  // Computes vector_out = A * vector_in.
+  virtual void multiply_with_vector(scalar* vector_in, scalar* vector_out);
+  // Multiplies matrix with a scalar.
+  virtual void multiply_with_scalar(scalar value);
+  // Creates matrix in CSR format using size, nnz, and the three arrays.
+  void create(unsigned int size, unsigned int nnz, int* ap, int* aj, scalar* ax);
+  // Creates matrix with the same entries as the given CSC matrix.
+  void create_from_csc(CSCMatrix* mat);
+  // Duplicates a matrix (including allocation).
+  virtual CSRMatrix* duplicate();
+
+  // Sets the number of threads used by multiply_with_vector(). Matrices with fewer than
+  // HERMES_CSR_MIN_NNZ_PER_THREAD nonzeros per thread use fewer threads.
+  void set_num_threads(int num_threads);
+  int get_num_threads() const { return num_threads; }
+
+  // Switches the row blocks on or off (default). The blocks are found when the structure
+  // is created.
+  void set_row_blocks(bool use);
+  // Number of row blocks (equal to the number of rows if the row blocks are off).
+  unsigned int get_num_row_blocks() const { return num_blocks; }
+  // Finds the row blocks (regardless of set_row_blocks()), returns the first rows of the blocks.
+  void find_row_blocks(std::vector<int>& first_rows) const;
+
+  // Exposes pointers to the CSR arrays.
+  int *get_Ap() {
+      return this->Ap;
+  }
+  int *get_Aj() {
+      return this->Aj;
+  }
+  scalar *get_Ax() {
+      return this->Ax;
+  }
+
+protected:
+  scalar *Ax;            // Matrix entries (row-wise).
+  int *Aj;               // Column indices of values in Ax, sorted in every row.
+  int *Ap;               // Index to Ax/Aj, where each row starts.
+  unsigned int nnz;      // Number of non-zero entries (= Ap[size]).
+
+  int num_threads;
+
+  // Row blocks: block b consists of the rows block_ptr[b], ..., block_ptr[b + 1] - 1.
+  bool use_row_blocks;
+  int *block_ptr;
+  unsigned int num_blocks;
+  int max_row_length;
+  // Scratch space for the gathered input vector (max_row_length entries, NULL without
+  // row blocks).
+  scalar *gathered;
+
+  void update_row_blocks();
+
+  // The threads of multiply_with_vector() and their work, NULL if not started.
+  struct MultiplyPool;
+  MultiplyPool *pool;
+  static void* multiply_thread_run(void* data);
+  // Splits the blocks between the threads of the pool (after the structure changed).
+  void split_blocks();
+  // Stops the threads.
+  void free_pool();
+
+  // Computes the rows of the blocks first_block, ..., last_block - 1 of the product,
+  // with the scratch space of max_row_length entries for the row blocks.
+  void multiply_blocks(scalar* vector_in, scalar* vector_out, unsigned int first_block, unsigned int last_block,
+                       scalar* scratch);
+};
+
+/// Vector to be used with CSRMatrix.
+class HERMES_API CSRVector : public Vector {
+public:
+  CSRVector();
+  CSRVector(unsigned int size);
+  virtual ~CSRVector();
+
+  virtual void alloc(unsigned int ndofs);
+  virtual void free();
+  virtual scalar get(unsigned int idx) { return v[idx]; }
+  virtual void extract(scalar *v) const { memcpy(v, this->v, size * sizeof(scalar)); }
+  virtual void zero();
+  virtual void change_sign();
+  virtual void set(unsigned int idx, scalar y);
+  virtual void add(unsigned int idx, scalar y);
+  virtual void add(unsigned int n, unsigned int *idx, scalar *y);
+  virtual void add_vector(Vector* vec);
+  virtual void add_vector(scalar* vec);
+  virtual bool dump(FILE *file, const char *var_name, EMatrixDumpFormat fmt = DF_MATLAB_SPARSE);
+
+  scalar *get_c_array() {
+      return this->v;
+  }
+
+protected:
+  scalar *v;
+};
+
+#endif
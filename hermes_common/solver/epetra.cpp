@@ -90,6 +90,21 @@ void EpetraMatrix::pre_add_ij(unsigned int row, unsigned int col)
 #endif
 }
 
+void EpetraMatrix::pre_add_block(unsigned int n_rows, int* rows, unsigned int n_cols, int* cols)
+{
+  _F_
+#ifdef HAVE_EPETRA
+  int* valid_cols = new int[n_cols];
+  int n_valid = 0;
+  for (unsigned int j = 0; j < n_cols; j++)
+    if (cols[j] >= 0) valid_cols[n_valid++] = cols[j];
+  if (n_valid > 0)
+    for (unsigned int i = 0; i < n_rows; i++)
+      if (rows[i] >= 0) grph->InsertGlobalIndices(rows[i], n_valid, valid_cols);
+  delete [] valid_cols;
+#endif
+}
+
 void EpetraMatrix::finish()
 {
   _F_
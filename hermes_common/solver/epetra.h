@@ -46,6 +46,7 @@ public:
 
   virtual void prealloc(unsigned int n);
   virtual void pre_add_ij(unsigned int row, unsigned int col);
+  virtual void pre_add_block(unsigned int n_rows, int* rows, unsigned int n_cols, int* cols);
   virtual void finish();
 
   virtual void alloc();
@@ -0,0 +1,462 @@
+// This file is part of Hermes
+//
+// Hermes is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "krylov.h"
+#include "umfpack_solver.h"
+
+#include "../error.h"
+#include "../callstack.h"
+
+// (x, y) = sum conj(x_i) y_i
+static scalar dot(scalar *x, scalar *y, int n)
+{
+  scalar s = 0.0;
+  for (int i = 0; i < n; i++) s += conj(x[i]) * y[i];
+  return s;
+}
+
+static double norm(scalar *x, int n)
+{
+  double s = 0.0;
+  for (int i = 0; i < n; i++) s += REAL(conj(x[i]) * x[i]);
+  return sqrt(s);
+}
+
+// y += alpha x
+static void axpy(scalar alpha, scalar *x, scalar *y, int n)
+{
+  for (int i = 0; i < n; i++) y[i] += alpha * x[i];
+}
+
+// z = M^{-1} r, or z = r without a preconditioner.
+static void apply_precond(NativePrecond *pc, scalar *r, scalar *z, int n)
+{
+  if (pc != NULL) pc->apply(r, z);
+  else memcpy(z, r, sizeof(scalar) * n);
+}
+
+// r = b - A x, returns ||r||.
+static double op_residual(LinearOperator *a, scalar *b, scalar *x, scalar *r)
+{
+  int n = a->get_size();
+  a->multiply_with_vector(x, r);
+  for (int i = 0; i < n; i++) r[i] = b[i] - r[i];
+  return norm(r, n);
+}
+
+// GMRES ///////
+
+bool gmres(LinearOperator *a, NativePrecond *pc, scalar *b, scalar *x, int restart,
+           double tolerance, int max_iters, int &num_iters, double &residual)
+{
+  _F_
+  int n = a->get_size();
+  int mr = restart;
+  double b_norm = norm(b, n);
+  if (b_norm == 0.0) b_norm = 1.0;
+
+  scalar **v = new_matrix<scalar>(mr + 1, n);   // Krylov basis
+  scalar **h = new_matrix<scalar>(mr + 1, mr);  // Hessenberg matrix, reduced to triangular
+  double *cs = new double[mr];                  // Givens rotations
+  scalar *sn = new scalar[mr];
+  scalar *g = new scalar[mr + 1];
+  scalar *y = new scalar[mr];
+  scalar *w = new scalar[n];
+  MEM_CHECK(cs);
+  MEM_CHECK(sn);
+  MEM_CHECK(g);
+  MEM_CHECK(y);
+  MEM_CHECK(w);
+
+  num_iters = 0;
+  double beta = op_residual(a, b, x, v[0]);
+  residual = beta / b_norm;
+
+  while (residual > tolerance && num_iters < max_iters) {
+    for (int i = 0; i < n; i++) v[0][i] /= beta;
+    memset(g, 0, sizeof(scalar) * (mr + 1));
+    g[0] = beta;
+
+    int k = 0;
+    while (k < mr && num_iters < max_iters) {
+      // v_{k+1} = A M^{-1} v_k, orthogonalized against v_0, ..., v_k.
+      apply_precond(pc, v[k], w, n);
+      a->multiply_with_vector(w, v[k + 1]);
+      for (int i = 0; i <= k; i++) {
+        h[i][k] = dot(v[i], v[k + 1], n);
+        axpy(-h[i][k], v[i], v[k + 1], n);
+      }
+      double h_norm = norm(v[k + 1], n);
+      h[k + 1][k] = h_norm;
+      if (h_norm != 0.0)
+        for (int i = 0; i < n; i++) v[k + 1][i] /= h_norm;
+
+      // Apply the previous rotations to the new column and compute a new one.
+      for (int i = 0; i < k; i++) {
+        scalar t = cs[i] * h[i][k] + sn[i] * h[i + 1][k];
+        h[i + 1][k] = -conj(sn[i]) * h[i][k] + cs[i] * h[i + 1][k];
+        h[i][k] = t;
+      }
+      double abs_a = std::abs(h[k][k]), abs_b = std::abs(h[k + 1][k]);
+      if (abs_b == 0.0) { cs[k] = 1.0; sn[k] = 0.0; }
+      else if (abs_a == 0.0) { cs[k] = 0.0; sn[k] = 1.0; }
+      else {
+        double t = sqrt(abs_a * abs_a + abs_b * abs_b);
+        cs[k] = abs_a / t;
+        sn[k] = (h[k][k] / abs_a) * conj(h[k + 1][k]) / t;
+      }
+      h[k][k] = cs[k] * h[k][k] + sn[k] * h[k + 1][k];
+      h[k + 1][k] = 0.0;
+      g[k + 1] = -conj(sn[k]) * g[k];
+      g[k] = cs[k] * g[k];
+
+      k++;
+      num_iters++;
+      residual = std::abs(g[k]) / b_norm;
+      if (residual <= tolerance || h_norm == 0.0) break;
+    }
+
+    // x += M^{-1} V y, where H y = g.
+    for (int i = k - 1; i >= 0; i--) {
+      y[i] = g[i];
+      for (int j = i + 1; j < k; j++) y[i] -= h[i][j] * y[j];
+      y[i] /= h[i][i];
+    }
+    memset(v[mr], 0, sizeof(scalar) * n);
+    for (int i = 0; i < k; i++) axpy(y[i], v[i], v[mr], n);
+    apply_precond(pc, v[mr], w, n);
+    axpy(1.0, w, x, n);
+
+    // The true residual (also the start of the next cycle).
+    beta = op_residual(a, b, x, v[0]);
+    residual = beta / b_norm;
+    if (beta == 0.0) break;
+  }
+
+  delete [] v;
+  delete [] h;
+  delete [] cs;
+  delete [] sn;
+  delete [] g;
+  delete [] y;
+  delete [] w;
+  return residual <= tolerance;
+}
+
+// KrylovSolver ///////
+
+KrylovSolver::KrylovSolver(SparseMatrix *m, Vector *rhs) : IterSolver(), m(m), rhs(rhs)
+{
+  _F_
+  pc = NULL;
+  own_pc = false;
+  reuse_scheme = HERMES_FACTORIZE_FROM_SCRATCH;
+  x0 = NULL;
+  num_iters = 0;
+  residual = -1.0;
+}
+
+KrylovSolver::~KrylovSolver()
+{
+  _F_
+  free_precond();
+  delete [] x0;
+}
+
+void KrylovSolver::free_precond()
+{
+  _F_
+  if (own_pc) delete pc;
+  pc = NULL;
+  own_pc = false;
+#ifdef HAVE_TEUCHOS
+  pc_rcp = Teuchos::null;
+#endif
+  precond_yes = false;
+}
+
+void KrylovSolver::set_precond(const char *name)
+{
+  _F_
+  free_precond();
+  pc = create_native_precond(name);
+  own_pc = true;
+  precond_yes = (pc != NULL);
+}
+
+#ifdef HAVE_TEUCHOS
+void KrylovSolver::set_precond(Teuchos::RCP<Precond> &pc)
+{
+  _F_
+  free_precond();
+  this->pc = dynamic_cast<NativePrecond *>(pc.get());
+  if (this->pc == NULL) error("KrylovSolver can use native preconditioners (NativePrecond) only.");
+  pc_rcp = pc;
+  precond_yes = true;
+}
+#else
+void KrylovSolver::set_precond(Precond *pc)
+{
+  _F_
+  free_precond();
+  this->pc = dynamic_cast<NativePrecond *>(pc);
+  if (pc != NULL && this->pc == NULL) error("KrylovSolver can use native preconditioners (NativePrecond) only.");
+  precond_yes = (this->pc != NULL);
+}
+#endif
+
+void KrylovSolver::set_initial_guess(scalar *x0)
+{
+  _F_
+  delete [] this->x0;
+  this->x0 = NULL;
+  if (x0 == NULL) return;
+  this->x0 = new scalar[m->get_size()];
+  MEM_CHECK(this->x0);
+  memcpy(this->x0, x0, sizeof(scalar) * m->get_size());
+}
+
+void KrylovSolver::precondition(scalar *r, scalar *z)
+{
+  if (pc != NULL) pc->apply(r, z);
+  else memcpy(z, r, sizeof(scalar) * m->get_size());
+}
+
+double KrylovSolver::calc_residual(CSRMatrix *a, scalar *b, scalar *x, scalar *r)
+{
+  int n = a->get_size();
+  a->multiply_with_vector(x, r);
+  for (int i = 0; i < n; i++) r[i] = b[i] - r[i];
+  return norm(r, n);
+}
+
+bool KrylovSolver::solve()
+{
+  _F_
+  assert(m != NULL);
+  assert(rhs != NULL);
+  assert(m->get_size() == rhs->length());
+
+  TimePeriod tmr;
+
+  CSRMatrix *a = dynamic_cast<CSRMatrix *>(m);
+  if (a == NULL) {
+    CSCMatrix *csc = dynamic_cast<CSCMatrix *>(m);
+    if (csc == NULL) error("KrylovSolver can solve systems with CSRMatrix or CSCMatrix only.");
+    csr_copy.create_from_csc(csc);
+    a = &csr_copy;
+  }
+  int n = a->get_size();
+
+  if (pc != NULL && !(reuse_scheme == HERMES_REUSE_FACTORIZATION_COMPLETELY && pc->is_computed())) {
+    pc->create(a);
+    pc->compute();
+  }
+
+  scalar *b = new scalar[n];
+  MEM_CHECK(b);
+  rhs->extract(b);
+
+  delete [] sln;
+  sln = new scalar[n];
+  MEM_CHECK(sln);
+  if (x0 != NULL) memcpy(sln, x0, sizeof(scalar) * n);
+  else memset(sln, 0, sizeof(scalar) * n);
+
+  bool converged = iterate(a, b, sln);
+  delete [] b;
+
+  tmr.tick();
+  time = tmr.accumulated();
+
+  if (converged) {
+    verbose("KrylovSolver: converged in %d iterations, relative residual %g.", num_iters, residual);
+  }
+  else {
+    warn("KrylovSolver: not converged in %d iterations, relative residual %g.", num_iters, residual);
+  }
+  return converged;
+}
+
+// CGSolver ///////
+
+bool CGSolver::iterate(CSRMatrix *a, scalar *b, scalar *x)
+{
+  _F_
+  int n = a->get_size();
+  double b_norm = norm(b, n);
+  if (b_norm == 0.0) b_norm = 1.0;
+
+  scalar *r = new scalar[n];
+  scalar *z = new scalar[n];
+  scalar *p = new scalar[n];
+  scalar *q = new scalar[n];
+  MEM_CHECK(r);
+  MEM_CHECK(z);
+  MEM_CHECK(p);
+  MEM_CHECK(q);
+
+  num_iters = 0;
+  residual = calc_residual(a, b, x, r) / b_norm;
+  precondition(r, z);
+  memcpy(p, z, sizeof(scalar) * n);
+  scalar rz = dot(r, z, n);
+
+  while (residual > tolerance && num_iters < max_iters) {
+    a->multiply_with_vector(p, q);
+    scalar pq = dot(p, q, n);
+    if (pq == 0.0) break;
+    scalar alpha = rz / pq;
+    axpy(alpha, p, x, n);
+    axpy(-alpha, q, r, n);
+    num_iters++;
+    residual = norm(r, n) / b_norm;
+    if (residual <= tolerance) break;
+
+    precondition(r, z);
+    scalar rz_new = dot(r, z, n);
+    scalar beta = rz_new / rz;
+    rz = rz_new;
+    for (int i = 0; i < n; i++) p[i] = z[i] + beta * p[i];
+  }
+
+  delete [] r;
+  delete [] z;
+  delete [] p;
+  delete [] q;
+  return residual <= tolerance;
+}
+
+// GMRESSolver ///////
+
+GMRESSolver::GMRESSolver(SparseMatrix *m, Vector *rhs, int restart) : KrylovSolver(m, rhs)
+{
+  _F_
+  set_restart(restart);
+}
+
+void GMRESSolver::set_restart(int restart)
+{
+  _F_
+  if (restart < 1) error("Invalid restart in GMRESSolver::set_restart().");
+  this->restart = restart;
+}
+
+// The rows of a CSRMatrix as a LinearOperator.
+class CSROperator : public LinearOperator {
+public:
+  CSROperator(CSRMatrix *a) : a(a) { }
+  virtual int get_size() { return a->get_size(); }
+  virtual void multiply_with_vector(scalar *x, scalar *y) { a->multiply_with_vector(x, y); }
+
+protected:
+  CSRMatrix *a;
+};
+
+bool GMRESSolver::iterate(CSRMatrix *a, scalar *b, scalar *x)
+{
+  _F_
+  CSROperator op(a);
+  return gmres(&op, pc, b, x, restart, tolerance, max_iters, num_iters, residual);
+}
+
+// BiCGStabSolver ///////
+
+bool BiCGStabSolver::iterate(CSRMatrix *a, scalar *b, scalar *x)
+{
+  _F_
+  int n = a->get_size();
+  double b_norm = norm(b, n);
+  if (b_norm == 0.0) b_norm = 1.0;
+
+  scalar *r = new scalar[n];
+  scalar *r_hat = new scalar[n];
+  scalar *p = new scalar[n];
+  scalar *v = new scalar[n];
+  scalar *s = new scalar[n];
+  scalar *t = new scalar[n];
+  scalar *p_hat = new scalar[n];
+  scalar *s_hat = new scalar[n];
+  MEM_CHECK(r);
+  MEM_CHECK(r_hat);
+  MEM_CHECK(p);
+  MEM_CHECK(v);
+  MEM_CHECK(s);
+  MEM_CHECK(t);
+  MEM_CHECK(p_hat);
+  MEM_CHECK(s_hat);
+
+  num_iters = 0;
+  residual = calc_residual(a, b, x, r) / b_norm;
+  memcpy(r_hat, r, sizeof(scalar) * n);
+  memset(p, 0, sizeof(scalar) * n);
+  memset(v, 0, sizeof(scalar) * n);
+  scalar rho = 1.0, alpha = 1.0, omega = 1.0;
+
+  while (residual > tolerance && num_iters < max_iters) {
+    scalar rho_new = dot(r_hat, r, n);
+    if (rho_new == 0.0) {
+      warn("BiCGStabSolver: breakdown (rho = 0).");
+      break;
+    }
+    scalar beta = (rho_new / rho) * (alpha / omega);
+    rho = rho_new;
+    for (int i = 0; i < n; i++) p[i] = r[i] + beta * (p[i] - omega * v[i]);
+
+    precondition(p, p_hat);
+    a->multiply_with_vector(p_hat, v);
+    scalar rv = dot(r_hat, v, n);
+    if (rv == 0.0) {
+      warn("BiCGStabSolver: breakdown ((r_hat, v) = 0).");
+      break;
+    }
+    alpha = rho / rv;
+    for (int i = 0; i < n; i++) s[i] = r[i] - alpha * v[i];
+    num_iters++;
+
+    double s_norm = norm(s, n);
+    if (s_norm / b_norm <= tolerance) {
+      axpy(alpha, p_hat, x, n);
+      memcpy(r, s, sizeof(scalar) * n);
+      residual = s_norm / b_norm;
+      break;
+    }
+
+    precondition(s, s_hat);
+    a->multiply_with_vector(s_hat, t);
+    double tt = norm(t, n);
+    if (tt == 0.0) {
+      warn("BiCGStabSolver: breakdown (t = 0).");
+      break;
+    }
+    omega = dot(t, s, n) / (tt * tt);
+    axpy(alpha, p_hat, x, n);
+    axpy(omega, s_hat, x, n);
+    for (int i = 0; i < n; i++) r[i] = s[i] - omega * t[i];
+    residual = norm(r, n) / b_norm;
+    if (omega == 0.0) break;
+  }
+
+  delete [] r;
+  delete [] r_hat;
+  delete [] p;
+  delete [] v;
+  delete [] s;
+  delete [] t;
+  delete [] p_hat;
+  delete [] s_hat;
+  return residual <= tolerance;
+}
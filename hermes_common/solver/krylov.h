@@ -0,0 +1,153 @@
+// This file is part of Hermes
+//
+// Hermes is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef __HERMES_COMMON_KRYLOV_H_
+#define __HERMES_COMMON_KRYLOV_H_
+
+#include "solver.h"
+#include "csr.h"
+#include "precond_native.h"
+
+/// A linear operator given only by its action y = A x, e.g. a Jacobian approximated by
+/// differences of residuals (see gmres()).
+///
+/// @ingroup solvers
+class HERMES_API LinearOperator {
+public:
+  virtual ~LinearOperator() { }
+
+  virtual int get_size() = 0;
+  virtual void multiply_with_vector(scalar *x, scalar *y) = 0;
+};
+
+/// Restarted GMRES(restart) for A x = b with the right preconditioner pc (can be NULL),
+/// x contains the initial guess. Stops when the relative residual ||b - A x|| / ||b|| drops
+/// below the tolerance or after max_iters iterations (applications of A), sets num_iters
+/// and residual. Returns true if the tolerance has been reached. GMRESSolver uses it with
+/// a CSRMatrix.
+///
+/// @ingroup solvers
+HERMES_API bool gmres(LinearOperator *a, NativePrecond *pc, scalar *b, scalar *x, int restart,
+                      double tolerance, int max_iters, int &num_iters, double &residual);
+
+/// Krylov solvers which need no external library (CG, GMRES(m), BiCGStab).
+///
+/// The matrix has to be a CSRMatrix or a CSCMatrix (which is converted to rows at the
+/// beginning of every solve()), the right-hand side can be any Vector. The iterations stop
+/// when the residual relative to the right-hand side, ||b - A x|| / ||b||, drops below
+/// the tolerance, or after max_iters iterations. Preconditioners are applied from the right
+/// (GMRES, BiCGStab) or symmetrically (CG), so the residual is the one of the original
+/// system in all cases.
+///
+/// The preconditioner is created and computed in every solve(), unless the factorization
+/// scheme is HERMES_REUSE_FACTORIZATION_COMPLETELY and it has already been computed.
+///
+/// @ingroup solvers
+class HERMES_API KrylovSolver : public IterSolver {
+public:
+  KrylovSolver(SparseMatrix *m, Vector *rhs);
+  virtual ~KrylovSolver();
+
+  virtual bool solve();
+
+  virtual int get_num_iters() { return num_iters; }
+  /// Relative residual after the last solve().
+  virtual double get_residual() { return residual; }
+
+  /// Set a native preconditioner by name
+  /// @param[in] name - name of the preconditioner [ none | jacobi | block-jacobi | ilu0 | amg ]
+  virtual void set_precond(const char *name);
+
+  /// Set a native preconditioner (NativePrecond)
+#ifdef HAVE_TEUCHOS
+  virtual void set_precond(Teuchos::RCP<Precond> &pc);
+#else
+  virtual void set_precond(Precond *pc);
+#endif
+
+  virtual void set_factorization_scheme(FactorizationScheme reuse_scheme) { this->reuse_scheme = reuse_scheme; }
+
+  /// Start the iterations from the given vector (copied) instead of zero; NULL resets it.
+  void set_initial_guess(scalar *x0);
+
+protected:
+  SparseMatrix *m;
+  Vector *rhs;
+  CSRMatrix csr_copy;     ///< Rows of the matrix if it is a CSCMatrix.
+
+  NativePrecond *pc;
+  bool own_pc;            ///< pc has been created by set_precond(const char *).
+#ifdef HAVE_TEUCHOS
+  Teuchos::RCP<Precond> pc_rcp;
+#endif
+  FactorizationScheme reuse_scheme;
+  scalar *x0;
+
+  int num_iters;
+  double residual;
+
+  void free_precond();
+
+  /// Iterates for A x = b, x contains the initial guess. Sets num_iters and residual,
+  /// returns true if the tolerance has been reached.
+  virtual bool iterate(CSRMatrix *a, scalar *b, scalar *x) = 0;
+
+  /// z = M^{-1} r, or z = r without a preconditioner.
+  void precondition(scalar *r, scalar *z);
+  /// r = b - A x, returns ||r||.
+  double calc_residual(CSRMatrix *a, scalar *b, scalar *x, scalar *r);
+};
+
+/// Preconditioned conjugate gradients, for symmetric (Hermitian) positive definite matrices
+/// and preconditioners.
+///
+/// @ingroup solvers
+class HERMES_API CGSolver : public KrylovSolver {
+public:
+  CGSolver(SparseMatrix *m, Vector *rhs) : KrylovSolver(m, rhs) { }
+
+protected:
+  virtual bool iterate(CSRMatrix *a, scalar *b, scalar *x);
+};
+
+/// Restarted GMRES with modified Gram-Schmidt orthogonalization and Givens rotations.
+///
+/// @ingroup solvers
+class HERMES_API GMRESSolver : public KrylovSolver {
+public:
+  GMRESSolver(SparseMatrix *m, Vector *rhs, int restart = 30);
+
+  /// Set the number of iterations after which GMRES is restarted.
+  void set_restart(int restart);
+
+protected:
+  int restart;
+
+  virtual bool iterate(CSRMatrix *a, scalar *b, scalar *x);
+};
+
+/// Stabilized biconjugate gradients.
+///
+/// @ingroup solvers
+class HERMES_API BiCGStabSolver : public KrylovSolver {
+public:
+  BiCGStabSolver(SparseMatrix *m, Vector *rhs) : KrylovSolver(m, rhs) { }
+
+protected:
+  virtual bool iterate(CSRMatrix *a, scalar *b, scalar *x);
+};
+
+#endif
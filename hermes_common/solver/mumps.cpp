@@ -88,25 +88,14 @@ MumpsMatrix::~MumpsMatrix()
 void MumpsMatrix::alloc()
 {
   _F_
-  assert(pages != NULL);
-
-  // initialize the arrays Ap and Ai
+  // Initialize the arrays Ap and Ai.
+  int* col_ptr;
+  build_pattern(col_ptr, Ai);
   Ap = new unsigned int [size + 1];
   MEM_CHECK(Ap);
-  int aisize = get_num_indices();
-  Ai = new int [aisize];
-  MEM_CHECK(Ai);
-
-  // sort the indices and remove duplicities, insert into Ai
-  unsigned int i, pos = 0;
-  for (i = 0; i < size; i++) {
-    Ap[i] = pos;
-    pos += sort_and_store_indices(pages[i], Ai + pos, Ai + aisize);
-  }
-  Ap[i] = pos;
-
-  delete [] pages;
-  pages = NULL;
+  for (unsigned int i = 0; i <= size; i++)
+    Ap[i] = col_ptr[i];
+  delete [] col_ptr;
 
   nnz = Ap[size];
 
@@ -339,6 +328,7 @@ void MumpsMatrix::multiply_with_scalar(scalar value){
 void MumpsMatrix::create(unsigned int size, unsigned int nnz, int* ap, int* ai, scalar* ax){
   this->nnz = nnz;
   this->size = size;
+  pattern_seq++;
   this->Ap = new unsigned int[size+1]; assert(this->Ap != NULL);
   this->Ai = new int[nnz];    assert(this->Ai != NULL);
   this->Ax = new mumps_scalar[nnz]; assert(this->Ax != NULL);
@@ -576,7 +566,7 @@ bool MumpsSolver::reinit()
 #endif
 
 MumpsSolver::MumpsSolver(MumpsMatrix *m, MumpsVector *rhs) :
-  LinearSolver(), m(m), rhs(rhs)
+  LinearSolver(), m(m), rhs(rhs), eff_fact_scheme(HERMES_FACTORIZE_FROM_SCRATCH)
 {
   _F_
 #ifdef WITH_MUMPS
@@ -637,6 +627,7 @@ bool MumpsSolver::solve()
 
   if (ret) 
   {
+    count_factorization(eff_fact_scheme);
     delete [] sln;
     sln = new scalar[m->size];
 #ifndef HERMES_COMMON_COMPLEX
@@ -654,6 +645,9 @@ bool MumpsSolver::solve()
   delete [] param.rhs;
   param.rhs = NULL;
 
+  if (!ret)
+    reset_factorization_reuse();
+
   return ret;
 #else
   return false;
@@ -664,12 +658,14 @@ bool MumpsSolver::setup_factorization()
 {
   _F_
 #ifdef WITH_MUMPS
+  // Reuse the reordering of the last factorization if the pattern of the matrix allows.
+  eff_fact_scheme = get_factorization_scheme(m->get_pattern_seq(), m->nnz, m->irn, m->nnz, m->jcn);
+
   // When called for the first time, all three phases (analysis, factorization,
   // solution) must be performed. 
-  int eff_fact_scheme = factorization_scheme;
   if (!inited)
-    if( factorization_scheme == HERMES_REUSE_MATRIX_REORDERING || 
-        factorization_scheme == HERMES_REUSE_FACTORIZATION_COMPLETELY )
+    if( eff_fact_scheme == HERMES_REUSE_MATRIX_REORDERING || 
+        eff_fact_scheme == HERMES_REUSE_FACTORIZATION_COMPLETELY )
       eff_fact_scheme = HERMES_FACTORIZE_FROM_SCRATCH;
   
   switch (eff_fact_scheme)
@@ -713,6 +709,13 @@ bool MumpsSolver::setup_factorization()
       param.job = JOB_SOLVE;
       break;
   }
+
+  // The matrix may have been recreated with the same pattern.
+  param.n = m->size;
+  param.nz = m->nnz;
+  param.irn = m->irn;
+  param.jcn = m->jcn;
+  param.a = m->Ax;
   
   return true;
 #else
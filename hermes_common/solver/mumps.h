@@ -147,6 +147,7 @@ protected:
   MumpsVector *rhs;
   
   bool setup_factorization();
+  unsigned int eff_fact_scheme;   // Factorization scheme of the current solution.
 
 #ifdef WITH_MUMPS
   MUMPS_STRUCT  param;
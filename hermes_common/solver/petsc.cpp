@@ -104,26 +104,18 @@ PetscMatrix::~PetscMatrix() {
 void PetscMatrix::alloc() {
   _F_
 #ifdef WITH_PETSC
-  assert(pages != NULL);
-
   // calc nnz
   int *nnz_array = new int[size];
   MEM_CHECK(nnz_array);
 
   // fill in nnz_array
-  int aisize = get_num_indices();
-  int *ai = new int[aisize];
-  MEM_CHECK(ai);
-
-  // sort the indices and remove duplicities, insert into ai
-  int pos = 0;
-  for (unsigned int i = 0; i < size; i++) {
-    nnz_array[i] = sort_and_store_indices(pages[i], ai + pos, ai + aisize);
-    pos += nnz_array[i];
-  }
+  int *ap, *ai;
+  build_pattern(ap, ai);
+  for (unsigned int i = 0; i < size; i++)
+    nnz_array[i] = ap[i + 1] - ap[i];
   // stote the number of nonzeros
-  nnz = pos;
-  delete [] pages; pages = NULL;
+  nnz = ap[size];
+  delete [] ap;
   delete [] ai;
 
   //
@@ -267,6 +259,7 @@ void PetscMatrix::multiply_with_scalar(scalar value){
 void PetscMatrix::create(unsigned int size, unsigned int nnz, int* ap, int* ai, scalar* ax){
   _F_
   this->size=size;
+  pattern_seq++;
   this->nnz=nnz;
   MatCreateSeqAIJWithArrays(PETSC_COMM_SELF,size,size,ap,ai,ax,&matrix);
 }
@@ -404,6 +397,7 @@ PetscLinearSolver::PetscLinearSolver(PetscMatrix *mat, PetscVector *rhs)
   _F_
 #ifdef WITH_PETSC
   add_petsc_object();
+  has_ksp = false;
 #else
   error(PETSC_NOT_COMPILED);
 #endif
@@ -412,6 +406,7 @@ PetscLinearSolver::PetscLinearSolver(PetscMatrix *mat, PetscVector *rhs)
 PetscLinearSolver::~PetscLinearSolver() {
   _F_
 #ifdef WITH_PETSC
+  if (has_ksp) KSPDestroy(ksp);
   remove_petsc_object();
 #endif
 }
@@ -423,19 +418,43 @@ bool PetscLinearSolver::solve() {
   assert(rhs != NULL);
 
   PetscErrorCode ec;
-  KSP ksp;
   Vec x;
 
   TimePeriod tmr;
 
-  KSPCreate(PETSC_COMM_WORLD, &ksp);
+  // PETSc matrices do not expose their structure, so the pattern is only checked
+  // by its sequence number; the factorization is reused completely only on request.
+  unsigned int eff_fact_scheme = get_factorization_scheme(m->get_pattern_seq(), 0, NULL, 0, NULL);
+  if (!has_ksp) {
+    KSPCreate(PETSC_COMM_WORLD, &ksp);
+    has_ksp = true;
+    eff_fact_scheme = HERMES_FACTORIZE_FROM_SCRATCH;
+  }
 
-  KSPSetOperators(ksp, m->matrix, m->matrix, DIFFERENT_NONZERO_PATTERN);
+  switch (eff_fact_scheme) {
+    case HERMES_FACTORIZE_FROM_SCRATCH:
+      KSPSetOperators(ksp, m->matrix, m->matrix, DIFFERENT_NONZERO_PATTERN);
+      break;
+    case HERMES_REUSE_MATRIX_REORDERING:
+    case HERMES_REUSE_MATRIX_REORDERING_AND_SCALING:
+      KSPSetOperators(ksp, m->matrix, m->matrix, SAME_NONZERO_PATTERN);
+      break;
+    case HERMES_REUSE_FACTORIZATION_COMPLETELY:
+      KSPSetOperators(ksp, m->matrix, m->matrix, SAME_PRECONDITIONER);
+      break;
+  }
   KSPSetFromOptions(ksp);
   VecDuplicate(rhs->vec, &x);
 
   ec = KSPSolve(ksp, rhs->vec, x);
-  if (ec) return false;
+  if (ec) {
+    KSPDestroy(ksp);
+    has_ksp = false;
+    VecDestroy(x);
+    reset_factorization_reuse();
+    return false;
+  }
+  count_factorization(eff_fact_scheme);
 
   tmr.tick();
   time = tmr.accumulated();
@@ -455,7 +474,6 @@ bool PetscLinearSolver::solve() {
   VecGetValues(x, m->size, idx, (PetscScalar *) sln);
   delete [] idx;
 
-  KSPDestroy(ksp);
   VecDestroy(x);
 
   return true;
@@ -124,6 +124,13 @@ public:
 protected:
   PetscMatrix *m;
   PetscVector *rhs;
+
+#ifdef WITH_PETSC
+  /// The solver context is kept between the solutions, so that PETSc can reuse
+  /// the preconditioner (factorization) if the pattern or the matrix is the same.
+  KSP ksp;
+  bool has_ksp;
+#endif
 };
 
 #endif
@@ -0,0 +1,593 @@
+// This file is part of Hermes
+//
+// Hermes is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "precond_amg.h"
+
+#include "../error.h"
+#include "../callstack.h"
+
+#include <algorithm>
+
+// Number of power iterations for the estimate of rho(D^{-1} A).
+#define AMG_POWER_ITERATIONS  15
+
+// Sparse matrix product C = A B (A: rows x inner, B: inner x cols, all CSR). With
+// new_structure, the structure of C is computed and C is allocated, otherwise only the
+// values are computed in the existing structure.
+static void sparse_product(int rows, int cols, int *Ap, int *Aj, scalar *Ax, int *Bp, int *Bj, scalar *Bx,
+                           int *&Cp, int *&Cj, scalar *&Cx, bool new_structure)
+{
+  int *pos = new int[cols];
+  MEM_CHECK(pos);
+  memset(pos, 0xff, sizeof(int) * cols);
+
+  if (new_structure) {
+    Cp = new int[rows + 1];
+    MEM_CHECK(Cp);
+    Cp[0] = 0;
+    for (int i = 0; i < rows; i++) {
+      int count = 0;
+      for (int k = Ap[i]; k < Ap[i + 1]; k++)
+        for (int l = Bp[Aj[k]]; l < Bp[Aj[k] + 1]; l++)
+          if (pos[Bj[l]] != i) {
+            pos[Bj[l]] = i;
+            count++;
+          }
+      Cp[i + 1] = Cp[i] + count;
+    }
+    Cj = new int[Cp[rows]];
+    Cx = new scalar[Cp[rows]];
+    MEM_CHECK(Cj);
+    MEM_CHECK(Cx);
+    memset(pos, 0xff, sizeof(int) * cols);
+    for (int i = 0; i < rows; i++) {
+      int c = Cp[i];
+      for (int k = Ap[i]; k < Ap[i + 1]; k++)
+        for (int l = Bp[Aj[k]]; l < Bp[Aj[k] + 1]; l++)
+          if (pos[Bj[l]] != i) {
+            pos[Bj[l]] = i;
+            Cj[c++] = Bj[l];
+          }
+      std::sort(Cj + Cp[i], Cj + Cp[i + 1]);
+    }
+    memset(pos, 0xff, sizeof(int) * cols);
+  }
+
+  for (int i = 0; i < rows; i++) {
+    for (int c = Cp[i]; c < Cp[i + 1]; c++) {
+      pos[Cj[c]] = c;
+      Cx[c] = 0.0;
+    }
+    for (int k = Ap[i]; k < Ap[i + 1]; k++)
+      for (int l = Bp[Aj[k]]; l < Bp[Aj[k] + 1]; l++)
+        Cx[pos[Bj[l]]] += Ax[k] * Bx[l];
+    for (int c = Cp[i]; c < Cp[i + 1]; c++)
+      pos[Cj[c]] = -1;
+  }
+  delete [] pos;
+}
+
+// Conjugate transpose T = A^H of the CSR matrix A (rows x cols). Tp, Tj, Tx are allocated
+// by the caller.
+static void conj_transpose(int rows, int cols, int *Ap, int *Aj, scalar *Ax, int *Tp, int *Tj, scalar *Tx)
+{
+  memset(Tp, 0, sizeof(int) * (cols + 1));
+  for (int k = 0; k < Ap[rows]; k++) Tp[Aj[k] + 1]++;
+  for (int j = 0; j < cols; j++) Tp[j + 1] += Tp[j];
+  int *next = new int[cols];
+  MEM_CHECK(next);
+  memcpy(next, Tp, sizeof(int) * cols);
+  for (int i = 0; i < rows; i++)
+    for (int k = Ap[i]; k < Ap[i + 1]; k++) {
+      int t = next[Aj[k]]++;
+      Tj[t] = i;
+      Tx[t] = conj(Ax[k]);
+    }
+  delete [] next;
+}
+
+AMGPrecond::AMGPrecond() : NativePrecond()
+{
+  _F_
+  coarse_solver = NULL;
+  theta = 0.08;
+  max_levels = 10;
+  coarse_size = 300;
+  smoother = AMG_SMOOTHER_GAUSS_SEIDEL;
+  pre_sweeps = post_sweeps = 1;
+  jacobi_damping = 4.0 / 3.0;
+  gamma = 1;
+  setup_reuse = true;
+  null_space = NULL;
+  null_space_size = 0;
+  fine_Ap = fine_Aj = NULL;
+  fine_size = fine_nnz = 0;
+}
+
+AMGPrecond::~AMGPrecond()
+{
+  _F_
+  destroy();
+  delete [] null_space;
+}
+
+void AMGPrecond::set_max_levels(int max_levels)
+{
+  _F_
+  if (max_levels < 1) error("AMGPrecond: invalid maximum number of levels.");
+  this->max_levels = max_levels;
+}
+
+void AMGPrecond::set_coarse_size(int coarse_size)
+{
+  _F_
+  if (coarse_size < 1) error("AMGPrecond: invalid coarse size.");
+  this->coarse_size = coarse_size;
+}
+
+void AMGPrecond::set_smoother(AMGSmoother smoother, int pre_sweeps, int post_sweeps)
+{
+  _F_
+  if (pre_sweeps < 0 || post_sweeps < 0) error("AMGPrecond: invalid number of smoothing steps.");
+  this->smoother = smoother;
+  this->pre_sweeps = pre_sweeps;
+  this->post_sweeps = post_sweeps;
+}
+
+void AMGPrecond::set_cycle(int gamma)
+{
+  _F_
+  if (gamma < 1) error("AMGPrecond: invalid cycle.");
+  this->gamma = gamma;
+}
+
+void AMGPrecond::set_near_null_space(scalar *b)
+{
+  _F_
+  delete [] null_space;
+  null_space = NULL;
+  null_space_size = 0;
+  if (b != NULL) {
+    if (mat == NULL) error("AMGPrecond: create() has to be called before set_near_null_space().");
+    null_space_size = mat->get_size();
+    null_space = new scalar[null_space_size];
+    MEM_CHECK(null_space);
+    memcpy(null_space, b, sizeof(scalar) * null_space_size);
+  }
+  // The aggregates depend on the near null space.
+  free_levels();
+}
+
+void AMGPrecond::destroy()
+{
+  _F_
+  free_levels();
+  NativePrecond::destroy();
+}
+
+void AMGPrecond::free_levels()
+{
+  for (unsigned int l = 0; l < levels.size(); l++) {
+    Level &L = levels[l];
+    if (l > 0) delete L.A;
+    delete [] L.inv_diag;
+    delete [] L.aggregate;
+    delete [] L.tentative;
+    delete [] L.Pp; delete [] L.Pj; delete [] L.Px;
+    delete [] L.Rp; delete [] L.Rj; delete [] L.Rx;
+    delete [] L.APp; delete [] L.APj; delete [] L.APx;
+    if (l > 0) {
+      delete [] L.x;
+      delete [] L.b;
+    }
+    delete [] L.r;
+  }
+  levels.clear();
+  delete coarse_solver;
+  coarse_solver = NULL;
+  delete [] fine_Ap; fine_Ap = NULL;
+  delete [] fine_Aj; fine_Aj = NULL;
+  fine_size = fine_nnz = 0;
+}
+
+bool AMGPrecond::same_structure(CSRMatrix *a)
+{
+  return fine_Ap != NULL && fine_size == a->get_size() && fine_nnz == a->get_nnz()
+         && memcmp(fine_Ap, a->get_Ap(), sizeof(int) * (fine_size + 1)) == 0
+         && memcmp(fine_Aj, a->get_Aj(), sizeof(int) * fine_nnz) == 0;
+}
+
+double AMGPrecond::get_operator_complexity() const
+{
+  if (levels.empty()) return 0.0;
+  double nnz = 0.0;
+  for (unsigned int l = 0; l < levels.size(); l++) nnz += levels[l].A->get_nnz();
+  return nnz / levels[0].A->get_nnz();
+}
+
+void AMGPrecond::compute()
+{
+  _F_
+  CSRMatrix *a = get_rows();
+  unsigned int size = a->get_size();
+  if (null_space != NULL && null_space_size != size)
+    error("AMGPrecond: the near null space does not match the matrix.");
+
+  bool reuse = setup_reuse && same_structure(a);
+  if (reuse) {
+    // Only the values of the hierarchy change.
+    levels[0].A = a;
+    for (unsigned int l = 0; l < levels.size(); l++) {
+      compute_diagonal(l);
+      if (l + 1 < levels.size()) compute_level_values(l, false);
+    }
+  }
+  else {
+    free_levels();
+    fine_size = size;
+    fine_nnz = a->get_nnz();
+    fine_Ap = new int[fine_size + 1];
+    fine_Aj = new int[fine_nnz];
+    MEM_CHECK(fine_Ap);
+    MEM_CHECK(fine_Aj);
+    memcpy(fine_Ap, a->get_Ap(), sizeof(int) * (fine_size + 1));
+    memcpy(fine_Aj, a->get_Aj(), sizeof(int) * fine_nnz);
+
+    Level fine;
+    memset(&fine, 0, sizeof(Level));
+    fine.A = a;
+    fine.r = new scalar[size];
+    MEM_CHECK(fine.r);
+    levels.push_back(fine);
+
+    scalar *nns = new scalar[size];
+    MEM_CHECK(nns);
+    for (unsigned int i = 0; i < size; i++)
+      nns[i] = (null_space != NULL) ? null_space[i] : 1.0;
+
+    for (int l = 0; ; l++) {
+      compute_diagonal(l);
+      unsigned int n = levels[l].A->get_size();
+      if ((int) n <= coarse_size || l + 1 >= max_levels) break;
+      aggregate(l, nns);
+      int nc = levels[l].num_aggregates;
+      if (nc == 0 || nc >= (int) n) {
+        // No coarsening.
+        delete [] levels[l].aggregate;
+        levels[l].aggregate = NULL;
+        break;
+      }
+      scalar *coarse_nns;
+      setup_level(l, nns, coarse_nns);
+      delete [] nns;
+      nns = coarse_nns;
+    }
+    delete [] nns;
+  }
+
+  // The coarsest level.
+  CSRMatrix *coarsest = levels.back().A;
+  if ((int) coarsest->get_size() <= coarse_size) {
+    if (coarse_solver == NULL) coarse_solver = new BlockJacobiPrecond(coarsest->get_size());
+    coarse_solver->create(coarsest);
+    coarse_solver->compute();
+  }
+  else if (!reuse) {
+    warn("AMGPrecond: the coarsest level has %u rows, it is only smoothed.", coarsest->get_size());
+  }
+
+  computed = true;
+  verbose("AMGPrecond: %d levels, %u rows on the coarsest one, operator complexity %g%s.", (int) levels.size(),
+          coarsest->get_size(), get_operator_complexity(), reuse ? " (setup reused)" : "");
+}
+
+void AMGPrecond::compute_diagonal(int l)
+{
+  _F_
+  Level &L = levels[l];
+  int n = L.A->get_size();
+  int *Ap = L.A->get_Ap(), *Aj = L.A->get_Aj();
+  scalar *Ax = L.A->get_Ax();
+
+  if (L.inv_diag == NULL) {
+    L.inv_diag = new scalar[n];
+    MEM_CHECK(L.inv_diag);
+  }
+  // Gershgorin bound of rho(D^{-1} A).
+  double bound = 0.0;
+  for (int i = 0; i < n; i++) {
+    scalar d = 0.0;
+    double sum = 0.0;
+    for (int k = Ap[i]; k < Ap[i + 1]; k++) {
+      if (Aj[k] == i) d = Ax[k];
+      sum += std::abs(Ax[k]);
+    }
+    if (d == 0.0) error("AMGPrecond: zero diagonal entry in row %d of level %d.", i, l);
+    L.inv_diag[i] = 1.0 / d;
+    bound = std::max(bound, sum / std::abs(d));
+  }
+
+  // Power iterations, starting from a fixed vector.
+  scalar *v = new scalar[n];
+  scalar *w = new scalar[n];
+  MEM_CHECK(v);
+  MEM_CHECK(w);
+  for (int i = 0; i < n; i++) v[i] = 1.0 + (i % 7) / 7.0;
+  double rho = 0.0;
+  for (int it = 0; it < AMG_POWER_ITERATIONS; it++) {
+    double norm_v = 0.0, norm_w = 0.0;
+    L.A->multiply_with_vector(v, w);
+    for (int i = 0; i < n; i++) {
+      w[i] *= L.inv_diag[i];
+      norm_v += sqr(std::abs(v[i]));
+      norm_w += sqr(std::abs(w[i]));
+    }
+    if (norm_w == 0.0) break;
+    rho = sqrt(norm_w / norm_v);
+    double scale = 1.0 / sqrt(norm_w);
+    for (int i = 0; i < n; i++) v[i] = w[i] * scale;
+  }
+  delete [] v;
+  delete [] w;
+  L.rho = (rho > 0.0 && rho < bound) ? rho : bound;
+}
+
+// Is the connection a_ij (i != j) strong?
+static inline bool is_strong(scalar a_ij, double d_i, double d_j, double theta)
+{
+  return sqr(std::abs(a_ij)) >= sqr(theta) * d_i * d_j;
+}
+
+void AMGPrecond::aggregate(int l, scalar *nns)
+{
+  _F_
+  // Rows without strong connections and rows where the near null space vanishes are left
+  // out (they are handled by the smoother only), the others are aggregated in three phases:
+  // 1. rows whose strong neighbors are all free form aggregates with them,
+  // 2. the free rows join an aggregate of phase 1 of a strong neighbor,
+  // 3. the remaining rows form aggregates with their free strong neighbors.
+  const int FREE = -2, LEFT_OUT = -1;
+  Level &L = levels[l];
+  int n = L.A->get_size();
+  int *Ap = L.A->get_Ap(), *Aj = L.A->get_Aj();
+  scalar *Ax = L.A->get_Ax();
+
+  double *d = new double[n];
+  MEM_CHECK(d);
+  for (int i = 0; i < n; i++) d[i] = std::abs(1.0 / L.inv_diag[i]);
+
+  int *agg = new int[n];
+  MEM_CHECK(agg);
+  for (int i = 0; i < n; i++) {
+    agg[i] = LEFT_OUT;
+    if (nns[i] == 0.0) continue;
+    for (int k = Ap[i]; k < Ap[i + 1]; k++)
+      if (Aj[k] != i && nns[Aj[k]] != 0.0 && is_strong(Ax[k], d[i], d[Aj[k]], theta)) {
+        agg[i] = FREE;
+        break;
+      }
+  }
+
+  int nc = 0;
+  for (int i = 0; i < n; i++) {
+    if (agg[i] != FREE) continue;
+    bool all_free = true;
+    for (int k = Ap[i]; k < Ap[i + 1] && all_free; k++)
+      if (Aj[k] != i && agg[Aj[k]] >= 0 && is_strong(Ax[k], d[i], d[Aj[k]], theta)) all_free = false;
+    if (!all_free) continue;
+    agg[i] = nc;
+    for (int k = Ap[i]; k < Ap[i + 1]; k++)
+      if (Aj[k] != i && agg[Aj[k]] == FREE && is_strong(Ax[k], d[i], d[Aj[k]], theta)) agg[Aj[k]] = nc;
+    nc++;
+  }
+
+  // Phase 2 must not chain, the new members are stored separately.
+  std::vector<std::pair<int, int> > joins;
+  for (int i = 0; i < n; i++) {
+    if (agg[i] != FREE) continue;
+    double strongest = 0.0;
+    int best = -1;
+    for (int k = Ap[i]; k < Ap[i + 1]; k++)
+      if (Aj[k] != i && agg[Aj[k]] >= 0 && is_strong(Ax[k], d[i], d[Aj[k]], theta)
+          && std::abs(Ax[k]) > strongest) {
+        strongest = std::abs(Ax[k]);
+        best = agg[Aj[k]];
+      }
+    if (best >= 0) joins.push_back(std::pair<int, int>(i, best));
+  }
+  for (unsigned int j = 0; j < joins.size(); j++) agg[joins[j].first] = joins[j].second;
+
+  for (int i = 0; i < n; i++) {
+    if (agg[i] != FREE) continue;
+    agg[i] = nc;
+    for (int k = Ap[i]; k < Ap[i + 1]; k++)
+      if (Aj[k] != i && agg[Aj[k]] == FREE && is_strong(Ax[k], d[i], d[Aj[k]], theta)) agg[Aj[k]] = nc;
+    nc++;
+  }
+
+  delete [] d;
+  L.aggregate = agg;
+  L.num_aggregates = nc;
+}
+
+void AMGPrecond::setup_level(int l, scalar *nns, scalar *&coarse_nns)
+{
+  _F_
+  Level &L = levels[l];
+  int n = L.A->get_size(), nc = L.num_aggregates;
+
+  // Tentative prolongator: the near null space restricted to the aggregates and normalized,
+  // the norms are the near null space of the coarse level.
+  double *norm = new double[nc];
+  MEM_CHECK(norm);
+  memset(norm, 0, sizeof(double) * nc);
+  for (int i = 0; i < n; i++)
+    if (L.aggregate[i] >= 0) norm[L.aggregate[i]] += sqr(std::abs(nns[i]));
+  coarse_nns = new scalar[nc];
+  MEM_CHECK(coarse_nns);
+  for (int c = 0; c < nc; c++) coarse_nns[c] = norm[c] = sqrt(norm[c]);
+  L.tentative = new scalar[n];
+  MEM_CHECK(L.tentative);
+  for (int i = 0; i < n; i++)
+    L.tentative[i] = (L.aggregate[i] >= 0) ? nns[i] / norm[L.aggregate[i]] : 0.0;
+  delete [] norm;
+
+  // The coarse level.
+  Level coarse;
+  memset(&coarse, 0, sizeof(Level));
+  coarse.x = new scalar[nc];
+  coarse.b = new scalar[nc];
+  coarse.r = new scalar[nc];
+  MEM_CHECK(coarse.x);
+  MEM_CHECK(coarse.b);
+  MEM_CHECK(coarse.r);
+  levels.push_back(coarse);
+
+  compute_level_values(l, true);
+}
+
+void AMGPrecond::compute_level_values(int l, bool new_structure)
+{
+  _F_
+  Level &L = levels[l];
+  int n = L.A->get_size(), nc = L.num_aggregates;
+  int *Ap = L.A->get_Ap(), *Aj = L.A->get_Aj();
+  scalar *Ax = L.A->get_Ax();
+
+  // P = (I - omega D^{-1} A) T; the structure of P is that of A T, since the diagonal of A
+  // is nonzero.
+  int *Tp = new int[n + 1];
+  int *Tj = new int[n];
+  MEM_CHECK(Tp);
+  MEM_CHECK(Tj);
+  Tp[0] = 0;
+  for (int i = 0; i < n; i++) {
+    if (L.aggregate[i] >= 0) Tj[Tp[i]] = L.aggregate[i];
+    Tp[i + 1] = Tp[i] + (L.aggregate[i] >= 0 ? 1 : 0);
+  }
+  scalar *Tx = new scalar[Tp[n]];
+  MEM_CHECK(Tx);
+  for (int i = 0; i < n; i++)
+    if (L.aggregate[i] >= 0) Tx[Tp[i]] = L.tentative[i];
+
+  sparse_product(n, nc, Ap, Aj, Ax, Tp, Tj, Tx, L.Pp, L.Pj, L.Px, new_structure);
+  double omega = 4.0 / 3.0 / L.rho;
+  for (int i = 0; i < n; i++)
+    for (int k = L.Pp[i]; k < L.Pp[i + 1]; k++) {
+      L.Px[k] *= -omega * L.inv_diag[i];
+      if (L.Pj[k] == L.aggregate[i]) L.Px[k] += L.tentative[i];
+    }
+  delete [] Tp;
+  delete [] Tj;
+  delete [] Tx;
+
+  // R = P^H.
+  if (new_structure) {
+    L.Rp = new int[nc + 1];
+    L.Rj = new int[L.Pp[n]];
+    L.Rx = new scalar[L.Pp[n]];
+    MEM_CHECK(L.Rp);
+    MEM_CHECK(L.Rj);
+    MEM_CHECK(L.Rx);
+  }
+  conj_transpose(n, nc, L.Pp, L.Pj, L.Px, L.Rp, L.Rj, L.Rx);
+
+  // The coarse matrix R A P.
+  sparse_product(n, nc, Ap, Aj, Ax, L.Pp, L.Pj, L.Px, L.APp, L.APj, L.APx, new_structure);
+  Level &C = levels[l + 1];
+  if (new_structure) {
+    int *Cp, *Cj;
+    scalar *Cx;
+    sparse_product(nc, nc, L.Rp, L.Rj, L.Rx, L.APp, L.APj, L.APx, Cp, Cj, Cx, true);
+    C.A = new CSRMatrix;
+    C.A->set_num_threads(L.A->get_num_threads());
+    C.A->create(nc, Cp[nc], Cp, Cj, Cx);
+    delete [] Cp;
+    delete [] Cj;
+    delete [] Cx;
+  }
+  else {
+    int *Cp = C.A->get_Ap(), *Cj = C.A->get_Aj();
+    scalar *Cx = C.A->get_Ax();
+    sparse_product(nc, nc, L.Rp, L.Rj, L.Rx, L.APp, L.APj, L.APx, Cp, Cj, Cx, false);
+  }
+}
+
+void AMGPrecond::smooth(int l, scalar *b, scalar *x, int sweeps, bool forward)
+{
+  Level &L = levels[l];
+  int n = L.A->get_size();
+  int *Ap = L.A->get_Ap(), *Aj = L.A->get_Aj();
+  scalar *Ax = L.A->get_Ax();
+
+  for (int s = 0; s < sweeps; s++) {
+    if (smoother == AMG_SMOOTHER_JACOBI) {
+      double omega = jacobi_damping / L.rho;
+      L.A->multiply_with_vector(x, L.r);
+      for (int i = 0; i < n; i++)
+        x[i] += omega * L.inv_diag[i] * (b[i] - L.r[i]);
+    }
+    else {
+      for (int m = 0; m < n; m++) {
+        int i = forward ? m : n - 1 - m;
+        scalar res = b[i];
+        for (int k = Ap[i]; k < Ap[i + 1]; k++) res -= Ax[k] * x[Aj[k]];
+        x[i] += L.inv_diag[i] * res;
+      }
+    }
+  }
+}
+
+void AMGPrecond::cycle(int l, scalar *b, scalar *x)
+{
+  Level &L = levels[l];
+  if (l + 1 == (int) levels.size()) {
+    if (coarse_solver != NULL) coarse_solver->apply(b, x);
+    else smooth(l, b, x, pre_sweeps + post_sweeps, true);
+    return;
+  }
+
+  int n = L.A->get_size(), nc = L.num_aggregates;
+  Level &C = levels[l + 1];
+  smooth(l, b, x, pre_sweeps, true);
+
+  // Restriction of the residual.
+  L.A->multiply_with_vector(x, L.r);
+  for (int i = 0; i < n; i++) L.r[i] = b[i] - L.r[i];
+  for (int c = 0; c < nc; c++) {
+    scalar s = 0.0;
+    for (int k = L.Rp[c]; k < L.Rp[c + 1]; k++) s += L.Rx[k] * L.r[L.Rj[k]];
+    C.b[c] = s;
+  }
+
+  // Coarse grid correction.
+  memset(C.x, 0, sizeof(scalar) * nc);
+  for (int g = 0; g < gamma; g++) cycle(l + 1, C.b, C.x);
+  for (int i = 0; i < n; i++) {
+    scalar s = 0.0;
+    for (int k = L.Pp[i]; k < L.Pp[i + 1]; k++) s += L.Px[k] * C.x[L.Pj[k]];
+    x[i] += s;
+  }
+
+  smooth(l, b, x, post_sweeps, false);
+}
+
+void AMGPrecond::apply(scalar *r, scalar *z)
+{
+  if (levels.empty()) error("AMGPrecond: compute() has to be called before apply().");
+  memset(z, 0, sizeof(scalar) * levels[0].A->get_size());
+  cycle(0, r, z);
+}
@@ -0,0 +1,126 @@
+// This file is part of Hermes
+//
+// Hermes is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef __HERMES_COMMON_PRECOND_AMG_H_
+#define __HERMES_COMMON_PRECOND_AMG_H_
+
+#include "precond_native.h"
+
+/// Smoothers of AMGPrecond.
+enum AMGSmoother
+{
+  AMG_SMOOTHER_JACOBI,        ///< Damped Jacobi.
+  AMG_SMOOTHER_GAUSS_SEIDEL   ///< Gauss-Seidel, forward before and backward after the coarse grid
+                              ///< correction (symmetric, can be used with CG).
+};
+
+/// Smoothed aggregation algebraic multigrid preconditioner.
+///
+/// Setup: the rows are grouped into aggregates by the strong connections of the matrix
+/// (|a_ij| >= theta * sqrt(|a_ii a_jj|)), the tentative prolongator is the near null space
+/// vector (constant by default) restricted to the aggregates, and it is smoothed by one
+/// damped Jacobi step, P = (I - omega D^{-1} A) P_0, omega = 4/3 / rho(D^{-1} A). The coarse
+/// matrices are the Galerkin products P^H A P. Coarsening stops at coarse_size rows, the
+/// coarsest matrix is factorized by dense LU.
+///
+/// apply() performs one V-cycle (or W-cycle, see set_cycle()).
+///
+/// Setup reuse: if the structure of the matrix is the same as in the previous compute()
+/// (e.g. in Newton iterations or time steps), the aggregates and the structures of all the
+/// prolongators and coarse matrices are kept and only their values are recomputed.
+///
+/// @ingroup preconds
+class HERMES_API AMGPrecond : public NativePrecond {
+public:
+  AMGPrecond();
+  virtual ~AMGPrecond();
+
+  virtual void destroy();
+  virtual void compute();
+  virtual void apply(scalar *r, scalar *z);
+
+  /// Strength of connection threshold theta (default 0.08).
+  void set_strength_threshold(double theta) { this->theta = theta; }
+  /// Maximum number of levels including the finest one (default 10).
+  void set_max_levels(int max_levels);
+  /// Coarsening stops when a level has at most coarse_size rows (default 300).
+  void set_coarse_size(int coarse_size);
+  /// Smoother and numbers of smoothing steps before and after the coarse grid correction
+  /// (default Gauss-Seidel, 1, 1).
+  void set_smoother(AMGSmoother smoother, int pre_sweeps = 1, int post_sweeps = 1);
+  /// Damping of the Jacobi smoother relative to 1 / rho(D^{-1} A) (default 4/3).
+  void set_jacobi_damping(double damping) { this->jacobi_damping = damping; }
+  /// Number of coarse grid corrections on each level, 1 = V-cycle (default), 2 = W-cycle.
+  void set_cycle(int gamma);
+  /// Near null space vector of the fine matrix (copied), NULL = constant vector (default).
+  /// For hierarchic H1 bases it should be the vector of coefficients of the constant function.
+  void set_near_null_space(scalar *b);
+  /// Reuse the aggregates and the structures of the hierarchy if the structure of the matrix
+  /// has not changed (default true).
+  void set_setup_reuse(bool reuse) { this->setup_reuse = reuse; }
+
+  int get_num_levels() const { return levels.size(); }
+  /// Sum of the numbers of nonzeros of all levels divided by that of the finest level.
+  double get_operator_complexity() const;
+
+protected:
+  /// One level of the hierarchy. The matrix A of the next level is P^H A P.
+  struct Level
+  {
+    CSRMatrix *A;       ///< Matrix of the level (of the finest level not owned).
+    scalar *inv_diag;
+    double rho;         ///< Estimate of the spectral radius of D^{-1} A.
+    int *aggregate;     ///< Aggregate of every row, -1 for rows left out (see aggregate()).
+    int num_aggregates;
+    scalar *tentative;  ///< Tentative prolongator, row i has one entry in the column aggregate[i].
+    int *Pp, *Pj;       ///< Prolongator (rows x num_aggregates), CSR.
+    scalar *Px;
+    int *Rp, *Rj;       ///< Restriction P^H, CSR.
+    scalar *Rx;
+    int *APp, *APj;     ///< A P, CSR.
+    scalar *APx;
+    scalar *x, *b, *r;  ///< Work vectors (x, b of the coarser levels only).
+  };
+  std::vector<Level> levels;
+  BlockJacobiPrecond *coarse_solver;
+
+  double theta;
+  int max_levels;
+  int coarse_size;
+  AMGSmoother smoother;
+  int pre_sweeps, post_sweeps;
+  double jacobi_damping;
+  int gamma;
+  bool setup_reuse;
+  scalar *null_space;
+  unsigned int null_space_size;
+
+  int *fine_Ap, *fine_Aj;   ///< Structure of the finest matrix at the last compute().
+  unsigned int fine_size, fine_nnz;
+
+  void free_levels();
+  bool same_structure(CSRMatrix *a);
+
+  void setup_level(int l, scalar *nns, scalar *&coarse_nns);
+  void compute_level_values(int l, bool new_structure);
+  void compute_diagonal(int l);
+  void aggregate(int l, scalar *nns);
+
+  void smooth(int l, scalar *b, scalar *x, int sweeps, bool forward);
+  void cycle(int l, scalar *b, scalar *x);
+};
+
+#endif
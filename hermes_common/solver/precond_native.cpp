@@ -0,0 +1,405 @@
+// This file is part of Hermes
+//
+// Hermes is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "precond_native.h"
+#include "precond_amg.h"
+#include "umfpack_solver.h"
+
+#include "../error.h"
+#include "../callstack.h"
+
+// NativePrecond ///////
+
+#ifdef HAVE_EPETRA
+static Epetra_SerialComm native_precond_comm;
+#endif
+
+NativePrecond::NativePrecond()
+{
+  _F_
+  mat = NULL;
+  computed = false;
+#ifdef HAVE_EPETRA
+  epetra_map = NULL;
+#endif
+}
+
+NativePrecond::~NativePrecond()
+{
+  _F_
+#ifdef HAVE_EPETRA
+  delete epetra_map;
+#endif
+}
+
+void NativePrecond::create(Matrix *mat)
+{
+  _F_
+  if (dynamic_cast<CSRMatrix *>(mat) == NULL && dynamic_cast<CSCMatrix *>(mat) == NULL)
+    error("Native preconditioners can be used with CSRMatrix and CSCMatrix only.");
+  this->mat = mat;
+  computed = false;
+#ifdef HAVE_EPETRA
+  delete epetra_map;
+  epetra_map = new Epetra_Map(mat->get_size(), 0, native_precond_comm);
+  MEM_CHECK(epetra_map);
+#endif
+}
+
+void NativePrecond::destroy()
+{
+  _F_
+  csr_copy.free();
+  computed = false;
+}
+
+CSRMatrix *NativePrecond::get_rows()
+{
+  _F_
+  if (mat == NULL) error("NativePrecond: create() has to be called before compute().");
+  CSRMatrix *rows = dynamic_cast<CSRMatrix *>(mat);
+  if (rows != NULL) return rows;
+  csr_copy.create_from_csc(static_cast<CSCMatrix *>(mat));
+  return &csr_copy;
+}
+
+#ifdef HAVE_EPETRA
+int NativePrecond::ApplyInverse(const Epetra_MultiVector &r, Epetra_MultiVector &z) const
+{
+#ifndef HERMES_COMMON_COMPLEX
+  int n = r.MyLength();
+  scalar *tmp = new scalar[n];
+  MEM_CHECK(tmp);
+  for (int k = 0; k < r.NumVectors(); k++) {
+    // r and z may be the same vector.
+    memcpy(tmp, r[k], sizeof(scalar) * n);
+    const_cast<NativePrecond *>(this)->apply(tmp, z[k]);
+  }
+  delete [] tmp;
+  return 0;
+#else
+  return -1;
+#endif
+}
+
+const Epetra_Comm &NativePrecond::Comm() const
+{
+  return native_precond_comm;
+}
+
+const Epetra_Map &NativePrecond::OperatorDomainMap() const
+{
+  return *epetra_map;
+}
+
+const Epetra_Map &NativePrecond::OperatorRangeMap() const
+{
+  return *epetra_map;
+}
+#endif
+
+// JacobiPrecond ///////
+
+JacobiPrecond::JacobiPrecond() : NativePrecond()
+{
+  _F_
+  inv_diag = NULL;
+  size = 0;
+}
+
+JacobiPrecond::~JacobiPrecond()
+{
+  _F_
+  destroy();
+}
+
+void JacobiPrecond::destroy()
+{
+  _F_
+  delete [] inv_diag;
+  inv_diag = NULL;
+  size = 0;
+  NativePrecond::destroy();
+}
+
+void JacobiPrecond::compute()
+{
+  _F_
+  CSRMatrix *a = get_rows();
+  if (size != a->get_size()) {
+    delete [] inv_diag;
+    size = a->get_size();
+    inv_diag = new scalar[size];
+    MEM_CHECK(inv_diag);
+  }
+
+  int *Ap = a->get_Ap(), *Aj = a->get_Aj();
+  scalar *Ax = a->get_Ax();
+  for (unsigned int i = 0; i < size; i++) {
+    scalar d = 0.0;
+    for (int k = Ap[i]; k < Ap[i + 1]; k++)
+      if (Aj[k] == (int) i) d = Ax[k];
+    if (d == 0.0) error("JacobiPrecond: zero diagonal entry in row %d.", i);
+    inv_diag[i] = 1.0 / d;
+  }
+  computed = true;
+}
+
+void JacobiPrecond::apply(scalar *r, scalar *z)
+{
+  for (unsigned int i = 0; i < size; i++)
+    z[i] = inv_diag[i] * r[i];
+}
+
+// BlockJacobiPrecond ///////
+
+// LU factorization with partial pivoting of the dense n x n matrix a (row-major),
+// returns false for a singular matrix.
+static bool dense_lu(scalar *a, int n, int *piv)
+{
+  for (int k = 0; k < n; k++) {
+    int p = k;
+    for (int i = k + 1; i < n; i++)
+      if (std::abs(a[i * n + k]) > std::abs(a[p * n + k])) p = i;
+    piv[k] = p;
+    if (a[p * n + k] == 0.0) return false;
+    if (p != k)
+      for (int j = 0; j < n; j++) std::swap(a[k * n + j], a[p * n + j]);
+    for (int i = k + 1; i < n; i++) {
+      a[i * n + k] /= a[k * n + k];
+      for (int j = k + 1; j < n; j++)
+        a[i * n + j] -= a[i * n + k] * a[k * n + j];
+    }
+  }
+  return true;
+}
+
+// Solves LU x = P b in place.
+static void dense_lu_solve(scalar *lu, int n, int *piv, scalar *x)
+{
+  for (int k = 0; k < n; k++)
+    if (piv[k] != k) std::swap(x[k], x[piv[k]]);
+  for (int i = 1; i < n; i++)
+    for (int j = 0; j < i; j++)
+      x[i] -= lu[i * n + j] * x[j];
+  for (int i = n - 1; i >= 0; i--) {
+    for (int j = i + 1; j < n; j++)
+      x[i] -= lu[i * n + j] * x[j];
+    x[i] /= lu[i * n + i];
+  }
+}
+
+BlockJacobiPrecond::BlockJacobiPrecond(int block_size) : NativePrecond()
+{
+  _F_
+  if (block_size < 0) error("Invalid block size in BlockJacobiPrecond.");
+  this->block_size = block_size;
+  num_blocks = 0;
+  block_ptr = lu_ptr = pivots = NULL;
+  lu = NULL;
+}
+
+BlockJacobiPrecond::~BlockJacobiPrecond()
+{
+  _F_
+  destroy();
+}
+
+void BlockJacobiPrecond::destroy()
+{
+  _F_
+  free_blocks();
+  NativePrecond::destroy();
+}
+
+void BlockJacobiPrecond::free_blocks()
+{
+  delete [] block_ptr; block_ptr = NULL;
+  delete [] lu_ptr; lu_ptr = NULL;
+  delete [] pivots; pivots = NULL;
+  delete [] lu; lu = NULL;
+  num_blocks = 0;
+}
+
+void BlockJacobiPrecond::compute()
+{
+  _F_
+  CSRMatrix *a = get_rows();
+  unsigned int size = a->get_size();
+  int *Ap = a->get_Ap(), *Aj = a->get_Aj();
+  scalar *Ax = a->get_Ax();
+
+  // The blocks.
+  std::vector<int> first_rows;
+  if (block_size == 0)
+    a->find_row_blocks(first_rows);
+  else
+    for (unsigned int i = 0; i < size; i += block_size)
+      first_rows.push_back(i);
+
+  free_blocks();
+  num_blocks = first_rows.size();
+  block_ptr = new int[num_blocks + 1];
+  lu_ptr = new int[num_blocks + 1];
+  pivots = new int[size];
+  MEM_CHECK(block_ptr);
+  MEM_CHECK(lu_ptr);
+  MEM_CHECK(pivots);
+  lu_ptr[0] = 0;
+  for (unsigned int b = 0; b < num_blocks; b++) {
+    block_ptr[b] = first_rows[b];
+    int n = ((b + 1 < num_blocks) ? first_rows[b + 1] : size) - first_rows[b];
+    lu_ptr[b + 1] = lu_ptr[b] + n * n;
+  }
+  block_ptr[num_blocks] = size;
+  lu = new scalar[lu_ptr[num_blocks]];
+  MEM_CHECK(lu);
+  memset(lu, 0, sizeof(scalar) * lu_ptr[num_blocks]);
+
+  // Copy the diagonal blocks and factorize them.
+  for (unsigned int b = 0; b < num_blocks; b++) {
+    int first = block_ptr[b], n = block_ptr[b + 1] - first;
+    scalar *blk = lu + lu_ptr[b];
+    for (int i = 0; i < n; i++)
+      for (int k = Ap[first + i]; k < Ap[first + i + 1]; k++)
+        if (Aj[k] >= first && Aj[k] < first + n)
+          blk[i * n + Aj[k] - first] = Ax[k];
+    if (!dense_lu(blk, n, pivots + first))
+      error("BlockJacobiPrecond: singular diagonal block at row %d.", first);
+  }
+  computed = true;
+  verbose("BlockJacobiPrecond: %u blocks for %u rows.", num_blocks, size);
+}
+
+void BlockJacobiPrecond::apply(scalar *r, scalar *z)
+{
+  for (unsigned int b = 0; b < num_blocks; b++) {
+    int first = block_ptr[b], n = block_ptr[b + 1] - first;
+    memcpy(z + first, r + first, sizeof(scalar) * n);
+    dense_lu_solve(lu + lu_ptr[b], n, pivots + first, z + first);
+  }
+}
+
+// ILU0Precond ///////
+
+ILU0Precond::ILU0Precond() : NativePrecond()
+{
+  _F_
+  size = 0;
+  Ap = Aj = diag = NULL;
+  LU = NULL;
+}
+
+ILU0Precond::~ILU0Precond()
+{
+  _F_
+  destroy();
+}
+
+void ILU0Precond::destroy()
+{
+  _F_
+  free_factors();
+  NativePrecond::destroy();
+}
+
+void ILU0Precond::free_factors()
+{
+  delete [] Ap; Ap = NULL;
+  delete [] Aj; Aj = NULL;
+  delete [] LU; LU = NULL;
+  delete [] diag; diag = NULL;
+  size = 0;
+}
+
+void ILU0Precond::compute()
+{
+  _F_
+  CSRMatrix *a = get_rows();
+  unsigned int nnz = a->get_nnz();
+
+  // Copy the structure unless it is the same as the last time.
+  if (size != a->get_size() || Ap == NULL || Ap[size] != (int) nnz
+      || memcmp(Ap, a->get_Ap(), sizeof(int) * (size + 1)) != 0
+      || memcmp(Aj, a->get_Aj(), sizeof(int) * nnz) != 0) {
+    free_factors();
+    size = a->get_size();
+    Ap = new int[size + 1];
+    Aj = new int[nnz];
+    LU = new scalar[nnz];
+    diag = new int[size];
+    MEM_CHECK(Ap);
+    MEM_CHECK(Aj);
+    MEM_CHECK(LU);
+    MEM_CHECK(diag);
+    memcpy(Ap, a->get_Ap(), sizeof(int) * (size + 1));
+    memcpy(Aj, a->get_Aj(), sizeof(int) * nnz);
+    for (unsigned int i = 0; i < size; i++) {
+      diag[i] = -1;
+      for (int k = Ap[i]; k < Ap[i + 1]; k++)
+        if (Aj[k] == (int) i) diag[i] = k;
+      if (diag[i] < 0) error("ILU0Precond: missing diagonal entry in row %d.", i);
+    }
+  }
+  memcpy(LU, a->get_Ax(), sizeof(scalar) * nnz);
+
+  // Row-wise (IKJ) elimination restricted to the structure of the matrix.
+  int *pos = new int[size];
+  MEM_CHECK(pos);
+  memset(pos, 0xff, sizeof(int) * size);
+  for (unsigned int i = 0; i < size; i++) {
+    for (int k = Ap[i]; k < Ap[i + 1]; k++) pos[Aj[k]] = k;
+    for (int k = Ap[i]; k < diag[i]; k++) {
+      int row = Aj[k];
+      LU[k] /= LU[diag[row]];
+      for (int l = diag[row] + 1; l < Ap[row + 1]; l++)
+        if (pos[Aj[l]] >= 0)
+          LU[pos[Aj[l]]] -= LU[k] * LU[l];
+    }
+    for (int k = Ap[i]; k < Ap[i + 1]; k++) pos[Aj[k]] = -1;
+    if (LU[diag[i]] == 0.0) error("ILU0Precond: zero pivot in row %d.", i);
+  }
+  delete [] pos;
+  computed = true;
+}
+
+void ILU0Precond::apply(scalar *r, scalar *z)
+{
+  // L y = r (unit diagonal).
+  for (unsigned int i = 0; i < size; i++) {
+    scalar s = r[i];
+    for (int k = Ap[i]; k < diag[i]; k++) s -= LU[k] * z[Aj[k]];
+    z[i] = s;
+  }
+  // U z = y.
+  for (int i = size - 1; i >= 0; i--) {
+    scalar s = z[i];
+    for (int k = diag[i] + 1; k < Ap[i + 1]; k++) s -= LU[k] * z[Aj[k]];
+    z[i] = s / LU[diag[i]];
+  }
+}
+
+NativePrecond *create_native_precond(const char *name)
+{
+  _F_
+  if (strcasecmp(name, "none") == 0) return NULL;
+  else if (strcasecmp(name, "jacobi") == 0) return new JacobiPrecond;
+  else if (strcasecmp(name, "block-jacobi") == 0) return new BlockJacobiPrecond;
+  else if (strcasecmp(name, "ilu0") == 0) return new ILU0Precond;
+  else if (strcasecmp(name, "amg") == 0) return new AMGPrecond;
+  error("Unknown native preconditioner '%s'.", name);
+  return NULL;
+}
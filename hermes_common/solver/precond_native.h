@@ -0,0 +1,148 @@
+// This file is part of Hermes
+//
+// Hermes is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef __HERMES_COMMON_PRECOND_NATIVE_H_
+#define __HERMES_COMMON_PRECOND_NATIVE_H_
+
+#include "precond.h"
+#include "csr.h"
+
+#ifdef HAVE_EPETRA
+  #include <Epetra_SerialComm.h>
+  #include <Epetra_Map.h>
+  #include <Epetra_MultiVector.h>
+#endif
+
+/// Preconditioners which need no external library. They work with CSRMatrix and CSCMatrix
+/// (a CSC matrix is converted to rows in compute()) and are used by the native Krylov
+/// solvers (see krylov.h). In real builds with Epetra they can be passed to AztecOO too.
+///
+/// create() registers the matrix, compute() computes the preconditioner from the current
+/// values of the matrix, apply() applies it.
+///
+/// @ingroup preconds
+class HERMES_API NativePrecond : public Precond {
+public:
+  NativePrecond();
+  virtual ~NativePrecond();
+
+  virtual void create(Matrix *mat);
+  virtual void destroy();
+  virtual void compute() = 0;
+
+  /// Computes z = M^{-1} r, where M is the preconditioner. r and z do not overlap.
+  virtual void apply(scalar *r, scalar *z) = 0;
+
+  /// Is the preconditioner computed?
+  bool is_computed() const { return computed; }
+
+#ifdef HAVE_EPETRA
+  virtual Epetra_Operator *get_obj() { return this; }
+
+  // Epetra_Operator interface
+  virtual int ApplyInverse(const Epetra_MultiVector &r, Epetra_MultiVector &z) const;
+  virtual const Epetra_Comm &Comm() const;
+  virtual const Epetra_Map &OperatorDomainMap() const;
+  virtual const Epetra_Map &OperatorRangeMap() const;
+#endif
+
+protected:
+  Matrix *mat;          ///< The matrix registered by create().
+  CSRMatrix csr_copy;   ///< Rows of the matrix if it is a CSCMatrix.
+  bool computed;
+
+  /// Returns the rows of the registered matrix with the current values.
+  CSRMatrix *get_rows();
+
+#ifdef HAVE_EPETRA
+  Epetra_Map *epetra_map;
+#endif
+};
+
+/// Jacobi (diagonal) preconditioner.
+///
+/// @ingroup preconds
+class HERMES_API JacobiPrecond : public NativePrecond {
+public:
+  JacobiPrecond();
+  virtual ~JacobiPrecond();
+
+  virtual void destroy();
+  virtual void compute();
+  virtual void apply(scalar *r, scalar *z);
+
+protected:
+  scalar *inv_diag;
+  unsigned int size;
+};
+
+/// Block Jacobi preconditioner: the diagonal blocks of the matrix are inverted by dense LU
+/// factorization with partial pivoting.
+///
+/// With block_size == 0 (default) the blocks are the row blocks of CSRMatrix, i.e. groups
+/// of consecutive DOFs with the same connectivity, such as the bubble functions of one
+/// element. Otherwise the blocks consist of block_size consecutive DOFs.
+///
+/// @ingroup preconds
+class HERMES_API BlockJacobiPrecond : public NativePrecond {
+public:
+  BlockJacobiPrecond(int block_size = 0);
+  virtual ~BlockJacobiPrecond();
+
+  virtual void destroy();
+  virtual void compute();
+  virtual void apply(scalar *r, scalar *z);
+
+  unsigned int get_num_blocks() const { return num_blocks; }
+
+protected:
+  int block_size;
+  unsigned int num_blocks;
+  int *block_ptr;       ///< Block b consists of the rows block_ptr[b], ..., block_ptr[b + 1] - 1.
+  int *lu_ptr;          ///< Offsets of the dense LU factors of the blocks in lu.
+  scalar *lu;
+  int *pivots;          ///< Row permutations of the blocks (indexed like the rows).
+
+  void free_blocks();
+};
+
+/// Incomplete LU factorization with zero fill-in, ILU(0).
+///
+/// @ingroup preconds
+class HERMES_API ILU0Precond : public NativePrecond {
+public:
+  ILU0Precond();
+  virtual ~ILU0Precond();
+
+  virtual void destroy();
+  virtual void compute();
+  virtual void apply(scalar *r, scalar *z);
+
+protected:
+  unsigned int size;
+  int *Ap;              ///< Structure of the factors (the structure of the matrix).
+  int *Aj;
+  scalar *LU;           ///< L (unit diagonal, not stored) and U in one array.
+  int *diag;            ///< Positions of the diagonal entries in LU.
+
+  void free_factors();
+};
+
+/// Creates a native preconditioner by name [ none | jacobi | block-jacobi | ilu0 | amg ],
+/// returns NULL for "none". The AMG preconditioner is declared in precond_amg.h.
+HERMES_API NativePrecond *create_native_precond(const char *name);
+
+#endif
@@ -110,11 +110,33 @@ protected:
 
 /// Abstract class for defining interface for linear solvers.
 ///
+/// The direct solvers (UMFPack, SuperLU, MUMPS, PETSc) reuse the reordering (symbolic analysis)
+/// of the last factorization automatically if the sparsity pattern of the matrix has not
+/// changed: the matrix keeps the sequence number of its pattern, and after the pattern has been
+/// rebuilt, a hash of its index arrays tells if it is the same as the last one. The numerical
+/// factorization is reused completely only on request, by set_factorization_scheme(), which
+/// sets the minimum reuse level.
+///
 class LinearSolver : public Solver 
 {
   public:
     LinearSolver(unsigned int factorization_scheme = HERMES_FACTORIZE_FROM_SCRATCH) 
-      : Solver(), factorization_scheme(factorization_scheme) {};
+      : Solver(), factorization_scheme(factorization_scheme), auto_factorization_reuse(true),
+        last_pattern_seq(0), have_last_matrix(false), last_pattern_hash(0), have_last_hash(false)
+    { 
+      memset(num_factorizations, 0, sizeof(num_factorizations));
+    };
+
+    /// Turns the automatic factorization reuse on (default) or off.
+    void set_auto_factorization_reuse(bool reuse) { 
+      auto_factorization_reuse = reuse; 
+      reset_factorization_reuse();
+    }
+
+    /// Number of solutions with the given factorization scheme, e.g. HERMES_FACTORIZE_FROM_SCRATCH
+    /// gives the number of complete factorizations, HERMES_REUSE_MATRIX_REORDERING the number
+    /// of numerical factorizations with a reused reordering.
+    int get_num_factorizations(FactorizationScheme scheme) const { return num_factorizations[scheme]; }
     
   protected:
     virtual void set_factorization_scheme(FactorizationScheme reuse_scheme) { 
@@ -122,6 +144,56 @@ class LinearSolver : public Solver
     }
         
     unsigned int factorization_scheme;
+
+    /// Returns the factorization scheme for a matrix given by the sequence number of its pattern
+    /// (SparseMatrix::get_pattern_seq()) and its index arrays (NULL if they are not available),
+    /// and remembers the pattern for the next call. The arrays are hashed only if the sequence
+    /// number has changed, i.e. once after every rebuild of the pattern.
+    unsigned int get_factorization_scheme(unsigned int pattern_seq, 
+                                          unsigned int n_idx1, const int *idx1, 
+                                          unsigned int n_idx2, const int *idx2)
+    {
+      unsigned int scheme = factorization_scheme;
+      if (!auto_factorization_reuse) return scheme;
+
+      bool same_pattern = have_last_matrix && pattern_seq == last_pattern_seq;
+      if (!same_pattern && idx1 != NULL && idx2 != NULL) {
+        unsigned long hash = hash_pattern(n_idx1, idx1, n_idx2, idx2);
+        same_pattern = have_last_hash && hash == last_pattern_hash;
+        last_pattern_hash = hash;
+        have_last_hash = true;
+      }
+      if (same_pattern && scheme < HERMES_REUSE_MATRIX_REORDERING) scheme = HERMES_REUSE_MATRIX_REORDERING;
+
+      last_pattern_seq = pattern_seq;
+      have_last_matrix = true;
+      return scheme;
+    }
+
+    /// Forgets the last matrix (when the factorization has been freed or has failed).
+    void reset_factorization_reuse() { 
+      have_last_matrix = false;
+      have_last_hash = false;
+    }
+
+    /// Counts a solution with the scheme actually used.
+    void count_factorization(unsigned int scheme) { num_factorizations[scheme]++; }
+
+    /// Hash of the sizes and the entries of the index arrays of a matrix.
+    static unsigned long hash_pattern(unsigned int n_idx1, const int *idx1, unsigned int n_idx2, const int *idx2)
+    {
+      unsigned long hash = n_idx1 * 1000003UL + n_idx2;
+      for (unsigned int i = 0; i < n_idx1; i++) hash = hash * 1000003UL ^ (unsigned int) idx1[i];
+      for (unsigned int i = 0; i < n_idx2; i++) hash = hash * 1000003UL ^ (unsigned int) idx2[i];
+      return hash;
+    }
+
+    bool auto_factorization_reuse;
+    int num_factorizations[HERMES_REUSE_FACTORIZATION_COMPLETELY + 1];
+    unsigned int last_pattern_seq;
+    bool have_last_matrix;
+    unsigned long last_pattern_hash;
+    bool have_last_hash;
 };
 
 /// Abstract class for defining interface for nonlinear solvers.
@@ -149,6 +221,7 @@ class IterSolver : public Solver
     /// Set the convergence tolerance
     /// @param[in] tol - the tolerance to set
     void set_tolerance(double tol) { this->tolerance = tol; }
+    double get_tolerance() const { return tolerance; }
     /// Set maximum number of iterations to perform
     /// @param[in] iters - number of iterations
     void set_max_iters(int iters) { this->max_iters = iters; }
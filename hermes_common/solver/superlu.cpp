@@ -69,26 +69,15 @@ SuperLUMatrix::~SuperLUMatrix()
 void SuperLUMatrix::alloc()
 {
   _F_
-  assert(pages != NULL);
-  
   // Initialize the arrays Ap and Ai.
+  int* col_ptr;
+  build_pattern(col_ptr, Ai);
   Ap = new unsigned int [size + 1];
   MEM_CHECK(Ap);
-  int aisize = get_num_indices();
-  Ai = new int [aisize];
-  MEM_CHECK(Ai);
-  
-  // sort the indices and remove duplicities, insert into Ai
-  unsigned int i, pos = 0;
-  for (i = 0; i < size; i++) {
-    Ap[i] = pos;
-    pos += sort_and_store_indices(pages[i], Ai + pos, Ai + aisize);
-  }
-  Ap[i] = pos;
-  
-  delete [] pages;
-  pages = NULL;
-  
+  for (unsigned int i = 0; i <= size; i++)
+    Ap[i] = col_ptr[i];
+  delete [] col_ptr;
+
   nnz = Ap[size];
 
   Ax = new slu_scalar [nnz];
@@ -303,6 +292,7 @@ void SuperLUMatrix::create(unsigned int size, unsigned int nnz, int* ap, int* ai
   _F_
   this->nnz = nnz;
   this->size = size;
+  pattern_seq++;
   this->Ap = new unsigned int[size+1]; assert(this->Ap != NULL);
   this->Ai = new int[nnz];    assert(this->Ai != NULL);
   this->Ax = new slu_scalar[nnz]; assert(this->Ax != NULL);
@@ -545,6 +535,7 @@ SuperLUSolver::SuperLUSolver(SuperLUMatrix *m, SuperLUVector *rhs)
   options.PrintStat = YES;   // Set to NO to suppress output.
   
   has_A = has_B = inited = false;
+  eff_fact_scheme = HERMES_FACTORIZE_FROM_SCRATCH;
 #else
   error(SUPERLU_NOT_COMPILED);
 #endif
@@ -604,10 +595,13 @@ bool SuperLUSolver::solve()
   // keep the (possibly rescaled) matrix from the last factorization, otherwise recreate it 
   // from the master SuperLUMatrix pointed to by this->m (this also applies to the case when 
   // A does not yet exist).
-  if (!has_A || factorization_scheme != HERMES_REUSE_FACTORIZATION_COMPLETELY)
+  if (!has_A || eff_fact_scheme != HERMES_REUSE_FACTORIZATION_COMPLETELY)
   {
-    if (A_changed) 
+    if (A_changed || eff_fact_scheme == HERMES_FACTORIZE_FROM_SCRATCH) 
       free_matrix();
+    else if (has_A)
+      // The pattern is the same, only the values are new.
+      memcpy(local_Ax, m->Ax, m->nnz * sizeof(slu_scalar));
     
     if (!has_A)
     {
@@ -712,6 +706,8 @@ bool SuperLUSolver::solve()
   
   if (factorized) 
   {
+    count_factorization(eff_fact_scheme);
+
     delete [] sln;
     sln = new scalar[m->size];
     
@@ -728,6 +724,9 @@ bool SuperLUSolver::solve()
   // If required, print statistics.
   if ( options.PrintStat ) SLU_PRINT_STAT(&stat);
   
+  if (!factorized)
+    reset_factorization_reuse();
+
   // Free temporary local variables.
   StatFree(&stat);
   SUPERLU_FREE (x);
@@ -746,19 +745,22 @@ bool SuperLUSolver::setup_factorization()
 {
   _F_
 #ifdef WITH_SUPERLU
+  // Reuse the reordering of the last factorization if the pattern of the matrix allows.
+  eff_fact_scheme = get_factorization_scheme(m->get_pattern_seq(), m->size + 1, (int *) m->Ap, m->nnz, m->Ai);
+
   unsigned int A_size = A.nrow < 0 ? 0 : A.nrow;
-  if (has_A && factorization_scheme != HERMES_FACTORIZE_FROM_SCRATCH && A_size != m->size)
+  if (has_A && eff_fact_scheme != HERMES_FACTORIZE_FROM_SCRATCH && A_size != m->size)
   {
+    reset_factorization_reuse();
     warning("You cannot reuse factorization structures for factorizing matrices of different sizes.");
     return false;
   }
   
   // Always factorize from scratch for the first time.
-  int eff_fact_scheme;
   if (!inited)
     eff_fact_scheme = HERMES_FACTORIZE_FROM_SCRATCH;
-  else
-    eff_fact_scheme = factorization_scheme;
+  else if (eff_fact_scheme == HERMES_REUSE_FACTORIZATION_COMPLETELY && !has_A)
+    eff_fact_scheme = HERMES_REUSE_MATRIX_REORDERING_AND_SCALING;
   
   // Prepare factorization structures. In case of a particular reuse scheme, comments are given
   // to clarify which arguments will be reused and which will be reset by the dgssvx (zgssvx) routine. 
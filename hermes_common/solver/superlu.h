@@ -228,6 +228,7 @@ protected:
   bool A_changed;               // Indicates that the system matrix has been changed
                                 // internally during factorization or externally by
                                 // the user.
+  unsigned int eff_fact_scheme; // Factorization scheme of the current solution.
                                 
   bool check_status(unsigned int info);  // Check the status returned from the solver routine.
   
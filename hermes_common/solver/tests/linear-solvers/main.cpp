@@ -14,6 +14,7 @@
 #include "solver/amesos.h"
 #include "solver/aztecoo.h"
 #include "solver/mumps.h"
+#include "solver/krylov.h"
 
 #include <iostream>
 
@@ -435,6 +436,37 @@ int main(int argc, char *argv[]) {
     solve(solver, n);
 #endif
   }  
+  else if (strcasecmp(argv[1], "krylov") == 0) {
+    CSRMatrix mat;
+    CSRVector rhs;
+    build_matrix(n, ar_mat, ar_rhs, &mat, &rhs);
+
+    GMRESSolver solver(&mat, &rhs);
+    solve(solver, n);
+  }
+  else if (strcasecmp(argv[1], "krylov-block") == 0) {
+    CSRMatrix mat;
+    CSRVector rhs;
+    build_matrix_block(n, ar_mat, ar_rhs, &mat, &rhs);
+
+    GMRESSolver solver(&mat, &rhs);
+    solve(solver, n);
+  }
+  else if (strcasecmp(argv[1], "cg") == 0 || strcasecmp(argv[1], "gmres") == 0 ||
+           strcasecmp(argv[1], "bicgstab") == 0) {
+    // The third parameter is the native preconditioner (see KrylovSolver::set_precond()).
+    CSRMatrix mat;
+    CSRVector rhs;
+    build_matrix(n, ar_mat, ar_rhs, &mat, &rhs);
+
+    KrylovSolver *solver;
+    if (strcasecmp(argv[1], "cg") == 0) solver = new CGSolver(&mat, &rhs);
+    else if (strcasecmp(argv[1], "gmres") == 0) solver = new GMRESSolver(&mat, &rhs);
+    else solver = new BiCGStabSolver(&mat, &rhs);
+    solver->set_precond(argc >= 4 ? argv[3] : "none");
+    solve(*solver, n);
+    delete solver;
+  }
   else
     ret = ERR_FAILURE;
 
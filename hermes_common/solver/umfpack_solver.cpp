@@ -59,17 +59,23 @@ static int find_position(int *Ai, int Alen, int idx) {
   return mid;
 }
 
+// Positions of the assembly map entries that are not added.
+#define HERMES_ASSEMBLY_MAP_SKIP     -1
+#define HERMES_ASSEMBLY_MAP_MISSING  -2
+
 CSCMatrix::CSCMatrix() {
   _F_
   size = 0; nnz = 0;
   Ap = NULL;
   Ai = NULL;
   Ax = NULL;
+  set_use_assembly_map(true);
 }
 
 CSCMatrix::CSCMatrix(unsigned int size) {
   _F_
   this->size = size;
+  set_use_assembly_map(true);
   this->alloc();
 }
 
@@ -96,27 +102,10 @@ void CSCMatrix::multiply_with_scalar(scalar value)
 
 void CSCMatrix::alloc() {
   _F_
-  assert(pages != NULL);
+  drop_assembly_map();
 
   // initialize the arrays Ap and Ai
-  Ap = new int [size + 1];
-  MEM_CHECK(Ap);
-  int aisize = get_num_indices();
-  Ai = new int [aisize];
-  MEM_CHECK(Ai);
-
-  // sort the indices and remove duplicities, insert into Ai
-  unsigned int i;
-  int pos = 0;
-  for (i = 0; i < size; i++) {
-    Ap[i] = pos;
-    pos += sort_and_store_indices(pages[i], Ai + pos, Ai + aisize);
-  }
-  Ap[i] = pos;
-
-  delete [] pages;
-  pages = NULL;
-
+  build_pattern(Ap, Ai);
   nnz = Ap[size];
   
   Ax = new scalar [nnz];
@@ -126,6 +115,7 @@ void CSCMatrix::alloc() {
 
 void CSCMatrix::free() {
   _F_
+  drop_assembly_map();
   nnz = 0;
   if (Ap != NULL) {delete [] Ap; Ap = NULL;}
   if (Ai != NULL) {delete [] Ai; Ai = NULL;}
@@ -249,12 +239,130 @@ void CSCMatrix::add_to_diagonal(scalar v)
 
 void CSCMatrix::add(unsigned int m, unsigned int n, scalar **mat, int *rows, int *cols) {
   _F_
+  if (m == 0 || n == 0) return;
+
+  if (assembly_map_mode == ASSEMBLY_MAP_REPLAY) {
+    if (add_replaying(m, n, mat, rows, cols)) return;
+    verbose("CSCMatrix: the assembly differs from the recorded one, dropping the assembly map.");
+    drop_assembly_map();
+  }
+  if (assembly_map_mode == ASSEMBLY_MAP_RECORD) {
+    add_recording(m, n, mat, rows, cols);
+    return;
+  }
+
   for (unsigned int i = 0; i < m; i++)       // rows
     for (unsigned int j = 0; j < n; j++)     // cols
       if(rows[i] >= 0 && cols[j] >= 0) // not Dir. dofs.
         add(rows[i], cols[j], mat[i][j]);
 }
 
+void CSCMatrix::drop_assembly_map()
+{
+  std::vector<int>().swap(assembly_map);
+  assembly_map_mode = ASSEMBLY_MAP_OFF;
+  assembly_map_valid = false;
+  assembly_map_pos = 0;
+}
+
+void CSCMatrix::set_use_assembly_map(bool use, double max_ratio)
+{
+  use_assembly_map = use;
+  assembly_map_max_ratio = max_ratio;
+  assembly_map_overflow_seq = 0;
+  drop_assembly_map();
+}
+
+void CSCMatrix::begin_assembly_map()
+{
+  _F_
+  if (!use_assembly_map || Ap == NULL || assembly_map_overflow_seq == pattern_seq) return;
+  if (assembly_map_valid) {
+    assembly_map_mode = ASSEMBLY_MAP_REPLAY;
+    assembly_map_pos = 0;
+  }
+  else {
+    drop_assembly_map();
+    assembly_map_mode = ASSEMBLY_MAP_RECORD;
+  }
+}
+
+void CSCMatrix::end_assembly_map()
+{
+  _F_
+  if (assembly_map_mode == ASSEMBLY_MAP_RECORD) {
+    assembly_map_valid = true;
+    verbose("CSCMatrix: assembly map recorded (%g MB).", sizeof(int) * (double) assembly_map.size() / 1048576.0);
+  }
+  else if (assembly_map_mode == ASSEMBLY_MAP_REPLAY && assembly_map_pos != assembly_map.size()) {
+    // Fewer blocks than recorded.
+    drop_assembly_map();
+  }
+  assembly_map_mode = ASSEMBLY_MAP_OFF;
+}
+
+void CSCMatrix::add_recording(unsigned int m, unsigned int n, scalar **mat, int *rows, int *cols)
+{
+  assembly_map.push_back(m);
+  assembly_map.push_back(n);
+  assembly_map.insert(assembly_map.end(), rows, rows + m);
+  assembly_map.insert(assembly_map.end(), cols, cols + n);
+
+  for (unsigned int i = 0; i < m; i++) {
+    for (unsigned int j = 0; j < n; j++) {
+      if (rows[i] < 0 || cols[j] < 0) {
+        assembly_map.push_back(HERMES_ASSEMBLY_MAP_SKIP);
+        continue;
+      }
+      int pos = find_position(Ai + Ap[cols[j]], Ap[cols[j] + 1] - Ap[cols[j]], rows[i]);
+      if (pos < 0) {
+        // Zero values may be added outside of the structure.
+        if (mat[i][j] != 0.0) {
+          info("CSCMatrix::add(): i = %d, j = %d.", rows[i], cols[j]);
+          error("Sparse matrix entry not found");
+        }
+        assembly_map.push_back(HERMES_ASSEMBLY_MAP_MISSING);
+        continue;
+      }
+      pos += Ap[cols[j]];
+      Ax[pos] += mat[i][j];
+      assembly_map.push_back(pos);
+    }
+  }
+
+  if (assembly_map.size() > assembly_map_max_ratio * nnz) {
+    verbose("CSCMatrix: the assembly map exceeds %g integers per nonzero entry, dropping it.",
+            assembly_map_max_ratio);
+    drop_assembly_map();
+    assembly_map_overflow_seq = pattern_seq;
+  }
+}
+
+bool CSCMatrix::add_replaying(unsigned int m, unsigned int n, scalar **mat, int *rows, int *cols)
+{
+  // Check that this is the recorded block.
+  if (assembly_map_pos + 2 + m + n + m * n > assembly_map.size()) return false;
+  int* rec = &assembly_map[assembly_map_pos];
+  if (rec[0] != (int) m || rec[1] != (int) n) return false;
+  if (memcmp(rec + 2, rows, sizeof(int) * m) != 0 || memcmp(rec + 2 + m, cols, sizeof(int) * n) != 0)
+    return false;
+
+  int* pos = rec + 2 + m + n;
+  for (unsigned int i = 0; i < m; i++, pos += n) {
+    scalar* row = mat[i];
+    for (unsigned int j = 0; j < n; j++) {
+      if (pos[j] >= 0)
+        Ax[pos[j]] += row[j];
+      else if (pos[j] == HERMES_ASSEMBLY_MAP_MISSING && row[j] != 0.0) {
+        info("CSCMatrix::add(): i = %d, j = %d.", rows[i], cols[j]);
+        error("Sparse matrix entry not found");
+      }
+    }
+  }
+  assembly_map_pos += 2 + m + n + m * n;
+  return true;
+}
+
 /// dumping matrix and right-hand side
 ///
 bool CSCMatrix::dump(FILE *file, const char *var_name, EMatrixDumpFormat fmt) {
@@ -376,8 +484,10 @@ double CSCMatrix::get_fill_in() const {
 void CSCMatrix::create(unsigned int size, unsigned int nnz, int* ap, int* ai, scalar* ax) 
 {
   _F_
+  drop_assembly_map();
   this->nnz = nnz;
   this->size = size;
+  pattern_seq++;
   this->Ap = new int[size+1]; assert(this->Ap != NULL);
   this->Ai = new int[nnz];    assert(this->Ai != NULL);
   this->Ax = new scalar[nnz]; assert(this->Ax != NULL);
@@ -601,12 +711,14 @@ bool UMFPackLinearSolver::setup_factorization()
 {
   _F_
 #ifdef WITH_UMFPACK
+  // Reuse the reordering of the last factorization if the pattern of the matrix allows.
+  int eff_fact_scheme = get_factorization_scheme(m->get_pattern_seq(), m->size + 1, m->Ap, m->nnz, m->Ai);
+
   // Perform both factorization phases for the first time.
-  int eff_fact_scheme;
-  if (factorization_scheme != HERMES_FACTORIZE_FROM_SCRATCH && symbolic == NULL && numeric == NULL)
+  if (eff_fact_scheme != HERMES_FACTORIZE_FROM_SCRATCH && symbolic == NULL)
     eff_fact_scheme = HERMES_FACTORIZE_FROM_SCRATCH;
-  else
-    eff_fact_scheme = factorization_scheme;
+  else if (eff_fact_scheme == HERMES_REUSE_FACTORIZATION_COMPLETELY && numeric == NULL)
+    eff_fact_scheme = HERMES_REUSE_MATRIX_REORDERING;
   
   int status;
   switch(eff_fact_scheme)
@@ -617,6 +729,7 @@ bool UMFPackLinearSolver::setup_factorization()
       //debug_log("Factorizing symbolically.");
       status = umfpack_symbolic(m->size, m->size, m->Ap, m->Ai, m->Ax, &symbolic, NULL, NULL);
       if (status != UMFPACK_OK) {
+        reset_factorization_reuse();
         check_status("umfpack_di_symbolic", status);
         return false;
       }
@@ -629,11 +742,13 @@ bool UMFPackLinearSolver::setup_factorization()
       //debug_log("Factorizing numerically.");
       status = umfpack_numeric(m->Ap, m->Ai, m->Ax, symbolic, &numeric, NULL, NULL);
       if (status != UMFPACK_OK) {
+        reset_factorization_reuse();
         check_status("umfpack_di_numeric", status);
         return false;
       }
       if (numeric == NULL) EXIT("umfpack_di_numeric error: numeric == NULL");
   }
+  count_factorization(eff_fact_scheme);
   
   return true;
 #else
@@ -650,6 +765,7 @@ void UMFPackLinearSolver::free_factorization_data()
   if (numeric != NULL) umfpack_free_numeric(&numeric);
   numeric = NULL;
 #endif
+  reset_factorization_reuse();
 }
 
 /*** UMFPack matrix iterator ****/
@@ -23,6 +23,10 @@
 #include "solver.h"
 #include "../matrix.h"
 
+// Default limit of the size of the assembly map of CSCMatrix, in integers per nonzero entry
+// (6 integers take twice the memory of Ai and Ax).
+#define HERMES_ASSEMBLY_MAP_MAX_RATIO  6.0
+
 
 // General CSC Matrix class (can be used in umfpack, in that case use the
 // UMFPackMatrix subclass, or with EigenSolver, or anything else)
@@ -69,6 +73,21 @@ public:
       return this->Ax;
   }
 
+  // Assembly map: during the first assembly (between begin_assembly_map() and
+  // end_assembly_map()) the positions in Ax of the entries added by add(m, n, mat, rows, cols)
+  // are recorded, the following assemblies with the same sequence of blocks add the values
+  // directly to these positions instead of searching the columns. The map is dropped by
+  // alloc(), free() and create(), and when a different sequence of blocks is detected.
+  // DiscreteProblem records it in the first assembly that reuses the sparse structure.
+  virtual void begin_assembly_map();
+  virtual void end_assembly_map();
+  // Switches the assembly map on (default) or off. The map takes about one integer for every
+  // entry of every element matrix. If it grows over max_ratio integers per nonzero entry of
+  // the matrix, it is dropped and not recorded again until the structure changes.
+  void set_use_assembly_map(bool use, double max_ratio = HERMES_ASSEMBLY_MAP_MAX_RATIO);
+  // True if the assembly map has been recorded and will be replayed by the next assembly.
+  bool has_assembly_map() const { return assembly_map_valid; }
+
 protected:
   // UMFPack specific data structures for storing the system matrix (CSC format).
   scalar *Ax;            // Matrix entries (column-wise).
@@ -76,6 +95,22 @@ protected:
   int *Ap;               // Index to Ax/Ai, where each column starts.
   unsigned int nnz;      // Number of non-zero entries (= Ap[size]).
 
+  // Assembly map. For every block: m, n, rows, cols and the m * n positions in Ax
+  // (HERMES_ASSEMBLY_MAP_SKIP for Dirichlet DOFs, HERMES_ASSEMBLY_MAP_MISSING for entries
+  // missing in the structure).
+  enum AssemblyMapMode { ASSEMBLY_MAP_OFF, ASSEMBLY_MAP_RECORD, ASSEMBLY_MAP_REPLAY };
+  std::vector<int> assembly_map;
+  AssemblyMapMode assembly_map_mode;
+  bool assembly_map_valid;
+  bool use_assembly_map;
+  size_t assembly_map_pos;
+  double assembly_map_max_ratio;
+  unsigned int assembly_map_overflow_seq;  // Pattern whose map has exceeded the limit (0 = none).
+
+  void drop_assembly_map();
+  void add_recording(unsigned int m, unsigned int n, scalar **mat, int *rows, int *cols);
+  bool add_replaying(unsigned int m, unsigned int n, scalar **mat, int *rows, int *cols);
+
 };
 
 // This class is to be used with UMFPack solver only:
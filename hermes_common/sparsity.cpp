@@ -0,0 +1,227 @@
+// This file is part of Hermes
+//
+// Hermes is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes; if not, see <http://www.gnu.prg/licenses/>.
+
+#include "sparsity.h"
+
+void qsort_int(int* pbase, size_t total_elems); // defined in qsort.cpp
+
+// Below this number of columns the pattern is always built by one thread.
+#define HERMES_SPARSITY_MIN_COLS_PER_THREAD 1000
+
+SparsityPattern::SparsityPattern()
+{
+  size = 0;
+  entry_block_open = false;
+  col_ptr = row_idx = NULL;
+  col_blocks_ptr = col_blocks = block_num_rows = NULL;
+  num_pairs = peak_memory = build_time = 0.0;
+}
+
+SparsityPattern::~SparsityPattern()
+{
+  free();
+}
+
+void SparsityPattern::init(unsigned int n)
+{
+  _F_
+  free();
+  size = n;
+  entry_block_open = false;
+}
+
+void SparsityPattern::free()
+{
+  _F_
+  std::vector<int>().swap(blocks);
+  std::vector<int>().swap(block_idx);
+  delete [] col_ptr; col_ptr = NULL;
+  delete [] row_idx; row_idx = NULL;
+  delete [] col_blocks_ptr; col_blocks_ptr = NULL;
+  delete [] col_blocks; col_blocks = NULL;
+  delete [] block_num_rows; block_num_rows = NULL;
+}
+
+void SparsityPattern::add_block(unsigned int n_rows, int* rows, unsigned int n_cols, int* cols)
+{
+  entry_block_open = false;
+  blocks.push_back(block_idx.size());
+  blocks.push_back(n_rows);
+  blocks.push_back(n_cols);
+  block_idx.insert(block_idx.end(), rows, rows + n_rows);
+  block_idx.insert(block_idx.end(), cols, cols + n_cols);
+}
+
+void SparsityPattern::add_entry(int row, int col)
+{
+  // Consecutive entries of one row (the usual loop order) extend one block.
+  int last = blocks.size() - 3;
+  if (entry_block_open && block_idx[blocks[last]] == row) {
+    block_idx.push_back(col);
+    blocks[last + 2]++;
+    return;
+  }
+  add_block(1, &row, 1, &col);
+  entry_block_open = true;
+}
+
+double SparsityPattern::process_columns(unsigned int first_col, unsigned int last_col, bool fill)
+{
+  int* marker = new int[size];
+  MEM_CHECK(marker);
+  memset(marker, 0xff, sizeof(int) * size);
+
+  int* idx = block_idx.empty() ? NULL : &block_idx[0];
+  double pairs = 0.0;
+  for (unsigned int c = first_col; c < last_col; c++) {
+    int cnt = 0;
+    int* out = fill ? row_idx + col_ptr[c] : NULL;
+    for (int k = col_blocks_ptr[c]; k < col_blocks_ptr[c + 1]; k++) {
+      int b = col_blocks[k];
+      int* rows = idx + blocks[3*b];
+      int n_rows = blocks[3*b + 1];
+      for (int i = 0; i < n_rows; i++) {
+        int r = rows[i];
+        if (r < 0 || marker[r] == (int) c) continue;
+        marker[r] = c;
+        if (fill) out[cnt] = r;
+        cnt++;
+      }
+      pairs += block_num_rows[b];
+    }
+    if (fill) qsort_int(out, cnt);
+    else col_ptr[c + 1] = cnt;
+  }
+
+  delete [] marker;
+  return pairs;
+}
+
+void* SparsityPattern::build_thread_run(void* data)
+{
+  BuildThread* bt = (BuildThread*) data;
+  bt->num_pairs = bt->pattern->process_columns(bt->first_col, bt->last_col, bt->fill);
+  return NULL;
+}
+
+void SparsityPattern::run_pass(int num_threads, unsigned int* bounds, bool fill)
+{
+  if (num_threads == 1) {
+    num_pairs = process_columns(0, size, fill);
+    return;
+  }
+
+  pthread_t* threads = new pthread_t[num_threads];
+  BuildThread* bt = new BuildThread[num_threads];
+  for (int t = 0; t < num_threads; t++) {
+    bt[t].pattern = this;
+    bt[t].first_col = bounds[t];
+    bt[t].last_col = bounds[t + 1];
+    bt[t].fill = fill;
+    if (pthread_create(&threads[t], NULL, build_thread_run, bt + t) != 0)
+      error("Failed to create a thread in SparsityPattern::build().");
+  }
+  num_pairs = 0.0;
+  for (int t = 0; t < num_threads; t++) {
+    pthread_join(threads[t], NULL);
+    num_pairs += bt[t].num_pairs;
+  }
+  delete [] threads;
+  delete [] bt;
+}
+
+void SparsityPattern::build(int num_threads)
+{
+  _F_
+  TimePeriod timer;
+
+  int num_blocks = blocks.size() / 3;
+  double mem = sizeof(int) * (double) (blocks.capacity() + block_idx.capacity());
+
+  // Number of valid rows of the blocks, column -> block incidence.
+  int* idx = block_idx.empty() ? NULL : &block_idx[0];
+  block_num_rows = new int[num_blocks];
+  col_blocks_ptr = new int[size + 1];
+  MEM_CHECK(block_num_rows);
+  MEM_CHECK(col_blocks_ptr);
+  memset(col_blocks_ptr, 0, sizeof(int) * (size + 1));
+  for (int b = 0; b < num_blocks; b++) {
+    int* rows = idx + blocks[3*b];
+    block_num_rows[b] = 0;
+    for (int i = 0; i < blocks[3*b + 1]; i++)
+      if (rows[i] >= 0) block_num_rows[b]++;
+    if (block_num_rows[b] == 0) continue;
+    int* cols = rows + blocks[3*b + 1];
+    for (int j = 0; j < blocks[3*b + 2]; j++)
+      if (cols[j] >= 0) col_blocks_ptr[cols[j] + 1]++;
+  }
+  for (unsigned int c = 0; c < size; c++)
+    col_blocks_ptr[c + 1] += col_blocks_ptr[c];
+
+  col_blocks = new int[col_blocks_ptr[size]];
+  MEM_CHECK(col_blocks);
+  int* pos = new int[size];
+  MEM_CHECK(pos);
+  memcpy(pos, col_blocks_ptr, sizeof(int) * size);
+  for (int b = 0; b < num_blocks; b++) {
+    if (block_num_rows[b] == 0) continue;
+    int* cols = idx + blocks[3*b] + blocks[3*b + 1];
+    for (int j = 0; j < blocks[3*b + 2]; j++)
+      if (cols[j] >= 0) col_blocks[pos[cols[j]]++] = b;
+  }
+  delete [] pos;
+  mem += sizeof(int) * ((double) num_blocks + 2.0 * size + 1.0 + col_blocks_ptr[size]);
+
+  // Split the columns into ranges of about the same work.
+  if (num_threads < 1) num_threads = 1;
+  if ((unsigned int) num_threads > size / HERMES_SPARSITY_MIN_COLS_PER_THREAD)
+    num_threads = std::max(1u, size / HERMES_SPARSITY_MIN_COLS_PER_THREAD);
+  unsigned int* bounds = new unsigned int[num_threads + 1];
+  bounds[0] = 0;
+  for (int t = 1; t < num_threads; t++) {
+    double target = (double) col_blocks_ptr[size] * t / num_threads;
+    unsigned int c = bounds[t - 1];
+    while (c < size && col_blocks_ptr[c] < target) c++;
+    bounds[t] = c;
+  }
+  bounds[num_threads] = size;
+  mem += sizeof(int) * (double) num_threads * size;  // marker arrays
+
+  // Count pass.
+  col_ptr = new int[size + 1];
+  MEM_CHECK(col_ptr);
+  col_ptr[0] = 0;
+  run_pass(num_threads, bounds, false);
+  for (unsigned int c = 0; c < size; c++)
+    col_ptr[c + 1] += col_ptr[c];
+
+  // Fill pass.
+  row_idx = new int[col_ptr[size]];
+  MEM_CHECK(row_idx);
+  run_pass(num_threads, bounds, true);
+  mem += sizeof(int) * (double) col_ptr[size];
+  delete [] bounds;
+
+  // The blocks are not needed anymore.
+  std::vector<int>().swap(blocks);
+  std::vector<int>().swap(block_idx);
+  delete [] col_blocks_ptr; col_blocks_ptr = NULL;
+  delete [] col_blocks; col_blocks = NULL;
+  delete [] block_num_rows; block_num_rows = NULL;
+
+  peak_memory = mem;
+  timer.tick();
+  build_time = timer.last();
+}
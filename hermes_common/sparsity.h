@@ -0,0 +1,110 @@
+// This file is part of Hermes
+//
+// Hermes is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes; if not, see <http://www.gnu.prg/licenses/>.
+
+#ifndef __HERMES_COMMON_SPARSITY_H_
+#define __HERMES_COMMON_SPARSITY_H_
+
+#include "common.h"
+
+/// Sparsity pattern of a square matrix, built from the lists of DOFs of the elements.
+///
+/// Every block registered by add_block() stands for all pairs (row, col) with the row taken
+/// from its row list and the column from its column list (negative indices are skipped), so
+/// the memory needed during the assembly of the pattern is proportional to the number
+/// of element DOFs and not to the number of element matrix entries.
+///
+/// build() creates the compressed column form with sorted row indices in two passes over
+/// the columns: the first one counts the distinct rows of every column, the second one
+/// fills them in. Duplicities are eliminated by a marker array, so no pair is stored twice.
+/// The columns can be processed by several threads.
+class HERMES_API SparsityPattern
+{
+public:
+  SparsityPattern();
+  ~SparsityPattern();
+
+  /// Prepares an empty pattern of an n x n matrix.
+  void init(unsigned int n);
+
+  /// Adds all pairs (rows[i], cols[j]). The arrays are copied.
+  void add_block(unsigned int n_rows, int* rows, unsigned int n_cols, int* cols);
+
+  /// Adds one pair.
+  void add_entry(int row, int col);
+
+  /// Builds the compressed column form and releases the blocks.
+  /// @param[in] num_threads - number of threads processing the columns
+  void build(int num_threads = 1);
+
+  /// Frees all the data.
+  void free();
+
+  unsigned int get_size() const { return size; }
+  unsigned int get_nnz() const { return (col_ptr != NULL) ? col_ptr[size] : 0; }
+
+  /// Column pointers (size + 1 entries) of the built pattern.
+  int* get_col_ptr() const { return col_ptr; }
+  /// Row indices of the built pattern, sorted in every column.
+  int* get_row_idx() const { return row_idx; }
+
+  /// Passes the ownership of the column pointers (allocated by new []) to the caller.
+  int* take_col_ptr() { int* p = col_ptr; col_ptr = NULL; return p; }
+  /// Passes the ownership of the row indices (allocated by new []) to the caller.
+  int* take_row_idx() { int* p = row_idx; row_idx = NULL; return p; }
+
+  /// Number of pairs registered including duplicities (what a list of pairs would store).
+  double get_num_pairs() const { return num_pairs; }
+  /// Memory high-water mark of the last build in bytes.
+  double get_peak_memory() const { return peak_memory; }
+  /// Wall-clock time of the last build in seconds.
+  double get_build_time() const { return build_time; }
+
+protected:
+  unsigned int size;
+
+  /// For every block: the offset of its indices in block_idx, the number of rows, the number
+  /// of columns. The row indices are followed by the column indices.
+  std::vector<int> blocks;
+  std::vector<int> block_idx;
+  bool entry_block_open; ///< The last block was created by add_entry() and can be extended.
+
+  int* col_ptr;
+  int* row_idx;
+
+  // Column -> blocks containing the column (compressed).
+  int* col_blocks_ptr;
+  int* col_blocks;
+  // Number of valid rows of every block.
+  int* block_num_rows;
+
+  double num_pairs;
+  double peak_memory;
+  double build_time;
+
+  struct BuildThread
+  {
+    SparsityPattern* pattern;
+    unsigned int first_col, last_col;
+    bool fill;
+    double num_pairs;
+  };
+  static void* build_thread_run(void* data);
+
+  /// Counts (fill == false) or fills in (fill == true) the rows of the columns first_col..last_col-1.
+  double process_columns(unsigned int first_col, unsigned int last_col, bool fill);
+  void run_pass(int num_threads, unsigned int* bounds, bool fill);
+};
+
+#endif